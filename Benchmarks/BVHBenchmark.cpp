@@ -0,0 +1,206 @@
+/**
+ * Dynamic BVH benchmark
+ * Measures FDynamicBVH builds, proxy moves and frustum / sphere / ray
+ * queries from 1k to 1M proxies, with the queries compared against the
+ * linear passes over FBoundsSoA the render scene would otherwise need.
+ *
+ * Proxies keep a constant density: the world grows with the cube root of
+ * the count, so a query covers about the same number of proxies at every
+ * size and only the cost of finding them changes. The frustum is a narrow
+ * spot view (a shadow cascade or a light face), not the main camera, whose
+ * view covers enough of the scene that the linear SIMD pass is the better fit.
+ *
+ * Usage: BVHBenchmark [--rounds R] [--max-proxies N]
+ */
+
+#include "DynamicBVH.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using FClock = std::chrono::high_resolution_clock;
+
+static double ElapsedUs(FClock::time_point Start)
+{
+    return std::chrono::duration<double, std::micro>(FClock::now() - Start).count();
+}
+
+// Median over Rounds of the microseconds one call of Work takes
+template <typename TWork>
+static double MedianUs(uint32 Rounds, TWork&& Work)
+{
+    std::vector<double> Samples;
+    for (uint32 Round = 0; Round < Rounds; ++Round)
+    {
+        auto Start = FClock::now();
+        Work(Round);
+        Samples.push_back(ElapsedUs(Start));
+    }
+    std::sort(Samples.begin(), Samples.end());
+    return Samples[Samples.size() / 2];
+}
+
+static FBoxSphereBounds MakeBounds(const FVector& Center, const FVector& Extent)
+{
+    return FBoxSphereBounds(Center, Extent, std::sqrt(Extent.X * Extent.X + Extent.Y * Extent.Y + Extent.Z * Extent.Z));
+}
+
+int main(int argc, char** argv)
+{
+    uint32 Rounds = 11;
+    uint32 MaxProxies = 1000000;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--rounds") == 0) Rounds = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--max-proxies") == 0) MaxProxies = static_cast<uint32>(atoi(argv[i + 1]));
+    }
+
+    printf("Dynamic BVH benchmark: %u rounds (median), BVH vs. linear pass over SoA bounds\n\n", Rounds);
+    printf("%-9s %6s %9s %9s | %8s %9s %9s | %8s %9s %9s | %8s %9s %9s\n", "Proxies", "Height", "Build ns", "Move ns",
+           "Frustum", "BVH us", "SoA us", "Sphere", "BVH us", "SoA us", "Ray hits", "BVH us", "SoA us");
+
+    uint64 Sink = 0;
+    for (uint32 NumProxies = 1000; NumProxies <= MaxProxies; NumProxies *= 10)
+    {
+        // 1k proxies fill a 100 unit cube
+        float HalfWorld = 50.0f * std::cbrt(NumProxies / 1000.0f);
+        std::mt19937 Random(42);
+        std::uniform_real_distribution<float> Position(-HalfWorld, HalfWorld);
+        std::uniform_real_distribution<float> Size(0.25f, 2.0f);
+        std::uniform_real_distribution<float> Step(-0.05f, 0.05f);
+
+        FBoundsSoA Bounds;
+        Bounds.Reset(NumProxies);
+        for (uint32 i = 0; i < NumProxies; ++i)
+        {
+            Bounds.Set(i, MakeBounds(FVector(Position(Random), Position(Random), Position(Random)),
+                                     FVector(Size(Random), Size(Random), Size(Random))));
+        }
+
+        // Build: one insert per proxy, then the depth-first layout
+        FDynamicBVH Tree;
+        std::vector<uint32> Ids(NumProxies);
+        auto BuildStart = FClock::now();
+        for (uint32 i = 0; i < NumProxies; ++i)
+        {
+            Ids[i] = Tree.CreateProxy(Bounds.Get(i).GetBox(), nullptr);
+        }
+        Tree.Compact();
+        double BuildNs = ElapsedUs(BuildStart) * 1000.0 / NumProxies;
+
+        // Moves: a tenth of the proxies take a frame's step of an animated object, mostly within the fat box
+        uint32 NumMoves = std::max(NumProxies / 10, 1u);
+        double MoveNs = MedianUs(Rounds, [&](uint32)
+        {
+            for (uint32 Move = 0; Move < NumMoves; ++Move)
+            {
+                uint32 i = static_cast<uint32>(Random() % NumProxies);
+                FBoxSphereBounds Moved = Bounds.Get(i);
+                Moved.Origin = FVector(Moved.Origin.X + Step(Random), Moved.Origin.Y + Step(Random), Moved.Origin.Z + Step(Random));
+                Bounds.Set(i, Moved);
+                Sink += Tree.MoveProxy(Ids[i], Moved.GetBox());
+            }
+        }) * 1000.0 / NumMoves;
+        Tree.Compact();
+
+        // Queries from points spread over the world, the same for both sides
+        std::vector<FVector> Origins(Rounds);
+        for (FVector& Origin : Origins)
+        {
+            Origin = FVector(Position(Random) * 0.5f, Position(Random) * 0.5f, Position(Random) * 0.5f);
+        }
+        std::vector<uint8> Visible(NumProxies + FBoundsSoA::Alignment);
+
+        // Frustum: a 30 degree spot view reaching 40 units down +Z
+        auto MakeFrustum = [&](uint32 Round)
+        {
+            const FVector& Eye = Origins[Round];
+            FMatrix4x4 View = FMatrix4x4::LookAtLH(Eye, FVector(Eye.X, Eye.Y, Eye.Z + 1.0f), FVector(0.0f, 1.0f, 0.0f));
+            FMatrix4x4 Projection = FMatrix4x4::PerspectiveFovLH(DirectX::XM_PI / 6.0f, 1.0f, 0.1f, 40.0f);
+            return FViewFrustum::FromViewProjection(View * Projection);
+        };
+        uint32 FrustumFound = 0;
+        double FrustumBvhUs = MedianUs(Rounds, [&](uint32 Round)
+        {
+            FViewFrustum Frustum = MakeFrustum(Round);
+            uint32 Found = 0;
+            Tree.QueryFrustum(Frustum, [&](uint32) { ++Found; return true; });
+            FrustumFound = Found;
+            Sink += Found;
+        });
+        double FrustumSoaUs = MedianUs(Rounds, [&](uint32 Round)
+        {
+            Sink += MakeFrustum(Round).CullBounds(Bounds, Visible.data());
+        });
+
+        // Sphere: a point light's reach
+        const float Radius = 15.0f;
+        uint32 SphereFound = 0;
+        double SphereBvhUs = MedianUs(Rounds, [&](uint32 Round)
+        {
+            uint32 Found = 0;
+            Tree.QuerySphere(Origins[Round], Radius, [&](uint32) { ++Found; return true; });
+            SphereFound = Found;
+            Sink += Found;
+        });
+        double SphereSoaUs = MedianUs(Rounds, [&](uint32 Round)
+        {
+            uint32 Found = 0;
+            for (uint32 i = 0; i < NumProxies; ++i)
+            {
+                Found += Bounds.Get(i).IntersectsSphere(Origins[Round], Radius);
+            }
+            Sink += Found;
+        });
+
+        // Ray: closest hit of a picking ray through the whole world
+        const FVector Direction(0.48f, 0.6f, 0.64f);
+        const FVector InvDirection(1.0f / Direction.X, 1.0f / Direction.Y, 1.0f / Direction.Z);
+        const float MaxDistance = 4.0f * HalfWorld;
+        uint32 RayHits = 0;
+        double RayBvhUs = MedianUs(Rounds, [&](uint32 Round)
+        {
+            uint32 Hit = FDynamicBVH::NullIndex;
+            Tree.RayCast(Origins[Round], Direction, MaxDistance, [&](uint32 ProxyId, float CurrentMax)
+            {
+                float Distance;
+                if (Bounds.Get(ProxyId).GetBox().IntersectsRay(Origins[Round], InvDirection, CurrentMax, Distance))
+                {
+                    Hit = ProxyId;
+                    return Distance;
+                }
+                return CurrentMax;
+            });
+            RayHits += Hit != FDynamicBVH::NullIndex;
+        });
+        double RaySoaUs = MedianUs(Rounds, [&](uint32 Round)
+        {
+            float Closest = MaxDistance;
+            uint32 Hit = FDynamicBVH::NullIndex;
+            for (uint32 i = 0; i < NumProxies; ++i)
+            {
+                float Distance;
+                if (Bounds.Get(i).GetBox().IntersectsRay(Origins[Round], InvDirection, Closest, Distance))
+                {
+                    Closest = Distance;
+                    Hit = i;
+                }
+            }
+            Sink += Hit != FDynamicBVH::NullIndex;
+        });
+        Sink += RayHits;
+
+        // Found counts are of the last round; ray hits are over all rounds
+        printf("%-9u %6u %9.1f %9.1f | %8u %9.2f %9.1f | %8u %9.2f %9.1f | %8u %9.2f %9.1f\n", NumProxies, Tree.GetHeight(),
+               BuildNs, MoveNs, FrustumFound, FrustumBvhUs, FrustumSoaUs, SphereFound, SphereBvhUs, SphereSoaUs, RayHits,
+               RayBvhUs, RaySoaUs);
+    }
+
+    return Sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * Frustum culling benchmark
+ * Measures FViewFrustum::CullBounds, the SSE batch kernel FRenderScene runs
+ * over its SoA proxy bounds each frame, against CullBoundsScalar, which tests
+ * one FBoxSphereBounds at a time, from 1k to 1M bounds.
+ *
+ * Bounds are scattered in a cube around a camera at the origin, so most are
+ * rejected by one of the first few planes, as in a large open scene.
+ *
+ * Usage: CullingBenchmark [--rounds R] [--max-bounds N]
+ */
+
+#include "Bounds.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using FClock = std::chrono::high_resolution_clock;
+
+static void FillRandomBounds(FBoundsSoA& Bounds, uint32 NumBounds)
+{
+    Bounds.Reset(NumBounds);
+    std::mt19937 Random(42);
+    std::uniform_real_distribution<float> Position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> Size(0.25f, 4.0f);
+    for (uint32 i = 0; i < NumBounds; ++i)
+    {
+        FVector Extent(Size(Random), Size(Random), Size(Random));
+        float Radius = std::sqrt(Extent.X * Extent.X + Extent.Y * Extent.Y + Extent.Z * Extent.Z);
+        Bounds.Set(i, FBoxSphereBounds(FVector(Position(Random), Position(Random), Position(Random)), Extent, Radius));
+    }
+}
+
+// Median over Rounds of the ns per bound for one pass of Cull
+template <typename TCull>
+static double MedianNsPerBound(uint32 Rounds, uint32 NumBounds, TCull&& Cull)
+{
+    std::vector<double> Samples;
+    for (uint32 Round = 0; Round < Rounds; ++Round)
+    {
+        auto Start = FClock::now();
+        Cull();
+        auto End = FClock::now();
+        Samples.push_back(std::chrono::duration<double, std::nano>(End - Start).count() / NumBounds);
+    }
+    std::sort(Samples.begin(), Samples.end());
+    return Samples[Samples.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    uint32 Rounds = 21;
+    uint32 MaxBounds = 1000000;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--rounds") == 0) Rounds = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--max-bounds") == 0) MaxBounds = static_cast<uint32>(atoi(argv[i + 1]));
+    }
+
+    // The default FCamera projection, looking down +Z from the origin
+    FMatrix4x4 View = FMatrix4x4::LookAtLH(FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 1.0f), FVector(0.0f, 1.0f, 0.0f));
+    FMatrix4x4 Projection = FMatrix4x4::PerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 100.0f);
+    FViewFrustum Frustum = FViewFrustum::FromViewProjection(View * Projection);
+
+    printf("Frustum culling benchmark: %u rounds (median)\n\n", Rounds);
+    printf("%-10s %10s %14s %14s %10s\n", "Bounds", "Visible", "SIMD ns/bound", "Scalar ns/bound", "Speedup");
+
+    uint64 Sink = 0;
+    for (uint32 NumBounds = 1000; NumBounds <= MaxBounds; NumBounds *= 10)
+    {
+        FBoundsSoA Bounds;
+        FillRandomBounds(Bounds, NumBounds);
+        std::vector<uint8> Visible(NumBounds);
+
+        uint32 NumVisible = 0;
+        double SimdNs = MedianNsPerBound(Rounds, NumBounds, [&]()
+        {
+            NumVisible = Frustum.CullBounds(Bounds, Visible.data());
+            Sink += NumVisible;
+        });
+        double ScalarNs = MedianNsPerBound(Rounds, NumBounds, [&]()
+        {
+            Sink += Frustum.CullBoundsScalar(Bounds, Visible.data());
+        });
+
+        printf("%-10u %10u %14.2f %15.2f %9.1fx\n", NumBounds, NumVisible, SimdNs, ScalarNs, ScalarNs / SimdNs);
+    }
+
+    return Sink == 0 ? 1 : 0;
+}
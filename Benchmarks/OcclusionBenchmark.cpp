@@ -0,0 +1,147 @@
+/**
+ * Software occlusion culling benchmark
+ * Measures FMaskedOcclusionBuffer on a city-like scene: rows of box
+ * buildings in front of a camera at the origin, rasterized as occluders,
+ * then a field of small boxes scattered among and behind them tested
+ * against the buffer. Reports the occluder setup and raster time, the test
+ * time per box and the share of boxes found hidden.
+ *
+ * Usage: OcclusionBenchmark [--rounds R] [--boxes N]
+ */
+
+#include "MaskedOcclusionBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using FClock = std::chrono::high_resolution_clock;
+
+// The 12 triangles of a unit cube centered on the origin
+static FOccluderMesh MakeUnitCube()
+{
+    FOccluderMesh Mesh;
+    for (uint32 Corner = 0; Corner < 8; ++Corner)
+    {
+        Mesh.Positions.push_back(FVector((Corner & 1) ? 0.5f : -0.5f, (Corner & 2) ? 0.5f : -0.5f, (Corner & 4) ? 0.5f : -0.5f));
+    }
+    Mesh.Indices = { 0, 2, 3, 0, 3, 1,  4, 5, 7, 4, 7, 6,  0, 1, 5, 0, 5, 4,
+                     2, 6, 7, 2, 7, 3,  0, 4, 6, 0, 6, 2,  1, 3, 7, 1, 7, 5 };
+    return Mesh;
+}
+
+// Median over Rounds of the ms one call of Body takes
+template <typename TBody>
+static double MedianMs(uint32 Rounds, TBody&& Body)
+{
+    std::vector<double> Samples;
+    for (uint32 Round = 0; Round < Rounds; ++Round)
+    {
+        auto Start = FClock::now();
+        Body();
+        auto End = FClock::now();
+        Samples.push_back(std::chrono::duration<double, std::milli>(End - Start).count());
+    }
+    std::sort(Samples.begin(), Samples.end());
+    return Samples[Samples.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    uint32 Rounds = 21;
+    uint32 NumBoxes = 100000;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--rounds") == 0) Rounds = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--boxes") == 0) NumBoxes = static_cast<uint32>(atoi(argv[i + 1]));
+    }
+
+    // The default FCamera projection, looking down +Z from the origin
+    FMatrix4x4 View = FMatrix4x4::LookAtLH(FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 1.0f), FVector(0.0f, 1.0f, 0.0f));
+    FMatrix4x4 Projection = FMatrix4x4::PerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 100.0f);
+    FMatrix4x4 ViewProjection = View * Projection;
+
+    std::mt19937 Random(42);
+    std::uniform_real_distribution<float> BoxX(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> BoxY(-2.0f, 3.0f);
+    std::uniform_real_distribution<float> BoxZ(5.0f, 95.0f);
+    std::uniform_real_distribution<float> BoxSize(0.25f, 1.0f);
+    std::vector<FBox> Boxes(NumBoxes);
+    for (FBox& Box : Boxes)
+    {
+        FVector Center(BoxX(Random), BoxY(Random), BoxZ(Random));
+        float HalfSize = BoxSize(Random);
+        Box = FBox(FVector(Center.X - HalfSize, Center.Y - HalfSize, Center.Z - HalfSize),
+                   FVector(Center.X + HalfSize, Center.Y + HalfSize, Center.Z + HalfSize));
+    }
+
+    FOccluderMesh Cube = MakeUnitCube();
+    FMaskedOcclusionBuffer Buffer;
+
+    printf("Occlusion culling benchmark: %ux%u buffer, %u boxes, %u rounds (median)\n\n",
+           Buffer.GetWidth(), Buffer.GetHeight(), NumBoxes, Rounds);
+    printf("%-10s %10s %10s %10s %12s %10s\n", "Occluders", "Triangles", "Setup ms", "Raster ms", "Test ns/box", "Hidden");
+
+    uint64 Sink = 0;
+    for (uint32 NumOccluders = 16; NumOccluders <= 1024; NumOccluders *= 4)
+    {
+        // Buildings in rows across the view, on the ground at y = -2
+        std::uniform_real_distribution<float> BuildingX(-40.0f, 40.0f);
+        std::uniform_real_distribution<float> BuildingZ(10.0f, 60.0f);
+        std::uniform_real_distribution<float> BuildingWidth(3.0f, 10.0f);
+        std::uniform_real_distribution<float> BuildingHeight(4.0f, 16.0f);
+        std::vector<FMatrix4x4> Buildings;
+        for (uint32 i = 0; i < NumOccluders; ++i)
+        {
+            float Width = BuildingWidth(Random);
+            float Height = BuildingHeight(Random);
+            FMatrix4x4 Model = FMatrix4x4::Scaling(Width, Height, Width) *
+                               FMatrix4x4::Translation(BuildingX(Random), Height * 0.5f - 2.0f, BuildingZ(Random));
+            Buildings.push_back(Model * ViewProjection);
+        }
+
+        // Rasterizing needs a cleared buffer each round, so setup and raster are timed apart
+        uint32 NumTriangles = 0;
+        std::vector<double> SetupSamples;
+        std::vector<double> RasterSamples;
+        for (uint32 Round = 0; Round < Rounds; ++Round)
+        {
+            auto Start = FClock::now();
+            Buffer.Clear();
+            NumTriangles = 0;
+            for (const FMatrix4x4& ModelViewProjection : Buildings)
+            {
+                NumTriangles += Buffer.AddOccluder(ModelViewProjection, Cube);
+            }
+            auto Binned = FClock::now();
+            Buffer.RasterizeAll();
+            auto End = FClock::now();
+            SetupSamples.push_back(std::chrono::duration<double, std::milli>(Binned - Start).count());
+            RasterSamples.push_back(std::chrono::duration<double, std::milli>(End - Binned).count());
+        }
+        std::sort(SetupSamples.begin(), SetupSamples.end());
+        std::sort(RasterSamples.begin(), RasterSamples.end());
+        double SetupMs = SetupSamples[SetupSamples.size() / 2];
+        double RasterMs = RasterSamples[RasterSamples.size() / 2];
+
+        uint32 NumHidden = 0;
+        double TestMs = MedianMs(Rounds, [&]()
+        {
+            NumHidden = 0;
+            for (const FBox& Box : Boxes)
+            {
+                NumHidden += !Buffer.IsBoxVisible(Box, ViewProjection);
+            }
+        });
+        Sink += NumHidden + NumTriangles;
+
+        printf("%-10u %10u %10.3f %10.3f %12.1f %9.1f%%\n", NumOccluders, NumTriangles, SetupMs, RasterMs,
+               TestMs * 1e6 / NumBoxes, 100.0 * NumHidden / NumBoxes);
+    }
+
+    return Sink == 0 ? 1 : 0;
+}
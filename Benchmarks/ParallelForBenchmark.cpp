@@ -0,0 +1,149 @@
+/**
+ * ParallelFor scaling benchmark
+ * Runs data-parallel loops of 10k, 100k and 1M elements on FTaskGraph
+ * instances with 2..N threads (caller plus workers) and reports speedup over
+ * a serial loop.
+ *
+ * Workloads:
+ * - Transform: per-element 4x4 matrix * position (light, memory bound)
+ * - Shade: per-element iterative math (~200 flops, compute bound)
+ *
+ * Usage: ParallelForBenchmark [--max-threads T] [--batch B] [--rounds R]
+ */
+
+#include "ParallelFor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using FClock = std::chrono::high_resolution_clock;
+
+struct FBenchVector
+{
+    float X, Y, Z, W;
+};
+
+struct FBenchData
+{
+    std::vector<FBenchVector> Input;
+    std::vector<FBenchVector> Output;
+    float Matrix[16];
+
+    explicit FBenchData(int32 Num)
+        : Input(Num)
+        , Output(Num)
+    {
+        for (int32 i = 0; i < Num; ++i)
+        {
+            Input[i] = { static_cast<float>(i % 97), static_cast<float>(i % 31), static_cast<float>(i % 13), 1.0f };
+        }
+        for (int32 i = 0; i < 16; ++i)
+        {
+            Matrix[i] = (i % 5 == 0) ? 1.0f : 0.01f * static_cast<float>(i);
+        }
+    }
+};
+
+static void TransformElement(FBenchData& Data, int32 Index)
+{
+    const FBenchVector& In = Data.Input[Index];
+    const float* M = Data.Matrix;
+    FBenchVector& Out = Data.Output[Index];
+    Out.X = In.X * M[0] + In.Y * M[4] + In.Z * M[8] + In.W * M[12];
+    Out.Y = In.X * M[1] + In.Y * M[5] + In.Z * M[9] + In.W * M[13];
+    Out.Z = In.X * M[2] + In.Y * M[6] + In.Z * M[10] + In.W * M[14];
+    Out.W = In.X * M[3] + In.Y * M[7] + In.Z * M[11] + In.W * M[15];
+}
+
+static void ShadeElement(FBenchData& Data, int32 Index)
+{
+    const FBenchVector& In = Data.Input[Index];
+    float Value = In.X + In.Y * 0.5f + In.Z * 0.25f;
+    for (int32 Step = 0; Step < 50; ++Step)
+    {
+        Value = std::sqrt(Value * Value + 1.0f) * 0.999f + 0.001f * In.W;
+    }
+    Data.Output[Index].X = Value;
+}
+
+// Median wall time of Rounds runs of Loop()
+template<typename LoopType>
+static double MeasureMs(uint32 Rounds, LoopType&& Loop)
+{
+    std::vector<double> Samples;
+    Samples.reserve(Rounds);
+    for (uint32 Round = 0; Round < Rounds; ++Round)
+    {
+        auto Start = FClock::now();
+        Loop();
+        Samples.push_back(std::chrono::duration<double, std::milli>(FClock::now() - Start).count());
+    }
+    std::sort(Samples.begin(), Samples.end());
+    return Samples[Samples.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    uint32 MaxThreads = std::max(1u, std::thread::hardware_concurrency());
+    int32 MinBatchSize = 256;
+    uint32 Rounds = 15;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--max-threads") == 0) MaxThreads = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--batch") == 0) MinBatchSize = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--rounds") == 0) Rounds = static_cast<uint32>(atoi(argv[i + 1]));
+    }
+
+    const int32 Sizes[] = { 10000, 100000, 1000000 };
+    struct FWorkload
+    {
+        const char* Name;
+        void (*Element)(FBenchData&, int32);
+    };
+    const FWorkload Workloads[] = { { "Transform", &TransformElement }, { "Shade", &ShadeElement } };
+
+    printf("ParallelFor benchmark: MinBatchSize %d, %u rounds (median), hardware threads %u\n",
+           MinBatchSize, Rounds, std::thread::hardware_concurrency());
+    printf("Threads counts the calling thread plus workers\n\n");
+    printf("%-10s %-9s %-8s %12s %9s\n", "Workload", "Elements", "Threads", "Time ms", "Speedup");
+
+    for (const FWorkload& Workload : Workloads)
+    {
+        for (int32 Num : Sizes)
+        {
+            FBenchData Data(Num);
+            double SerialMs = MeasureMs(Rounds, [&]()
+            {
+                for (int32 Index = 0; Index < Num; ++Index)
+                {
+                    Workload.Element(Data, Index);
+                }
+            });
+
+            printf("%-10s %-9d %-8s %12.3f %8.2fx\n", Workload.Name, Num, "serial", SerialMs, 1.0);
+
+            for (uint32 NumThreads = 2; NumThreads <= std::max(2u, MaxThreads); NumThreads *= 2)
+            {
+                // The caller participates, so NumThreads - 1 workers
+                FTaskGraph Graph(NumThreads - 1);
+                Graph.Initialize();
+
+                double ParallelMs = MeasureMs(Rounds, [&]()
+                {
+                    ParallelFor(Graph, Num, [&](int32 Index) { Workload.Element(Data, Index); }, MinBatchSize);
+                });
+
+                Graph.Shutdown();
+                printf("%-10s %-9d %-8u %12.3f %8.2fx\n",
+                       Workload.Name, Num, NumThreads, ParallelMs, SerialMs / ParallelMs);
+            }
+        }
+    }
+
+    return 0;
+}
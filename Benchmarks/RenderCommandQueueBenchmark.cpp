@@ -0,0 +1,154 @@
+/**
+ * Render command queue benchmark
+ * Compares the lock-free chunked FRenderCommandQueue against the previous
+ * design (reproduced below as FMutexRenderCommandQueue): one heap-allocated
+ * command per enqueue, pushed onto a std::queue under a mutex.
+ *
+ * Measures, for 1..N producer threads:
+ * - Enqueue cost: wall time for the producers to enqueue all commands, per command
+ * - Execute cost: ProcessCommands time (execute + destroy), per command
+ *
+ * Usage: RenderCommandQueueBenchmark [--commands N] [--rounds R] [--max-producers P]
+ */
+
+#include "RenderCommands.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using FClock = std::chrono::high_resolution_clock;
+
+/**
+ * FMutexRenderCommandQueue - the pre-lock-free FRenderCommandQueue
+ * make_unique per command, std::queue under QueueMutex, swap-out on process.
+ */
+class FMutexRenderCommandQueue
+{
+public:
+    template<typename LambdaType>
+    void EnqueueLambda(const char* Name, LambdaType&& Lambda)
+    {
+        auto Command = std::make_unique<FLambdaRenderCommand<std::decay_t<LambdaType>>>(
+            Name, std::forward<LambdaType>(Lambda));
+        {
+            std::lock_guard<std::mutex> Lock(QueueMutex);
+            Commands.push(std::move(Command));
+        }
+        QueueCondition.notify_one();
+    }
+
+    uint32 ProcessCommands()
+    {
+        uint32 ProcessedCount = 0;
+        std::queue<std::unique_ptr<FRenderCommandBase>> LocalCommands;
+        {
+            std::lock_guard<std::mutex> Lock(QueueMutex);
+            std::swap(LocalCommands, Commands);
+        }
+        while (!LocalCommands.empty())
+        {
+            LocalCommands.front()->Execute();
+            LocalCommands.pop();
+            ++ProcessedCount;
+        }
+        return ProcessedCount;
+    }
+
+private:
+    std::queue<std::unique_ptr<FRenderCommandBase>> Commands;
+    std::mutex QueueMutex;
+    std::condition_variable QueueCondition;
+};
+
+struct FQueueResult
+{
+    double EnqueueNs = 0.0;
+    double ExecuteNs = 0.0;
+};
+
+template<typename QueueType>
+static FQueueResult RunBenchmark(QueueType& Queue, uint32 NumProducers, uint32 NumCommands, uint32 Rounds)
+{
+    std::vector<double> EnqueueSamples;
+    std::vector<double> ExecuteSamples;
+    uint64 Sink = 0;
+    uint32 PerProducer = NumCommands / NumProducers;
+    uint32 Total = PerProducer * NumProducers;
+
+    for (uint32 Round = 0; Round < Rounds; ++Round)
+    {
+        // Typical render command: a couple of captured pointers and a value
+        auto Start = FClock::now();
+        std::vector<std::thread> Producers;
+        for (uint32 Producer = 0; Producer < NumProducers; ++Producer)
+        {
+            Producers.emplace_back([&Queue, &Sink, PerProducer, Producer]()
+            {
+                uint64* Target = &Sink;
+                for (uint32 i = 0; i < PerProducer; ++i)
+                {
+                    Queue.EnqueueLambda("Bench", [Target, Producer, i]() { *Target += Producer + i; });
+                }
+            });
+        }
+        for (std::thread& Producer : Producers)
+        {
+            Producer.join();
+        }
+        auto Enqueued = FClock::now();
+
+        Queue.ProcessCommands();
+        auto Executed = FClock::now();
+
+        EnqueueSamples.push_back(std::chrono::duration<double, std::nano>(Enqueued - Start).count() / Total);
+        ExecuteSamples.push_back(std::chrono::duration<double, std::nano>(Executed - Enqueued).count() / Total);
+    }
+
+    std::sort(EnqueueSamples.begin(), EnqueueSamples.end());
+    std::sort(ExecuteSamples.begin(), ExecuteSamples.end());
+
+    FQueueResult Result;
+    Result.EnqueueNs = EnqueueSamples[EnqueueSamples.size() / 2];
+    Result.ExecuteNs = ExecuteSamples[ExecuteSamples.size() / 2];
+    if (Sink == 0)
+    {
+        printf("(unexpected empty sink)\n");
+    }
+    return Result;
+}
+
+int main(int argc, char** argv)
+{
+    uint32 NumCommands = 200000;
+    uint32 Rounds = 20;
+    uint32 MaxProducers = 8;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--commands") == 0) NumCommands = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--rounds") == 0) Rounds = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--max-producers") == 0) MaxProducers = static_cast<uint32>(atoi(argv[i + 1]));
+    }
+
+    printf("Render command queue benchmark: %u commands x %u rounds (median), hardware threads %u\n\n",
+           NumCommands, Rounds, std::thread::hardware_concurrency());
+    printf("%-10s %-12s %18s %18s\n", "Producers", "Queue", "Enqueue ns/cmd", "Execute ns/cmd");
+
+    FMutexRenderCommandQueue MutexQueue;
+    FRenderCommandQueue LockFreeQueue;
+
+    for (uint32 NumProducers = 1; NumProducers <= MaxProducers; NumProducers *= 2)
+    {
+        FQueueResult Mutex = RunBenchmark(MutexQueue, NumProducers, NumCommands, Rounds);
+        FQueueResult LockFree = RunBenchmark(LockFreeQueue, NumProducers, NumCommands, Rounds);
+
+        printf("%-10u %-12s %18.1f %18.1f\n", NumProducers, "Mutex", Mutex.EnqueueNs, Mutex.ExecuteNs);
+        printf("%-10u %-12s %18.1f %18.1f\n", NumProducers, "LockFree", LockFree.EnqueueNs, LockFree.ExecuteNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * Task graph scheduler benchmark
+ * Compares the work-stealing FTaskGraph against the previous single
+ * mutex + condition variable queue (reproduced below as FSharedQueueScheduler)
+ *
+ * Measures, for 1..64 worker threads:
+ * - Empty-task throughput: N empty tasks queued from an external thread
+ * - Worker fan-out throughput: N empty tasks queued from inside a worker task
+ * - Fan-out/fan-in latency: one root task spawns K children, time until the last completes
+ *
+ * Usage: TaskGraphBenchmark [--tasks N] [--fanout K] [--rounds R] [--max-threads T]
+ */
+
+#include "TaskGraph.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using FClock = std::chrono::high_resolution_clock;
+
+/**
+ * FSharedQueueScheduler - the pre-work-stealing FTaskGraph scheduler
+ * One std::queue guarded by one mutex, one condition variable, notify_one per task.
+ */
+class FSharedQueueScheduler
+{
+public:
+    explicit FSharedQueueScheduler(uint32 InNumThreads)
+        : bShutdown(false)
+    {
+        for (uint32 i = 0; i < InNumThreads; ++i)
+        {
+            WorkerThreads.emplace_back(&FSharedQueueScheduler::WorkerThreadLoop, this);
+        }
+    }
+
+    ~FSharedQueueScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(QueueMutex);
+            bShutdown = true;
+        }
+        QueueCondition.notify_all();
+        for (auto& Thread : WorkerThreads)
+        {
+            Thread.join();
+        }
+    }
+
+    void QueueTask(FTask* Task)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(QueueMutex);
+            TaskQueue.push(Task);
+        }
+        QueueCondition.notify_one();
+    }
+
+private:
+    void WorkerThreadLoop()
+    {
+        while (true)
+        {
+            FTask* Task = nullptr;
+            {
+                std::unique_lock<std::mutex> Lock(QueueMutex);
+                QueueCondition.wait(Lock, [this]() { return !TaskQueue.empty() || bShutdown; });
+                if (TaskQueue.empty())
+                {
+                    return;
+                }
+                Task = TaskQueue.front();
+                TaskQueue.pop();
+            }
+            Task->Execute();
+        }
+    }
+
+    std::vector<std::thread> WorkerThreads;
+    std::queue<FTask*> TaskQueue;
+    std::mutex QueueMutex;
+    std::condition_variable QueueCondition;
+    bool bShutdown;
+};
+
+/**
+ * FWorkStealingScheduler - adapter so both schedulers share the benchmark code
+ */
+class FWorkStealingScheduler
+{
+public:
+    explicit FWorkStealingScheduler(uint32 InNumThreads)
+        : Graph(InNumThreads)
+    {
+        Graph.Initialize();
+    }
+
+    ~FWorkStealingScheduler()
+    {
+        Graph.Shutdown();
+    }
+
+    void QueueTask(FTask* Task) { Graph.QueueTask(Task); }
+
+private:
+    FTaskGraph Graph;
+};
+
+// Empty task - decrements the outstanding counter, nothing else
+class FEmptyTask : public FTask
+{
+public:
+    std::atomic<int64>* Remaining = nullptr;
+
+    virtual void Execute() override
+    {
+        Remaining->fetch_sub(1, std::memory_order_acq_rel);
+    }
+};
+
+// Root task - queues every child from inside a worker
+template<typename SchedulerType>
+class FFanOutTask : public FTask
+{
+public:
+    SchedulerType* Scheduler = nullptr;
+    std::vector<FEmptyTask>* Children = nullptr;
+
+    virtual void Execute() override
+    {
+        for (FEmptyTask& Child : *Children)
+        {
+            Scheduler->QueueTask(&Child);
+        }
+    }
+};
+
+static void SpinUntilZero(const std::atomic<int64>& Remaining)
+{
+    while (Remaining.load(std::memory_order_acquire) > 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+struct FBenchmarkResult
+{
+    double ExternalTasksPerSec = 0.0;
+    double WorkerTasksPerSec = 0.0;
+    double FanOutMedianUs = 0.0;
+    double FanOutP99Us = 0.0;
+};
+
+template<typename SchedulerType>
+static FBenchmarkResult RunBenchmark(uint32 NumThreads, uint32 NumTasks, uint32 FanOut, uint32 Rounds)
+{
+    FBenchmarkResult Result;
+    SchedulerType Scheduler(NumThreads);
+    std::atomic<int64> Remaining(0);
+
+    // Tasks are preallocated so only scheduling cost is measured
+    std::vector<FEmptyTask> Tasks(NumTasks);
+    for (FEmptyTask& Task : Tasks)
+    {
+        Task.Remaining = &Remaining;
+    }
+
+    // External submission throughput
+    {
+        Remaining = NumTasks;
+        auto Start = FClock::now();
+        for (FEmptyTask& Task : Tasks)
+        {
+            Scheduler.QueueTask(&Task);
+        }
+        SpinUntilZero(Remaining);
+        double Seconds = std::chrono::duration<double>(FClock::now() - Start).count();
+        Result.ExternalTasksPerSec = NumTasks / Seconds;
+    }
+
+    // Worker submission throughput (local deque path for the work-stealing graph)
+    {
+        FFanOutTask<SchedulerType> Root;
+        Root.Scheduler = &Scheduler;
+        Root.Children = &Tasks;
+
+        Remaining = NumTasks;
+        auto Start = FClock::now();
+        Scheduler.QueueTask(&Root);
+        SpinUntilZero(Remaining);
+        double Seconds = std::chrono::duration<double>(FClock::now() - Start).count();
+        Result.WorkerTasksPerSec = NumTasks / Seconds;
+    }
+
+    // Fan-out/fan-in latency
+    {
+        std::vector<FEmptyTask> Children(FanOut);
+        for (FEmptyTask& Child : Children)
+        {
+            Child.Remaining = &Remaining;
+        }
+        FFanOutTask<SchedulerType> Root;
+        Root.Scheduler = &Scheduler;
+        Root.Children = &Children;
+
+        std::vector<double> Samples;
+        Samples.reserve(Rounds);
+        for (uint32 Round = 0; Round < Rounds; ++Round)
+        {
+            Remaining = FanOut;
+            auto Start = FClock::now();
+            Scheduler.QueueTask(&Root);
+            SpinUntilZero(Remaining);
+            Samples.push_back(std::chrono::duration<double, std::micro>(FClock::now() - Start).count());
+        }
+
+        std::sort(Samples.begin(), Samples.end());
+        Result.FanOutMedianUs = Samples[Samples.size() / 2];
+        Result.FanOutP99Us = Samples[std::min<size_t>(Samples.size() - 1, Samples.size() * 99 / 100)];
+    }
+
+    return Result;
+}
+
+int main(int argc, char** argv)
+{
+    uint32 NumTasks = 200000;
+    uint32 FanOut = 256;
+    uint32 Rounds = 200;
+    uint32 MaxThreads = 64;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--tasks") == 0) NumTasks = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--fanout") == 0) FanOut = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--rounds") == 0) Rounds = static_cast<uint32>(atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--max-threads") == 0) MaxThreads = static_cast<uint32>(atoi(argv[i + 1]));
+    }
+
+    printf("TaskGraph benchmark: %u empty tasks, fan-out %u x %u rounds, hardware threads %u\n\n",
+           NumTasks, FanOut, Rounds, std::thread::hardware_concurrency());
+    printf("%-8s %-14s %16s %16s %14s %14s\n",
+           "Threads", "Scheduler", "External Mtask/s", "Worker Mtask/s", "FanOut p50 us", "FanOut p99 us");
+
+    for (uint32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+    {
+        FBenchmarkResult Shared = RunBenchmark<FSharedQueueScheduler>(NumThreads, NumTasks, FanOut, Rounds);
+        FBenchmarkResult Stealing = RunBenchmark<FWorkStealingScheduler>(NumThreads, NumTasks, FanOut, Rounds);
+
+        printf("%-8u %-14s %16.2f %16.2f %14.1f %14.1f\n", NumThreads, "SharedQueue",
+               Shared.ExternalTasksPerSec / 1e6, Shared.WorkerTasksPerSec / 1e6, Shared.FanOutMedianUs, Shared.FanOutP99Us);
+        printf("%-8u %-14s %16.2f %16.2f %14.1f %14.1f\n", NumThreads, "WorkStealing",
+               Stealing.ExternalTasksPerSec / 1e6, Stealing.WorkerTasksPerSec / 1e6, Stealing.FanOutMedianUs, Stealing.FanOutP99Us);
+    }
+
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include "Bounds.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define BOUNDS_USE_SSE 1
+#else
+#define BOUNDS_USE_SSE 0
+#endif
+
+// Extent and radius of unbounded entries; large enough to pass every plane, small enough
+// that summing three of them stays finite
+static constexpr float UnboundedExtent = 1.0e30f;
+
+FBox FBox::Union(const FBox& A, const FBox& B)
+{
+    return FBox(FVector(std::min(A.Min.X, B.Min.X), std::min(A.Min.Y, B.Min.Y), std::min(A.Min.Z, B.Min.Z)),
+                FVector(std::max(A.Max.X, B.Max.X), std::max(A.Max.Y, B.Max.Y), std::max(A.Max.Z, B.Max.Z)));
+}
+
+FBox FBox::ExpandBy(float Margin) const
+{
+    return FBox(FVector(Min.X - Margin, Min.Y - Margin, Min.Z - Margin), FVector(Max.X + Margin, Max.Y + Margin, Max.Z + Margin));
+}
+
+float FBox::GetSurfaceArea() const
+{
+    float dx = Max.X - Min.X;
+    float dy = Max.Y - Min.Y;
+    float dz = Max.Z - Min.Z;
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+float FBox::ComputeSquaredDistanceToPoint(const FVector& Point) const
+{
+    float dx = std::max(std::max(Min.X - Point.X, Point.X - Max.X), 0.0f);
+    float dy = std::max(std::max(Min.Y - Point.Y, Point.Y - Max.Y), 0.0f);
+    float dz = std::max(std::max(Min.Z - Point.Z, Point.Z - Max.Z), 0.0f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+bool FBox::IntersectsRay(const FVector& Origin, const FVector& InvDirection, float MaxDistance, float& OutDistance) const
+{
+    const float origin[3] = { Origin.X, Origin.Y, Origin.Z };
+    const float invDirection[3] = { InvDirection.X, InvDirection.Y, InvDirection.Z };
+    const float minimum[3] = { Min.X, Min.Y, Min.Z };
+    const float maximum[3] = { Max.X, Max.Y, Max.Z };
+
+    float tNear = 0.0f;
+    float tFar = MaxDistance;
+    for (uint32 axis = 0; axis < 3; ++axis)
+    {
+        // An axis-parallel ray has an infinite inverse; outside the slab both ends go the same way
+        float t0 = (minimum[axis] - origin[axis]) * invDirection[axis];
+        float t1 = (maximum[axis] - origin[axis]) * invDirection[axis];
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+        if (std::isnan(t0) || std::isnan(t1))
+        {
+            // Origin on the slab boundary of a parallel ray: inside along this axis
+            if (origin[axis] < minimum[axis] || origin[axis] > maximum[axis])
+            {
+                return false;
+            }
+            continue;
+        }
+        tNear = std::max(tNear, t0);
+        tFar = std::min(tFar, t1);
+        if (tNear > tFar)
+        {
+            return false;
+        }
+    }
+    OutDistance = tNear;
+    return true;
+}
+
+FBoxSphereBounds FBoxSphereBounds::FromPoints(const void* Positions, uint32 NumPoints, uint32 Stride)
+{
+    if (!Positions || NumPoints == 0)
+    {
+        return FBoxSphereBounds();
+    }
+
+    const uint8* bytes = static_cast<const uint8*>(Positions);
+    FVector point;
+    memcpy(&point, bytes, sizeof(FVector));
+    FVector minimum = point;
+    FVector maximum = point;
+    for (uint32 i = 1; i < NumPoints; ++i)
+    {
+        memcpy(&point, bytes + static_cast<size_t>(i) * Stride, sizeof(FVector));
+        minimum = FVector(std::min(minimum.X, point.X), std::min(minimum.Y, point.Y), std::min(minimum.Z, point.Z));
+        maximum = FVector(std::max(maximum.X, point.X), std::max(maximum.Y, point.Y), std::max(maximum.Z, point.Z));
+    }
+
+    FVector origin((minimum.X + maximum.X) * 0.5f, (minimum.Y + maximum.Y) * 0.5f, (minimum.Z + maximum.Z) * 0.5f);
+    FVector extent(maximum.X - origin.X, maximum.Y - origin.Y, maximum.Z - origin.Z);
+
+    // The farthest point, not the box corner: tighter for spheres and cylinders
+    float radiusSquared = 0.0f;
+    for (uint32 i = 0; i < NumPoints; ++i)
+    {
+        memcpy(&point, bytes + static_cast<size_t>(i) * Stride, sizeof(FVector));
+        float dx = point.X - origin.X;
+        float dy = point.Y - origin.Y;
+        float dz = point.Z - origin.Z;
+        radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+    }
+    return FBoxSphereBounds(origin, extent, std::sqrt(radiusSquared));
+}
+
+FBoxSphereBounds FBoxSphereBounds::TransformBy(const FMatrix4x4& Matrix) const
+{
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, Matrix.Matrix);
+
+    // Row i of the upper 3x3 is where the i-th axis goes
+    float origin[3];
+    float extent[3];
+    for (uint32 j = 0; j < 3; ++j)
+    {
+        origin[j] = Origin.X * m.m[0][j] + Origin.Y * m.m[1][j] + Origin.Z * m.m[2][j] + m.m[3][j];
+        extent[j] = BoxExtent.X * std::fabs(m.m[0][j]) + BoxExtent.Y * std::fabs(m.m[1][j]) + BoxExtent.Z * std::fabs(m.m[2][j]);
+    }
+
+    float maxScaleSquared = 0.0f;
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        maxScaleSquared = std::max(maxScaleSquared, m.m[i][0] * m.m[i][0] + m.m[i][1] * m.m[i][1] + m.m[i][2] * m.m[i][2]);
+    }
+
+    return FBoxSphereBounds(FVector(origin[0], origin[1], origin[2]), FVector(extent[0], extent[1], extent[2]),
+                            SphereRadius * std::sqrt(maxScaleSquared));
+}
+
+bool FBoxSphereBounds::IntersectsSphere(const FVector& Center, float Radius) const
+{
+    float dx = Center.X - Origin.X;
+    float dy = Center.Y - Origin.Y;
+    float dz = Center.Z - Origin.Z;
+    float reach = Radius + SphereRadius;
+    if (dx * dx + dy * dy + dz * dz > reach * reach)
+    {
+        return false;
+    }
+
+    // Distance from Center to the nearest point of the box
+    float ox = std::max(std::fabs(dx) - BoxExtent.X, 0.0f);
+    float oy = std::max(std::fabs(dy) - BoxExtent.Y, 0.0f);
+    float oz = std::max(std::fabs(dz) - BoxExtent.Z, 0.0f);
+    return ox * ox + oy * oy + oz * oz <= Radius * Radius;
+}
+
+void FBoundsSoA::Reset(uint32 InNum)
+{
+    NumBounds = InNum;
+    size_t padded = (static_cast<size_t>(InNum) + Alignment - 1) / Alignment * Alignment;
+    for (std::vector<float>* column : { &OriginX, &OriginY, &OriginZ, &ExtentX, &ExtentY, &ExtentZ, &Radius })
+    {
+        column->assign(padded, 0.0f);
+    }
+    for (uint32 i = 0; i < InNum; ++i)
+    {
+        SetUnbounded(i);
+    }
+}
+
+void FBoundsSoA::Set(uint32 Index, const FBoxSphereBounds& Bounds)
+{
+    OriginX[Index] = Bounds.Origin.X;
+    OriginY[Index] = Bounds.Origin.Y;
+    OriginZ[Index] = Bounds.Origin.Z;
+    ExtentX[Index] = Bounds.BoxExtent.X;
+    ExtentY[Index] = Bounds.BoxExtent.Y;
+    ExtentZ[Index] = Bounds.BoxExtent.Z;
+    Radius[Index] = Bounds.SphereRadius;
+}
+
+void FBoundsSoA::SetUnbounded(uint32 Index)
+{
+    Set(Index, FBoxSphereBounds(FVector(), FVector(UnboundedExtent, UnboundedExtent, UnboundedExtent), UnboundedExtent));
+}
+
+FBoxSphereBounds FBoundsSoA::Get(uint32 Index) const
+{
+    return FBoxSphereBounds(FVector(OriginX[Index], OriginY[Index], OriginZ[Index]),
+                            FVector(ExtentX[Index], ExtentY[Index], ExtentZ[Index]), Radius[Index]);
+}
+
+FViewFrustum FViewFrustum::FromViewProjection(const FMatrix4x4& ViewProjection)
+{
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, ViewProjection.Matrix);
+
+    // Row vectors: clip component j is the dot product with column j
+    auto column = [&m](uint32 j)
+    {
+        return FPlane(m.m[0][j], m.m[1][j], m.m[2][j], m.m[3][j]);
+    };
+    auto add = [](const FPlane& A, const FPlane& B, float Sign)
+    {
+        return FPlane(A.X + Sign * B.X, A.Y + Sign * B.Y, A.Z + Sign * B.Z, A.W + Sign * B.W);
+    };
+
+    FPlane x = column(0);
+    FPlane y = column(1);
+    FPlane z = column(2);
+    FPlane w = column(3);
+
+    FViewFrustum frustum;
+    frustum.Planes[Left] = add(w, x, 1.0f);
+    frustum.Planes[Right] = add(w, x, -1.0f);
+    frustum.Planes[Bottom] = add(w, y, 1.0f);
+    frustum.Planes[Top] = add(w, y, -1.0f);
+    frustum.Planes[Near] = z;
+    frustum.Planes[Far] = add(w, z, -1.0f);
+
+    for (FPlane& plane : frustum.Planes)
+    {
+        float length = std::sqrt(plane.X * plane.X + plane.Y * plane.Y + plane.Z * plane.Z);
+        if (length > 0.0f)
+        {
+            plane = FPlane(plane.X / length, plane.Y / length, plane.Z / length, plane.W / length);
+        }
+    }
+    return frustum;
+}
+
+bool FViewFrustum::IntersectsBounds(const FBoxSphereBounds& Bounds) const
+{
+    for (const FPlane& plane : Planes)
+    {
+        // Box or sphere, whichever reaches less far towards the plane
+        float boxRadius = std::fabs(plane.X) * Bounds.BoxExtent.X + std::fabs(plane.Y) * Bounds.BoxExtent.Y +
+                          std::fabs(plane.Z) * Bounds.BoxExtent.Z;
+        if (plane.PlaneDot(Bounds.Origin) + std::min(boxRadius, Bounds.SphereRadius) < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FViewFrustum::IntersectsSphere(const FVector& Center, float Radius) const
+{
+    for (const FPlane& plane : Planes)
+    {
+        if (plane.PlaneDot(Center) + Radius < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32 FViewFrustum::CullBoundsScalar(const FBoundsSoA& Bounds, uint8* OutVisible) const
+{
+    uint32 numVisible = 0;
+    for (uint32 i = 0; i < Bounds.Num(); ++i)
+    {
+        OutVisible[i] = IntersectsBounds(Bounds.Get(i)) ? 1 : 0;
+        numVisible += OutVisible[i];
+    }
+    return numVisible;
+}
+
+uint32 FViewFrustum::CullBounds(const FBoundsSoA& Bounds, uint8* OutVisible) const
+{
+#if BOUNDS_USE_SSE
+    // Plane components broadcast once; the box radius needs the absolute normal
+    __m128 planeX[NumPlanes], planeY[NumPlanes], planeZ[NumPlanes], planeW[NumPlanes];
+    __m128 absX[NumPlanes], absY[NumPlanes], absZ[NumPlanes];
+    for (uint32 p = 0; p < NumPlanes; ++p)
+    {
+        planeX[p] = _mm_set1_ps(Planes[p].X);
+        planeY[p] = _mm_set1_ps(Planes[p].Y);
+        planeZ[p] = _mm_set1_ps(Planes[p].Z);
+        planeW[p] = _mm_set1_ps(Planes[p].W);
+        absX[p] = _mm_set1_ps(std::fabs(Planes[p].X));
+        absY[p] = _mm_set1_ps(std::fabs(Planes[p].Y));
+        absZ[p] = _mm_set1_ps(std::fabs(Planes[p].Z));
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    uint32 numVisible = 0;
+    const uint32 num = Bounds.Num();
+    for (uint32 i = 0; i < num; i += FBoundsSoA::Alignment)
+    {
+        __m128 originX = _mm_loadu_ps(&Bounds.OriginX[i]);
+        __m128 originY = _mm_loadu_ps(&Bounds.OriginY[i]);
+        __m128 originZ = _mm_loadu_ps(&Bounds.OriginZ[i]);
+        __m128 extentX = _mm_loadu_ps(&Bounds.ExtentX[i]);
+        __m128 extentY = _mm_loadu_ps(&Bounds.ExtentY[i]);
+        __m128 extentZ = _mm_loadu_ps(&Bounds.ExtentZ[i]);
+        __m128 radius = _mm_loadu_ps(&Bounds.Radius[i]);
+
+        // Lanes stay set while every plane so far has the bounds (partly) in front
+        int inside = 0xF;
+        for (uint32 p = 0; p < NumPlanes && inside; ++p)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], originX), _mm_mul_ps(planeY[p], originY)),
+                                         _mm_add_ps(_mm_mul_ps(planeZ[p], originZ), planeW[p]));
+            __m128 boxRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], extentX), _mm_mul_ps(absY[p], extentY)),
+                                          _mm_mul_ps(absZ[p], extentZ));
+            __m128 reach = _mm_add_ps(distance, _mm_min_ps(boxRadius, radius));
+            inside &= _mm_movemask_ps(_mm_cmpge_ps(reach, zero));
+        }
+
+        uint32 lanes = std::min(num - i, FBoundsSoA::Alignment);
+        for (uint32 lane = 0; lane < lanes; ++lane)
+        {
+            uint8 bVisible = static_cast<uint8>((inside >> lane) & 1);
+            OutVisible[i + lane] = bVisible;
+            numVisible += bVisible;
+        }
+    }
+    return numVisible;
+#else
+    return CullBoundsScalar(Bounds, OutVisible);
+#endif
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "CoreTypes.h"
+#include <vector>
+
+/**
+ * FBox - Axis-aligned box by its corners
+ */
+struct FBox
+{
+    FVector Min;
+    FVector Max;
+
+    FBox() = default;
+
+    FBox(const FVector& InMin, const FVector& InMax)
+        : Min(InMin)
+        , Max(InMax)
+    {
+    }
+
+    static FBox Union(const FBox& A, const FBox& B);
+
+    // Grown by Margin on every side
+    FBox ExpandBy(float Margin) const;
+
+    bool Contains(const FBox& Other) const
+    {
+        return Min.X <= Other.Min.X && Min.Y <= Other.Min.Y && Min.Z <= Other.Min.Z &&
+               Max.X >= Other.Max.X && Max.Y >= Other.Max.Y && Max.Z >= Other.Max.Z;
+    }
+
+    bool Intersects(const FBox& Other) const
+    {
+        return Min.X <= Other.Max.X && Max.X >= Other.Min.X && Min.Y <= Other.Max.Y && Max.Y >= Other.Min.Y &&
+               Min.Z <= Other.Max.Z && Max.Z >= Other.Min.Z;
+    }
+
+    float GetSurfaceArea() const;
+
+    // Squared distance from Point to the nearest point of the box (0 inside)
+    float ComputeSquaredDistanceToPoint(const FVector& Point) const;
+
+    // Slab test of the ray Origin + t * Direction, 0 <= t <= MaxDistance, given 1 / Direction per
+    // axis; OutDistance is where it enters the box (0 if Origin is inside)
+    bool IntersectsRay(const FVector& Origin, const FVector& InvDirection, float MaxDistance, float& OutDistance) const;
+};
+
+/**
+ * FBoxSphereBounds - Axis-aligned box and bounding sphere sharing one origin
+ * Similar in spirit to UE5's FBoxSphereBounds
+ *
+ * Meshes compute theirs once in mesh space; TransformBy() moves them into
+ * world space with a model matrix, keeping the box axis-aligned (it grows
+ * to enclose the rotated box) and scaling the radius by the largest axis
+ * scale. The two are tested together: whichever is tighter along a plane
+ * decides.
+ */
+struct FBoxSphereBounds
+{
+    FVector Origin;
+    FVector BoxExtent;      // Half size of the box along each axis
+    float SphereRadius;
+
+    FBoxSphereBounds()
+        : SphereRadius(0.0f)
+    {
+    }
+
+    FBoxSphereBounds(const FVector& InOrigin, const FVector& InBoxExtent, float InSphereRadius)
+        : Origin(InOrigin)
+        , BoxExtent(InBoxExtent)
+        , SphereRadius(InSphereRadius)
+    {
+    }
+
+    // Box around NumPoints positions Stride bytes apart (the first member of a vertex);
+    // the sphere is centered on the box and just reaches the farthest point
+    static FBoxSphereBounds FromPoints(const void* Positions, uint32 NumPoints, uint32 Stride);
+
+    // Bounds of the transformed box and sphere (row-vector matrix, as FMatrix4x4 is used)
+    FBoxSphereBounds TransformBy(const FMatrix4x4& Matrix) const;
+
+    // Whether both the box and the sphere touch the sphere at Center (a point light's reach)
+    bool IntersectsSphere(const FVector& Center, float Radius) const;
+
+    FBox GetBox() const
+    {
+        return FBox(FVector(Origin.X - BoxExtent.X, Origin.Y - BoxExtent.Y, Origin.Z - BoxExtent.Z),
+                    FVector(Origin.X + BoxExtent.X, Origin.Y + BoxExtent.Y, Origin.Z + BoxExtent.Z));
+    }
+};
+
+/**
+ * FPlane - Plane X*x + Y*y + Z*z + W = 0; points with a positive distance are in front
+ */
+struct FPlane
+{
+    float X, Y, Z, W;
+
+    FPlane(float InX = 0.0f, float InY = 0.0f, float InZ = 0.0f, float InW = 0.0f)
+        : X(InX), Y(InY), Z(InZ), W(InW)
+    {
+    }
+
+    float PlaneDot(const FVector& Point) const { return X * Point.X + Y * Point.Y + Z * Point.Z + W; }
+};
+
+/**
+ * FBoundsSoA - Bounds of many primitives, one array per component
+ * Laid out for FViewFrustum::CullBounds, which tests four entries per
+ * instruction. The arrays are padded to a multiple of four; padding entries
+ * are never reported.
+ */
+class FBoundsSoA
+{
+public:
+    static constexpr uint32 Alignment = 4;
+
+    // Num entries, all unbounded until Set
+    void Reset(uint32 InNum);
+
+    void Set(uint32 Index, const FBoxSphereBounds& Bounds);
+
+    // Always passes the frustum test (proxies without bounds)
+    void SetUnbounded(uint32 Index);
+
+    FBoxSphereBounds Get(uint32 Index) const;
+
+    uint32 Num() const { return NumBounds; }
+
+    std::vector<float> OriginX, OriginY, OriginZ;
+    std::vector<float> ExtentX, ExtentY, ExtentZ;
+    std::vector<float> Radius;
+
+private:
+    uint32 NumBounds = 0;
+};
+
+/**
+ * FViewFrustum - Six inward-facing planes of a view-projection
+ * Planes are taken straight from the matrix (Gribb / Hartmann), for the
+ * D3D clip volume -w <= x, y <= w, 0 <= z <= w, and normalized so plane
+ * distances are in world units.
+ */
+struct FViewFrustum
+{
+    enum EPlane
+    {
+        Left, Right, Bottom, Top, Near, Far,
+        NumPlanes
+    };
+
+    FPlane Planes[NumPlanes];
+
+    static FViewFrustum FromViewProjection(const FMatrix4x4& ViewProjection);
+
+    // Whether Bounds may be inside: false only if the box or the sphere is wholly behind a plane
+    bool IntersectsBounds(const FBoxSphereBounds& Bounds) const;
+    bool IntersectsSphere(const FVector& Center, float Radius) const;
+
+    // Batch test of every entry; OutVisible[i] is 1 if Bounds entry i may be inside, else 0.
+    // OutVisible needs Bounds.Num() entries. Returns the number visible. Runs four entries at a
+    // time with SSE where available, and gives the same results as IntersectsBounds
+    uint32 CullBounds(const FBoundsSoA& Bounds, uint8* OutVisible) const;
+
+    // One entry at a time, for comparison with CullBounds
+    uint32 CullBoundsScalar(const FBoundsSoA& Bounds, uint8* OutVisible) const;
+};
@@ -1,10 +1,15 @@
 #include "CoreTypes.h"
 #include <fstream>
+#include <mutex>
 
 static std::ofstream logFile;
+static std::mutex logMutex;
 
 void FLog::Log(ELogLevel Level, const std::string& Message)
 {
+    // Worker threads log too (e.g. PSO precaching)
+    std::lock_guard<std::mutex> lock(logMutex);
+    
     // Open log file on first use
     if (!logFile.is_open())
     {
@@ -0,0 +1,423 @@
+#include "DynamicBVH.h"
+#include <cstdlib>
+
+FDynamicBVH::FDynamicBVH(float InMargin)
+    : Root(NullIndex)
+    , FreeNodes(NullIndex)
+    , FreeProxies(NullIndex)
+    , NumProxies(0)
+    , Margin(InMargin)
+{
+}
+
+uint32 FDynamicBVH::CreateProxy(const FBox& Box, void* UserData)
+{
+    uint32 proxyId;
+    if (FreeProxies != NullIndex)
+    {
+        proxyId = FreeProxies;
+        FreeProxies = Proxies[proxyId].NextFree;
+    }
+    else
+    {
+        proxyId = static_cast<uint32>(Proxies.size());
+        Proxies.push_back(FProxy());
+    }
+
+    uint32 leaf = AllocateNode();
+    Nodes[leaf].Box = Box.ExpandBy(Margin);
+    Nodes[leaf].Height = 0;
+    Nodes[leaf].ProxyId = proxyId;
+
+    Proxies[proxyId].Node = leaf;
+    Proxies[proxyId].NextFree = NullIndex;
+    Proxies[proxyId].UserData = UserData;
+    ++NumProxies;
+
+    InsertLeaf(leaf);
+    return proxyId;
+}
+
+void FDynamicBVH::DestroyProxy(uint32 ProxyId)
+{
+    uint32 leaf = Proxies[ProxyId].Node;
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+
+    Proxies[ProxyId].Node = NullIndex;
+    Proxies[ProxyId].UserData = nullptr;
+    Proxies[ProxyId].NextFree = FreeProxies;
+    FreeProxies = ProxyId;
+    --NumProxies;
+}
+
+bool FDynamicBVH::MoveProxy(uint32 ProxyId, const FBox& Box)
+{
+    uint32 leaf = Proxies[ProxyId].Node;
+    const FBox& fatBox = Nodes[leaf].Box;
+
+    // Still inside, and the fat box has not become much larger than it (a shrunk proxy)
+    if (fatBox.Contains(Box) && Box.ExpandBy(4.0f * Margin).Contains(fatBox))
+    {
+        return false;
+    }
+
+    RemoveLeaf(leaf);
+    Nodes[leaf].Box = Box.ExpandBy(Margin);
+    InsertLeaf(leaf);
+    return true;
+}
+
+void FDynamicBVH::Clear()
+{
+    Nodes.clear();
+    Proxies.clear();
+    Root = NullIndex;
+    FreeNodes = NullIndex;
+    FreeProxies = NullIndex;
+    NumProxies = 0;
+}
+
+void FDynamicBVH::Compact()
+{
+    std::vector<FNode> compacted;
+    compacted.reserve(GetNumNodes());
+
+    if (Root != NullIndex)
+    {
+        // Pre-order: each node, then its first subtree, then its second. A node is written
+        // when popped and patches the slot in its new parent that it fills
+        struct FEntry
+        {
+            uint32 Node;
+            uint32 NewParent;
+            bool bSecondChild;
+        };
+        FEntry stack[MaxStackDepth];
+        uint32 stackSize = 0;
+        stack[stackSize++] = { Root, NullIndex, false };
+        while (stackSize > 0)
+        {
+            FEntry entry = stack[--stackSize];
+            uint32 newIndex = static_cast<uint32>(compacted.size());
+            compacted.push_back(Nodes[entry.Node]);
+            FNode& node = compacted.back();
+            node.Parent = entry.NewParent;
+            if (entry.NewParent != NullIndex)
+            {
+                FNode& parent = compacted[entry.NewParent];
+                (entry.bSecondChild ? parent.Child2 : parent.Child1) = newIndex;
+            }
+
+            if (node.IsLeaf())
+            {
+                Proxies[node.ProxyId].Node = newIndex;
+                continue;
+            }
+            stack[stackSize++] = { node.Child2, newIndex, true };
+            stack[stackSize++] = { node.Child1, newIndex, false };
+        }
+    }
+
+    Nodes.swap(compacted);
+    Root = Nodes.empty() ? NullIndex : 0;
+    FreeNodes = NullIndex;
+}
+
+float FDynamicBVH::GetAreaRatio() const
+{
+    if (Root == NullIndex)
+    {
+        return 0.0f;
+    }
+
+    float rootArea = Nodes[Root].Box.GetSurfaceArea();
+    float totalArea = 0.0f;
+    for (const FNode& node : Nodes)
+    {
+        if (node.Height > 0)
+        {
+            totalArea += node.Box.GetSurfaceArea();
+        }
+    }
+    return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+}
+
+bool FDynamicBVH::Validate() const
+{
+    if (Root == NullIndex)
+    {
+        return NumProxies == 0;
+    }
+    if (Nodes[Root].Parent != NullIndex)
+    {
+        return false;
+    }
+
+    uint32 numLeaves = 0;
+    uint32 stack[MaxStackDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = Root;
+    while (stackSize > 0)
+    {
+        uint32 nodeIndex = stack[--stackSize];
+        const FNode& node = Nodes[nodeIndex];
+        if (node.IsLeaf())
+        {
+            if (node.Height != 0 || node.Child2 != NullIndex || Proxies[node.ProxyId].Node != nodeIndex)
+            {
+                return false;
+            }
+            ++numLeaves;
+            continue;
+        }
+
+        const FNode& child1 = Nodes[node.Child1];
+        const FNode& child2 = Nodes[node.Child2];
+        if (child1.Parent != nodeIndex || child2.Parent != nodeIndex)
+        {
+            return false;
+        }
+        if (node.Height != 1 + std::max(child1.Height, child2.Height) || std::abs(child1.Height - child2.Height) > 1)
+        {
+            return false;
+        }
+        if (!node.Box.Contains(child1.Box) || !node.Box.Contains(child2.Box))
+        {
+            return false;
+        }
+        if (stackSize + 2 > MaxStackDepth)
+        {
+            return false;
+        }
+        stack[stackSize++] = node.Child1;
+        stack[stackSize++] = node.Child2;
+    }
+    return numLeaves == NumProxies;
+}
+
+uint32 FDynamicBVH::AllocateNode()
+{
+    uint32 nodeIndex;
+    if (FreeNodes != NullIndex)
+    {
+        nodeIndex = FreeNodes;
+        FreeNodes = Nodes[nodeIndex].Parent;
+    }
+    else
+    {
+        nodeIndex = static_cast<uint32>(Nodes.size());
+        Nodes.push_back(FNode());
+    }
+
+    FNode& node = Nodes[nodeIndex];
+    node.Parent = NullIndex;
+    node.Child1 = NullIndex;
+    node.Child2 = NullIndex;
+    node.Height = 0;
+    node.ProxyId = NullIndex;
+    return nodeIndex;
+}
+
+void FDynamicBVH::FreeNode(uint32 NodeIndex)
+{
+    Nodes[NodeIndex].Parent = FreeNodes;
+    Nodes[NodeIndex].Height = -1;
+    FreeNodes = NodeIndex;
+}
+
+void FDynamicBVH::InsertLeaf(uint32 Leaf)
+{
+    if (Root == NullIndex)
+    {
+        Root = Leaf;
+        Nodes[Root].Parent = NullIndex;
+        return;
+    }
+
+    // Walk down to the sibling that adds the least surface area: pairing with a node costs
+    // the new parent's area, and every ancestor above it grows by the same amount
+    const FBox leafBox = Nodes[Leaf].Box;
+    uint32 index = Root;
+    while (!Nodes[index].IsLeaf())
+    {
+        const FNode& node = Nodes[index];
+        float area = node.Box.GetSurfaceArea();
+        float combinedArea = FBox::Union(node.Box, leafBox).GetSurfaceArea();
+
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](uint32 Child)
+        {
+            const FNode& child = Nodes[Child];
+            float unionArea = FBox::Union(child.Box, leafBox).GetSurfaceArea();
+            return (child.IsLeaf() ? unionArea : unionArea - child.Box.GetSurfaceArea()) + inheritanceCost;
+        };
+        float cost1 = descendCost(node.Child1);
+        float cost2 = descendCost(node.Child2);
+
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+        index = cost1 < cost2 ? node.Child1 : node.Child2;
+    }
+    uint32 sibling = index;
+
+    // A new parent takes the sibling's place, with the sibling and the leaf below it
+    uint32 oldParent = Nodes[sibling].Parent;
+    uint32 newParent = AllocateNode();
+    Nodes[newParent].Parent = oldParent;
+    Nodes[newParent].Box = FBox::Union(leafBox, Nodes[sibling].Box);
+    Nodes[newParent].Height = Nodes[sibling].Height + 1;
+    Nodes[newParent].Child1 = sibling;
+    Nodes[newParent].Child2 = Leaf;
+    Nodes[sibling].Parent = newParent;
+    Nodes[Leaf].Parent = newParent;
+
+    if (oldParent == NullIndex)
+    {
+        Root = newParent;
+    }
+    else if (Nodes[oldParent].Child1 == sibling)
+    {
+        Nodes[oldParent].Child1 = newParent;
+    }
+    else
+    {
+        Nodes[oldParent].Child2 = newParent;
+    }
+
+    RefitAncestors(Nodes[Leaf].Parent);
+}
+
+void FDynamicBVH::RemoveLeaf(uint32 Leaf)
+{
+    if (Leaf == Root)
+    {
+        Root = NullIndex;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    uint32 parent = Nodes[Leaf].Parent;
+    uint32 grandParent = Nodes[parent].Parent;
+    uint32 sibling = Nodes[parent].Child1 == Leaf ? Nodes[parent].Child2 : Nodes[parent].Child1;
+
+    if (grandParent == NullIndex)
+    {
+        Root = sibling;
+        Nodes[sibling].Parent = NullIndex;
+        FreeNode(parent);
+        return;
+    }
+
+    if (Nodes[grandParent].Child1 == parent)
+    {
+        Nodes[grandParent].Child1 = sibling;
+    }
+    else
+    {
+        Nodes[grandParent].Child2 = sibling;
+    }
+    Nodes[sibling].Parent = grandParent;
+    FreeNode(parent);
+
+    RefitAncestors(grandParent);
+}
+
+void FDynamicBVH::RefitAncestors(uint32 NodeIndex)
+{
+    while (NodeIndex != NullIndex)
+    {
+        NodeIndex = Balance(NodeIndex);
+
+        FNode& node = Nodes[NodeIndex];
+        const FNode& child1 = Nodes[node.Child1];
+        const FNode& child2 = Nodes[node.Child2];
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+        node.Box = FBox::Union(child1.Box, child2.Box);
+
+        NodeIndex = node.Parent;
+    }
+}
+
+uint32 FDynamicBVH::Balance(uint32 IndexA)
+{
+    const FNode& nodeA = Nodes[IndexA];
+    if (nodeA.IsLeaf() || nodeA.Height < 2)
+    {
+        return IndexA;
+    }
+
+    uint32 indexB = nodeA.Child1;
+    uint32 indexC = nodeA.Child2;
+    int32 balance = Nodes[indexC].Height - Nodes[indexB].Height;
+
+    // Promote the taller child: it becomes the subtree root, A takes one of its children and
+    // the shorter grandchild stays where A was
+    auto rotateUp = [this, IndexA](uint32 IndexUp, uint32 IndexOther, bool bUpIsChild2) -> uint32
+    {
+        FNode& a = Nodes[IndexA];
+        FNode& up = Nodes[IndexUp];
+        uint32 indexF = up.Child1;
+        uint32 indexG = up.Child2;
+        FNode& f = Nodes[indexF];
+        FNode& g = Nodes[indexG];
+
+        // Up replaces A
+        up.Child1 = IndexA;
+        up.Parent = a.Parent;
+        a.Parent = IndexUp;
+        if (up.Parent != NullIndex)
+        {
+            FNode& upParent = Nodes[up.Parent];
+            if (upParent.Child1 == IndexA)
+            {
+                upParent.Child1 = IndexUp;
+            }
+            else
+            {
+                upParent.Child2 = IndexUp;
+            }
+        }
+        else
+        {
+            Root = IndexUp;
+        }
+
+        // The taller grandchild stays with Up, the shorter one moves to A
+        const FNode& other = Nodes[IndexOther];
+        uint32 indexKeep = f.Height > g.Height ? indexF : indexG;
+        uint32 indexMove = f.Height > g.Height ? indexG : indexF;
+        up.Child2 = indexKeep;
+        if (bUpIsChild2)
+        {
+            a.Child2 = indexMove;
+        }
+        else
+        {
+            a.Child1 = indexMove;
+        }
+        Nodes[indexMove].Parent = IndexA;
+
+        FNode& keep = Nodes[indexKeep];
+        FNode& move = Nodes[indexMove];
+        a.Box = FBox::Union(other.Box, move.Box);
+        up.Box = FBox::Union(a.Box, keep.Box);
+        a.Height = 1 + std::max(other.Height, move.Height);
+        up.Height = 1 + std::max(a.Height, keep.Height);
+        return IndexUp;
+    };
+
+    if (balance > 1)
+    {
+        return rotateUp(indexC, indexB, true);
+    }
+    if (balance < -1)
+    {
+        return rotateUp(indexB, indexC, false);
+    }
+    return IndexA;
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+#include "CoreTypes.h"
+#include "Bounds.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * FDynamicBVH - Incrementally updated bounding volume hierarchy of AABBs
+ * Similar in spirit to Box2D's b2DynamicTree and Bullet's btDbvt
+ *
+ * Every proxy is a leaf holding a "fat" box: its bounds grown by a margin,
+ * so small moves stay inside it and MoveProxy() does nothing. A proxy that
+ * leaves its fat box is removed and reinserted. Inserting walks down to the
+ * sibling with the lowest surface area cost; on the way back up every
+ * ancestor is refit and rebalanced with AVL-style rotations, so the tree
+ * stays O(log n) deep whatever the insertion order.
+ *
+ * Nodes live in one array with a free list. Proxy ids are stable handles
+ * that map to nodes through a table, so Compact() can reorder the nodes
+ * depth first (each left child directly after its parent, subtrees
+ * contiguous) for cache-friendly traversal without invalidating them.
+ *
+ * Queries call Visitor(ProxyId) for each proxy whose fat box passes; a
+ * visitor returning false stops the query. A subtree whose box lies wholly
+ * inside the query volume is accepted without testing its nodes. Query
+ * results are conservative (fat boxes): test the exact bounds where needed.
+ *
+ * Not thread-safe for updates; concurrent queries are fine.
+ */
+class FDynamicBVH
+{
+public:
+    static constexpr uint32 NullIndex = 0xFFFFFFFFu;
+
+    // Traversal stack size; balancing keeps the height far below it
+    static constexpr uint32 MaxStackDepth = 256;
+
+    explicit FDynamicBVH(float InMargin = 0.1f);
+
+    // Add a proxy with bounds Box; returns its id. UserData is returned by GetUserData
+    uint32 CreateProxy(const FBox& Box, void* UserData);
+    void DestroyProxy(uint32 ProxyId);
+
+    // New bounds for a proxy; returns true if it left its fat box and was reinserted
+    bool MoveProxy(uint32 ProxyId, const FBox& Box);
+
+    void* GetUserData(uint32 ProxyId) const { return Proxies[ProxyId].UserData; }
+    const FBox& GetFatBox(uint32 ProxyId) const { return Nodes[Proxies[ProxyId].Node].Box; }
+
+    // Remove every proxy
+    void Clear();
+
+    // Lay the nodes out depth first and drop the free ones; proxy ids are kept
+    void Compact();
+
+    // Queries; Visitor is bool(uint32 ProxyId)
+    template <typename TVisitor>
+    void QueryBox(const FBox& Box, TVisitor&& Visitor) const;
+
+    template <typename TVisitor>
+    void QuerySphere(const FVector& Center, float Radius, TVisitor&& Visitor) const;
+
+    template <typename TVisitor>
+    void QueryFrustum(const FViewFrustum& Frustum, TVisitor&& Visitor) const;
+
+    // Proxies whose fat box the ray Origin + t * Direction (0 <= t <= MaxDistance) enters, nearer
+    // subtrees first. Visitor is float(uint32 ProxyId, float MaxDistance) and returns the new
+    // MaxDistance: MaxDistance to go on, a hit distance to look only for closer proxies, a
+    // negative value to stop
+    template <typename TVisitor>
+    void RayCast(const FVector& Origin, const FVector& Direction, float MaxDistance, TVisitor&& Visitor) const;
+
+    uint32 GetNumProxies() const { return NumProxies; }
+    uint32 GetNumNodes() const { return NumProxies > 0 ? NumProxies * 2 - 1 : 0; }
+
+    // Longest root to leaf path (0 for a lone leaf or an empty tree)
+    uint32 GetHeight() const { return Root != NullIndex ? static_cast<uint32>(Nodes[Root].Height) : 0; }
+
+    // Summed surface area of the internal nodes over the root's; lower is a better tree
+    float GetAreaRatio() const;
+
+    // Check parent links, heights, balance and enclosing boxes; for tests
+    bool Validate() const;
+
+private:
+    struct FNode
+    {
+        FBox Box;
+        uint32 Parent;      // Next free node while on the free list
+        uint32 Child1;      // NullIndex for leaves
+        uint32 Child2;
+        int32 Height;       // 0 for leaves, -1 when free
+        uint32 ProxyId;     // Leaves only
+
+        bool IsLeaf() const { return Child1 == NullIndex; }
+    };
+
+    struct FProxy
+    {
+        uint32 Node;        // NullIndex when the id is free; then NextFree links free ids
+        uint32 NextFree;
+        void* UserData;
+    };
+
+    uint32 AllocateNode();
+    void FreeNode(uint32 NodeIndex);
+
+    void InsertLeaf(uint32 Leaf);
+    void RemoveLeaf(uint32 Leaf);
+
+    // Rotate NodeIndex's subtree if its children's heights differ by more than one; returns
+    // the subtree's new root
+    uint32 Balance(uint32 NodeIndex);
+
+    // Refit boxes and heights from NodeIndex up to the root, rebalancing on the way
+    void RefitAncestors(uint32 NodeIndex);
+
+    // Call Visitor for every leaf below NodeIndex without testing; false if it stopped
+    template <typename TVisitor>
+    bool VisitSubtree(uint32 NodeIndex, TVisitor& Visitor) const;
+
+    std::vector<FNode> Nodes;
+    std::vector<FProxy> Proxies;
+    uint32 Root;
+    uint32 FreeNodes;
+    uint32 FreeProxies;
+    uint32 NumProxies;
+    float Margin;
+};
+
+template <typename TVisitor>
+bool FDynamicBVH::VisitSubtree(uint32 NodeIndex, TVisitor& Visitor) const
+{
+    uint32 stack[MaxStackDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = NodeIndex;
+    while (stackSize > 0)
+    {
+        const FNode& node = Nodes[stack[--stackSize]];
+        if (node.IsLeaf())
+        {
+            if (!Visitor(node.ProxyId))
+            {
+                return false;
+            }
+            continue;
+        }
+        stack[stackSize++] = node.Child2;
+        stack[stackSize++] = node.Child1;
+    }
+    return true;
+}
+
+template <typename TVisitor>
+void FDynamicBVH::QueryBox(const FBox& Box, TVisitor&& Visitor) const
+{
+    if (Root == NullIndex)
+    {
+        return;
+    }
+
+    uint32 stack[MaxStackDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = Root;
+    while (stackSize > 0)
+    {
+        uint32 nodeIndex = stack[--stackSize];
+        const FNode& node = Nodes[nodeIndex];
+        if (!node.Box.Intersects(Box))
+        {
+            continue;
+        }
+        if (node.IsLeaf() || Box.Contains(node.Box))
+        {
+            if (!VisitSubtree(nodeIndex, Visitor))
+            {
+                return;
+            }
+            continue;
+        }
+        stack[stackSize++] = node.Child2;
+        stack[stackSize++] = node.Child1;
+    }
+}
+
+template <typename TVisitor>
+void FDynamicBVH::QuerySphere(const FVector& Center, float Radius, TVisitor&& Visitor) const
+{
+    if (Root == NullIndex)
+    {
+        return;
+    }
+
+    const float radiusSquared = Radius * Radius;
+    uint32 stack[MaxStackDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = Root;
+    while (stackSize > 0)
+    {
+        uint32 nodeIndex = stack[--stackSize];
+        const FNode& node = Nodes[nodeIndex];
+        if (node.Box.ComputeSquaredDistanceToPoint(Center) > radiusSquared)
+        {
+            continue;
+        }
+
+        // Wholly inside when the farthest corner is
+        float dx = std::max(Center.X - node.Box.Min.X, node.Box.Max.X - Center.X);
+        float dy = std::max(Center.Y - node.Box.Min.Y, node.Box.Max.Y - Center.Y);
+        float dz = std::max(Center.Z - node.Box.Min.Z, node.Box.Max.Z - Center.Z);
+        if (node.IsLeaf() || dx * dx + dy * dy + dz * dz <= radiusSquared)
+        {
+            if (!VisitSubtree(nodeIndex, Visitor))
+            {
+                return;
+            }
+            continue;
+        }
+        stack[stackSize++] = node.Child2;
+        stack[stackSize++] = node.Child1;
+    }
+}
+
+template <typename TVisitor>
+void FDynamicBVH::QueryFrustum(const FViewFrustum& Frustum, TVisitor&& Visitor) const
+{
+    if (Root == NullIndex)
+    {
+        return;
+    }
+
+    // Each entry carries the planes its box still straddles; a box in front of a plane is
+    // in front of it for the whole subtree, so children skip it
+    constexpr uint32 AllPlanes = (1u << FViewFrustum::NumPlanes) - 1;
+    struct FEntry
+    {
+        uint32 Node;
+        uint32 PlaneMask;
+    };
+    FEntry stack[MaxStackDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = { Root, AllPlanes };
+    while (stackSize > 0)
+    {
+        FEntry entry = stack[--stackSize];
+        const FNode& node = Nodes[entry.Node];
+        FVector center((node.Box.Min.X + node.Box.Max.X) * 0.5f, (node.Box.Min.Y + node.Box.Max.Y) * 0.5f,
+                       (node.Box.Min.Z + node.Box.Max.Z) * 0.5f);
+        FVector extent(node.Box.Max.X - center.X, node.Box.Max.Y - center.Y, node.Box.Max.Z - center.Z);
+
+        uint32 planeMask = entry.PlaneMask;
+        bool bOutside = false;
+        for (uint32 p = 0; p < FViewFrustum::NumPlanes; ++p)
+        {
+            if (!(planeMask & (1u << p)))
+            {
+                continue;
+            }
+            const FPlane& plane = Frustum.Planes[p];
+            float distance = plane.PlaneDot(center);
+            float radius = std::fabs(plane.X) * extent.X + std::fabs(plane.Y) * extent.Y + std::fabs(plane.Z) * extent.Z;
+            if (distance + radius < 0.0f)
+            {
+                bOutside = true;
+                break;
+            }
+            if (distance - radius >= 0.0f)
+            {
+                planeMask &= ~(1u << p);
+            }
+        }
+        if (bOutside)
+        {
+            continue;
+        }
+        if (node.IsLeaf() || planeMask == 0)
+        {
+            if (!VisitSubtree(entry.Node, Visitor))
+            {
+                return;
+            }
+            continue;
+        }
+        stack[stackSize++] = { node.Child2, planeMask };
+        stack[stackSize++] = { node.Child1, planeMask };
+    }
+}
+
+template <typename TVisitor>
+void FDynamicBVH::RayCast(const FVector& Origin, const FVector& Direction, float MaxDistance, TVisitor&& Visitor) const
+{
+    if (Root == NullIndex)
+    {
+        return;
+    }
+
+    // Division by zero gives the infinities the slab test expects
+    FVector invDirection(1.0f / Direction.X, 1.0f / Direction.Y, 1.0f / Direction.Z);
+
+    uint32 stack[MaxStackDepth];
+    uint32 stackSize = 0;
+    stack[stackSize++] = Root;
+    while (stackSize > 0)
+    {
+        const FNode& node = Nodes[stack[--stackSize]];
+        float distance;
+        if (!node.Box.IntersectsRay(Origin, invDirection, MaxDistance, distance))
+        {
+            continue;
+        }
+        if (node.IsLeaf())
+        {
+            MaxDistance = Visitor(node.ProxyId, MaxDistance);
+            if (MaxDistance < 0.0f)
+            {
+                return;
+            }
+            continue;
+        }
+
+        // Nearer child on top, so a closest-hit search clips the farther one
+        float distance1 = 0.0f;
+        float distance2 = 0.0f;
+        bool bHit1 = Nodes[node.Child1].Box.IntersectsRay(Origin, invDirection, MaxDistance, distance1);
+        bool bHit2 = Nodes[node.Child2].Box.IntersectsRay(Origin, invDirection, MaxDistance, distance2);
+        if (bHit1 && bHit2)
+        {
+            bool bFirstNearer = distance1 <= distance2;
+            stack[stackSize++] = bFirstNearer ? node.Child2 : node.Child1;
+            stack[stackSize++] = bFirstNearer ? node.Child1 : node.Child2;
+        }
+        else if (bHit1)
+        {
+            stack[stackSize++] = node.Child1;
+        }
+        else if (bHit2)
+        {
+            stack[stackSize++] = node.Child2;
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#include "FrameAllocator.h"
+#include <cstdlib>
+#include <new>
+
+// Generations are unique across all allocators, so a thread's cached block can
+// never be mistaken for one of a different (or re-created) allocator
+static std::atomic<uint64> GNextFrameAllocatorGeneration(1);
+
+struct FThreadFrameBlock
+{
+    uint64 Generation = 0;
+    void* Block = nullptr;
+};
+
+static thread_local FThreadFrameBlock GThreadFrameBlock;
+
+static uint8* AlignPointer(uint8* Pointer, size_t Alignment)
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(Pointer);
+    return reinterpret_cast<uint8*>((address + Alignment - 1) & ~static_cast<uintptr_t>(Alignment - 1));
+}
+
+std::unique_ptr<FFrameAllocator> FFrameAllocator::Singleton;
+
+FFrameAllocator::FFrameAllocator()
+    : UsedBlocks(nullptr)
+    , FreeBlocks(nullptr)
+    , NumAllocatedBlocks(0)
+    , Generation(GNextFrameAllocatorGeneration.fetch_add(1))
+    , LastFrameBytes(0)
+    , LastFrameBlocks(0)
+{
+}
+
+FFrameAllocator::~FFrameAllocator()
+{
+    Reset();
+    while (FreeBlocks)
+    {
+        FBlock* next = FreeBlocks->Next;
+        std::free(FreeBlocks);
+        FreeBlocks = next;
+    }
+}
+
+void* FFrameAllocator::Allocate(size_t Size, size_t Alignment)
+{
+    FThreadFrameBlock& threadBlock = GThreadFrameBlock;
+    uint64 generation = Generation.load(std::memory_order_relaxed);
+
+    if (threadBlock.Generation == generation)
+    {
+        FBlock* block = static_cast<FBlock*>(threadBlock.Block);
+        uint8* memory = AlignPointer(block->Cursor, Alignment);
+        if (memory + Size <= block->End)
+        {
+            block->Cursor = memory + Size;
+            return memory;
+        }
+    }
+
+    FBlock* block = AcquireBlock(Size, Alignment);
+    uint8* memory = AlignPointer(block->Cursor, Alignment);
+    block->Cursor = memory + Size;
+
+    // Keep bumping through a regular block; an oversized one is full already
+    if (!block->bOversized)
+    {
+        threadBlock.Generation = generation;
+        threadBlock.Block = block;
+    }
+    return memory;
+}
+
+FFrameAllocator::FBlock* FFrameAllocator::AcquireBlock(size_t Size, size_t Alignment)
+{
+    size_t headerSize = (sizeof(FBlock) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    size_t required = headerSize + Size + Alignment;
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    FBlock* block = nullptr;
+    if (required > BlockSize)
+    {
+        void* memory = std::malloc(required);
+        if (!memory)
+        {
+            throw std::bad_alloc();
+        }
+        block = static_cast<FBlock*>(memory);
+        block->End = static_cast<uint8*>(memory) + required;
+        block->bOversized = true;
+    }
+    else if (FreeBlocks)
+    {
+        block = FreeBlocks;
+        FreeBlocks = block->Next;
+    }
+    else
+    {
+        void* memory = std::malloc(BlockSize);
+        if (!memory)
+        {
+            throw std::bad_alloc();
+        }
+        block = static_cast<FBlock*>(memory);
+        block->End = static_cast<uint8*>(memory) + BlockSize;
+        block->bOversized = false;
+        ++NumAllocatedBlocks;
+    }
+
+    block->Cursor = reinterpret_cast<uint8*>(block) + headerSize;
+    block->Next = UsedBlocks;
+    UsedBlocks = block;
+    return block;
+}
+
+void FFrameAllocator::Reset()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    size_t headerSize = (sizeof(FBlock) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    size_t bytes = 0;
+    uint32 blocks = 0;
+    while (UsedBlocks)
+    {
+        FBlock* block = UsedBlocks;
+        UsedBlocks = block->Next;
+        bytes += static_cast<size_t>(block->Cursor - (reinterpret_cast<uint8*>(block) + headerSize));
+        ++blocks;
+
+        if (block->bOversized)
+        {
+            std::free(block);
+        }
+        else
+        {
+            block->Next = FreeBlocks;
+            FreeBlocks = block;
+        }
+    }
+    LastFrameBytes = bytes;
+    LastFrameBlocks = blocks;
+
+    // Invalidates every thread's cached block
+    Generation.store(GNextFrameAllocatorGeneration.fetch_add(1), std::memory_order_relaxed);
+}
+
+FFrameAllocator& FFrameAllocator::Get()
+{
+    if (!Singleton)
+    {
+        Singleton = std::make_unique<FFrameAllocator>();
+    }
+    return *Singleton;
+}
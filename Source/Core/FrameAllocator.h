@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * FFrameAllocator - per-frame linear (bump) allocator
+ * Similar in spirit to UE5's FMemStack / FConcurrentLinearAllocator
+ *
+ * Memory is carved out of BlockSize blocks. Every thread bumps through its
+ * own current block, so an allocation is a pointer increment with no locking;
+ * the mutex is only taken when a thread needs a new block. Nothing is freed
+ * individually: Reset() recycles all blocks at once and every pointer handed
+ * out since the previous Reset() becomes invalid.
+ *
+ * Reset() must not race with Allocate() - call it once the frame's work
+ * (including parallel tasks) has finished. Destructors of objects placed in
+ * frame memory are not run by Reset(); use it for trivially destructible data
+ * or containers that are destroyed before the frame ends.
+ *
+ * Each thread caches one block for the allocator it used last; threads that
+ * alternate between allocators take a fresh block on every switch.
+ */
+class FFrameAllocator
+{
+public:
+    static constexpr size_t BlockSize = 64 * 1024;
+
+    FFrameAllocator();
+    ~FFrameAllocator();
+
+    FFrameAllocator(const FFrameAllocator&) = delete;
+    FFrameAllocator& operator=(const FFrameAllocator&) = delete;
+
+    // Any thread: Size bytes aligned to Alignment (a power of two), valid until Reset()
+    void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* AllocateArray(size_t Count)
+    {
+        return static_cast<T*>(Allocate(Count * sizeof(T), alignof(T)));
+    }
+
+    // End of frame: recycle every block (no concurrent Allocate calls allowed)
+    void Reset();
+
+    // Bytes handed out and blocks in use during the frame that the last Reset() closed
+    size_t GetLastFrameBytes() const { return LastFrameBytes; }
+    uint32 GetLastFrameBlocks() const { return LastFrameBlocks; }
+
+    // Pooled blocks ever allocated from the heap (stays flat in steady state)
+    uint32 GetNumAllocatedBlocks() const { return NumAllocatedBlocks; }
+
+    // The render thread's frame allocator; FRenderer resets it at the end of every frame
+    static FFrameAllocator& Get();
+
+private:
+    struct FBlock
+    {
+        FBlock* Next;
+        uint8* Cursor;
+        uint8* End;
+        bool bOversized;    // Sized for one large allocation, freed on Reset
+    };
+
+    // Hand out a block with room for Size bytes at Alignment
+    FBlock* AcquireBlock(size_t Size, size_t Alignment);
+
+    std::mutex Mutex;
+    FBlock* UsedBlocks;     // Blocks handed to threads since the last Reset
+    FBlock* FreeBlocks;
+    uint32 NumAllocatedBlocks;
+
+    // Unique per allocator and frame; thread caches from an older generation are stale
+    std::atomic<uint64> Generation;
+
+    size_t LastFrameBytes;
+    uint32 LastFrameBlocks;
+
+    static std::unique_ptr<FFrameAllocator> Singleton;
+};
+
+/**
+ * TFrameStlAllocator - STL allocator adapter over FFrameAllocator
+ * deallocate() is a no-op; containers using it must not outlive the frame.
+ * Reserve up front where possible - memory released by growth is only
+ * reclaimed at Reset().
+ */
+template<typename T>
+class TFrameStlAllocator
+{
+public:
+    using value_type = T;
+
+    TFrameStlAllocator() noexcept : Allocator(&FFrameAllocator::Get()) {}
+    explicit TFrameStlAllocator(FFrameAllocator& InAllocator) noexcept : Allocator(&InAllocator) {}
+
+    template<typename OtherType>
+    TFrameStlAllocator(const TFrameStlAllocator<OtherType>& Other) noexcept : Allocator(Other.GetAllocator()) {}
+
+    T* allocate(size_t Count) { return Allocator->AllocateArray<T>(Count); }
+    void deallocate(T*, size_t) noexcept {}
+
+    FFrameAllocator* GetAllocator() const { return Allocator; }
+
+    template<typename OtherType>
+    bool operator==(const TFrameStlAllocator<OtherType>& Other) const { return Allocator == Other.GetAllocator(); }
+    template<typename OtherType>
+    bool operator!=(const TFrameStlAllocator<OtherType>& Other) const { return Allocator != Other.GetAllocator(); }
+
+private:
+    FFrameAllocator* Allocator;
+};
+
+// Frame-memory containers
+template<typename T>
+using TFrameVector = std::vector<T, TFrameStlAllocator<T>>;
+using FFrameString = std::basic_string<char, std::char_traits<char>, TFrameStlAllocator<char>>;
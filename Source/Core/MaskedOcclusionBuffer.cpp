@@ -0,0 +1,425 @@
+#include "MaskedOcclusionBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE 1
+#else
+#define OCCLUSION_USE_SSE 0
+#endif
+
+static constexpr uint32 FullRowMask = 0xFFFFFFFFu;
+
+// Row mask with columns First..Last set; empty when First > Last
+static inline uint32 SpanMask(int32 First, int32 Last)
+{
+    if (First > Last)
+    {
+        return 0;
+    }
+    return (FullRowMask >> (31 - Last)) & (FullRowMask << First);
+}
+
+FMaskedOcclusionBuffer::FMaskedOcclusionBuffer(uint32 InWidth, uint32 InHeight)
+    : Width(0)
+    , Height(0)
+    , NumTilesX(0)
+    , NumTilesY(0)
+{
+    SetResolution(InWidth, InHeight);
+}
+
+void FMaskedOcclusionBuffer::SetResolution(uint32 InWidth, uint32 InHeight)
+{
+    NumTilesX = std::max((InWidth + TileWidth - 1) / TileWidth, 1u);
+    NumTilesY = std::max((InHeight + TileHeight - 1) / TileHeight, 1u);
+    Width = NumTilesX * TileWidth;
+    Height = NumTilesY * TileHeight;
+    Tiles.resize(NumTilesX * NumTilesY);
+    RowDepths.resize(NumTilesY);
+    Bins.resize(NumTilesY);
+    Clear();
+}
+
+void FMaskedOcclusionBuffer::Clear()
+{
+    for (FTile& tile : Tiles)
+    {
+        std::fill(tile.Mask, tile.Mask + TileHeight, 0u);
+        tile.ZMax0 = 1.0f;
+        tile.ZMax1 = 0.0f;
+    }
+    std::fill(RowDepths.begin(), RowDepths.end(), 1.0f);
+    Triangles.clear();
+    for (std::vector<uint32>& bin : Bins)
+    {
+        bin.clear();
+    }
+}
+
+void FMaskedOcclusionBuffer::ToScreen(const FClipVertex& Vertex, float& OutX, float& OutY, float& OutZ) const
+{
+    float invW = 1.0f / Vertex.W;
+    OutX = (Vertex.X * invW * 0.5f + 0.5f) * static_cast<float>(Width);
+    OutY = (0.5f - Vertex.Y * invW * 0.5f) * static_cast<float>(Height);
+    OutZ = Vertex.Z * invW;
+}
+
+uint32 FMaskedOcclusionBuffer::AddOccluder(const FMatrix4x4& ModelViewProjection, const FOccluderMesh& Mesh)
+{
+    if (!Mesh.IsValid())
+    {
+        return 0;
+    }
+
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, ModelViewProjection.Matrix);
+
+    // Row vectors: clip = (x, y, z, 1) * M
+    ClipVertices.resize(Mesh.Positions.size());
+    for (size_t i = 0; i < Mesh.Positions.size(); ++i)
+    {
+        const FVector& p = Mesh.Positions[i];
+        FClipVertex& v = ClipVertices[i];
+        v.X = p.X * m.m[0][0] + p.Y * m.m[1][0] + p.Z * m.m[2][0] + m.m[3][0];
+        v.Y = p.X * m.m[0][1] + p.Y * m.m[1][1] + p.Z * m.m[2][1] + m.m[3][1];
+        v.Z = p.X * m.m[0][2] + p.Y * m.m[1][2] + p.Z * m.m[2][2] + m.m[3][2];
+        v.W = p.X * m.m[0][3] + p.Y * m.m[1][3] + p.Z * m.m[2][3] + m.m[3][3];
+    }
+
+    uint32 numBinned = 0;
+    const uint32 numIndices = static_cast<uint32>(Mesh.Indices.size()) / 3 * 3;
+    for (uint32 i = 0; i < numIndices; i += 3)
+    {
+        const FClipVertex* corners[3] = { &ClipVertices[Mesh.Indices[i]], &ClipVertices[Mesh.Indices[i + 1]],
+                                          &ClipVertices[Mesh.Indices[i + 2]] };
+
+        // Wholly outside one side of the view: nothing to draw
+        bool bOutside = false;
+        for (uint32 axis = 0; axis < 2 && !bOutside; ++axis)
+        {
+            auto coordinate = [axis](const FClipVertex* V) { return axis == 0 ? V->X : V->Y; };
+            bOutside = (coordinate(corners[0]) > corners[0]->W && coordinate(corners[1]) > corners[1]->W &&
+                        coordinate(corners[2]) > corners[2]->W) ||
+                       (coordinate(corners[0]) < -corners[0]->W && coordinate(corners[1]) < -corners[1]->W &&
+                        coordinate(corners[2]) < -corners[2]->W);
+        }
+        if (bOutside)
+        {
+            continue;
+        }
+
+        // Clip against the near plane (clip z >= 0): a triangle becomes up to a quad
+        FClipVertex polygon[4];
+        uint32 numPolygon = 0;
+        for (uint32 edge = 0; edge < 3; ++edge)
+        {
+            const FClipVertex& a = *corners[edge];
+            const FClipVertex& b = *corners[(edge + 1) % 3];
+            bool bInsideA = a.Z >= 0.0f;
+            bool bInsideB = b.Z >= 0.0f;
+            if (bInsideA)
+            {
+                polygon[numPolygon++] = a;
+            }
+            if (bInsideA != bInsideB)
+            {
+                float t = a.Z / (a.Z - b.Z);
+                polygon[numPolygon++] = { a.X + (b.X - a.X) * t, a.Y + (b.Y - a.Y) * t, 0.0f, a.W + (b.W - a.W) * t };
+            }
+        }
+        if (numPolygon < 3)
+        {
+            continue;
+        }
+
+        float x[4], y[4], z[4];
+        for (uint32 v = 0; v < numPolygon; ++v)
+        {
+            ToScreen(polygon[v], x[v], y[v], z[v]);
+        }
+        for (uint32 v = 2; v < numPolygon; ++v)
+        {
+            const float triangleX[3] = { x[0], x[v - 1], x[v] };
+            const float triangleY[3] = { y[0], y[v - 1], y[v] };
+            const float triangleZ[3] = { z[0], z[v - 1], z[v] };
+            numBinned += BinTriangle(triangleX, triangleY, triangleZ) ? 1 : 0;
+        }
+    }
+    return numBinned;
+}
+
+bool FMaskedOcclusionBuffer::BinTriangle(const float (&X)[3], const float (&Y)[3], const float (&Z)[3])
+{
+    float area = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+    if (std::fabs(area) < 1.0e-6f)
+    {
+        return false;
+    }
+
+    float minX = std::min(std::min(X[0], X[1]), X[2]);
+    float maxX = std::max(std::max(X[0], X[1]), X[2]);
+    float minY = std::min(std::min(Y[0], Y[1]), Y[2]);
+    float maxY = std::max(std::max(Y[0], Y[1]), Y[2]);
+    if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(Width) || minY >= static_cast<float>(Height))
+    {
+        return false;
+    }
+
+    // Either winding: flip the edges so the inside is positive
+    FTriangle triangle;
+    float sign = area > 0.0f ? 1.0f : -1.0f;
+    for (uint32 edge = 0; edge < 3; ++edge)
+    {
+        uint32 next = (edge + 1) % 3;
+        triangle.EdgeA[edge] = sign * (Y[edge] - Y[next]);
+        triangle.EdgeB[edge] = sign * (X[next] - X[edge]);
+        triangle.EdgeC[edge] = sign * (X[edge] * Y[next] - X[next] * Y[edge]);
+    }
+
+    // z / w is linear in screen space
+    float invArea = 1.0f / area;
+    triangle.DepthA = ((Z[1] - Z[0]) * (Y[2] - Y[0]) - (Z[2] - Z[0]) * (Y[1] - Y[0])) * invArea;
+    triangle.DepthB = ((X[1] - X[0]) * (Z[2] - Z[0]) - (X[2] - X[0]) * (Z[1] - Z[0])) * invArea;
+    triangle.DepthC = Z[0] - triangle.DepthA * X[0] - triangle.DepthB * Y[0];
+    triangle.ZMax = std::max(std::max(Z[0], Z[1]), Z[2]);
+
+    auto tileRange = [](float Min, float Max, uint32 TileSize, uint32 NumTiles, uint32& OutFirst, uint32& OutLast)
+    {
+        float limit = static_cast<float>(NumTiles * TileSize - 1);
+        OutFirst = static_cast<uint32>(std::max(Min, 0.0f)) / TileSize;
+        OutLast = static_cast<uint32>(std::min(Max, limit)) / TileSize;
+    };
+    uint32 firstRow, lastRow;
+    tileRange(minX, maxX, TileWidth, NumTilesX, triangle.MinTileX, triangle.MaxTileX);
+    tileRange(minY, maxY, TileHeight, NumTilesY, firstRow, lastRow);
+
+    uint32 index = static_cast<uint32>(Triangles.size());
+    Triangles.push_back(triangle);
+    for (uint32 row = firstRow; row <= lastRow; ++row)
+    {
+        Bins[row].push_back(index);
+    }
+    return true;
+}
+
+void FMaskedOcclusionBuffer::RasterizeBin(uint32 Bin)
+{
+    for (uint32 index : Bins[Bin])
+    {
+        const FTriangle& triangle = Triangles[index];
+        for (uint32 tileX = triangle.MinTileX; tileX <= triangle.MaxTileX; ++tileX)
+        {
+            RasterizeTile(triangle, tileX, Bin);
+        }
+    }
+
+    float rowDepth = 0.0f;
+    for (uint32 tileX = 0; tileX < NumTilesX; ++tileX)
+    {
+        rowDepth = std::max(rowDepth, Tiles[Bin * NumTilesX + tileX].ZMax0);
+    }
+    RowDepths[Bin] = rowDepth;
+}
+
+void FMaskedOcclusionBuffer::RasterizeAll()
+{
+    for (uint32 bin = 0; bin < GetNumBins(); ++bin)
+    {
+        RasterizeBin(bin);
+    }
+}
+
+void FMaskedOcclusionBuffer::RasterizeTile(const FTriangle& Triangle, uint32 TileX, uint32 TileY)
+{
+    FTile& tile = Tiles[TileY * NumTilesX + TileX];
+    const float tileMinX = static_cast<float>(TileX * TileWidth);
+    const float tileMinY = static_cast<float>(TileY * TileHeight);
+
+    // The depth plane is farthest at one of the tile's corners; the triangle's own farthest
+    // vertex caps it where the plane runs on past the triangle
+    float cornerDepth = Triangle.DepthC + Triangle.DepthA * (Triangle.DepthA > 0.0f ? tileMinX + TileWidth : tileMinX) +
+                        Triangle.DepthB * (Triangle.DepthB > 0.0f ? tileMinY + TileHeight : tileMinY);
+    float depth = std::min(Triangle.ZMax, cornerDepth);
+    if (depth >= tile.ZMax0)
+    {
+        return;     // Behind what already covers the whole tile
+    }
+
+    // Per row, each edge bounds the covered columns from one side: pixel centers x + 0.5 with
+    // A x + B y + C >= 0. Columns are found as [First, Last] spans
+    uint32 coverage[TileHeight];
+#if OCCLUSION_USE_SSE
+    for (uint32 half = 0; half < TileHeight; half += 4)
+    {
+        const __m128 rowY = _mm_add_ps(_mm_set1_ps(tileMinY + static_cast<float>(half)), _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f));
+        __m128 low = _mm_setzero_ps();
+        __m128 high = _mm_set1_ps(static_cast<float>(TileWidth - 1));
+        for (uint32 edge = 0; edge < 3; ++edge)
+        {
+            const float a = Triangle.EdgeA[edge];
+            __m128 rowValue = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Triangle.EdgeB[edge]), rowY), _mm_set1_ps(Triangle.EdgeC[edge]));
+            if (a == 0.0f)
+            {
+                // Horizontal edge: whole rows in or out
+                low = _mm_max_ps(low, _mm_and_ps(_mm_cmplt_ps(rowValue, _mm_setzero_ps()), _mm_set1_ps(64.0f)));
+                continue;
+            }
+            __m128 column = _mm_sub_ps(_mm_mul_ps(rowValue, _mm_set1_ps(-1.0f / a)), _mm_set1_ps(tileMinX + 0.5f));
+            if (a > 0.0f)
+            {
+                low = _mm_max_ps(low, column);
+            }
+            else
+            {
+                high = _mm_min_ps(high, column);
+            }
+        }
+        low = _mm_min_ps(low, _mm_set1_ps(static_cast<float>(TileWidth)));
+        high = _mm_max_ps(high, _mm_set1_ps(-1.0f));
+
+        // Both are in small ranges, so truncation gives ceil(low) and floor(high)
+        __m128i lowInt = _mm_cvttps_epi32(low);
+        __m128i first = _mm_sub_epi32(lowInt, _mm_castps_si128(_mm_cmplt_ps(_mm_cvtepi32_ps(lowInt), low)));
+        __m128i last = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(high, _mm_set1_ps(1.0f))), _mm_set1_epi32(1));
+
+        alignas(16) int32 firsts[4];
+        alignas(16) int32 lasts[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(firsts), first);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lasts), last);
+        for (uint32 row = 0; row < 4; ++row)
+        {
+            coverage[half + row] = SpanMask(firsts[row], lasts[row]);
+        }
+    }
+#else
+    for (uint32 row = 0; row < TileHeight; ++row)
+    {
+        float rowY = tileMinY + static_cast<float>(row) + 0.5f;
+        float low = 0.0f;
+        float high = static_cast<float>(TileWidth - 1);
+        for (uint32 edge = 0; edge < 3; ++edge)
+        {
+            const float a = Triangle.EdgeA[edge];
+            float rowValue = Triangle.EdgeB[edge] * rowY + Triangle.EdgeC[edge];
+            if (a == 0.0f)
+            {
+                low = rowValue < 0.0f ? 64.0f : low;
+                continue;
+            }
+            float column = -rowValue / a - (tileMinX + 0.5f);
+            low = a > 0.0f ? std::max(low, column) : low;
+            high = a < 0.0f ? std::min(high, column) : high;
+        }
+        low = std::min(low, static_cast<float>(TileWidth));
+        high = std::max(high, -1.0f);
+        coverage[row] = SpanMask(static_cast<int32>(std::ceil(low)), static_cast<int32>(std::floor(high)));
+    }
+#endif
+
+    uint32 anyCovered = 0;
+    uint32 allCovered = FullRowMask;
+    for (uint32 row = 0; row < TileHeight; ++row)
+    {
+        anyCovered |= coverage[row];
+        allCovered &= coverage[row];
+    }
+    if (!anyCovered)
+    {
+        return;
+    }
+
+    // Covers the tile on its own: a closer whole-tile depth, and a working layer behind it is moot
+    if (allCovered == FullRowMask)
+    {
+        tile.ZMax0 = depth;
+        if (tile.ZMax1 >= depth)
+        {
+            std::fill(tile.Mask, tile.Mask + TileHeight, 0u);
+            tile.ZMax1 = 0.0f;
+        }
+        return;
+    }
+
+    // Merge into the working layer; once it covers the tile it replaces ZMax0
+    uint32 merged = FullRowMask;
+    for (uint32 row = 0; row < TileHeight; ++row)
+    {
+        tile.Mask[row] |= coverage[row];
+        merged &= tile.Mask[row];
+    }
+    tile.ZMax1 = std::max(tile.ZMax1, depth);
+    if (merged == FullRowMask)
+    {
+        tile.ZMax0 = std::min(tile.ZMax0, tile.ZMax1);
+        std::fill(tile.Mask, tile.Mask + TileHeight, 0u);
+        tile.ZMax1 = 0.0f;
+    }
+}
+
+bool FMaskedOcclusionBuffer::IsBoxVisible(const FBox& Box, const FMatrix4x4& ViewProjection) const
+{
+    DirectX::XMFLOAT4X4 m;
+    DirectX::XMStoreFloat4x4(&m, ViewProjection.Matrix);
+
+    float minX = static_cast<float>(Width);
+    float minY = static_cast<float>(Height);
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+    float nearestDepth = 1.0f;
+    for (uint32 corner = 0; corner < 8; ++corner)
+    {
+        FClipVertex v;
+        float x = (corner & 1) ? Box.Max.X : Box.Min.X;
+        float y = (corner & 2) ? Box.Max.Y : Box.Min.Y;
+        float z = (corner & 4) ? Box.Max.Z : Box.Min.Z;
+        v.X = x * m.m[0][0] + y * m.m[1][0] + z * m.m[2][0] + m.m[3][0];
+        v.Y = x * m.m[0][1] + y * m.m[1][1] + z * m.m[2][1] + m.m[3][1];
+        v.Z = x * m.m[0][2] + y * m.m[1][2] + z * m.m[2][2] + m.m[3][2];
+        v.W = x * m.m[0][3] + y * m.m[1][3] + z * m.m[2][3] + m.m[3][3];
+        if (v.Z < 0.0f)
+        {
+            return true;    // Crosses the near plane
+        }
+
+        float screenX, screenY, depth;
+        ToScreen(v, screenX, screenY, depth);
+        minX = std::min(minX, screenX);
+        maxX = std::max(maxX, screenX);
+        minY = std::min(minY, screenY);
+        maxY = std::max(maxY, screenY);
+        nearestDepth = std::min(nearestDepth, depth);
+    }
+    return IsRectVisible(minX, minY, maxX, maxY, nearestDepth);
+}
+
+bool FMaskedOcclusionBuffer::IsRectVisible(float MinX, float MinY, float MaxX, float MaxY, float NearestDepth) const
+{
+    if (MaxX < 0.0f || MaxY < 0.0f || MinX >= static_cast<float>(Width) || MinY >= static_cast<float>(Height))
+    {
+        return true;
+    }
+
+    uint32 firstTileX = static_cast<uint32>(std::max(MinX, 0.0f)) / TileWidth;
+    uint32 lastTileX = static_cast<uint32>(std::min(MaxX, static_cast<float>(Width - 1))) / TileWidth;
+    uint32 firstTileY = static_cast<uint32>(std::max(MinY, 0.0f)) / TileHeight;
+    uint32 lastTileY = static_cast<uint32>(std::min(MaxY, static_cast<float>(Height - 1))) / TileHeight;
+    for (uint32 tileY = firstTileY; tileY <= lastTileY; ++tileY)
+    {
+        // Behind the farthest tile of the row: every tile of it hides the box
+        if (NearestDepth >= RowDepths[tileY])
+        {
+            continue;
+        }
+        const FTile* row = &Tiles[tileY * NumTilesX];
+        for (uint32 tileX = firstTileX; tileX <= lastTileX; ++tileX)
+        {
+            if (NearestDepth < row[tileX].ZMax0)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CoreTypes.h"
+#include "Bounds.h"
+#include <vector>
+
+/**
+ * FOccluderMesh - Triangles an occluder is rasterized with, in mesh space
+ * Kept on the CPU next to the GPU copy; only simple meshes (walls, floors,
+ * large boxes) are worth rasterizing.
+ */
+struct FOccluderMesh
+{
+    std::vector<FVector> Positions;
+    std::vector<uint32> Indices;    // Three per triangle
+
+    bool IsValid() const { return !Positions.empty() && Indices.size() >= 3; }
+    uint32 GetNumTriangles() const { return static_cast<uint32>(Indices.size() / 3); }
+};
+
+/**
+ * FMaskedOcclusionBuffer - Low resolution software depth buffer for occlusion culling
+ * Similar in spirit to Intel's Masked Occlusion Culling
+ *
+ * The screen is split into tiles of TileWidth x TileHeight pixels. Instead of
+ * a depth per pixel, a tile keeps a coverage bit per pixel and two depths:
+ * ZMax0, the farthest occluder depth over the whole tile, and ZMax1, the
+ * farthest depth of a working layer covering only the pixels in the mask.
+ * Triangles add their coverage to the working layer; once the mask is full
+ * the working layer becomes the new ZMax0. Coverage is found per row from the
+ * triangle's edge spans, four rows at a time with SSE.
+ *
+ * Depth is clip z / w (0 at the near plane, 1 at the far plane), and the
+ * stored depths are conservative: a pixel's occluder is never farther than
+ * its tile's ZMax0, so a box whose nearest point is closer than ZMax0 in any
+ * tile it touches may be visible.
+ *
+ * Occluders are transformed, near-clipped and binned by tile row with
+ * AddOccluder(); RasterizeBin() then fills one row of tiles and touches no
+ * other, so bins can be rasterized on different threads. Tests only read the
+ * buffer and may run concurrently once rasterization is done.
+ */
+class FMaskedOcclusionBuffer
+{
+public:
+    static constexpr uint32 TileWidth = 32;     // One bit per pixel in a uint32 per row
+    static constexpr uint32 TileHeight = 8;
+
+    // Size rounded up to whole tiles; the viewport maps onto the rounded size
+    FMaskedOcclusionBuffer(uint32 InWidth = 384, uint32 InHeight = 216);
+
+    void SetResolution(uint32 InWidth, uint32 InHeight);
+    uint32 GetWidth() const { return Width; }
+    uint32 GetHeight() const { return Height; }
+    uint32 GetNumTilesX() const { return NumTilesX; }
+    uint32 GetNumTilesY() const { return NumTilesY; }
+
+    // Empty the depth (nothing occludes) and drop the binned triangles
+    void Clear();
+
+    // Transform Mesh by ModelViewProjection, clip it against the near plane and bin its
+    // triangles. Returns the number of triangles binned. Not thread-safe
+    uint32 AddOccluder(const FMatrix4x4& ModelViewProjection, const FOccluderMesh& Mesh);
+
+    // One bin per row of tiles; bins may be rasterized concurrently
+    uint32 GetNumBins() const { return NumTilesY; }
+    void RasterizeBin(uint32 Bin);
+
+    // Rasterize every bin on the calling thread
+    void RasterizeAll();
+
+    uint32 GetNumBinnedTriangles() const { return static_cast<uint32>(Triangles.size()); }
+
+    // Whether any part of the world space box may be visible past the occluders. Boxes
+    // crossing the near plane or off screen count as visible (frustum culling handles them)
+    bool IsBoxVisible(const FBox& Box, const FMatrix4x4& ViewProjection) const;
+
+    // Whether a screen rectangle in pixels, whose nearest point is at NearestDepth, may be visible
+    bool IsRectVisible(float MinX, float MinY, float MaxX, float MaxY, float NearestDepth) const;
+
+    // Farthest occluder depth over a whole tile (1 where nothing covers it yet), and over a row
+    // of tiles, the coarse level tests look at first
+    float GetTileDepth(uint32 TileX, uint32 TileY) const { return Tiles[TileY * NumTilesX + TileX].ZMax0; }
+    float GetRowDepth(uint32 TileY) const { return RowDepths[TileY]; }
+
+private:
+    struct FTile
+    {
+        uint32 Mask[TileHeight];    // Working layer coverage, bit i of row r = pixel (i, r)
+        float ZMax0;                // Whole tile
+        float ZMax1;                // Pixels in Mask
+    };
+
+    // A screen space triangle: edges E(x, y) = A x + B y + C >= 0 inside, depth = A x + B y + C
+    struct FTriangle
+    {
+        float EdgeA[3];
+        float EdgeB[3];
+        float EdgeC[3];
+        float DepthA;
+        float DepthB;
+        float DepthC;
+        float ZMax;                 // Farthest vertex
+        uint32 MinTileX;
+        uint32 MaxTileX;
+    };
+
+    struct FClipVertex
+    {
+        float X;
+        float Y;
+        float Z;
+        float W;
+    };
+
+    // Set up and bin a triangle given its screen space vertices (x, y in pixels, z / w)
+    bool BinTriangle(const float (&X)[3], const float (&Y)[3], const float (&Z)[3]);
+
+    // Project a clip space vertex in front of the near plane to screen space
+    void ToScreen(const FClipVertex& Vertex, float& OutX, float& OutY, float& OutZ) const;
+
+    // Coverage of Triangle in a tile and the merge into its layers
+    void RasterizeTile(const FTriangle& Triangle, uint32 TileX, uint32 TileY);
+
+    uint32 Width;
+    uint32 Height;
+    uint32 NumTilesX;
+    uint32 NumTilesY;
+    std::vector<FTile> Tiles;
+    std::vector<float> RowDepths;               // Farthest ZMax0 of each tile row
+    std::vector<FClipVertex> ClipVertices;      // Scratch for AddOccluder
+    std::vector<FTriangle> Triangles;
+    std::vector<std::vector<uint32>> Bins;     // Triangle indices per tile row
+};
@@ -0,0 +1,314 @@
+#include "TLSFAllocator.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest / highest set bit (Value must be non-zero)
+static uint32 FindLowestSetBit(uint32 Value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, Value);
+    return static_cast<uint32>(index);
+#else
+    return static_cast<uint32>(__builtin_ctz(Value));
+#endif
+}
+
+static uint32 FindHighestSetBit(uint32 Value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, Value);
+    return static_cast<uint32>(index);
+#else
+    return 31u - static_cast<uint32>(__builtin_clz(Value));
+#endif
+}
+
+FTLSFAllocator::FTLSFAllocator(uint32 InCapacity)
+    : Capacity(InCapacity)
+{
+    Reset();
+}
+
+uint32 FTLSFAllocator::GetBinIndex(uint32 Size)
+{
+    // Sizes below SecondLevelCount each get their own bin
+    if (Size < SecondLevelCount)
+    {
+        return Size;
+    }
+    uint32 highestBit = FindHighestSetBit(Size);
+    uint32 firstLevel = highestBit - SecondLevelBits + 1;
+    uint32 secondLevel = (Size >> (highestBit - SecondLevelBits)) & (SecondLevelCount - 1);
+    return firstLevel * SecondLevelCount + secondLevel;
+}
+
+uint32 FTLSFAllocator::GetBinSize(uint32 Bin)
+{
+    uint32 firstLevel = Bin / SecondLevelCount;
+    uint32 secondLevel = Bin % SecondLevelCount;
+    if (firstLevel == 0)
+    {
+        return secondLevel;
+    }
+    return (SecondLevelCount | secondLevel) << (firstLevel - 1);
+}
+
+uint32 FTLSFAllocator::FindFreeBin(uint32 Bin) const
+{
+    if (Bin >= NumBins)
+    {
+        return InvalidOffset;
+    }
+
+    // A larger bin within the same power of two
+    uint32 firstLevel = Bin / SecondLevelCount;
+    uint32 secondLevelMap = SecondLevelBitmaps[firstLevel] & (0xFFu << (Bin % SecondLevelCount)) & 0xFFu;
+    if (secondLevelMap != 0)
+    {
+        return firstLevel * SecondLevelCount + FindLowestSetBit(secondLevelMap);
+    }
+
+    // Otherwise the smallest bin of the next non-empty power of two
+    uint32 firstLevelMap = FirstLevelBitmap & (0xFFFFFFFFu << (firstLevel + 1));
+    if (firstLevelMap == 0)
+    {
+        return InvalidOffset;
+    }
+    firstLevel = FindLowestSetBit(firstLevelMap);
+    return firstLevel * SecondLevelCount + FindLowestSetBit(SecondLevelBitmaps[firstLevel]);
+}
+
+uint32 FTLSFAllocator::CreateNode(uint32 Offset, uint32 Size)
+{
+    FNode node = { Offset, Size, InvalidOffset, InvalidOffset, InvalidOffset, InvalidOffset, false };
+    if (!UnusedNodes.empty())
+    {
+        uint32 index = UnusedNodes.back();
+        UnusedNodes.pop_back();
+        Nodes[index] = node;
+        return index;
+    }
+    Nodes.push_back(node);
+    return static_cast<uint32>(Nodes.size() - 1);
+}
+
+void FTLSFAllocator::ReleaseNode(uint32 Node)
+{
+    Nodes[Node].Offset = InvalidOffset;
+    UnusedNodes.push_back(Node);
+}
+
+void FTLSFAllocator::InsertFreeBlock(uint32 Node)
+{
+    uint32 bin = GetBinIndex(Nodes[Node].Size);
+    uint32 head = BinHeads[bin];
+
+    Nodes[Node].PrevFree = InvalidOffset;
+    Nodes[Node].NextFree = head;
+    if (head != InvalidOffset)
+    {
+        Nodes[head].PrevFree = Node;
+    }
+    BinHeads[bin] = Node;
+
+    FirstLevelBitmap |= 1u << (bin / SecondLevelCount);
+    SecondLevelBitmaps[bin / SecondLevelCount] |= static_cast<uint8>(1u << (bin % SecondLevelCount));
+    ++NumFreeBlocks;
+}
+
+void FTLSFAllocator::RemoveFreeBlock(uint32 Node)
+{
+    FNode& node = Nodes[Node];
+    uint32 bin = GetBinIndex(node.Size);
+
+    if (node.PrevFree != InvalidOffset)
+    {
+        Nodes[node.PrevFree].NextFree = node.NextFree;
+    }
+    else
+    {
+        BinHeads[bin] = node.NextFree;
+    }
+    if (node.NextFree != InvalidOffset)
+    {
+        Nodes[node.NextFree].PrevFree = node.PrevFree;
+    }
+
+    if (BinHeads[bin] == InvalidOffset)
+    {
+        uint32 firstLevel = bin / SecondLevelCount;
+        SecondLevelBitmaps[firstLevel] &= static_cast<uint8>(~(1u << (bin % SecondLevelCount)));
+        if (SecondLevelBitmaps[firstLevel] == 0)
+        {
+            FirstLevelBitmap &= ~(1u << firstLevel);
+        }
+    }
+    --NumFreeBlocks;
+}
+
+FTLSFAllocator::FAllocation FTLSFAllocator::Allocate(uint32 Size)
+{
+    FAllocation allocation;
+    if (Size == 0)
+    {
+        return allocation;
+    }
+
+    // Round up to a bin whose every block is large enough
+    uint32 sizeBin = GetBinIndex(Size);
+    uint32 bin = GetBinSize(sizeBin) < Size ? sizeBin + 1 : sizeBin;
+
+    uint32 node = InvalidOffset;
+    uint32 freeBin = FindFreeBin(bin);
+    if (freeBin != InvalidOffset)
+    {
+        node = BinHeads[freeBin];
+    }
+    else if (bin != sizeBin)
+    {
+        // Nothing larger: a block in the request's own bin may still fit
+        for (uint32 candidate = BinHeads[sizeBin]; candidate != InvalidOffset; candidate = Nodes[candidate].NextFree)
+        {
+            if (Nodes[candidate].Size >= Size)
+            {
+                node = candidate;
+                break;
+            }
+        }
+    }
+    if (node == InvalidOffset)
+    {
+        return allocation;
+    }
+    RemoveFreeBlock(node);
+
+    // Return the tail to the free lists (indices only: CreateNode may grow Nodes)
+    if (Nodes[node].Size > Size)
+    {
+        uint32 remainder = CreateNode(Nodes[node].Offset + Size, Nodes[node].Size - Size);
+        uint32 next = Nodes[node].NextPhysical;
+        Nodes[remainder].PrevPhysical = node;
+        Nodes[remainder].NextPhysical = next;
+        if (next != InvalidOffset)
+        {
+            Nodes[next].PrevPhysical = remainder;
+        }
+        Nodes[node].NextPhysical = remainder;
+        Nodes[node].Size = Size;
+        InsertFreeBlock(remainder);
+    }
+
+    Nodes[node].bUsed = true;
+    UsedSize += Size;
+    ++NumAllocations;
+
+    allocation.Offset = Nodes[node].Offset;
+    allocation.Node = node;
+    return allocation;
+}
+
+void FTLSFAllocator::Free(const FAllocation& Allocation)
+{
+    if (!Allocation.IsValid() || Allocation.Node >= Nodes.size())
+    {
+        return;
+    }
+    uint32 node = Allocation.Node;
+    if (!Nodes[node].bUsed || Nodes[node].Offset != Allocation.Offset)
+    {
+        FLog::Log(ELogLevel::Warning, "FTLSFAllocator: Free of an unknown allocation at offset " + std::to_string(Allocation.Offset));
+        return;
+    }
+
+    UsedSize -= Nodes[node].Size;
+    --NumAllocations;
+    Nodes[node].bUsed = false;
+
+    // Merge with the free block before it
+    uint32 prev = Nodes[node].PrevPhysical;
+    if (prev != InvalidOffset && !Nodes[prev].bUsed)
+    {
+        RemoveFreeBlock(prev);
+        Nodes[prev].Size += Nodes[node].Size;
+        Nodes[prev].NextPhysical = Nodes[node].NextPhysical;
+        if (Nodes[node].NextPhysical != InvalidOffset)
+        {
+            Nodes[Nodes[node].NextPhysical].PrevPhysical = prev;
+        }
+        ReleaseNode(node);
+        node = prev;
+    }
+
+    // And with the one after it
+    uint32 next = Nodes[node].NextPhysical;
+    if (next != InvalidOffset && !Nodes[next].bUsed)
+    {
+        RemoveFreeBlock(next);
+        Nodes[node].Size += Nodes[next].Size;
+        Nodes[node].NextPhysical = Nodes[next].NextPhysical;
+        if (Nodes[next].NextPhysical != InvalidOffset)
+        {
+            Nodes[Nodes[next].NextPhysical].PrevPhysical = node;
+        }
+        ReleaseNode(next);
+    }
+
+    InsertFreeBlock(node);
+}
+
+void FTLSFAllocator::Reset()
+{
+    UsedSize = 0;
+    NumAllocations = 0;
+    NumFreeBlocks = 0;
+    FirstLevelBitmap = 0;
+    for (uint8& bitmap : SecondLevelBitmaps)
+    {
+        bitmap = 0;
+    }
+    for (uint32& head : BinHeads)
+    {
+        head = InvalidOffset;
+    }
+    Nodes.clear();
+    UnusedNodes.clear();
+
+    if (Capacity > 0)
+    {
+        InsertFreeBlock(CreateNode(0, Capacity));
+    }
+}
+
+uint32 FTLSFAllocator::GetAllocationSize(const FAllocation& Allocation) const
+{
+    if (!Allocation.IsValid() || Allocation.Node >= Nodes.size() || !Nodes[Allocation.Node].bUsed)
+    {
+        return 0;
+    }
+    return Nodes[Allocation.Node].Size;
+}
+
+uint32 FTLSFAllocator::GetLargestFreeBlock() const
+{
+    if (FirstLevelBitmap == 0)
+    {
+        return 0;
+    }
+
+    // Blocks in the highest non-empty bin are the largest; sizes vary within a bin
+    uint32 firstLevel = FindHighestSetBit(FirstLevelBitmap);
+    uint32 bin = firstLevel * SecondLevelCount + FindHighestSetBit(SecondLevelBitmaps[firstLevel]);
+    uint32 largest = 0;
+    for (uint32 node = BinHeads[bin]; node != InvalidOffset; node = Nodes[node].NextFree)
+    {
+        if (Nodes[node].Size > largest)
+        {
+            largest = Nodes[node].Size;
+        }
+    }
+    return largest;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreTypes.h"
+#include <vector>
+
+/**
+ * FTLSFAllocator - Two-Level Segregated Fit range allocator
+ * Similar in spirit to UE5's FGPUDefragAllocator / D3D12 buddy allocators
+ *
+ * Manages offsets in [0, Capacity) without owning any memory, so the same
+ * allocator can carve up a GPU buffer, a heap or anything else addressed by
+ * offset. Units are whatever the caller counts in (bytes, vertices, indices).
+ *
+ * Free blocks are kept in size classes: the first level is the power of two
+ * of the size, the second splits each power of two into SecondLevelCount
+ * linear steps. Two bitmaps locate a non-empty class with a couple of bit
+ * scans, so Allocate() and Free() are O(1). Allocate() rounds the request up
+ * to the next class boundary so any block found is large enough, falling back
+ * to the request's own class only when nothing larger is free; it splits the
+ * block and returns the remainder to its class. Free() merges the block with
+ * free physical neighbours, so free space never stays split into adjacent
+ * pieces.
+ *
+ * Not thread-safe; callers serialize access.
+ */
+class FTLSFAllocator
+{
+public:
+    static constexpr uint32 InvalidOffset = 0xFFFFFFFFu;
+
+    /** FAllocation - Handle returned by Allocate(), passed back to Free() */
+    struct FAllocation
+    {
+        uint32 Offset = InvalidOffset;
+        uint32 Node = InvalidOffset;    // Internal block index
+
+        bool IsValid() const { return Offset != InvalidOffset; }
+    };
+
+    explicit FTLSFAllocator(uint32 InCapacity);
+
+    // Size units at some offset; an invalid allocation if no free block is large enough
+    FAllocation Allocate(uint32 Size);
+    void Free(const FAllocation& Allocation);
+
+    // Forget every allocation: the whole range becomes one free block
+    void Reset();
+
+    uint32 GetAllocationSize(const FAllocation& Allocation) const;
+
+    uint32 GetCapacity() const { return Capacity; }
+    uint32 GetUsedSize() const { return UsedSize; }
+    uint32 GetFreeSize() const { return Capacity - UsedSize; }
+    uint32 GetNumAllocations() const { return NumAllocations; }
+    uint32 GetNumFreeBlocks() const { return NumFreeBlocks; }
+
+    // Size of the largest free block (what the next Allocate() can satisfy at most)
+    uint32 GetLargestFreeBlock() const;
+
+private:
+    static constexpr uint32 SecondLevelBits = 3;
+    static constexpr uint32 SecondLevelCount = 1u << SecondLevelBits;
+    static constexpr uint32 FirstLevelCount = 32 - SecondLevelBits + 1;
+    static constexpr uint32 NumBins = FirstLevelCount * SecondLevelCount;
+
+    struct FNode
+    {
+        uint32 Offset;
+        uint32 Size;
+        uint32 PrevPhysical;    // Neighbouring blocks in address order
+        uint32 NextPhysical;
+        uint32 PrevFree;        // Links within the block's size class
+        uint32 NextFree;
+        bool bUsed;
+    };
+
+    // Size class a block of Size belongs to (rounded down)
+    static uint32 GetBinIndex(uint32 Size);
+
+    // Smallest size stored in a bin
+    static uint32 GetBinSize(uint32 Bin);
+
+    // First non-empty bin at or above Bin, InvalidOffset if none
+    uint32 FindFreeBin(uint32 Bin) const;
+
+    uint32 CreateNode(uint32 Offset, uint32 Size);
+    void ReleaseNode(uint32 Node);
+    void InsertFreeBlock(uint32 Node);
+    void RemoveFreeBlock(uint32 Node);
+
+    uint32 Capacity;
+    uint32 UsedSize;
+    uint32 NumAllocations;
+    uint32 NumFreeBlocks;
+
+    uint32 FirstLevelBitmap;
+    uint8 SecondLevelBitmaps[FirstLevelCount];
+    uint32 BinHeads[NumBins];
+
+    std::vector<FNode> Nodes;
+    std::vector<uint32> UnusedNodes;
+};
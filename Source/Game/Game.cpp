@@ -6,6 +6,8 @@
 #include "../Scene/OBJPrimitive.h"
 #include "../Asset/TextureLoader.h"
 #include "../Shaders/ShaderCompiler.h"
+#include "../Renderer/PipelineStateCache.h"
+#include "../Renderer/GeometryBufferAllocator.h"
 #include <filesystem>
 #include <algorithm>
 #include <Windows.h>
@@ -70,12 +72,6 @@ static std::string ResolveContentPath(const std::string& RelativePath)
     return RelativePath;
 }
 
-// Define the global camera pointer (declared in GameGlobals.h)
-FCamera* g_Camera = nullptr;
-
-// Global light scene pointer for lit primitives to access
-FLightScene* g_LightScene = nullptr;
-
 // FGame implementation
 FGame::FGame()
     : bMultiThreaded(true)  // Enable multi-threading by default
@@ -334,6 +330,7 @@ void FGame::SetupScene()
     {
         cornellBox->SetPosition(FVector(0.0f, 0.0f, 5.0f));
         cornellBox->SetScale(FVector(0.8f, 0.8f, 0.8f));
+        cornellBox->SetOccluder(true);  // Its walls hide what stands behind the box
         Scene->AddPrimitive(cornellBox);
         FLog::Log(ELogLevel::Info, "Added Cornell Box to scene");
         
@@ -391,15 +388,14 @@ void FGame::SetupScene()
         
         if (!vertices.empty())
         {
-            FRHIBuffer* vb = RHI->CreateVertexBuffer(vertices.size() * sizeof(FVertex), vertices.data());
-            FRHIBuffer* ib = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-            FRHIBuffer* cb = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
+            FGeometryAllocation* vb = FGeometryBufferAllocator::AllocateVertices(RHI, vertices.data(), static_cast<uint32>(vertices.size()), sizeof(FVertex));
+            FGeometryAllocation* ib = FGeometryBufferAllocator::AllocateIndices(RHI, indices.data(), static_cast<uint32>(indices.size()));
             
             EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::LineTopology;
-            FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
+            FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
             
             FLightVisualizationProxy* lightVizProxy = new FLightVisualizationProxy(
-                vb, ib, cb, pso, indices.size(), g_Camera, light->GetPosition(), true);
+                vb, ib, pso, indices.size(), g_Camera, light->GetPosition(), RHI, true);
             Renderer->AddSceneProxy(lightVizProxy);
         }
         
@@ -409,15 +405,14 @@ void FGame::SetupScene()
         
         if (!markerVerts.empty())
         {
-            FRHIBuffer* mvb = RHI->CreateVertexBuffer(markerVerts.size() * sizeof(FVertex), markerVerts.data());
-            FRHIBuffer* mib = RHI->CreateIndexBuffer(markerIndices.size() * sizeof(uint32), markerIndices.data());
-            FRHIBuffer* mcb = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
+            FGeometryAllocation* mvb = FGeometryBufferAllocator::AllocateVertices(RHI, markerVerts.data(), static_cast<uint32>(markerVerts.size()), sizeof(FVertex));
+            FGeometryAllocation* mib = FGeometryBufferAllocator::AllocateIndices(RHI, markerIndices.data(), static_cast<uint32>(markerIndices.size()));
             
             EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::LineTopology;
-            FRHIPipelineState* mpso = RHI->CreateGraphicsPipelineStateEx(flags);
+            FRHIPipelineState* mpso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
             
             FLightVisualizationProxy* markerProxy = new FLightVisualizationProxy(
-                mvb, mib, mcb, mpso, markerIndices.size(), g_Camera, light->GetPosition(), true);
+                mvb, mib, mpso, markerIndices.size(), g_Camera, light->GetPosition(), RHI, true);
             Renderer->AddSceneProxy(markerProxy);
         }
     }
@@ -437,16 +432,15 @@ void FGame::SetupScene()
         
         if (!vertices.empty())
         {
-            FRHIBuffer* vb = RHI->CreateVertexBuffer(vertices.size() * sizeof(FVertex), vertices.data());
-            FRHIBuffer* ib = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-            FRHIBuffer* cb = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
+            FGeometryAllocation* vb = FGeometryBufferAllocator::AllocateVertices(RHI, vertices.data(), static_cast<uint32>(vertices.size()), sizeof(FVertex));
+            FGeometryAllocation* ib = FGeometryBufferAllocator::AllocateIndices(RHI, indices.data(), static_cast<uint32>(indices.size()));
             
             EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::LineTopology;
-            FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
+            FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
             
             FVector sunIconPos(5.0f, 8.0f, 5.0f);
             FLightVisualizationProxy* sunVizProxy = new FLightVisualizationProxy(
-                vb, ib, cb, pso, indices.size(), g_Camera, sunIconPos, true);
+                vb, ib, pso, indices.size(), g_Camera, sunIconPos, RHI, true);
             Renderer->AddSceneProxy(sunVizProxy);
         }
     }
@@ -465,8 +459,10 @@ void FGame::Shutdown()
     {
         FLog::Log(ELogLevel::Info, "Stopping multi-threaded systems...");
         
-        FRenderThread::Get().WaitForFrameComplete();
-        FRHIThread::Get().WaitForFrameComplete();
+        // Flush everything already enqueued through the render and RHI threads
+        FRenderFence Fence;
+        Fence.BeginFence(true);
+        Fence.Wait();
         
         FRenderThread::Get().Stop();
         FRHIThread::Get().Stop();
@@ -522,6 +518,8 @@ void FGame::TickSingleThreaded(float DeltaTime)
         FLog::Log(ELogLevel::Info, std::string("FGame::Tick (SingleThreaded) ") + std::to_string(tickCount));
     }
     
+    uint64 FrameId = Renderer->GetStats().GetLatencyTracker().BeginFrame();
+    
     Renderer->GetStats().BeginGameThreadTiming();
     
     if (Scene)
@@ -536,7 +534,7 @@ void FGame::TickSingleThreaded(float DeltaTime)
     
     if (Renderer)
     {
-        Renderer->RenderFrame();
+        Renderer->RenderFrame(FrameId);
     }
     
     Renderer->GetStats().EndRenderThreadTiming();
@@ -556,6 +554,9 @@ void FGame::TickMultiThreaded(float DeltaTime)
     
     ++GameFrameNumber;
     
+    // Tag the frame; each stage stamps this ID for the latency stats
+    uint64 FrameId = Renderer->GetStats().GetLatencyTracker().BeginFrame();
+    
     Renderer->GetStats().BeginGameThreadTiming();
     
     if (Scene)
@@ -568,16 +569,22 @@ void FGame::TickMultiThreaded(float DeltaTime)
     
     FRenderer* RendererPtr = Renderer.get();
     
-    ENQUEUE_RENDER_COMMAND(RenderFrame)[RendererPtr]() 
+    ENQUEUE_RENDER_COMMAND(RenderFrame)[RendererPtr, FrameId]() 
     {
         RendererPtr->GetStats().BeginRenderThreadTiming();
         
         FFrameSyncManager::Get().RenderThread_BeginFrame();
         
-        if (RendererPtr)
+        // Record this frame's RHI commands; the RHI thread replays and presents
+        // them while the render thread moves on to the next frame
+        FRHICommandRecorder* Recorder = RendererPtr->RecordFrame(FrameId);
+        
+        FRHIThread::Get().EnqueueWork([RendererPtr, Recorder]()
         {
-            RendererPtr->RenderFrame();
-        }
+            FFrameSyncManager::Get().RHIThread_BeginFrame();
+            RendererPtr->ExecuteRecordedFrame(Recorder);
+            FFrameSyncManager::Get().RHIThread_EndFrame();
+        });
         
         FFrameSyncManager::Get().RenderThread_EndFrame();
         
@@ -24,6 +24,10 @@ public:
     bool IsMultiThreaded() const { return bMultiThreaded; }
     void SetMultiThreaded(bool bEnable) { bMultiThreaded = bEnable; }
     
+    // Frames the game thread may run ahead of the RHI thread (1-3, multi-threaded mode)
+    void SetFrameLead(uint32 InFrameLead) { FFrameSyncManager::Get().SetFrameLead(InFrameLead); }
+    uint32 GetFrameLead() const { return FFrameSyncManager::Get().GetFrameLead(); }
+    
     // Get scene
     FScene* GetScene() { return Scene.get(); }
     
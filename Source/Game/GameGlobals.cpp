@@ -0,0 +1,10 @@
+#include "GameGlobals.h"
+
+// Globals live in their own translation unit so targets that do not link
+// Game.cpp (e.g. the headless build) can still create scene proxies.
+
+// Define the global camera pointer (declared in GameGlobals.h)
+FCamera* g_Camera = nullptr;
+
+// Global light scene pointer for lit primitives to access
+FLightScene* g_LightScene = nullptr;
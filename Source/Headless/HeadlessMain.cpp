@@ -0,0 +1,434 @@
+#include "../Renderer/Renderer.h"
+#include "../Renderer/PipelineStateCache.h"
+#include "../Renderer/GeometryBufferAllocator.h"
+#include "../Renderer/MeshRegistry.h"
+#include "../Scene/Scene.h"
+#include "../Scene/ScenePrimitive.h"
+#include "../RHI_Null/NullRHI.h"
+#include "../Game/GameGlobals.h"
+#include "../TaskGraph/RenderCommands.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <new>
+
+// Headless renderer runner
+// Drives FRenderer::RenderFrame against the null RHI so the render path
+// (shadow passes, scene proxies, stats overlay) can be profiled without a GPU.
+//
+// With --frame-lead the frame loop is pipelined like FGame's multi-threaded
+// mode: the game thread ticks, the render thread records each frame and the
+// RHI thread replays it, with the game at most N (1-3) frames ahead.
+//
+// Heap allocations are counted (all threads) through the replaced global
+// operator new below and reported per frame.
+//
+// --pso-compile-ms makes every null RHI PSO build take N ms, so startup and
+// first-frame PSO hitches can be measured with and without --no-pso-precache.
+//
+// --mixed interleaves unlit primitives with the lit ones, like the demo scene
+// mixes pipeline states; --no-sort-draws submits mesh draw commands in proxy
+// order, for comparing state changes with and without sorting; --no-instancing
+// draws every primitive on its own instead of batching identical ones;
+// --no-culling draws the primitives outside the camera frustum as well;
+// --no-shadow-culling draws every shadow caster into every shadow view.
+//
+// --occluder-wall puts a wall flagged as an occluder between the camera and
+// the middle of the grid, so occlusion culling has something to hide;
+// --no-occlusion-culling draws what it hides anyway.
+//
+// Usage: UE5MinimalRendererHeadless [--frames N] [--objects N] [--frame-lead N]
+//                                   [--pso-compile-ms N] [--no-pso-precache]
+//                                   [--mixed] [--no-sort-draws] [--no-instancing]
+//                                   [--no-culling] [--no-shadow-culling]
+//                                   [--occluder-wall] [--no-occlusion-culling]
+
+static std::atomic<uint64> GHeapAllocationCount(0);
+
+void* operator new(std::size_t Size)
+{
+    GHeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* Memory = std::malloc(Size ? Size : 1))
+    {
+        return Memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* Memory) noexcept
+{
+    std::free(Memory);
+}
+
+void operator delete(void* Memory, std::size_t) noexcept
+{
+    std::free(Memory);
+}
+
+struct FHeadlessOptions
+{
+    uint32 FrameCount = 300;
+    uint32 ObjectCount = 64;
+    uint32 FrameLead = 0;  // 0 = single-threaded
+    uint32 PSOCompileMs = 0;
+    bool bPrecachePSOs = true;
+    bool bMixedScene = false;
+    bool bSortDraws = true;
+    bool bInstancedDraws = true;
+    bool bFrustumCulling = true;
+    bool bShadowCulling = true;
+    bool bOccluderWall = false;
+    bool bOcclusionCulling = true;
+};
+
+static FHeadlessOptions ParseOptions(int argc, char** argv)
+{
+    FHeadlessOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            options.FrameCount = static_cast<uint32>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--objects") == 0 && i + 1 < argc)
+        {
+            options.ObjectCount = static_cast<uint32>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--frame-lead") == 0 && i + 1 < argc)
+        {
+            options.FrameLead = static_cast<uint32>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--pso-compile-ms") == 0 && i + 1 < argc)
+        {
+            options.PSOCompileMs = static_cast<uint32>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--no-pso-precache") == 0)
+        {
+            options.bPrecachePSOs = false;
+        }
+        else if (strcmp(argv[i], "--mixed") == 0)
+        {
+            options.bMixedScene = true;
+        }
+        else if (strcmp(argv[i], "--no-sort-draws") == 0)
+        {
+            options.bSortDraws = false;
+        }
+        else if (strcmp(argv[i], "--no-instancing") == 0)
+        {
+            options.bInstancedDraws = false;
+        }
+        else if (strcmp(argv[i], "--no-culling") == 0)
+        {
+            options.bFrustumCulling = false;
+        }
+        else if (strcmp(argv[i], "--no-shadow-culling") == 0)
+        {
+            options.bShadowCulling = false;
+        }
+        else if (strcmp(argv[i], "--occluder-wall") == 0)
+        {
+            options.bOccluderWall = true;
+        }
+        else if (strcmp(argv[i], "--no-occlusion-culling") == 0)
+        {
+            options.bOcclusionCulling = false;
+        }
+    }
+    return options;
+}
+
+// Build a benchmark scene: ground plane, a grid of mixed lit primitives and the demo lights.
+// With bMixed every fourth primitive is unlit, so pipeline states alternate in scene order; with
+// bOccluderWall an occluder wall stands between the camera and the middle of the grid
+static void SetupBenchmarkScene(FScene* Scene, uint32 ObjectCount, bool bMixed, bool bOccluderWall)
+{
+    FLightScene* LightScene = Scene->GetLightScene();
+    LightScene->SetAmbientLight(FColor(0.15f, 0.18f, 0.22f, 1.0f));
+
+    FDirectionalLight* sunLight = new FDirectionalLight();
+    sunLight->SetDirection(FVector(0.5f, -0.8f, 0.3f));
+    sunLight->SetIntensity(0.7f);
+    LightScene->AddLight(sunLight);
+
+    FDirectionalLight* fillLight = new FDirectionalLight();
+    fillLight->SetDirection(FVector(-0.3f, -0.5f, -0.4f));
+    fillLight->SetIntensity(0.15f);
+    LightScene->AddLight(fillLight);
+
+    FPointLight* pointLight1 = new FPointLight();
+    pointLight1->SetPosition(FVector(-3.0f, 2.0f, -2.0f));
+    pointLight1->SetRadius(8.0f);
+    LightScene->AddLight(pointLight1);
+
+    FPointLight* pointLight2 = new FPointLight();
+    pointLight2->SetPosition(FVector(3.0f, 2.0f, 2.0f));
+    pointLight2->SetRadius(8.0f);
+    LightScene->AddLight(pointLight2);
+
+    FPlanePrimitive* groundPlane = new FPlanePrimitive(8);
+    groundPlane->SetPosition(FVector(0.0f, -1.0f, 0.0f));
+    groundPlane->SetScale(FVector(20.0f, 1.0f, 20.0f));
+    Scene->AddPrimitive(groundPlane);
+
+    if (bOccluderWall)
+    {
+        FCubePrimitive* wall = new FCubePrimitive();
+        wall->SetPosition(FVector(0.0f, 0.5f, -3.0f));
+        wall->SetScale(FVector(4.0f, 3.0f, 0.2f));
+        wall->SetMaterial(FMaterial::Diffuse(FColor(0.6f, 0.55f, 0.5f, 1.0f)));
+        wall->SetOccluder(true);
+        Scene->AddPrimitive(wall);
+    }
+
+    // Lay objects out on a square grid centered on the origin
+    uint32 gridSize = static_cast<uint32>(std::ceil(std::sqrt(static_cast<float>(ObjectCount))));
+    float spacing = 2.0f;
+    float halfExtent = (gridSize - 1) * spacing * 0.5f;
+
+    for (uint32 i = 0; i < ObjectCount; ++i)
+    {
+        FPrimitive* primitive = nullptr;
+        if (bMixed && i % 4 == 3)
+        {
+            if ((i / 4) % 2)
+            {
+                primitive = new FUnlitSpherePrimitive(16, 12);
+            }
+            else
+            {
+                primitive = new FUnlitCubePrimitive();
+            }
+        }
+        else
+        {
+            switch (i % 3)
+            {
+                case 0:
+                {
+                    FCubePrimitive* cube = new FCubePrimitive();
+                    cube->SetAutoRotate(true);
+                    primitive = cube;
+                    break;
+                }
+                case 1:
+                    primitive = new FSpherePrimitive(24, 16);
+                    break;
+                default:
+                    primitive = new FCylinderPrimitive(24);
+                    break;
+            }
+        }
+
+        float x = (i % gridSize) * spacing - halfExtent;
+        float z = (i / gridSize) * spacing - halfExtent;
+        primitive->SetPosition(FVector(x, 0.0f, z));
+        primitive->SetMaterial(FMaterial::Diffuse(FColor(0.8f, 0.8f, 0.8f, 1.0f)));
+        Scene->AddPrimitive(primitive);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    FHeadlessOptions options = ParseOptions(argc, argv);
+
+    std::unique_ptr<FRHI> RHI(CreateNullRHI());
+    if (!RHI->Initialize(nullptr, 1280, 720))
+    {
+        fprintf(stderr, "Failed to initialize null RHI\n");
+        return 1;
+    }
+
+    static_cast<FNullRHI*>(RHI.get())->SetPipelineStateCreateDelayMs(options.PSOCompileMs);
+
+    // Startup: renderer init, scene setup and the first scene update (creates every proxy)
+    auto startupStart = std::chrono::high_resolution_clock::now();
+    std::unique_ptr<FRenderer> Renderer = std::make_unique<FRenderer>(RHI.get());
+    Renderer->SetPrecachePipelineStates(options.bPrecachePSOs);
+    Renderer->SetSortMeshDrawCommands(options.bSortDraws);
+    Renderer->SetInstancedDraws(options.bInstancedDraws);
+    Renderer->SetFrustumCulling(options.bFrustumCulling);
+    Renderer->SetOcclusionCulling(options.bOcclusionCulling);
+    Renderer->SetShadowCulling(options.bShadowCulling);
+    Renderer->Initialize();
+    g_Camera = Renderer->GetCamera();
+
+    std::unique_ptr<FScene> Scene = std::make_unique<FScene>(RHI.get());
+    g_LightScene = Scene->GetLightScene();
+
+    SetupBenchmarkScene(Scene.get(), options.ObjectCount, options.bMixedScene, options.bOccluderWall);
+    Renderer->UpdateFromScene(Scene.get());
+    double startupMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - startupStart).count();
+
+    FRecordingCommandList* CmdList = static_cast<FNullRHI*>(RHI.get())->GetRecordingCommandList();
+    const float DeltaTime = 1.0f / 60.0f;
+
+    bool bPipelined = options.FrameLead > 0;
+    FRenderer* RendererPtr = Renderer.get();
+    if (bPipelined)
+    {
+        FFrameSyncManager::Get().SetFrameLead(options.FrameLead);
+        FRenderThread::Get().SetRenderer(RendererPtr);
+        FRenderThread::Get().SetRHI(RHI.get());
+        FRenderThread::Get().Start();
+        FRHIThread::Get().SetRHI(RHI.get());
+        FRHIThread::Get().Start();
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    uint64 startAllocations = GHeapAllocationCount.load();
+    double firstFrameMs = 0.0;
+    for (uint32 frame = 0; frame < options.FrameCount; ++frame)
+    {
+        if (!bPipelined)
+        {
+            auto frameStart = std::chrono::high_resolution_clock::now();
+            uint64 frameId = Renderer->GetStats().GetLatencyTracker().BeginFrame();
+            Scene->Tick(DeltaTime);
+            Renderer->UpdateFromScene(Scene.get());
+            Renderer->RenderFrame(frameId);
+            if (frame == 0)
+            {
+                firstFrameMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - frameStart).count();
+            }
+            continue;
+        }
+
+        FFrameSyncManager::Get().GameThread_BeginFrame();
+        uint64 frameId = Renderer->GetStats().GetLatencyTracker().BeginFrame();
+
+        Renderer->GetStats().BeginGameThreadTiming();
+        Scene->Tick(DeltaTime);
+        Renderer->UpdateFromScene(Scene.get());
+        Renderer->GetStats().EndGameThreadTiming();
+
+        ENQUEUE_RENDER_COMMAND(RenderFrame)[RendererPtr, frameId]()
+        {
+            RendererPtr->GetStats().BeginRenderThreadTiming();
+            FFrameSyncManager::Get().RenderThread_BeginFrame();
+
+            FRHICommandRecorder* Recorder = RendererPtr->RecordFrame(frameId);
+            FRHIThread::Get().EnqueueWork([RendererPtr, Recorder]()
+            {
+                FFrameSyncManager::Get().RHIThread_BeginFrame();
+                RendererPtr->ExecuteRecordedFrame(Recorder);
+                FFrameSyncManager::Get().RHIThread_EndFrame();
+            });
+
+            FFrameSyncManager::Get().RenderThread_EndFrame();
+            RendererPtr->GetStats().EndRenderThreadTiming();
+        });
+
+        FFrameSyncManager::Get().GameThread_EndFrame();
+    }
+    if (bPipelined)
+    {
+        FRenderFence fence;
+        fence.BeginFence(true);
+        fence.Wait();
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    uint64 frameAllocations = GHeapAllocationCount.load() - startAllocations;
+
+    double totalMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    const FNullCommandStats& cmdStats = CmdList->GetStats();
+
+    printf("Frames:            %u\n", options.FrameCount);
+    printf("Objects:           %u\n", options.ObjectCount);
+    printf("Avg frame (CPU):   %.3f ms\n", options.FrameCount > 0 ? totalMs / options.FrameCount : 0.0);
+    printf("Draw calls/frame:  %u\n", cmdStats.DrawCalls);
+    printf("Commands/frame:    %u\n", cmdStats.CommandCount);
+    printf("PSO changes/frame: %u\n", cmdStats.PipelineStateChanges);
+    const FRHIStateCacheStats& stateStats = Renderer->GetStateCacheStats();
+    printf("State binds/frame: %u issued, %u filtered (PSO %u/%u, VB %u/%u, IB %u/%u, CB %u/%u, tex %u/%u)\n",
+           stateStats.Issued.GetTotal(), stateStats.Filtered.GetTotal(),
+           stateStats.Issued.PipelineStates, stateStats.Filtered.PipelineStates,
+           stateStats.Issued.VertexBuffers, stateStats.Filtered.VertexBuffers,
+           stateStats.Issued.IndexBuffers, stateStats.Filtered.IndexBuffers,
+           stateStats.Issued.ConstantBuffers, stateStats.Filtered.ConstantBuffers,
+           stateStats.Issued.Textures, stateStats.Filtered.Textures);
+    const FRenderScene* renderScene = Renderer->GetRenderScene();
+    printf("Cached draws:      %u base pass, %u shadow depth, %u list builds\n",
+           renderScene->GetNumCachedMeshDrawCommands(EMeshPass::BasePass),
+           renderScene->GetNumCachedMeshDrawCommands(EMeshPass::ShadowDepth),
+           renderScene->GetNumCachedDrawListBuilds());
+    printf("Instanced draws:   %u base pass (%u instances), %u shadow depth (%u instances)\n",
+           renderScene->GetNumInstancedDraws(EMeshPass::BasePass),
+           renderScene->GetNumInstances(EMeshPass::BasePass),
+           renderScene->GetNumInstancedDraws(EMeshPass::ShadowDepth),
+           renderScene->GetNumInstances(EMeshPass::ShadowDepth));
+    const FSceneCullingStats& cullingStats = renderScene->GetCullingStats();
+    printf("Frustum culling:   %u visible / %u culled proxies, %llu / %llu triangles, %.3f ms\n",
+           cullingStats.VisibleProxies, cullingStats.CulledProxies,
+           static_cast<unsigned long long>(cullingStats.VisibleTriangles),
+           static_cast<unsigned long long>(cullingStats.CulledTriangles), cullingStats.CullTimeMs);
+    const FOcclusionCullingStats& occlusionStats = renderScene->GetOcclusionCullingStats();
+    printf("Occlusion culling: %u occluders (%u triangles), %u / %u proxies hidden (%.1f%%), raster %.3f ms, test %.3f ms\n",
+           occlusionStats.NumOccluders, occlusionStats.OccluderTriangles, occlusionStats.OccludedProxies,
+           occlusionStats.TestedProxies, occlusionStats.GetOccludedPercent(), occlusionStats.RasterTimeMs,
+           occlusionStats.TestTimeMs);
+    const FShadowCullingStats& shadowCullingStats = renderScene->GetShadowCullingStats();
+    printf("Shadow culling:    %u views, %u drawn / %u culled casters, %u shadow draws, %.3f ms\n",
+           shadowCullingStats.NumViews, shadowCullingStats.DrawnCasters, shadowCullingStats.CulledCasters,
+           Renderer->GetShadowSystem()->GetShadowDrawCallCount(), shadowCullingStats.CullTimeMs);
+    printf("Stream bytes:      %zu\n", CmdList->GetCommandStream().size());
+    printf("Triangles:         %u\n", Renderer->GetStats().GetTriangleCount());
+    printf("Heap allocs/frame: %.1f\n", options.FrameCount > 0 ? static_cast<double>(frameAllocations) / options.FrameCount : 0.0);
+    FRHITransientConstantStats constantStats = RHI->GetTransientConstantStats();
+    printf("Transient consts:  %.1f KB/frame, %u allocs/frame, %u pages in %u segments (%.1f KB)\n",
+           constantStats.LastFrameBytes / 1024.0, constantStats.LastFrameAllocations,
+           constantStats.NumPages, constantStats.NumSegments, constantStats.TotalPageBytes / 1024.0);
+    FRHIDeferredReleaseStats releaseStats = RHI->GetDeferredReleaseStats();
+    printf("Deferred releases: %u pending (%.1f KB), %llu released, %u frames in flight\n",
+           releaseStats.PendingObjects, releaseStats.PendingBytes / 1024.0,
+           static_cast<unsigned long long>(releaseStats.ReleasedObjects), releaseStats.FramesInFlight);
+    FGeometryBufferStats geometryStats = FGeometryBufferAllocator::Get()->GetStats();
+    printf("Geometry buffers:  %u ranges in %u pages, %.1f / %.1f KB used\n",
+           geometryStats.NumAllocations, geometryStats.NumPages,
+           geometryStats.UsedBytes / 1024.0, geometryStats.ReservedBytes / 1024.0);
+    FMeshRegistryStats meshStats = FMeshRegistry::Get()->GetStats();
+    printf("Mesh registry:     %u meshes for %u references (%llu hits / %llu misses), %.1f KB (%.1f KB unshared)\n",
+           meshStats.LiveMeshes, meshStats.References,
+           static_cast<unsigned long long>(meshStats.Hits), static_cast<unsigned long long>(meshStats.Misses),
+           meshStats.LiveBytes / 1024.0, meshStats.ReferencedBytes / 1024.0);
+    const FFrameLatencyTracker& latency = Renderer->GetStats().GetLatencyTracker();
+    printf("Latency p50/p95/p99/max: %.3f / %.3f / %.3f / %.3f ms (game begin -> present)\n",
+           latency.GetP50LatencyMs(), latency.GetP95LatencyMs(), latency.GetP99LatencyMs(), latency.GetMaxLatencyMs());
+    if (bPipelined)
+    {
+        const FRenderStats& stats = Renderer->GetStats();
+        printf("Frame lead:        %u\n", FFrameSyncManager::Get().GetFrameLead());
+        printf("Game   %6.3f ms  util %5.1f%%\n", stats.GetGameThreadTime(), stats.GetGameThreadUtilization() * 100.0f);
+        printf("Render %6.3f ms  util %5.1f%%\n", stats.GetRenderThreadTime(), stats.GetRenderThreadUtilization() * 100.0f);
+        printf("RHI    %6.3f ms  util %5.1f%%\n", stats.GetRHIThreadTime(), stats.GetRHIThreadUtilization() * 100.0f);
+
+        FRenderThread::Get().Stop();
+        FRHIThread::Get().Stop();
+    }
+
+    FPipelineStateCacheStats psoStats = FPipelineStateCache::Get()->GetStats();
+    printf("PSO cache:         %u live, %llu hits, %llu misses, %u precached\n", psoStats.LivePipelineStates,
+           static_cast<unsigned long long>(psoStats.Hits), static_cast<unsigned long long>(psoStats.Misses),
+           psoStats.Precached);
+    printf("PSO waits:         %llu (%.3f ms)\n", static_cast<unsigned long long>(psoStats.Waits), psoStats.WaitMs);
+    printf("Startup:           %.3f ms\n", startupMs);
+    if (!bPipelined)
+    {
+        printf("First frame:       %.3f ms\n", firstFrameMs);
+    }
+
+    Scene->Shutdown();
+    Renderer->Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+    Scene.reset();
+    Renderer.reset();
+    RHI->Shutdown();
+
+    return 0;
+}
@@ -101,28 +101,42 @@ void FLightScene::ClearLights()
     FLog::Log(ELogLevel::Info, "FLightScene::ClearLights - All lights cleared");
 }
 
-std::vector<FDirectionalLight*> FLightScene::GetDirectionalLights() const
+// Collect the enabled lights of one type, in scene order
+template<typename LightType, typename ContainerType>
+static void GatherLights(const std::vector<FLight*>& Lights, ELightType Type, ContainerType& OutLights)
 {
-    std::vector<FDirectionalLight*> result;
+    OutLights.clear();
     for (FLight* light : Lights)
     {
-        if (light->IsEnabled() && light->GetType() == ELightType::Directional)
+        if (light->IsEnabled() && light->GetType() == Type)
         {
-            result.push_back(static_cast<FDirectionalLight*>(light));
+            OutLights.push_back(static_cast<LightType*>(light));
         }
     }
+}
+
+std::vector<FDirectionalLight*> FLightScene::GetDirectionalLights() const
+{
+    std::vector<FDirectionalLight*> result;
+    GatherLights<FDirectionalLight>(Lights, ELightType::Directional, result);
     return result;
 }
 
 std::vector<FPointLight*> FLightScene::GetPointLights() const
 {
     std::vector<FPointLight*> result;
-    for (FLight* light : Lights)
-    {
-        if (light->IsEnabled() && light->GetType() == ELightType::Point)
-        {
-            result.push_back(static_cast<FPointLight*>(light));
-        }
-    }
+    GatherLights<FPointLight>(Lights, ELightType::Point, result);
     return result;
 }
+
+void FLightScene::GetDirectionalLights(TFrameVector<FDirectionalLight*>& OutLights) const
+{
+    OutLights.reserve(Lights.size());
+    GatherLights<FDirectionalLight>(Lights, ELightType::Directional, OutLights);
+}
+
+void FLightScene::GetPointLights(TFrameVector<FPointLight*>& OutLights) const
+{
+    OutLights.reserve(Lights.size());
+    GatherLights<FPointLight>(Lights, ELightType::Point, OutLights);
+}
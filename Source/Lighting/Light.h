@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Core/CoreTypes.h"
+#include "../Core/FrameAllocator.h"
 #include <vector>
 
 /**
@@ -196,6 +197,10 @@ public:
     // Get lights by type (for forward rendering multiple passes or deferred light pass)
     std::vector<FDirectionalLight*> GetDirectionalLights() const;
     std::vector<FPointLight*> GetPointLights() const;
+    
+    // Same queries into frame memory, for per-proxy use on the render thread (no heap allocation)
+    void GetDirectionalLights(TFrameVector<FDirectionalLight*>& OutLights) const;
+    void GetPointLights(TFrameVector<FPointLight*>& OutLights) const;
 
     // Ambient light for the scene (global illumination approximation)
     void SetAmbientLight(const FColor& Color) { AmbientLight = Color; }
@@ -5,15 +5,37 @@
 #include <DirectXMath.h>
 
 /**
- * FLightingConstants - GPU constant buffer data for lighting calculations
- * Must match the HLSL LightingBuffer structure exactly
- * Aligned to 16-byte boundaries for GPU compatibility
+ * FMaterialConstants - The material part of FPrimitiveUniformParameters
+ * Packed once per material change instead of every frame
  */
-struct FLightingConstants
+struct FMaterialConstants
 {
-    // Model matrix for transforming normals to world space
-    DirectX::XMMATRIX ModelMatrix;           // 64 bytes
+    DirectX::XMFLOAT4 Diffuse;      // xyz = color, w = unused
+    DirectX::XMFLOAT4 Specular;     // xyz = color, w = shininess
+    DirectX::XMFLOAT4 Ambient;      // xyz = color, w = unused
     
+    FMaterialConstants()
+    {
+        Set(FMaterial());
+    }
+    
+    void Set(const FMaterial& Mat)
+    {
+        Diffuse = { Mat.DiffuseColor.R, Mat.DiffuseColor.G, Mat.DiffuseColor.B, 1.0f };
+        Specular = { Mat.SpecularColor.R, Mat.SpecularColor.G, Mat.SpecularColor.B, Mat.Shininess };
+        Ambient = { Mat.AmbientColor.R, Mat.AmbientColor.G, Mat.AmbientColor.B, 1.0f };
+    }
+};
+
+/**
+ * FViewUniformParameters - Per-view constant buffer data for the lit shaders (b1)
+ * Camera, scene lights and the directional shadow matrix: everything lit draws
+ * share. Filled and uploaded once per frame by FMeshDrawContext::InitBasePass,
+ * and every lit draw of the pass binds that one upload.
+ * Must match the HLSL ViewBuffer structure exactly
+ */
+struct FViewUniformParameters
+{
     // Camera position for specular calculations
     DirectX::XMFLOAT4 CameraPosition;        // 16 bytes (xyz = pos, w = unused)
     
@@ -41,22 +63,19 @@ struct FLightingConstants
     DirectX::XMFLOAT4 PointLight3Color;
     DirectX::XMFLOAT4 PointLight3Params;
     
-    // Material properties
-    DirectX::XMFLOAT4 MaterialDiffuse;       // 16 bytes (xyz = color, w = unused)
-    DirectX::XMFLOAT4 MaterialSpecular;      // 16 bytes (xyz = color, w = shininess)
-    DirectX::XMFLOAT4 MaterialAmbient;       // 16 bytes (xyz = color, w = unused)
+    // Directional shadow map, as rendered by FShadowSystem
+    DirectX::XMMATRIX DirLightViewProj;      // 64 bytes, transposed for HLSL
+    DirectX::XMFLOAT4 DirShadowInfo;         // 16 bytes (x = shadow map rendered, yzw = unused)
     
-    // Total: 64 + 16*20 = 384 bytes
-    // Note: DX12 constant buffers are automatically aligned to 256 bytes by CreateConstantBuffer()
+    // Total: 16*16 + 64 + 16 = 336 bytes
     
-    FLightingConstants()
+    FViewUniformParameters()
     {
         Clear();
     }
     
     void Clear()
     {
-        ModelMatrix = DirectX::XMMatrixIdentity();
         CameraPosition = { 0.0f, 0.0f, 0.0f, 0.0f };
         AmbientLight = { 0.1f, 0.1f, 0.15f, 1.0f };
         
@@ -68,7 +87,8 @@ struct FLightingConstants
         ClearPointLight(2);
         ClearPointLight(3);
         
-        SetDefaultMaterial();
+        DirLightViewProj = DirectX::XMMatrixIdentity();
+        DirShadowInfo = { 0.0f, 0.0f, 0.0f, 0.0f };
     }
     
     void ClearPointLight(int index)
@@ -98,20 +118,6 @@ struct FLightingConstants
         }
     }
     
-    void SetDefaultMaterial()
-    {
-        MaterialDiffuse = { 0.8f, 0.8f, 0.8f, 1.0f };
-        MaterialSpecular = { 1.0f, 1.0f, 1.0f, 32.0f };
-        MaterialAmbient = { 0.1f, 0.1f, 0.1f, 1.0f };
-    }
-    
-    void SetModelMatrix(const FMatrix4x4& Matrix)
-    {
-        // DirectXMath uses row-major storage, HLSL uses column-major by default.
-        // Transpose is required to convert from CPU row-major to GPU column-major.
-        ModelMatrix = DirectX::XMMatrixTranspose(Matrix.Matrix);
-    }
-    
     void SetCameraPosition(const FVector& Pos)
     {
         CameraPosition = { Pos.X, Pos.Y, Pos.Z, 0.0f };
@@ -182,10 +188,25 @@ struct FLightingConstants
         }
     }
     
-    void SetMaterial(const FMaterial& Mat)
+    // Directional shadow matrix (untransposed, as FShadowSystem renders with it); null = no shadow map
+    void SetDirectionalShadow(const FMatrix4x4* LightViewProj)
     {
-        MaterialDiffuse = { Mat.DiffuseColor.R, Mat.DiffuseColor.G, Mat.DiffuseColor.B, 1.0f };
-        MaterialSpecular = { Mat.SpecularColor.R, Mat.SpecularColor.G, Mat.SpecularColor.B, Mat.Shininess };
-        MaterialAmbient = { Mat.AmbientColor.R, Mat.AmbientColor.G, Mat.AmbientColor.B, 1.0f };
+        DirLightViewProj = LightViewProj ? DirectX::XMMatrixTranspose(LightViewProj->Matrix) : DirectX::XMMatrixIdentity();
+        DirShadowInfo.x = LightViewProj ? 1.0f : 0.0f;
     }
 };
+
+/**
+ * FPrimitiveUniformParameters - Per-draw constant buffer data for the lit shaders (b0)
+ * Only what differs between draws: transforms, material and shadow receiving.
+ * Must match the HLSL PrimitiveBuffer structure exactly
+ */
+struct FPrimitiveUniformParameters
+{
+    DirectX::XMMATRIX MVP;                   // 64 bytes, transposed; view-projection for instanced draws
+    DirectX::XMMATRIX ModelMatrix;           // 64 bytes, transposed; not used by instanced draws
+    FMaterialConstants Material;             // 48 bytes
+    DirectX::XMFLOAT4 ShadowParams;          // 16 bytes (x = bias, y = receives shadows, z = strength)
+    
+    // Total: 192 bytes, one 256-byte constant buffer slice
+};
@@ -0,0 +1,129 @@
+#include "DeferredReleaseQueue.h"
+#include <vector>
+
+FDeferredReleaseQueue::FDeferredReleaseQueue()
+    : CurrentFrame(0)
+    , CompletedFrame(0)
+    , PendingBytes(0)
+    , ReleasedObjects(0)
+    , ReleasedBytes(0)
+{
+}
+
+FDeferredReleaseQueue::~FDeferredReleaseQueue()
+{
+    if (!Entries.empty())
+    {
+        FLog::Log(ELogLevel::Warning, "FDeferredReleaseQueue: Destroyed with " + std::to_string(Entries.size()) +
+                  " pending releases, releasing now");
+    }
+    Flush();
+}
+
+uint64 FDeferredReleaseQueue::BeginFrame(uint64 InCompletedFrame)
+{
+    uint64 frame;
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        frame = ++CurrentFrame;
+    }
+    ReleaseCompleted(InCompletedFrame);
+    return frame;
+}
+
+void FDeferredReleaseQueue::Enqueue(FRHIResource* Resource, uint64 SizeInBytes)
+{
+    if (!Resource)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(Mutex);
+    Entries.push_back({ CurrentFrame, Resource, nullptr, SizeInBytes });
+    PendingBytes += SizeInBytes;
+}
+
+void FDeferredReleaseQueue::Enqueue(std::function<void()> Release, uint64 SizeInBytes)
+{
+    if (!Release)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(Mutex);
+    Entries.push_back({ CurrentFrame, nullptr, std::move(Release), SizeInBytes });
+    PendingBytes += SizeInBytes;
+}
+
+void FDeferredReleaseQueue::ReleaseCompleted(uint64 InCompletedFrame)
+{
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (InCompletedFrame > CompletedFrame)
+        {
+            CompletedFrame = InCompletedFrame;
+        }
+    }
+    ReleaseUpTo(InCompletedFrame);
+}
+
+void FDeferredReleaseQueue::Flush()
+{
+    // Callbacks may enqueue more releases (e.g. a buffer freed along with its last range)
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Entries.empty())
+            {
+                return;
+            }
+        }
+        ReleaseUpTo(UINT64_MAX);
+    }
+}
+
+void FDeferredReleaseQueue::ReleaseUpTo(uint64 LastFrame)
+{
+    std::vector<FEntry> retired;
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        while (!Entries.empty() && Entries.front().Frame <= LastFrame)
+        {
+            PendingBytes -= Entries.front().SizeInBytes;
+            ReleasedBytes += Entries.front().SizeInBytes;
+            ++ReleasedObjects;
+            retired.push_back(std::move(Entries.front()));
+            Entries.pop_front();
+        }
+    }
+
+    for (FEntry& entry : retired)
+    {
+        if (entry.Resource)
+        {
+            delete entry.Resource;
+        }
+        else
+        {
+            entry.Release();
+        }
+    }
+}
+
+uint64 FDeferredReleaseQueue::GetCurrentFrame() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    return CurrentFrame;
+}
+
+FRHIDeferredReleaseStats FDeferredReleaseQueue::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    FRHIDeferredReleaseStats stats;
+    stats.PendingObjects = static_cast<uint32>(Entries.size());
+    stats.PendingBytes = PendingBytes;
+    stats.ReleasedObjects = ReleasedObjects;
+    stats.ReleasedBytes = ReleasedBytes;
+    stats.FramesInFlight = CurrentFrame > CompletedFrame ? static_cast<uint32>(CurrentFrame - CompletedFrame) : 0;
+    return stats;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "RHI.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * FDeferredReleaseQueue - RHI resources kept alive until the GPU has finished with them
+ * Similar in spirit to UE5's FD3D12DeferredDeletionQueue
+ *
+ * Frames are numbered by BeginFrame(): frame N is the N-th frame the
+ * renderer has started recording. Anything released while frame N is
+ * current may still be referenced by frames up to N - recorded but not yet
+ * replayed, or submitted but not yet executed - so it is tagged with N and
+ * destroyed once the backend reports N as completed (the GPU has finished
+ * the N-th presented frame).
+ *
+ * Entries are either an RHI resource, deleted on release, or a callback for
+ * things that are not resources of their own, such as a range in a shared
+ * buffer. Entries are tagged in increasing frame order, so the queue is a
+ * FIFO and releasing stops at the first entry still in flight.
+ *
+ * Thread-safe: resources are released from the game, render and RHI threads.
+ * Release callbacks run without the lock held and may enqueue again.
+ */
+class FDeferredReleaseQueue
+{
+public:
+    FDeferredReleaseQueue();
+    ~FDeferredReleaseQueue();
+
+    FDeferredReleaseQueue(const FDeferredReleaseQueue&) = delete;
+    FDeferredReleaseQueue& operator=(const FDeferredReleaseQueue&) = delete;
+
+    // Start recording the next frame, then release everything up to CompletedFrame.
+    // Returns the number of the new frame.
+    uint64 BeginFrame(uint64 CompletedFrame);
+
+    // Destroy Resource / run Release once the current frame has completed
+    void Enqueue(FRHIResource* Resource, uint64 SizeInBytes);
+    void Enqueue(std::function<void()> Release, uint64 SizeInBytes);
+
+    // Release every entry tagged with a frame up to CompletedFrame
+    void ReleaseCompleted(uint64 CompletedFrame);
+
+    // Release everything now - the GPU must be idle
+    void Flush();
+
+    uint64 GetCurrentFrame() const;
+    FRHIDeferredReleaseStats GetStats() const;
+
+private:
+    struct FEntry
+    {
+        uint64 Frame;
+        FRHIResource* Resource;
+        std::function<void()> Release;
+        uint64 SizeInBytes;
+    };
+
+    // Pop the entries up to LastFrame under the lock, release them outside it
+    void ReleaseUpTo(uint64 LastFrame);
+
+    mutable std::mutex Mutex;
+    std::deque<FEntry> Entries;
+    uint64 CurrentFrame;
+    uint64 CompletedFrame;
+    uint64 PendingBytes;
+    uint64 ReleasedObjects;
+    uint64 ReleasedBytes;
+};
@@ -1,4 +1,47 @@
 #include "RHI.h"
+#include "DeferredReleaseQueue.h"
+#include <cstring>
 
-// RHI implementation file
-// This file exists to make RHI a static library consistent with other modules
+void FRHICommandList::UpdateBuffer(FRHIBuffer* Buffer, const void* Data, uint32 Size)
+{
+    void* MappedData = Buffer->Map();
+    memcpy(MappedData, Data, Size);
+    Buffer->Unmap();
+}
+
+FRHITransientAllocation FRHI::UploadTransientConstants(const void* Data, uint32 Size)
+{
+    FRHITransientAllocation Allocation = AllocateTransientConstants(Size);
+    memcpy(Allocation.CPUAddress, Data, Size);
+    return Allocation;
+}
+
+void FRHI::DeferredRelease(FRHIResource* Resource, uint64 SizeInBytes)
+{
+    if (FDeferredReleaseQueue* queue = GetDeferredReleaseQueue())
+    {
+        queue->Enqueue(Resource, SizeInBytes);
+    }
+    else
+    {
+        delete Resource;
+    }
+}
+
+void FRHI::DeferredRelease(std::function<void()> Release, uint64 SizeInBytes)
+{
+    if (FDeferredReleaseQueue* queue = GetDeferredReleaseQueue())
+    {
+        queue->Enqueue(std::move(Release), SizeInBytes);
+    }
+    else if (Release)
+    {
+        Release();
+    }
+}
+
+FRHIDeferredReleaseStats FRHI::GetDeferredReleaseStats() const
+{
+    FDeferredReleaseQueue* queue = GetDeferredReleaseQueue();
+    return queue ? queue->GetStats() : FRHIDeferredReleaseStats();
+}
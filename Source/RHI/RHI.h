@@ -1,12 +1,14 @@
 #pragma once
 
 #include "../Core/CoreTypes.h"
+#include <functional>
 
 // Forward declarations
 class FRHICommandList;
 class FRHIBuffer;
 class FRHIPipelineState;
 class FRHITexture;
+class FDeferredReleaseQueue;
 
 // Vertex data structure (basic, used for unlit rendering)
 struct FVertex 
@@ -97,10 +99,19 @@ public:
     virtual void SetPipelineState(FRHIPipelineState* PipelineState) = 0;
     virtual void SetVertexBuffer(FRHIBuffer* VertexBuffer, uint32 Offset, uint32 Stride) = 0;
     virtual void SetIndexBuffer(FRHIBuffer* IndexBuffer) = 0;
-    virtual void SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex) = 0;
+    // Offset selects a 256-byte aligned slice of the buffer (see FRHI::AllocateTransientConstants)
+    virtual void SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset = 0) = 0;
     virtual void DrawPrimitive(uint32 VertexCount, uint32 StartVertex) = 0;
     virtual void DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) = 0;
     
+    // Per-instance vertex stream (input slot 1) read by Instanced pipeline states
+    // Offset is in bytes; Stride is the size of one instance's data
+    virtual void SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride) = 0;
+    
+    // Draw InstanceCount copies of the indexed mesh; instance i reads element StartInstance + i
+    // of the instance stream
+    virtual void DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance = 0) = 0;
+    
     // Draw indexed primitives with line list topology (for wireframe/debug rendering)
     virtual void DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) = 0;
     
@@ -110,7 +121,7 @@ public:
     virtual void Present() = 0;
     
     // Flush 3D rendering commands before 2D overlay rendering
-    // This ensures all 3D content is rendered before 2D text/UI is drawn on top
+    // Submits the 3D content so 2D text/UI is drawn on top; does not wait for the GPU
     virtual void FlushCommandsFor2D() = 0;
     
     // Text rendering - call FlushCommandsFor2D() before calling this
@@ -149,6 +160,11 @@ public:
     // Bind diffuse texture for shader sampling
     // Call this before rendering textured geometry
     virtual void SetDiffuseTexture(FRHITexture* DiffuseTexture) = 0;
+    
+    // Write Size bytes of Data to the start of a CPU-writable buffer (constant buffers)
+    // Ordered with the surrounding commands, so recorded command lists defer the write
+    // until replay. The default implementation maps, copies and unmaps immediately.
+    virtual void UpdateBuffer(FRHIBuffer* Buffer, const void* Data, uint32 Size);
 };
 
 // Pipeline state creation flags
@@ -162,6 +178,7 @@ enum class EPipelineFlags : uint32
     EnableShadows = 1 << 4, // Enable shadow mapping (requires shadow map textures bound)
     DepthOnly = 1 << 5,     // Depth-only rendering for shadow pass
     EnableTextures = 1 << 6, // Enable texture sampling (requires texture bound)
+    Instanced = 1 << 7,     // World matrix per instance from the instance stream (slot 1)
 };
 
 // Operator overloads for pipeline flags
@@ -180,6 +197,34 @@ inline bool HasFlag(EPipelineFlags flags, EPipelineFlags flag)
     return (static_cast<uint32>(flags) & static_cast<uint32>(flag)) != 0;
 }
 
+// Slice of transient constant memory returned by FRHI::AllocateTransientConstants
+struct FRHITransientAllocation
+{
+    FRHIBuffer* Buffer = nullptr;   // Bind with SetConstantBuffer(Buffer, Index, Offset)
+    uint32 Offset = 0;              // 256-byte aligned
+    void* CPUAddress = nullptr;     // Persistently mapped, write-only
+};
+
+// Transient constant ring statistics
+struct FRHITransientConstantStats
+{
+    uint64 LastFrameBytes = 0;          // Aligned bytes handed out during the previous frame
+    uint32 LastFrameAllocations = 0;
+    uint32 NumPages = 0;                // Constant buffers backing the ring (flat in steady state)
+    uint32 NumSegments = 0;             // One per frame the GPU may still be reading
+    uint64 TotalPageBytes = 0;
+};
+
+// Deferred release queue statistics
+struct FRHIDeferredReleaseStats
+{
+    uint32 PendingObjects = 0;          // Released but possibly still in use by a frame in flight
+    uint64 PendingBytes = 0;
+    uint64 ReleasedObjects = 0;         // Destroyed since startup
+    uint64 ReleasedBytes = 0;
+    uint32 FramesInFlight = 0;          // Frames begun whose Present the GPU has not finished
+};
+
 // RHI Interface - factory for creating RHI resources
 // Note: Resource ownership model - resources created by FRHI are owned by the caller
 // and must be deleted when no longer needed. This matches traditional graphics API patterns.
@@ -210,7 +255,42 @@ public:
     
     // Extended pipeline state creation with flags
     virtual FRHIPipelineState* CreateGraphicsPipelineStateEx(EPipelineFlags Flags) = 0;
+    
+    // Per-frame constants - owned by the RHI, valid until the frame is retired. Sub-allocated
+    // from a persistently mapped ring with one segment per frame in flight.
+    virtual FRHITransientAllocation AllocateTransientConstants(uint32 Size) = 0;
+    
+    // Called by the renderer at the start of every frame, before any AllocateTransientConstants.
+    // Starts a new frame for transient constants and deferred releases, and destroys whatever
+    // the GPU has finished with.
+    virtual void BeginTransientFrame() = 0;
+    
+    virtual FRHITransientConstantStats GetTransientConstantStats() const = 0;
+    
+    // Number of presented frames the GPU has finished executing
+    virtual uint64 GetCompletedFrameFence() const = 0;
+    
+    // Queue holding released resources until the frames that used them complete (may be null)
+    virtual FDeferredReleaseQueue* GetDeferredReleaseQueue() const = 0;
+    
+    // Wait for the GPU to go idle and destroy everything in the deferred release queue
+    virtual void FlushDeferredReleases() = 0;
+    
+    // Copy Size bytes of Data into a new transient allocation
+    FRHITransientAllocation UploadTransientConstants(const void* Data, uint32 Size);
+    
+    // Destroy Resource once no frame in flight can reference it; use instead of delete for
+    // anything a recorded or submitted frame may still read
+    void DeferredRelease(FRHIResource* Resource, uint64 SizeInBytes = 0);
+    
+    // Run Release once no frame in flight can reference what it frees
+    void DeferredRelease(std::function<void()> Release, uint64 SizeInBytes = 0);
+    
+    FRHIDeferredReleaseStats GetDeferredReleaseStats() const;
 };
 
 // Factory function to create platform-specific RHI
 FRHI* CreateDX12RHI();
+
+// Factory function to create the headless null RHI (CPU-backed resources, recorded commands)
+FRHI* CreateNullRHI();
@@ -0,0 +1,408 @@
+#include "RHICommandRecorder.h"
+#include <cstring>
+
+// Sequential reader over one command's payload
+struct FPayloadReader
+{
+    const uint8* Cursor;
+
+    template<typename ValueType>
+    ValueType Read()
+    {
+        ValueType Value;
+        memcpy(&Value, Cursor, sizeof(ValueType));
+        Cursor += sizeof(ValueType);
+        return Value;
+    }
+
+    std::string ReadString()
+    {
+        uint32 Length = Read<uint32>();
+        std::string Text(reinterpret_cast<const char*>(Cursor), Length);
+        Cursor += Length;
+        return Text;
+    }
+};
+
+FRHICommandRecorder::FRHICommandRecorder()
+    : NumCommands(0)
+{
+    // Same initial budget as the null RHI's recording list; a demo frame fits
+    Stream.reserve(64 * 1024);
+}
+
+FRHICommandRecorder::~FRHICommandRecorder()
+{
+}
+
+uint8* FRHICommandRecorder::Record(ECommand Command, uint32 PayloadSize)
+{
+    FCommandHeader Header;
+    Header.Command = Command;
+    Header.PayloadSize = PayloadSize;
+
+    size_t Offset = Stream.size();
+    Stream.resize(Offset + sizeof(FCommandHeader) + PayloadSize);
+    memcpy(Stream.data() + Offset, &Header, sizeof(FCommandHeader));
+
+    NumCommands++;
+    return Stream.data() + Offset + sizeof(FCommandHeader);
+}
+
+template<typename... ArgTypes>
+void FRHICommandRecorder::RecordValues(ECommand Command, const ArgTypes&... Args)
+{
+    uint8* Payload = Record(Command, static_cast<uint32>((sizeof(ArgTypes) + ... + 0)));
+    uint32 Offset = 0;
+    ((memcpy(Payload + Offset, &Args, sizeof(ArgTypes)), Offset += sizeof(ArgTypes)), ...);
+}
+
+void FRHICommandRecorder::RecordString(ECommand Command, const std::string& Text, const void* Extra, uint32 ExtraSize)
+{
+    uint32 Length = static_cast<uint32>(Text.size());
+    uint8* Payload = Record(Command, ExtraSize + sizeof(uint32) + Length);
+    if (ExtraSize > 0)
+    {
+        memcpy(Payload, Extra, ExtraSize);
+    }
+    memcpy(Payload + ExtraSize, &Length, sizeof(uint32));
+    memcpy(Payload + ExtraSize + sizeof(uint32), Text.data(), Length);
+}
+
+void FRHICommandRecorder::Reset()
+{
+    Stream.clear();
+    NumCommands = 0;
+}
+
+void FRHICommandRecorder::BeginFrame()
+{
+    Record(ECommand::BeginFrame, 0);
+}
+
+void FRHICommandRecorder::EndFrame()
+{
+    Record(ECommand::EndFrame, 0);
+}
+
+void FRHICommandRecorder::ClearRenderTarget(const FColor& Color)
+{
+    RecordValues(ECommand::ClearRenderTarget, Color);
+}
+
+void FRHICommandRecorder::ClearDepthStencil()
+{
+    Record(ECommand::ClearDepthStencil, 0);
+}
+
+void FRHICommandRecorder::SetPipelineState(FRHIPipelineState* PipelineState)
+{
+    RecordValues(ECommand::SetPipelineState, PipelineState);
+}
+
+void FRHICommandRecorder::SetVertexBuffer(FRHIBuffer* VertexBuffer, uint32 Offset, uint32 Stride)
+{
+    RecordValues(ECommand::SetVertexBuffer, VertexBuffer, Offset, Stride);
+}
+
+void FRHICommandRecorder::SetIndexBuffer(FRHIBuffer* IndexBuffer)
+{
+    RecordValues(ECommand::SetIndexBuffer, IndexBuffer);
+}
+
+void FRHICommandRecorder::SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset)
+{
+    RecordValues(ECommand::SetConstantBuffer, ConstantBuffer, RootParameterIndex, Offset);
+}
+
+void FRHICommandRecorder::DrawPrimitive(uint32 VertexCount, uint32 StartVertex)
+{
+    RecordValues(ECommand::DrawPrimitive, VertexCount, StartVertex);
+}
+
+void FRHICommandRecorder::DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex)
+{
+    RecordValues(ECommand::DrawIndexedPrimitive, IndexCount, StartIndex, BaseVertex);
+}
+
+void FRHICommandRecorder::SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride)
+{
+    RecordValues(ECommand::SetInstanceBuffer, InstanceBuffer, Offset, Stride);
+}
+
+void FRHICommandRecorder::DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance)
+{
+    RecordValues(ECommand::DrawIndexedInstanced, IndexCountPerInstance, InstanceCount, StartIndex, BaseVertex, StartInstance);
+}
+
+void FRHICommandRecorder::DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex)
+{
+    RecordValues(ECommand::DrawIndexedLines, IndexCount, StartIndex, BaseVertex);
+}
+
+void FRHICommandRecorder::SetPrimitiveTopology(bool bLineList)
+{
+    uint8 LineList = bLineList ? 1 : 0;
+    RecordValues(ECommand::SetPrimitiveTopology, LineList);
+}
+
+void FRHICommandRecorder::Present()
+{
+    Record(ECommand::Present, 0);
+}
+
+void FRHICommandRecorder::FlushCommandsFor2D()
+{
+    Record(ECommand::FlushCommandsFor2D, 0);
+}
+
+void FRHICommandRecorder::RHIDrawText(const std::string& Text, const FVector2D& Position, float FontSize, const FColor& Color)
+{
+    uint8 Extra[sizeof(FVector2D) + sizeof(float) + sizeof(FColor)];
+    memcpy(Extra, &Position, sizeof(FVector2D));
+    memcpy(Extra + sizeof(FVector2D), &FontSize, sizeof(float));
+    memcpy(Extra + sizeof(FVector2D) + sizeof(float), &Color, sizeof(FColor));
+    RecordString(ECommand::RHIDrawText, Text, Extra, sizeof(Extra));
+}
+
+void FRHICommandRecorder::DrawDebugTexture(FRHITexture* Texture, float X, float Y, float Width, float Height)
+{
+    RecordValues(ECommand::DrawDebugTexture, Texture, X, Y, Width, Height);
+}
+
+void FRHICommandRecorder::BeginShadowPass(FRHITexture* ShadowMap, uint32 FaceIndex)
+{
+    RecordValues(ECommand::BeginShadowPass, ShadowMap, FaceIndex);
+}
+
+void FRHICommandRecorder::EndShadowPass()
+{
+    Record(ECommand::EndShadowPass, 0);
+}
+
+void FRHICommandRecorder::SetViewport(float X, float Y, float Width, float Height, float MinDepth, float MaxDepth)
+{
+    RecordValues(ECommand::SetViewport, X, Y, Width, Height, MinDepth, MaxDepth);
+}
+
+void FRHICommandRecorder::ClearDepthOnly(FRHITexture* DepthTexture, uint32 FaceIndex)
+{
+    RecordValues(ECommand::ClearDepthOnly, DepthTexture, FaceIndex);
+}
+
+void FRHICommandRecorder::BeginEvent(const std::string& EventName)
+{
+    RecordString(ECommand::BeginEvent, EventName, nullptr, 0);
+}
+
+void FRHICommandRecorder::EndEvent()
+{
+    Record(ECommand::EndEvent, 0);
+}
+
+void FRHICommandRecorder::SetRootConstants(uint32 RootParameterIndex, uint32 Num32BitValues, const void* Data, uint32 DestOffset)
+{
+    // Payload: index, count, offset, then the values themselves
+    uint32 DataSize = Num32BitValues * sizeof(uint32);
+    uint8* Payload = Record(ECommand::SetRootConstants, 3 * sizeof(uint32) + DataSize);
+    memcpy(Payload, &RootParameterIndex, sizeof(uint32));
+    memcpy(Payload + sizeof(uint32), &Num32BitValues, sizeof(uint32));
+    memcpy(Payload + 2 * sizeof(uint32), &DestOffset, sizeof(uint32));
+    memcpy(Payload + 3 * sizeof(uint32), Data, DataSize);
+}
+
+void FRHICommandRecorder::SetShadowMapTexture(FRHITexture* ShadowMap)
+{
+    RecordValues(ECommand::SetShadowMapTexture, ShadowMap);
+}
+
+void FRHICommandRecorder::SetDiffuseTexture(FRHITexture* DiffuseTexture)
+{
+    RecordValues(ECommand::SetDiffuseTexture, DiffuseTexture);
+}
+
+void FRHICommandRecorder::UpdateBuffer(FRHIBuffer* Buffer, const void* Data, uint32 Size)
+{
+    // Payload: buffer, size, then a copy of the data
+    uint8* Payload = Record(ECommand::UpdateBuffer, sizeof(FRHIBuffer*) + sizeof(uint32) + Size);
+    memcpy(Payload, &Buffer, sizeof(FRHIBuffer*));
+    memcpy(Payload + sizeof(FRHIBuffer*), &Size, sizeof(uint32));
+    memcpy(Payload + sizeof(FRHIBuffer*) + sizeof(uint32), Data, Size);
+}
+
+void FRHICommandRecorder::Replay(FRHICommandList* Target) const
+{
+    size_t Offset = 0;
+    while (Offset + sizeof(FCommandHeader) <= Stream.size())
+    {
+        FCommandHeader Header;
+        memcpy(&Header, Stream.data() + Offset, sizeof(FCommandHeader));
+        Offset += sizeof(FCommandHeader);
+
+        FPayloadReader Reader{ Stream.data() + Offset };
+        Offset += Header.PayloadSize;
+
+        switch (Header.Command)
+        {
+            case ECommand::BeginFrame:
+                Target->BeginFrame();
+                break;
+            case ECommand::EndFrame:
+                Target->EndFrame();
+                break;
+            case ECommand::ClearRenderTarget:
+                Target->ClearRenderTarget(Reader.Read<FColor>());
+                break;
+            case ECommand::ClearDepthStencil:
+                Target->ClearDepthStencil();
+                break;
+            case ECommand::SetPipelineState:
+                Target->SetPipelineState(Reader.Read<FRHIPipelineState*>());
+                break;
+            case ECommand::SetVertexBuffer:
+            {
+                FRHIBuffer* VertexBuffer = Reader.Read<FRHIBuffer*>();
+                uint32 VertexOffset = Reader.Read<uint32>();
+                uint32 Stride = Reader.Read<uint32>();
+                Target->SetVertexBuffer(VertexBuffer, VertexOffset, Stride);
+                break;
+            }
+            case ECommand::SetIndexBuffer:
+                Target->SetIndexBuffer(Reader.Read<FRHIBuffer*>());
+                break;
+            case ECommand::SetConstantBuffer:
+            {
+                FRHIBuffer* ConstantBuffer = Reader.Read<FRHIBuffer*>();
+                uint32 RootParameterIndex = Reader.Read<uint32>();
+                uint32 Offset = Reader.Read<uint32>();
+                Target->SetConstantBuffer(ConstantBuffer, RootParameterIndex, Offset);
+                break;
+            }
+            case ECommand::DrawPrimitive:
+            {
+                uint32 VertexCount = Reader.Read<uint32>();
+                uint32 StartVertex = Reader.Read<uint32>();
+                Target->DrawPrimitive(VertexCount, StartVertex);
+                break;
+            }
+            case ECommand::DrawIndexedPrimitive:
+            case ECommand::DrawIndexedLines:
+            {
+                uint32 IndexCount = Reader.Read<uint32>();
+                uint32 StartIndex = Reader.Read<uint32>();
+                uint32 BaseVertex = Reader.Read<uint32>();
+                if (Header.Command == ECommand::DrawIndexedPrimitive)
+                {
+                    Target->DrawIndexedPrimitive(IndexCount, StartIndex, BaseVertex);
+                }
+                else
+                {
+                    Target->DrawIndexedLines(IndexCount, StartIndex, BaseVertex);
+                }
+                break;
+            }
+            case ECommand::SetInstanceBuffer:
+            {
+                FRHIBuffer* InstanceBuffer = Reader.Read<FRHIBuffer*>();
+                uint32 InstanceOffset = Reader.Read<uint32>();
+                uint32 Stride = Reader.Read<uint32>();
+                Target->SetInstanceBuffer(InstanceBuffer, InstanceOffset, Stride);
+                break;
+            }
+            case ECommand::DrawIndexedInstanced:
+            {
+                uint32 IndexCountPerInstance = Reader.Read<uint32>();
+                uint32 InstanceCount = Reader.Read<uint32>();
+                uint32 StartIndex = Reader.Read<uint32>();
+                uint32 BaseVertex = Reader.Read<uint32>();
+                uint32 StartInstance = Reader.Read<uint32>();
+                Target->DrawIndexedInstanced(IndexCountPerInstance, InstanceCount, StartIndex, BaseVertex, StartInstance);
+                break;
+            }
+            case ECommand::SetPrimitiveTopology:
+                Target->SetPrimitiveTopology(Reader.Read<uint8>() != 0);
+                break;
+            case ECommand::Present:
+                Target->Present();
+                break;
+            case ECommand::FlushCommandsFor2D:
+                Target->FlushCommandsFor2D();
+                break;
+            case ECommand::RHIDrawText:
+            {
+                FVector2D Position = Reader.Read<FVector2D>();
+                float FontSize = Reader.Read<float>();
+                FColor Color = Reader.Read<FColor>();
+                Target->RHIDrawText(Reader.ReadString(), Position, FontSize, Color);
+                break;
+            }
+            case ECommand::DrawDebugTexture:
+            {
+                FRHITexture* Texture = Reader.Read<FRHITexture*>();
+                float X = Reader.Read<float>();
+                float Y = Reader.Read<float>();
+                float Width = Reader.Read<float>();
+                float Height = Reader.Read<float>();
+                Target->DrawDebugTexture(Texture, X, Y, Width, Height);
+                break;
+            }
+            case ECommand::BeginShadowPass:
+            {
+                FRHITexture* ShadowMap = Reader.Read<FRHITexture*>();
+                uint32 FaceIndex = Reader.Read<uint32>();
+                Target->BeginShadowPass(ShadowMap, FaceIndex);
+                break;
+            }
+            case ECommand::EndShadowPass:
+                Target->EndShadowPass();
+                break;
+            case ECommand::SetViewport:
+            {
+                float Viewport[6];
+                for (float& Value : Viewport)
+                {
+                    Value = Reader.Read<float>();
+                }
+                Target->SetViewport(Viewport[0], Viewport[1], Viewport[2], Viewport[3], Viewport[4], Viewport[5]);
+                break;
+            }
+            case ECommand::ClearDepthOnly:
+            {
+                FRHITexture* DepthTexture = Reader.Read<FRHITexture*>();
+                uint32 FaceIndex = Reader.Read<uint32>();
+                Target->ClearDepthOnly(DepthTexture, FaceIndex);
+                break;
+            }
+            case ECommand::BeginEvent:
+                Target->BeginEvent(Reader.ReadString());
+                break;
+            case ECommand::EndEvent:
+                Target->EndEvent();
+                break;
+            case ECommand::SetRootConstants:
+            {
+                uint32 RootParameterIndex = Reader.Read<uint32>();
+                uint32 Num32BitValues = Reader.Read<uint32>();
+                uint32 DestOffset = Reader.Read<uint32>();
+                Target->SetRootConstants(RootParameterIndex, Num32BitValues, Reader.Cursor, DestOffset);
+                break;
+            }
+            case ECommand::SetShadowMapTexture:
+                Target->SetShadowMapTexture(Reader.Read<FRHITexture*>());
+                break;
+            case ECommand::SetDiffuseTexture:
+                Target->SetDiffuseTexture(Reader.Read<FRHITexture*>());
+                break;
+            case ECommand::UpdateBuffer:
+            {
+                FRHIBuffer* Buffer = Reader.Read<FRHIBuffer*>();
+                uint32 Size = Reader.Read<uint32>();
+                Target->UpdateBuffer(Buffer, Reader.Cursor, Size);
+                break;
+            }
+            default:
+                FLog::Log(ELogLevel::Error, "FRHICommandRecorder::Replay - unknown command in stream");
+                return;
+        }
+    }
+}
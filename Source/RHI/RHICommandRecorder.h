@@ -0,0 +1,123 @@
+#pragma once
+
+#include "RHI.h"
+#include <vector>
+
+/**
+ * FRHICommandRecorder - backend-independent recorded command list
+ * Similar in spirit to UE5's FRHICommandList when the RHI thread is enabled
+ *
+ * Implements FRHICommandList by appending every call to a linear byte stream
+ * instead of executing it. Replay() later issues the same calls, in order,
+ * on a real command list - typically on the RHI thread while the render
+ * thread records the next frame into another recorder.
+ *
+ * Recorded data:
+ * - Resources (buffers, textures, pipeline states) are stored as pointers and
+ *   must stay alive until the stream has been replayed
+ * - Strings, root constants and UpdateBuffer contents are copied into the
+ *   stream, so callers may reuse their memory immediately
+ *
+ * Stream layout: each command is an 8-byte header (opcode, payload size)
+ * followed by its payload. Reset() keeps the allocation, so a recorder reused
+ * every frame stops allocating once it has seen its largest frame.
+ */
+class FRHICommandRecorder : public FRHICommandList
+{
+public:
+    enum class ECommand : uint32
+    {
+        BeginFrame,
+        EndFrame,
+        ClearRenderTarget,
+        ClearDepthStencil,
+        SetPipelineState,
+        SetVertexBuffer,
+        SetIndexBuffer,
+        SetConstantBuffer,
+        DrawPrimitive,
+        DrawIndexedPrimitive,
+        SetInstanceBuffer,
+        DrawIndexedInstanced,
+        DrawIndexedLines,
+        SetPrimitiveTopology,
+        Present,
+        FlushCommandsFor2D,
+        RHIDrawText,
+        DrawDebugTexture,
+        BeginShadowPass,
+        EndShadowPass,
+        SetViewport,
+        ClearDepthOnly,
+        BeginEvent,
+        EndEvent,
+        SetRootConstants,
+        SetShadowMapTexture,
+        SetDiffuseTexture,
+        UpdateBuffer,
+
+        Count
+    };
+
+    FRHICommandRecorder();
+    virtual ~FRHICommandRecorder() override;
+
+    virtual void BeginFrame() override;
+    virtual void EndFrame() override;
+    virtual void ClearRenderTarget(const FColor& Color) override;
+    virtual void ClearDepthStencil() override;
+    virtual void SetPipelineState(FRHIPipelineState* PipelineState) override;
+    virtual void SetVertexBuffer(FRHIBuffer* VertexBuffer, uint32 Offset, uint32 Stride) override;
+    virtual void SetIndexBuffer(FRHIBuffer* IndexBuffer) override;
+    virtual void SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset = 0) override;
+    virtual void DrawPrimitive(uint32 VertexCount, uint32 StartVertex) override;
+    virtual void DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
+    virtual void SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride) override;
+    virtual void DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance = 0) override;
+    virtual void DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
+    virtual void SetPrimitiveTopology(bool bLineList = false) override;
+    virtual void Present() override;
+    virtual void FlushCommandsFor2D() override;
+    virtual void RHIDrawText(const std::string& Text, const FVector2D& Position, float FontSize, const FColor& Color) override;
+    virtual void DrawDebugTexture(FRHITexture* Texture, float X, float Y, float Width, float Height) override;
+    virtual void BeginShadowPass(FRHITexture* ShadowMap, uint32 FaceIndex = 0) override;
+    virtual void EndShadowPass() override;
+    virtual void SetViewport(float X, float Y, float Width, float Height, float MinDepth = 0.0f, float MaxDepth = 1.0f) override;
+    virtual void ClearDepthOnly(FRHITexture* DepthTexture, uint32 FaceIndex = 0) override;
+    virtual void BeginEvent(const std::string& EventName) override;
+    virtual void EndEvent() override;
+    virtual void SetRootConstants(uint32 RootParameterIndex, uint32 Num32BitValues, const void* Data, uint32 DestOffset = 0) override;
+    virtual void SetShadowMapTexture(FRHITexture* ShadowMap) override;
+    virtual void SetDiffuseTexture(FRHITexture* DiffuseTexture) override;
+    virtual void UpdateBuffer(FRHIBuffer* Buffer, const void* Data, uint32 Size) override;
+
+    // Issue every recorded command, in order, on Target. The stream is left intact.
+    void Replay(FRHICommandList* Target) const;
+
+    // Drop the recorded commands (keeps the stream allocation)
+    void Reset();
+
+    uint32 GetNumCommands() const { return NumCommands; }
+    size_t GetStreamSize() const { return Stream.size(); }
+    size_t GetStreamCapacity() const { return Stream.capacity(); }
+
+private:
+    struct FCommandHeader
+    {
+        ECommand Command;
+        uint32 PayloadSize;
+    };
+
+    // Append a command header and reserve its payload; returns the payload start
+    uint8* Record(ECommand Command, uint32 PayloadSize);
+
+    // Pack the arguments back to back into the payload
+    template<typename... ArgTypes>
+    void RecordValues(ECommand Command, const ArgTypes&... Args);
+
+    // Extra data, then uint32 length, then the characters
+    void RecordString(ECommand Command, const std::string& Text, const void* Extra, uint32 ExtraSize);
+
+    std::vector<uint8> Stream;
+    uint32 NumCommands;
+};
@@ -0,0 +1,280 @@
+#include "RHIStateCache.h"
+
+FRHIStateCache::FRHIStateCache()
+    : FRHIStateCache(nullptr)
+{
+}
+
+FRHIStateCache::FRHIStateCache(FRHICommandList* InTarget)
+    : Target(InTarget)
+{
+    Invalidate();
+}
+
+FRHIStateCache::~FRHIStateCache()
+{
+}
+
+void FRHIStateCache::SetTarget(FRHICommandList* InTarget)
+{
+    Target = InTarget;
+    Invalidate();
+}
+
+void FRHIStateCache::Invalidate()
+{
+    PipelineState = nullptr;
+    VertexBuffer = nullptr;
+    VertexBufferOffset = 0;
+    VertexBufferStride = 0;
+    InstanceBuffer = nullptr;
+    InstanceBufferOffset = 0;
+    InstanceBufferStride = 0;
+    IndexBuffer = nullptr;
+    InvalidateRootBindings();
+}
+
+void FRHIStateCache::InvalidateRootBindings()
+{
+    for (FConstantBufferBinding& binding : ConstantBuffers)
+    {
+        binding.Buffer = nullptr;
+        binding.Offset = 0;
+    }
+    ShadowMapTexture = nullptr;
+    DiffuseTexture = nullptr;
+}
+
+void FRHIStateCache::BeginFrame()
+{
+    CurrentFrameStats = FRHIStateCacheStats();
+
+    Invalidate();
+    Target->BeginFrame();
+}
+
+void FRHIStateCache::EndFrame()
+{
+    Invalidate();
+    Target->EndFrame();
+}
+
+void FRHIStateCache::ClearRenderTarget(const FColor& Color)
+{
+    Target->ClearRenderTarget(Color);
+}
+
+void FRHIStateCache::ClearDepthStencil()
+{
+    Target->ClearDepthStencil();
+}
+
+void FRHIStateCache::SetPipelineState(FRHIPipelineState* InPipelineState)
+{
+    if (InPipelineState && InPipelineState == PipelineState)
+    {
+        ++CurrentFrameStats.Filtered.PipelineStates;
+        return;
+    }
+
+    // A new PSO brings its own root signature, which drops the root bindings
+    PipelineState = InPipelineState;
+    InvalidateRootBindings();
+    ++CurrentFrameStats.Issued.PipelineStates;
+    Target->SetPipelineState(InPipelineState);
+}
+
+void FRHIStateCache::SetVertexBuffer(FRHIBuffer* InVertexBuffer, uint32 Offset, uint32 Stride)
+{
+    if (InVertexBuffer && InVertexBuffer == VertexBuffer && Offset == VertexBufferOffset && Stride == VertexBufferStride)
+    {
+        ++CurrentFrameStats.Filtered.VertexBuffers;
+        return;
+    }
+
+    VertexBuffer = InVertexBuffer;
+    VertexBufferOffset = Offset;
+    VertexBufferStride = Stride;
+    ++CurrentFrameStats.Issued.VertexBuffers;
+    Target->SetVertexBuffer(InVertexBuffer, Offset, Stride);
+}
+
+void FRHIStateCache::SetIndexBuffer(FRHIBuffer* InIndexBuffer)
+{
+    if (InIndexBuffer && InIndexBuffer == IndexBuffer)
+    {
+        ++CurrentFrameStats.Filtered.IndexBuffers;
+        return;
+    }
+
+    IndexBuffer = InIndexBuffer;
+    ++CurrentFrameStats.Issued.IndexBuffers;
+    Target->SetIndexBuffer(InIndexBuffer);
+}
+
+void FRHIStateCache::SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset)
+{
+    if (RootParameterIndex < MaxConstantBufferSlots)
+    {
+        FConstantBufferBinding& binding = ConstantBuffers[RootParameterIndex];
+        if (ConstantBuffer && ConstantBuffer == binding.Buffer && Offset == binding.Offset)
+        {
+            ++CurrentFrameStats.Filtered.ConstantBuffers;
+            return;
+        }
+        binding.Buffer = ConstantBuffer;
+        binding.Offset = Offset;
+    }
+
+    ++CurrentFrameStats.Issued.ConstantBuffers;
+    Target->SetConstantBuffer(ConstantBuffer, RootParameterIndex, Offset);
+}
+
+void FRHIStateCache::DrawPrimitive(uint32 VertexCount, uint32 StartVertex)
+{
+    Target->DrawPrimitive(VertexCount, StartVertex);
+}
+
+void FRHIStateCache::DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex)
+{
+    Target->DrawIndexedPrimitive(IndexCount, StartIndex, BaseVertex);
+}
+
+void FRHIStateCache::SetInstanceBuffer(FRHIBuffer* InInstanceBuffer, uint32 Offset, uint32 Stride)
+{
+    if (InInstanceBuffer && InInstanceBuffer == InstanceBuffer && Offset == InstanceBufferOffset && Stride == InstanceBufferStride)
+    {
+        ++CurrentFrameStats.Filtered.VertexBuffers;
+        return;
+    }
+
+    InstanceBuffer = InInstanceBuffer;
+    InstanceBufferOffset = Offset;
+    InstanceBufferStride = Stride;
+    ++CurrentFrameStats.Issued.VertexBuffers;
+    Target->SetInstanceBuffer(InInstanceBuffer, Offset, Stride);
+}
+
+void FRHIStateCache::DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance)
+{
+    Target->DrawIndexedInstanced(IndexCountPerInstance, InstanceCount, StartIndex, BaseVertex, StartInstance);
+}
+
+void FRHIStateCache::DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex)
+{
+    Target->DrawIndexedLines(IndexCount, StartIndex, BaseVertex);
+}
+
+void FRHIStateCache::SetPrimitiveTopology(bool bLineList)
+{
+    // Draw calls set their own topology on the backends, so this is not tracked
+    Target->SetPrimitiveTopology(bLineList);
+}
+
+void FRHIStateCache::Present()
+{
+    LastFrameStats = CurrentFrameStats;
+    Invalidate();
+    Target->Present();
+}
+
+void FRHIStateCache::FlushCommandsFor2D()
+{
+    // The backend closes, submits and resets its command list
+    Invalidate();
+    Target->FlushCommandsFor2D();
+}
+
+void FRHIStateCache::RHIDrawText(const std::string& Text, const FVector2D& Position, float FontSize, const FColor& Color)
+{
+    Invalidate();
+    Target->RHIDrawText(Text, Position, FontSize, Color);
+}
+
+void FRHIStateCache::DrawDebugTexture(FRHITexture* Texture, float X, float Y, float Width, float Height)
+{
+    Invalidate();
+    Target->DrawDebugTexture(Texture, X, Y, Width, Height);
+}
+
+void FRHIStateCache::BeginShadowPass(FRHITexture* ShadowMap, uint32 FaceIndex)
+{
+    // Only the render target changes; bindings carry over into the pass
+    Target->BeginShadowPass(ShadowMap, FaceIndex);
+}
+
+void FRHIStateCache::EndShadowPass()
+{
+    Target->EndShadowPass();
+}
+
+void FRHIStateCache::SetViewport(float X, float Y, float Width, float Height, float MinDepth, float MaxDepth)
+{
+    Target->SetViewport(X, Y, Width, Height, MinDepth, MaxDepth);
+}
+
+void FRHIStateCache::ClearDepthOnly(FRHITexture* DepthTexture, uint32 FaceIndex)
+{
+    Target->ClearDepthOnly(DepthTexture, FaceIndex);
+}
+
+void FRHIStateCache::BeginEvent(const std::string& EventName)
+{
+    Target->BeginEvent(EventName);
+}
+
+void FRHIStateCache::EndEvent()
+{
+    Target->EndEvent();
+}
+
+void FRHIStateCache::SetRootConstants(uint32 RootParameterIndex, uint32 Num32BitValues, const void* Data, uint32 DestOffset)
+{
+    // Overwrites whatever the slot held, including a constant buffer bound to it
+    if (RootParameterIndex < MaxConstantBufferSlots)
+    {
+        ConstantBuffers[RootParameterIndex].Buffer = nullptr;
+    }
+    Target->SetRootConstants(RootParameterIndex, Num32BitValues, Data, DestOffset);
+}
+
+void FRHIStateCache::SetShadowMapTexture(FRHITexture* ShadowMap)
+{
+    if (ShadowMap && ShadowMap == ShadowMapTexture)
+    {
+        ++CurrentFrameStats.Filtered.Textures;
+        return;
+    }
+
+    // Binding sets the texture's own descriptor heap, which replaces the diffuse texture's
+    if (ShadowMap)
+    {
+        ShadowMapTexture = ShadowMap;
+        DiffuseTexture = nullptr;
+    }
+    ++CurrentFrameStats.Issued.Textures;
+    Target->SetShadowMapTexture(ShadowMap);
+}
+
+void FRHIStateCache::SetDiffuseTexture(FRHITexture* InDiffuseTexture)
+{
+    if (InDiffuseTexture && InDiffuseTexture == DiffuseTexture)
+    {
+        ++CurrentFrameStats.Filtered.Textures;
+        return;
+    }
+
+    if (InDiffuseTexture)
+    {
+        DiffuseTexture = InDiffuseTexture;
+        ShadowMapTexture = nullptr;
+    }
+    ++CurrentFrameStats.Issued.Textures;
+    Target->SetDiffuseTexture(InDiffuseTexture);
+}
+
+void FRHIStateCache::UpdateBuffer(FRHIBuffer* Buffer, const void* Data, uint32 Size)
+{
+    // Bindings refer to the buffer, not its contents, so they stay valid
+    Target->UpdateBuffer(Buffer, Data, Size);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "RHI.h"
+
+/**
+ * FRHIStateChangeCounts - State-setting calls of one kind, per category
+ */
+struct FRHIStateChangeCounts
+{
+    uint32 PipelineStates = 0;
+    uint32 VertexBuffers = 0;      // Vertex and instance streams
+    uint32 IndexBuffers = 0;
+    uint32 ConstantBuffers = 0;
+    uint32 Textures = 0;            // Shadow map and diffuse texture binds
+
+    uint32 GetTotal() const { return PipelineStates + VertexBuffers + IndexBuffers + ConstantBuffers + Textures; }
+};
+
+/**
+ * FRHIStateCacheStats - Binds passed on to the target versus dropped as redundant
+ */
+struct FRHIStateCacheStats
+{
+    FRHIStateChangeCounts Issued;
+    FRHIStateChangeCounts Filtered;
+};
+
+/**
+ * FRHIStateCache - Command list adapter that drops redundant state changes
+ * Similar in spirit to UE5's FD3D12StateCache
+ *
+ * Forwards every call to a target command list (a backend list or an
+ * FRHICommandRecorder) and keeps a shadow copy of what is bound. A bind of
+ * the pipeline state, vertex / instance / index buffer, a root constant buffer slot or
+ * a texture that matches the shadow copy is not forwarded.
+ *
+ * The shadow copy follows the backend's rules for what survives:
+ * - Everything is forgotten at BeginFrame, EndFrame, FlushCommandsFor2D,
+ *   Present and the 2D overlay calls, which reset or replace the backend's
+ *   command list
+ * - Constant buffers and textures are root-signature bindings, so they are
+ *   forgotten whenever a different pipeline state is set
+ * - Shadow map and diffuse textures each set their own descriptor heap, so
+ *   binding one forgets the other
+ *
+ * Root constants and UpdateBuffer are always forwarded. Counters cover one
+ * frame, BeginFrame to Present; GetLastFrameStats() returns the last frame
+ * that was presented.
+ */
+class FRHIStateCache : public FRHICommandList
+{
+public:
+    static constexpr uint32 MaxConstantBufferSlots = 8;
+
+    FRHIStateCache();
+    explicit FRHIStateCache(FRHICommandList* InTarget);
+    virtual ~FRHIStateCache() override;
+
+    // Command list the calls go to; forgets all bound state
+    void SetTarget(FRHICommandList* InTarget);
+    FRHICommandList* GetTarget() const { return Target; }
+
+    // Forget all bound state, e.g. after issuing commands on the target directly
+    void Invalidate();
+
+    const FRHIStateCacheStats& GetCurrentFrameStats() const { return CurrentFrameStats; }
+    const FRHIStateCacheStats& GetLastFrameStats() const { return LastFrameStats; }
+
+    virtual void BeginFrame() override;
+    virtual void EndFrame() override;
+    virtual void ClearRenderTarget(const FColor& Color) override;
+    virtual void ClearDepthStencil() override;
+    virtual void SetPipelineState(FRHIPipelineState* PipelineState) override;
+    virtual void SetVertexBuffer(FRHIBuffer* VertexBuffer, uint32 Offset, uint32 Stride) override;
+    virtual void SetIndexBuffer(FRHIBuffer* IndexBuffer) override;
+    virtual void SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset = 0) override;
+    virtual void DrawPrimitive(uint32 VertexCount, uint32 StartVertex) override;
+    virtual void DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
+    virtual void SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride) override;
+    virtual void DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance = 0) override;
+    virtual void DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
+    virtual void SetPrimitiveTopology(bool bLineList = false) override;
+    virtual void Present() override;
+    virtual void FlushCommandsFor2D() override;
+    virtual void RHIDrawText(const std::string& Text, const FVector2D& Position, float FontSize, const FColor& Color) override;
+    virtual void DrawDebugTexture(FRHITexture* Texture, float X, float Y, float Width, float Height) override;
+    virtual void BeginShadowPass(FRHITexture* ShadowMap, uint32 FaceIndex = 0) override;
+    virtual void EndShadowPass() override;
+    virtual void SetViewport(float X, float Y, float Width, float Height, float MinDepth = 0.0f, float MaxDepth = 1.0f) override;
+    virtual void ClearDepthOnly(FRHITexture* DepthTexture, uint32 FaceIndex = 0) override;
+    virtual void BeginEvent(const std::string& EventName) override;
+    virtual void EndEvent() override;
+    virtual void SetRootConstants(uint32 RootParameterIndex, uint32 Num32BitValues, const void* Data, uint32 DestOffset = 0) override;
+    virtual void SetShadowMapTexture(FRHITexture* ShadowMap) override;
+    virtual void SetDiffuseTexture(FRHITexture* DiffuseTexture) override;
+    virtual void UpdateBuffer(FRHIBuffer* Buffer, const void* Data, uint32 Size) override;
+
+private:
+    struct FConstantBufferBinding
+    {
+        FRHIBuffer* Buffer;
+        uint32 Offset;
+    };
+
+    // Forget the bindings that belong to the root signature
+    void InvalidateRootBindings();
+
+    FRHICommandList* Target;
+
+    // Shadow copy of the target's bindings; nullptr means unknown
+    FRHIPipelineState* PipelineState;
+    FRHIBuffer* VertexBuffer;
+    uint32 VertexBufferOffset;
+    uint32 VertexBufferStride;
+    FRHIBuffer* InstanceBuffer;
+    uint32 InstanceBufferOffset;
+    uint32 InstanceBufferStride;
+    FRHIBuffer* IndexBuffer;
+    FConstantBufferBinding ConstantBuffers[MaxConstantBufferSlots];
+    FRHITexture* ShadowMapTexture;
+    FRHITexture* DiffuseTexture;
+
+    FRHIStateCacheStats CurrentFrameStats;
+    FRHIStateCacheStats LastFrameStats;
+};
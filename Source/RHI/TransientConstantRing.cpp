@@ -0,0 +1,105 @@
+#include "TransientConstantRing.h"
+
+FTransientConstantRing::FTransientConstantRing(FRHI* InRHI, uint32 InPageSize)
+    : RHI(InRHI)
+    , PageSize(InPageSize)
+    , FrameIndex(0)
+    , NumPages(0)
+    , TotalPageBytes(0)
+    , LastFrameBytes(0)
+    , LastFrameAllocations(0)
+{
+    Segments.resize(1);
+}
+
+FTransientConstantRing::~FTransientConstantRing()
+{
+    for (FFrameSegment& segment : Segments)
+    {
+        for (FPage& page : segment.Pages)
+        {
+            page.Buffer->Unmap();
+            delete page.Buffer;
+        }
+        segment.Pages.clear();
+    }
+}
+
+FRHITransientAllocation FTransientConstantRing::Allocate(uint32 Size)
+{
+    uint32 alignedSize = (Size + Alignment - 1) & ~(Alignment - 1);
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    FFrameSegment& segment = Segments[FrameIndex];
+
+    // Move on to the first page (kept from earlier frames or new) with room for the slice
+    while (segment.CurrentPage < segment.Pages.size() &&
+           segment.Cursor + alignedSize > segment.Pages[segment.CurrentPage].Size)
+    {
+        ++segment.CurrentPage;
+        segment.Cursor = 0;
+    }
+    if (segment.CurrentPage == segment.Pages.size())
+    {
+        uint32 pageSize = alignedSize > PageSize ? alignedSize : PageSize;
+        FRHIBuffer* buffer = RHI->CreateConstantBuffer(pageSize);
+        segment.Pages.push_back(FPage{ buffer, static_cast<uint8*>(buffer->Map()), pageSize });
+        ++NumPages;
+        TotalPageBytes += pageSize;
+    }
+
+    FPage& page = segment.Pages[segment.CurrentPage];
+    FRHITransientAllocation allocation;
+    allocation.Buffer = page.Buffer;
+    allocation.Offset = segment.Cursor;
+    allocation.CPUAddress = page.CPUAddress + segment.Cursor;
+
+    segment.Cursor += alignedSize;
+    segment.BytesAllocated += alignedSize;
+    ++segment.NumAllocations;
+    return allocation;
+}
+
+void FTransientConstantRing::BeginFrame(uint64 Frame, uint64 CompletedFrame)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    LastFrameBytes = Segments[FrameIndex].BytesAllocated;
+    LastFrameAllocations = Segments[FrameIndex].NumAllocations;
+
+    // Oldest segment the GPU has finished reading
+    uint32 reuseIndex = static_cast<uint32>(Segments.size());
+    for (uint32 index = 0; index < Segments.size(); ++index)
+    {
+        if (Segments[index].Frame <= CompletedFrame &&
+            (reuseIndex == Segments.size() || Segments[index].Frame < Segments[reuseIndex].Frame))
+        {
+            reuseIndex = index;
+        }
+    }
+    if (reuseIndex == Segments.size())
+    {
+        Segments.emplace_back();
+    }
+
+    FrameIndex = reuseIndex;
+    FFrameSegment& segment = Segments[FrameIndex];
+    segment.Frame = Frame;
+    segment.CurrentPage = 0;
+    segment.Cursor = 0;
+    segment.BytesAllocated = 0;
+    segment.NumAllocations = 0;
+}
+
+FRHITransientConstantStats FTransientConstantRing::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    FRHITransientConstantStats stats;
+    stats.LastFrameBytes = LastFrameBytes;
+    stats.LastFrameAllocations = LastFrameAllocations;
+    stats.NumPages = NumPages;
+    stats.NumSegments = static_cast<uint32>(Segments.size());
+    stats.TotalPageBytes = TotalPageBytes;
+    return stats;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "RHI.h"
+#include <mutex>
+#include <vector>
+
+/**
+ * FTransientConstantRing - Per-frame ring of persistently mapped constant memory
+ * Similar in spirit to UE5's FD3D12FastConstantAllocator / transient uniform buffers
+ *
+ * Backs FRHI::AllocateTransientConstants. Memory is split into segments,
+ * one per frame in flight; each segment is a list of pages created with
+ * FRHI::CreateConstantBuffer and mapped once for their whole lifetime.
+ * Allocate() bumps through the current segment's pages and returns 256-byte
+ * aligned slices; when they are full a new page is added and kept, so the
+ * ring stops growing once it has seen the busiest frame.
+ *
+ * BeginFrame() tags a segment with the new frame number and rewinds it. It
+ * reuses the oldest segment whose frame has completed on the GPU (see
+ * FRHI::GetCompletedFrameFence) and only adds a segment when every one is
+ * still in flight, so the number of segments follows how far the CPU runs
+ * ahead of the GPU instead of a fixed frame count.
+ *
+ * Thread-safe; the mutex is uncontended in practice because one thread
+ * records each frame.
+ */
+class FTransientConstantRing
+{
+public:
+    static constexpr uint32 Alignment = 256;
+    static constexpr uint32 DefaultPageSize = 256 * 1024;
+
+    FTransientConstantRing(FRHI* InRHI, uint32 InPageSize = DefaultPageSize);
+    ~FTransientConstantRing();
+
+    FTransientConstantRing(const FTransientConstantRing&) = delete;
+    FTransientConstantRing& operator=(const FTransientConstantRing&) = delete;
+
+    // Size bytes of write-only CPU memory visible to the GPU at Buffer + Offset, valid for this frame
+    FRHITransientAllocation Allocate(uint32 Size);
+
+    // Start frame Frame: rewind the oldest segment retired by CompletedFrame (or add one) and allocate from it
+    void BeginFrame(uint64 Frame, uint64 CompletedFrame);
+
+    FRHITransientConstantStats GetStats() const;
+
+private:
+    struct FPage
+    {
+        FRHIBuffer* Buffer;
+        uint8* CPUAddress;
+        uint32 Size;
+    };
+
+    struct FFrameSegment
+    {
+        std::vector<FPage> Pages;
+        uint32 CurrentPage = 0;
+        uint32 Cursor = 0;          // Next free byte in Pages[CurrentPage]
+        uint64 BytesAllocated = 0;
+        uint32 NumAllocations = 0;
+        uint64 Frame = 0;           // Last frame that allocated from the segment
+    };
+
+    FRHI* RHI;
+    uint32 PageSize;
+
+    mutable std::mutex Mutex;
+    std::vector<FFrameSegment> Segments;
+    uint32 FrameIndex;
+    uint32 NumPages;
+    uint64 TotalPageBytes;
+    uint64 LastFrameBytes;
+    uint32 LastFrameAllocations;
+};
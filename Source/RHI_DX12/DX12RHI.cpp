@@ -149,15 +149,19 @@ FDX12PipelineState::~FDX12PipelineState()
 // FDX12CommandList implementation
 FDX12CommandList::FDX12CommandList(ID3D12Device* InDevice, ID3D12CommandQueue* InQueue, IDXGISwapChain3* InSwapChain, uint32 Width, uint32 Height)
     : Device(InDevice), CommandQueue(InQueue), SwapChain(InSwapChain), FrameIndex(0), FenceValue(0)
+    , PresentedFrames(0), FrameFenceValues{}
     , bCommandsFlushedFor2D(false), bInShadowPass(false), CurrentShadowMap(nullptr)
     , SavedViewport{}, SavedScissorRect{}
 {
     
-    // Create command allocator
-    ThrowIfFailed(Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&CommandAllocator)));
+    // Create command allocators
+    for (uint32 i = 0; i < FrameCount; i++)
+    {
+        ThrowIfFailed(Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&CommandAllocators[i])));
+    }
     
     // Create command list
-    ThrowIfFailed(Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, CommandAllocator.Get(), nullptr, IID_PPV_ARGS(&GraphicsCommandList)));
+    ThrowIfFailed(Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, CommandAllocators[0].Get(), nullptr, IID_PPV_ARGS(&GraphicsCommandList)));
     ThrowIfFailed(GraphicsCommandList->Close());
     
     // Create RTV descriptor heap
@@ -199,6 +203,7 @@ FDX12CommandList::FDX12CommandList(ID3D12Device* InDevice, ID3D12CommandQueue* I
     // Create synchronization objects
     ThrowIfFailed(Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Fence)));
     FenceValue = 1;
+    ThrowIfFailed(Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&FrameFence)));
     
     FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
     if (FenceEvent == nullptr)
@@ -231,9 +236,12 @@ FDX12CommandList::~FDX12CommandList()
     D3D11DeviceContext.Reset();
     D3D11Device.Reset();
     
-    // Release command list and allocator
+    // Release command list and allocators
     GraphicsCommandList.Reset();
-    CommandAllocator.Reset();
+    for (int i = 0; i < FrameCount; ++i)
+    {
+        CommandAllocators[i].Reset();
+    }
     
     // Release render targets and descriptor heaps
     for (int i = 0; i < FrameCount; ++i)
@@ -246,8 +254,9 @@ FDX12CommandList::~FDX12CommandList()
     DepthStencilBuffer.Reset();
     DSVHeap.Reset();
     
-    // Release fence
+    // Release fences
     Fence.Reset();
+    FrameFence.Reset();
     CloseHandle(FenceEvent);
     
     // Note: Device, CommandQueue, SwapChain are shared with FDX12RHI
@@ -260,8 +269,16 @@ void FDX12CommandList::BeginFrame()
     
     FLog::Log(ELogLevel::Info, std::string("BeginFrame - Frame Index: ") + std::to_string(FrameIndex));
     
-    ThrowIfFailed(CommandAllocator->Reset());
-    ThrowIfFailed(GraphicsCommandList->Reset(CommandAllocator.Get(), nullptr));
+    // The only CPU/GPU sync point: wait for the frame that last rendered to this back buffer,
+    // so the CPU runs at most FrameCount frames ahead
+    if (FrameFence->GetCompletedValue() < FrameFenceValues[FrameIndex])
+    {
+        ThrowIfFailed(FrameFence->SetEventOnCompletion(FrameFenceValues[FrameIndex], FenceEvent));
+        WaitForSingleObjectEx(FenceEvent, INFINITE, FALSE);
+    }
+    
+    ThrowIfFailed(CommandAllocators[FrameIndex]->Reset());
+    ThrowIfFailed(GraphicsCommandList->Reset(CommandAllocators[FrameIndex].Get(), nullptr));
     
     // Set viewport and scissor rect
     GraphicsCommandList->RSSetViewports(1, &Viewport);
@@ -359,11 +376,12 @@ void FDX12CommandList::SetIndexBuffer(FRHIBuffer* IndexBuffer)
     GraphicsCommandList->IASetIndexBuffer(&ibv);
 }
 
-void FDX12CommandList::SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex)
+void FDX12CommandList::SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset)
 {
-    FLog::Log(ELogLevel::Info, std::string("SetConstantBuffer - Root Parameter: ") + std::to_string(RootParameterIndex));
+    FLog::Log(ELogLevel::Info, std::string("SetConstantBuffer - Root Parameter: ") + std::to_string(RootParameterIndex) +
+        ", Offset: " + std::to_string(Offset));
     FDX12Buffer* DX12Buffer = static_cast<FDX12Buffer*>(ConstantBuffer);
-    GraphicsCommandList->SetGraphicsRootConstantBufferView(RootParameterIndex, DX12Buffer->GetGPUVirtualAddress());
+    GraphicsCommandList->SetGraphicsRootConstantBufferView(RootParameterIndex, DX12Buffer->GetGPUVirtualAddress() + Offset);
 }
 
 void FDX12CommandList::DrawPrimitive(uint32 VertexCount, uint32 StartVertex)
@@ -387,6 +405,29 @@ void FDX12CommandList::DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex
     GraphicsCommandList->DrawIndexedInstanced(IndexCount, 1, StartIndex, BaseVertex, 0);
 }
 
+void FDX12CommandList::SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride)
+{
+    FDX12Buffer* DX12Buffer = static_cast<FDX12Buffer*>(InstanceBuffer);
+    
+    // Instance data usually lives in a transient upload page, so the view starts at Offset
+    // and covers the rest of the buffer
+    D3D12_VERTEX_BUFFER_VIEW vbv = {};
+    vbv.BufferLocation = DX12Buffer->GetGPUVirtualAddress() + Offset;
+    vbv.SizeInBytes = static_cast<UINT>(DX12Buffer->GetResource()->GetDesc().Width) - Offset;
+    vbv.StrideInBytes = Stride;
+    GraphicsCommandList->IASetVertexBuffers(1, 1, &vbv);
+}
+
+void FDX12CommandList::DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance)
+{
+    FLog::Log(ELogLevel::Info, std::string("DrawIndexedInstanced - IndexCount: ") + std::to_string(IndexCountPerInstance) + 
+        ", InstanceCount: " + std::to_string(InstanceCount) + ", StartIndex: " + std::to_string(StartIndex) + 
+        ", BaseVertex: " + std::to_string(BaseVertex));
+    
+    GraphicsCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    GraphicsCommandList->DrawIndexedInstanced(IndexCountPerInstance, InstanceCount, StartIndex, BaseVertex, StartInstance);
+}
+
 void FDX12CommandList::DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex)
 {
     FLog::Log(ELogLevel::Info, std::string("DrawIndexedLines - IndexCount: ") + std::to_string(IndexCount) + 
@@ -414,7 +455,12 @@ void FDX12CommandList::Present()
     FLog::Log(ELogLevel::Info, "Presenting frame...");
     // disable vsync
     ThrowIfFailed(SwapChain->Present(0, 0));
-    WaitForGPU();
+    
+    // No wait here - BeginFrame waits on the back buffer's fence value, and released
+    // resources are kept alive by the deferred release queue until the fence passes them
+    ++PresentedFrames;
+    ThrowIfFailed(CommandQueue->Signal(FrameFence.Get(), PresentedFrames));
+    FrameFenceValues[FrameIndex] = PresentedFrames;
     FLog::Log(ELogLevel::Info, "Frame presented");
 }
 
@@ -422,23 +468,19 @@ void FDX12CommandList::FlushCommandsFor2D()
 {
 	try
 	{
-		// Close and execute D3D12 command list
+		// Close and execute D3D12 command list; D3D11On12 submits the 2D work to the same
+		// queue afterwards, so queue order is all the overlay needs
 		ThrowIfFailed(GraphicsCommandList->Close());
 		ID3D12CommandList* ppCommandLists[] = { GraphicsCommandList.Get() };
 		CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 
-		// Wait for D3D12 to finish rendering
-		const UINT64 fenceValueForD2D = FenceValue++;
-		ThrowIfFailed(CommandQueue->Signal(Fence.Get(), fenceValueForD2D));
-		if (Fence->GetCompletedValue() < fenceValueForD2D)
-		{
-			ThrowIfFailed(Fence->SetEventOnCompletion(fenceValueForD2D, FenceEvent));
-			WaitForSingleObjectEx(FenceEvent, INFINITE, FALSE);
-		}
+		// Signal without waiting; WaitForGPU() can still block on it
+		ThrowIfFailed(CommandQueue->Signal(Fence.Get(), FenceValue++));
 
-		// Reset command list for potential additional commands
-		ThrowIfFailed(CommandAllocator->Reset());
-		ThrowIfFailed(GraphicsCommandList->Reset(CommandAllocator.Get(), nullptr));
+		// Keep recording into the same allocator. Resetting the list is legal while its
+		// submitted commands execute; the allocator itself is only reset in BeginFrame,
+		// after the frame fence says its previous frame is done
+		ThrowIfFailed(GraphicsCommandList->Reset(CommandAllocators[FrameIndex].Get(), nullptr));
 
 		// Reset viewport and scissor since we reset the command list
 		GraphicsCommandList->RSSetViewports(1, &Viewport);
@@ -660,6 +702,11 @@ void FDX12CommandList::WaitForGPU()
     }
 }
 
+uint64 FDX12CommandList::GetCompletedFrameFence() const
+{
+    return FrameFence->GetCompletedValue();
+}
+
 void FDX12CommandList::SetRootConstants(uint32 RootParameterIndex, uint32 Num32BitValues, const void* Data, uint32 DestOffset)
 {
     // Set inline root constants directly in the root signature
@@ -684,8 +731,8 @@ void FDX12CommandList::SetShadowMapTexture(FRHITexture* ShadowMap)
     ID3D12DescriptorHeap* heaps[] = { srvHeap };
     GraphicsCommandList->SetDescriptorHeaps(1, heaps);
     
-    // Set the descriptor table for the shadow map (root parameter index 3 for lit shader)
-    GraphicsCommandList->SetGraphicsRootDescriptorTable(3, dx12Texture->GetSRVGPUHandle());
+    // Set the descriptor table for the shadow map (root parameter index 2 for lit shaders)
+    GraphicsCommandList->SetGraphicsRootDescriptorTable(2, dx12Texture->GetSRVGPUHandle());
 }
 
 void FDX12CommandList::SetDiffuseTexture(FRHITexture* DiffuseTexture)
@@ -705,8 +752,8 @@ void FDX12CommandList::SetDiffuseTexture(FRHITexture* DiffuseTexture)
     ID3D12DescriptorHeap* heaps[] = { srvHeap };
     GraphicsCommandList->SetDescriptorHeaps(1, heaps);
     
-    // Set the descriptor table for the diffuse texture (root parameter index 4 for textured shader)
-    GraphicsCommandList->SetGraphicsRootDescriptorTable(4, dx12Texture->GetSRVGPUHandle());
+    // Set the descriptor table for the diffuse texture (root parameter index 3 for textured shader)
+    GraphicsCommandList->SetGraphicsRootDescriptorTable(3, dx12Texture->GetSRVGPUHandle());
 }
 
 void FDX12CommandList::InitializeTextRendering(ID3D12Device* InDevice, IDXGISwapChain3* InSwapChain)
@@ -1028,6 +1075,10 @@ bool FDX12RHI::Initialize(void* WindowHandle, uint32 InWidth, uint32 InHeight)
         // Create command list
         CommandList = std::make_unique<FDX12CommandList>(Device.Get(), CommandQueue.Get(), SwapChain.Get(), Width, Height);
         
+        // Pages are created lazily on the first allocations
+        TransientConstants = std::make_unique<FTransientConstantRing>(this);
+        DeferredReleases = std::make_unique<FDeferredReleaseQueue>();
+        
         FLog::Log(ELogLevel::Info, "DX12 RHI initialized successfully");
         return true;
         
@@ -1041,6 +1092,12 @@ bool FDX12RHI::Initialize(void* WindowHandle, uint32 InWidth, uint32 InHeight)
 
 void FDX12RHI::Shutdown()
 {
+    // Released resources go first, while the device is still alive
+    FlushDeferredReleases();
+    DeferredReleases.reset();
+    
+    // Unmaps and releases the ring pages while the device is still alive
+    TransientConstants.reset();
     CommandList.reset();
     SwapChain.Reset();
     CommandQueue.Reset();
@@ -1142,6 +1199,40 @@ FRHIBuffer* FDX12RHI::CreateConstantBuffer(uint32 Size)
     return new FDX12Buffer(constantBuffer.Detach(), FDX12Buffer::EBufferType::Constant);
 }
 
+FRHITransientAllocation FDX12RHI::AllocateTransientConstants(uint32 Size)
+{
+    return TransientConstants->Allocate(Size);
+}
+
+void FDX12RHI::BeginTransientFrame()
+{
+    uint64 completedFrame = GetCompletedFrameFence();
+    uint64 frame = DeferredReleases->BeginFrame(completedFrame);
+    TransientConstants->BeginFrame(frame, completedFrame);
+}
+
+FRHITransientConstantStats FDX12RHI::GetTransientConstantStats() const
+{
+    return TransientConstants ? TransientConstants->GetStats() : FRHITransientConstantStats();
+}
+
+uint64 FDX12RHI::GetCompletedFrameFence() const
+{
+    return CommandList ? CommandList->GetCompletedFrameFence() : 0;
+}
+
+void FDX12RHI::FlushDeferredReleases()
+{
+    if (CommandList)
+    {
+        CommandList->WaitForIdle();
+    }
+    if (DeferredReleases)
+    {
+        DeferredReleases->Flush();
+    }
+}
+
 FRHITexture* FDX12RHI::CreateDepthTexture(uint32 InWidth, uint32 InHeight, ERTFormat Format, uint32 ArraySize)
 {
     FLog::Log(ELogLevel::Info, "Creating depth texture: " + std::to_string(InWidth) + "x" + 
@@ -1543,12 +1634,13 @@ FRHIPipelineState* FDX12RHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
     bool bEnableShadows = HasFlag(Flags, EPipelineFlags::EnableShadows);
     bool bDepthOnly = HasFlag(Flags, EPipelineFlags::DepthOnly);
     bool bEnableTextures = HasFlag(Flags, EPipelineFlags::EnableTextures);
+    bool bInstanced = HasFlag(Flags, EPipelineFlags::Instanced);
     
     FLog::Log(ELogLevel::Info, std::string("Creating graphics pipeline state Ex (depth: ") + 
         (bEnableDepth ? "on" : "off") + ", lighting: " + (bEnableLighting ? "on" : "off") + 
         ", wireframe: " + (bWireframe ? "on" : "off") + ", lines: " + (bLineTopology ? "on" : "off") + 
         ", shadows: " + (bEnableShadows ? "on" : "off") + ", depth-only: " + (bDepthOnly ? "on" : "off") + 
-        ", textures: " + (bEnableTextures ? "on" : "off") + ")...");
+        ", textures: " + (bEnableTextures ? "on" : "off") + ", instanced: " + (bInstanced ? "on" : "off") + ")...");
     
     // Use shader manager to compile shaders from files
     FShaderManager& shaderManager = FShaderManager::Get();
@@ -1579,8 +1671,9 @@ FRHIPipelineState* FDX12RHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
         FLog::Log(ELogLevel::Info, "Using base pass shader from file: " + shaderFile);
     }
     
-    // Compile vertex and pixel shaders from files
-    vertexShaderBytecode = shaderManager.GetShader(shaderFile, "VSMain", EShaderType::Vertex);
+    // Compile vertex and pixel shaders from files; instanced variants read the world matrix
+    // from the instance stream instead of the per-draw constants
+    vertexShaderBytecode = shaderManager.GetShader(shaderFile, bInstanced ? "VSMainInstanced" : "VSMain", EShaderType::Vertex);
     pixelShaderBytecode = shaderManager.GetShader(shaderFile, "PSMain", EShaderType::Pixel);
     
     if (!vertexShaderBytecode.IsValid())
@@ -1598,7 +1691,7 @@ FRHIPipelineState* FDX12RHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
     FLog::Log(ELogLevel::Info, "Pixel shader compiled successfully from file");
     
     // Create root signature with appropriate number of constant buffers
-    CD3DX12_ROOT_PARAMETER rootParameters[5];
+    CD3DX12_ROOT_PARAMETER rootParameters[4];
     CD3DX12_DESCRIPTOR_RANGE srvRanges[2];  // For shadow map and diffuse texture
     CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
     D3D12_STATIC_SAMPLER_DESC staticSamplers[2] = {};  // Shadow sampler and diffuse sampler
@@ -1606,23 +1699,21 @@ FRHIPipelineState* FDX12RHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
     
     if (bEnableTextures && bEnableLighting)
     {
-        // Five root parameters for textured lit rendering:
-        // 0: CBV for MVP (b0)
-        // 1: CBV for Lighting (b1)
-        // 2: CBV for Shadow (b2)
-        // 3: Descriptor table for shadow map texture (t0)
-        // 4: Descriptor table for diffuse texture (t1)
+        // Four root parameters for textured lit rendering:
+        // 0: CBV for the primitive constants (b0)
+        // 1: CBV for the view constants (b1)
+        // 2: Descriptor table for shadow map texture (t0)
+        // 3: Descriptor table for diffuse texture (t1)
         rootParameters[0].InitAsConstantBufferView(0);
         rootParameters[1].InitAsConstantBufferView(1);
-        rootParameters[2].InitAsConstantBufferView(2);
         
         // Descriptor range for shadow map texture (t0)
         srvRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);  // 1 SRV at t0
-        rootParameters[3].InitAsDescriptorTable(1, &srvRanges[0]);
+        rootParameters[2].InitAsDescriptorTable(1, &srvRanges[0]);
         
         // Descriptor range for diffuse texture (t1)
         srvRanges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 1);  // 1 SRV at t1
-        rootParameters[4].InitAsDescriptorTable(1, &srvRanges[1]);
+        rootParameters[3].InitAsDescriptorTable(1, &srvRanges[1]);
         
         // Shadow map comparison sampler (s0)
         staticSamplers[0].Filter = D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
@@ -1655,23 +1746,21 @@ FRHIPipelineState* FDX12RHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
         staticSamplers[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
         
         numSamplers = 2;
-        rootSignatureDesc.Init(5, rootParameters, numSamplers, staticSamplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+        rootSignatureDesc.Init(4, rootParameters, numSamplers, staticSamplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
         FLog::Log(ELogLevel::Info, "Creating textured lit PSO with shadow and diffuse texture support");
     }
     else if (bEnableLighting)
     {
-        // Four root parameters:
-        // 0: CBV for MVP (b0)
-        // 1: CBV for Lighting (b1)
-        // 2: CBV for Shadow (b2)
-        // 3: Descriptor table for shadow map texture (t0)
+        // Three root parameters:
+        // 0: CBV for the primitive constants (b0)
+        // 1: CBV for the view constants (b1)
+        // 2: Descriptor table for shadow map texture (t0)
         rootParameters[0].InitAsConstantBufferView(0);
         rootParameters[1].InitAsConstantBufferView(1);
-        rootParameters[2].InitAsConstantBufferView(2);
         
         // Descriptor range for shadow map texture (t0)
         srvRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);  // 1 SRV at t0
-        rootParameters[3].InitAsDescriptorTable(1, &srvRanges[0]);
+        rootParameters[2].InitAsDescriptorTable(1, &srvRanges[0]);
         
         // Static sampler for shadow map comparison sampling
         staticSamplers[0].Filter = D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
@@ -1689,7 +1778,7 @@ FRHIPipelineState* FDX12RHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
         staticSamplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
         
         numSamplers = 1;
-        rootSignatureDesc.Init(4, rootParameters, numSamplers, staticSamplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+        rootSignatureDesc.Init(3, rootParameters, numSamplers, staticSamplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
         FLog::Log(ELogLevel::Info, "Creating lit PSO with shadow map sampling support");
     }
     else if (bDepthOnly)
@@ -1750,22 +1839,38 @@ FRHIPipelineState* FDX12RHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
         { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
     };
     
-    // Create PSO
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+    // Per-instance world matrix rows (slot 1), appended to the vertex layout for instanced PSOs
+    D3D12_INPUT_ELEMENT_DESC instanceInputElementDescs[] = 
+    {
+        { "INSTANCE_TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "INSTANCE_TRANSFORM", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "INSTANCE_TRANSFORM", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+        { "INSTANCE_TRANSFORM", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 }
+    };
+    
+    std::vector<D3D12_INPUT_ELEMENT_DESC> inputElementDescs;
     if (bEnableTextures)
     {
         // Textured vertex format (position, normal, texcoord, color)
-        psoDesc.InputLayout = { texturedInputElementDescs, _countof(texturedInputElementDescs) };
+        inputElementDescs.assign(std::begin(texturedInputElementDescs), std::end(texturedInputElementDescs));
     }
     else if (bEnableLighting || bDepthOnly)
     {
         // Depth-only shader uses lit vertex format (position, normal, color)
-        psoDesc.InputLayout = { litInputElementDescs, _countof(litInputElementDescs) };
+        inputElementDescs.assign(std::begin(litInputElementDescs), std::end(litInputElementDescs));
     }
     else
     {
-        psoDesc.InputLayout = { unlitInputElementDescs, _countof(unlitInputElementDescs) };
+        inputElementDescs.assign(std::begin(unlitInputElementDescs), std::end(unlitInputElementDescs));
+    }
+    if (bInstanced)
+    {
+        inputElementDescs.insert(inputElementDescs.end(), std::begin(instanceInputElementDescs), std::end(instanceInputElementDescs));
     }
+    
+    // Create PSO
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.InputLayout = { inputElementDescs.data(), static_cast<UINT>(inputElementDescs.size()) };
     psoDesc.pRootSignature = rootSignature.Get();
     psoDesc.VS = vertexShaderBytecode.GetShaderBytecode();
     psoDesc.PS = pixelShaderBytecode.GetShaderBytecode();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../RHI/RHI.h"
+#include "../RHI/TransientConstantRing.h"
+#include "../RHI/DeferredReleaseQueue.h"
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include <d3d11on12.h>
@@ -119,9 +121,11 @@ public:
     virtual void SetPipelineState(FRHIPipelineState* PipelineState) override;
     virtual void SetVertexBuffer(FRHIBuffer* VertexBuffer, uint32 Offset, uint32 Stride) override;
     virtual void SetIndexBuffer(FRHIBuffer* IndexBuffer) override;
-    virtual void SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex) override;
+    virtual void SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset = 0) override;
     virtual void DrawPrimitive(uint32 VertexCount, uint32 StartVertex) override;
     virtual void DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
+    virtual void SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride) override;
+    virtual void DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance = 0) override;
     virtual void DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
     virtual void SetPrimitiveTopology(bool bLineList = false) override;
     virtual void Present() override;
@@ -152,17 +156,25 @@ public:
     
     void InitializeTextRendering(ID3D12Device* Device, IDXGISwapChain3* SwapChain);
     
+    // Number of presented frames the GPU has finished
+    uint64 GetCompletedFrameFence() const;
+    
+    // Block until the GPU has executed everything submitted so far
+    void WaitForIdle() { WaitForGPU(); }
+    
 private:
     void WaitForGPU();
     void CreateDepthStencilBuffer(uint32 Width, uint32 Height);
     
     ComPtr<ID3D12Device> Device;
     ComPtr<ID3D12CommandQueue> CommandQueue;
-    ComPtr<ID3D12CommandAllocator> CommandAllocator;
     ComPtr<ID3D12GraphicsCommandList> GraphicsCommandList;
     ComPtr<IDXGISwapChain3> SwapChain;
     
     static const uint32 FrameCount = 2;
+    
+    // One allocator per back buffer; reset only once the GPU has finished the frame that used it
+    ComPtr<ID3D12CommandAllocator> CommandAllocators[FrameCount];
     ComPtr<ID3D12Resource> RenderTargets[FrameCount];
     ComPtr<ID3D12DescriptorHeap> RTVHeap;
     uint32 RTVDescriptorSize;
@@ -176,6 +188,11 @@ private:
     uint64 FenceValue;
     void* FenceEvent;
     
+    // Signalled with the presented frame count after every Present
+    ComPtr<ID3D12Fence> FrameFence;
+    uint64 PresentedFrames;
+    uint64 FrameFenceValues[FrameCount];    // Presented frame count that last used each back buffer
+    
     D3D12_VIEWPORT Viewport;
     D3D12_RECT ScissorRect;
     
@@ -218,6 +235,14 @@ public:
     virtual FRHIPipelineState* CreateGraphicsPipelineState(bool bEnableDepth = false) override;
     virtual FRHIPipelineState* CreateGraphicsPipelineStateEx(EPipelineFlags Flags) override;
     
+    virtual FRHITransientAllocation AllocateTransientConstants(uint32 Size) override;
+    virtual void BeginTransientFrame() override;
+    virtual FRHITransientConstantStats GetTransientConstantStats() const override;
+    
+    virtual uint64 GetCompletedFrameFence() const override;
+    virtual FDeferredReleaseQueue* GetDeferredReleaseQueue() const override { return DeferredReleases.get(); }
+    virtual void FlushDeferredReleases() override;
+    
 private:
     ComPtr<IDXGIFactory4> Factory;
     ComPtr<ID3D12Device> Device;
@@ -225,5 +250,11 @@ private:
     ComPtr<IDXGISwapChain3> SwapChain;
     
     std::unique_ptr<FDX12CommandList> CommandList;
+    
+    // Upload-heap pages for per-frame constants, mapped for the lifetime of the RHI
+    std::unique_ptr<FTransientConstantRing> TransientConstants;
+    
+    // Resources released while frames that may use them are still on the GPU
+    std::unique_ptr<FDeferredReleaseQueue> DeferredReleases;
     uint32 Width, Height;
 };
@@ -0,0 +1,612 @@
+#include "NullRHI.h"
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// Constant buffers are aligned like the DX12 backend so sizes match across backends
+static constexpr uint32 ConstantBufferAlignment = 256;
+
+const char* GetNullCommandName(ENullCommand Command)
+{
+    switch (Command)
+    {
+        case ENullCommand::BeginFrame:           return "BeginFrame";
+        case ENullCommand::EndFrame:             return "EndFrame";
+        case ENullCommand::ClearRenderTarget:    return "ClearRenderTarget";
+        case ENullCommand::ClearDepthStencil:    return "ClearDepthStencil";
+        case ENullCommand::SetPipelineState:     return "SetPipelineState";
+        case ENullCommand::SetVertexBuffer:      return "SetVertexBuffer";
+        case ENullCommand::SetIndexBuffer:       return "SetIndexBuffer";
+        case ENullCommand::SetConstantBuffer:    return "SetConstantBuffer";
+        case ENullCommand::DrawPrimitive:        return "DrawPrimitive";
+        case ENullCommand::DrawIndexedPrimitive: return "DrawIndexedPrimitive";
+        case ENullCommand::SetInstanceBuffer:    return "SetInstanceBuffer";
+        case ENullCommand::DrawIndexedInstanced: return "DrawIndexedInstanced";
+        case ENullCommand::DrawIndexedLines:     return "DrawIndexedLines";
+        case ENullCommand::SetPrimitiveTopology: return "SetPrimitiveTopology";
+        case ENullCommand::Present:              return "Present";
+        case ENullCommand::FlushCommandsFor2D:   return "FlushCommandsFor2D";
+        case ENullCommand::RHIDrawText:          return "RHIDrawText";
+        case ENullCommand::DrawDebugTexture:     return "DrawDebugTexture";
+        case ENullCommand::BeginShadowPass:      return "BeginShadowPass";
+        case ENullCommand::EndShadowPass:        return "EndShadowPass";
+        case ENullCommand::SetViewport:          return "SetViewport";
+        case ENullCommand::ClearDepthOnly:       return "ClearDepthOnly";
+        case ENullCommand::BeginEvent:           return "BeginEvent";
+        case ENullCommand::EndEvent:             return "EndEvent";
+        case ENullCommand::SetRootConstants:     return "SetRootConstants";
+        case ENullCommand::SetShadowMapTexture:  return "SetShadowMapTexture";
+        case ENullCommand::SetDiffuseTexture:    return "SetDiffuseTexture";
+        default:                                 return "Unknown";
+    }
+}
+
+// FNullBuffer implementation
+FNullBuffer::FNullBuffer(uint32 InResourceId, EBufferType InType, uint32 InSize, const void* InitialData)
+    : ResourceId(InResourceId)
+    , BufferType(InType)
+    , Data(InSize, 0)
+    , bMapped(false)
+{
+    if (InitialData && InSize > 0)
+    {
+        memcpy(Data.data(), InitialData, InSize);
+    }
+}
+
+FNullBuffer::~FNullBuffer()
+{
+}
+
+void* FNullBuffer::Map()
+{
+    bMapped = true;
+    return Data.data();
+}
+
+void FNullBuffer::Unmap()
+{
+    bMapped = false;
+}
+
+// FNullTexture implementation
+FNullTexture::FNullTexture(uint32 InResourceId, uint32 InWidth, uint32 InHeight, uint32 InArraySize,
+                           ERTFormat InFormat, bool bInColorTexture, const void* InitialData)
+    : ResourceId(InResourceId)
+    , Width(InWidth)
+    , Height(InHeight)
+    , ArraySize(InArraySize)
+    , Format(InFormat)
+    , bColorTexture(bInColorTexture)
+{
+    uint64 sizeInBytes = static_cast<uint64>(Width) * Height * ArraySize * GetBytesPerPixel(Format);
+    Data.resize(static_cast<size_t>(sizeInBytes), 0);
+
+    if (InitialData && sizeInBytes > 0)
+    {
+        memcpy(Data.data(), InitialData, static_cast<size_t>(sizeInBytes));
+    }
+}
+
+FNullTexture::~FNullTexture()
+{
+}
+
+uint32 FNullTexture::GetBytesPerPixel(ERTFormat InFormat)
+{
+    switch (InFormat)
+    {
+        case ERTFormat::R8G8B8A8_UNORM:     return 4;
+        case ERTFormat::R16G16B16A16_FLOAT: return 8;
+        case ERTFormat::R32_FLOAT:          return 4;
+        case ERTFormat::D32_FLOAT:          return 4;
+        case ERTFormat::D16_UNORM:          return 2;
+        case ERTFormat::D24_UNORM_S8_UINT:  return 4;
+        default:                            return 4;
+    }
+}
+
+// FNullPipelineState implementation
+FNullPipelineState::FNullPipelineState(uint32 InResourceId, EPipelineFlags InFlags)
+    : ResourceId(InResourceId)
+    , Flags(InFlags)
+{
+}
+
+FNullPipelineState::~FNullPipelineState()
+{
+}
+
+// FRecordingCommandList implementation
+FRecordingCommandList::FRecordingCommandList(uint32 InWidth, uint32 InHeight)
+    : Width(InWidth)
+    , Height(InHeight)
+    , PresentedFrameCount(0)
+{
+    // A frame of the demo scene records a few tens of KB; reserve up front
+    // so steady-state recording never reallocates
+    CommandStream.reserve(64 * 1024);
+}
+
+FRecordingCommandList::~FRecordingCommandList()
+{
+}
+
+void FRecordingCommandList::Record(ENullCommand Command, const void* Payload, uint32 PayloadSize)
+{
+    uint8* payload = RecordUninitialized(Command, PayloadSize);
+    if (PayloadSize > 0)
+    {
+        memcpy(payload, Payload, PayloadSize);
+    }
+}
+
+uint8* FRecordingCommandList::RecordUninitialized(ENullCommand Command, uint32 PayloadSize)
+{
+    FCommandHeader header;
+    header.Command = Command;
+    header.Reserved = 0;
+    header.PayloadSize = static_cast<uint16>(PayloadSize);
+
+    size_t offset = CommandStream.size();
+    CommandStream.resize(offset + sizeof(FCommandHeader) + PayloadSize);
+    memcpy(CommandStream.data() + offset, &header, sizeof(FCommandHeader));
+
+    Stats.CommandCount++;
+    Stats.CommandCounts[static_cast<uint32>(Command)]++;
+    return CommandStream.data() + offset + sizeof(FCommandHeader);
+}
+
+template<typename... ArgTypes>
+void FRecordingCommandList::RecordValues(ENullCommand Command, const ArgTypes&... Args)
+{
+    // Pack the arguments back to back (no padding) into a small stack buffer
+    uint8 payload[(sizeof(ArgTypes) + ... + 0) + 1];
+    uint32 offset = 0;
+    ((memcpy(payload + offset, &Args, sizeof(ArgTypes)), offset += sizeof(ArgTypes)), ...);
+    Record(Command, payload, offset);
+}
+
+void FRecordingCommandList::RecordString(ENullCommand Command, const std::string& Text, const void* Extra, uint32 ExtraSize)
+{
+    // Payload: extra data, uint16 length, characters (truncated to fit the 16-bit payload size)
+    uint32 maxLength = 0xFFFF - ExtraSize - sizeof(uint16);
+    uint16 length = static_cast<uint16>(std::min<size_t>(Text.size(), maxLength));
+
+    // Written in place - no temporary payload buffer
+    uint8* payload = RecordUninitialized(Command, ExtraSize + sizeof(uint16) + length);
+    if (ExtraSize > 0)
+    {
+        memcpy(payload, Extra, ExtraSize);
+    }
+    memcpy(payload + ExtraSize, &length, sizeof(uint16));
+    memcpy(payload + ExtraSize + sizeof(uint16), Text.data(), length);
+}
+
+uint32 FRecordingCommandList::GetResourceId(FRHIBuffer* Buffer)
+{
+    return Buffer ? static_cast<FNullBuffer*>(Buffer)->GetResourceId() : 0;
+}
+
+uint32 FRecordingCommandList::GetResourceId(FRHITexture* Texture)
+{
+    return Texture ? static_cast<FNullTexture*>(Texture)->GetResourceId() : 0;
+}
+
+uint32 FRecordingCommandList::GetResourceId(FRHIPipelineState* PipelineState)
+{
+    return PipelineState ? static_cast<FNullPipelineState*>(PipelineState)->GetResourceId() : 0;
+}
+
+void FRecordingCommandList::ForEachCommand(const std::function<void(ENullCommand, const uint8*, uint32)>& Callback) const
+{
+    size_t offset = 0;
+    while (offset + sizeof(FCommandHeader) <= CommandStream.size())
+    {
+        FCommandHeader header;
+        memcpy(&header, CommandStream.data() + offset, sizeof(FCommandHeader));
+        offset += sizeof(FCommandHeader);
+
+        Callback(header.Command, CommandStream.data() + offset, header.PayloadSize);
+        offset += header.PayloadSize;
+    }
+}
+
+void FRecordingCommandList::BeginFrame()
+{
+    // Start a fresh stream; capacity is kept so recording stays allocation free
+    CommandStream.clear();
+    Stats.Reset();
+    BoundState = FNullBoundState();
+    BoundState.Viewport[2] = static_cast<float>(Width);
+    BoundState.Viewport[3] = static_cast<float>(Height);
+    BoundState.Viewport[5] = 1.0f;
+
+    Record(ENullCommand::BeginFrame, nullptr, 0);
+}
+
+void FRecordingCommandList::EndFrame()
+{
+    if (BoundState.EventDepth != 0)
+    {
+        FLog::Log(ELogLevel::Warning, "NullRHI: EndFrame with " + std::to_string(BoundState.EventDepth) + " unbalanced BeginEvent(s)");
+    }
+
+    Record(ENullCommand::EndFrame, nullptr, 0);
+}
+
+void FRecordingCommandList::ClearRenderTarget(const FColor& Color)
+{
+    RecordValues(ENullCommand::ClearRenderTarget, Color);
+}
+
+void FRecordingCommandList::ClearDepthStencil()
+{
+    Record(ENullCommand::ClearDepthStencil, nullptr, 0);
+}
+
+void FRecordingCommandList::SetPipelineState(FRHIPipelineState* PipelineState)
+{
+    FNullPipelineState* nullPSO = static_cast<FNullPipelineState*>(PipelineState);
+    if (BoundState.PipelineState != nullPSO)
+    {
+        Stats.PipelineStateChanges++;
+    }
+    BoundState.PipelineState = nullPSO;
+
+    RecordValues(ENullCommand::SetPipelineState, GetResourceId(PipelineState));
+}
+
+void FRecordingCommandList::SetVertexBuffer(FRHIBuffer* VertexBuffer, uint32 Offset, uint32 Stride)
+{
+    BoundState.VertexBuffer = static_cast<FNullBuffer*>(VertexBuffer);
+    BoundState.VertexOffset = Offset;
+    BoundState.VertexStride = Stride;
+
+    RecordValues(ENullCommand::SetVertexBuffer, GetResourceId(VertexBuffer), Offset, Stride);
+}
+
+void FRecordingCommandList::SetIndexBuffer(FRHIBuffer* IndexBuffer)
+{
+    BoundState.IndexBuffer = static_cast<FNullBuffer*>(IndexBuffer);
+
+    RecordValues(ENullCommand::SetIndexBuffer, GetResourceId(IndexBuffer));
+}
+
+void FRecordingCommandList::SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset)
+{
+    if (Offset % ConstantBufferAlignment != 0)
+    {
+        FLog::Log(ELogLevel::Warning, "NullRHI: SetConstantBuffer offset not 256-byte aligned: " + std::to_string(Offset));
+    }
+
+    if (RootParameterIndex < FNullBoundState::MaxRootParameters)
+    {
+        BoundState.ConstantBuffers[RootParameterIndex] = static_cast<FNullBuffer*>(ConstantBuffer);
+        BoundState.ConstantBufferOffsets[RootParameterIndex] = Offset;
+    }
+    else
+    {
+        FLog::Log(ELogLevel::Warning, "NullRHI: SetConstantBuffer root index out of range: " + std::to_string(RootParameterIndex));
+    }
+
+    RecordValues(ENullCommand::SetConstantBuffer, GetResourceId(ConstantBuffer), RootParameterIndex, Offset);
+}
+
+void FRecordingCommandList::DrawPrimitive(uint32 VertexCount, uint32 StartVertex)
+{
+    Stats.DrawCalls++;
+    Stats.VerticesDrawn += VertexCount;
+
+    RecordValues(ENullCommand::DrawPrimitive, VertexCount, StartVertex);
+}
+
+void FRecordingCommandList::DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex)
+{
+    Stats.DrawCalls++;
+    Stats.IndicesDrawn += IndexCount;
+
+    RecordValues(ENullCommand::DrawIndexedPrimitive, IndexCount, StartIndex, BaseVertex);
+}
+
+void FRecordingCommandList::SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride)
+{
+    BoundState.InstanceBuffer = static_cast<FNullBuffer*>(InstanceBuffer);
+    BoundState.InstanceOffset = Offset;
+    BoundState.InstanceStride = Stride;
+
+    RecordValues(ENullCommand::SetInstanceBuffer, GetResourceId(InstanceBuffer), Offset, Stride);
+}
+
+void FRecordingCommandList::DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance)
+{
+    if (BoundState.PipelineState && HasFlag(BoundState.PipelineState->GetFlags(), EPipelineFlags::Instanced) && !BoundState.InstanceBuffer)
+    {
+        FLog::Log(ELogLevel::Warning, "NullRHI: DrawIndexedInstanced with an instanced pipeline state and no instance buffer");
+    }
+
+    Stats.DrawCalls++;
+    Stats.IndicesDrawn += static_cast<uint64>(IndexCountPerInstance) * InstanceCount;
+    Stats.InstancesDrawn += InstanceCount;
+
+    RecordValues(ENullCommand::DrawIndexedInstanced, IndexCountPerInstance, InstanceCount, StartIndex, BaseVertex, StartInstance);
+}
+
+void FRecordingCommandList::DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex)
+{
+    // DX12 backend switches to line list topology for this draw
+    BoundState.bLineList = true;
+    Stats.DrawCalls++;
+    Stats.IndicesDrawn += IndexCount;
+
+    RecordValues(ENullCommand::DrawIndexedLines, IndexCount, StartIndex, BaseVertex);
+}
+
+void FRecordingCommandList::SetPrimitiveTopology(bool bLineList)
+{
+    BoundState.bLineList = bLineList;
+
+    uint8 lineList = bLineList ? 1 : 0;
+    RecordValues(ENullCommand::SetPrimitiveTopology, lineList);
+}
+
+void FRecordingCommandList::Present()
+{
+    Record(ENullCommand::Present, nullptr, 0);
+    PresentedFrameCount++;
+}
+
+void FRecordingCommandList::FlushCommandsFor2D()
+{
+    Record(ENullCommand::FlushCommandsFor2D, nullptr, 0);
+}
+
+void FRecordingCommandList::RHIDrawText(const std::string& Text, const FVector2D& Position, float FontSize, const FColor& Color)
+{
+    struct FTextParams
+    {
+        FVector2D Position;
+        float FontSize;
+        FColor Color;
+    } params = { Position, FontSize, Color };
+
+    RecordString(ENullCommand::RHIDrawText, Text, &params, sizeof(params));
+}
+
+void FRecordingCommandList::DrawDebugTexture(FRHITexture* Texture, float X, float Y, float InWidth, float InHeight)
+{
+    RecordValues(ENullCommand::DrawDebugTexture, GetResourceId(Texture), X, Y, InWidth, InHeight);
+}
+
+void FRecordingCommandList::BeginShadowPass(FRHITexture* ShadowMap, uint32 FaceIndex)
+{
+    if (BoundState.bInShadowPass)
+    {
+        FLog::Log(ELogLevel::Warning, "NullRHI: BeginShadowPass called while already in a shadow pass");
+    }
+
+    BoundState.bInShadowPass = true;
+    BoundState.ShadowPassTarget = static_cast<FNullTexture*>(ShadowMap);
+    BoundState.ShadowPassFace = FaceIndex;
+
+    RecordValues(ENullCommand::BeginShadowPass, GetResourceId(ShadowMap), FaceIndex);
+}
+
+void FRecordingCommandList::EndShadowPass()
+{
+    BoundState.bInShadowPass = false;
+    BoundState.ShadowPassTarget = nullptr;
+    BoundState.ShadowPassFace = 0;
+
+    // Main viewport is restored like the DX12 backend does
+    BoundState.Viewport[0] = 0.0f;
+    BoundState.Viewport[1] = 0.0f;
+    BoundState.Viewport[2] = static_cast<float>(Width);
+    BoundState.Viewport[3] = static_cast<float>(Height);
+    BoundState.Viewport[4] = 0.0f;
+    BoundState.Viewport[5] = 1.0f;
+
+    Record(ENullCommand::EndShadowPass, nullptr, 0);
+}
+
+void FRecordingCommandList::SetViewport(float X, float Y, float InWidth, float InHeight, float MinDepth, float MaxDepth)
+{
+    BoundState.Viewport[0] = X;
+    BoundState.Viewport[1] = Y;
+    BoundState.Viewport[2] = InWidth;
+    BoundState.Viewport[3] = InHeight;
+    BoundState.Viewport[4] = MinDepth;
+    BoundState.Viewport[5] = MaxDepth;
+
+    RecordValues(ENullCommand::SetViewport, X, Y, InWidth, InHeight, MinDepth, MaxDepth);
+}
+
+void FRecordingCommandList::ClearDepthOnly(FRHITexture* DepthTexture, uint32 FaceIndex)
+{
+    RecordValues(ENullCommand::ClearDepthOnly, GetResourceId(DepthTexture), FaceIndex);
+}
+
+void FRecordingCommandList::BeginEvent(const std::string& EventName)
+{
+    BoundState.EventDepth++;
+
+    RecordString(ENullCommand::BeginEvent, EventName, nullptr, 0);
+}
+
+void FRecordingCommandList::EndEvent()
+{
+    if (BoundState.EventDepth == 0)
+    {
+        FLog::Log(ELogLevel::Warning, "NullRHI: EndEvent without matching BeginEvent");
+    }
+    else
+    {
+        BoundState.EventDepth--;
+    }
+
+    Record(ENullCommand::EndEvent, nullptr, 0);
+}
+
+void FRecordingCommandList::SetRootConstants(uint32 RootParameterIndex, uint32 Num32BitValues, const void* Data, uint32 DestOffset)
+{
+    // Payload: root index, value count, dest offset, then the raw 32-bit values
+    uint32 dataSize = Num32BitValues * sizeof(uint32);
+    uint8* payload = RecordUninitialized(ENullCommand::SetRootConstants, 3 * sizeof(uint32) + dataSize);
+    memcpy(payload, &RootParameterIndex, sizeof(uint32));
+    memcpy(payload + 4, &Num32BitValues, sizeof(uint32));
+    memcpy(payload + 8, &DestOffset, sizeof(uint32));
+    if (dataSize > 0)
+    {
+        if (Data)
+        {
+            memcpy(payload + 12, Data, dataSize);
+        }
+        else
+        {
+            memset(payload + 12, 0, dataSize);
+        }
+    }
+}
+
+void FRecordingCommandList::SetShadowMapTexture(FRHITexture* ShadowMap)
+{
+    BoundState.ShadowMapTexture = static_cast<FNullTexture*>(ShadowMap);
+
+    RecordValues(ENullCommand::SetShadowMapTexture, GetResourceId(ShadowMap));
+}
+
+void FRecordingCommandList::SetDiffuseTexture(FRHITexture* DiffuseTexture)
+{
+    BoundState.DiffuseTexture = static_cast<FNullTexture*>(DiffuseTexture);
+
+    RecordValues(ENullCommand::SetDiffuseTexture, GetResourceId(DiffuseTexture));
+}
+
+// FNullRHI implementation
+FNullRHI::FNullRHI()
+    : NextResourceId(1)
+    , PipelineStateCreateDelayMs(0)
+    , Width(0)
+    , Height(0)
+{
+}
+
+FNullRHI::~FNullRHI()
+{
+    Shutdown();
+}
+
+bool FNullRHI::Initialize(void* WindowHandle, uint32 InWidth, uint32 InHeight)
+{
+    // WindowHandle is ignored - there is nothing to present to
+    (void)WindowHandle;
+
+    Width = InWidth;
+    Height = InHeight;
+    CommandList = std::make_unique<FRecordingCommandList>(Width, Height);
+    TransientConstants = std::make_unique<FTransientConstantRing>(this);
+    DeferredReleases = std::make_unique<FDeferredReleaseQueue>();
+
+    FLog::Log(ELogLevel::Info, "Null RHI initialized (" + std::to_string(Width) + "x" + std::to_string(Height) + ")");
+    return true;
+}
+
+void FNullRHI::Shutdown()
+{
+    if (CommandList)
+    {
+        DeferredReleases->Flush();
+        DeferredReleases.reset();
+        TransientConstants.reset();
+        CommandList.reset();
+        FLog::Log(ELogLevel::Info, "Null RHI shutdown");
+    }
+}
+
+FRHICommandList* FNullRHI::GetCommandList()
+{
+    return CommandList.get();
+}
+
+FRHIBuffer* FNullRHI::CreateVertexBuffer(uint32 Size, const void* Data)
+{
+    return new FNullBuffer(NextResourceId++, FNullBuffer::EBufferType::Vertex, Size, Data);
+}
+
+FRHIBuffer* FNullRHI::CreateIndexBuffer(uint32 Size, const void* Data)
+{
+    return new FNullBuffer(NextResourceId++, FNullBuffer::EBufferType::Index, Size, Data);
+}
+
+FRHIBuffer* FNullRHI::CreateConstantBuffer(uint32 Size)
+{
+    uint32 alignedSize = (Size + ConstantBufferAlignment - 1) & ~(ConstantBufferAlignment - 1);
+    return new FNullBuffer(NextResourceId++, FNullBuffer::EBufferType::Constant, alignedSize, nullptr);
+}
+
+FRHITransientAllocation FNullRHI::AllocateTransientConstants(uint32 Size)
+{
+    return TransientConstants->Allocate(Size);
+}
+
+void FNullRHI::BeginTransientFrame()
+{
+    uint64 completedFrame = GetCompletedFrameFence();
+    uint64 frame = DeferredReleases->BeginFrame(completedFrame);
+    TransientConstants->BeginFrame(frame, completedFrame);
+}
+
+FRHITransientConstantStats FNullRHI::GetTransientConstantStats() const
+{
+    return TransientConstants ? TransientConstants->GetStats() : FRHITransientConstantStats();
+}
+
+uint64 FNullRHI::GetCompletedFrameFence() const
+{
+    return CommandList ? CommandList->GetPresentedFrameCount() : 0;
+}
+
+void FNullRHI::FlushDeferredReleases()
+{
+    if (DeferredReleases)
+    {
+        DeferredReleases->Flush();
+    }
+}
+
+FRHITexture* FNullRHI::CreateDepthTexture(uint32 InWidth, uint32 InHeight, ERTFormat Format, uint32 ArraySize)
+{
+    return new FNullTexture(NextResourceId++, InWidth, InHeight, ArraySize, Format, false, nullptr);
+}
+
+FRHITexture* FNullRHI::CreateTexture2D(uint32 InWidth, uint32 InHeight, const void* Data)
+{
+    return new FNullTexture(NextResourceId++, InWidth, InHeight, 1, ERTFormat::R8G8B8A8_UNORM, true, Data);
+}
+
+FRHIPipelineState* FNullRHI::CreateGraphicsPipelineState(bool bEnableDepth)
+{
+    SimulatePipelineStateCreate();
+    return new FNullPipelineState(NextResourceId++, bEnableDepth ? EPipelineFlags::EnableDepth : EPipelineFlags::None);
+}
+
+FRHIPipelineState* FNullRHI::CreateGraphicsPipelineStateEx(EPipelineFlags Flags)
+{
+    SimulatePipelineStateCreate();
+    return new FNullPipelineState(NextResourceId++, Flags);
+}
+
+void FNullRHI::SimulatePipelineStateCreate() const
+{
+    if (PipelineStateCreateDelayMs > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(PipelineStateCreateDelayMs));
+    }
+}
+
+// Factory function
+FRHI* CreateNullRHI()
+{
+    return new FNullRHI();
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+#include "../RHI/RHI.h"
+#include "../RHI/TransientConstantRing.h"
+#include "../RHI/DeferredReleaseQueue.h"
+#include <atomic>
+#include <vector>
+#include <functional>
+
+/**
+ * Null RHI - headless backend for the RHI interface
+ *
+ * Every resource is backed by plain CPU memory and every command is recorded
+ * into a compact binary stream instead of being submitted to a GPU. This lets
+ * FRenderer, FShadowSystem and FRenderScene run on machines without Windows
+ * or a GPU (CI, perf farm, unit tests) while still exercising the same code
+ * paths as the DX12 backend.
+ */
+
+/**
+ * ENullCommand - opcode of a recorded command in the binary stream
+ */
+enum class ENullCommand : uint8
+{
+    BeginFrame,
+    EndFrame,
+    ClearRenderTarget,
+    ClearDepthStencil,
+    SetPipelineState,
+    SetVertexBuffer,
+    SetIndexBuffer,
+    SetConstantBuffer,
+    DrawPrimitive,
+    DrawIndexedPrimitive,
+    SetInstanceBuffer,
+    DrawIndexedInstanced,
+    DrawIndexedLines,
+    SetPrimitiveTopology,
+    Present,
+    FlushCommandsFor2D,
+    RHIDrawText,
+    DrawDebugTexture,
+    BeginShadowPass,
+    EndShadowPass,
+    SetViewport,
+    ClearDepthOnly,
+    BeginEvent,
+    EndEvent,
+    SetRootConstants,
+    SetShadowMapTexture,
+    SetDiffuseTexture,
+
+    Count
+};
+
+// Get a printable name for a recorded command (for dumps and test output)
+const char* GetNullCommandName(ENullCommand Command);
+
+/**
+ * FNullBuffer - CPU-backed buffer
+ * Map() returns a pointer into the owned byte storage.
+ */
+class FNullBuffer : public FRHIBuffer
+{
+public:
+    enum class EBufferType
+    {
+        Vertex,
+        Index,
+        Constant
+    };
+
+    FNullBuffer(uint32 InResourceId, EBufferType InType, uint32 InSize, const void* InitialData);
+    virtual ~FNullBuffer() override;
+
+    virtual void* Map() override;
+    virtual void Unmap() override;
+
+    uint32 GetResourceId() const { return ResourceId; }
+    EBufferType GetBufferType() const { return BufferType; }
+    uint32 GetSize() const { return static_cast<uint32>(Data.size()); }
+    const uint8* GetData() const { return Data.data(); }
+    bool IsMapped() const { return bMapped; }
+
+private:
+    uint32 ResourceId;
+    EBufferType BufferType;
+    std::vector<uint8> Data;
+    bool bMapped;
+};
+
+/**
+ * FNullTexture - CPU-backed texture (depth or RGBA8 color)
+ */
+class FNullTexture : public FRHITexture
+{
+public:
+    FNullTexture(uint32 InResourceId, uint32 InWidth, uint32 InHeight, uint32 InArraySize,
+                 ERTFormat InFormat, bool bInColorTexture, const void* InitialData);
+    virtual ~FNullTexture() override;
+
+    virtual uint32 GetWidth() const override { return Width; }
+    virtual uint32 GetHeight() const override { return Height; }
+    virtual uint32 GetArraySize() const override { return ArraySize; }
+    virtual bool IsColorTexture() const override { return bColorTexture; }
+
+    uint32 GetResourceId() const { return ResourceId; }
+    ERTFormat GetFormat() const { return Format; }
+    uint64 GetSizeInBytes() const { return Data.size(); }
+
+    // Bytes per texel for a given format
+    static uint32 GetBytesPerPixel(ERTFormat InFormat);
+
+private:
+    uint32 ResourceId;
+    uint32 Width;
+    uint32 Height;
+    uint32 ArraySize;
+    ERTFormat Format;
+    bool bColorTexture;
+    std::vector<uint8> Data;
+};
+
+/**
+ * FNullPipelineState - remembers the flags it was created with
+ */
+class FNullPipelineState : public FRHIPipelineState
+{
+public:
+    FNullPipelineState(uint32 InResourceId, EPipelineFlags InFlags);
+    virtual ~FNullPipelineState() override;
+
+    uint32 GetResourceId() const { return ResourceId; }
+    EPipelineFlags GetFlags() const { return Flags; }
+
+private:
+    uint32 ResourceId;
+    EPipelineFlags Flags;
+};
+
+/**
+ * FNullBoundState - state currently bound on the recording command list
+ * Mirrors what the DX12 command list would have set on the GPU.
+ */
+struct FNullBoundState
+{
+    static constexpr uint32 MaxRootParameters = 8;
+
+    FNullPipelineState* PipelineState = nullptr;
+    FNullBuffer* VertexBuffer = nullptr;
+    uint32 VertexOffset = 0;
+    uint32 VertexStride = 0;
+    FNullBuffer* InstanceBuffer = nullptr;
+    uint32 InstanceOffset = 0;
+    uint32 InstanceStride = 0;
+    FNullBuffer* IndexBuffer = nullptr;
+    FNullBuffer* ConstantBuffers[MaxRootParameters] = {};
+    uint32 ConstantBufferOffsets[MaxRootParameters] = {};
+    FNullTexture* ShadowMapTexture = nullptr;
+    FNullTexture* DiffuseTexture = nullptr;
+    FNullTexture* ShadowPassTarget = nullptr;
+    uint32 ShadowPassFace = 0;
+    bool bLineList = false;
+    bool bInShadowPass = false;
+    float Viewport[6] = {};  // X, Y, Width, Height, MinDepth, MaxDepth
+    uint32 EventDepth = 0;
+};
+
+/**
+ * FNullCommandStats - per-frame counters gathered while recording
+ */
+struct FNullCommandStats
+{
+    uint32 CommandCount = 0;
+    uint32 DrawCalls = 0;
+    uint64 IndicesDrawn = 0;
+    uint64 VerticesDrawn = 0;
+    uint64 InstancesDrawn = 0;      // Instances of DrawIndexedInstanced calls; single draws are not counted
+    uint32 PipelineStateChanges = 0;
+    uint32 CommandCounts[static_cast<uint32>(ENullCommand::Count)] = {};
+
+    void Reset() { *this = FNullCommandStats(); }
+    uint32 GetCount(ENullCommand Command) const { return CommandCounts[static_cast<uint32>(Command)]; }
+};
+
+/**
+ * FRecordingCommandList - records commands into a compact binary stream
+ *
+ * Stream layout: each command is a 4-byte header (opcode, reserved, payload size)
+ * followed by its payload. Resources are referenced by their 32-bit resource id,
+ * strings are stored as a length followed by the characters. The stream is
+ * cleared at BeginFrame, so after Present() it holds exactly one frame.
+ */
+class FRecordingCommandList : public FRHICommandList
+{
+public:
+    struct FCommandHeader
+    {
+        ENullCommand Command;
+        uint8 Reserved;
+        uint16 PayloadSize;
+    };
+
+    FRecordingCommandList(uint32 InWidth, uint32 InHeight);
+    virtual ~FRecordingCommandList() override;
+
+    virtual void BeginFrame() override;
+    virtual void EndFrame() override;
+    virtual void ClearRenderTarget(const FColor& Color) override;
+    virtual void ClearDepthStencil() override;
+    virtual void SetPipelineState(FRHIPipelineState* PipelineState) override;
+    virtual void SetVertexBuffer(FRHIBuffer* VertexBuffer, uint32 Offset, uint32 Stride) override;
+    virtual void SetIndexBuffer(FRHIBuffer* IndexBuffer) override;
+    virtual void SetConstantBuffer(FRHIBuffer* ConstantBuffer, uint32 RootParameterIndex, uint32 Offset = 0) override;
+    virtual void DrawPrimitive(uint32 VertexCount, uint32 StartVertex) override;
+    virtual void DrawIndexedPrimitive(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
+    virtual void SetInstanceBuffer(FRHIBuffer* InstanceBuffer, uint32 Offset, uint32 Stride) override;
+    virtual void DrawIndexedInstanced(uint32 IndexCountPerInstance, uint32 InstanceCount, uint32 StartIndex, uint32 BaseVertex, uint32 StartInstance = 0) override;
+    virtual void DrawIndexedLines(uint32 IndexCount, uint32 StartIndex, uint32 BaseVertex) override;
+    virtual void SetPrimitiveTopology(bool bLineList = false) override;
+    virtual void Present() override;
+    virtual void FlushCommandsFor2D() override;
+    virtual void RHIDrawText(const std::string& Text, const FVector2D& Position, float FontSize, const FColor& Color) override;
+    virtual void DrawDebugTexture(FRHITexture* Texture, float X, float Y, float Width, float Height) override;
+    virtual void BeginShadowPass(FRHITexture* ShadowMap, uint32 FaceIndex = 0) override;
+    virtual void EndShadowPass() override;
+    virtual void SetViewport(float X, float Y, float Width, float Height, float MinDepth = 0.0f, float MaxDepth = 1.0f) override;
+    virtual void ClearDepthOnly(FRHITexture* DepthTexture, uint32 FaceIndex = 0) override;
+    virtual void BeginEvent(const std::string& EventName) override;
+    virtual void EndEvent() override;
+    virtual void SetRootConstants(uint32 RootParameterIndex, uint32 Num32BitValues, const void* Data, uint32 DestOffset = 0) override;
+    virtual void SetShadowMapTexture(FRHITexture* ShadowMap) override;
+    virtual void SetDiffuseTexture(FRHITexture* DiffuseTexture) override;
+
+    // Recorded stream of the current (or last presented) frame
+    const std::vector<uint8>& GetCommandStream() const { return CommandStream; }
+
+    // Walk the recorded stream; the callback receives the opcode and its raw payload
+    void ForEachCommand(const std::function<void(ENullCommand, const uint8*, uint32)>& Callback) const;
+
+    const FNullBoundState& GetBoundState() const { return BoundState; }
+    const FNullCommandStats& GetStats() const { return Stats; }
+    uint64 GetPresentedFrameCount() const { return PresentedFrameCount.load(); }
+
+private:
+    // Append a command header plus payload to the stream
+    void Record(ENullCommand Command, const void* Payload, uint32 PayloadSize);
+
+    // Append a command header and reserve its payload; returns the payload start
+    uint8* RecordUninitialized(ENullCommand Command, uint32 PayloadSize);
+
+    // Payload builder helpers
+    template<typename... ArgTypes>
+    void RecordValues(ENullCommand Command, const ArgTypes&... Args);
+
+    void RecordString(ENullCommand Command, const std::string& Text, const void* Extra, uint32 ExtraSize);
+
+    static uint32 GetResourceId(FRHIBuffer* Buffer);
+    static uint32 GetResourceId(FRHITexture* Texture);
+    static uint32 GetResourceId(FRHIPipelineState* PipelineState);
+
+    uint32 Width;
+    uint32 Height;
+
+    std::vector<uint8> CommandStream;
+    FNullBoundState BoundState;
+    FNullCommandStats Stats;
+    std::atomic<uint64> PresentedFrameCount;    // Read by the recording thread as the frame fence
+};
+
+/**
+ * FNullRHI - headless RHI factory
+ * Resource ids are assigned from a monotonically increasing counter; id 0 means null.
+ * Resource creation is thread-safe, as pipeline states are built on task graph workers.
+ */
+class FNullRHI : public FRHI
+{
+public:
+    FNullRHI();
+    virtual ~FNullRHI() override;
+
+    virtual bool Initialize(void* WindowHandle, uint32 Width, uint32 Height) override;
+    virtual void Shutdown() override;
+
+    virtual FRHICommandList* GetCommandList() override;
+
+    virtual FRHIBuffer* CreateVertexBuffer(uint32 Size, const void* Data) override;
+    virtual FRHIBuffer* CreateIndexBuffer(uint32 Size, const void* Data) override;
+    virtual FRHIBuffer* CreateConstantBuffer(uint32 Size) override;
+
+    virtual FRHITexture* CreateDepthTexture(uint32 Width, uint32 Height, ERTFormat Format, uint32 ArraySize = 1) override;
+    virtual FRHITexture* CreateTexture2D(uint32 Width, uint32 Height, const void* Data) override;
+
+    virtual FRHIPipelineState* CreateGraphicsPipelineState(bool bEnableDepth = false) override;
+    virtual FRHIPipelineState* CreateGraphicsPipelineStateEx(EPipelineFlags Flags) override;
+
+    virtual FRHITransientAllocation AllocateTransientConstants(uint32 Size) override;
+    virtual void BeginTransientFrame() override;
+    virtual FRHITransientConstantStats GetTransientConstantStats() const override;
+
+    // There is no GPU: a frame is complete as soon as it has been presented
+    virtual uint64 GetCompletedFrameFence() const override;
+    virtual FDeferredReleaseQueue* GetDeferredReleaseQueue() const override { return DeferredReleases.get(); }
+    virtual void FlushDeferredReleases() override;
+
+    FRecordingCommandList* GetRecordingCommandList() { return CommandList.get(); }
+    uint32 GetCreatedResourceCount() const { return NextResourceId.load() - 1; }
+
+    // Simulated shader compile + PSO build time, so PSO hitches show up in headless runs
+    void SetPipelineStateCreateDelayMs(uint32 DelayMs) { PipelineStateCreateDelayMs = DelayMs; }
+
+private:
+    // Stall for PipelineStateCreateDelayMs
+    void SimulatePipelineStateCreate() const;
+
+    std::unique_ptr<FRecordingCommandList> CommandList;
+    std::unique_ptr<FTransientConstantRing> TransientConstants;
+    std::unique_ptr<FDeferredReleaseQueue> DeferredReleases;
+    std::atomic<uint32> NextResourceId;
+    uint32 PipelineStateCreateDelayMs;
+    uint32 Width;
+    uint32 Height;
+};
@@ -0,0 +1,424 @@
+#include "GeometryBufferAllocator.h"
+#include <algorithm>
+#include <cstring>
+
+// Static instance
+FGeometryBufferAllocator* FGeometryBufferAllocator::GInstance = nullptr;
+
+FGeometryBufferAllocator::FGeometryBufferAllocator(FRHI* InRHI, uint32 InPageSize)
+    : RHI(InRHI)
+    , PageSize(InPageSize)
+    , Generation(0)
+{
+    FLog::Log(ELogLevel::Info, "FGeometryBufferAllocator: Initialized (" + std::to_string(PageSize / 1024) + " KB pages)");
+}
+
+FGeometryBufferAllocator::~FGeometryBufferAllocator()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    uint32 orphaned = 0;
+    for (FPool& pool : Pools)
+    {
+        for (FPage* page : pool.Pages)
+        {
+            // Leave the handles valid so their owners can still free them
+            for (FGeometryAllocation* allocation : page->Allocations)
+            {
+                allocation->Buffer = nullptr;
+                allocation->bDedicated = true;
+                ++orphaned;
+            }
+            page->Buffer->Unmap();
+            delete page->Buffer;
+            delete page;
+        }
+        pool.Pages.clear();
+    }
+    Pools.clear();
+
+    if (orphaned > 0)
+    {
+        FLog::Log(ELogLevel::Warning, "FGeometryBufferAllocator: Destroyed with " + std::to_string(orphaned) + " live allocations");
+    }
+}
+
+FGeometryBufferAllocator* FGeometryBufferAllocator::Get()
+{
+    return GInstance;
+}
+
+void FGeometryBufferAllocator::Initialize(FRHI* InRHI)
+{
+    if (!GInstance && InRHI)
+    {
+        GInstance = new FGeometryBufferAllocator(InRHI);
+    }
+}
+
+void FGeometryBufferAllocator::Shutdown()
+{
+    if (GInstance)
+    {
+        FGeometryBufferStats stats = GInstance->GetStats();
+        FLog::Log(ELogLevel::Info, "FGeometryBufferAllocator: Shutdown (" + std::to_string(stats.NumPages) + " pages, " +
+                  std::to_string(stats.ReservedBytes / 1024) + " KB)");
+
+        // Pending frees reference the allocator
+        GInstance->RHI->FlushDeferredReleases();
+        delete GInstance;
+        GInstance = nullptr;
+    }
+}
+
+FGeometryAllocation* FGeometryBufferAllocator::AllocateVertices(FRHI* InRHI, const void* Data, uint32 NumVertices, uint32 Stride)
+{
+    if (GInstance && GInstance->RHI == InRHI)
+    {
+        return GInstance->Allocate(EGeometryBufferType::Vertex, Data, NumVertices, Stride);
+    }
+    if (!InRHI || NumVertices == 0)
+    {
+        return nullptr;
+    }
+
+    FGeometryAllocation* allocation = new FGeometryAllocation();
+    allocation->Buffer = InRHI->CreateVertexBuffer(NumVertices * Stride, Data);
+    allocation->Count = NumVertices;
+    allocation->Stride = Stride;
+    allocation->bDedicated = true;
+    allocation->RHI = InRHI;
+    return allocation;
+}
+
+FGeometryAllocation* FGeometryBufferAllocator::AllocateIndices(FRHI* InRHI, const uint32* Data, uint32 NumIndices)
+{
+    if (GInstance && GInstance->RHI == InRHI)
+    {
+        return GInstance->Allocate(EGeometryBufferType::Index, Data, NumIndices, sizeof(uint32));
+    }
+    if (!InRHI || NumIndices == 0)
+    {
+        return nullptr;
+    }
+
+    FGeometryAllocation* allocation = new FGeometryAllocation();
+    allocation->Buffer = InRHI->CreateIndexBuffer(NumIndices * sizeof(uint32), Data);
+    allocation->Count = NumIndices;
+    allocation->Stride = sizeof(uint32);
+    allocation->bDedicated = true;
+    allocation->RHI = InRHI;
+    return allocation;
+}
+
+void FGeometryBufferAllocator::FreeGeometry(FGeometryAllocation* Allocation)
+{
+    if (!Allocation)
+    {
+        return;
+    }
+    uint64 sizeInBytes = static_cast<uint64>(Allocation->Count) * Allocation->Stride;
+    if (Allocation->bDedicated)
+    {
+        // Orphaned handles have no buffer left
+        if (Allocation->RHI)
+        {
+            Allocation->RHI->DeferredRelease(Allocation->Buffer, sizeInBytes);
+        }
+        else
+        {
+            delete Allocation->Buffer;
+        }
+        delete Allocation;
+        return;
+    }
+    if (GInstance)
+    {
+        FGeometryBufferAllocator* allocator = GInstance;
+        allocator->RHI->DeferredRelease([allocator, Allocation]() { allocator->Free(Allocation); }, sizeInBytes);
+    }
+}
+
+uint32 FGeometryBufferAllocator::FindOrCreatePool(EGeometryBufferType Type, uint32 Stride)
+{
+    for (uint32 i = 0; i < Pools.size(); ++i)
+    {
+        if (Pools[i].Type == Type && Pools[i].Stride == Stride)
+        {
+            return i;
+        }
+    }
+    Pools.push_back(FPool{ Type, Stride, {} });
+    return static_cast<uint32>(Pools.size() - 1);
+}
+
+uint32 FGeometryBufferAllocator::CreatePage(uint32 PoolIndex, uint32 Count)
+{
+    FPool& pool = Pools[PoolIndex];
+
+    uint32 capacity = PageSize / pool.Stride;
+    bool bOversized = Count > capacity;
+    if (bOversized)
+    {
+        capacity = Count;
+    }
+
+    uint32 sizeInBytes = capacity * pool.Stride;
+    FRHIBuffer* buffer = pool.Type == EGeometryBufferType::Vertex
+        ? RHI->CreateVertexBuffer(sizeInBytes, nullptr)
+        : RHI->CreateIndexBuffer(sizeInBytes, nullptr);
+
+    // Upload-heap memory: mapped once, written directly by Allocate and Defragment
+    pool.Pages.push_back(new FPage(buffer, static_cast<uint8*>(buffer->Map()), capacity, bOversized));
+    return static_cast<uint32>(pool.Pages.size() - 1);
+}
+
+void FGeometryBufferAllocator::RemovePage(uint32 PoolIndex, uint32 PageIndex)
+{
+    FPool& pool = Pools[PoolIndex];
+    FPage* page = pool.Pages[PageIndex];
+    page->Buffer->Unmap();
+    delete page->Buffer;
+    delete page;
+    pool.Pages.erase(pool.Pages.begin() + PageIndex);
+
+    for (uint32 i = PageIndex; i < pool.Pages.size(); ++i)
+    {
+        for (FGeometryAllocation* allocation : pool.Pages[i]->Allocations)
+        {
+            allocation->PageIndex = i;
+        }
+    }
+}
+
+void FGeometryBufferAllocator::PlaceAllocation(FGeometryAllocation* Allocation, uint32 PoolIndex, uint32 PageIndex,
+                                               const FTLSFAllocator::FAllocation& Range)
+{
+    FPage* page = Pools[PoolIndex].Pages[PageIndex];
+    Allocation->Buffer = page->Buffer;
+    Allocation->First = Range.Offset;
+    Allocation->PoolIndex = PoolIndex;
+    Allocation->PageIndex = PageIndex;
+    Allocation->IndexInPage = static_cast<uint32>(page->Allocations.size());
+    Allocation->Range = Range;
+    page->Allocations.push_back(Allocation);
+}
+
+void FGeometryBufferAllocator::RemoveFromPage(FGeometryAllocation* Allocation)
+{
+    std::vector<FGeometryAllocation*>& allocations = Pools[Allocation->PoolIndex].Pages[Allocation->PageIndex]->Allocations;
+    FGeometryAllocation* last = allocations.back();
+    allocations[Allocation->IndexInPage] = last;
+    last->IndexInPage = Allocation->IndexInPage;
+    allocations.pop_back();
+}
+
+FGeometryAllocation* FGeometryBufferAllocator::Allocate(EGeometryBufferType Type, const void* Data, uint32 Count, uint32 Stride)
+{
+    if (Count == 0 || Stride == 0)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    uint32 poolIndex = FindOrCreatePool(Type, Stride);
+    FPool& pool = Pools[poolIndex];
+
+    // First page with a free range large enough, otherwise a new page
+    FTLSFAllocator::FAllocation range;
+    uint32 pageIndex = 0;
+    for (; pageIndex < pool.Pages.size(); ++pageIndex)
+    {
+        range = pool.Pages[pageIndex]->Ranges.Allocate(Count);
+        if (range.IsValid())
+        {
+            break;
+        }
+    }
+    if (!range.IsValid())
+    {
+        pageIndex = CreatePage(poolIndex, Count);
+        range = pool.Pages[pageIndex]->Ranges.Allocate(Count);
+    }
+
+    FGeometryAllocation* allocation = new FGeometryAllocation();
+    allocation->Count = Count;
+    allocation->Stride = Stride;
+    PlaceAllocation(allocation, poolIndex, pageIndex, range);
+
+    if (Data)
+    {
+        memcpy(pool.Pages[pageIndex]->CPUAddress + static_cast<size_t>(range.Offset) * Stride, Data,
+               static_cast<size_t>(Count) * Stride);
+    }
+    return allocation;
+}
+
+void FGeometryBufferAllocator::Free(FGeometryAllocation* Allocation)
+{
+    if (!Allocation)
+    {
+        return;
+    }
+    if (Allocation->bDedicated)
+    {
+        FreeGeometry(Allocation);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    FPage* page = Pools[Allocation->PoolIndex].Pages[Allocation->PageIndex];
+    page->Ranges.Free(Allocation->Range);
+    RemoveFromPage(Allocation);
+
+    // Regular pages stay as capacity; an oversized page only ever holds one mesh
+    if (page->bOversized && page->Allocations.empty())
+    {
+        RemovePage(Allocation->PoolIndex, Allocation->PageIndex);
+    }
+    delete Allocation;
+}
+
+void FGeometryBufferAllocator::MoveAllocation(FGeometryAllocation* Allocation, uint32 NewPageIndex,
+                                              const FTLSFAllocator::FAllocation& NewRange)
+{
+    uint32 poolIndex = Allocation->PoolIndex;
+    FPage* source = Pools[poolIndex].Pages[Allocation->PageIndex];
+    FPage* target = Pools[poolIndex].Pages[NewPageIndex];
+
+    memmove(target->CPUAddress + static_cast<size_t>(NewRange.Offset) * Allocation->Stride,
+            source->CPUAddress + static_cast<size_t>(Allocation->First) * Allocation->Stride,
+            static_cast<size_t>(Allocation->Count) * Allocation->Stride);
+
+    RemoveFromPage(Allocation);
+    PlaceAllocation(Allocation, poolIndex, NewPageIndex, NewRange);
+}
+
+void FGeometryBufferAllocator::CompactPage(uint32 PoolIndex, uint32 PageIndex, FGeometryDefragmentStats& Stats)
+{
+    FPage* page = Pools[PoolIndex].Pages[PageIndex];
+
+    // Re-allocating in address order from an empty allocator packs ranges from offset 0,
+    // so every range moves down (or stays) and the copies never overwrite unmoved data
+    std::vector<FGeometryAllocation*> sorted = page->Allocations;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const FGeometryAllocation* A, const FGeometryAllocation* B) { return A->First < B->First; });
+
+    page->Ranges.Reset();
+    for (FGeometryAllocation* allocation : sorted)
+    {
+        FTLSFAllocator::FAllocation range = page->Ranges.Allocate(allocation->Count);
+        if (range.Offset != allocation->First)
+        {
+            memmove(page->CPUAddress + static_cast<size_t>(range.Offset) * allocation->Stride,
+                    page->CPUAddress + static_cast<size_t>(allocation->First) * allocation->Stride,
+                    static_cast<size_t>(allocation->Count) * allocation->Stride);
+            allocation->First = range.Offset;
+            ++Stats.MovedAllocations;
+            Stats.MovedBytes += static_cast<uint64>(allocation->Count) * allocation->Stride;
+        }
+        allocation->Range = range;
+    }
+}
+
+FGeometryDefragmentStats FGeometryBufferAllocator::Defragment()
+{
+    // Pages are rewritten in place, and pending frees are free space to compact away
+    RHI->FlushDeferredReleases();
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    FGeometryDefragmentStats stats;
+    for (uint32 poolIndex = 0; poolIndex < Pools.size(); ++poolIndex)
+    {
+        FPool& pool = Pools[poolIndex];
+
+        // 1. Pack each page so its free space is one range at the end
+        for (uint32 pageIndex = 0; pageIndex < pool.Pages.size(); ++pageIndex)
+        {
+            CompactPage(poolIndex, pageIndex, stats);
+        }
+
+        // 2. Empty later pages into earlier ones, largest ranges first
+        for (uint32 pageIndex = static_cast<uint32>(pool.Pages.size()); pageIndex-- > 1;)
+        {
+            if (pool.Pages[pageIndex]->bOversized)
+            {
+                continue;
+            }
+            std::vector<FGeometryAllocation*> candidates = pool.Pages[pageIndex]->Allocations;
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const FGeometryAllocation* A, const FGeometryAllocation* B) { return A->Count > B->Count; });
+
+            for (FGeometryAllocation* allocation : candidates)
+            {
+                for (uint32 targetIndex = 0; targetIndex < pageIndex; ++targetIndex)
+                {
+                    FPage* target = pool.Pages[targetIndex];
+                    if (target->bOversized)
+                    {
+                        continue;
+                    }
+                    FTLSFAllocator::FAllocation range = target->Ranges.Allocate(allocation->Count);
+                    if (range.IsValid())
+                    {
+                        pool.Pages[pageIndex]->Ranges.Free(allocation->Range);
+                        MoveAllocation(allocation, targetIndex, range);
+                        ++stats.MovedAllocations;
+                        stats.MovedBytes += static_cast<uint64>(allocation->Count) * allocation->Stride;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // 3. Release emptied pages (keeping one so the next mesh does not recreate it)
+        for (uint32 pageIndex = static_cast<uint32>(pool.Pages.size()); pageIndex-- > 0;)
+        {
+            if (pool.Pages[pageIndex]->Allocations.empty() && pool.Pages.size() > 1)
+            {
+                RemovePage(poolIndex, pageIndex);
+                ++stats.ReleasedPages;
+            }
+        }
+
+        // 4. Close the holes left in pages that gave ranges away
+        for (uint32 pageIndex = 0; pageIndex < pool.Pages.size(); ++pageIndex)
+        {
+            CompactPage(poolIndex, pageIndex, stats);
+        }
+    }
+
+    // Draws that copied the old Buffer / First must be rebuilt
+    if (stats.MovedAllocations > 0 || stats.ReleasedPages > 0)
+    {
+        Generation.fetch_add(1, std::memory_order_release);
+    }
+
+    FLog::Log(ELogLevel::Info, "FGeometryBufferAllocator: Defragmented - moved " + std::to_string(stats.MovedAllocations) +
+              " ranges (" + std::to_string(stats.MovedBytes / 1024) + " KB), released " +
+              std::to_string(stats.ReleasedPages) + " pages");
+    return stats;
+}
+
+FGeometryBufferStats FGeometryBufferAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    FGeometryBufferStats stats;
+    for (const FPool& pool : Pools)
+    {
+        for (const FPage* page : pool.Pages)
+        {
+            ++stats.NumPages;
+            stats.NumAllocations += page->Ranges.GetNumAllocations();
+            stats.ReservedBytes += static_cast<uint64>(page->Ranges.GetCapacity()) * pool.Stride;
+            stats.UsedBytes += static_cast<uint64>(page->Ranges.GetUsedSize()) * pool.Stride;
+            stats.LargestFreeBytes = std::max<uint64>(stats.LargestFreeBytes,
+                static_cast<uint64>(page->Ranges.GetLargestFreeBlock()) * pool.Stride);
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include "../Core/TLSFAllocator.h"
+#include "../RHI/RHI.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/**
+ * EGeometryBufferType - What a geometry allocation holds
+ */
+enum class EGeometryBufferType : uint8
+{
+    Vertex,
+    Index,      // 32-bit indices
+};
+
+/**
+ * FGeometryAllocation - A range of vertices or indices inside a shared buffer
+ * Draw with Buffer bound and First as BaseVertex / StartIndex / StartVertex.
+ * Owned by the allocator that returned it; Buffer and First change when the
+ * allocator defragments, so read them when recording the draw.
+ */
+struct FGeometryAllocation
+{
+    FRHIBuffer* Buffer = nullptr;
+    uint32 First = 0;       // First vertex / index within Buffer
+    uint32 Count = 0;
+    uint32 Stride = 0;      // Bytes per element
+
+    // Allocator bookkeeping
+    uint32 PoolIndex = 0;
+    uint32 PageIndex = 0;
+    uint32 IndexInPage = 0;
+    FTLSFAllocator::FAllocation Range;
+    bool bDedicated = false;    // Own buffer, created because no allocator existed
+    FRHI* RHI = nullptr;        // Creator of a dedicated Buffer, which releases it
+};
+
+/**
+ * FGeometryBufferStats - Statistics for the geometry buffer allocator
+ */
+struct FGeometryBufferStats
+{
+    uint32 NumPages;            // Shared vertex / index buffers
+    uint32 NumAllocations;
+    uint64 ReservedBytes;       // Size of all pages
+    uint64 UsedBytes;           // Bytes covered by live allocations
+    uint64 LargestFreeBytes;    // Largest single free range in any page
+
+    FGeometryBufferStats()
+        : NumPages(0)
+        , NumAllocations(0)
+        , ReservedBytes(0)
+        , UsedBytes(0)
+        , LargestFreeBytes(0)
+    {
+    }
+};
+
+/**
+ * FGeometryDefragmentStats - What one Defragment() call did
+ */
+struct FGeometryDefragmentStats
+{
+    uint32 MovedAllocations = 0;
+    uint64 MovedBytes = 0;
+    uint32 ReleasedPages = 0;
+};
+
+/**
+ * FGeometryBufferAllocator - Vertex and index ranges carved out of a few large buffers
+ * Similar in spirit to UE5's FGlobalDynamicVertexBuffer / D3D12 pooled buffer allocators
+ *
+ * Instead of one RHI buffer per mesh, geometry lives in PageSize pages: one
+ * set of pages per vertex stride and one for indices. Each page is created
+ * once with FRHI::CreateVertexBuffer / CreateIndexBuffer, mapped for its
+ * whole lifetime and divided with an FTLSFAllocator counting elements, so a
+ * range's offset is directly the BaseVertex / StartIndex to draw with.
+ * Meshes larger than a page get an oversized page of their own, released
+ * when they are freed.
+ *
+ * FreeGeometry() hands the range back through FRHI::DeferredRelease, so it
+ * is only reused once every frame that may draw from it has completed on the
+ * GPU. Free() returns a range immediately.
+ *
+ * Defragment() compacts every page, moves ranges from later pages into free
+ * space in earlier ones and releases pages left empty. It copies geometry on
+ * the CPU through the mapped pages and rewrites Buffer / First of the moved
+ * allocations. It waits for the GPU and lands pending frees first, but frames
+ * recorded and not yet replayed must be flushed by the caller
+ * (FlushRenderingCommands). Anything holding on to Buffer / First must fetch
+ * them again once GetGeneration() changes; FRenderScene rebuilds its cached
+ * mesh draw commands when it sees a new generation.
+ *
+ * Allocate and Free are thread-safe: proxies are created on the game thread
+ * and destroyed on the render thread. Allocations still alive when the
+ * allocator is destroyed are orphaned (Buffer becomes nullptr) and
+ * FreeGeometry then only deletes the handle.
+ */
+class FGeometryBufferAllocator
+{
+public:
+    static constexpr uint32 DefaultPageSize = 4 * 1024 * 1024;
+
+    FGeometryBufferAllocator(FRHI* InRHI, uint32 InPageSize = DefaultPageSize);
+    ~FGeometryBufferAllocator();
+
+    FGeometryBufferAllocator(const FGeometryBufferAllocator&) = delete;
+    FGeometryBufferAllocator& operator=(const FGeometryBufferAllocator&) = delete;
+
+    // Singleton access (created by FRenderer::Initialize)
+    static FGeometryBufferAllocator* Get();
+    static void Initialize(FRHI* InRHI);
+    static void Shutdown();
+
+    // Sub-allocated when the global allocator belongs to InRHI, otherwise a dedicated buffer
+    static FGeometryAllocation* AllocateVertices(FRHI* InRHI, const void* Data, uint32 NumVertices, uint32 Stride);
+    static FGeometryAllocation* AllocateIndices(FRHI* InRHI, const uint32* Data, uint32 NumIndices);
+    // Release once no frame in flight can draw from the allocation
+    static void FreeGeometry(FGeometryAllocation* Allocation);
+
+    // Count elements of Stride bytes, initialized from Data if not null; nullptr if Count is 0
+    FGeometryAllocation* Allocate(EGeometryBufferType Type, const void* Data, uint32 Count, uint32 Stride);
+
+    // Return the range right away - the GPU must no longer read it
+    void Free(FGeometryAllocation* Allocation);
+
+    // Pack live ranges into as few pages as possible (see class comment for when this is safe)
+    FGeometryDefragmentStats Defragment();
+
+    // Bumped by every Defragment() that moved a range or released a page
+    uint32 GetGeneration() const { return Generation.load(std::memory_order_acquire); }
+
+    FRHI* GetRHI() const { return RHI; }
+    uint32 GetPageSize() const { return PageSize; }
+
+    // Statistics (computed under the lock)
+    FGeometryBufferStats GetStats() const;
+
+private:
+    struct FPage
+    {
+        FRHIBuffer* Buffer;
+        uint8* CPUAddress;
+        FTLSFAllocator Ranges;      // In elements of the pool's stride
+        std::vector<FGeometryAllocation*> Allocations;
+        bool bOversized;
+
+        FPage(FRHIBuffer* InBuffer, uint8* InCPUAddress, uint32 InCapacity, bool bInOversized)
+            : Buffer(InBuffer)
+            , CPUAddress(InCPUAddress)
+            , Ranges(InCapacity)
+            , bOversized(bInOversized)
+        {
+        }
+    };
+
+    struct FPool
+    {
+        EGeometryBufferType Type;
+        uint32 Stride;
+        std::vector<FPage*> Pages;
+    };
+
+    // Pool for a buffer type and stride, created on first use (Mutex held)
+    uint32 FindOrCreatePool(EGeometryBufferType Type, uint32 Stride);
+
+    // New page with room for at least Count elements (Mutex held)
+    uint32 CreatePage(uint32 PoolIndex, uint32 Count);
+
+    // Destroy a page and renumber the pages after it (Mutex held)
+    void RemovePage(uint32 PoolIndex, uint32 PageIndex);
+
+    // Record Allocation as living in Range of the given page (Mutex held)
+    void PlaceAllocation(FGeometryAllocation* Allocation, uint32 PoolIndex, uint32 PageIndex,
+                         const FTLSFAllocator::FAllocation& Range);
+    void RemoveFromPage(FGeometryAllocation* Allocation);
+
+    // Move Allocation to NewRange in page NewPageIndex, copying its elements (Mutex held)
+    void MoveAllocation(FGeometryAllocation* Allocation, uint32 NewPageIndex, const FTLSFAllocator::FAllocation& NewRange);
+
+    // Compact one page so its live ranges are packed from offset 0 (Mutex held)
+    void CompactPage(uint32 PoolIndex, uint32 PageIndex, FGeometryDefragmentStats& Stats);
+
+    FRHI* RHI;
+    uint32 PageSize;
+
+    mutable std::mutex Mutex;
+    std::vector<FPool> Pools;
+    std::atomic<uint32> Generation;
+
+    static FGeometryBufferAllocator* GInstance;
+};
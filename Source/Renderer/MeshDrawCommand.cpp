@@ -0,0 +1,406 @@
+#include "MeshDrawCommand.h"
+#include "Renderer.h"
+#include "Camera.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <utility>
+
+void FMeshDrawContext::InitBasePass(FRHI* InRHI, const FCamera* Camera, const FLightScene* LightScene, const FShadowSystem* ShadowSystem)
+{
+    RHI = InRHI;
+    ShadowMapTexture = ShadowSystem ? ShadowSystem->GetDirectionalShadowMap() : nullptr;
+    ViewUniforms.Clear();
+    
+    if (Camera)
+    {
+        ViewProjection = Camera->GetViewProjectionMatrix();
+        ViewUniforms.SetCameraPosition(Camera->GetPosition());
+    }
+    
+    if (LightScene)
+    {
+        ViewUniforms.SetAmbientLight(LightScene->GetAmbientLight());
+        
+        // First directional light lights the scene, up to 4 point lights
+        TFrameVector<FDirectionalLight*> dirLights;
+        LightScene->GetDirectionalLights(dirLights);
+        ViewUniforms.SetDirectionalLight(dirLights.empty() ? nullptr : dirLights[0]);
+        
+        TFrameVector<FPointLight*> pointLights;
+        LightScene->GetPointLights(pointLights);
+        for (int i = 0; i < 4; ++i)
+        {
+            ViewUniforms.SetPointLight(i, i < static_cast<int>(pointLights.size()) ? pointLights[i] : nullptr);
+        }
+    }
+    
+    // Receivers sample the shadow map with the matrix it was rendered with
+    FMatrix4x4 dirLightViewProj;
+    bool bDirShadows = ShadowMapTexture && ShadowSystem->GetDirectionalShadowMatrix(dirLightViewProj);
+    ViewUniforms.SetDirectionalShadow(bDirShadows ? &dirLightViewProj : nullptr);
+    
+    ViewUniformBuffer = RHI ? RHI->UploadTransientConstants(&ViewUniforms, sizeof(FViewUniformParameters)) : FRHITransientAllocation();
+}
+
+void FMeshDrawCommand::SetRootConstants(const void* Data, uint32 Num32BitValues)
+{
+    NumRootConstants = Num32BitValues < MaxRootConstants ? Num32BitValues : MaxRootConstants;
+    memcpy(RootConstants, Data, NumRootConstants * sizeof(float));
+}
+
+uint64 FMeshDrawCommand::HashInstancingData(uint64 Hash, const void* Data, uint32 Size)
+{
+    const uint8* bytes = static_cast<const uint8*>(Data);
+    for (uint32 i = 0; i < Size; ++i)
+    {
+        Hash = (Hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return Hash;
+}
+
+void FMeshDrawCommand::Submit(FRHICommandList* RHICmdList, FRHIPipelineState* DefaultPipelineState) const
+{
+    // Same order the proxies bound in: root signature first, then root parameters, then geometry
+    FRHIPipelineState* pipelineState = PipelineState ? PipelineState : DefaultPipelineState;
+    if (pipelineState)
+    {
+        RHICmdList->SetPipelineState(pipelineState);
+    }
+    for (uint32 i = 0; i < MaxConstantBuffers; ++i)
+    {
+        if (ConstantBuffers[i].Buffer)
+        {
+            RHICmdList->SetConstantBuffer(ConstantBuffers[i].Buffer, i, ConstantBuffers[i].Offset);
+        }
+    }
+    if (NumRootConstants > 0)
+    {
+        RHICmdList->SetRootConstants(0, NumRootConstants, RootConstants, 0);
+    }
+    if (ShadowMapTexture)
+    {
+        RHICmdList->SetShadowMapTexture(ShadowMapTexture);
+    }
+    if (DiffuseTexture)
+    {
+        RHICmdList->SetDiffuseTexture(DiffuseTexture);
+    }
+    if (VertexBuffer)
+    {
+        RHICmdList->SetVertexBuffer(VertexBuffer, 0, VertexStride);
+    }
+    if (IndexBuffer)
+    {
+        RHICmdList->SetIndexBuffer(IndexBuffer);
+    }
+
+    if (IsInstanced())
+    {
+        RHICmdList->SetInstanceBuffer(InstanceBuffer.Buffer, InstanceBuffer.Offset, sizeof(FMatrix4x4));
+        RHICmdList->DrawIndexedInstanced(NumElements, NumDrawnInstances, FirstElement, BaseVertex);
+        return;
+    }
+
+    switch (DrawType)
+    {
+        case EMeshDrawType::Indexed:
+            RHICmdList->DrawIndexedPrimitive(NumElements, FirstElement, BaseVertex);
+            break;
+        case EMeshDrawType::IndexedLines:
+            RHICmdList->DrawIndexedLines(NumElements, FirstElement, BaseVertex);
+            break;
+        case EMeshDrawType::NonIndexed:
+            RHICmdList->DrawPrimitive(NumElements, FirstElement);
+            break;
+    }
+}
+
+void FMeshDrawCommandList::FSortIdMap::Reset()
+{
+    std::fill(Keys.begin(), Keys.end(), nullptr);
+    NumIds = 0;
+}
+
+uint16 FMeshDrawCommandList::FSortIdMap::FindOrAdd(const void* Key)
+{
+    // Unbound sorts first
+    if (!Key)
+    {
+        return 0;
+    }
+
+    // Keep the table at most half full
+    if ((NumIds + 1) * 2 > Keys.size())
+    {
+        std::vector<const void*> oldKeys;
+        std::vector<uint16> oldIds;
+        oldKeys.swap(Keys);
+        oldIds.swap(Ids);
+
+        size_t capacity = oldKeys.empty() ? 64 : oldKeys.size() * 2;
+        Keys.assign(capacity, nullptr);
+        Ids.assign(capacity, 0);
+        for (size_t i = 0; i < oldKeys.size(); ++i)
+        {
+            if (oldKeys[i])
+            {
+                size_t slot = (reinterpret_cast<uintptr_t>(oldKeys[i]) >> 4) & (capacity - 1);
+                while (Keys[slot])
+                {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+                Keys[slot] = oldKeys[i];
+                Ids[slot] = oldIds[i];
+            }
+        }
+    }
+
+    size_t mask = Keys.size() - 1;
+    size_t slot = (reinterpret_cast<uintptr_t>(Key) >> 4) & mask;
+    while (Keys[slot])
+    {
+        if (Keys[slot] == Key)
+        {
+            return Ids[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    // Past 65535 distinct objects the rest share the last id: still sorted, just grouped less
+    ++NumIds;
+    Keys[slot] = Key;
+    Ids[slot] = static_cast<uint16>(NumIds < 0xFFFF ? NumIds : 0xFFFF);
+    return Ids[slot];
+}
+
+FMeshDrawCommandList::FMeshDrawCommandList()
+    : NumInstancedDraws(0)
+    , bSorted(false)
+{
+}
+
+void FMeshDrawCommandList::Reset()
+{
+    Commands.clear();
+    SortEntries.clear();
+    PipelineStateIds.Reset();
+    TextureIds.Reset();
+    VertexBufferIds.Reset();
+    IndexBufferIds.Reset();
+    InstanceProxies.clear();
+    InstancePrimitiveIndices.clear();
+    NumInstancedDraws = 0;
+    bSorted = false;
+}
+
+void FMeshDrawCommandList::AddCommand(const FMeshDrawCommand& Command)
+{
+    Commands.push_back(Command);
+    FMeshDrawCommand& command = Commands.back();
+    command.SortKey = (static_cast<uint64>(PipelineStateIds.FindOrAdd(command.PipelineState)) << 48)
+                    | (static_cast<uint64>(TextureIds.FindOrAdd(command.DiffuseTexture)) << 32)
+                    | (static_cast<uint64>(VertexBufferIds.FindOrAdd(command.VertexBuffer)) << 16)
+                    | static_cast<uint64>(IndexBufferIds.FindOrAdd(command.IndexBuffer));
+    bSorted = false;
+}
+
+void FMeshDrawCommandList::SetPrimitiveIndex(uint32 FirstCommand, uint32 PrimitiveIndex)
+{
+    for (uint32 i = FirstCommand; i < Num(); ++i)
+    {
+        Commands[i].PrimitiveIndex = PrimitiveIndex;
+    }
+}
+
+void FMeshDrawCommandList::MergeInstancedCommands(uint32 MinInstances)
+{
+    MinInstances = MinInstances > 2 ? MinInstances : 2;
+
+    // Commands of each instancing group, in the order they were added
+    std::map<std::pair<uint64, const void*>, std::vector<uint32>> groups;
+    for (uint32 i = 0; i < Num(); ++i)
+    {
+        const FMeshDrawCommand& command = Commands[i];
+        if (command.InstancedPipelineState)
+        {
+            groups[std::make_pair(command.InstancingKey, static_cast<const void*>(command.InstancedPipelineState))].push_back(i);
+        }
+    }
+
+    // A large enough group is drawn where its first command was added; the others fold into it
+    std::vector<const std::vector<uint32>*> instancedGroups(Num(), nullptr);
+    std::vector<uint8> folded(Num(), 0);
+    bool bAnyMerged = false;
+    for (const auto& group : groups)
+    {
+        const std::vector<uint32>& members = group.second;
+        if (members.size() < MinInstances)
+        {
+            continue;
+        }
+        instancedGroups[members[0]] = &members;
+        for (size_t member = 1; member < members.size(); ++member)
+        {
+            folded[members[member]] = 1;
+        }
+        bAnyMerged = true;
+    }
+    if (!bAnyMerged)
+    {
+        return;
+    }
+
+    // Re-add what is left so the sort keys only see the remaining commands
+    std::vector<FMeshDrawCommand> commands;
+    commands.swap(Commands);
+    Reset();
+    for (uint32 i = 0; i < static_cast<uint32>(commands.size()); ++i)
+    {
+        if (folded[i])
+        {
+            continue;
+        }
+        FMeshDrawCommand& command = commands[i];
+        if (const std::vector<uint32>* members = instancedGroups[i])
+        {
+            command.PipelineState = command.InstancedPipelineState;
+            command.FirstInstance = static_cast<uint32>(InstanceProxies.size());
+            command.NumInstances = static_cast<uint32>(members->size());
+            for (uint32 member : *members)
+            {
+                InstanceProxies.push_back(commands[member].Proxy);
+                InstancePrimitiveIndices.push_back(commands[member].PrimitiveIndex);
+            }
+            command.PrimitiveIndex = FMeshDrawCommand::NoPrimitiveIndex;  // Culled per instance
+            ++NumInstancedDraws;
+        }
+        AddCommand(command);
+    }
+}
+
+void FMeshDrawCommandList::UploadInstanceData(FRHI* RHI, const uint8* Visibility)
+{
+    if (NumInstancedDraws == 0)
+    {
+        return;
+    }
+
+    for (FMeshDrawCommand& command : Commands)
+    {
+        if (!command.IsInstanced())
+        {
+            continue;
+        }
+
+        uint32 numVisible = command.NumInstances;
+        if (Visibility)
+        {
+            numVisible = 0;
+            for (uint32 i = 0; i < command.NumInstances; ++i)
+            {
+                uint32 primitiveIndex = InstancePrimitiveIndices[command.FirstInstance + i];
+                numVisible += (primitiveIndex == FMeshDrawCommand::NoPrimitiveIndex || Visibility[primitiveIndex]) ? 1 : 0;
+            }
+        }
+        command.NumDrawnInstances = numVisible;
+        if (numVisible == 0)
+        {
+            command.InstanceBuffer = FRHITransientAllocation();
+            continue;
+        }
+
+        // Visible instances packed in instance order
+        command.InstanceBuffer = RHI->AllocateTransientConstants(numVisible * sizeof(FMatrix4x4));
+        FMatrix4x4* transforms = static_cast<FMatrix4x4*>(command.InstanceBuffer.CPUAddress);
+        uint32 numWritten = 0;
+        for (uint32 i = 0; i < command.NumInstances; ++i)
+        {
+            uint32 primitiveIndex = InstancePrimitiveIndices[command.FirstInstance + i];
+            if (!Visibility || primitiveIndex == FMeshDrawCommand::NoPrimitiveIndex || Visibility[primitiveIndex])
+            {
+                transforms[numWritten++] = InstanceProxies[command.FirstInstance + i]->GetModelMatrix();
+            }
+        }
+    }
+}
+
+void FMeshDrawCommandList::Sort()
+{
+    uint32 numCommands = Num();
+    SortEntries.resize(numCommands);
+    SortScratch.resize(numCommands);
+
+    uint64 differingBits = 0;
+    for (uint32 i = 0; i < numCommands; ++i)
+    {
+        SortEntries[i] = { Commands[i].SortKey, i };
+        differingBits |= Commands[i].SortKey ^ Commands[0].SortKey;
+    }
+
+    // LSD radix sort, one byte per pass; each pass is stable, so equal keys keep their order
+    for (uint32 shift = 0; shift < 64; shift += 8)
+    {
+        if (((differingBits >> shift) & 0xFF) == 0)
+        {
+            continue;
+        }
+
+        uint32 offsets[256] = {};
+        for (const FSortEntry& entry : SortEntries)
+        {
+            ++offsets[(entry.Key >> shift) & 0xFF];
+        }
+        uint32 total = 0;
+        for (uint32& offset : offsets)
+        {
+            uint32 count = offset;
+            offset = total;
+            total += count;
+        }
+        for (const FSortEntry& entry : SortEntries)
+        {
+            SortScratch[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+        }
+        SortEntries.swap(SortScratch);
+    }
+
+    bSorted = true;
+}
+
+void FMeshDrawCommandList::Submit(FRHICommandList* RHICmdList) const
+{
+    for (uint32 i = 0; i < Num(); ++i)
+    {
+        GetCommand(i).Submit(RHICmdList);
+    }
+}
+
+uint32 FMeshDrawCommandList::UpdateAndSubmit(EMeshPass Pass, const FMeshDrawContext& Context, FRHICommandList* RHICmdList,
+                                             const uint8* Visibility)
+{
+    uint32 numSubmitted = 0;
+    for (uint32 i = 0; i < Num(); ++i)
+    {
+        FMeshDrawCommand& command = GetCommand(i);
+        if (Visibility)
+        {
+            bool bCulled = command.IsInstanced()
+                ? command.NumDrawnInstances == 0
+                : command.PrimitiveIndex != FMeshDrawCommand::NoPrimitiveIndex && !Visibility[command.PrimitiveIndex];
+            if (bCulled)
+            {
+                continue;
+            }
+        }
+        if (command.Proxy)
+        {
+            command.Proxy->UpdateMeshDrawCommand(Pass, command, Context);
+        }
+        command.Submit(RHICmdList, Context.PassPipelineState);
+        ++numSubmitted;
+    }
+    return numSubmitted;
+}
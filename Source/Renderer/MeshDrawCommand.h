@@ -0,0 +1,227 @@
+#pragma once
+
+#include "../RHI/RHI.h"
+#include "../Lighting/LightingConstants.h"
+#include <vector>
+
+class FSceneProxy;
+class FCamera;
+class FLightScene;
+class FShadowSystem;
+
+// Passes that keep cached mesh draw commands
+enum class EMeshPass : uint8
+{
+    BasePass,       // Main scene color pass
+    ShadowDepth,    // Depth-only shadow views (directional map, point light atlas faces)
+    Num
+};
+
+/**
+ * FMeshDrawContext - Per-frame values every cached draw of a pass is patched with
+ * Filled once per pass and frame, so proxies only add their own transform and material.
+ * The base pass's view constants are uploaded here once, and every lit draw binds them
+ */
+struct FMeshDrawContext
+{
+    FRHI* RHI = nullptr;                    // Source of the frame's transient constants
+    FMatrix4x4 ViewProjection;              // Camera, or the shadow view's light view-projection
+    FRHIPipelineState* PassPipelineState = nullptr;  // Bound for commands without their own, if set
+
+    // Base pass only
+    FViewUniformParameters ViewUniforms;    // Camera, lights and the directional shadow matrix
+    FRHITransientAllocation ViewUniformBuffer;  // ViewUniforms in this frame's transient memory (b1 of lit draws)
+    FRHITexture* ShadowMapTexture = nullptr;
+
+    // Camera, lights and shadow map for the base pass, uploaded as the view constants. A null
+    // light scene leaves the default lighting, a null shadow system no directional shadows
+    void InitBasePass(FRHI* InRHI, const FCamera* Camera, const FLightScene* LightScene, const FShadowSystem* ShadowSystem);
+};
+
+// How an FMeshDrawCommand draws its geometry
+enum class EMeshDrawType : uint8
+{
+    Indexed,        // DrawIndexedPrimitive
+    IndexedLines,   // DrawIndexedLines
+    NonIndexed      // DrawPrimitive
+};
+
+/**
+ * FMeshDrawCommand - Everything one draw binds, plus its draw arguments
+ * Similar in spirit to UE5's FMeshDrawCommand
+ *
+ * Scene proxies fill these in instead of issuing RHI calls, so a pass can
+ * sort all of its draws by state before submitting them. The render scene
+ * caches them per pass: the state that only changes with the proxy's mesh,
+ * material or shader is built once, and every frame Proxy patches the rest
+ * (transient constant slices, root constants) through
+ * FSceneProxy::UpdateMeshDrawCommand. Root constants (the shadow passes'
+ * light-space MVP) are copied into the command. Null bindings are not set
+ * on submit and keep whatever the pass bound before.
+ *
+ * Commands that set InstancedPipelineState can be drawn as instances:
+ * FMeshDrawCommandList::MergeInstancedCommands folds commands with equal
+ * InstancingKey and InstancedPipelineState into one command that draws
+ * NumInstances copies of the first command's mesh with the instanced PSO,
+ * one world matrix per instance in InstanceBuffer. Proxy is then the first
+ * instance's proxy, and patches the state the instances share (its view
+ * constants hold the view-projection instead of the MVP).
+ *
+ * Culling: PrimitiveIndex ties a command to an entry of the visibility a
+ * pass is submitted with, and culled commands are skipped without being
+ * patched. An instanced draw writes only its visible instances and draws
+ * NumDrawnInstances of them.
+ */
+struct FMeshDrawCommand
+{
+    static constexpr uint32 MaxConstantBuffers = 2;
+    static constexpr uint32 MaxRootConstants = 16;
+    static constexpr uint32 NoPrimitiveIndex = 0xFFFFFFFFu;
+
+    FRHIPipelineState* PipelineState = nullptr;
+    FRHIBuffer* VertexBuffer = nullptr;
+    uint32 VertexStride = 0;
+    FRHIBuffer* IndexBuffer = nullptr;
+    FRHITransientAllocation ConstantBuffers[MaxConstantBuffers];  // Root parameter i; unbound if Buffer is null
+    FRHITexture* ShadowMapTexture = nullptr;
+    FRHITexture* DiffuseTexture = nullptr;
+
+    // 32-bit values for root parameter 0, set after the constant buffers
+    uint32 NumRootConstants = 0;
+    float RootConstants[MaxRootConstants];
+
+    EMeshDrawType DrawType = EMeshDrawType::Indexed;
+    uint32 NumElements = 0;     // Index count (vertex count for NonIndexed)
+    uint32 FirstElement = 0;    // Start index (start vertex for NonIndexed)
+    uint32 BaseVertex = 0;
+
+    // Patched every frame before submission; null for commands with no per-frame data
+    FSceneProxy* Proxy = nullptr;
+
+    // Set by the render scene: the proxy's entry in the pass's visibility (NoPrimitiveIndex = never culled)
+    uint32 PrimitiveIndex = NoPrimitiveIndex;
+
+    // Instancing; a null InstancedPipelineState keeps the command out of instanced draws
+    FRHIPipelineState* InstancedPipelineState = nullptr;  // PipelineState's Instanced variant
+    uint64 InstancingKey = 0;               // Mesh and material the instances must share
+    uint32 FirstInstance = 0;               // Into the list's instance proxies
+    uint32 NumInstances = 1;                // More than one: drawn with DrawIndexedInstanced
+    uint32 NumDrawnInstances = 0;           // Visible ones, written to InstanceBuffer this frame
+    FRHITransientAllocation InstanceBuffer; // World matrix per drawn instance, written every frame
+
+    // Filled by FMeshDrawCommandList::AddCommand
+    uint64 SortKey = 0;
+
+    void SetRootConstants(const void* Data, uint32 Num32BitValues);
+
+    bool IsInstanced() const { return NumInstances > 1; }
+
+    // FNV-1a over Size bytes of Data, continuing from Hash; for building InstancingKey
+    static uint64 HashInstancingData(uint64 Hash, const void* Data, uint32 Size);
+    static constexpr uint64 InstancingHashSeed = 14695981039346656037ull;
+
+    // Bind this command's state on RHICmdList and draw; DefaultPipelineState stands in for a null PipelineState
+    void Submit(FRHICommandList* RHICmdList, FRHIPipelineState* DefaultPipelineState = nullptr) const;
+};
+
+/**
+ * FMeshDrawCommandList - The draws of one pass, sorted by state before submission
+ *
+ * AddCommand gives every command a 64-bit sort key made of small per-pass
+ * ids, from the most to the least expensive state to change:
+ *   [63..48] pipeline state  [47..32] diffuse texture  [31..16] vertex buffer  [15..0] index buffer
+ * Ids are handed out in first-seen order, so draws with equal state keep
+ * their submission order. Sort() is a stable LSD radix sort over the keys
+ * that skips the byte positions no command differs in.
+ *
+ * Storage is kept across Reset(), so a list that is rebuilt stops
+ * allocating once it has seen its largest pass.
+ *
+ * Instanced draws keep the proxies of their instances in the list, in
+ * instance order; UploadInstanceData writes their world matrices into
+ * transient memory ahead of the views that submit them: once per frame when
+ * every view draws every instance, once per view when views cull them.
+ *
+ * Visibility, where given, has one entry per primitive index (non-zero =
+ * visible); commands and instances of culled primitives are left out.
+ */
+class FMeshDrawCommandList
+{
+public:
+    FMeshDrawCommandList();
+
+    // Start over; commands without a pipeline state draw with the one the pass has set
+    void Reset();
+
+    void AddCommand(const FMeshDrawCommand& Command);
+
+    // Give the commands added since FirstCommand (a Num() taken before adding them) PrimitiveIndex
+    void SetPrimitiveIndex(uint32 FirstCommand, uint32 PrimitiveIndex);
+
+    // Fold commands that share an InstancingKey and instanced PSO into one instanced draw per
+    // group of at least MinInstances; call after adding every command, before Sort()
+    void MergeInstancedCommands(uint32 MinInstances = 2);
+
+    // Write every instanced draw's world matrices into this frame's transient memory; with
+    // Visibility, only those of visible instances
+    void UploadInstanceData(FRHI* RHI, const uint8* Visibility = nullptr);
+
+    // Order commands by sort key; without it Submit keeps the order they were added in
+    void Sort();
+
+    // Submit every command in order; the redundant binds between neighbours are left to
+    // the command list (FRHIStateCache drops them)
+    void Submit(FRHICommandList* RHICmdList) const;
+
+    // Patch each command's per-frame data through its proxy, then submit it, in order; with
+    // Visibility, culled commands and instanced draws with no visible instance are skipped.
+    // Returns the number of commands submitted
+    uint32 UpdateAndSubmit(EMeshPass Pass, const FMeshDrawContext& Context, FRHICommandList* RHICmdList,
+                         const uint8* Visibility = nullptr);
+
+    uint32 Num() const { return static_cast<uint32>(Commands.size()); }
+    bool IsSorted() const { return bSorted; }
+
+    // Instanced draws in the list and the instances they draw
+    uint32 GetNumInstancedDraws() const { return NumInstancedDraws; }
+    uint32 GetNumInstances() const { return static_cast<uint32>(InstanceProxies.size()); }
+
+    // Command at Index in submission order
+    const FMeshDrawCommand& GetCommand(uint32 Index) const { return Commands[bSorted ? SortEntries[Index].Index : Index]; }
+    FMeshDrawCommand& GetCommand(uint32 Index) { return Commands[bSorted ? SortEntries[Index].Index : Index]; }
+
+private:
+    // Pointer to per-pass id, open addressing over a table reused across passes
+    class FSortIdMap
+    {
+    public:
+        void Reset();
+        uint16 FindOrAdd(const void* Key);
+
+    private:
+        std::vector<const void*> Keys;
+        std::vector<uint16> Ids;
+        uint32 NumIds = 0;
+    };
+
+    struct FSortEntry
+    {
+        uint64 Key;
+        uint32 Index;
+    };
+
+    std::vector<FMeshDrawCommand> Commands;
+    std::vector<FSortEntry> SortEntries;    // Submission order once sorted
+    std::vector<FSortEntry> SortScratch;
+
+    std::vector<FSceneProxy*> InstanceProxies;  // Instances of every instanced draw
+    std::vector<uint32> InstancePrimitiveIndices;
+    uint32 NumInstancedDraws;
+
+    FSortIdMap PipelineStateIds;
+    FSortIdMap TextureIds;
+    FSortIdMap VertexBufferIds;
+    FSortIdMap IndexBufferIds;
+
+    bool bSorted;
+};
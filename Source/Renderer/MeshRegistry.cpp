@@ -0,0 +1,233 @@
+#include "MeshRegistry.h"
+#include <cstring>
+
+// Static instance
+FMeshRegistry* FMeshRegistry::GInstance = nullptr;
+
+uint64 FMeshKey::GetHash() const
+{
+    uint32 values[3] = { static_cast<uint32>(Generator), ParamA, ParamB };
+    uint64 hash = HashBytes(values, sizeof(values));
+    hash = HashBytes(&ContentHash, sizeof(ContentHash), hash);
+    return hash != 0 ? hash : 1;
+}
+
+uint64 FMeshKey::HashBytes(const void* Data, size_t Size, uint64 Hash)
+{
+    const uint8* bytes = static_cast<const uint8*>(Data);
+    for (size_t i = 0; i < Size; ++i)
+    {
+        Hash = (Hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return Hash;
+}
+
+uint64 FSharedMesh::GetSizeBytes() const
+{
+    uint64 bytes = 0;
+    if (Vertices)
+    {
+        bytes += static_cast<uint64>(Vertices->Count) * Vertices->Stride;
+    }
+    if (Indices)
+    {
+        bytes += static_cast<uint64>(Indices->Count) * Indices->Stride;
+    }
+    return bytes;
+}
+
+FMeshRegistry::FMeshRegistry(FRHI* InRHI)
+    : RHI(InRHI)
+{
+    FLog::Log(ELogLevel::Info, "FMeshRegistry: Initialized");
+}
+
+FMeshRegistry::~FMeshRegistry()
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    // Proxies still holding a mesh free it with their last ReleaseMesh
+    if (!Meshes.empty())
+    {
+        FLog::Log(ELogLevel::Warning, "FMeshRegistry: Destroying with " + std::to_string(Meshes.size()) +
+                  " meshes still referenced (" + std::to_string(Stats.References) + " references)");
+    }
+    for (auto& entry : Meshes)
+    {
+        entry.second->Registry = nullptr;
+    }
+    Meshes.clear();
+}
+
+FMeshRegistry* FMeshRegistry::Get()
+{
+    return GInstance;
+}
+
+void FMeshRegistry::Initialize(FRHI* InRHI)
+{
+    if (!GInstance && InRHI)
+    {
+        GInstance = new FMeshRegistry(InRHI);
+    }
+}
+
+void FMeshRegistry::Shutdown()
+{
+    if (GInstance)
+    {
+        FMeshRegistryStats stats = GInstance->GetStats();
+        FLog::Log(ELogLevel::Info, "FMeshRegistry: Shutdown (" + std::to_string(stats.Hits) + " hits, " +
+                  std::to_string(stats.Misses) + " misses)");
+        delete GInstance;
+        GInstance = nullptr;
+    }
+}
+
+FSharedMesh* FMeshRegistry::AcquireMesh(FRHI* InRHI, const FMeshKey& Key, const FMeshBuildFunction& Build)
+{
+    if (GInstance && GInstance->RHI == InRHI)
+    {
+        return GInstance->Acquire(Key, Build);
+    }
+    return BuildMesh(InRHI, Key, Build);
+}
+
+void FMeshRegistry::ReleaseMesh(FSharedMesh* Mesh)
+{
+    if (!Mesh)
+    {
+        return;
+    }
+    if (Mesh->Registry)
+    {
+        Mesh->Registry->Release(Mesh);
+    }
+    else if (--Mesh->RefCount == 0)
+    {
+        // Built without a registry, or orphaned by its destruction
+        DestroyMesh(Mesh);
+    }
+}
+
+FSharedMesh* FMeshRegistry::Acquire(const FMeshKey& Key, const FMeshBuildFunction& Build)
+{
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        auto it = Meshes.find(Key);
+        if (it != Meshes.end())
+        {
+            FSharedMesh* mesh = it->second;
+            ++mesh->RefCount;
+            ++Stats.Hits;
+            ++Stats.References;
+            Stats.ReferencedBytes += mesh->GetSizeBytes();
+            return mesh;
+        }
+    }
+
+    // Generate and upload without the lock, so releases on the render thread do not wait for it
+    FSharedMesh* built = BuildMesh(RHI, Key, Build);
+    if (!built)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    auto result = Meshes.emplace(Key, built);
+    FSharedMesh* mesh = result.first->second;
+    if (result.second)
+    {
+        mesh->Registry = this;
+        ++Stats.Misses;
+        ++Stats.LiveMeshes;
+        ++Stats.References;
+        Stats.LiveBytes += mesh->GetSizeBytes();
+        Stats.ReferencedBytes += mesh->GetSizeBytes();
+        return mesh;
+    }
+
+    // Another thread built the same mesh first; nothing has drawn from our copy
+    DestroyMesh(built);
+    ++mesh->RefCount;
+    ++Stats.Hits;
+    ++Stats.References;
+    Stats.ReferencedBytes += mesh->GetSizeBytes();
+    return mesh;
+}
+
+bool FMeshRegistry::Release(FSharedMesh* Mesh)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (!Mesh || Mesh->Registry != this)
+    {
+        return false;
+    }
+
+    --Stats.References;
+    Stats.ReferencedBytes -= Mesh->GetSizeBytes();
+    if (--Mesh->RefCount == 0)
+    {
+        --Stats.LiveMeshes;
+        Stats.LiveBytes -= Mesh->GetSizeBytes();
+        Meshes.erase(Mesh->Key);
+        DestroyMesh(Mesh);
+    }
+    return true;
+}
+
+FMeshRegistryStats FMeshRegistry::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Stats;
+}
+
+uint32 FMeshRegistry::GetNumLiveMeshes() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Stats.LiveMeshes;
+}
+
+FSharedMesh* FMeshRegistry::BuildMesh(FRHI* InRHI, const FMeshKey& Key, const FMeshBuildFunction& Build)
+{
+    FMeshBuildData data;
+    if (Build)
+    {
+        Build(data);
+    }
+    if (data.GetNumVertices() == 0 || data.Indices.empty())
+    {
+        FLog::Log(ELogLevel::Error, "FMeshRegistry: Mesh build produced no geometry");
+        return nullptr;
+    }
+
+    FSharedMesh* mesh = new FSharedMesh();
+    mesh->Key = Key;
+    mesh->Hash = Key.GetHash();
+    mesh->Bounds = FBoxSphereBounds::FromPoints(data.VertexData.data(), data.GetNumVertices(), data.VertexStride);
+    if (data.Indices.size() / 3 <= FSharedMesh::MaxOccluderTriangles)
+    {
+        mesh->Occluder.Positions.resize(data.GetNumVertices());
+        for (uint32 i = 0; i < data.GetNumVertices(); ++i)
+        {
+            memcpy(&mesh->Occluder.Positions[i], data.VertexData.data() + static_cast<size_t>(i) * data.VertexStride, sizeof(FVector));
+        }
+        mesh->Occluder.Indices = data.Indices;
+    }
+    mesh->Vertices = FGeometryBufferAllocator::AllocateVertices(InRHI, data.VertexData.data(), data.GetNumVertices(), data.VertexStride);
+    mesh->Indices = FGeometryBufferAllocator::AllocateIndices(InRHI, data.Indices.data(), static_cast<uint32>(data.Indices.size()));
+    mesh->RefCount = 1;
+    if (!mesh->Vertices || !mesh->Indices)
+    {
+        DestroyMesh(mesh);
+        return nullptr;
+    }
+    return mesh;
+}
+
+void FMeshRegistry::DestroyMesh(FSharedMesh* Mesh)
+{
+    FGeometryBufferAllocator::FreeGeometry(Mesh->Vertices);
+    FGeometryBufferAllocator::FreeGeometry(Mesh->Indices);
+    delete Mesh;
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include "../Core/Bounds.h"
+#include "../Core/MaskedOcclusionBuffer.h"
+#include "../RHI/RHI.h"
+#include "GeometryBufferAllocator.h"
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * EMeshGenerator - What built a mesh: a procedural generator, or geometry loaded from a file
+ */
+enum class EMeshGenerator : uint32
+{
+    None = 0,
+    LitCube,        // FLitVertex
+    LitSphere,      // Segments, rings
+    LitPlane,       // Subdivisions
+    LitCylinder,    // Segments
+    UnlitCube,      // FVertex in one color
+    UnlitSphere,    // Segments, rings; FVertex in one color
+    Imported,       // Loaded geometry, identified by its content hash
+};
+
+/**
+ * FMeshKey - Everything the geometry of a mesh depends on
+ * Equal keys build identical vertices and indices, so their meshes can be shared.
+ */
+struct FMeshKey
+{
+    EMeshGenerator Generator;
+    uint32 ParamA;          // Segments / subdivisions
+    uint32 ParamB;          // Rings
+    uint64 ContentHash;     // Vertex color of one-color meshes, content of imported geometry
+
+    FMeshKey()
+        : Generator(EMeshGenerator::None)
+        , ParamA(0)
+        , ParamB(0)
+        , ContentHash(0)
+    {
+    }
+
+    explicit FMeshKey(EMeshGenerator InGenerator, uint32 InParamA = 0, uint32 InParamB = 0, uint64 InContentHash = 0)
+        : Generator(InGenerator)
+        , ParamA(InParamA)
+        , ParamB(InParamB)
+        , ContentHash(InContentHash)
+    {
+    }
+
+    bool operator==(const FMeshKey& Other) const
+    {
+        return Generator == Other.Generator && ParamA == Other.ParamA && ParamB == Other.ParamB &&
+               ContentHash == Other.ContentHash;
+    }
+
+    // 64-bit hash of the key; never 0, so it can serve as FSceneProxy's mesh key
+    uint64 GetHash() const;
+
+    // FNV-1a over Size bytes of Data, continuing from Hash; for ContentHash
+    static constexpr uint64 HashSeed = 14695981039346656037ull;
+    static uint64 HashBytes(const void* Data, size_t Size, uint64 Hash = HashSeed);
+};
+
+// Hash function for FMeshKey
+struct FMeshKeyHash
+{
+    size_t operator()(const FMeshKey& Key) const
+    {
+        return static_cast<size_t>(Key.GetHash());
+    }
+};
+
+/**
+ * FMeshBuildData - Vertices and indices a generator fills in on a registry miss
+ */
+struct FMeshBuildData
+{
+    std::vector<uint8> VertexData;      // Each vertex starts with its FVector position
+    uint32 VertexStride = 0;
+    std::vector<uint32> Indices;
+
+    template <typename TVertex>
+    void SetVertices(const std::vector<TVertex>& Vertices)
+    {
+        const uint8* bytes = reinterpret_cast<const uint8*>(Vertices.data());
+        VertexData.assign(bytes, bytes + Vertices.size() * sizeof(TVertex));
+        VertexStride = sizeof(TVertex);
+    }
+
+    uint32 GetNumVertices() const { return VertexStride ? static_cast<uint32>(VertexData.size() / VertexStride) : 0; }
+};
+
+using FMeshBuildFunction = std::function<void(FMeshBuildData&)>;
+
+class FMeshRegistry;
+
+/**
+ * FSharedMesh - Geometry ranges shared by every proxy drawing the same mesh
+ * Returned by FMeshRegistry::AcquireMesh; read the ranges when recording a
+ * draw, since defragmenting the geometry buffers moves them.
+ */
+struct FSharedMesh
+{
+    FMeshKey Key;
+    uint64 Hash = 0;                            // Key.GetHash()
+    FGeometryAllocation* Vertices = nullptr;    // Range in a shared vertex buffer
+    FGeometryAllocation* Indices = nullptr;     // Range in a shared index buffer
+    FBoxSphereBounds Bounds;                    // Mesh space, from the vertex positions
+    FOccluderMesh Occluder;                     // CPU copy of the triangles; empty past MaxOccluderTriangles
+
+    // Meshes with more triangles are too costly to rasterize as occluders
+    static constexpr uint32 MaxOccluderTriangles = 4096;
+
+    uint32 GetNumVertices() const { return Vertices ? Vertices->Count : 0; }
+    uint32 GetNumIndices() const { return Indices ? Indices->Count : 0; }
+    uint64 GetSizeBytes() const;
+
+private:
+    friend class FMeshRegistry;
+
+    FMeshRegistry* Registry = nullptr;  // Null when not shared: no registry when built, or destroyed since
+    uint32 RefCount = 0;
+};
+
+/**
+ * FMeshRegistryStats - Statistics for the mesh registry
+ */
+struct FMeshRegistryStats
+{
+    uint64 Hits;                // Acquires served by an existing mesh
+    uint64 Misses;              // Acquires that generated and uploaded a mesh
+    uint32 LiveMeshes;          // Meshes held by at least one user
+    uint32 References;          // Outstanding acquires across all live meshes
+    uint64 LiveBytes;           // Vertex and index bytes of the live meshes
+    uint64 ReferencedBytes;     // What the references would take with a copy each
+
+    FMeshRegistryStats()
+        : Hits(0)
+        , Misses(0)
+        , LiveMeshes(0)
+        , References(0)
+        , LiveBytes(0)
+        , ReferencedBytes(0)
+    {
+    }
+};
+
+/**
+ * FMeshRegistry - Shared, reference-counted mesh geometry
+ * Similar in spirit to UE5's static mesh render data, shared by every
+ * component that uses the asset
+ *
+ * Meshes are content-addressed by FMeshKey: the generator and its
+ * parameters, or the hash of imported geometry. Acquire() returns the mesh
+ * for a key and adds a reference; only the first acquire runs the build
+ * function and uploads its geometry through FGeometryBufferAllocator. Every
+ * Acquire() must be matched by a Release(), and the geometry ranges are
+ * freed (deferred until the GPU is done with them) with the last reference.
+ *
+ * Thread-safe: proxies are created on the game thread and may be destroyed
+ * on the render thread. The build runs outside the lock; if two threads
+ * build the same key at once, the second copy is dropped.
+ *
+ * Callers that may run without a renderer (unit tests building scenes
+ * directly) use the static AcquireMesh / ReleaseMesh helpers, which build
+ * an unshared mesh when no registry exists for the RHI. Meshes still held
+ * when the registry is destroyed become unshared and are freed by their
+ * last ReleaseMesh.
+ */
+class FMeshRegistry
+{
+public:
+    FMeshRegistry(FRHI* InRHI);
+    ~FMeshRegistry();
+
+    FMeshRegistry(const FMeshRegistry&) = delete;
+    FMeshRegistry& operator=(const FMeshRegistry&) = delete;
+
+    // Singleton access (created by FRenderer::Initialize)
+    static FMeshRegistry* Get();
+    static void Initialize(FRHI* InRHI);
+    static void Shutdown();
+
+    // Shared when the global registry belongs to InRHI, otherwise built for the caller alone
+    static FSharedMesh* AcquireMesh(FRHI* InRHI, const FMeshKey& Key, const FMeshBuildFunction& Build);
+    static void ReleaseMesh(FSharedMesh* Mesh);
+
+    // Shared mesh for Key with one more reference, built on a miss; nullptr if Build made no geometry
+    FSharedMesh* Acquire(const FMeshKey& Key, const FMeshBuildFunction& Build);
+
+    // Drop one reference; false if Mesh is not shared through this registry
+    bool Release(FSharedMesh* Mesh);
+
+    FRHI* GetRHI() const { return RHI; }
+
+    // Statistics (copied under the lock)
+    FMeshRegistryStats GetStats() const;
+    uint32 GetNumLiveMeshes() const;
+
+private:
+    // Run Build and upload its geometry; the mesh starts with one reference
+    static FSharedMesh* BuildMesh(FRHI* InRHI, const FMeshKey& Key, const FMeshBuildFunction& Build);
+
+    // Free a mesh's geometry ranges and delete it
+    static void DestroyMesh(FSharedMesh* Mesh);
+
+    FRHI* RHI;
+
+    mutable std::mutex Mutex;
+    std::unordered_map<FMeshKey, FSharedMesh*, FMeshKeyHash> Meshes;
+
+    FMeshRegistryStats Stats;
+
+    static FMeshRegistry* GInstance;
+};
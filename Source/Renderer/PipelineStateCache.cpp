@@ -0,0 +1,289 @@
+#include "PipelineStateCache.h"
+#include <chrono>
+
+// Static instance
+FPipelineStateCache* FPipelineStateCache::GInstance = nullptr;
+
+FPipelineStateCache::FPipelineStateCache(FRHI* InRHI)
+    : RHI(InRHI)
+{
+    FLog::Log(ELogLevel::Info, "FPipelineStateCache: Initialized");
+}
+
+FPipelineStateCache::~FPipelineStateCache()
+{
+    // Precache tasks write into the entries below
+    WaitForPrecache();
+
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    // The cache holds one reference per precached PSO itself
+    if (Stats.References > Stats.Precached)
+    {
+        FLog::Log(ELogLevel::Warning, "FPipelineStateCache: Destroying pipeline states that are still referenced (" +
+                  std::to_string(Stats.References - Stats.Precached) + " references)");
+    }
+    for (auto& entry : Entries)
+    {
+        delete entry.second.PipelineState;
+    }
+    Entries.clear();
+    Owners.clear();
+}
+
+FPipelineStateCache* FPipelineStateCache::Get()
+{
+    return GInstance;
+}
+
+void FPipelineStateCache::Initialize(FRHI* InRHI)
+{
+    if (!GInstance && InRHI)
+    {
+        GInstance = new FPipelineStateCache(InRHI);
+    }
+}
+
+void FPipelineStateCache::Shutdown()
+{
+    if (GInstance)
+    {
+        FPipelineStateCacheStats stats = GInstance->GetStats();
+        FLog::Log(ELogLevel::Info, "FPipelineStateCache: Shutdown (" + std::to_string(stats.Hits) + " hits, " +
+                  std::to_string(stats.Misses) + " misses, " + std::to_string(stats.Waits) + " waits)");
+        delete GInstance;
+        GInstance = nullptr;
+    }
+}
+
+FRHIPipelineState* FPipelineStateCache::AcquirePipelineState(FRHI* InRHI, EPipelineFlags Flags)
+{
+    if (GInstance && GInstance->RHI == InRHI)
+    {
+        return GInstance->Acquire(Flags);
+    }
+    return InRHI ? InRHI->CreateGraphicsPipelineStateEx(Flags) : nullptr;
+}
+
+void FPipelineStateCache::ReleasePipelineState(FRHIPipelineState* PipelineState)
+{
+    if (!PipelineState)
+    {
+        return;
+    }
+    if (!GInstance || !GInstance->Release(PipelineState))
+    {
+        // Created directly because no cache existed at the time
+        delete PipelineState;
+    }
+}
+
+FRHIPipelineState* FPipelineStateCache::Acquire(const FPipelineStateKey& Key)
+{
+    std::unique_lock<std::mutex> lock(Mutex);
+
+    auto it = Entries.find(Key);
+    if (it == Entries.end())
+    {
+        // Publish the entry before building so concurrent acquires wait instead of duplicating it
+        ++Stats.Misses;
+        ++Stats.References;
+        Entries.emplace(Key, FCachedPipelineState{ nullptr, 1, EBuildState::Building });
+
+        lock.unlock();
+        BuildPipelineState(Key);
+        lock.lock();
+    }
+    else
+    {
+        ++Stats.Hits;
+        ++Stats.References;
+        ++it->second.RefCount;
+
+        // Element addresses are stable and our reference keeps the entry alive
+        FCachedPipelineState* entry = &it->second;
+        if (entry->State != EBuildState::Ready)
+        {
+            ++Stats.Waits;
+            auto waitStart = std::chrono::high_resolution_clock::now();
+            if (entry->State == EBuildState::Queued)
+            {
+                // Its precache task has not started: build it now rather than wait behind other keys
+                entry->State = EBuildState::Building;
+                lock.unlock();
+                BuildPipelineState(Key);
+                lock.lock();
+            }
+            else
+            {
+                BuildCondition.wait(lock, [entry]() { return entry->State == EBuildState::Ready; });
+            }
+            Stats.WaitMs += std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - waitStart).count();
+        }
+    }
+
+    FRHIPipelineState* pipelineState = Entries.find(Key)->second.PipelineState;
+    if (!pipelineState)
+    {
+        // Build failed; drop our reference so a later acquire tries again
+        ReleaseEntry(Key);
+    }
+    return pipelineState;
+}
+
+bool FPipelineStateCache::Release(FRHIPipelineState* PipelineState)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+
+    auto ownerIt = Owners.find(PipelineState);
+    if (ownerIt == Owners.end())
+    {
+        return false;
+    }
+
+    // Copy: releasing the last reference erases the owner entry
+    FPipelineStateKey key = ownerIt->second;
+    ReleaseEntry(key);
+    return true;
+}
+
+bool FPipelineStateCache::BuildPipelineState(const FPipelineStateKey& Key)
+{
+    // The RHI derives the input layout from the flags, which is what Key.VertexLayout records
+    FRHIPipelineState* pipelineState = RHI->CreateGraphicsPipelineStateEx(Key.Flags);
+    if (!pipelineState)
+    {
+        FLog::Log(ELogLevel::Error, "FPipelineStateCache: Failed to create pipeline state for flags " +
+                  std::to_string(static_cast<uint32>(Key.Flags)));
+    }
+
+    std::lock_guard<std::mutex> lock(Mutex);
+    FCachedPipelineState& entry = Entries.find(Key)->second;
+    entry.PipelineState = pipelineState;
+    entry.State = EBuildState::Ready;
+    if (pipelineState)
+    {
+        Owners.emplace(pipelineState, Key);
+        ++Stats.LivePipelineStates;
+    }
+    BuildCondition.notify_all();
+    return pipelineState != nullptr;
+}
+
+void FPipelineStateCache::ReleaseEntry(const FPipelineStateKey& Key)
+{
+    auto it = Entries.find(Key);
+    --Stats.References;
+    if (--it->second.RefCount == 0)
+    {
+        FRHIPipelineState* pipelineState = it->second.PipelineState;
+        if (pipelineState)
+        {
+            Owners.erase(pipelineState);
+            // Frames still in flight may have the PSO bound
+            RHI->DeferredRelease(pipelineState);
+            --Stats.LivePipelineStates;
+        }
+        Entries.erase(it);
+    }
+}
+
+void FPipelineStateCache::Precache(const std::vector<FPipelineStateKey>& Keys)
+{
+    std::vector<FPipelineStateKey> newKeys;
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        for (const FPipelineStateKey& key : Keys)
+        {
+            if (Entries.find(key) != Entries.end())
+            {
+                continue;
+            }
+            // The cache's own reference keeps precached PSOs alive between users
+            Entries.emplace(key, FCachedPipelineState{ nullptr, 1, EBuildState::Queued });
+            ++Stats.References;
+            ++Stats.Precached;
+            newKeys.push_back(key);
+        }
+    }
+
+    // Queued outside the lock: without workers the task graph runs tasks inline
+    FTaskGraph& taskGraph = FTaskGraph::Get();
+    for (const FPipelineStateKey& key : newKeys)
+    {
+        PrecacheEvents.push_back(taskGraph.CreateTask([this, key]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                FCachedPipelineState& entry = Entries.find(key)->second;
+                if (entry.State != EBuildState::Queued)
+                {
+                    // An Acquire() got to it first
+                    return;
+                }
+                entry.State = EBuildState::Building;
+            }
+            if (!BuildPipelineState(key))
+            {
+                // Drop the cache's reference so the key is retried on demand
+                std::lock_guard<std::mutex> lock(Mutex);
+                --Stats.Precached;
+                ReleaseEntry(key);
+            }
+        }));
+    }
+
+    FLog::Log(ELogLevel::Info, "FPipelineStateCache: Precaching " + std::to_string(newKeys.size()) +
+              " pipeline states on " + std::to_string(taskGraph.GetNumWorkerThreads()) + " workers");
+}
+
+void FPipelineStateCache::WaitForPrecache()
+{
+    for (FGraphEventRef& event : PrecacheEvents)
+    {
+        event->Wait();
+    }
+    PrecacheEvents.clear();
+}
+
+bool FPipelineStateCache::IsPrecacheComplete() const
+{
+    for (const FGraphEventRef& event : PrecacheEvents)
+    {
+        if (!event->IsComplete())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<FPipelineStateKey> FPipelineStateCache::GetAllPipelineStateKeys()
+{
+    // Every subset of the eight flag bits, filtered down to what the RHI can build
+    const uint32 numFlagCombinations = static_cast<uint32>(EPipelineFlags::Instanced) << 1;
+
+    std::vector<FPipelineStateKey> keys;
+    for (uint32 bits = 0; bits < numFlagCombinations; ++bits)
+    {
+        EPipelineFlags flags = static_cast<EPipelineFlags>(bits);
+        if (IsValidPipelineFlags(flags))
+        {
+            keys.emplace_back(flags);
+        }
+    }
+    return keys;
+}
+
+FPipelineStateCacheStats FPipelineStateCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Stats;
+}
+
+uint32 FPipelineStateCache::GetNumLivePipelineStates() const
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Stats.LivePipelineStates;
+}
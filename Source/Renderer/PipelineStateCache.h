@@ -0,0 +1,226 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include "../RHI/RHI.h"
+#include "../TaskGraph/TaskGraph.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * EVertexLayout - Input layout a pipeline state is compiled against
+ * Matches the vertex structures in RHI.h
+ */
+enum class EVertexLayout : uint32
+{
+    Color,      // FVertex (position, color)
+    Lit,        // FLitVertex (position, normal, color)
+    Textured,   // FTexturedVertex (position, normal, color, UV)
+};
+
+// The input layout the RHI picks for a set of pipeline flags
+inline EVertexLayout GetVertexLayoutForFlags(EPipelineFlags Flags)
+{
+    if (HasFlag(Flags, EPipelineFlags::EnableTextures))
+    {
+        return EVertexLayout::Textured;
+    }
+    if (HasFlag(Flags, EPipelineFlags::EnableLighting) || HasFlag(Flags, EPipelineFlags::DepthOnly))
+    {
+        return EVertexLayout::Lit;
+    }
+    return EVertexLayout::Color;
+}
+
+// Flag combinations the RHI can build: depth-only stands alone, shadows and
+// textures need lighting, and line topology is only used by unlit pipelines.
+// Instanced variants exist for the depth-only, lit and depth-tested unlit shaders.
+inline bool IsValidPipelineFlags(EPipelineFlags Flags)
+{
+    bool bInstanced = HasFlag(Flags, EPipelineFlags::Instanced);
+    if (HasFlag(Flags, EPipelineFlags::DepthOnly))
+    {
+        return Flags == EPipelineFlags::DepthOnly || Flags == (EPipelineFlags::DepthOnly | EPipelineFlags::Instanced);
+    }
+    if (bInstanced &&
+        (!HasFlag(Flags, EPipelineFlags::EnableDepth) || HasFlag(Flags, EPipelineFlags::EnableTextures) ||
+         HasFlag(Flags, EPipelineFlags::LineTopology)))
+    {
+        return false;
+    }
+    bool bLighting = HasFlag(Flags, EPipelineFlags::EnableLighting);
+    if (!bLighting && (HasFlag(Flags, EPipelineFlags::EnableShadows) || HasFlag(Flags, EPipelineFlags::EnableTextures)))
+    {
+        return false;
+    }
+    if (HasFlag(Flags, EPipelineFlags::LineTopology) &&
+        (bLighting || HasFlag(Flags, EPipelineFlags::WireframeMode)))
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * FPipelineStateKey - Everything that distinguishes one cached PSO from another
+ */
+struct FPipelineStateKey
+{
+    EPipelineFlags Flags;
+    EVertexLayout VertexLayout;
+
+    FPipelineStateKey()
+        : Flags(EPipelineFlags::None)
+        , VertexLayout(EVertexLayout::Color)
+    {
+    }
+
+    explicit FPipelineStateKey(EPipelineFlags InFlags)
+        : Flags(InFlags)
+        , VertexLayout(GetVertexLayoutForFlags(InFlags))
+    {
+    }
+
+    bool operator==(const FPipelineStateKey& Other) const
+    {
+        return Flags == Other.Flags && VertexLayout == Other.VertexLayout;
+    }
+};
+
+// Hash function for FPipelineStateKey
+struct FPipelineStateKeyHash
+{
+    size_t operator()(const FPipelineStateKey& Key) const
+    {
+        uint64 packed = (static_cast<uint64>(Key.VertexLayout) << 32) | static_cast<uint32>(Key.Flags);
+        return std::hash<uint64>()(packed);
+    }
+};
+
+/**
+ * FPipelineStateCacheStats - Statistics for the pipeline state cache
+ */
+struct FPipelineStateCacheStats
+{
+    uint64 Hits;                // Acquires served by an existing PSO
+    uint64 Misses;              // Acquires that had to create a PSO
+    uint64 Waits;               // Acquires that found a precached PSO not ready yet
+    double WaitMs;              // Total time spent in those waits
+    uint32 LivePipelineStates;  // PSOs currently held by at least one user
+    uint32 References;          // Outstanding acquires across all live PSOs (including precache)
+    uint32 Precached;           // PSOs requested by Precache()
+
+    FPipelineStateCacheStats()
+        : Hits(0)
+        , Misses(0)
+        , Waits(0)
+        , WaitMs(0.0)
+        , LivePipelineStates(0)
+        , References(0)
+        , Precached(0)
+    {
+    }
+};
+
+/**
+ * FPipelineStateCache - Shared, reference-counted pipeline states
+ * Similar in spirit to UE5's PipelineStateCache
+ *
+ * Primitives that share flags share one PSO instead of compiling their own.
+ * Acquire() returns the PSO for a key and adds a reference; every Acquire()
+ * must be matched by a Release(), and the PSO is destroyed when the last
+ * reference goes. Thread-safe: proxies are created on the game thread and
+ * may be destroyed on the render thread.
+ *
+ * Precache() builds a set of keys on FTaskGraph workers ahead of use and
+ * keeps them alive until the cache is destroyed. Acquire() never compiles a
+ * duplicate: a precached PSO whose task has not started yet is built by the
+ * caller right away (the task then skips it), and one that is mid-build is
+ * waited for, so the first proxy to need a PSO pays at most one build.
+ *
+ * Callers that may run without a renderer (unit tests building scenes
+ * directly) use the static AcquirePipelineState / ReleasePipelineState
+ * helpers, which fall back to creating and deleting PSOs directly when no
+ * cache exists for the RHI.
+ */
+class FPipelineStateCache
+{
+public:
+    FPipelineStateCache(FRHI* InRHI);
+    ~FPipelineStateCache();
+
+    FPipelineStateCache(const FPipelineStateCache&) = delete;
+    FPipelineStateCache& operator=(const FPipelineStateCache&) = delete;
+
+    // Singleton access (created by FRenderer::Initialize)
+    static FPipelineStateCache* Get();
+    static void Initialize(FRHI* InRHI);
+    static void Shutdown();
+
+    // Cached when the global cache belongs to InRHI, otherwise created / deleted directly
+    static FRHIPipelineState* AcquirePipelineState(FRHI* InRHI, EPipelineFlags Flags);
+    static void ReleasePipelineState(FRHIPipelineState* PipelineState);
+
+    // Shared PSO for Key with one more reference; nullptr if creation failed
+    FRHIPipelineState* Acquire(const FPipelineStateKey& Key);
+    FRHIPipelineState* Acquire(EPipelineFlags Flags) { return Acquire(FPipelineStateKey(Flags)); }
+
+    // Drop one reference; false if PipelineState did not come from this cache
+    bool Release(FRHIPipelineState* PipelineState);
+
+    // Start building Keys on the task graph; each is held by the cache until it is destroyed.
+    // Precache and the wait/query below are for the thread that owns the cache (game thread).
+    void Precache(const std::vector<FPipelineStateKey>& Keys);
+
+    // Block until every task started by Precache() has finished
+    void WaitForPrecache();
+    bool IsPrecacheComplete() const;
+
+    // Every valid flag combination, which covers each vertex layout (FVertex, FLitVertex, FTexturedVertex)
+    static std::vector<FPipelineStateKey> GetAllPipelineStateKeys();
+
+    FRHI* GetRHI() const { return RHI; }
+
+    // Statistics (copied under the lock)
+    FPipelineStateCacheStats GetStats() const;
+    uint32 GetNumLivePipelineStates() const;
+
+private:
+    enum class EBuildState : uint8
+    {
+        Queued,     // Waiting for its precache task
+        Building,   // Being created by exactly one thread
+        Ready,      // PipelineState is final (nullptr if the build failed)
+    };
+
+    struct FCachedPipelineState
+    {
+        FRHIPipelineState* PipelineState;
+        uint32 RefCount;
+        EBuildState State;
+    };
+
+    // Create the PSO for an entry the caller moved to Building, then publish it (Mutex not held)
+    bool BuildPipelineState(const FPipelineStateKey& Key);
+
+    // Drop one reference to the entry for Key, destroying it with the last one (Mutex held)
+    void ReleaseEntry(const FPipelineStateKey& Key);
+
+    FRHI* RHI;
+
+    mutable std::mutex Mutex;
+    std::condition_variable BuildCondition;
+    std::unordered_map<FPipelineStateKey, FCachedPipelineState, FPipelineStateKeyHash> Entries;
+
+    // Reverse lookup so Release() only needs the PSO pointer
+    std::unordered_map<FRHIPipelineState*, FPipelineStateKey> Owners;
+
+    FPipelineStateCacheStats Stats;
+
+    // Completion events of in-flight Precache() tasks
+    FGraphEventArray PrecacheEvents;
+
+    static FPipelineStateCache* GInstance;
+};
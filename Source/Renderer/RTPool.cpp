@@ -249,7 +249,8 @@ void FRTPool::DestroyRT(FPooledRT* RT)
         
         if (RT->Texture)
         {
-            delete RT->Texture;
+            // The last frame that rendered to or sampled it may still be in flight
+            RHI->DeferredRelease(RT->Texture, EstimateMemoryUsage(RT->Descriptor));
             RT->Texture = nullptr;
         }
         delete RT;
@@ -1,4 +1,6 @@
 #include "RenderStats.h"
+#include <algorithm>
+#include <cmath>
 
 FRenderStats::FRenderStats()
     : FrameCount(0)
@@ -6,9 +8,6 @@ FRenderStats::FRenderStats()
     , FrameTimeMs(0.0f)
     , TriangleCount(0)
     , FramesSinceLastFPSUpdate(0)
-    , GameThreadTimeMs(0.0f)
-    , RenderThreadTimeMs(0.0f)
-    , RHIThreadTimeMs(0.0f)
 {
     LastFPSUpdateTime = std::chrono::high_resolution_clock::now();
 }
@@ -44,38 +43,111 @@ void FRenderStats::AddTriangles(uint32 Count)
     TriangleCount += Count;
 }
 
-void FRenderStats::BeginGameThreadTiming()
+FStageTimer::FStageTimer()
+    : WindowBusyMs(0.0)
+    , bWindowStarted(false)
+    , TimeMs(0.0f)
+    , Utilization(0.0f)
 {
-    GameThreadStartTime = std::chrono::high_resolution_clock::now();
 }
 
-void FRenderStats::EndGameThreadTiming()
+void FStageTimer::Begin()
+{
+    StartTime = std::chrono::high_resolution_clock::now();
+    if (!bWindowStarted)
+    {
+        WindowStartTime = StartTime;
+        bWindowStarted = true;
+    }
+}
+
+void FStageTimer::End()
 {
     auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration<float, std::milli>(endTime - GameThreadStartTime);
-    GameThreadTimeMs = duration.count();
+    auto duration = std::chrono::duration<float, std::milli>(endTime - StartTime);
+    TimeMs = duration.count();
+    WindowBusyMs += duration.count();
+    
+    // Publish utilization once per window
+    auto windowDuration = std::chrono::duration<double, std::milli>(endTime - WindowStartTime);
+    if (windowDuration.count() >= UtilizationWindowSeconds * 1000.0)
+    {
+        Utilization = static_cast<float>(WindowBusyMs / windowDuration.count());
+        WindowStartTime = endTime;
+        WindowBusyMs = 0.0;
+    }
 }
 
-void FRenderStats::BeginRenderThreadTiming()
+FFrameLatencyTracker::FFrameLatencyTracker()
+    : NextFrameId(1)
+    , HistoryCount(0)
+    , HistoryNext(0)
+    , P50LatencyMs(0.0f)
+    , P95LatencyMs(0.0f)
+    , P99LatencyMs(0.0f)
+    , MaxLatencyMs(0.0f)
+    , LastLatencyMs(0.0f)
+    , LastPresentedFrameId(0)
 {
-    RenderThreadStartTime = std::chrono::high_resolution_clock::now();
+    for (FFrameRecord& Record : Frames)
+    {
+        Record.FrameId = 0;
+    }
 }
 
-void FRenderStats::EndRenderThreadTiming()
+uint64 FFrameLatencyTracker::BeginFrame()
 {
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration<float, std::milli>(endTime - RenderThreadStartTime);
-    RenderThreadTimeMs = duration.count();
+    uint64 frameId = NextFrameId++;
+    FFrameRecord& record = Frames[frameId % MaxFramesTracked];
+    record.FrameId = frameId;
+    record.StageTimes[static_cast<uint32>(EFrameStage::GameBegin)] = std::chrono::high_resolution_clock::now();
+    return frameId;
 }
 
-void FRenderStats::BeginRHIThreadTiming()
+void FFrameLatencyTracker::MarkStage(uint64 FrameId, EFrameStage Stage)
 {
-    RHIThreadStartTime = std::chrono::high_resolution_clock::now();
+    if (FrameId == 0)
+    {
+        return;
+    }
+    
+    FFrameRecord& record = Frames[FrameId % MaxFramesTracked];
+    if (record.FrameId != FrameId)
+    {
+        return;  // Slot already reused - the pipeline held more than MaxFramesTracked frames
+    }
+    
+    record.StageTimes[static_cast<uint32>(Stage)] = std::chrono::high_resolution_clock::now();
+    if (Stage == EFrameStage::Present)
+    {
+        CompleteFrame(record);
+    }
 }
 
-void FRenderStats::EndRHIThreadTiming()
+void FFrameLatencyTracker::CompleteFrame(const FFrameRecord& Record)
 {
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration<float, std::milli>(endTime - RHIThreadStartTime);
-    RHIThreadTimeMs = duration.count();
+    auto gameBegin = Record.StageTimes[static_cast<uint32>(EFrameStage::GameBegin)];
+    auto present = Record.StageTimes[static_cast<uint32>(EFrameStage::Present)];
+    float latencyMs = std::chrono::duration<float, std::milli>(present - gameBegin).count();
+    
+    History[HistoryNext] = latencyMs;
+    HistoryNext = (HistoryNext + 1) % HistorySize;
+    HistoryCount = std::min(HistoryCount + 1, HistorySize);
+    
+    // Nearest-rank percentiles over the history (at most HistorySize floats, no allocation)
+    float sorted[HistorySize];
+    std::copy(History, History + HistoryCount, sorted);
+    std::sort(sorted, sorted + HistoryCount);
+    auto percentile = [&sorted, this](float Fraction)
+    {
+        uint32 rank = static_cast<uint32>(std::ceil(Fraction * HistoryCount));
+        return sorted[std::min(std::max(rank, 1u), HistoryCount) - 1];
+    };
+    
+    P50LatencyMs = percentile(0.50f);
+    P95LatencyMs = percentile(0.95f);
+    P99LatencyMs = percentile(0.99f);
+    MaxLatencyMs = sorted[HistoryCount - 1];
+    LastLatencyMs = latencyMs;
+    LastPresentedFrameId.store(Record.FrameId, std::memory_order_release);
 }
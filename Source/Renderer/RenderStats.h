@@ -4,6 +4,102 @@
 #include <chrono>
 #include <atomic>
 
+/**
+ * FStageTimer - busy time and utilization of one pipeline stage (game, render, RHI)
+ * Begin/End are called from the stage's own thread only. Utilization is the
+ * fraction of wall time spent between Begin and End, measured over windows of
+ * UtilizationWindowSeconds; readers on other threads see the last full window.
+ */
+struct FStageTimer
+{
+    static constexpr float UtilizationWindowSeconds = 0.5f;
+
+    FStageTimer();
+
+    void Begin();
+    void End();
+
+    std::chrono::high_resolution_clock::time_point StartTime;
+    std::chrono::high_resolution_clock::time_point WindowStartTime;
+    double WindowBusyMs;
+    bool bWindowStarted;
+
+    std::atomic<float> TimeMs;       // Duration of the last Begin/End pair
+    std::atomic<float> Utilization;  // 0..1 over the last full window
+};
+
+// Points in a frame's life that FFrameLatencyTracker timestamps
+enum class EFrameStage : uint32
+{
+    GameBegin,      // Game thread starts the frame
+    RenderBegin,    // Render thread starts recording it
+    RHISubmit,      // RHI thread starts submitting it
+    Present,        // Present call returned
+    Count
+};
+
+/**
+ * FFrameLatencyTracker - per-frame stage timestamps and game-to-present latency
+ * The game thread tags every frame with an ID (BeginFrame); each later stage
+ * stamps that ID from its own thread. The stages of one frame run strictly
+ * one after another (handed over through the render command queue and the RHI
+ * work queue), so a frame's slot needs no locking.
+ *
+ * Present closes the frame: its game-to-present latency goes into a history
+ * of the last HistorySize frames and the percentiles over that history are
+ * republished for readers on any thread.
+ */
+class FFrameLatencyTracker
+{
+public:
+    // Open frames are kept in a ring; must exceed the frames the pipeline can hold
+    static constexpr uint32 MaxFramesTracked = 8;
+    static constexpr uint32 HistorySize = 128;
+
+    FFrameLatencyTracker();
+
+    // Game thread: tag a new frame and stamp GameBegin. IDs start at 1.
+    uint64 BeginFrame();
+
+    // Stamp Stage of FrameId from the stage's thread (FrameId 0 = untracked frame, ignored)
+    void MarkStage(uint64 FrameId, EFrameStage Stage);
+
+    // Game-to-present latency over the last HistorySize presented frames
+    float GetP50LatencyMs() const { return P50LatencyMs; }
+    float GetP95LatencyMs() const { return P95LatencyMs; }
+    float GetP99LatencyMs() const { return P99LatencyMs; }
+    float GetMaxLatencyMs() const { return MaxLatencyMs; }
+
+    // Latency of the most recently presented frame
+    float GetLastLatencyMs() const { return LastLatencyMs; }
+    uint64 GetLastPresentedFrameId() const { return LastPresentedFrameId; }
+
+private:
+    struct FFrameRecord
+    {
+        uint64 FrameId;
+        std::chrono::high_resolution_clock::time_point StageTimes[static_cast<uint32>(EFrameStage::Count)];
+    };
+
+    // Present: record the frame's latency and republish percentiles
+    void CompleteFrame(const FFrameRecord& Record);
+
+    FFrameRecord Frames[MaxFramesTracked];
+    uint64 NextFrameId;                     // Game thread only
+
+    // Written by the presenting thread only
+    float History[HistorySize];
+    uint32 HistoryCount;
+    uint32 HistoryNext;
+
+    std::atomic<float> P50LatencyMs;
+    std::atomic<float> P95LatencyMs;
+    std::atomic<float> P99LatencyMs;
+    std::atomic<float> MaxLatencyMs;
+    std::atomic<float> LastLatencyMs;
+    std::atomic<uint64> LastPresentedFrameId;
+};
+
 // Render statistics tracker
 class FRenderStats 
 {
@@ -18,12 +114,12 @@ public:
     void AddTriangles(uint32 Count);
     
     // Thread timing - called from respective threads
-    void BeginGameThreadTiming();
-    void EndGameThreadTiming();
-    void BeginRenderThreadTiming();
-    void EndRenderThreadTiming();
-    void BeginRHIThreadTiming();
-    void EndRHIThreadTiming();
+    void BeginGameThreadTiming() { GameThreadTimer.Begin(); }
+    void EndGameThreadTiming() { GameThreadTimer.End(); }
+    void BeginRenderThreadTiming() { RenderThreadTimer.Begin(); }
+    void EndRenderThreadTiming() { RenderThreadTimer.End(); }
+    void BeginRHIThreadTiming() { RHIThreadTimer.Begin(); }
+    void EndRHIThreadTiming() { RHIThreadTimer.End(); }
     
     // Get statistics
     uint64 GetFrameCount() const { return FrameCount; }
@@ -32,9 +128,19 @@ public:
     uint32 GetTriangleCount() const { return TriangleCount; }
     
     // Thread times in milliseconds
-    float GetGameThreadTime() const { return GameThreadTimeMs; }
-    float GetRenderThreadTime() const { return RenderThreadTimeMs; }
-    float GetRHIThreadTime() const { return RHIThreadTimeMs; }
+    float GetGameThreadTime() const { return GameThreadTimer.TimeMs; }
+    float GetRenderThreadTime() const { return RenderThreadTimer.TimeMs; }
+    float GetRHIThreadTime() const { return RHIThreadTimer.TimeMs; }
+    
+    // Stage utilization (busy time / wall time, 0..1)
+    // With frame pipelining a stage below 1.0 is waiting on its neighbours
+    float GetGameThreadUtilization() const { return GameThreadTimer.Utilization; }
+    float GetRenderThreadUtilization() const { return RenderThreadTimer.Utilization; }
+    float GetRHIThreadUtilization() const { return RHIThreadTimer.Utilization; }
+    
+    // Per-frame stage timestamps and game-to-present latency percentiles
+    FFrameLatencyTracker& GetLatencyTracker() { return LatencyTracker; }
+    const FFrameLatencyTracker& GetLatencyTracker() const { return LatencyTracker; }
     
 private:
     uint64 FrameCount;
@@ -47,11 +153,9 @@ private:
     uint32 FramesSinceLastFPSUpdate;
     
     // Thread timing
-    std::chrono::high_resolution_clock::time_point GameThreadStartTime;
-    std::chrono::high_resolution_clock::time_point RenderThreadStartTime;
-    std::chrono::high_resolution_clock::time_point RHIThreadStartTime;
+    FStageTimer GameThreadTimer;
+    FStageTimer RenderThreadTimer;
+    FStageTimer RHIThreadTimer;
     
-    std::atomic<float> GameThreadTimeMs;
-    std::atomic<float> RenderThreadTimeMs;
-    std::atomic<float> RHIThreadTimeMs;
+    FFrameLatencyTracker LatencyTracker;
 };
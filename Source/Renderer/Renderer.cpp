@@ -1,32 +1,46 @@
 #include "Renderer.h"
+#include "PipelineStateCache.h"
+#include "MeshRegistry.h"
+#include "../Core/FrameAllocator.h"
 #include "../Scene/Scene.h"
-#include "../Scene/LitSceneProxy.h"  // For FPrimitiveSceneProxy
 #include <algorithm>
 #include <string>
+#include <thread>
 #include <cstdio>  // for snprintf
 #include <cstring> // for memcpy
 #include <cinttypes> // for PRIu64
 
 // FTriangleMeshProxy implementation
-FTriangleMeshProxy::FTriangleMeshProxy(FRHIBuffer* InVertexBuffer, FRHIPipelineState* InPSO, uint32 InVertexCount)
-    : VertexBuffer(InVertexBuffer), PipelineState(InPSO), VertexCount(InVertexCount)
+FTriangleMeshProxy::FTriangleMeshProxy(FGeometryAllocation* InVertices, FRHIPipelineState* InPSO, uint32 InVertexCount)
+    : Vertices(InVertices), PipelineState(InPSO), VertexCount(InVertexCount)
 {
 }
 
 FTriangleMeshProxy::~FTriangleMeshProxy()
 {
-    // Note: Raw delete is intentional here. The proxy owns these RHI resources
-    // and is responsible for their lifetime. This matches the RHI design pattern
-    // where resources are created via factory methods and owned by their users.
-    delete VertexBuffer;
-    delete PipelineState;
+    // The proxy owns its geometry range and returns it to the shared buffers.
+    // Pipeline states are shared, so the proxy only drops its reference.
+    FGeometryBufferAllocator::FreeGeometry(Vertices);
+    FPipelineStateCache::ReleasePipelineState(PipelineState);
 }
 
-void FTriangleMeshProxy::Render(FRHICommandList* RHICmdList)
+bool FTriangleMeshProxy::AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList)
 {
-    RHICmdList->SetPipelineState(PipelineState);
-    RHICmdList->SetVertexBuffer(VertexBuffer, 0, sizeof(FVertex));
-    RHICmdList->DrawPrimitive(VertexCount, 0);
+    if (Pass != EMeshPass::BasePass)
+    {
+        return true;
+    }
+    
+    // No per-frame data: the cached command is submitted as is
+    FMeshDrawCommand command;
+    command.PipelineState = PipelineState;
+    command.VertexBuffer = Vertices->Buffer;
+    command.VertexStride = sizeof(FVertex);
+    command.DrawType = EMeshDrawType::NonIndexed;
+    command.NumElements = VertexCount;
+    command.FirstElement = Vertices->First;
+    DrawList.AddCommand(command);
+    return true;
 }
 
 uint32 FTriangleMeshProxy::GetTriangleCount() const
@@ -35,40 +49,45 @@ uint32 FTriangleMeshProxy::GetTriangleCount() const
 }
 
 // FCubeMeshProxy implementation
-FCubeMeshProxy::FCubeMeshProxy(FRHIBuffer* InVertexBuffer, FRHIBuffer* InIndexBuffer, FRHIBuffer* InConstantBuffer,
-                               FRHIPipelineState* InPSO, uint32 InIndexCount, FCamera* InCamera)
-    : VertexBuffer(InVertexBuffer), IndexBuffer(InIndexBuffer), ConstantBuffer(InConstantBuffer),
-      PipelineState(InPSO), IndexCount(InIndexCount), Camera(InCamera), ModelMatrix(FMatrix4x4::Identity())
+FCubeMeshProxy::FCubeMeshProxy(FGeometryAllocation* InVertices, FGeometryAllocation* InIndices,
+                               FRHIPipelineState* InPSO, uint32 InIndexCount, FCamera* InCamera, FRHI* InRHI)
+    : Vertices(InVertices), Indices(InIndices),
+      PipelineState(InPSO), IndexCount(InIndexCount), Camera(InCamera), ModelMatrix(FMatrix4x4::Identity()), RHI(InRHI)
 {
 }
 
 FCubeMeshProxy::~FCubeMeshProxy()
 {
-    delete VertexBuffer;
-    delete IndexBuffer;
-    delete ConstantBuffer;
-    delete PipelineState;
+    FGeometryBufferAllocator::FreeGeometry(Vertices);
+    FGeometryBufferAllocator::FreeGeometry(Indices);
+    FPipelineStateCache::ReleasePipelineState(PipelineState);
+}
+
+bool FCubeMeshProxy::AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList)
+{
+    if (Pass != EMeshPass::BasePass)
+    {
+        return true;
+    }
+    
+    FMeshDrawCommand command;
+    command.Proxy = this;
+    command.PipelineState = PipelineState;
+    command.VertexBuffer = Vertices->Buffer;
+    command.VertexStride = sizeof(FVertex);
+    command.IndexBuffer = Indices->Buffer;
+    command.NumElements = IndexCount;
+    command.FirstElement = Indices->First;
+    command.BaseVertex = Vertices->First;
+    DrawList.AddCommand(command);
+    return true;
 }
 
-void FCubeMeshProxy::Render(FRHICommandList* RHICmdList)
+void FCubeMeshProxy::UpdateMeshDrawCommand(EMeshPass /*Pass*/, FMeshDrawCommand& Command, const FMeshDrawContext& Context)
 {
-    // Calculate MVP matrix with current model matrix
-    FMatrix4x4 viewProjection = Camera->GetViewProjectionMatrix();
-    FMatrix4x4 mvp = ModelMatrix * viewProjection;
-    
-    // Transpose for HLSL (column-major)
-    FMatrix4x4 mvpTransposed = mvp.Transpose();
-    
-    // Update constant buffer with current MVP
-    void* cbData = ConstantBuffer->Map();
-    memcpy(cbData, &mvpTransposed.Matrix, sizeof(DirectX::XMMATRIX));
-    ConstantBuffer->Unmap();
-    
-    RHICmdList->SetPipelineState(PipelineState);
-    RHICmdList->SetConstantBuffer(ConstantBuffer, 0);
-    RHICmdList->SetVertexBuffer(VertexBuffer, 0, sizeof(FVertex));
-    RHICmdList->SetIndexBuffer(IndexBuffer);
-    RHICmdList->DrawIndexedPrimitive(IndexCount, 0, 0);
+    // Current MVP (transposed for HLSL) goes into this frame's transient constants
+    FMatrix4x4 mvpTransposed = (ModelMatrix * Context.ViewProjection).Transpose();
+    Command.ConstantBuffers[0] = RHI->UploadTransientConstants(&mvpTransposed.Matrix, sizeof(DirectX::XMMATRIX));
 }
 
 uint32 FCubeMeshProxy::GetTriangleCount() const
@@ -86,7 +105,21 @@ FRenderer::FRenderer(FRHI* InRHI)
     : RHI(InRHI)
     , DrawCallCount(0)
     , CurrentScene(nullptr)
+    , RecordedFrameCount(0)
+    , bPrecachePipelineStates(true)
+    , bSortMeshDrawCommands(true)
+    , bInstancedDraws(true)
+    , bFrustumCulling(true)
+    , bOcclusionCulling(true)
+    , bShadowCulling(true)
 {
+    for (uint32 i = 0; i < MaxFramesInFlight; ++i)
+    {
+        FrameRecorders[i] = std::make_unique<FRHICommandRecorder>();
+        FrameRecorderInFlight[i] = false;
+        FrameRecorderSnapshotSequence[i] = 0;
+        FrameRecorderFrameId[i] = 0;
+    }
 }
 
 FRenderer::~FRenderer()
@@ -103,10 +136,31 @@ void FRenderer::Initialize()
     
     // Create render scene
     RenderScene = std::make_unique<FRenderScene>();
+    RenderScene->SetSortMeshDrawCommands(bSortMeshDrawCommands);
+    RenderScene->SetInstancedDraws(bInstancedDraws);
+    RenderScene->SetFrustumCulling(bFrustumCulling);
+    RenderScene->SetOcclusionCulling(bOcclusionCulling);
+    RenderScene->SetShadowCulling(bShadowCulling);
     
     // Initialize RT pool (global singleton)
     FRTPool::Initialize(RHI);
     
+    // Initialize pipeline state cache (global singleton) before anything acquires a PSO
+    FPipelineStateCache::Initialize(RHI);
+    
+    // Build every pipeline state on the task graph while the game sets up its scene;
+    // proxies that need one before it is ready wait for that PSO only
+    if (bPrecachePipelineStates)
+    {
+        FPipelineStateCache::Get()->Precache(FPipelineStateCache::GetAllPipelineStateKeys());
+    }
+    
+    // Shared vertex / index buffers that scene primitives sub-allocate their geometry from
+    FGeometryBufferAllocator::Initialize(RHI);
+    
+    // Meshes shared by every primitive built from the same generator parameters or source
+    FMeshRegistry::Initialize(RHI);
+    
     // Initialize shadow system
     ShadowSystem = std::make_unique<FShadowSystem>();
     ShadowSystem->Initialize(RHI);
@@ -132,13 +186,156 @@ void FRenderer::Shutdown()
         RenderScene.reset();
     }
     
+    // Destroy everything released above now, while the allocators its releases return to still exist
+    if (RHI)
+    {
+        RHI->FlushDeferredReleases();
+    }
+    
+    // Meshes still held by proxies are freed by their last release, into orphaned ranges
+    FMeshRegistry::Shutdown();
+    
+    // Geometry buffers go once no proxy references a range in them
+    FGeometryBufferAllocator::Shutdown();
+    
+    // Shutdown pipeline state cache last - proxies and shadow passes release into it
+    FPipelineStateCache::Shutdown();
+    
     CurrentScene = nullptr;
     
     FLog::Log(ELogLevel::Info, "Renderer shutdown");
 }
 
-void FRenderer::RenderFrame()
+void FRenderer::SetSortMeshDrawCommands(bool bEnable)
+{
+    bSortMeshDrawCommands = bEnable;
+    if (RenderScene)
+    {
+        RenderScene->SetSortMeshDrawCommands(bEnable);
+    }
+}
+
+void FRenderer::SetInstancedDraws(bool bEnable)
+{
+    bInstancedDraws = bEnable;
+    if (RenderScene)
+    {
+        RenderScene->SetInstancedDraws(bEnable);
+    }
+}
+
+void FRenderer::SetFrustumCulling(bool bEnable)
+{
+    bFrustumCulling = bEnable;
+    if (RenderScene)
+    {
+        RenderScene->SetFrustumCulling(bEnable);
+    }
+}
+
+void FRenderer::SetOcclusionCulling(bool bEnable)
+{
+    bOcclusionCulling = bEnable;
+    if (RenderScene)
+    {
+        RenderScene->SetOcclusionCulling(bEnable);
+    }
+}
+
+void FRenderer::SetShadowCulling(bool bEnable)
+{
+    bShadowCulling = bEnable;
+    if (RenderScene)
+    {
+        RenderScene->SetShadowCulling(bEnable);
+    }
+}
+
+void FRenderer::RenderFrame(uint64 FrameId)
+{
+    // Recording and submission are the same step on this path
+    FFrameLatencyTracker& latencyTracker = Stats.GetLatencyTracker();
+    latencyTracker.MarkStage(FrameId, EFrameStage::RenderBegin);
+    latencyTracker.MarkStage(FrameId, EFrameStage::RHISubmit);
+    
+    // Begin RHI timing (tracks GPU command submission time)
+    Stats.BeginRHIThreadTiming();
+    
+    RenderFrameInternal(RHI->GetCommandList());
+    
+    // End RHI timing
+    Stats.EndRHIThreadTiming();
+    
+    latencyTracker.MarkStage(FrameId, EFrameStage::Present);
+    
+    // Commands were issued directly, so the snapshot is no longer referenced
+    if (RenderScene)
+    {
+        RenderScene->ReleaseSnapshot(RenderScene->GetAppliedSnapshotSequence());
+    }
+}
+
+FRHICommandRecorder* FRenderer::RecordFrame(uint64 FrameId)
+{
+    Stats.GetLatencyTracker().MarkStage(FrameId, EFrameStage::RenderBegin);
+    
+    uint32 slot = static_cast<uint32>(RecordedFrameCount % MaxFramesInFlight);
+    ++RecordedFrameCount;
+    
+    // Back-pressure: the RHI thread is still replaying the frame that last used this slot
+    while (FrameRecorderInFlight[slot].load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+    
+    FRHICommandRecorder* recorder = FrameRecorders[slot].get();
+    recorder->Reset();
+    RenderFrameInternal(recorder);
+    
+    // Proxies of this snapshot stay alive until the recorder has been replayed
+    FrameRecorderSnapshotSequence[slot] = RenderScene ? RenderScene->GetAppliedSnapshotSequence() : 0;
+    FrameRecorderFrameId[slot] = FrameId;
+    FrameRecorderInFlight[slot].store(true, std::memory_order_release);
+    return recorder;
+}
+
+void FRenderer::ExecuteRecordedFrame(FRHICommandRecorder* Recorder)
+{
+    uint32 slot = 0;
+    while (slot < MaxFramesInFlight && FrameRecorders[slot].get() != Recorder)
+    {
+        ++slot;
+    }
+    uint64 frameId = slot < MaxFramesInFlight ? FrameRecorderFrameId[slot] : 0;
+    
+    FFrameLatencyTracker& latencyTracker = Stats.GetLatencyTracker();
+    latencyTracker.MarkStage(frameId, EFrameStage::RHISubmit);
+    
+    Stats.BeginRHIThreadTiming();
+    
+    Recorder->Replay(RHI->GetCommandList());
+    
+    Stats.EndRHIThreadTiming();
+    
+    latencyTracker.MarkStage(frameId, EFrameStage::Present);
+    
+    if (slot < MaxFramesInFlight)
+    {
+        if (RenderScene)
+        {
+            RenderScene->ReleaseSnapshot(FrameRecorderSnapshotSequence[slot]);
+        }
+        FrameRecorderInFlight[slot].store(false, std::memory_order_release);
+    }
+}
+
+void FRenderer::RenderFrameInternal(FRHICommandList* TargetCmdList)
 {
+    // Proxies and passes bind everything they need per draw; the state cache drops the binds
+    // that repeat what is already set before they reach TargetCmdList
+    StateCache.SetTarget(TargetCmdList);
+    FRHICommandList* RHICmdList = &StateCache;
+    
     static int renderFrameCount = 0;
     renderFrameCount++;
     
@@ -147,6 +344,12 @@ void FRenderer::RenderFrame()
         FLog::Log(ELogLevel::Info, std::string("=== RenderFrame ") + std::to_string(renderFrameCount) + " ===");
     }
     
+    // Pick up the latest primitive state published by the game thread
+    if (RenderScene)
+    {
+        RenderScene->ApplySnapshot();
+    }
+    
     // Begin stats tracking for this frame
     Stats.BeginFrame();
     
@@ -160,13 +363,16 @@ void FRenderer::RenderFrame()
         rtPool->BeginFrame(Stats.GetFrameCount());
     }
     
-    // This simulates UE5's parallel rendering architecture
-    // In real UE5, this would kick off a render thread task
-    
-    FRHICommandList* RHICmdList = RHI->GetCommandList();
+    // Start a new transient constant segment. The ring rewinds only segments whose frame
+    // GetCompletedFrameFence() has passed, so the GPU is done reading the constants in it;
+    // if every segment is still in flight it grows instead of waiting.
+    RHI->BeginTransientFrame();
     
-    // Begin RHI timing (tracks GPU command submission time)
-    Stats.BeginRHIThreadTiming();
+    // Instance data is rewritten into the new segment before the first pass
+    if (RenderScene)
+    {
+        RenderScene->BeginFrame();
+    }
     
     // Begin rendering - initializes command list and render targets
     RHICmdList->BeginFrame();
@@ -182,44 +388,21 @@ void FRenderer::RenderFrame()
         // Render shadow passes (directional + point lights)
         ShadowSystem->RenderShadowPasses(RHICmdList, RenderScene.get());
         DrawCallCount += ShadowSystem->GetShadowDrawCallCount();
-        
-        // === CRITICAL: Flush shadow pass commands before main pass ===
-        // Each proxy uses its own MVPConstantBuffer for shadow rendering.
-        // The main pass will overwrite these buffers with camera matrices.
-        // We must ensure the GPU has read the shadow MVP data before overwriting.
-        RHICmdList->FlushCommandsFor2D();  // Reuse existing flush mechanism
     }
     
     // Clear screen (main render target)
     RHICmdList->ClearRenderTarget(FColor(0.2f, 0.3f, 0.4f, 1.0f));
     RHICmdList->ClearDepthStencil();
     
-    // Pass shadow map texture to all lit proxies (they will bind it after setting their PSO)
-    FRHITexture* shadowMap = nullptr;
-    if (ShadowSystem)
-    {
-        shadowMap = ShadowSystem->GetDirectionalShadowMap();
-    }
-    
-    // Set shadow map on all proxies before rendering
-    if (RenderScene && shadowMap)
-    {
-        for (auto& proxy : RenderScene->GetProxies())
-        {
-            // Try to cast to FPrimitiveSceneProxy to set shadow map
-            FPrimitiveSceneProxy* litProxy = dynamic_cast<FPrimitiveSceneProxy*>(proxy);
-            if (litProxy)
-            {
-                litProxy->SetShadowMapTexture(shadowMap);
-            }
-        }
-    }
-    
     // Render scene using render scene
     if (RenderScene)
     {
-        RenderScene->Render(RHICmdList, Stats);
-        DrawCallCount += static_cast<uint32>(RenderScene->GetProxies().size());
+        // Camera, lights and shadow map are looked up once here; cached draws only add their own data
+        FMeshDrawContext basePassContext;
+        basePassContext.InitBasePass(RHI, Camera.get(),
+                                     CurrentScene ? CurrentScene->GetLightScene() : nullptr,
+                                     ShadowSystem.get());
+        DrawCallCount += RenderScene->Render(RHICmdList, basePassContext, Stats);
     }
 
 	// === CRITICAL: Flush 3D commands before 2D rendering ===
@@ -234,9 +417,6 @@ void FRenderer::RenderFrame()
     // Present
     RHICmdList->Present();
     
-    // End RHI timing
-    Stats.EndRHIThreadTiming();
-    
     // End RT pool frame
     if (rtPool)
     {
@@ -245,6 +425,9 @@ void FRenderer::RenderFrame()
     
     // End stats tracking
     Stats.EndFrame();
+    
+    // Transient render-thread allocations of this frame are dead; command lists copied what they keep
+    FFrameAllocator::Get().Reset();
 }
 
 void FRenderer::UpdateFromScene(FScene* GameScene)
@@ -252,8 +435,7 @@ void FRenderer::UpdateFromScene(FScene* GameScene)
     // Store scene reference for shadow system
     CurrentScene = GameScene;
     
-    // This is the sync point between game and render thread
-    // In real UE5, this would be more sophisticated with command queues
+    // Game thread: publishes a snapshot the render thread applies at its next frame
     if (GameScene && RenderScene)
     {
         GameScene->UpdateRenderScene(RenderScene.get());
@@ -320,6 +502,23 @@ void FRenderer::RenderStats(FRHICommandList* RHICmdList)
     RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
     yPos += lineHeight;
     
+    // Stage utilization (busy / wall time) - shows which stage bounds the pipeline
+    snprintf(buffer, sizeof(buffer), "Util G/D/R: %.0f/%.0f/%.0f%%",
+             Stats.GetGameThreadUtilization() * 100.0f,
+             Stats.GetRenderThreadUtilization() * 100.0f,
+             Stats.GetRHIThreadUtilization() * 100.0f);
+    RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
+    yPos += lineHeight;
+    
+    // Game-to-present latency p50/p95/p99 over recent frames
+    const FFrameLatencyTracker& latencyTracker = Stats.GetLatencyTracker();
+    snprintf(buffer, sizeof(buffer), "Latency: %.1f/%.1f/%.1f ms",
+             latencyTracker.GetP50LatencyMs(),
+             latencyTracker.GetP95LatencyMs(),
+             latencyTracker.GetP99LatencyMs());
+    RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
+    yPos += lineHeight;
+    
     // Triangle count
     snprintf(buffer, sizeof(buffer), "Tris: %u", Stats.GetTriangleCount());
     RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
@@ -330,6 +529,25 @@ void FRenderer::RenderStats(FRHICommandList* RHICmdList)
     RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
     yPos += lineHeight;
     
+    // Frustum culling: proxies drawn / culled in the base pass
+    if (RenderScene)
+    {
+        const FSceneCullingStats& cullingStats = RenderScene->GetCullingStats();
+        snprintf(buffer, sizeof(buffer), "Visible/Culled: %u/%u", cullingStats.VisibleProxies, cullingStats.CulledProxies);
+        RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
+        yPos += lineHeight;
+        
+        const FOcclusionCullingStats& occlusionStats = RenderScene->GetOcclusionCullingStats();
+        snprintf(buffer, sizeof(buffer), "Occluded: %u (%.0f%%)", occlusionStats.OccludedProxies, occlusionStats.GetOccludedPercent());
+        RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
+        yPos += lineHeight;
+        
+        const FShadowCullingStats& shadowStats = RenderScene->GetShadowCullingStats();
+        snprintf(buffer, sizeof(buffer), "Shadow Casters Drawn/Culled: %u/%u", shadowStats.DrawnCasters, shadowStats.CulledCasters);
+        RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
+        yPos += lineHeight;
+    }
+    
     // RT Pool statistics
     FRTPool* pool = FRTPool::Get();
     if (pool)
@@ -352,6 +570,17 @@ void FRenderer::RenderStats(FRHICommandList* RHICmdList)
             yPos += lineHeight;
         }
     }
+    
+    // Pipeline state cache statistics
+    FPipelineStateCache* psoCache = FPipelineStateCache::Get();
+    if (psoCache)
+    {
+        FPipelineStateCacheStats psoStats = psoCache->GetStats();
+        snprintf(buffer, sizeof(buffer), "PSOs: %u (hit/miss %" PRIu64 "/%" PRIu64 ")",
+                 psoStats.LivePipelineStates, psoStats.Hits, psoStats.Misses);
+        RHICmdList->RHIDrawText(buffer, FVector2D(startX, yPos), fontSize, statColor);
+        yPos += lineHeight;
+    }
 }
 
 const FRTPoolStats* FRenderer::GetRTPoolStats() const
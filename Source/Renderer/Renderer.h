@@ -1,10 +1,16 @@
 #pragma once
 
 #include "../RHI/RHI.h"
+#include "../RHI/RHICommandRecorder.h"
+#include "../RHI/RHIStateCache.h"
+#include "../Core/Bounds.h"
 #include "RenderStats.h"
 #include "Camera.h"
 #include "RTPool.h"
 #include "ShadowMapping.h"
+#include "GeometryBufferAllocator.h"
+#include "MeshDrawCommand.h"
+#include <atomic>
 #include <memory>
 
 // Render commands that can be enqueued from game thread
@@ -15,52 +21,117 @@ public:
     virtual void Execute(FRHICommandList* RHICmdList) = 0;
 };
 
-// Forward declaration - FTransform is defined in Scene/ScenePrimitive.h
+// Forward declarations - FTransform is defined in Scene/ScenePrimitive.h, FMaterial in Lighting/Light.h
 struct FTransform;
+struct FMaterial;
+struct FOccluderMesh;
 
 // Scene proxy - represents renderable object
 class FSceneProxy 
 {
 public:
-    FSceneProxy() : bCastShadow(true) {}  // Default to casting shadows
+    FSceneProxy() : bCastShadow(true), RenderStateVersion(0), bMeshDrawCommandsCached(false), MeshKey(0), bHasBounds(false), bOccluder(false), OccluderMesh(nullptr) {}  // Default to casting shadows
     virtual ~FSceneProxy() = default;
-    virtual void Render(FRHICommandList* RHICmdList) = 0;
+    
+    // Draw straight onto RHICmdList; only called for proxies that do not provide mesh draw commands
+    virtual void Render(FRHICommandList* /*RHICmdList*/) {}
     virtual uint32 GetTriangleCount() const = 0;
     
-    // Shadow pass rendering - renders with light's view-projection matrix
-    // Default implementation does nothing - override for shadow-casting objects
+    // Add this proxy's draws for Pass to DrawList. The render scene calls this once when the
+    // proxy enters its cached draw lists (or after InvalidateMeshDrawCommands), so fill in
+    // the state that only changes with the mesh, material or shader, and set Proxy on the
+    // commands that need UpdateMeshDrawCommand every frame. Commands without a pipeline
+    // state draw with the one the pass has set. Commands that can be drawn as instances set
+    // InstancedPipelineState and an InstancingKey covering mesh and material; the render
+    // scene merges equal ones and the first proxy's UpdateMeshDrawCommand then patches the
+    // instanced command (see FMeshDrawCommand). Return true with nothing added for passes
+    // the proxy does not draw in; false if the proxy does not support mesh draw commands,
+    // in which case Render() / RenderShadow() are called every frame instead
+    virtual bool AddMeshDrawCommands(EMeshPass /*Pass*/, FMeshDrawCommandList& /*DrawList*/) { return false; }
+    
+    // Patch a cached command's per-frame data (transforms, transient constants) just before
+    // it is submitted. Context holds what every draw of the pass shares this frame
+    virtual void UpdateMeshDrawCommand(EMeshPass /*Pass*/, FMeshDrawCommand& /*Command*/, const FMeshDrawContext& /*Context*/) {}
+    
+    // Shadow pass rendering for proxies without mesh draw commands
     // @param RHICmdList - Command list to record draw commands
     // @param LightViewProj - Light's view-projection matrix
     // @param ShadowMVPBuffer - Optional separate constant buffer for shadow MVP (avoids GPU race with main pass)
-    virtual void RenderShadow(FRHICommandList* RHICmdList, const FMatrix4x4& LightViewProj, FRHIBuffer* ShadowMVPBuffer = nullptr) {}
+    virtual void RenderShadow(FRHICommandList* /*RHICmdList*/, const FMatrix4x4& /*LightViewProj*/, FRHIBuffer* /*ShadowMVPBuffer*/ = nullptr) {}
     
     // Update transform - default implementation does nothing
     // Derived classes should override this to handle transform updates
-    virtual void UpdateTransform(const FTransform& InTransform) {}
+    virtual void UpdateTransform(const FTransform& /*InTransform*/) {}
+    
+    // Update material - default implementation does nothing (e.g. unlit proxies)
+    virtual void UpdateMaterial(const FMaterial& /*InMaterial*/) {}
     
-    // Get model matrix for shadow calculations
+    // Get model matrix for shadow calculations and instance data
     virtual FMatrix4x4 GetModelMatrix() const { return FMatrix4x4::Identity(); }
     
+    // Content identity of the proxy's mesh (how it was generated); proxies with equal non-zero
+    // keys draw identical geometry and may be drawn as instances of one another. 0 = unique
+    void SetMeshKey(uint64 InMeshKey) { MeshKey = InMeshKey; }
+    uint64 GetMeshKey() const { return MeshKey; }
+    
+    // Mesh-space bounds; the world bounds follow the model matrix through UpdateBounds().
+    // Proxies without bounds are never culled
+    void SetLocalBounds(const FBoxSphereBounds& InLocalBounds) { LocalBounds = InLocalBounds; bHasBounds = true; UpdateBounds(); }
+    bool HasBounds() const { return bHasBounds; }
+    const FBoxSphereBounds& GetBounds() const { return Bounds; }  // World space
+    
+    // Recompute the world bounds from GetModelMatrix(); call after the model matrix changes
+    void UpdateBounds() { if (bHasBounds) { Bounds = LocalBounds.TransformBy(GetModelMatrix()); } }
+    
+    // Occluders are rasterized into the render scene's software depth buffer before the base
+    // pass, to hide proxies behind them. Only proxies with an occluder mesh (mesh space, owned
+    // by the mesh registry) can occlude
+    void SetOccluder(bool bInOccluder) { bOccluder = bInOccluder; }
+    bool IsOccluder() const { return bOccluder && OccluderMesh != nullptr; }
+    void SetOccluderMesh(const FOccluderMesh* InOccluderMesh) { OccluderMesh = InOccluderMesh; }
+    const FOccluderMesh* GetOccluderMesh() const { return OccluderMesh; }
+    
     // Shadow casting property
     void SetCastShadow(bool bCast) { bCastShadow = bCast; }
     bool GetCastShadow() const { return bCastShadow; }
+    
+    // Version of the primitive render state last applied from a scene snapshot (render thread)
+    void SetRenderStateVersion(uint32 InVersion) { RenderStateVersion = InVersion; }
+    uint32 GetRenderStateVersion() const { return RenderStateVersion; }
+    
+    // Whether the render scene's cached draw lists hold commands built from this proxy's
+    // current mesh, material and shader (render thread)
+    void SetMeshDrawCommandsCached(bool bCached) { bMeshDrawCommandsCached = bCached; }
+    bool AreMeshDrawCommandsCached() const { return bMeshDrawCommandsCached; }
+    
+    // Rebuild this proxy's cached commands; call after changing what AddMeshDrawCommands fills in.
+    // Picked up when the render scene applies the next scene snapshot
+    void InvalidateMeshDrawCommands() { bMeshDrawCommandsCached = false; }
 
 protected:
     bool bCastShadow;  // Whether this proxy casts shadows
+    uint32 RenderStateVersion;
+    bool bMeshDrawCommandsCached;
+    uint64 MeshKey;
+    bool bHasBounds;
+    FBoxSphereBounds LocalBounds;
+    FBoxSphereBounds Bounds;
+    bool bOccluder;
+    const FOccluderMesh* OccluderMesh;
 };
 
 // Triangle mesh scene proxy
 class FTriangleMeshProxy : public FSceneProxy 
 {
 public:
-    FTriangleMeshProxy(FRHIBuffer* InVertexBuffer, FRHIPipelineState* InPSO, uint32 InVertexCount);
+    FTriangleMeshProxy(FGeometryAllocation* InVertices, FRHIPipelineState* InPSO, uint32 InVertexCount);
     virtual ~FTriangleMeshProxy() override;
     
-    virtual void Render(FRHICommandList* RHICmdList) override;
+    virtual bool AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList) override;
     virtual uint32 GetTriangleCount() const override;
     
 private:
-    FRHIBuffer* VertexBuffer;
+    FGeometryAllocation* Vertices;     // Range in a shared vertex buffer
     FRHIPipelineState* PipelineState;
     uint32 VertexCount;
 };
@@ -69,23 +140,24 @@ private:
 class FCubeMeshProxy : public FSceneProxy 
 {
 public:
-    FCubeMeshProxy(FRHIBuffer* InVertexBuffer, FRHIBuffer* InIndexBuffer, FRHIBuffer* InConstantBuffer,
-                   FRHIPipelineState* InPSO, uint32 InIndexCount, FCamera* InCamera);
+    FCubeMeshProxy(FGeometryAllocation* InVertices, FGeometryAllocation* InIndices,
+                   FRHIPipelineState* InPSO, uint32 InIndexCount, FCamera* InCamera, FRHI* InRHI);
     virtual ~FCubeMeshProxy() override;
     
-    virtual void Render(FRHICommandList* RHICmdList) override;
+    virtual bool AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList) override;
+    virtual void UpdateMeshDrawCommand(EMeshPass Pass, FMeshDrawCommand& Command, const FMeshDrawContext& Context) override;
     virtual uint32 GetTriangleCount() const override;
     
     void UpdateModelMatrix(const FMatrix4x4& InModelMatrix);
     
 private:
-    FRHIBuffer* VertexBuffer;
-    FRHIBuffer* IndexBuffer;
-    FRHIBuffer* ConstantBuffer;
+    FGeometryAllocation* Vertices;     // Range in a shared vertex buffer
+    FGeometryAllocation* Indices;      // Range in a shared index buffer
     FRHIPipelineState* PipelineState;
     uint32 IndexCount;
     FCamera* Camera;
     FMatrix4x4 ModelMatrix;
+    FRHI* RHI;
 };
 
 // Forward declarations
@@ -102,8 +174,40 @@ public:
     void Initialize();
     void Shutdown();
     
+    // Build all pipeline states asynchronously in Initialize (default on); call before Initialize
+    void SetPrecachePipelineStates(bool bEnable) { bPrecachePipelineStates = bEnable; }
+    
+    // Sort the mesh draw commands of every pass by state before submitting them (default on)
+    void SetSortMeshDrawCommands(bool bEnable);
+    
+    // Draw primitives that share mesh and material as one instanced draw (default on)
+    void SetInstancedDraws(bool bEnable);
+    
+    // Skip base pass draws of primitives outside the camera frustum (default on)
+    void SetFrustumCulling(bool bEnable);
+    
+    // Skip base pass draws of primitives hidden behind occluder primitives (default on)
+    void SetOcclusionCulling(bool bEnable);
+    
+    // Skip shadow draws of casters outside each light view or a point light's radius (default on)
+    void SetShadowCulling(bool bEnable);
+    
     // Called from game thread to render a frame
-    void RenderFrame();
+    // Records straight into the RHI command list and presents (single-threaded path)
+    // FrameId comes from the stats' latency tracker (0 = frame not tracked)
+    void RenderFrame(uint64 FrameId = 0);
+    
+    // Frame pipelining - the render thread records a frame into the next
+    // per-frame recorder, the RHI thread later replays it and presents.
+    // Recorders form a ring of MaxFramesInFlight slots; RecordFrame blocks
+    // if the slot it needs has not been replayed yet.
+    static constexpr uint32 MaxFramesInFlight = 4;
+    
+    // Render thread: record one frame, returns the recorder to hand to the RHI thread
+    FRHICommandRecorder* RecordFrame(uint64 FrameId = 0);
+    
+    // RHI thread: replay a recorded frame onto the RHI command list and release its slot
+    void ExecuteRecordedFrame(FRHICommandRecorder* Recorder);
     
     // Update render scene from game scene (sync point)
     void UpdateFromScene(FScene* GameScene);
@@ -122,11 +226,20 @@ public:
     // Get shadow system
     FShadowSystem* GetShadowSystem() { return ShadowSystem.get(); }
     
+    // Render-thread scene (cached draw lists, applied snapshot)
+    const FRenderScene* GetRenderScene() const { return RenderScene.get(); }
+    
     // Get RT pool statistics
     const FRTPoolStats* GetRTPoolStats() const;
     uint32 GetDrawCallCount() const { return DrawCallCount; }
     
+    // Issued versus filtered state changes of the last rendered frame
+    const FRHIStateCacheStats& GetStateCacheStats() const { return StateCache.GetLastFrameStats(); }
+    
 private:
+    // Record the whole frame (shadows, scene, overlay, present) into TargetCmdList
+    void RenderFrameInternal(FRHICommandList* TargetCmdList);
+    
     void RenderStats(FRHICommandList* RHICmdList);
     void RenderShadowPasses(FRHICommandList* RHICmdList);
     
@@ -139,6 +252,23 @@ private:
     // Per-frame tracking
     uint32 DrawCallCount;
     
+    // Every frame is recorded through this, so redundant binds never reach the target list
+    FRHIStateCache StateCache;
+    
     // Scene reference for shadow pass updates
     FScene* CurrentScene;
+    
+    // Per-frame command recorders (ring) and whether each is waiting for replay
+    std::unique_ptr<FRHICommandRecorder> FrameRecorders[MaxFramesInFlight];
+    std::atomic<bool> FrameRecorderInFlight[MaxFramesInFlight];
+    uint64 FrameRecorderSnapshotSequence[MaxFramesInFlight];
+    uint64 FrameRecorderFrameId[MaxFramesInFlight];
+    uint64 RecordedFrameCount;
+    
+    bool bPrecachePipelineStates;
+    bool bSortMeshDrawCommands;
+    bool bInstancedDraws;
+    bool bFrustumCulling;
+    bool bOcclusionCulling;
+    bool bShadowCulling;
 };
@@ -2,6 +2,8 @@
 #include "../Scene/Scene.h"
 #include "../Renderer/Renderer.h"
 #include "../Renderer/RTPool.h"
+#include "../Renderer/PipelineStateCache.h"
+#include "../Renderer/MeshDrawCommand.h"
 #include <cstring>
 #include <cmath>
 
@@ -47,12 +49,12 @@ void FShadowMapPass::Shutdown()
     }
     if (ShadowPSO)
     {
-        delete ShadowPSO;
+        FPipelineStateCache::ReleasePipelineState(ShadowPSO);
         ShadowPSO = nullptr;
     }
     if (ShadowConstantBuffer)
     {
-        delete ShadowConstantBuffer;
+        RHI->DeferredRelease(ShadowConstantBuffer, sizeof(DirectX::XMMATRIX));
         ShadowConstantBuffer = nullptr;
     }
     bInitialized = false;
@@ -89,7 +91,7 @@ void FShadowMapPass::InitializeDirectional(FRHI* InRHI, uint32 InMapSize)
     
     // Create shadow pass pipeline state (depth-only rendering)
     // Use DepthOnly flag for simple depth pass without color output
-    ShadowPSO = RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::DepthOnly);
+    ShadowPSO = FPipelineStateCache::AcquirePipelineState(RHI, EPipelineFlags::DepthOnly);
     
     bInitialized = (PooledShadowTexture != nullptr && PooledShadowTexture->Texture != nullptr && ShadowPSO != nullptr);
     
@@ -135,7 +137,7 @@ void FShadowMapPass::InitializePointLight(FRHI* InRHI, uint32 FaceSize)
     
     // Create shadow pass pipeline state (depth-only rendering)
     // Use DepthOnly flag for simple depth pass without color output
-    ShadowPSO = RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::DepthOnly);
+    ShadowPSO = FPipelineStateCache::AcquirePipelineState(RHI, EPipelineFlags::DepthOnly);
     
     bInitialized = (PooledShadowTexture != nullptr && PooledShadowTexture->Texture != nullptr && ShadowPSO != nullptr);
     
@@ -326,7 +328,8 @@ void FShadowSystem::Update(FLightScene* LightScene, const FVector& SceneCenter,
     if (!LightScene) return;
     
     // Get directional light
-    auto dirLights = LightScene->GetDirectionalLights();
+    TFrameVector<FDirectionalLight*> dirLights;
+    LightScene->GetDirectionalLights(dirLights);
     if (!dirLights.empty() && dirLights[0]->IsEnabled())
     {
         CurrentDirLight = dirLights[0];
@@ -338,7 +341,8 @@ void FShadowSystem::Update(FLightScene* LightScene, const FVector& SceneCenter,
     }
     
     // Get point lights (up to 2 for shadows)
-    auto pointLights = LightScene->GetPointLights();
+    TFrameVector<FPointLight*> pointLights;
+    LightScene->GetPointLights(pointLights);
     for (int i = 0; i < 2; ++i)
     {
         if (i < static_cast<int>(pointLights.size()) && pointLights[i]->IsEnabled())
@@ -359,10 +363,37 @@ void FShadowSystem::RenderShadowPasses(FRHICommandList* RHICmdList, FRenderScene
     
     ShadowDrawCallCount = 0;
     
+    // Gather every view first (directional, then six faces per point light) so their casters
+    // are culled together, in parallel
+    FShadowCullView views[1 + 2 * 6];
+    uint32 numViews = 0;
+    bool bDirectional = CurrentDirLight && DirectionalShadowPass.IsInitialized();
+    uint32 dirViewIndex = numViews;
+    if (bDirectional)
+    {
+        views[numViews++].ViewProjection = DirectionalShadowPass.GetViewProjectionMatrix();
+    }
+    uint32 pointViewIndices[2] = { 0, 0 };
+    for (int i = 0; i < 2; ++i)
+    {
+        if (CurrentPointLights[i] && PointLightShadowPasses[i].IsInitialized())
+        {
+            pointViewIndices[i] = numViews;
+            for (uint32 face = 0; face < 6; ++face)
+            {
+                FShadowCullView& view = views[numViews++];
+                view.ViewProjection = PointLightShadowPasses[i].GetViewProjectionMatrix(face);
+                view.SphereCenter = CurrentPointLights[i]->GetPosition();
+                view.SphereRadius = CurrentPointLights[i]->GetRadius();
+            }
+        }
+    }
+    Scene->CullShadowViews(views, numViews);
+    
     // Render directional light shadow pass
-    if (CurrentDirLight && DirectionalShadowPass.IsInitialized())
+    if (bDirectional)
     {
-        RenderDirectionalShadowPass(RHICmdList, Scene);
+        RenderDirectionalShadowPass(RHICmdList, Scene, dirViewIndex);
     }
     
     // Render point light shadow passes
@@ -370,7 +401,7 @@ void FShadowSystem::RenderShadowPasses(FRHICommandList* RHICmdList, FRenderScene
     {
         if (CurrentPointLights[i] && PointLightShadowPasses[i].IsInitialized())
         {
-            RenderPointLightShadowPass(RHICmdList, Scene, i);
+            RenderPointLightShadowPass(RHICmdList, Scene, i, pointViewIndices[i]);
         }
     }
 }
@@ -420,6 +451,16 @@ void FShadowSystem::GetShadowConstants(FShadowConstants& OutConstants) const
     }
 }
 
+bool FShadowSystem::GetDirectionalShadowMatrix(FMatrix4x4& OutViewProj) const
+{
+    if (CurrentDirLight && DirectionalShadowPass.IsInitialized())
+    {
+        OutViewProj = DirectionalShadowPass.GetViewProjectionMatrix();
+        return true;
+    }
+    return false;
+}
+
 FRHITexture* FShadowSystem::GetDirectionalShadowMap() const
 {
     if (CurrentDirLight && DirectionalShadowPass.IsInitialized())
@@ -469,7 +510,7 @@ void FShadowSystem::SetSlopeScaledBias(float Bias)
     }
 }
 
-void FShadowSystem::RenderDirectionalShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene)
+void FShadowSystem::RenderDirectionalShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene, uint32 ViewIndex)
 {
     FRHITexture* shadowTexture = DirectionalShadowPass.GetShadowTexture();
     FRHIPipelineState* shadowPSO = DirectionalShadowPass.GetShadowPSO();
@@ -480,8 +521,6 @@ void FShadowSystem::RenderDirectionalShadowPass(FRHICommandList* RHICmdList, FRe
         return;
     }
     
-    const auto& proxies = Scene->GetProxies();
-    
     // GPU Event: Directional Shadow Pass
     RHICmdList->BeginEvent("Shadow: Directional Light");
     
@@ -492,23 +531,13 @@ void FShadowSystem::RenderDirectionalShadowPass(FRHICommandList* RHICmdList, FRe
     uint32 mapSize = DirectionalShadowPass.GetMapSize();
     RHICmdList->SetViewport(0.0f, 0.0f, static_cast<float>(mapSize), static_cast<float>(mapSize));
     
-    // Set shadow PSO (depth-only rendering)
-    RHICmdList->SetPipelineState(shadowPSO);
-    
     // Get light view-projection matrix (calculated from light direction)
     FMatrix4x4 lightVP = DirectionalShadowPass.GetViewProjectionMatrix();
     
     // Render each proxy with shadow pass (only if it casts shadows)
-    // Note: Each proxy uses its own MVPConstantBuffer. Caller must flush after
-    // shadow pass to ensure GPU reads shadow data before main pass overwrites it.
-    for (FSceneProxy* proxy : proxies)
-    {
-        if (proxy && proxy->GetCastShadow())
-        {
-            proxy->RenderShadow(RHICmdList, lightVP, shadowMVPBuffer);
-            ShadowDrawCallCount++;
-        }
-    }
+    // Note: Caller must flush after shadow pass to ensure GPU reads shadow
+    // data before main pass overwrites it.
+    RenderShadowCasters(RHICmdList, Scene, lightVP, shadowPSO, shadowMVPBuffer, ViewIndex);
     
     // End shadow pass - restores main render target
     RHICmdList->EndShadowPass();
@@ -516,7 +545,7 @@ void FShadowSystem::RenderDirectionalShadowPass(FRHICommandList* RHICmdList, FRe
     RHICmdList->EndEvent();  // End "Shadow: Directional Light"
 }
 
-void FShadowSystem::RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene, uint32 LightIndex)
+void FShadowSystem::RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene, uint32 LightIndex, uint32 FirstViewIndex)
 {
     if (LightIndex >= 2) return;
     
@@ -527,7 +556,6 @@ void FShadowSystem::RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRen
     if (!shadowTexture || !shadowPSO) return;
     
     uint32 faceSize = shadowPass.GetMapSize();
-    const auto& proxies = Scene->GetProxies();
     
     // Atlas layout: 3x2 grid
     static const uint32 ATLAS_COLS = 3;
@@ -540,9 +568,6 @@ void FShadowSystem::RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRen
     // NOTE: BeginShadowPass clears the entire depth buffer once (this is correct)
     RHICmdList->BeginShadowPass(shadowTexture, 0);
     
-    // Set shadow PSO once for all faces
-    RHICmdList->SetPipelineState(shadowPSO);
-    
     // Face names for debugging
     static const char* faceNames[] = { "+X", "-X", "+Y", "-Y", "+Z", "-Z" };
     
@@ -564,15 +589,8 @@ void FShadowSystem::RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRen
         // Get face view-projection matrix
         FMatrix4x4 faceVP = shadowPass.GetViewProjectionMatrix(face);
         
-        // Render each proxy (only if it casts shadows)
-        for (FSceneProxy* proxy : proxies)
-        {
-            if (proxy && proxy->GetCastShadow())
-            {
-                proxy->RenderShadow(RHICmdList, faceVP, shadowMVPBuffer);
-                ShadowDrawCallCount++;
-            }
-        }
+        // Render each proxy (only if it casts shadows and reaches into this face)
+        RenderShadowCasters(RHICmdList, Scene, faceVP, shadowPSO, shadowMVPBuffer, FirstViewIndex + face);
         
         RHICmdList->EndEvent();  // End face event
     }
@@ -582,3 +600,17 @@ void FShadowSystem::RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRen
     
     RHICmdList->EndEvent();  // End "Shadow: Point Light X"
 }
+
+void FShadowSystem::RenderShadowCasters(FRHICommandList* RHICmdList, FRenderScene* Scene, const FMatrix4x4& LightViewProj,
+                                        FRHIPipelineState* ShadowPSO, FRHIBuffer* ShadowMVPBuffer, uint32 ViewIndex)
+{
+    // Every view starts from the depth-only PSO; casters with their own (other vertex layouts)
+    // change it, so cached commands without one bind it again
+    RHICmdList->SetPipelineState(ShadowPSO);
+    
+    FMeshDrawContext context;
+    context.RHI = RHI;
+    context.ViewProjection = LightViewProj;
+    context.PassPipelineState = ShadowPSO;
+    ShadowDrawCallCount += Scene->RenderShadowDepth(RHICmdList, context, ShadowMVPBuffer, ViewIndex);
+}
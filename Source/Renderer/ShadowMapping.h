@@ -215,12 +215,18 @@ public:
     // Update shadow maps for current frame
     void Update(FLightScene* LightScene, const FVector& SceneCenter, float SceneRadius);
     
-    // Render shadow passes (call before main scene rendering)
+    // Render shadow passes (call before main scene rendering); each view draws only the
+    // casters inside its frustum (and the point light's radius) unless the scene's shadow
+    // culling is off
     void RenderShadowPasses(FRHICommandList* RHICmdList, FRenderScene* Scene);
     
     // Get shadow constant buffer data (for binding to main shader)
     void GetShadowConstants(FShadowConstants& OutConstants) const;
     
+    // View-projection the directional shadow map is rendered with; false without a shadowed
+    // directional light
+    bool GetDirectionalShadowMatrix(FMatrix4x4& OutViewProj) const;
+    
     // Get shadow textures for binding
     FRHITexture* GetDirectionalShadowMap() const;
     FRHITexture* GetPointLightShadowAtlas(uint32 LightIndex) const;
@@ -237,8 +243,13 @@ public:
     uint32 GetShadowDrawCallCount() const { return ShadowDrawCallCount; }
     
 private:
-    void RenderDirectionalShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene);
-    void RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene, uint32 LightIndex);
+    // ViewIndex: the pass's (first) view in the scene's culled shadow views
+    void RenderDirectionalShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene, uint32 ViewIndex);
+    void RenderPointLightShadowPass(FRHICommandList* RHICmdList, FRenderScene* Scene, uint32 LightIndex, uint32 FirstViewIndex);
+    
+    // Draw the shadow casters of Scene's view ViewIndex with LightViewProj and ShadowPSO (the pass's depth-only PSO)
+    void RenderShadowCasters(FRHICommandList* RHICmdList, FRenderScene* Scene, const FMatrix4x4& LightViewProj,
+                             FRHIPipelineState* ShadowPSO, FRHIBuffer* ShadowMVPBuffer, uint32 ViewIndex);
     
     FRHI* RHI;
     bool bInitialized;
@@ -194,6 +194,16 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                     case 'D': g_InputState.bKeyD = true; return 0;
                     case 'Q': g_InputState.bKeyQ = true; return 0;
                     case 'E': g_InputState.bKeyE = true; return 0;
+                    
+                    // 1/2/3: frame lead between game and RHI threads
+                    case '1':
+                    case '2':
+                    case '3':
+                        if (g_Game)
+                        {
+                            g_Game->SetFrameLead(static_cast<uint32>(wParam - '0'));
+                        }
+                        return 0;
                 }
                 return 0;
             }
@@ -1,305 +1,219 @@
 #include "LitSceneProxy.h"
 #include "ScenePrimitive.h"
+#include "../Renderer/PipelineStateCache.h"
 #include <cstring>
-#include <cmath>
 
 // FPrimitiveSceneProxy implementation (lit rendering with Phong shading)
 FPrimitiveSceneProxy::FPrimitiveSceneProxy(
-    FRHIBuffer* InVertexBuffer,
-    FRHIBuffer* InIndexBuffer,
-    FRHIBuffer* InMVPConstantBuffer,
-    FRHIBuffer* InLightingConstantBuffer,
+    FSharedMesh* InMesh,
     FRHIPipelineState* InPSO,
-    uint32 InIndexCount,
     FCamera* InCamera,
     const FTransform& InTransform,
     FLightScene* InLightScene,
     const FMaterial& InMaterial,
     FRHI* InRHI)
-    : VertexBuffer(InVertexBuffer)
-    , IndexBuffer(InIndexBuffer)
-    , MVPConstantBuffer(InMVPConstantBuffer)
-    , LightingConstantBuffer(InLightingConstantBuffer)
-    , ShadowConstantBuffer(nullptr)
+    : Mesh(InMesh)
     , PipelineState(InPSO)
-    , IndexCount(InIndexCount)
+    , InstancedPipelineState(nullptr)
+    , InstancedShadowPipelineState(nullptr)
     , Camera(InCamera)
     , ModelMatrix(InTransform.GetMatrix())
+    , LightingModelMatrix(DirectX::XMMatrixTranspose(ModelMatrix.Matrix))
     , LightScene(InLightScene)
     , Material(InMaterial)
     , RHI(InRHI)
-    , ShadowMapTexture(nullptr)
 {
-    // Create shadow constant buffer if RHI is available
-    if (RHI)
-    {
-        ShadowConstantBuffer = RHI->CreateConstantBuffer(256);  // 256-byte aligned
-        // Enable shadows by default for directional light
-        ShadowData.SetEnabled(true);
-        ShadowData.SetStrength(0.5f);  // 50% shadow strength for visible effect
-    }
+    MaterialData.Set(Material);
+    SetMeshKey(Mesh->Hash);
+    SetLocalBounds(Mesh->Bounds);
+    SetOccluderMesh(Mesh->Occluder.IsValid() ? &Mesh->Occluder : nullptr);
+    
+    // Enable shadows by default for directional light
+    ShadowData.SetEnabled(true);
+    ShadowData.SetStrength(0.5f);  // 50% shadow strength for visible effect
 }
 
 FPrimitiveSceneProxy::~FPrimitiveSceneProxy()
 {
-    delete VertexBuffer;
-    delete IndexBuffer;
-    delete MVPConstantBuffer;
-    delete LightingConstantBuffer;
-    if (ShadowConstantBuffer)
-    {
-        delete ShadowConstantBuffer;
-    }
-    delete PipelineState;
+    FMeshRegistry::ReleaseMesh(Mesh);
+    FPipelineStateCache::ReleasePipelineState(PipelineState);
+    FPipelineStateCache::ReleasePipelineState(InstancedPipelineState);
+    FPipelineStateCache::ReleasePipelineState(InstancedShadowPipelineState);
 }
 
-void FPrimitiveSceneProxy::UpdateLightingConstants()
+bool FPrimitiveSceneProxy::AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList)
 {
-    // Set model matrix
-    LightingData.SetModelMatrix(ModelMatrix);
-    
-    // Set camera position
-    LightingData.SetCameraPosition(Camera->GetPosition());
+    FMeshDrawCommand command;
+    command.Proxy = this;
+    command.VertexBuffer = Mesh->Vertices->Buffer;
+    command.VertexStride = sizeof(FLitVertex);
+    command.IndexBuffer = Mesh->Indices->Buffer;
+    command.NumElements = Mesh->GetNumIndices();
+    command.FirstElement = Mesh->Indices->First;
+    command.BaseVertex = Mesh->Vertices->First;
     
-    // Set material
-    LightingData.SetMaterial(Material);
-    
-    // Set lights from light scene
-    if (LightScene)
+    // No pipeline state in the shadow pass: the pass's depth-only PSO is used
+    if (Pass == EMeshPass::BasePass)
     {
-        LightingData.SetAmbientLight(LightScene->GetAmbientLight());
-        
-        // Get directional lights (use first one)
-        auto dirLights = LightScene->GetDirectionalLights();
-        if (!dirLights.empty())
-        {
-            LightingData.SetDirectionalLight(dirLights[0]);
-        }
-        else
-        {
-            LightingData.SetDirectionalLight(nullptr);
-        }
-        
-        // Get point lights (up to 4)
-        auto pointLights = LightScene->GetPointLights();
-        for (int i = 0; i < 4; ++i)
-        {
-            if (i < static_cast<int>(pointLights.size()))
-            {
-                LightingData.SetPointLight(i, pointLights[i]);
-            }
-            else
-            {
-                LightingData.SetPointLight(i, nullptr);
-            }
-        }
+        command.PipelineState = PipelineState;
     }
-}
-
-void FPrimitiveSceneProxy::UpdateShadowConstants()
-{
-    // Update shadow matrix from light scene
-    if (LightScene)
+    
+    // Instances share the mesh; base pass instances also share material and shadow settings
+    if (MeshKey != 0)
     {
-        auto dirLights = LightScene->GetDirectionalLights();
-        if (!dirLights.empty() && dirLights[0]->IsEnabled())
+        uint64 key = FMeshDrawCommand::HashInstancingData(FMeshDrawCommand::InstancingHashSeed, &MeshKey, sizeof(MeshKey));
+        if (Pass == EMeshPass::BasePass)
         {
-            // Calculate a simple directional light view-projection matrix
-            FVector lightDir = dirLights[0]->GetDirection();
-            
-            // Normalize and create light view
-            DirectX::XMVECTOR lightDirVec = DirectX::XMVector3Normalize(
-                DirectX::XMVectorSet(lightDir.X, lightDir.Y, lightDir.Z, 0.0f));
-            
-            // Light position far behind scene
-            DirectX::XMVECTOR lightPos = DirectX::XMVectorScale(
-                DirectX::XMVectorNegate(lightDirVec), 50.0f);
-            
-            // Up vector
-            DirectX::XMVECTOR upVec = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-            float dotUp = std::abs(DirectX::XMVectorGetX(DirectX::XMVector3Dot(lightDirVec, upVec)));
-            if (dotUp > 0.99f)
+            if (!InstancedPipelineState)
             {
-                upVec = DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+                InstancedPipelineState = FPipelineStateCache::AcquirePipelineState(RHI,
+                    EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting | EPipelineFlags::Instanced);
             }
-            
-            // View and projection
-            DirectX::XMMATRIX viewMatrix = DirectX::XMMatrixLookAtLH(
-                lightPos, 
-                DirectX::XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), 
-                upVec);
-            DirectX::XMMATRIX projMatrix = DirectX::XMMatrixOrthographicLH(40.0f, 40.0f, 0.1f, 100.0f);
-            
-            // Transpose for HLSL
-            ShadowData.DirLightViewProj = DirectX::XMMatrixTranspose(
-                DirectX::XMMatrixMultiply(viewMatrix, projMatrix));
-            ShadowData.SetEnabled(true);
+            key = FMeshDrawCommand::HashInstancingData(key, &MaterialData, sizeof(MaterialData));
+            key = FMeshDrawCommand::HashInstancingData(key, &ShadowData.ShadowParams, sizeof(ShadowData.ShadowParams));
+            command.InstancedPipelineState = InstancedPipelineState;
         }
         else
         {
-            ShadowData.SetEnabled(false);
+            if (!InstancedShadowPipelineState)
+            {
+                InstancedShadowPipelineState = FPipelineStateCache::AcquirePipelineState(RHI,
+                    EPipelineFlags::DepthOnly | EPipelineFlags::Instanced);
+            }
+            command.InstancedPipelineState = InstancedShadowPipelineState;
         }
+        command.InstancingKey = key;
     }
+    DrawList.AddCommand(command);
+    return true;
 }
 
-void FPrimitiveSceneProxy::Render(FRHICommandList* RHICmdList)
+void FPrimitiveSceneProxy::UpdateMeshDrawCommand(EMeshPass Pass, FMeshDrawCommand& Command, const FMeshDrawContext& Context)
 {
-    // Calculate MVP matrix
-    FMatrix4x4 viewProjection = Camera->GetViewProjectionMatrix();
-    FMatrix4x4 mvp = ModelMatrix * viewProjection;
-    
-    // Transpose for HLSL (column-major)
-    FMatrix4x4 mvpTransposed = mvp.Transpose();
+    // MVP for the pass's view (camera or light), transposed for HLSL (column-major).
+    // Instanced draws take the world matrix from the instance stream, so only the view goes in
+    FMatrix4x4 mvpTransposed = (Command.IsInstanced() ? Context.ViewProjection : ModelMatrix * Context.ViewProjection).Transpose();
     
-    // Update MVP constant buffer
-    void* mvpData = MVPConstantBuffer->Map();
-    memcpy(mvpData, &mvpTransposed.Matrix, sizeof(DirectX::XMMATRIX));
-    MVPConstantBuffer->Unmap();
-    
-    // Update lighting constant buffer
-    UpdateLightingConstants();
-    void* lightData = LightingConstantBuffer->Map();
-    memcpy(lightData, &LightingData, sizeof(FLightingConstants));
-    LightingConstantBuffer->Unmap();
-    
-    // Update shadow constant buffer
-    if (ShadowConstantBuffer)
+    if (Pass == EMeshPass::ShadowDepth)
     {
-        UpdateShadowConstants();
-        void* shadowData = ShadowConstantBuffer->Map();
-        memcpy(shadowData, &ShadowData, sizeof(FShadowRenderConstants));
-        ShadowConstantBuffer->Unmap();
+        // IMPORTANT: Use root constants for shadow pass MVP matrix
+        // The command copies the matrix, avoiding the constant buffer synchronization
+        // issue where all draws would see the same (last) matrix value.
+        // 16 floats = 16 DWORDs = sizeof(XMMATRIX) / sizeof(float)
+        Command.SetRootConstants(&mvpTransposed.Matrix, 16);
+        return;
     }
     
-    // Set render state and draw
-    RHICmdList->SetPipelineState(PipelineState);
-    RHICmdList->SetConstantBuffer(MVPConstantBuffer, 0);      // b0 = MVP
-    RHICmdList->SetConstantBuffer(LightingConstantBuffer, 1); // b1 = Lighting
-    if (ShadowConstantBuffer)
-    {
-        RHICmdList->SetConstantBuffer(ShadowConstantBuffer, 2);  // b2 = Shadow
-    }
-    // Bind shadow map texture AFTER pipeline state is set (root signature must be active)
-    if (ShadowMapTexture)
-    {
-        RHICmdList->SetShadowMapTexture(ShadowMapTexture);
-    }
-    RHICmdList->SetVertexBuffer(VertexBuffer, 0, sizeof(FLitVertex));
-    RHICmdList->SetIndexBuffer(IndexBuffer);
-    RHICmdList->DrawIndexedPrimitive(IndexCount, 0, 0);
-}
-
-void FPrimitiveSceneProxy::RenderShadow(FRHICommandList* RHICmdList, const FMatrix4x4& LightViewProj, FRHIBuffer* ShadowMVPBuffer)
-{
-    // IMPORTANT: Use SetRootConstants for shadow pass MVP matrix
-    // This copies the matrix data at command record time, avoiding the constant buffer
-    // synchronization issue where all draws would see the same (last) matrix value.
-    (void)ShadowMVPBuffer;  // Unused - using root constants instead
-    
-    // Calculate shadow MVP matrix: Model * LightViewProj
-    FMatrix4x4 shadowMVP = ModelMatrix * LightViewProj;
-    
-    // Transpose for HLSL (column-major)
-    FMatrix4x4 shadowMVPTransposed = shadowMVP.Transpose();
+    // Only what differs per draw goes into a transient slice; lights and the shadow matrix
+    // are the view constants every lit draw shares
+    FPrimitiveUniformParameters primitiveData;
+    primitiveData.MVP = mvpTransposed.Matrix;
+    primitiveData.ModelMatrix = LightingModelMatrix;
+    primitiveData.Material = MaterialData;
+    primitiveData.ShadowParams = ShadowData.ShadowParams;
+    Command.ConstantBuffers[0] = RHI->UploadTransientConstants(&primitiveData, sizeof(FPrimitiveUniformParameters));  // b0 = Primitive
+    Command.ConstantBuffers[1] = Context.ViewUniformBuffer;                                                          // b1 = View
     
-    // Set MVP using root constants - this copies data at record time!
-    // 16 floats = 16 DWORDs = sizeof(XMMATRIX) / sizeof(float)
-    RHICmdList->SetRootConstants(0, 16, &shadowMVPTransposed.Matrix, 0);
-    
-    // Set vertex and index buffers, then draw
-    RHICmdList->SetVertexBuffer(VertexBuffer, 0, sizeof(FLitVertex));
-    RHICmdList->SetIndexBuffer(IndexBuffer);
-    RHICmdList->DrawIndexedPrimitive(IndexCount, 0, 0);
+    // The shadow map is bound after the pipeline state (root signature must be active)
+    Command.ShadowMapTexture = Context.ShadowMapTexture;
 }
 
 uint32 FPrimitiveSceneProxy::GetTriangleCount() const
 {
-    return IndexCount / 3;
+    return Mesh->GetNumIndices() / 3;
 }
 
 void FPrimitiveSceneProxy::UpdateTransform(const FTransform& InTransform)
 {
     ModelMatrix = InTransform.GetMatrix();
+    
+    // DirectXMath uses row-major storage, HLSL uses column-major by default
+    LightingModelMatrix = DirectX::XMMatrixTranspose(ModelMatrix.Matrix);
+    UpdateBounds();
 }
 
-void FPrimitiveSceneProxy::SetShadowMatrix(const FMatrix4x4& LightViewProj)
-{
-    ShadowData.DirLightViewProj = DirectX::XMMatrixTranspose(LightViewProj.Matrix);
-}
-
-void FPrimitiveSceneProxy::SetShadowEnabled(bool bEnabled)
+void FPrimitiveSceneProxy::UpdateMaterial(const FMaterial& InMaterial)
 {
-    ShadowData.SetEnabled(bEnabled);
+    FMaterialConstants previousMaterialData = MaterialData;
+    Material = InMaterial;
+    MaterialData.Set(Material);
+    
+    // The material is part of the instancing key, so a change may move this proxy to another batch
+    if (memcmp(&previousMaterialData, &MaterialData, sizeof(FMaterialConstants)) != 0)
+    {
+        InvalidateMeshDrawCommands();
+    }
 }
 
 void FPrimitiveSceneProxy::SetShadowBias(float Bias)
 {
     ShadowData.SetBias(Bias);
+    InvalidateMeshDrawCommands();
 }
 
 void FPrimitiveSceneProxy::SetShadowStrength(float Strength)
 {
     ShadowData.SetStrength(Strength);
+    InvalidateMeshDrawCommands();
 }
 
 // FLightVisualizationProxy implementation
 FLightVisualizationProxy::FLightVisualizationProxy(
-    FRHIBuffer* InVertexBuffer,
-    FRHIBuffer* InIndexBuffer,
-    FRHIBuffer* InConstantBuffer,
+    FGeometryAllocation* InVertices,
+    FGeometryAllocation* InIndices,
     FRHIPipelineState* InPSO,
     uint32 InIndexCount,
     FCamera* InCamera,
     const FVector& InPosition,
+    FRHI* InRHI,
     bool bIsLineList)
-    : VertexBuffer(InVertexBuffer)
-    , IndexBuffer(InIndexBuffer)
-    , ConstantBuffer(InConstantBuffer)
+    : Vertices(InVertices)
+    , Indices(InIndices)
     , PipelineState(InPSO)
     , IndexCount(InIndexCount)
     , Camera(InCamera)
     , Position(InPosition)
+    , RHI(InRHI)
     , bLineList(bIsLineList)
 {
 }
 
 FLightVisualizationProxy::~FLightVisualizationProxy()
 {
-    delete VertexBuffer;
-    delete IndexBuffer;
-    delete ConstantBuffer;
-    delete PipelineState;
+    FGeometryBufferAllocator::FreeGeometry(Vertices);
+    FGeometryBufferAllocator::FreeGeometry(Indices);
+    FPipelineStateCache::ReleasePipelineState(PipelineState);
 }
 
-void FLightVisualizationProxy::Render(FRHICommandList* RHICmdList)
+bool FLightVisualizationProxy::AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList)
 {
-    // Calculate MVP matrix with position as translation
-    FMatrix4x4 modelMatrix = FMatrix4x4::Translation(Position.X, Position.Y, Position.Z);
-    FMatrix4x4 viewProjection = Camera->GetViewProjectionMatrix();
-    FMatrix4x4 mvp = modelMatrix * viewProjection;
-    
-    // Transpose for HLSL
-    FMatrix4x4 mvpTransposed = mvp.Transpose();
-    
-    // Update constant buffer
-    void* cbData = ConstantBuffer->Map();
-    memcpy(cbData, &mvpTransposed.Matrix, sizeof(DirectX::XMMATRIX));
-    ConstantBuffer->Unmap();
-    
-    // Set render state and draw
-    RHICmdList->SetPipelineState(PipelineState);
-    RHICmdList->SetConstantBuffer(ConstantBuffer, 0);
-    RHICmdList->SetVertexBuffer(VertexBuffer, 0, sizeof(FVertex));
-    RHICmdList->SetIndexBuffer(IndexBuffer);
-    
-    if (bLineList)
+    // Debug visualization does not cast shadows
+    if (Pass != EMeshPass::BasePass)
     {
-        RHICmdList->DrawIndexedLines(IndexCount, 0, 0);
-    }
-    else
-    {
-        RHICmdList->DrawIndexedPrimitive(IndexCount, 0, 0);
+        return true;
     }
+    
+    // Render state and draw; the MVP is patched in every frame
+    FMeshDrawCommand command;
+    command.Proxy = this;
+    command.PipelineState = PipelineState;
+    command.VertexBuffer = Vertices->Buffer;
+    command.VertexStride = sizeof(FVertex);
+    command.IndexBuffer = Indices->Buffer;
+    command.DrawType = bLineList ? EMeshDrawType::IndexedLines : EMeshDrawType::Indexed;
+    command.NumElements = IndexCount;
+    command.FirstElement = Indices->First;
+    command.BaseVertex = Vertices->First;
+    DrawList.AddCommand(command);
+    return true;
+}
+
+void FLightVisualizationProxy::UpdateMeshDrawCommand(EMeshPass /*Pass*/, FMeshDrawCommand& Command, const FMeshDrawContext& Context)
+{
+    // MVP with position as translation, transposed for HLSL
+    FMatrix4x4 modelMatrix = FMatrix4x4::Translation(Position.X, Position.Y, Position.Z);
+    FMatrix4x4 mvpTransposed = (modelMatrix * Context.ViewProjection).Transpose();
+    Command.ConstantBuffers[0] = RHI->UploadTransientConstants(&mvpTransposed.Matrix, sizeof(DirectX::XMMATRIX));
 }
 
 uint32 FLightVisualizationProxy::GetTriangleCount() const
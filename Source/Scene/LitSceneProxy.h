@@ -3,6 +3,7 @@
 #include "../RHI/RHI.h"
 #include "../Renderer/Camera.h"
 #include "../Renderer/Renderer.h"
+#include "../Renderer/MeshRegistry.h"
 #include "../Lighting/Light.h"
 #include "../Lighting/LightingConstants.h"
 #include "../Core/CoreTypes.h"
@@ -11,18 +12,15 @@
 // FTransform is defined in ScenePrimitive.h (included above)
 
 /**
- * FShadowRenderConstants - Simple shadow constant buffer data
- * Used for passing shadow matrix and parameters to shader
+ * FShadowRenderConstants - How a primitive receives the directional shadow
+ * Packed into its FPrimitiveUniformParameters; the shadow matrix is per view
  */
 struct FShadowRenderConstants
 {
-    DirectX::XMMATRIX DirLightViewProj;  // 64 bytes
     DirectX::XMFLOAT4 ShadowParams;       // 16 bytes - x=bias, y=enabled, z=strength, w=unused
-    // Total: 80 bytes, padded to 256 for constant buffer alignment
     
     FShadowRenderConstants()
     {
-        DirLightViewProj = DirectX::XMMatrixIdentity();
         ShadowParams = { 0.001f, 0.0f, 1.0f, 0.0f };  // Disabled by default
     }
     
@@ -44,74 +42,59 @@ struct FShadowRenderConstants
 
 /**
  * FPrimitiveSceneProxy - Default scene proxy for lit primitives with Phong shading
- * Uses FLitVertex format (position, normal, color) and lighting constant buffer
+ * Uses FLitVertex format (position, normal, color); per-draw constants hold only
+ * the transforms, material and shadow settings, lighting comes from the view constants
  * This is the primary proxy type for scene rendering with lighting support
  */
 class FPrimitiveSceneProxy : public FSceneProxy 
 {
 public:
     FPrimitiveSceneProxy(
-        FRHIBuffer* InVertexBuffer, 
-        FRHIBuffer* InIndexBuffer, 
-        FRHIBuffer* InMVPConstantBuffer,
-        FRHIBuffer* InLightingConstantBuffer,
+        FSharedMesh* InMesh,
         FRHIPipelineState* InPSO,
-        uint32 InIndexCount, 
         FCamera* InCamera, 
         const FTransform& InTransform,
         FLightScene* InLightScene,
         const FMaterial& InMaterial,
-        FRHI* InRHI = nullptr);
+        FRHI* InRHI);
     
     virtual ~FPrimitiveSceneProxy();
     
-    // Render this proxy (override from FSceneProxy)
-    virtual void Render(FRHICommandList* RHICmdList) override;
-    
-    // Shadow pass rendering - renders depth-only with light's view-projection
-    // @param ShadowMVPBuffer - Separate buffer for shadow MVP to avoid GPU race condition
-    virtual void RenderShadow(FRHICommandList* RHICmdList, const FMatrix4x4& LightViewProj, FRHIBuffer* ShadowMVPBuffer = nullptr) override;
+    // Cached draws: lit base pass, and depth-only shadow pass with the light-space MVP in root constants.
+    // With a mesh key, both can be drawn as instances of proxies with the same mesh and material
+    virtual bool AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList) override;
+    virtual void UpdateMeshDrawCommand(EMeshPass Pass, FMeshDrawCommand& Command, const FMeshDrawContext& Context) override;
     
     // Get triangle count (override from FSceneProxy)
     virtual uint32 GetTriangleCount() const override;
     
-    // Update transform
+    // Update transform / material (render thread, from the scene snapshot)
     virtual void UpdateTransform(const FTransform& InTransform) override;
+    virtual void UpdateMaterial(const FMaterial& InMaterial) override;
     
-    // Get model matrix for shadow calculations
+    // Get model matrix for shadow calculations and instance data
     virtual FMatrix4x4 GetModelMatrix() const override { return ModelMatrix; }
     
     // Update material
-    void SetMaterial(const FMaterial& InMaterial) { Material = InMaterial; }
+    void SetMaterial(const FMaterial& InMaterial) { UpdateMaterial(InMaterial); }
     
-    // Update shadow constants from shadow system
-    void SetShadowMatrix(const FMatrix4x4& LightViewProj);
-    void SetShadowEnabled(bool bEnabled);
+    // Shadow receiving settings; the shadow matrix and map come from the frame's view constants
     void SetShadowBias(float Bias);
     void SetShadowStrength(float Strength);
     
-    // Set shadow map texture for shader sampling (called before rendering)
-    void SetShadowMapTexture(FRHITexture* InShadowMapTexture) { ShadowMapTexture = InShadowMapTexture; }
-    
 protected:
-    void UpdateLightingConstants();
-    void UpdateShadowConstants();
-    
-    FRHIBuffer* VertexBuffer;
-    FRHIBuffer* IndexBuffer;
-    FRHIBuffer* MVPConstantBuffer;
-    FRHIBuffer* LightingConstantBuffer;
-    FRHIBuffer* ShadowConstantBuffer;  // NEW: Shadow constant buffer
+    FSharedMesh* Mesh;                 // Geometry shared by every proxy of the same mesh
     FRHIPipelineState* PipelineState;
-    uint32 IndexCount;
+    FRHIPipelineState* InstancedPipelineState;          // Acquired with the first instanceable command
+    FRHIPipelineState* InstancedShadowPipelineState;
     FCamera* Camera;
     FMatrix4x4 ModelMatrix;
+    DirectX::XMMATRIX LightingModelMatrix;  // ModelMatrix transposed for HLSL, updated with the transform
     FLightScene* LightScene;
     FMaterial Material;
-    FLightingConstants LightingData;
-    FShadowRenderConstants ShadowData;  // NEW: Shadow data
-    FRHI* RHI;  // NEW: RHI reference for creating shadow buffer
-    FRHITexture* ShadowMapTexture;  // Shadow map texture for shader sampling
+    FMaterialConstants MaterialData;        // Material packed for the primitive constants
+    FShadowRenderConstants ShadowData;
+    FRHI* RHI;  // Source of the per-frame transient constants
 };
 
 /**
@@ -122,29 +105,30 @@ class FLightVisualizationProxy : public FSceneProxy
 {
 public:
     FLightVisualizationProxy(
-        FRHIBuffer* InVertexBuffer,
-        FRHIBuffer* InIndexBuffer,
-        FRHIBuffer* InConstantBuffer,
+        FGeometryAllocation* InVertices,
+        FGeometryAllocation* InIndices,
         FRHIPipelineState* InPSO,
         uint32 InIndexCount,
         FCamera* InCamera,
         const FVector& InPosition,
+        FRHI* InRHI,
         bool bIsLineList = true);
     
     virtual ~FLightVisualizationProxy();
     
-    virtual void Render(FRHICommandList* RHICmdList) override;
+    virtual bool AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList) override;
+    virtual void UpdateMeshDrawCommand(EMeshPass Pass, FMeshDrawCommand& Command, const FMeshDrawContext& Context) override;
     virtual uint32 GetTriangleCount() const override;
     
     void UpdatePosition(const FVector& InPosition);
     
 protected:
-    FRHIBuffer* VertexBuffer;
-    FRHIBuffer* IndexBuffer;
-    FRHIBuffer* ConstantBuffer;
+    FGeometryAllocation* Vertices;     // Range in a shared vertex buffer
+    FGeometryAllocation* Indices;      // Range in a shared index buffer
     FRHIPipelineState* PipelineState;
     uint32 IndexCount;
     FCamera* Camera;
     FVector Position;
+    FRHI* RHI;
     bool bLineList;
 };
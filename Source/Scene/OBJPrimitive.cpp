@@ -1,9 +1,12 @@
 #include "OBJPrimitive.h"
 #include "TexturedSceneProxy.h"
+#include "../Renderer/PipelineStateCache.h"
+#include "../Renderer/MeshRegistry.h"
 #include "../Game/GameGlobals.h"
 
 FOBJPrimitive::FOBJPrimitive(const std::string& InFilename, FRHI* InRHI)
     : Filename(InFilename)
+    , MeshContentHash(0)
     , DiffuseTexture(nullptr)
     , RHIRef(InRHI)
     , bAutoRotate(false)
@@ -18,6 +21,8 @@ FOBJPrimitive::FOBJPrimitive(const std::string& InFilename, FRHI* InRHI)
         FLog::Log(ELogLevel::Error, "Failed to load OBJ: " + Filename);
         return;
     }
+    MeshContentHash = FMeshKey::HashBytes(MeshData.Vertices.data(), MeshData.Vertices.size() * sizeof(FTexturedVertex));
+    MeshContentHash = FMeshKey::HashBytes(MeshData.Indices.data(), MeshData.Indices.size() * sizeof(uint32), MeshContentHash);
     
     // Set material from loaded mesh data
     Material.DiffuseColor = MeshData.Material.DiffuseColor;
@@ -54,7 +59,14 @@ FOBJPrimitive::FOBJPrimitive(const std::string& InFilename, FRHI* InRHI)
 
 FOBJPrimitive::~FOBJPrimitive()
 {
-    delete DiffuseTexture;
+    if (DiffuseTexture && RHIRef)
+    {
+        RHIRef->DeferredRelease(DiffuseTexture, static_cast<uint64>(DiffuseTexture->GetWidth()) * DiffuseTexture->GetHeight() * 4);
+    }
+    else
+    {
+        delete DiffuseTexture;
+    }
     FLog::Log(ELogLevel::Info, "FOBJPrimitive destroyed");
 }
 
@@ -77,31 +89,27 @@ FSceneProxy* FOBJPrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
     
     FLog::Log(ELogLevel::Info, "Creating textured scene proxy for OBJ model");
     
-    // Create RHI resources
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(
-        MeshData.Vertices.size() * sizeof(FTexturedVertex),
-        MeshData.Vertices.data());
-    
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(
-        MeshData.Indices.size() * sizeof(uint32),
-        MeshData.Indices.data());
-    
-    FRHIBuffer* mvpBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIBuffer* lightingBuffer = RHI->CreateConstantBuffer(sizeof(FLightingConstants));
+    // Geometry is shared with every primitive that loaded the same model
+    FMeshKey key(EMeshGenerator::Imported, static_cast<uint32>(MeshData.Vertices.size()),
+                 static_cast<uint32>(MeshData.Indices.size()), MeshContentHash);
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, key, [this](FMeshBuildData& OutMesh)
+    {
+        OutMesh.SetVertices(MeshData.Vertices);
+        OutMesh.Indices = MeshData.Indices;
+    });
     
     // Create pipeline states
     EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting | EPipelineFlags::EnableTextures;
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
     
     // Shadow PSO (depth-only)
     EPipelineFlags shadowFlags = EPipelineFlags::EnableDepth | EPipelineFlags::DepthOnly;
-    FRHIPipelineState* shadowPSO = RHI->CreateGraphicsPipelineStateEx(shadowFlags);
+    FRHIPipelineState* shadowPSO = FPipelineStateCache::AcquirePipelineState(RHI, shadowFlags);
     
     // Create the proxy
     FTexturedSceneProxy* proxy = new FTexturedSceneProxy(
-        vertexBuffer, indexBuffer, mvpBuffer, lightingBuffer,
+        mesh,
         pso, shadowPSO,
-        MeshData.GetIndexCount(),
         g_Camera, Transform, LightScene, Material,
         DiffuseTexture, RHI);
     
@@ -42,6 +42,7 @@ public:
 private:
     std::string Filename;
     FMeshData MeshData;
+    uint64 MeshContentHash;     // Of the loaded geometry; copies of a model share one mesh
     FRHITexture* DiffuseTexture;
     FRHI* RHIRef;
     bool bAutoRotate;
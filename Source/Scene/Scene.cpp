@@ -1,10 +1,29 @@
 #include "Scene.h"
 #include "ScenePrimitive.h"
 #include "../Renderer/Renderer.h"
+#include "../Renderer/GeometryBufferAllocator.h"
+#include "../Core/FrameAllocator.h"
+#include "../TaskGraph/ParallelFor.h"
+#include <algorithm>
+#include <chrono>
 
 // FRenderScene implementation
 FRenderScene::FRenderScene()
+    : SnapshotSource(nullptr)
+    , AppliedSnapshotSequence(0)
+    , ReleasedSnapshotSequence(0)
+    , CachedTriangleCount(0)
+    , NumCachedDrawListBuilds(0)
+    , CachedGeometryGeneration(0)
+    , bCachedDrawListsDirty(true)
+    , bSortMeshDrawCommands(true)
+    , bInstancedDraws(true)
+    , bFrustumCulling(true)
+    , bOcclusionCulling(true)
+    , NumShadowViews(0)
+    , bShadowCulling(true)
 {
+    BeginFrame();
 }
 
 FRenderScene::~FRenderScene()
@@ -16,52 +35,601 @@ void FRenderScene::AddProxy(FSceneProxy* Proxy)
 {
     if (Proxy)
     {
+        LegacyProxies.push_back(Proxy);
         Proxies.push_back(Proxy);
+        bCachedDrawListsDirty = true;
     }
 }
 
 void FRenderScene::RemoveProxy(FSceneProxy* Proxy)
 {
-    auto it = std::find(Proxies.begin(), Proxies.end(), Proxy);
-    if (it != Proxies.end())
+    auto it = std::find(LegacyProxies.begin(), LegacyProxies.end(), Proxy);
+    if (it != LegacyProxies.end())
     {
-        delete *it;
-        Proxies.erase(it);
+        LegacyProxies.erase(it);
+        Proxies.erase(std::find(Proxies.begin(), Proxies.end(), Proxy));
+        bCachedDrawListsDirty = true;
+        delete Proxy;
     }
 }
 
 void FRenderScene::ClearProxies()
 {
-    for (FSceneProxy* Proxy : Proxies)
+    // Snapshot proxies belong to FScene; only legacy proxies are deleted here
+    for (FSceneProxy* Proxy : LegacyProxies)
     {
         delete Proxy;
     }
+    LegacyProxies.clear();
     Proxies.clear();
+    bCachedDrawListsDirty = true;
 }
 
-void FRenderScene::Render(FRHICommandList* RHICmdList, FRenderStats& Stats)
+void FRenderScene::SetSortMeshDrawCommands(bool bEnable)
 {
-    uint32 totalTriangles = 0;
-    uint32 drawCalls = 0;
+    if (bEnable != bSortMeshDrawCommands)
+    {
+        bSortMeshDrawCommands = bEnable;
+        bCachedDrawListsDirty = true;
+    }
+}
+
+void FRenderScene::SetInstancedDraws(bool bEnable)
+{
+    if (bEnable != bInstancedDraws)
+    {
+        bInstancedDraws = bEnable;
+        bCachedDrawListsDirty = true;
+    }
+}
+
+void FRenderScene::BeginFrame()
+{
+    for (bool& bUploaded : bInstanceDataUploaded)
+    {
+        bUploaded = false;
+    }
+}
+
+void FRenderScene::ApplySnapshot()
+{
+    FSceneSnapshotBuffer* Source = SnapshotSource.load(std::memory_order_acquire);
+    if (!Source || !Source->Acquire())
+    {
+        return;
+    }
+    
+    const FSceneSnapshot& Snapshot = Source->GetReadBuffer();
     
-    for (FSceneProxy* Proxy : Proxies)
+    PreviousProxies.swap(Proxies);
+    Proxies.assign(LegacyProxies.begin(), LegacyProxies.end());
+    for (const FPrimitiveRenderState& State : Snapshot.Primitives)
     {
-        if (Proxy)
+        FSceneProxy* Proxy = State.Proxy;
+        if (!Proxy)
+        {
+            continue;
+        }
+        
+        // Only touch proxies whose primitive changed since we last applied it
+        bool bStateChanged = Proxy->GetRenderStateVersion() != State.Version;
+        if (bStateChanged)
+        {
+            // Transforms and materials are patched into the cached commands every frame;
+            // a caster joining or leaving the shadow pass changes its draw list, and an
+            // occluder joining or leaving changes the occluder list
+            bool bWasOccluder = Proxy->IsOccluder();
+            Proxy->SetOccluder(State.bOccluder);
+            if (Proxy->GetCastShadow() != State.bCastShadow || Proxy->IsOccluder() != bWasOccluder)
+            {
+                bCachedDrawListsDirty = true;
+            }
+            Proxy->UpdateTransform(State.Transform);
+            Proxy->UpdateMaterial(State.Material);
+            Proxy->SetCastShadow(State.bCastShadow);
+            Proxy->SetRenderStateVersion(State.Version);
+        }
+        
+        if (State.bVisible)
         {
-            Proxy->Render(RHICmdList);
-            totalTriangles += Proxy->GetTriangleCount();
-            drawCalls++;
+            // New proxies (including a new one at a freed proxy's address) and invalidated
+            // ones have no commands in the cached lists yet
+            if (!Proxy->AreMeshDrawCommandsCached())
+            {
+                bCachedDrawListsDirty = true;
+            }
+            
+            // Its world bounds moved with the transform
+            if (bStateChanged)
+            {
+                DirtyBoundsIndices.push_back(static_cast<uint32>(Proxies.size()));
+            }
+            Proxies.push_back(Proxy);
         }
     }
     
+    // Primitives added, removed, shown or hidden
+    if (Proxies != PreviousProxies)
+    {
+        bCachedDrawListsDirty = true;
+    }
+    
+    AppliedSnapshotSequence = Snapshot.Sequence;
+}
+
+void FRenderScene::UpdateCachedDrawLists()
+{
+    // Cached commands hold geometry buffers and offsets; a defragment may have moved them
+    FGeometryBufferAllocator* geometryAllocator = FGeometryBufferAllocator::Get();
+    uint32 geometryGeneration = geometryAllocator ? geometryAllocator->GetGeneration() : 0;
+    if (geometryGeneration != CachedGeometryGeneration)
+    {
+        CachedGeometryGeneration = geometryGeneration;
+        bCachedDrawListsDirty = true;
+    }
+    
+    if (!bCachedDrawListsDirty)
+    {
+        return;
+    }
+    
+    for (uint32 pass = 0; pass < static_cast<uint32>(EMeshPass::Num); ++pass)
+    {
+        CachedDrawLists[pass].Reset();
+        UncachedProxies[pass].clear();
+    }
+    CachedTriangleCount = 0;
+    
+    uint32 numProxies = static_cast<uint32>(Proxies.size());
+    ProxyBounds.Reset(numProxies);
+    ProxyTriangles.resize(numProxies);
+    ProxyVisibility.assign(numProxies, 1);
+    ProxySpatialIds.assign(numProxies, FDynamicBVH::NullIndex);
+    DirtyBoundsIndices.clear();
+    ShadowCasterIndices.clear();
+    OccluderIndices.clear();
+    NumShadowViews = 0;     // Their visibility was indexed by the old proxy order
+    
+    for (uint32 index = 0; index < numProxies; ++index)
+    {
+        FSceneProxy* Proxy = Proxies[index];
+        
+        // Commands are culled with their proxy, by the camera view or by each shadow view
+        FMeshDrawCommandList& basePassList = CachedDrawLists[static_cast<uint32>(EMeshPass::BasePass)];
+        uint32 firstCommand = basePassList.Num();
+        if (!Proxy->AddMeshDrawCommands(EMeshPass::BasePass, basePassList))
+        {
+            UncachedProxies[static_cast<uint32>(EMeshPass::BasePass)].push_back(index);
+        }
+        basePassList.SetPrimitiveIndex(firstCommand, index);
+        if (Proxy->GetCastShadow())
+        {
+            FMeshDrawCommandList& shadowList = CachedDrawLists[static_cast<uint32>(EMeshPass::ShadowDepth)];
+            firstCommand = shadowList.Num();
+            if (!Proxy->AddMeshDrawCommands(EMeshPass::ShadowDepth, shadowList))
+            {
+                UncachedProxies[static_cast<uint32>(EMeshPass::ShadowDepth)].push_back(index);
+            }
+            shadowList.SetPrimitiveIndex(firstCommand, index);
+            ShadowCasterIndices.push_back(index);
+        }
+        Proxy->SetMeshDrawCommandsCached(true);
+        if (Proxy->IsOccluder())
+        {
+            OccluderIndices.push_back(index);
+        }
+        
+        ProxyTriangles[index] = Proxy->GetTriangleCount();
+        CachedTriangleCount += ProxyTriangles[index];
+        if (Proxy->HasBounds())
+        {
+            ProxyBounds.Set(index, Proxy->GetBounds());
+        }
+    }
+    
+    UpdateSpatialIndexMembership();
+    
+    // Proxies sharing mesh and material become one draw with a transform per instance
+    if (bInstancedDraws)
+    {
+        for (FMeshDrawCommandList& drawList : CachedDrawLists)
+        {
+            drawList.MergeInstancedCommands();
+        }
+    }
+    
+    // Group draws by pipeline state, then texture and buffers, so fewer binds change between them
+    if (bSortMeshDrawCommands)
+    {
+        for (FMeshDrawCommandList& drawList : CachedDrawLists)
+        {
+            drawList.Sort();
+        }
+    }
+    
+    // The rebuilt instanced draws have no instance data yet
+    BeginFrame();
+    bCachedDrawListsDirty = false;
+    ++NumCachedDrawListBuilds;
+}
+
+void FRenderScene::ReleaseSnapshot(uint64 Sequence)
+{
+    uint64 Released = ReleasedSnapshotSequence.load(std::memory_order_relaxed);
+    while (Sequence > Released &&
+           !ReleasedSnapshotSequence.compare_exchange_weak(Released, Sequence, std::memory_order_release))
+    {
+    }
+}
+
+uint32 FRenderScene::Render(FRHICommandList* RHICmdList, const FMeshDrawContext& Context, FRenderStats& Stats)
+{
+    UpdateCachedDrawLists();
+    
+    const uint8* visibility = nullptr;
+    if (bFrustumCulling)
+    {
+        CullProxies(Context.ViewProjection);
+        visibility = ProxyVisibility.data();
+    }
+    else
+    {
+        // Keep the bounds and the spatial index current for queries and later culling
+        UpdateProxyBounds();
+        CullingStats = FSceneCullingStats();
+        CullingStats.VisibleProxies = static_cast<uint32>(Proxies.size());
+        CullingStats.VisibleTriangles = CachedTriangleCount;
+    }
+    
+    // Occluders then hide what the frustum kept
+    OcclusionCullingStats = FOcclusionCullingStats();
+    if (bOcclusionCulling && !OccluderIndices.empty())
+    {
+        if (!visibility)
+        {
+            std::fill(ProxyVisibility.begin(), ProxyVisibility.end(), static_cast<uint8>(1));
+            visibility = ProxyVisibility.data();
+        }
+        CullOccludedProxies(Context.ViewProjection);
+    }
+    
+    // Proxies that only implement Render() draw straight away
+    uint32 numDraws = 0;
+    for (uint32 index : UncachedProxies[static_cast<uint32>(EMeshPass::BasePass)])
+    {
+        if (!visibility || visibility[index])
+        {
+            Proxies[index]->Render(RHICmdList);
+            ++numDraws;
+        }
+    }
+    
+    // Steady state: one walk over the cached commands, patching per-frame data as it goes
+    UploadInstanceData(EMeshPass::BasePass, Context.RHI, visibility);
+    numDraws += CachedDrawLists[static_cast<uint32>(EMeshPass::BasePass)].UpdateAndSubmit(EMeshPass::BasePass, Context, RHICmdList,
+                                                                                           visibility);
+    
     // Use AddTriangles instead of SetTriangleCount (triangles are reset in BeginFrame)
-    Stats.AddTriangles(totalTriangles);
-    // Note: draw call counting is not currently supported by FRenderStats
+    Stats.AddTriangles(static_cast<uint32>(CullingStats.VisibleTriangles));
+    return numDraws;
+}
+
+void FRenderScene::UpdateProxyBounds()
+{
+    for (uint32 index : DirtyBoundsIndices)
+    {
+        FSceneProxy* Proxy = Proxies[index];
+        if (Proxy->HasBounds())
+        {
+            const FBoxSphereBounds& bounds = Proxy->GetBounds();
+            ProxyBounds.Set(index, bounds);
+            if (ProxySpatialIds[index] != FDynamicBVH::NullIndex)
+            {
+                SpatialIndex.MoveProxy(ProxySpatialIds[index], bounds.GetBox());
+            }
+        }
+    }
+    DirtyBoundsIndices.clear();
+}
+
+void FRenderScene::UpdateSpatialIndexMembership()
+{
+    // Proxies still present keep their leaf and are refit; a proxy address reused by a new
+    // proxy is the same leaf, since the tree stores only the pointer
+    std::unordered_map<FSceneProxy*, uint32> previousIds;
+    previousIds.swap(SpatialProxyIds);
+    bool bMembershipChanged = false;
+    
+    uint32 numProxies = static_cast<uint32>(Proxies.size());
+    for (uint32 index = 0; index < numProxies; ++index)
+    {
+        FSceneProxy* Proxy = Proxies[index];
+        if (!Proxy->HasBounds())
+        {
+            continue;
+        }
+        
+        FBox box = Proxy->GetBounds().GetBox();
+        uint32 proxyId;
+        auto it = previousIds.find(Proxy);
+        if (it != previousIds.end())
+        {
+            proxyId = it->second;
+            previousIds.erase(it);
+            SpatialIndex.MoveProxy(proxyId, box);
+        }
+        else
+        {
+            proxyId = SpatialIndex.CreateProxy(box, Proxy);
+            bMembershipChanged = true;
+        }
+        SpatialProxyIds[Proxy] = proxyId;
+        ProxySpatialIds[index] = proxyId;
+    }
+    
+    for (const auto& entry : previousIds)
+    {
+        SpatialIndex.DestroyProxy(entry.second);
+        bMembershipChanged = true;
+    }
+    
+    // Rebuilds are rare; lay the tree out again for the queries of the frames in between
+    if (bMembershipChanged)
+    {
+        SpatialIndex.Compact();
+    }
+}
+
+void FRenderScene::PrepareSpatialQuery()
+{
+    UpdateCachedDrawLists();
+    UpdateProxyBounds();
+}
+
+void FRenderScene::QueryProxies(const FViewFrustum& Frustum, std::vector<FSceneProxy*>& OutProxies)
+{
+    PrepareSpatialQuery();
+    SpatialIndex.QueryFrustum(Frustum, [&](uint32 ProxyId)
+    {
+        // The tree holds fat boxes; keep only the proxies whose own bounds pass
+        FSceneProxy* Proxy = static_cast<FSceneProxy*>(SpatialIndex.GetUserData(ProxyId));
+        if (Frustum.IntersectsBounds(Proxy->GetBounds()))
+        {
+            OutProxies.push_back(Proxy);
+        }
+        return true;
+    });
+}
+
+void FRenderScene::QueryProxies(const FVector& Center, float Radius, std::vector<FSceneProxy*>& OutProxies)
+{
+    PrepareSpatialQuery();
+    SpatialIndex.QuerySphere(Center, Radius, [&](uint32 ProxyId)
+    {
+        FSceneProxy* Proxy = static_cast<FSceneProxy*>(SpatialIndex.GetUserData(ProxyId));
+        if (Proxy->GetBounds().GetBox().ComputeSquaredDistanceToPoint(Center) <= Radius * Radius)
+        {
+            OutProxies.push_back(Proxy);
+        }
+        return true;
+    });
+}
+
+FSceneProxy* FRenderScene::RayCastProxies(const FVector& Origin, const FVector& Direction, float MaxDistance,
+                                          float* OutDistance)
+{
+    PrepareSpatialQuery();
+    
+    FVector invDirection(1.0f / Direction.X, 1.0f / Direction.Y, 1.0f / Direction.Z);
+    FSceneProxy* closestProxy = nullptr;
+    float closestDistance = MaxDistance;
+    SpatialIndex.RayCast(Origin, Direction, MaxDistance, [&](uint32 ProxyId, float CurrentMax)
+    {
+        FSceneProxy* Proxy = static_cast<FSceneProxy*>(SpatialIndex.GetUserData(ProxyId));
+        float distance;
+        if (Proxy->GetBounds().GetBox().IntersectsRay(Origin, invDirection, CurrentMax, distance))
+        {
+            // Only closer proxies from here on
+            closestProxy = Proxy;
+            closestDistance = distance;
+            return distance;
+        }
+        return CurrentMax;
+    });
+    
+    if (closestProxy && OutDistance)
+    {
+        *OutDistance = closestDistance;
+    }
+    return closestProxy;
+}
+
+void FRenderScene::CullProxies(const FMatrix4x4& ViewProjection)
+{
+    auto cullStart = std::chrono::high_resolution_clock::now();
+    
+    UpdateProxyBounds();
+    
+    FViewFrustum frustum = FViewFrustum::FromViewProjection(ViewProjection);
+    uint32 numProxies = ProxyBounds.Num();
+    uint32 numVisible = frustum.CullBounds(ProxyBounds, ProxyVisibility.data());
+    
+    uint64 visibleTriangles = 0;
+    for (uint32 index = 0; index < numProxies; ++index)
+    {
+        visibleTriangles += ProxyVisibility[index] ? ProxyTriangles[index] : 0;
+    }
+    
+    CullingStats.VisibleProxies = numVisible;
+    CullingStats.CulledProxies = numProxies - numVisible;
+    CullingStats.VisibleTriangles = visibleTriangles;
+    CullingStats.CulledTriangles = CachedTriangleCount - visibleTriangles;
+    CullingStats.CullTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - cullStart).count();
+}
+
+void FRenderScene::CullOccludedProxies(const FMatrix4x4& ViewProjection)
+{
+    auto rasterStart = std::chrono::high_resolution_clock::now();
+    
+    // Occluders the frustum culled could only add triangles outside the view
+    OcclusionBuffer.Clear();
+    for (uint32 index : OccluderIndices)
+    {
+        if (ProxyVisibility[index])
+        {
+            FSceneProxy* Proxy = Proxies[index];
+            OcclusionCullingStats.OccluderTriangles +=
+                OcclusionBuffer.AddOccluder(Proxy->GetModelMatrix() * ViewProjection, *Proxy->GetOccluderMesh());
+            ++OcclusionCullingStats.NumOccluders;
+        }
+    }
+    if (OcclusionCullingStats.NumOccluders == 0)
+    {
+        return;
+    }
+    
+    // Each bin is a row of tiles no other bin writes
+    ParallelFor(static_cast<int32>(OcclusionBuffer.GetNumBins()), [this](int32 Bin)
+    {
+        OcclusionBuffer.RasterizeBin(static_cast<uint32>(Bin));
+    });
+    
+    auto testStart = std::chrono::high_resolution_clock::now();
+    OcclusionCullingStats.RasterTimeMs = std::chrono::duration<float, std::milli>(testStart - rasterStart).count();
+    
+    // Tests only read the buffer; each batch of proxies counts what it hid
+    constexpr uint32 TestBatchSize = 256;
+    uint32 numProxies = static_cast<uint32>(Proxies.size());
+    uint32 numBatches = (numProxies + TestBatchSize - 1) / TestBatchSize;
+    TFrameVector<uint32> batchTested(numBatches, 0);
+    TFrameVector<uint32> batchOccluded(numBatches, 0);
+    TFrameVector<uint64> batchOccludedTriangles(numBatches, 0);
+    ParallelFor(static_cast<int32>(numBatches), [&](int32 Batch)
+    {
+        uint32 first = static_cast<uint32>(Batch) * TestBatchSize;
+        uint32 last = std::min(first + TestBatchSize, numProxies);
+        for (uint32 index = first; index < last; ++index)
+        {
+            FSceneProxy* Proxy = Proxies[index];
+            if (!ProxyVisibility[index] || !Proxy->HasBounds() || Proxy->IsOccluder())
+            {
+                continue;
+            }
+            ++batchTested[Batch];
+            if (!OcclusionBuffer.IsBoxVisible(ProxyBounds.Get(index).GetBox(), ViewProjection))
+            {
+                ProxyVisibility[index] = 0;
+                ++batchOccluded[Batch];
+                batchOccludedTriangles[Batch] += ProxyTriangles[index];
+            }
+        }
+    });
+    
+    for (uint32 batch = 0; batch < numBatches; ++batch)
+    {
+        OcclusionCullingStats.TestedProxies += batchTested[batch];
+        OcclusionCullingStats.OccludedProxies += batchOccluded[batch];
+        OcclusionCullingStats.OccludedTriangles += batchOccludedTriangles[batch];
+    }
+    CullingStats.VisibleProxies -= OcclusionCullingStats.OccludedProxies;
+    CullingStats.CulledProxies += OcclusionCullingStats.OccludedProxies;
+    CullingStats.VisibleTriangles -= OcclusionCullingStats.OccludedTriangles;
+    CullingStats.CulledTriangles += OcclusionCullingStats.OccludedTriangles;
+    OcclusionCullingStats.TestTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - testStart).count();
+}
+
+void FRenderScene::CullShadowViews(const FShadowCullView* Views, uint32 NumViews)
+{
+    NumShadowViews = 0;
+    ShadowCullingStats = FShadowCullingStats();
+    if (!bShadowCulling || !Views || NumViews == 0)
+    {
+        return;
+    }
+    
+    auto cullStart = std::chrono::high_resolution_clock::now();
+    
+    UpdateCachedDrawLists();
+    UpdateProxyBounds();
+    
+    uint32 numProxies = ProxyBounds.Num();
+    if (ShadowViewVisibility.size() < NumViews)
+    {
+        ShadowViewVisibility.resize(NumViews);
+    }
+    
+    // Views only read the bounds and write their own visibility, so each is a task
+    TFrameVector<uint32> drawnCasters(NumViews, 0);
+    ParallelFor(static_cast<int32>(NumViews), [&](int32 ViewIndex)
+    {
+        const FShadowCullView& view = Views[ViewIndex];
+        std::vector<uint8>& visibility = ShadowViewVisibility[ViewIndex];
+        visibility.resize(numProxies);
+        FViewFrustum::FromViewProjection(view.ViewProjection).CullBounds(ProxyBounds, visibility.data());
+        
+        // Only casters matter from here; the sphere test runs on the few the frustum kept
+        uint32 numDrawn = 0;
+        for (uint32 index : ShadowCasterIndices)
+        {
+            if (visibility[index] && view.SphereRadius > 0.0f &&
+                !ProxyBounds.Get(index).IntersectsSphere(view.SphereCenter, view.SphereRadius))
+            {
+                visibility[index] = 0;
+            }
+            numDrawn += visibility[index];
+        }
+        drawnCasters[ViewIndex] = numDrawn;
+    });
+    NumShadowViews = NumViews;
+    
+    uint32 numCasters = static_cast<uint32>(ShadowCasterIndices.size());
+    ShadowCullingStats.NumViews = NumViews;
+    for (uint32 numDrawn : drawnCasters)
+    {
+        ShadowCullingStats.DrawnCasters += numDrawn;
+        ShadowCullingStats.CulledCasters += numCasters - numDrawn;
+    }
+    ShadowCullingStats.CullTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - cullStart).count();
+}
+
+uint32 FRenderScene::RenderShadowDepth(FRHICommandList* RHICmdList, const FMeshDrawContext& Context, FRHIBuffer* ShadowMVPBuffer,
+                                       uint32 ViewIndex)
+{
+    UpdateCachedDrawLists();
+    
+    const uint8* visibility = ViewIndex < NumShadowViews ? ShadowViewVisibility[ViewIndex].data() : nullptr;
+    
+    uint32 numDraws = 0;
+    for (uint32 index : UncachedProxies[static_cast<uint32>(EMeshPass::ShadowDepth)])
+    {
+        if (!visibility || visibility[index])
+        {
+            Proxies[index]->RenderShadow(RHICmdList, Context.ViewProjection, ShadowMVPBuffer);
+            ++numDraws;
+        }
+    }
+    
+    // Unculled, every shadow view draws the same instances and their transforms are written
+    // once per frame; culled, each view packs its own visible instances
+    FMeshDrawCommandList& drawList = CachedDrawLists[static_cast<uint32>(EMeshPass::ShadowDepth)];
+    if (visibility)
+    {
+        drawList.UploadInstanceData(Context.RHI, visibility);
+    }
+    else
+    {
+        UploadInstanceData(EMeshPass::ShadowDepth, Context.RHI);
+    }
+    return numDraws + drawList.UpdateAndSubmit(EMeshPass::ShadowDepth, Context, RHICmdList, visibility);
 }
 
 // FScene implementation
 FScene::FScene(FRHI* InRHI)
     : RHI(InRHI)
+    , NextSnapshotSequence(1)
 {
 }
 
@@ -86,10 +654,11 @@ void FScene::RemovePrimitive(FPrimitive* Primitive)
     {
         Primitives.erase(it);
         
-        // Remove from proxy map
+        // Remove from proxy map; the render thread may still be drawing the proxy
         auto mapIt = PrimitiveProxyMap.find(Primitive);
         if (mapIt != PrimitiveProxyMap.end())
         {
+            RetireProxy(mapIt->second);
             PrimitiveProxyMap.erase(mapIt);
         }
     }
@@ -97,62 +666,104 @@ void FScene::RemovePrimitive(FPrimitive* Primitive)
 
 void FScene::Tick(float DeltaTime)
 {
-    for (FPrimitive* Primitive : Primitives)
+    // Primitives only touch their own state in Tick, so they can tick in parallel
+    ParallelFor(static_cast<int32>(Primitives.size()), [this, DeltaTime](int32 Index)
     {
-        if (Primitive)
+        if (FPrimitive* Primitive = Primitives[Index])
         {
             Primitive->Tick(DeltaTime);
         }
-    }
+    }, ParallelBatchSize);
 }
 
 void FScene::UpdateRenderScene(FRenderScene* RenderScene)
 {
     if (!RenderScene || !RHI) return;
     
+    RenderScene->SetSnapshotSource(&Snapshots);
+    DeleteReleasedProxies(RenderScene->GetReleasedSnapshotSequence());
+    
+    // Proxy (re)creation touches the proxy map - serial. New proxies are not
+    // visible to the render thread until the snapshot below is published.
     for (FPrimitive* Primitive : Primitives)
     {
-        if (!Primitive) continue;
+        if (!Primitive || !Primitive->IsDirty()) continue;
         
         auto it = PrimitiveProxyMap.find(Primitive);
         
-        if (Primitive->IsDirty())
+        // Need to recreate proxy
+        if (it != PrimitiveProxyMap.end() && it->second)
         {
-            // Need to recreate proxy
-            if (it != PrimitiveProxyMap.end() && it->second)
-            {
-                RenderScene->RemoveProxy(it->second);
-            }
-            
-            // Create new proxy
-            FSceneProxy* NewProxy = Primitive->CreateSceneProxy(RHI, &LightScene);
-            if (NewProxy)
-            {
-                // Copy shadow casting property from primitive to proxy
-                NewProxy->SetCastShadow(Primitive->GetCastShadow());
-                
-                RenderScene->AddProxy(NewProxy);
-                PrimitiveProxyMap[Primitive] = NewProxy;
-            }
-            
-            Primitive->ClearDirty();
+            RetireProxy(it->second);
         }
-        else if (Primitive->IsTransformDirty())
+        
+        // Create new proxy
+        PrimitiveProxyMap[Primitive] = Primitive->CreateSceneProxy(RHI, &LightScene);
+        
+        Primitive->ClearDirty();
+    }
+    
+    // Capture every primitive's render state - one slot each, so parallel
+    FSceneSnapshot& Snapshot = Snapshots.GetWriteBuffer();
+    Snapshot.Sequence = NextSnapshotSequence++;
+    Snapshot.Primitives.resize(Primitives.size());
+    
+    ParallelFor(static_cast<int32>(Primitives.size()), [this, &Snapshot](int32 Index)
+    {
+        FPrimitive* Primitive = Primitives[Index];
+        FPrimitiveRenderState& State = Snapshot.Primitives[Index];
+        State.Proxy = nullptr;
+        if (!Primitive) return;
+        
+        auto it = PrimitiveProxyMap.find(Primitive);
+        if (it != PrimitiveProxyMap.end())
         {
-            // Just update transform
-            if (it != PrimitiveProxyMap.end() && it->second)
-            {
-                it->second->UpdateTransform(Primitive->GetTransform());
-            }
-            Primitive->ClearDirty();
+            State.Proxy = it->second;
         }
+        State.Transform = Primitive->GetTransform();
+        State.Material = Primitive->GetMaterial();
+        State.Version = Primitive->GetRenderStateVersion();
+        State.bVisible = Primitive->IsVisible();
+        State.bCastShadow = Primitive->GetCastShadow();
+        State.bOccluder = Primitive->IsOccluder();
+        Primitive->ClearDirty();
+    }, ParallelBatchSize);
+    
+    Snapshots.Publish();
+}
+
+void FScene::RetireProxy(FSceneProxy* Proxy)
+{
+    if (Proxy)
+    {
+        // The next published snapshot is the first one without it
+        RetiredProxies.push_back({ Proxy, NextSnapshotSequence });
     }
 }
 
+void FScene::DeleteReleasedProxies(uint64 ReleasedSequence)
+{
+    auto it = std::remove_if(RetiredProxies.begin(), RetiredProxies.end(), [ReleasedSequence](const FRetiredProxy& Retired)
+    {
+        if (Retired.Sequence <= ReleasedSequence)
+        {
+            delete Retired.Proxy;
+            return true;
+        }
+        return false;
+    });
+    RetiredProxies.erase(it, RetiredProxies.end());
+}
+
 void FScene::Shutdown()
 {
-    // Clear primitive-proxy mapping
+    // Delete proxies - rendering with this scene's snapshots must have stopped
+    for (auto& Pair : PrimitiveProxyMap)
+    {
+        delete Pair.second;
+    }
     PrimitiveProxyMap.clear();
+    DeleteReleasedProxies(UINT64_MAX);
     
     // Delete all primitives
     for (FPrimitive* Primitive : Primitives)
@@ -164,3 +775,13 @@ void FScene::Shutdown()
     // Clear lights
     LightScene.ClearLights();
 }
+
+void FRenderScene::UploadInstanceData(EMeshPass Pass, FRHI* RHI, const uint8* Visibility)
+{
+    uint32 pass = static_cast<uint32>(Pass);
+    if (!bInstanceDataUploaded[pass] && RHI)
+    {
+        CachedDrawLists[pass].UploadInstanceData(RHI, Visibility);
+        bInstanceDataUploaded[pass] = true;
+    }
+}
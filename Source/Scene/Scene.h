@@ -1,7 +1,14 @@
 #pragma once
 
 #include "../Core/CoreTypes.h"
+#include "../Core/Bounds.h"
+#include "../Core/DynamicBVH.h"
+#include "../Core/MaskedOcclusionBuffer.h"
 #include "../Lighting/Light.h"
+#include "../TaskGraph/TripleBuffer.h"
+#include "../Renderer/MeshDrawCommand.h"
+#include "ScenePrimitive.h"
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 
@@ -12,9 +19,155 @@ class FRHI;
 class FRHICommandList;
 class FRenderStats;
 
+/**
+ * FPrimitiveRenderState - per-primitive state the render thread needs each frame
+ * Copied out of FPrimitive on the game thread into an FSceneSnapshot.
+ */
+struct FPrimitiveRenderState
+{
+    FSceneProxy* Proxy = nullptr;  // Null if proxy creation failed
+    FTransform Transform;
+    FMaterial Material;
+    uint32 Version = 0;            // FPrimitive::GetRenderStateVersion() at capture
+    bool bVisible = true;
+    bool bCastShadow = true;
+    bool bOccluder = false;
+};
+
+/**
+ * FSceneSnapshot - the game scene's render state for one game frame
+ * Sequence increases by one per published snapshot (first is 1).
+ */
+struct FSceneSnapshot
+{
+    uint64 Sequence = 0;
+    std::vector<FPrimitiveRenderState> Primitives;
+};
+
+using FSceneSnapshotBuffer = TTripleBuffer<FSceneSnapshot>;
+
+/**
+ * FSceneCullingStats - What view frustum culling kept of the last base pass
+ * Proxies hidden by occlusion culling count as culled.
+ */
+struct FSceneCullingStats
+{
+    uint32 VisibleProxies;
+    uint32 CulledProxies;
+    uint64 VisibleTriangles;
+    uint64 CulledTriangles;
+    float CullTimeMs;           // Bounds updates and the frustum test
+
+    FSceneCullingStats()
+        : VisibleProxies(0)
+        , CulledProxies(0)
+        , VisibleTriangles(0)
+        , CulledTriangles(0)
+        , CullTimeMs(0.0f)
+    {
+    }
+};
+
+/**
+ * FOcclusionCullingStats - What software occlusion culling hid of the last base pass
+ * Only proxies that passed the frustum test are tested; the occluders are not.
+ */
+struct FOcclusionCullingStats
+{
+    uint32 NumOccluders;
+    uint32 OccluderTriangles;   // Binned, after clipping
+    uint32 TestedProxies;
+    uint32 OccludedProxies;
+    uint64 OccludedTriangles;
+    float RasterTimeMs;         // Occluder setup, binning and rasterization
+    float TestTimeMs;
+
+    FOcclusionCullingStats()
+        : NumOccluders(0)
+        , OccluderTriangles(0)
+        , TestedProxies(0)
+        , OccludedProxies(0)
+        , OccludedTriangles(0)
+        , RasterTimeMs(0.0f)
+        , TestTimeMs(0.0f)
+    {
+    }
+
+    // Share of the tested proxies found hidden, in percent
+    float GetOccludedPercent() const { return TestedProxies > 0 ? 100.0f * OccludedProxies / TestedProxies : 0.0f; }
+};
+
+/**
+ * FShadowCullView - A shadow view to cull casters against
+ * The light's view-projection for one shadow map (or one cube face of a
+ * point light), plus the sphere the light reaches for point lights.
+ */
+struct FShadowCullView
+{
+    FMatrix4x4 ViewProjection;
+    FVector SphereCenter;
+    float SphereRadius;         // 0 = no sphere test
+
+    FShadowCullView()
+        : SphereRadius(0.0f)
+    {
+    }
+};
+
+/**
+ * FShadowCullingStats - What shadow caster culling kept of the last frame's shadow views
+ */
+struct FShadowCullingStats
+{
+    uint32 NumViews;
+    uint32 DrawnCasters;        // Caster draws over all views (an instance counts as one)
+    uint32 CulledCasters;       // Casters left out of a view
+    float CullTimeMs;
+
+    FShadowCullingStats()
+        : NumViews(0)
+        , DrawnCasters(0)
+        , CulledCasters(0)
+        , CullTimeMs(0.0f)
+    {
+    }
+};
+
 /**
  * FRenderScene - Render thread scene representation
  * Contains proxies for actual rendering
+ *
+ * Scene primitives reach the render scene only through snapshots: the game
+ * thread publishes an FSceneSnapshot into a triple buffer and ApplySnapshot()
+ * picks up the newest one at the start of a frame, so game and render
+ * threads never touch the same proxy state concurrently. Proxies added
+ * directly with AddProxy (legacy path) are owned here and always drawn.
+ *
+ * The base pass is culled against the camera frustum: the world bounds of
+ * the proxies are kept in an FBoundsSoA in proxy order, refreshed for the
+ * proxies whose transform changed, and tested in one batch per frame.
+ * Cached commands carry their proxy's index into the resulting visibility,
+ * so culling never rebuilds the cached lists.
+ *
+ * Shadow casters are culled separately for every shadow view (each light,
+ * and each cube face of a point light), since casters outside the camera
+ * view can still shadow it. CullShadowViews() tests the same bounds against
+ * all views in parallel, one visibility array per view, and
+ * RenderShadowDepth() draws the view it is given with that array.
+ *
+ * The same world bounds also feed an FDynamicBVH kept in step with the
+ * proxies: membership is diffed when the cached lists are rebuilt and moved
+ * proxies are refit with their bounds. Whole-scene passes keep the linear SoA
+ * kernel, which beats a tree walk when most proxies are tested anyway; the
+ * tree answers the small queries (a region, a light's reach, a picking ray)
+ * in time logarithmic in the scene size. Proxies without bounds are not
+ * indexed.
+ *
+ * After the frustum test, proxies flagged as occluders are rasterized into a
+ * low resolution FMaskedOcclusionBuffer, one tile row per task, and every
+ * other visible proxy's box is tested against it; hidden ones are cleared
+ * from the same visibility the base pass draws with. Occluders themselves
+ * are never occlusion culled.
  */
 class FRenderScene 
 {
@@ -22,19 +175,174 @@ public:
     FRenderScene();
     ~FRenderScene();
     
-    // Proxy management
+    // Proxy management (legacy proxies, owned by the render scene)
     void AddProxy(FSceneProxy* Proxy);
     void RemoveProxy(FSceneProxy* Proxy);
     void ClearProxies();
     
-    // Rendering
-    void Render(FRHICommandList* RHICmdList, FRenderStats& Stats);
+    // Start of a frame, after FRHI::BeginTransientFrame: instance data is rewritten into the
+    // new frame's transient memory before its first pass
+    void BeginFrame();
+    
+    // Rendering: base pass draws, patched with Context (camera, lights, shadow map) and culled
+    // against the frustum of Context.ViewProjection. Returns the draw count
+    uint32 Render(FRHICommandList* RHICmdList, const FMeshDrawContext& Context, FRenderStats& Stats);
+    
+    // Cull the shadow casters against each of the frame's shadow views, in parallel. A no-op
+    // with shadow culling off; every view then draws every caster
+    void CullShadowViews(const FShadowCullView* Views, uint32 NumViews);
     
-    // Get proxy list
+    // One shadow view's casters, patched with Context (RHI, light view-projection). The
+    // caller has begun the shadow pass and set its depth-only PSO. ViewIndex is the view's
+    // position in the last CullShadowViews; NoShadowView draws every caster. Returns the
+    // draw count
+    static constexpr uint32 NoShadowView = 0xFFFFFFFFu;
+    uint32 RenderShadowDepth(FRHICommandList* RHICmdList, const FMeshDrawContext& Context, FRHIBuffer* ShadowMVPBuffer,
+                             uint32 ViewIndex = NoShadowView);
+    
+    // Sort each pass's mesh draw commands by state when the cached lists are built (default on);
+    // off, draws are submitted in proxy order
+    void SetSortMeshDrawCommands(bool bEnable);
+    bool GetSortMeshDrawCommands() const { return bSortMeshDrawCommands; }
+    
+    // Merge the draws of proxies that share mesh and material into instanced draws when the
+    // cached lists are built (default on)
+    void SetInstancedDraws(bool bEnable);
+    bool GetInstancedDraws() const { return bInstancedDraws; }
+    
+    // Skip base pass draws of proxies whose bounds are outside the view frustum (default on)
+    void SetFrustumCulling(bool bEnable) { bFrustumCulling = bEnable; }
+    bool GetFrustumCulling() const { return bFrustumCulling; }
+    
+    // Visible and culled proxies and triangles of the last base pass
+    const FSceneCullingStats& GetCullingStats() const { return CullingStats; }
+    
+    // Skip base pass draws of proxies hidden behind occluder proxies (default on); does nothing
+    // without occluders in the scene
+    void SetOcclusionCulling(bool bEnable) { bOcclusionCulling = bEnable; }
+    bool GetOcclusionCulling() const { return bOcclusionCulling; }
+    
+    // Occluders, raster and test times and hidden proxies of the last base pass
+    const FOcclusionCullingStats& GetOcclusionCullingStats() const { return OcclusionCullingStats; }
+    
+    // The depth the last base pass was tested against
+    const FMaskedOcclusionBuffer& GetOcclusionBuffer() const { return OcclusionBuffer; }
+    
+    // Skip shadow draws of casters outside each shadow view or a point light's radius (default on)
+    void SetShadowCulling(bool bEnable) { bShadowCulling = bEnable; }
+    bool GetShadowCulling() const { return bShadowCulling; }
+    
+    // Drawn and culled casters of the last CullShadowViews
+    const FShadowCullingStats& GetShadowCullingStats() const { return ShadowCullingStats; }
+    
+    // Proxies whose bounds touch Frustum / the sphere, appended to OutProxies (spatial index)
+    void QueryProxies(const FViewFrustum& Frustum, std::vector<FSceneProxy*>& OutProxies);
+    void QueryProxies(const FVector& Center, float Radius, std::vector<FSceneProxy*>& OutProxies);
+    
+    // Nearest proxy whose bounds the ray Origin + t * Direction (0 <= t <= MaxDistance) hits, for
+    // picking; nullptr if none. OutDistance receives the t where it enters the bounds
+    FSceneProxy* RayCastProxies(const FVector& Origin, const FVector& Direction, float MaxDistance,
+                                float* OutDistance = nullptr);
+    
+    // The tree behind the queries; its user data are the FSceneProxy pointers
+    const FDynamicBVH& GetSpatialIndex() const { return SpatialIndex; }
+    
+    // Cached draw lists: commands per pass, and how many times they have been built
+    uint32 GetNumCachedMeshDrawCommands(EMeshPass Pass) const { return CachedDrawLists[static_cast<uint32>(Pass)].Num(); }
+    uint32 GetNumCachedDrawListBuilds() const { return NumCachedDrawListBuilds; }
+    
+    // Instanced draws among a pass's cached commands, and the proxies they draw
+    uint32 GetNumInstancedDraws(EMeshPass Pass) const { return CachedDrawLists[static_cast<uint32>(Pass)].GetNumInstancedDraws(); }
+    uint32 GetNumInstances(EMeshPass Pass) const { return CachedDrawLists[static_cast<uint32>(Pass)].GetNumInstances(); }
+    
+    // Get proxy list (legacy proxies plus the visible proxies of the applied snapshot)
     const std::vector<FSceneProxy*>& GetProxies() const { return Proxies; }
     
+    // Game thread: where FScene publishes its snapshots
+    void SetSnapshotSource(FSceneSnapshotBuffer* InSource) { SnapshotSource.store(InSource, std::memory_order_release); }
+    
+    // Render thread: switch to the newest published snapshot, pushing changed
+    // transforms / materials / flags into the proxies. No-op if nothing new.
+    void ApplySnapshot();
+    
+    // Sequence of the snapshot the render thread is currently drawing (0 = none)
+    uint64 GetAppliedSnapshotSequence() const { return AppliedSnapshotSequence; }
+    
+    // Any thread: a frame drawn with snapshot Sequence has been fully submitted
+    // (frames complete in order, so this only moves forward)
+    void ReleaseSnapshot(uint64 Sequence);
+    
+    // Newest snapshot no in-flight frame can still reference anything older than
+    uint64 GetReleasedSnapshotSequence() const { return ReleasedSnapshotSequence.load(std::memory_order_acquire); }
+    
 private:
     std::vector<FSceneProxy*> Proxies;
+    std::vector<FSceneProxy*> LegacyProxies;
+    std::vector<FSceneProxy*> PreviousProxies;      // Proxies before the last ApplySnapshot
+    
+    std::atomic<FSceneSnapshotBuffer*> SnapshotSource;
+    uint64 AppliedSnapshotSequence;
+    std::atomic<uint64> ReleasedSnapshotSequence;
+    
+    // Rebuild the cached draw lists if the visible proxies or their static state changed
+    void UpdateCachedDrawLists();
+    
+    // Write Pass's instance data if this frame has not yet; Visibility as for the pass's draws
+    void UploadInstanceData(EMeshPass Pass, FRHI* RHI, const uint8* Visibility = nullptr);
+    
+    // Copy the world bounds of the proxies whose transform changed into ProxyBounds and the
+    // spatial index
+    void UpdateProxyBounds();
+    
+    // Add the proxies new to the cached lists to the spatial index and remove the ones gone
+    void UpdateSpatialIndexMembership();
+    
+    // Bring the cached lists, the bounds and the spatial index up to date before a query
+    void PrepareSpatialQuery();
+    
+    // Bring ProxyBounds up to date and test it against ViewProjection's frustum into ProxyVisibility
+    void CullProxies(const FMatrix4x4& ViewProjection);
+    
+    // Rasterize the visible occluders and clear ProxyVisibility for the proxies they hide
+    void CullOccludedProxies(const FMatrix4x4& ViewProjection);
+    
+    // Per-pass draws of the visible proxies, built once and patched every frame; sorted at build
+    FMeshDrawCommandList CachedDrawLists[static_cast<uint32>(EMeshPass::Num)];
+    std::vector<uint32> UncachedProxies[static_cast<uint32>(EMeshPass::Num)];  // Into Proxies; drawn through Render() / RenderShadow()
+    bool bInstanceDataUploaded[static_cast<uint32>(EMeshPass::Num)];  // This frame; shared by all of a pass's views
+    uint32 CachedTriangleCount;
+    uint32 NumCachedDrawListBuilds;
+    uint32 CachedGeometryGeneration;        // FGeometryBufferAllocator generation the lists were built against
+    bool bCachedDrawListsDirty;
+    bool bSortMeshDrawCommands;
+    bool bInstancedDraws;
+    
+    // Frustum culling, indexed like Proxies; rebuilt with the cached draw lists
+    FBoundsSoA ProxyBounds;                 // World space
+    std::vector<uint32> ProxyTriangles;
+    std::vector<uint8> ProxyVisibility;     // Of the last base pass
+    std::vector<uint32> DirtyBoundsIndices; // Proxies whose transform changed since the last cull
+    FSceneCullingStats CullingStats;
+    bool bFrustumCulling;
+    
+    // Occlusion culling; OccluderIndices (into Proxies) is rebuilt with the cached draw lists
+    FMaskedOcclusionBuffer OcclusionBuffer;
+    std::vector<uint32> OccluderIndices;
+    FOcclusionCullingStats OcclusionCullingStats;
+    bool bOcclusionCulling;
+    
+    // Spatial index over the bounded proxies; ProxySpatialIds is indexed like Proxies
+    // (FDynamicBVH::NullIndex for proxies without bounds)
+    FDynamicBVH SpatialIndex;
+    std::vector<uint32> ProxySpatialIds;
+    std::unordered_map<FSceneProxy*, uint32> SpatialProxyIds;
+    
+    // Shadow caster culling: a visibility array per view of the last CullShadowViews
+    std::vector<uint32> ShadowCasterIndices;            // Into Proxies; rebuilt with the cached draw lists
+    std::vector<std::vector<uint8>> ShadowViewVisibility;
+    uint32 NumShadowViews;
+    FShadowCullingStats ShadowCullingStats;
+    bool bShadowCulling;
 };
 
 /**
@@ -59,7 +367,9 @@ public:
     // Update all primitives
     void Tick(float DeltaTime);
     
-    // Synchronize with render scene
+    // Synchronize with render scene (game thread)
+    // Creates proxies for new/dirty primitives and publishes a snapshot of every
+    // primitive's render state; never modifies the render scene's proxies.
     void UpdateRenderScene(FRenderScene* RenderScene);
     
     // Cleanup
@@ -68,11 +378,33 @@ public:
     // Get RHI
     FRHI* GetRHI() { return RHI; }
     
+    // Proxies waiting for the render thread to release their last snapshot
+    uint32 GetNumRetiredProxies() const { return static_cast<uint32>(RetiredProxies.size()); }
+    
 private:
+    // Minimum primitives per ParallelFor batch in Tick/UpdateRenderScene
+    static constexpr int32 ParallelBatchSize = 64;
+    
     FRHI* RHI;
     std::vector<FPrimitive*> Primitives;
     FLightScene LightScene;
     
     // Dirty tracking
     std::unordered_map<FPrimitive*, FSceneProxy*> PrimitiveProxyMap;
+    
+    // Game -> render handoff of primitive render state
+    FSceneSnapshotBuffer Snapshots;
+    uint64 NextSnapshotSequence;
+    
+    // Proxies replaced or removed on the game thread; deleted once the render
+    // scene has released the first snapshot that no longer contains them
+    struct FRetiredProxy
+    {
+        FSceneProxy* Proxy;
+        uint64 Sequence;
+    };
+    std::vector<FRetiredProxy> RetiredProxies;
+    
+    void RetireProxy(FSceneProxy* Proxy);
+    void DeleteReleasedProxies(uint64 ReleasedSequence);
 };
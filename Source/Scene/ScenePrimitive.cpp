@@ -4,58 +4,23 @@
 #include "../Game/GameGlobals.h"
 #include "../RHI/RHI.h"
 #include "../Renderer/Camera.h"
+#include "../Renderer/PipelineStateCache.h"
+#include "../Renderer/MeshRegistry.h"
 #include <vector>
 #include <cmath>
+#include <utility>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 // ============================================================================
-// FPrimitive - Base class implementation
-// ============================================================================
-
-FPrimitive::FPrimitive()
-    : Transform()
-    , Material(FMaterial::Default())
-    , Color(1.0f, 1.0f, 1.0f, 1.0f)
-    , PrimitiveType(EPrimitiveType::Lit)  // Default to lit rendering
-    , bIsDirty(true)
-    , bTransformDirty(false)
-    , bCastShadow(true)  // Default to casting shadows
-{
-}
-
-void FPrimitive::Tick(float DeltaTime)
-{
-    // Base implementation does nothing
-}
-
-// ============================================================================
-// LIT PRIMITIVES (Default)
+// Mesh generators - run once per FMeshKey; every primitive with the same key
+// shares the result through FMeshRegistry
 // ============================================================================
 
-// FCubePrimitive implementation (lit)
-FCubePrimitive::FCubePrimitive()
-    : bAutoRotate(false)
-    , RotationSpeed(0.5f)
-{
-    PrimitiveType = EPrimitiveType::Lit;
-}
-
-void FCubePrimitive::Tick(float DeltaTime)
-{
-    if (bAutoRotate)
-    {
-        Transform.Rotation.Y += DeltaTime * RotationSpeed;
-        MarkTransformDirty();
-    }
-}
-
-FSceneProxy* FCubePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
+static void BuildLitCube(FMeshBuildData& OutMesh)
 {
-    FLog::Log(ELogLevel::Info, "Creating cube primitive proxy...");
-    
     std::vector<FLitVertex> vertices;
     std::vector<uint32> indices;
     
@@ -117,41 +82,12 @@ FSceneProxy* FCubePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene
         21, 20, 23, 21, 23, 22   // Left
     };
     
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(vertices.size() * sizeof(FLitVertex), vertices.data());
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-    FRHIBuffer* mvpBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIBuffer* lightingBuffer = RHI->CreateConstantBuffer(sizeof(FLightingConstants));
-    
-    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
-    
-    return new FPrimitiveSceneProxy(vertexBuffer, indexBuffer, mvpBuffer, lightingBuffer,
-                                        pso, indices.size(), g_Camera, Transform, LightScene, Material, RHI);
+    OutMesh.SetVertices(vertices);
+    OutMesh.Indices = std::move(indices);
 }
 
-// FSpherePrimitive implementation (lit)
-FSpherePrimitive::FSpherePrimitive(uint32 InSegments, uint32 InRings)
-    : Segments(InSegments)
-    , Rings(InRings)
-    , bAutoRotate(false)
-    , RotationSpeed(0.3f)
-{
-    PrimitiveType = EPrimitiveType::Lit;
-}
-
-void FSpherePrimitive::Tick(float DeltaTime)
-{
-    if (bAutoRotate)
-    {
-        Transform.Rotation.Y += DeltaTime * RotationSpeed;
-        MarkTransformDirty();
-    }
-}
-
-FSceneProxy* FSpherePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
+static void BuildLitSphere(uint32 Segments, uint32 Rings, FMeshBuildData& OutMesh)
 {
-    FLog::Log(ELogLevel::Info, "Creating sphere primitive proxy...");
-    
     std::vector<FLitVertex> vertices;
     std::vector<uint32> indices;
     
@@ -194,34 +130,12 @@ FSceneProxy* FSpherePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightSce
         }
     }
     
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(vertices.size() * sizeof(FLitVertex), vertices.data());
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-    FRHIBuffer* mvpBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIBuffer* lightingBuffer = RHI->CreateConstantBuffer(sizeof(FLightingConstants));
-    
-    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
-    
-    return new FPrimitiveSceneProxy(vertexBuffer, indexBuffer, mvpBuffer, lightingBuffer,
-                                        pso, indices.size(), g_Camera, Transform, LightScene, Material, RHI);
+    OutMesh.SetVertices(vertices);
+    OutMesh.Indices = std::move(indices);
 }
 
-// FPlanePrimitive implementation (lit)
-FPlanePrimitive::FPlanePrimitive(uint32 InSubdivisions)
-    : Subdivisions(InSubdivisions)
+static void BuildLitPlane(uint32 Subdivisions, FMeshBuildData& OutMesh)
 {
-    PrimitiveType = EPrimitiveType::Lit;
-}
-
-void FPlanePrimitive::Tick(float DeltaTime)
-{
-    // Planes don't animate
-}
-
-FSceneProxy* FPlanePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
-{
-    FLog::Log(ELogLevel::Info, "Creating plane primitive proxy...");
-    
     std::vector<FLitVertex> vertices;
     std::vector<uint32> indices;
     
@@ -261,40 +175,12 @@ FSceneProxy* FPlanePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScen
         }
     }
     
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(vertices.size() * sizeof(FLitVertex), vertices.data());
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-    FRHIBuffer* mvpBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIBuffer* lightingBuffer = RHI->CreateConstantBuffer(sizeof(FLightingConstants));
-    
-    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
-    
-    return new FPrimitiveSceneProxy(vertexBuffer, indexBuffer, mvpBuffer, lightingBuffer,
-                                        pso, indices.size(), g_Camera, Transform, LightScene, Material, RHI);
+    OutMesh.SetVertices(vertices);
+    OutMesh.Indices = std::move(indices);
 }
 
-// FCylinderPrimitive implementation (lit)
-FCylinderPrimitive::FCylinderPrimitive(uint32 InSegments)
-    : Segments(InSegments)
-    , bAutoRotate(false)
-    , RotationSpeed(0.4f)
+static void BuildLitCylinder(uint32 Segments, FMeshBuildData& OutMesh)
 {
-    PrimitiveType = EPrimitiveType::Lit;
-}
-
-void FCylinderPrimitive::Tick(float DeltaTime)
-{
-    if (bAutoRotate)
-    {
-        Transform.Rotation.Y += DeltaTime * RotationSpeed;
-        MarkTransformDirty();
-    }
-}
-
-FSceneProxy* FCylinderPrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
-{
-    FLog::Log(ELogLevel::Info, "Creating cylinder primitive proxy...");
-    
     std::vector<FLitVertex> vertices;
     std::vector<uint32> indices;
     
@@ -374,43 +260,12 @@ FSceneProxy* FCylinderPrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightS
         indices.push_back(idx1);
     }
     
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(vertices.size() * sizeof(FLitVertex), vertices.data());
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-    FRHIBuffer* mvpBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIBuffer* lightingBuffer = RHI->CreateConstantBuffer(sizeof(FLightingConstants));
-    
-    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
-    
-    return new FPrimitiveSceneProxy(vertexBuffer, indexBuffer, mvpBuffer, lightingBuffer,
-                                        pso, indices.size(), g_Camera, Transform, LightScene, Material, RHI);
+    OutMesh.SetVertices(vertices);
+    OutMesh.Indices = std::move(indices);
 }
 
-// ============================================================================
-// UNLIT PRIMITIVES
-// ============================================================================
-
-FUnlitCubePrimitive::FUnlitCubePrimitive()
-    : bAutoRotate(true)
-    , RotationSpeed(0.5f)
+static void BuildUnlitCube(const FColor& Color, FMeshBuildData& OutMesh)
 {
-    PrimitiveType = EPrimitiveType::Unlit;
-}
-
-void FUnlitCubePrimitive::Tick(float DeltaTime)
-{
-    if (bAutoRotate)
-    {
-        Transform.Rotation.Y += DeltaTime * RotationSpeed;
-        Transform.Rotation.X += DeltaTime * RotationSpeed * 0.3f;
-        MarkTransformDirty();
-    }
-}
-
-FSceneProxy* FUnlitCubePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* /*LightScene*/)
-{
-    FLog::Log(ELogLevel::Info, "Creating unlit cube primitive proxy...");
-    
     std::vector<FVertex> vertices = {
         { FVector(-0.5f, -0.5f,  0.5f), Color },
         { FVector( 0.5f, -0.5f,  0.5f), Color },
@@ -447,37 +302,12 @@ FSceneProxy* FUnlitCubePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* /*Lig
         21, 20, 23, 21, 23, 22
     };
     
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(vertices.size() * sizeof(FVertex), vertices.data());
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-    FRHIBuffer* constantBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineState(true);
-    
-    return new FUnlitPrimitiveSceneProxy(vertexBuffer, indexBuffer, constantBuffer, pso, 
-                                    indices.size(), g_Camera, Transform);
-}
-
-FUnlitSpherePrimitive::FUnlitSpherePrimitive(uint32 InSegments, uint32 InRings)
-    : Segments(InSegments)
-    , Rings(InRings)
-    , bAutoRotate(true)
-    , RotationSpeed(0.3f)
-{
-    PrimitiveType = EPrimitiveType::Unlit;
-}
-
-void FUnlitSpherePrimitive::Tick(float DeltaTime)
-{
-    if (bAutoRotate)
-    {
-        Transform.Rotation.Y += DeltaTime * RotationSpeed;
-        MarkTransformDirty();
-    }
+    OutMesh.SetVertices(vertices);
+    OutMesh.Indices = std::move(indices);
 }
 
-FSceneProxy* FUnlitSpherePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* /*LightScene*/)
+static void BuildUnlitSphere(uint32 Segments, uint32 Rings, const FColor& Color, FMeshBuildData& OutMesh)
 {
-    FLog::Log(ELogLevel::Info, "Creating unlit sphere primitive proxy...");
-    
     std::vector<FVertex> vertices;
     std::vector<uint32> indices;
     
@@ -514,13 +344,217 @@ FSceneProxy* FUnlitSpherePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* /*L
         }
     }
     
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(vertices.size() * sizeof(FVertex), vertices.data());
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-    FRHIBuffer* constantBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineState(true);
+    OutMesh.SetVertices(vertices);
+    OutMesh.Indices = std::move(indices);
+}
+
+// ============================================================================
+// FPrimitive - Base class implementation
+// ============================================================================
+
+FPrimitive::FPrimitive()
+    : Transform()
+    , Material(FMaterial::Default())
+    , Color(1.0f, 1.0f, 1.0f, 1.0f)
+    , PrimitiveType(EPrimitiveType::Lit)  // Default to lit rendering
+    , bIsDirty(true)
+    , bTransformDirty(false)
+    , bCastShadow(true)  // Default to casting shadows
+    , bOccluder(false)
+    , bVisible(true)
+    , RenderStateVersion(1)  // Proxies start at 0, so the first snapshot always applies
+{
+}
+
+void FPrimitive::Tick(float DeltaTime)
+{
+    // Base implementation does nothing
+}
+
+// ============================================================================
+// LIT PRIMITIVES (Default)
+// ============================================================================
+
+// FCubePrimitive implementation (lit)
+FCubePrimitive::FCubePrimitive()
+    : bAutoRotate(false)
+    , RotationSpeed(0.5f)
+{
+    PrimitiveType = EPrimitiveType::Lit;
+}
+
+void FCubePrimitive::Tick(float DeltaTime)
+{
+    if (bAutoRotate)
+    {
+        Transform.Rotation.Y += DeltaTime * RotationSpeed;
+        MarkTransformDirty();
+    }
+}
+
+FSceneProxy* FCubePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
+{
+    FLog::Log(ELogLevel::Info, "Creating cube primitive proxy...");
+    
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, FMeshKey(EMeshGenerator::LitCube), BuildLitCube);
+    
+    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
+    
+    return new FPrimitiveSceneProxy(mesh, pso, g_Camera, Transform, LightScene, Material, RHI);
+}
+
+// FSpherePrimitive implementation (lit)
+FSpherePrimitive::FSpherePrimitive(uint32 InSegments, uint32 InRings)
+    : Segments(InSegments)
+    , Rings(InRings)
+    , bAutoRotate(false)
+    , RotationSpeed(0.3f)
+{
+    PrimitiveType = EPrimitiveType::Lit;
+}
+
+void FSpherePrimitive::Tick(float DeltaTime)
+{
+    if (bAutoRotate)
+    {
+        Transform.Rotation.Y += DeltaTime * RotationSpeed;
+        MarkTransformDirty();
+    }
+}
+
+FSceneProxy* FSpherePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
+{
+    FLog::Log(ELogLevel::Info, "Creating sphere primitive proxy...");
+    
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, FMeshKey(EMeshGenerator::LitSphere, Segments, Rings),
+                                                   [this](FMeshBuildData& OutMesh) { BuildLitSphere(Segments, Rings, OutMesh); });
+    
+    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
+    
+    return new FPrimitiveSceneProxy(mesh, pso, g_Camera, Transform, LightScene, Material, RHI);
+}
+
+// FPlanePrimitive implementation (lit)
+FPlanePrimitive::FPlanePrimitive(uint32 InSubdivisions)
+    : Subdivisions(InSubdivisions)
+{
+    PrimitiveType = EPrimitiveType::Lit;
+}
+
+void FPlanePrimitive::Tick(float DeltaTime)
+{
+    // Planes don't animate
+}
+
+FSceneProxy* FPlanePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
+{
+    FLog::Log(ELogLevel::Info, "Creating plane primitive proxy...");
+    
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, FMeshKey(EMeshGenerator::LitPlane, Subdivisions),
+                                                   [this](FMeshBuildData& OutMesh) { BuildLitPlane(Subdivisions, OutMesh); });
+    
+    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
+    
+    return new FPrimitiveSceneProxy(mesh, pso, g_Camera, Transform, LightScene, Material, RHI);
+}
+
+// FCylinderPrimitive implementation (lit)
+FCylinderPrimitive::FCylinderPrimitive(uint32 InSegments)
+    : Segments(InSegments)
+    , bAutoRotate(false)
+    , RotationSpeed(0.4f)
+{
+    PrimitiveType = EPrimitiveType::Lit;
+}
+
+void FCylinderPrimitive::Tick(float DeltaTime)
+{
+    if (bAutoRotate)
+    {
+        Transform.Rotation.Y += DeltaTime * RotationSpeed;
+        MarkTransformDirty();
+    }
+}
+
+FSceneProxy* FCylinderPrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightScene)
+{
+    FLog::Log(ELogLevel::Info, "Creating cylinder primitive proxy...");
+    
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, FMeshKey(EMeshGenerator::LitCylinder, Segments),
+                                                   [this](FMeshBuildData& OutMesh) { BuildLitCylinder(Segments, OutMesh); });
+    
+    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
+    
+    return new FPrimitiveSceneProxy(mesh, pso, g_Camera, Transform, LightScene, Material, RHI);
+}
+
+// ============================================================================
+// UNLIT PRIMITIVES
+// ============================================================================
+
+FUnlitCubePrimitive::FUnlitCubePrimitive()
+    : bAutoRotate(true)
+    , RotationSpeed(0.5f)
+{
+    PrimitiveType = EPrimitiveType::Unlit;
+}
+
+void FUnlitCubePrimitive::Tick(float DeltaTime)
+{
+    if (bAutoRotate)
+    {
+        Transform.Rotation.Y += DeltaTime * RotationSpeed;
+        Transform.Rotation.X += DeltaTime * RotationSpeed * 0.3f;
+        MarkTransformDirty();
+    }
+}
+
+FSceneProxy* FUnlitCubePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* /*LightScene*/)
+{
+    FLog::Log(ELogLevel::Info, "Creating unlit cube primitive proxy...");
+    
+    // The vertex color is baked into the geometry, so it is part of the key
+    FMeshKey key(EMeshGenerator::UnlitCube, 0, 0, FMeshKey::HashBytes(&Color, sizeof(FColor)));
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, key,
+                                                   [this](FMeshBuildData& OutMesh) { BuildUnlitCube(Color, OutMesh); });
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, EPipelineFlags::EnableDepth);
+    
+    return new FUnlitPrimitiveSceneProxy(mesh, pso, g_Camera, Transform, RHI);
+}
+
+FUnlitSpherePrimitive::FUnlitSpherePrimitive(uint32 InSegments, uint32 InRings)
+    : Segments(InSegments)
+    , Rings(InRings)
+    , bAutoRotate(true)
+    , RotationSpeed(0.3f)
+{
+    PrimitiveType = EPrimitiveType::Unlit;
+}
+
+void FUnlitSpherePrimitive::Tick(float DeltaTime)
+{
+    if (bAutoRotate)
+    {
+        Transform.Rotation.Y += DeltaTime * RotationSpeed;
+        MarkTransformDirty();
+    }
+}
+
+FSceneProxy* FUnlitSpherePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* /*LightScene*/)
+{
+    FLog::Log(ELogLevel::Info, "Creating unlit sphere primitive proxy...");
+    
+    // The vertex color is baked into the geometry, so it is part of the key
+    FMeshKey key(EMeshGenerator::UnlitSphere, Segments, Rings, FMeshKey::HashBytes(&Color, sizeof(FColor)));
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, key,
+                                                   [this](FMeshBuildData& OutMesh) { BuildUnlitSphere(Segments, Rings, Color, OutMesh); });
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, EPipelineFlags::EnableDepth);
     
-    return new FUnlitPrimitiveSceneProxy(vertexBuffer, indexBuffer, constantBuffer, pso,
-                                    indices.size(), g_Camera, Transform);
+    return new FUnlitPrimitiveSceneProxy(mesh, pso, g_Camera, Transform, RHI);
 }
 
 // ============================================================================
@@ -596,68 +630,11 @@ FSceneProxy* FDemoCubePrimitive::CreateSceneProxy(FRHI* RHI, FLightScene* LightS
 {
     FLog::Log(ELogLevel::Info, "Creating demo cube primitive proxy...");
     
-    std::vector<FLitVertex> vertices;
-    std::vector<uint32> indices;
-    
-    FVector normals[6] = {
-        FVector(0.0f, 0.0f, 1.0f),
-        FVector(0.0f, 0.0f, -1.0f),
-        FVector(0.0f, 1.0f, 0.0f),
-        FVector(0.0f, -1.0f, 0.0f),
-        FVector(1.0f, 0.0f, 0.0f),
-        FVector(-1.0f, 0.0f, 0.0f),
-    };
-    
-    FColor white(1.0f, 1.0f, 1.0f, 1.0f);
-    
-    // Front
-    vertices.push_back({ FVector(-0.5f, -0.5f,  0.5f), normals[0], white });
-    vertices.push_back({ FVector( 0.5f, -0.5f,  0.5f), normals[0], white });
-    vertices.push_back({ FVector( 0.5f,  0.5f,  0.5f), normals[0], white });
-    vertices.push_back({ FVector(-0.5f,  0.5f,  0.5f), normals[0], white });
-    // Back
-    vertices.push_back({ FVector(-0.5f, -0.5f, -0.5f), normals[1], white });
-    vertices.push_back({ FVector( 0.5f, -0.5f, -0.5f), normals[1], white });
-    vertices.push_back({ FVector( 0.5f,  0.5f, -0.5f), normals[1], white });
-    vertices.push_back({ FVector(-0.5f,  0.5f, -0.5f), normals[1], white });
-    // Top
-    vertices.push_back({ FVector(-0.5f,  0.5f,  0.5f), normals[2], white });
-    vertices.push_back({ FVector( 0.5f,  0.5f,  0.5f), normals[2], white });
-    vertices.push_back({ FVector( 0.5f,  0.5f, -0.5f), normals[2], white });
-    vertices.push_back({ FVector(-0.5f,  0.5f, -0.5f), normals[2], white });
-    // Bottom
-    vertices.push_back({ FVector(-0.5f, -0.5f,  0.5f), normals[3], white });
-    vertices.push_back({ FVector( 0.5f, -0.5f,  0.5f), normals[3], white });
-    vertices.push_back({ FVector( 0.5f, -0.5f, -0.5f), normals[3], white });
-    vertices.push_back({ FVector(-0.5f, -0.5f, -0.5f), normals[3], white });
-    // Right
-    vertices.push_back({ FVector( 0.5f, -0.5f,  0.5f), normals[4], white });
-    vertices.push_back({ FVector( 0.5f, -0.5f, -0.5f), normals[4], white });
-    vertices.push_back({ FVector( 0.5f,  0.5f, -0.5f), normals[4], white });
-    vertices.push_back({ FVector( 0.5f,  0.5f,  0.5f), normals[4], white });
-    // Left
-    vertices.push_back({ FVector(-0.5f, -0.5f,  0.5f), normals[5], white });
-    vertices.push_back({ FVector(-0.5f, -0.5f, -0.5f), normals[5], white });
-    vertices.push_back({ FVector(-0.5f,  0.5f, -0.5f), normals[5], white });
-    vertices.push_back({ FVector(-0.5f,  0.5f,  0.5f), normals[5], white });
-    
-    indices = {
-        0, 1, 2,    0, 2, 3,
-        5, 4, 7,    5, 7, 6,
-        8, 9, 10,   8, 10, 11,
-        15, 14, 13, 15, 13, 12,
-        16, 17, 18, 16, 18, 19,
-        21, 20, 23, 21, 23, 22
-    };
-    
-    FRHIBuffer* vertexBuffer = RHI->CreateVertexBuffer(vertices.size() * sizeof(FLitVertex), vertices.data());
-    FRHIBuffer* indexBuffer = RHI->CreateIndexBuffer(indices.size() * sizeof(uint32), indices.data());
-    FRHIBuffer* mvpBuffer = RHI->CreateConstantBuffer(sizeof(FMatrix4x4));
-    FRHIBuffer* lightingBuffer = RHI->CreateConstantBuffer(sizeof(FLightingConstants));
+    // Same geometry as FCubePrimitive, so both share one mesh
+    FSharedMesh* mesh = FMeshRegistry::AcquireMesh(RHI, FMeshKey(EMeshGenerator::LitCube), BuildLitCube);
     
     EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
-    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineStateEx(flags);
+    FRHIPipelineState* pso = FPipelineStateCache::AcquirePipelineState(RHI, flags);
     
-    return new FPrimitiveSceneProxy(vertexBuffer, indexBuffer, mvpBuffer, lightingBuffer,
-                                        pso, indices.size(), g_Camera, Transform, LightScene, Material, RHI);
+    return new FPrimitiveSceneProxy(mesh, pso, g_Camera, Transform, LightScene, Material, RHI);
 }
@@ -82,8 +82,8 @@ public:
     
     FMatrix4x4 GetTransformMatrix() const { return Transform.GetMatrix(); }
 
-    // Material accessors
-    void SetMaterial(const FMaterial& InMaterial) { Material = InMaterial; MarkDirty(); }
+    // Material accessors (material changes reach the existing proxy through the scene snapshot)
+    void SetMaterial(const FMaterial& InMaterial) { Material = InMaterial; MarkRenderStateDirty(); }
     const FMaterial& GetMaterial() const { return Material; }
     FMaterial& GetMaterial() { return Material; }
 
@@ -99,12 +99,26 @@ public:
     bool IsDirty() const { return bIsDirty; }
     bool IsTransformDirty() const { return bTransformDirty; }
     void MarkDirty() { bIsDirty = true; bTransformDirty = false; }
-    void MarkTransformDirty() { bTransformDirty = true; }
+    void MarkTransformDirty() { bTransformDirty = true; MarkRenderStateDirty(); }
     void ClearDirty() { bIsDirty = false; bTransformDirty = false; }
+    
+    // Bumped whenever transform, material, visibility, shadow casting or occluding changes;
+    // the render thread re-applies a snapshot entry only when its version moved
+    void MarkRenderStateDirty() { ++RenderStateVersion; }
+    uint32 GetRenderStateVersion() const { return RenderStateVersion; }
 
     // Shadow casting property
-    void SetCastShadow(bool bCast) { bCastShadow = bCast; }
+    void SetCastShadow(bool bCast) { bCastShadow = bCast; MarkRenderStateDirty(); }
     bool GetCastShadow() const { return bCastShadow; }
+    
+    // Occluders hide the primitives behind them from the base pass (software occlusion
+    // culling). Best for large, simple meshes such as walls and floors
+    void SetOccluder(bool bInOccluder) { bOccluder = bInOccluder; MarkRenderStateDirty(); }
+    bool IsOccluder() const { return bOccluder; }
+    
+    // Visibility - hidden primitives keep their proxy but are not drawn or shadowed
+    void SetVisible(bool bInVisible) { bVisible = bInVisible; MarkRenderStateDirty(); }
+    bool IsVisible() const { return bVisible; }
 
 protected:
     FTransform Transform;
@@ -114,6 +128,9 @@ protected:
     bool bIsDirty;
     bool bTransformDirty;
     bool bCastShadow;  // Whether this primitive casts shadows
+    bool bOccluder;
+    bool bVisible;
+    uint32 RenderStateVersion;
 };
 
 // ============================================================================
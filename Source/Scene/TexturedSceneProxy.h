@@ -3,6 +3,7 @@
 #include "../RHI/RHI.h"
 #include "../Renderer/Camera.h"
 #include "../Renderer/Renderer.h"
+#include "../Renderer/MeshRegistry.h"
 #include "../Lighting/Light.h"
 #include "../Lighting/LightingConstants.h"
 #include "../Core/CoreTypes.h"
@@ -18,13 +19,9 @@ class FTexturedSceneProxy : public FSceneProxy
 {
 public:
     FTexturedSceneProxy(
-        FRHIBuffer* InVertexBuffer,
-        FRHIBuffer* InIndexBuffer,
-        FRHIBuffer* InMVPConstantBuffer,
-        FRHIBuffer* InLightingConstantBuffer,
+        FSharedMesh* InMesh,
         FRHIPipelineState* InPSO,
         FRHIPipelineState* InShadowPSO,
-        uint32 InIndexCount,
         FCamera* InCamera,
         const FTransform& InTransform,
         FLightScene* InLightScene,
@@ -34,51 +31,41 @@ public:
     
     virtual ~FTexturedSceneProxy();
     
-    // Render this proxy
-    virtual void Render(FRHICommandList* RHICmdList) override;
-    
-    // Shadow pass rendering
-    virtual void RenderShadow(FRHICommandList* RHICmdList, const FMatrix4x4& LightViewProj, FRHIBuffer* ShadowMVPBuffer = nullptr) override;
+    // Cached draws: textured base pass, and the shadow pass with this vertex layout's depth-only PSO
+    virtual bool AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList) override;
+    virtual void UpdateMeshDrawCommand(EMeshPass Pass, FMeshDrawCommand& Command, const FMeshDrawContext& Context) override;
     
     // Get triangle count
     virtual uint32 GetTriangleCount() const override;
     
-    // Update transform
+    // Update transform / material (render thread, from the scene snapshot)
     virtual void UpdateTransform(const FTransform& InTransform) override;
+    virtual void UpdateMaterial(const FMaterial& InMaterial) override;
     
     // Get model matrix for shadow calculations
     virtual FMatrix4x4 GetModelMatrix() const override { return ModelMatrix; }
     
     // Update material
-    void SetMaterial(const FMaterial& InMaterial) { Material = InMaterial; }
+    void SetMaterial(const FMaterial& InMaterial) { UpdateMaterial(InMaterial); }
     
-    // Update texture
-    void SetDiffuseTexture(FRHITexture* InTexture) { DiffuseTexture = InTexture; }
+    // Update texture; the texture is part of the cached draw, so it is rebuilt
+    void SetDiffuseTexture(FRHITexture* InTexture);
     
-    // Shadow settings
-    void SetShadowMatrix(const FMatrix4x4& LightViewProj);
+    // Whether the directional shadow darkens this mesh (off by default); the shadow matrix and
+    // map come from the frame's view constants
     void SetShadowEnabled(bool bEnabled);
-    void SetShadowMapTexture(FRHITexture* InShadowMapTexture) { ShadowMapTexture = InShadowMapTexture; }
     
 protected:
-    void UpdateLightingConstants();
-    void UpdateShadowConstants();
-    
-    FRHIBuffer* VertexBuffer;
-    FRHIBuffer* IndexBuffer;
-    FRHIBuffer* MVPConstantBuffer;
-    FRHIBuffer* LightingConstantBuffer;
-    FRHIBuffer* ShadowConstantBuffer;
+    FSharedMesh* Mesh;                 // Geometry shared by every proxy of the same mesh
     FRHIPipelineState* PipelineState;
     FRHIPipelineState* ShadowPipelineState;
-    uint32 IndexCount;
     FCamera* Camera;
     FMatrix4x4 ModelMatrix;
+    DirectX::XMMATRIX LightingModelMatrix;  // ModelMatrix transposed for HLSL, updated with the transform
     FLightScene* LightScene;
     FMaterial Material;
-    FLightingConstants LightingData;
+    FMaterialConstants MaterialData;        // Material packed for the primitive constants
     FShadowRenderConstants ShadowData;
-    FRHI* RHI;
+    FRHI* RHI;  // Source of the per-frame transient constants
     FRHITexture* DiffuseTexture;
-    FRHITexture* ShadowMapTexture;
 };
@@ -1,55 +1,76 @@
 #include "UnlitSceneProxy.h"
+#include "../Renderer/PipelineStateCache.h"
 #include <cstring>
 
-FUnlitPrimitiveSceneProxy::FUnlitPrimitiveSceneProxy(FRHIBuffer* InVertexBuffer, FRHIBuffer* InIndexBuffer,
-                                                     FRHIBuffer* InConstantBuffer, FRHIPipelineState* InPSO,
-                                                     uint32 InIndexCount, FCamera* InCamera, const FTransform& InTransform)
-    : VertexBuffer(InVertexBuffer)
-    , IndexBuffer(InIndexBuffer)
-    , ConstantBuffer(InConstantBuffer)
+FUnlitPrimitiveSceneProxy::FUnlitPrimitiveSceneProxy(FSharedMesh* InMesh, FRHIPipelineState* InPSO,
+                                                     FCamera* InCamera, const FTransform& InTransform, FRHI* InRHI)
+    : Mesh(InMesh)
     , PipelineState(InPSO)
-    , IndexCount(InIndexCount)
+    , InstancedPipelineState(nullptr)
     , Camera(InCamera)
     , ModelMatrix(InTransform.GetMatrix())
+    , RHI(InRHI)
 {
+    SetMeshKey(Mesh->Hash);
+    SetLocalBounds(Mesh->Bounds);
+    SetOccluderMesh(Mesh->Occluder.IsValid() ? &Mesh->Occluder : nullptr);
 }
 
 FUnlitPrimitiveSceneProxy::~FUnlitPrimitiveSceneProxy()
 {
-    delete VertexBuffer;
-    delete IndexBuffer;
-    delete ConstantBuffer;
-    delete PipelineState;
+    FMeshRegistry::ReleaseMesh(Mesh);
+    FPipelineStateCache::ReleasePipelineState(PipelineState);
+    FPipelineStateCache::ReleasePipelineState(InstancedPipelineState);
 }
 
-void FUnlitPrimitiveSceneProxy::Render(FRHICommandList* RHICmdList)
+bool FUnlitPrimitiveSceneProxy::AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList)
 {
-    // Calculate MVP matrix
-    FMatrix4x4 viewProjection = Camera->GetViewProjectionMatrix();
-    FMatrix4x4 mvp = ModelMatrix * viewProjection;
+    // Unlit primitives do not cast shadows
+    if (Pass != EMeshPass::BasePass)
+    {
+        return true;
+    }
     
-    // Transpose for HLSL (column-major)
-    FMatrix4x4 mvpTransposed = mvp.Transpose();
+    // Render state and draw; the MVP is patched in every frame
+    FMeshDrawCommand command;
+    command.Proxy = this;
+    command.PipelineState = PipelineState;
+    command.VertexBuffer = Mesh->Vertices->Buffer;
+    command.VertexStride = sizeof(FVertex);
+    command.IndexBuffer = Mesh->Indices->Buffer;
+    command.NumElements = Mesh->GetNumIndices();
+    command.FirstElement = Mesh->Indices->First;
+    command.BaseVertex = Mesh->Vertices->First;
     
-    // Update constant buffer
-    void* cbData = ConstantBuffer->Map();
-    memcpy(cbData, &mvpTransposed.Matrix, sizeof(DirectX::XMMATRIX));
-    ConstantBuffer->Unmap();
-    
-    // Set render state and draw
-    RHICmdList->SetPipelineState(PipelineState);
-    RHICmdList->SetConstantBuffer(ConstantBuffer, 0);
-    RHICmdList->SetVertexBuffer(VertexBuffer, 0, sizeof(FVertex));
-    RHICmdList->SetIndexBuffer(IndexBuffer);
-    RHICmdList->DrawIndexedPrimitive(IndexCount, 0, 0);
+    // Vertex colors are part of the mesh, so proxies with equal mesh keys draw identically
+    if (MeshKey != 0)
+    {
+        if (!InstancedPipelineState)
+        {
+            InstancedPipelineState = FPipelineStateCache::AcquirePipelineState(RHI, EPipelineFlags::EnableDepth | EPipelineFlags::Instanced);
+        }
+        command.InstancedPipelineState = InstancedPipelineState;
+        command.InstancingKey = FMeshDrawCommand::HashInstancingData(FMeshDrawCommand::InstancingHashSeed, &MeshKey, sizeof(MeshKey));
+    }
+    DrawList.AddCommand(command);
+    return true;
+}
+
+void FUnlitPrimitiveSceneProxy::UpdateMeshDrawCommand(EMeshPass /*Pass*/, FMeshDrawCommand& Command, const FMeshDrawContext& Context)
+{
+    // Write the MVP (transposed for HLSL) into this frame's transient constants; instanced
+    // draws get the view-projection and take the world matrix from the instance stream
+    FMatrix4x4 mvpTransposed = (Command.IsInstanced() ? Context.ViewProjection : ModelMatrix * Context.ViewProjection).Transpose();
+    Command.ConstantBuffers[0] = RHI->UploadTransientConstants(&mvpTransposed.Matrix, sizeof(DirectX::XMMATRIX));
 }
 
 uint32 FUnlitPrimitiveSceneProxy::GetTriangleCount() const
 {
-    return IndexCount / 3;
+    return Mesh->GetNumIndices() / 3;
 }
 
 void FUnlitPrimitiveSceneProxy::UpdateTransform(const FTransform& InTransform)
 {
     ModelMatrix = InTransform.GetMatrix();
+    UpdateBounds();
 }
@@ -3,6 +3,7 @@
 #include "../RHI/RHI.h"
 #include "../Renderer/Camera.h"
 #include "../Renderer/Renderer.h"
+#include "../Renderer/MeshRegistry.h"
 #include "../Core/CoreTypes.h"
 #include "ScenePrimitive.h"  // For FTransform
 
@@ -14,24 +15,24 @@
 class FUnlitPrimitiveSceneProxy : public FSceneProxy 
 {
 public:
-    FUnlitPrimitiveSceneProxy(FRHIBuffer* InVertexBuffer, FRHIBuffer* InIndexBuffer, 
-                              FRHIBuffer* InConstantBuffer, FRHIPipelineState* InPSO,
-                              uint32 InIndexCount, FCamera* InCamera, const FTransform& InTransform);
+    FUnlitPrimitiveSceneProxy(FSharedMesh* InMesh, FRHIPipelineState* InPSO,
+                              FCamera* InCamera, const FTransform& InTransform, FRHI* InRHI);
     virtual ~FUnlitPrimitiveSceneProxy();
     
-    virtual void Render(FRHICommandList* RHICmdList) override;
+    virtual bool AddMeshDrawCommands(EMeshPass Pass, FMeshDrawCommandList& DrawList) override;
+    virtual void UpdateMeshDrawCommand(EMeshPass Pass, FMeshDrawCommand& Command, const FMeshDrawContext& Context) override;
     virtual uint32 GetTriangleCount() const override;
     
     virtual void UpdateTransform(const FTransform& InTransform) override;
+    virtual FMatrix4x4 GetModelMatrix() const override { return ModelMatrix; }
     
 protected:
-    FRHIBuffer* VertexBuffer;
-    FRHIBuffer* IndexBuffer;
-    FRHIBuffer* ConstantBuffer;
+    FSharedMesh* Mesh;                 // Geometry shared by every proxy of the same mesh
     FRHIPipelineState* PipelineState;
-    uint32 IndexCount;
+    FRHIPipelineState* InstancedPipelineState;  // Acquired with the first instanceable command
     FCamera* Camera;
     FMatrix4x4 ModelMatrix;
+    FRHI* RHI;  // Source of the per-frame transient constants
 };
 
 
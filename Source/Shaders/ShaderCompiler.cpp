@@ -334,20 +334,25 @@ FShaderBytecode FShaderManager::GetShader(const std::string& FilePath,
     FShaderKey key = {FilePath, EntryPoint, ShaderType};
     
     // Check cache
-    auto it = ShaderCache.find(key);
-    if (it != ShaderCache.end())
     {
-        FLog::Log(ELogLevel::Info, "Shader cache hit: " + FilePath + ":" + EntryPoint);
-        return it->second;
+        std::lock_guard<std::mutex> lock(CacheMutex);
+        auto it = ShaderCache.find(key);
+        if (it != ShaderCache.end())
+        {
+            FLog::Log(ELogLevel::Info, "Shader cache hit: " + FilePath + ":" + EntryPoint);
+            return it->second;
+        }
     }
     
-    // Compile shader
+    // Compile shader outside the lock so PSO precache workers compile in parallel
+    // (two workers may compile the same shader once; the second result is dropped)
     FShaderCompileResult result = Compiler.CompileFromFile(FilePath, EntryPoint, ShaderType);
     
     if (result.bSuccess)
     {
         // Cache the result
-        ShaderCache[key] = result.Bytecode;
+        std::lock_guard<std::mutex> lock(CacheMutex);
+        ShaderCache.emplace(key, result.Bytecode);
         return result.Bytecode;
     }
     
@@ -366,6 +371,7 @@ FShaderBytecode FShaderManager::CompileShaderFromSource(const std::string& Sourc
 
 void FShaderManager::ClearCache()
 {
+    std::lock_guard<std::mutex> lock(CacheMutex);
     ShaderCache.clear();
     FLog::Log(ELogLevel::Info, "Shader cache cleared");
 }
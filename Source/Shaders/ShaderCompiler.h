@@ -5,6 +5,7 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <d3d12.h>
 #include <d3dcompiler.h>
 #include <wrl/client.h>
@@ -216,6 +217,7 @@ private:
     ~FShaderManager() = default;
     
     FShaderCompiler Compiler;
+    std::mutex CacheMutex;  // GetShader is called from PSO precache workers
     std::unordered_map<FShaderKey, FShaderBytecode, FShaderKeyHash> ShaderCache;
     bool bInitialized = false;
 };
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+
+/**
+ * TLockFreePool - fixed-type object pool with a lock-free free list
+ *
+ * Objects are constructed once, when their block is allocated, and are then
+ * recycled through a Treiber stack. They are only destroyed with the pool. Callers
+ * re-initialize recycled objects themselves. Allocate/Free never lock;
+ * growing by one block takes a mutex but only happens when the free list is
+ * empty, so a steady-state workload allocates nothing.
+ *
+ * The free list links slots by 32-bit index. The head packs the index with a
+ * 32-bit tag that is bumped on every update to defeat ABA.
+ *
+ * Once MaxBlocks blocks exist, Allocate falls back to one heap slot per object;
+ * Free destroys those instead of recycling them, so the pool never returns null.
+ * Similar in spirit to UE5's TLockFreeFixedSizeAllocator.
+ */
+template<typename ItemType, uint32 BlockSize = 256>
+class TLockFreePool
+{
+public:
+    TLockFreePool()
+        : FreeHead(MakeHead(InvalidIndex, 0))
+        , NumBlocks(0)
+        , NumFree(0)
+    {
+        for (uint32 i = 0; i < MaxBlocks; ++i)
+        {
+            Blocks[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~TLockFreePool()
+    {
+        uint32 blockCount = NumBlocks.load();
+        for (uint32 b = 0; b < blockCount; ++b)
+        {
+            FSlot* block = Blocks[b].load();
+            for (uint32 i = 0; i < BlockSize; ++i)
+            {
+                block[i].GetItem()->~ItemType();
+            }
+            delete[] block;
+        }
+    }
+
+    TLockFreePool(const TLockFreePool&) = delete;
+    TLockFreePool& operator=(const TLockFreePool&) = delete;
+
+    // Pop a recycled object, growing the pool by one block if the free list is empty
+    ItemType* Allocate()
+    {
+        while (true)
+        {
+            uint64 head = FreeHead.load(std::memory_order_acquire);
+            uint32 index = GetIndex(head);
+            if (index == InvalidIndex)
+            {
+                if (!Grow())
+                {
+                    return AllocateFromHeap();
+                }
+                continue;
+            }
+
+            FSlot* slot = GetSlot(index);
+            uint32 next = slot->NextFree.load(std::memory_order_relaxed);
+            if (FreeHead.compare_exchange_weak(head, MakeHead(next, GetTag(head) + 1),
+                                               std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                NumFree.fetch_sub(1, std::memory_order_relaxed);
+                return slot->GetItem();
+            }
+        }
+    }
+
+    // Return an object to the free list (it is not destroyed, unless it came from the heap)
+    void Free(ItemType* Item)
+    {
+        FSlot* slot = reinterpret_cast<FSlot*>(Item);
+        if (slot->Index == HeapIndex)
+        {
+            Item->~ItemType();
+            delete slot;
+            return;
+        }
+        PushSlot(slot);
+        NumFree.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Total objects ever created (allocated + free)
+    uint32 GetCapacity() const { return NumBlocks.load(std::memory_order_relaxed) * BlockSize; }
+
+    // Objects currently on the free list (approximate under concurrency)
+    uint32 GetNumFree() const { return NumFree.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32 InvalidIndex = 0xFFFFFFFFu;
+    static constexpr uint32 HeapIndex = 0xFFFFFFFEu;     // Slot allocated past MaxBlocks
+    static constexpr uint32 MaxBlocks = 16384;
+
+    // Storage comes first so an item pointer is also its slot pointer
+    struct FSlot
+    {
+        alignas(ItemType) uint8 Storage[sizeof(ItemType)];
+        uint32 Index;
+        std::atomic<uint32> NextFree;
+
+        ItemType* GetItem() { return reinterpret_cast<ItemType*>(Storage); }
+    };
+
+    static uint64 MakeHead(uint32 Index, uint32 Tag) { return (static_cast<uint64>(Tag) << 32) | Index; }
+    static uint32 GetIndex(uint64 Head) { return static_cast<uint32>(Head & 0xFFFFFFFFu); }
+    static uint32 GetTag(uint64 Head) { return static_cast<uint32>(Head >> 32); }
+
+    FSlot* GetSlot(uint32 Index)
+    {
+        return &Blocks[Index / BlockSize].load(std::memory_order_acquire)[Index % BlockSize];
+    }
+
+    void PushSlot(FSlot* Slot)
+    {
+        uint64 head = FreeHead.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot->NextFree.store(GetIndex(head), std::memory_order_relaxed);
+            if (FreeHead.compare_exchange_weak(head, MakeHead(Slot->Index, GetTag(head) + 1),
+                                               std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    bool Grow()
+    {
+        std::lock_guard<std::mutex> Lock(GrowMutex);
+
+        // Another thread may have grown (or freed) while we waited for the lock
+        if (GetIndex(FreeHead.load(std::memory_order_acquire)) != InvalidIndex)
+        {
+            return true;
+        }
+
+        uint32 blockIndex = NumBlocks.load(std::memory_order_relaxed);
+        if (blockIndex >= MaxBlocks)
+        {
+            if (!bLoggedExhausted)
+            {
+                FLog::Log(ELogLevel::Warning, "TLockFreePool exhausted, falling back to heap allocation");
+                bLoggedExhausted = true;
+            }
+            return false;
+        }
+
+        FSlot* block = new FSlot[BlockSize];
+        for (uint32 i = 0; i < BlockSize; ++i)
+        {
+            new (block[i].Storage) ItemType();
+            block[i].Index = blockIndex * BlockSize + i;
+            block[i].NextFree.store(InvalidIndex, std::memory_order_relaxed);
+        }
+        Blocks[blockIndex].store(block, std::memory_order_release);
+        NumBlocks.store(blockIndex + 1, std::memory_order_release);
+
+        for (uint32 i = 0; i < BlockSize; ++i)
+        {
+            PushSlot(&block[i]);
+        }
+        NumFree.fetch_add(BlockSize, std::memory_order_relaxed);
+        return true;
+    }
+
+    ItemType* AllocateFromHeap()
+    {
+        FSlot* slot = new FSlot;
+        new (slot->Storage) ItemType();
+        slot->Index = HeapIndex;
+        slot->NextFree.store(InvalidIndex, std::memory_order_relaxed);
+        return slot->GetItem();
+    }
+
+    alignas(64) std::atomic<uint64> FreeHead;
+    alignas(64) std::atomic<uint32> NumBlocks;
+    std::atomic<uint32> NumFree;
+    std::atomic<FSlot*> Blocks[MaxBlocks];
+    std::mutex GrowMutex;
+    bool bLoggedExhausted = false;  // Under GrowMutex
+};
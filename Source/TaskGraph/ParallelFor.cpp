@@ -0,0 +1,68 @@
+#include "ParallelFor.h"
+#include <algorithm>
+
+/**
+ * FParallelForState - shared by every task of one ParallelFor call
+ * Lives on the caller's stack; the caller does not return until Remaining
+ * reaches zero, and no task touches the state after its final decrement.
+ */
+struct FParallelForState
+{
+    FTaskGraph* Graph;
+    FParallelForRangeFunction RangeFunction;
+    void* Context;
+    int32 MinBatchSize;
+    std::atomic<int32> Remaining;  // Elements not yet processed
+};
+
+static void ProcessRange(FParallelForState* State, int32 Begin, int32 End)
+{
+    const int32 MinBatchSize = State->MinBatchSize;
+    int32 NumProcessed = 0;
+
+    while (Begin < End)
+    {
+        // Lazy binary splitting: only expose more parallelism when nobody
+        // could steal from us, so splits happen on demand rather than up front
+        if (End - Begin >= 2 * MinBatchSize && State->Graph->IsCallerQueueEmpty())
+        {
+            int32 Mid = Begin + (End - Begin) / 2;
+            int32 SplitEnd = End;
+            State->Graph->CreateTask([State, Mid, SplitEnd]() { ProcessRange(State, Mid, SplitEnd); });
+            End = Mid;
+            continue;
+        }
+
+        int32 BatchEnd = std::min(Begin + MinBatchSize, End);
+        State->RangeFunction(State->Context, Begin, BatchEnd);
+        NumProcessed += BatchEnd - Begin;
+        Begin = BatchEnd;
+    }
+
+    // Split-off halves are accounted for by their own tasks. This must be
+    // the last access to State - the caller may return as soon as it hits zero.
+    State->Remaining.fetch_sub(NumProcessed, std::memory_order_release);
+}
+
+void ParallelForInternal(FTaskGraph& Graph, int32 Num, int32 MinBatchSize,
+                         FParallelForRangeFunction RangeFunction, void* Context)
+{
+    FParallelForState State;
+    State.Graph = &Graph;
+    State.RangeFunction = RangeFunction;
+    State.Context = Context;
+    State.MinBatchSize = MinBatchSize;
+    State.Remaining.store(Num, std::memory_order_relaxed);
+
+    // The caller works on the whole range first, splitting as workers go idle
+    ProcessRange(&State, 0, Num);
+
+    // Then helps with whatever is still queued until every element is done
+    while (State.Remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (!Graph.TryExecuteTask())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
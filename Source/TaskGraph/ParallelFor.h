@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include "TaskGraph.h"
+#include <type_traits>
+#include <utility>
+
+/**
+ * ParallelFor - data-parallel loop on top of FTaskGraph
+ * Similar to UE5's ParallelFor
+ *
+ * Calls Body(Index) for every Index in [0, Num). Ranges are split lazily
+ * (lazy binary splitting): a thread working on a range only splits off the
+ * upper half as a new task when its own queue is empty, i.e. when there is
+ * nothing left for idle workers to steal. Otherwise it keeps processing
+ * MinBatchSize elements at a time. Balanced loops therefore create roughly
+ * one task per worker, while skewed loops keep splitting where the work is.
+ *
+ * The calling thread takes part in the loop and, once its own range is done,
+ * runs queued tasks until every element has been processed. Loops with
+ * Num <= MinBatchSize, or with no worker threads, run inline on the caller.
+ *
+ * Body must be safe to call concurrently for different indices.
+ *
+ * Usage:
+ *   ParallelFor(static_cast<int32>(Items.size()), [&](int32 Index) { Items[Index].Update(); }, 64);
+ */
+
+// Type-erased range body: processes [Begin, End)
+using FParallelForRangeFunction = void (*)(void* Context, int32 Begin, int32 End);
+
+// Non-template core (ParallelFor.cpp); Num > 0 and MinBatchSize >= 1
+void ParallelForInternal(FTaskGraph& Graph, int32 Num, int32 MinBatchSize,
+                         FParallelForRangeFunction RangeFunction, void* Context);
+
+template<typename BodyType>
+void ParallelFor(FTaskGraph& Graph, int32 Num, BodyType&& Body, int32 MinBatchSize = 1, bool bForceSingleThread = false)
+{
+    if (Num <= 0)
+    {
+        return;
+    }
+    if (MinBatchSize < 1)
+    {
+        MinBatchSize = 1;
+    }
+
+    if (bForceSingleThread || Num <= MinBatchSize || !Graph.IsInitialized())
+    {
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            Body(Index);
+        }
+        return;
+    }
+
+    auto RangeFunction = [](void* Context, int32 Begin, int32 End)
+    {
+        BodyType& RangeBody = *static_cast<std::remove_reference_t<BodyType>*>(Context);
+        for (int32 Index = Begin; Index < End; ++Index)
+        {
+            RangeBody(Index);
+        }
+    };
+    ParallelForInternal(Graph, Num, MinBatchSize, RangeFunction,
+                        const_cast<void*>(static_cast<const void*>(&Body)));
+}
+
+// ParallelFor on the global task graph
+template<typename BodyType>
+void ParallelFor(int32 Num, BodyType&& Body, int32 MinBatchSize = 1, bool bForceSingleThread = false)
+{
+    ParallelFor(FTaskGraph::Get(), Num, std::forward<BodyType>(Body), MinBatchSize, bForceSingleThread);
+}
@@ -1,6 +1,97 @@
 #include "RenderCommands.h"
 #include "../Renderer/Renderer.h"
 #include "../RHI/RHI.h"
+#include <algorithm>
+
+// ============================================================================
+// Render Command Chunk Allocator
+// ============================================================================
+
+/**
+ * FRenderCommandChunkPool - process-wide store of command chunks
+ * Chunks are shared by all queues so a thread's current chunk stays valid no
+ * matter which queue it enqueues to. The mutex is only taken when a chunk
+ * fills up or is recycled, never per command.
+ */
+class FRenderCommandChunkPool
+{
+public:
+    FRenderCommandChunk* Acquire()
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        if (!FreeChunks.empty())
+        {
+            FRenderCommandChunk* Chunk = FreeChunks.back();
+            FreeChunks.pop_back();
+            return Chunk;
+        }
+        
+        FRenderCommandChunk* Chunk = new FRenderCommandChunk();
+        AllChunks.push_back(Chunk);
+        return Chunk;
+    }
+    
+    void Recycle(FRenderCommandChunk* Chunk)
+    {
+        Chunk->Offset = 0;
+        Chunk->NumAllocated = 0;
+        Chunk->Balance.store(0, std::memory_order_relaxed);
+        
+        std::lock_guard<std::mutex> Lock(Mutex);
+        FreeChunks.push_back(Chunk);
+    }
+    
+    // Producer is done with Chunk; recycles it if every command was already destroyed
+    void Retire(FRenderCommandChunk* Chunk)
+    {
+        int32 NumAllocated = static_cast<int32>(Chunk->NumAllocated);
+        if (Chunk->Balance.fetch_add(NumAllocated, std::memory_order_acq_rel) + NumAllocated == 0)
+        {
+            Recycle(Chunk);
+        }
+    }
+    
+    // Consumer destroyed NumDestroyed commands from Chunk
+    void Release(FRenderCommandChunk* Chunk, int32 NumDestroyed)
+    {
+        // Before retirement Balance is negative, so zero means retired and empty
+        if (Chunk->Balance.fetch_sub(NumDestroyed, std::memory_order_acq_rel) - NumDestroyed == 0)
+        {
+            Recycle(Chunk);
+        }
+    }
+    
+    uint32 GetNumAllocated()
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        return static_cast<uint32>(AllChunks.size());
+    }
+    
+private:
+    std::mutex Mutex;
+    std::vector<FRenderCommandChunk*> FreeChunks;
+    std::vector<FRenderCommandChunk*> AllChunks;
+};
+
+// Intentionally never destroyed: exiting threads (e.g. task graph workers torn
+// down by another singleton) may still retire their chunk during static destruction
+static FRenderCommandChunkPool& GRenderCommandChunkPool = *new FRenderCommandChunkPool();
+
+// Calling thread's current chunk; retired when full or when the thread exits
+struct FThreadRenderCommandChunk
+{
+    FRenderCommandChunk* Chunk = nullptr;
+    
+    ~FThreadRenderCommandChunk()
+    {
+        if (Chunk)
+        {
+            GRenderCommandChunkPool.Retire(Chunk);
+        }
+    }
+};
+
+static thread_local FThreadRenderCommandChunk GThreadRenderCommandChunk;
 
 // ============================================================================
 // FRenderCommandQueue Implementation
@@ -9,159 +100,312 @@
 std::unique_ptr<FRenderCommandQueue> FRenderCommandQueue::Singleton;
 
 FRenderCommandQueue::FRenderCommandQueue()
-    : bShutdown(false)
+    : Head(&Stub)
+    , Tail(&Stub)
+    , PendingCount(0)
+    , bConsumerWaiting(false)
+    , bShutdown(false)
+    , ActiveProducers(0)
 {
 }
 
 FRenderCommandQueue::~FRenderCommandQueue()
 {
     SignalShutdown();
+    
+    // Destroy anything never executed so its chunk can be recycled
+    FRenderCommandBase* First = nullptr;
+    FRenderCommandBase* Last = nullptr;
+    while (FRenderCommandBase* Command = Pop())
+    {
+        Command->Next.store(nullptr, std::memory_order_relaxed);
+        if (Last)
+        {
+            Last->Next.store(Command, std::memory_order_relaxed);
+        }
+        else
+        {
+            First = Command;
+        }
+        Last = Command;
+    }
+    DestroyCommands(First);
 }
 
-void FRenderCommandQueue::EnqueueCommand(std::unique_ptr<FRenderCommandBase> Command)
+void* FRenderCommandQueue::AllocateCommandMemory(size_t Size, size_t Alignment, FRenderCommandChunk*& OutChunk)
 {
-    if (bShutdown)
+    if (Size + Alignment > FRenderCommandChunk::ChunkSize)
     {
-        return;
+        OutChunk = nullptr;
+        return nullptr;
     }
     
+    FThreadRenderCommandChunk& ThreadChunk = GThreadRenderCommandChunk;
+    while (true)
     {
-        std::lock_guard<std::mutex> Lock(QueueMutex);
-        Commands.push(std::move(Command));
+        FRenderCommandChunk* Chunk = ThreadChunk.Chunk;
+        if (Chunk)
+        {
+            uintptr_t Base = reinterpret_cast<uintptr_t>(Chunk->Data);
+            uintptr_t Aligned = (Base + Chunk->Offset + Alignment - 1) & ~(static_cast<uintptr_t>(Alignment) - 1);
+            if (Aligned + Size <= Base + FRenderCommandChunk::ChunkSize)
+            {
+                Chunk->Offset = static_cast<uint32>(Aligned + Size - Base);
+                ++Chunk->NumAllocated;
+                OutChunk = Chunk;
+                return reinterpret_cast<void*>(Aligned);
+            }
+            
+            // Full - hand it over to the consumer and start a new one
+            GRenderCommandChunkPool.Retire(Chunk);
+        }
+        ThreadChunk.Chunk = GRenderCommandChunkPool.Acquire();
     }
-    QueueCondition.notify_one();
 }
 
-uint32 FRenderCommandQueue::ProcessCommands()
+bool FRenderCommandQueue::EnqueueCommand(std::unique_ptr<FRenderCommandBase> Command)
 {
-    uint32 ProcessedCount = 0;
-    
-    std::queue<std::unique_ptr<FRenderCommandBase>> LocalCommands;
+    if (!Command)
+    {
+        return false;
+    }
     
-    // Quickly swap the queue to minimize lock time
+    ActiveProducers.fetch_add(1);
+    if (bShutdown)
     {
-        std::lock_guard<std::mutex> Lock(QueueMutex);
-        std::swap(LocalCommands, Commands);
+        ActiveProducers.fetch_sub(1, std::memory_order_release);
+        return false;
     }
     
-    // Process all commands
-    while (!LocalCommands.empty())
+    Command->Chunk = nullptr;
+    Push(Command.release());
+    ActiveProducers.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void FRenderCommandQueue::Push(FRenderCommandBase* Command)
+{
+    // Counted before linking so Pop can never decrement below zero
+    PendingCount.fetch_add(1, std::memory_order_relaxed);
+    
+    Command->Next.store(nullptr, std::memory_order_relaxed);
+    FRenderCommandBase* Previous = Head.exchange(Command, std::memory_order_acq_rel);
+    Previous->Next.store(Command, std::memory_order_release);
+    
+    // Pairs with the fence in WaitAndProcessCommand: either the consumer sees
+    // our command before parking, or we see it waiting and notify
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (bConsumerWaiting.load(std::memory_order_relaxed))
     {
-        auto& Command = LocalCommands.front();
-        if (Command)
         {
-            // Store command name before execution for safe error reporting
-            const char* CommandName = Command->GetName();
-            try
-            {
-                Command->Execute();
-            }
-            catch (const std::exception& e)
-            {
-                FLog::Log(ELogLevel::Error, std::string("Render command exception (") + 
-                    CommandName + "): " + e.what());
-            }
-            catch (...)
-            {
-                FLog::Log(ELogLevel::Error, std::string("Render command exception (") + 
-                    CommandName + "): Unknown error");
-            }
+            std::lock_guard<std::mutex> Lock(WaitMutex);
         }
-        LocalCommands.pop();
-        ++ProcessedCount;
+        WaitCondition.notify_one();
     }
-    
-    return ProcessedCount;
 }
 
-bool FRenderCommandQueue::ProcessOneCommand()
+FRenderCommandBase* FRenderCommandQueue::Pop()
 {
-    std::unique_ptr<FRenderCommandBase> Command;
+    FRenderCommandBase* CurrentTail = Tail;
+    FRenderCommandBase* Next = CurrentTail->Next.load(std::memory_order_acquire);
     
+    if (CurrentTail == &Stub)
     {
-        std::lock_guard<std::mutex> Lock(QueueMutex);
-        if (Commands.empty())
+        if (!Next)
         {
-            return false;
+            return nullptr;
         }
-        Command = std::move(Commands.front());
-        Commands.pop();
+        Tail = Next;
+        CurrentTail = Next;
+        Next = Next->Next.load(std::memory_order_acquire);
     }
     
-    if (Command)
+    if (Next)
     {
-        // Store command name before execution for safe error reporting
-        const char* CommandName = Command->GetName();
-        try
+        Tail = Next;
+        PendingCount.fetch_sub(1, std::memory_order_relaxed);
+        return CurrentTail;
+    }
+    
+    // CurrentTail is the last node; a producer may be between exchange and link
+    if (CurrentTail != Head.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    
+    // Re-insert the stub behind the last node so it can be detached
+    Stub.Next.store(nullptr, std::memory_order_relaxed);
+    FRenderCommandBase* Previous = Head.exchange(&Stub, std::memory_order_acq_rel);
+    Previous->Next.store(&Stub, std::memory_order_release);
+    
+    Next = CurrentTail->Next.load(std::memory_order_acquire);
+    if (Next)
+    {
+        Tail = Next;
+        PendingCount.fetch_sub(1, std::memory_order_relaxed);
+        return CurrentTail;
+    }
+    return nullptr;
+}
+
+void FRenderCommandQueue::ExecuteCommand(FRenderCommandBase* Command)
+{
+    // Store command name before execution for safe error reporting
+    const char* CommandName = Command->GetName();
+    try
+    {
+        Command->Execute();
+    }
+    catch (const std::exception& e)
+    {
+        FLog::Log(ELogLevel::Error, std::string("Render command exception (") + 
+            CommandName + "): " + e.what());
+    }
+    catch (...)
+    {
+        FLog::Log(ELogLevel::Error, std::string("Render command exception (") + 
+            CommandName + "): Unknown error");
+    }
+}
+
+void FRenderCommandQueue::DestroyCommands(FRenderCommandBase* First)
+{
+    // Consecutive commands usually share a chunk - release each run with one atomic
+    FRenderCommandChunk* RunChunk = nullptr;
+    int32 RunLength = 0;
+    
+    for (FRenderCommandBase* Command = First; Command; )
+    {
+        FRenderCommandBase* Next = Command->Next.load(std::memory_order_relaxed);
+        FRenderCommandChunk* Chunk = Command->Chunk;
+        
+        if (Chunk)
         {
-            Command->Execute();
+            Command->~FRenderCommandBase();
+            if (Chunk != RunChunk)
+            {
+                if (RunChunk)
+                {
+                    GRenderCommandChunkPool.Release(RunChunk, RunLength);
+                }
+                RunChunk = Chunk;
+                RunLength = 0;
+            }
+            ++RunLength;
         }
-        catch (const std::exception& e)
+        else
         {
-            FLog::Log(ELogLevel::Error, std::string("Render command exception (") + 
-                CommandName + "): " + e.what());
+            delete Command;
         }
+        Command = Next;
     }
     
-    return true;
+    if (RunChunk)
+    {
+        GRenderCommandChunkPool.Release(RunChunk, RunLength);
+    }
 }
 
-bool FRenderCommandQueue::WaitAndProcessCommand()
+uint32 FRenderCommandQueue::ProcessCommands()
 {
-    std::unique_ptr<FRenderCommandBase> Command;
+    uint32 ProcessedCount = 0;
     
+    // Execute in order, chaining executed commands for bulk destruction.
+    // A popped command is detached from the queue, so its Next link is free to reuse.
+    FRenderCommandBase* First = nullptr;
+    FRenderCommandBase* Last = nullptr;
+    while (FRenderCommandBase* Command = Pop())
     {
-        std::unique_lock<std::mutex> Lock(QueueMutex);
-        QueueCondition.wait(Lock, [this]() {
-            return !Commands.empty() || bShutdown;
-        });
+        ExecuteCommand(Command);
         
-        if (bShutdown && Commands.empty())
+        Command->Next.store(nullptr, std::memory_order_relaxed);
+        if (Last)
         {
-            return false;
+            Last->Next.store(Command, std::memory_order_relaxed);
         }
-        
-        if (!Commands.empty())
+        else
         {
-            Command = std::move(Commands.front());
-            Commands.pop();
+            First = Command;
         }
+        Last = Command;
+        ++ProcessedCount;
     }
     
-    if (Command)
+    DestroyCommands(First);
+    return ProcessedCount;
+}
+
+bool FRenderCommandQueue::ProcessOneCommand()
+{
+    FRenderCommandBase* Command = Pop();
+    if (!Command)
     {
-        // Store command name before execution for safe error reporting
-        const char* CommandName = Command->GetName();
-        try
+        return false;
+    }
+    
+    ExecuteCommand(Command);
+    Command->Next.store(nullptr, std::memory_order_relaxed);
+    DestroyCommands(Command);
+    return true;
+}
+
+bool FRenderCommandQueue::WaitAndProcessCommand()
+{
+    while (true)
+    {
+        if (ProcessOneCommand())
         {
-            Command->Execute();
+            return true;
         }
-        catch (const std::exception& e)
+        if (bShutdown)
         {
-            FLog::Log(ELogLevel::Error, std::string("Render command exception (") + 
-                CommandName + "): " + e.what());
+            return false;
+        }
+        
+        // Announce we are about to park, then re-check so a concurrent Push
+        // either sees the flag or its command is visible to us
+        bConsumerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (PendingCount.load(std::memory_order_relaxed) == 0 && !bShutdown)
+        {
+            std::unique_lock<std::mutex> Lock(WaitMutex);
+            WaitCondition.wait(Lock, [this]() {
+                return PendingCount.load(std::memory_order_acquire) > 0 || bShutdown;
+            });
         }
+        bConsumerWaiting.store(false, std::memory_order_relaxed);
     }
-    
-    return true;
 }
 
 void FRenderCommandQueue::SignalShutdown()
 {
-    bShutdown = true;
-    QueueCondition.notify_all();
+    {
+        std::lock_guard<std::mutex> Lock(WaitMutex);
+        bShutdown = true;
+    }
+    WaitCondition.notify_all();
+    
+    // Producers that saw the queue open are linking their command in; wait for them
+    // (seq_cst on both sides: either a producer sees bShutdown or we see it registered)
+    while (ActiveProducers.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
 }
 
 bool FRenderCommandQueue::HasPendingCommands() const
 {
-    std::lock_guard<std::mutex> Lock(QueueMutex);
-    return !Commands.empty();
+    return PendingCount.load(std::memory_order_acquire) > 0;
 }
 
 uint32 FRenderCommandQueue::GetPendingCommandCount() const
 {
-    std::lock_guard<std::mutex> Lock(QueueMutex);
-    return static_cast<uint32>(Commands.size());
+    return PendingCount.load(std::memory_order_acquire);
+}
+
+uint32 FRenderCommandQueue::GetNumAllocatedChunks()
+{
+    return GRenderCommandChunkPool.GetNumAllocated();
 }
 
 FRenderCommandQueue& FRenderCommandQueue::Get()
@@ -203,6 +447,9 @@ void FRenderThread::Start()
     
     FLog::Log(ELogLevel::Info, "Starting render thread");
     
+    // Stop() shut the queue down; commands (and fence markers) must be accepted again
+    FRenderCommandQueue::Get().ResetShutdown();
+    
     bShouldStop = false;
     bRunning = true;
     
@@ -218,6 +465,9 @@ void FRenderThread::Stop()
     
     FLog::Log(ELogLevel::Info, "Stopping render thread");
     
+    // Close the queue first: every command accepted before this is pushed by the time it
+    // returns, so the thread's final ProcessCommands runs it (fence markers included)
+    FRenderCommandQueue::Get().SignalShutdown();
     bShouldStop = true;
     
     // Signal to wake up the thread
@@ -226,7 +476,6 @@ void FRenderThread::Stop()
         bFrameReady = true;
     }
     FrameReadyCondition.notify_all();
-    FRenderCommandQueue::Get().SignalShutdown();
     
     if (Thread.joinable())
     {
@@ -315,8 +564,7 @@ FRHIThread::FRHIThread()
     : bRunning(false)
     , bShouldStop(false)
     , RHI(nullptr)
-    , bFrameReady(false)
-    , bFrameComplete(true)
+    , bWorkInProgress(false)
 {
 }
 
@@ -349,14 +597,11 @@ void FRHIThread::Stop()
     
     FLog::Log(ELogLevel::Info, "Stopping RHI thread");
     
-    bShouldStop = true;
-    
-    // Signal to wake up the thread
+    // Signal to wake up the thread; queued work still runs before it exits
     {
-        std::lock_guard<std::mutex> Lock(FrameMutex);
-        bFrameReady = true;
+        std::lock_guard<std::mutex> Lock(WorkMutex);
+        bShouldStop = true;
     }
-    FrameReadyCondition.notify_all();
     WorkCondition.notify_all();
     
     if (Thread.joinable())
@@ -368,30 +613,32 @@ void FRHIThread::Stop()
     FLog::Log(ELogLevel::Info, "RHI thread stopped");
 }
 
-void FRHIThread::EnqueueWork(std::function<void()> Work)
+bool FRHIThread::EnqueueWork(std::function<void()> Work)
 {
     {
+        // Checked under the lock: once the loop has seen bShouldStop with an empty
+        // queue it exits, and anything pushed after that would never run
         std::lock_guard<std::mutex> Lock(WorkMutex);
+        if (bShouldStop || !bRunning)
+        {
+            return false;
+        }
         WorkQueue.push(std::move(Work));
     }
     WorkCondition.notify_one();
+    return true;
 }
 
 void FRHIThread::SignalFrameReady()
 {
-    {
-        std::lock_guard<std::mutex> Lock(FrameMutex);
-        bFrameReady = true;
-        bFrameComplete = false;
-    }
-    FrameReadyCondition.notify_one();
+    WorkCondition.notify_one();
 }
 
 void FRHIThread::WaitForFrameComplete()
 {
-    std::unique_lock<std::mutex> Lock(FrameMutex);
-    FrameCompleteCondition.wait(Lock, [this]() {
-        return bFrameComplete.load() || bShouldStop;
+    std::unique_lock<std::mutex> Lock(WorkMutex);
+    WorkCompleteCondition.wait(Lock, [this]() {
+        return (WorkQueue.empty() && !bWorkInProgress) || !bRunning;
     });
 }
 
@@ -411,49 +658,42 @@ void FRHIThread::ThreadLoop()
     
     FLog::Log(ELogLevel::Info, "RHI thread loop started");
     
-    while (!bShouldStop)
+    std::unique_lock<std::mutex> Lock(WorkMutex);
+    while (true)
     {
-        // Wait for frame ready or work available
+        WorkCondition.wait(Lock, [this]() {
+            return !WorkQueue.empty() || bShouldStop;
+        });
+        
+        if (WorkQueue.empty())
         {
-            std::unique_lock<std::mutex> Lock(FrameMutex);
-            FrameReadyCondition.wait(Lock, [this]() {
-                return bFrameReady.load() || bShouldStop;
-            });
-            
-            if (bShouldStop)
-            {
-                break;
-            }
-            
-            bFrameReady = false;
+            // Stop requested and everything enqueued has run
+            break;
         }
         
-        // Process all work for this frame
+        // Run one item outside the lock so producers never wait on RHI work
+        auto Work = std::move(WorkQueue.front());
+        WorkQueue.pop();
+        bWorkInProgress = true;
+        Lock.unlock();
+        
+        try
         {
-            std::lock_guard<std::mutex> Lock(WorkMutex);
-            while (!WorkQueue.empty())
-            {
-                auto Work = std::move(WorkQueue.front());
-                WorkQueue.pop();
-                
-                try
-                {
-                    Work();
-                }
-                catch (const std::exception& e)
-                {
-                    FLog::Log(ELogLevel::Error, std::string("RHI work exception: ") + e.what());
-                }
-            }
+            Work();
+        }
+        catch (const std::exception& e)
+        {
+            FLog::Log(ELogLevel::Error, std::string("RHI work exception: ") + e.what());
         }
         
-        // Signal frame complete
+        Lock.lock();
+        bWorkInProgress = false;
+        if (WorkQueue.empty())
         {
-            std::lock_guard<std::mutex> Lock(FrameMutex);
-            bFrameComplete = true;
+            WorkCompleteCondition.notify_all();
         }
-        FrameCompleteCondition.notify_all();
     }
+    Lock.unlock();
     
     FLog::Log(ELogLevel::Info, "RHI thread loop ended");
 }
@@ -462,12 +702,23 @@ void FRHIThread::ThreadLoop()
 // FFrameSyncManager Implementation
 // ============================================================================
 
+// Every frame that can be in flight needs its own recorder slot
+static_assert(FRenderer::MaxFramesInFlight >= FFrameSyncManager::MaxFrameLead + 1,
+              "FRenderer's recorder ring must cover the maximum frame lead");
+
+// ... and its own latency record until it is presented
+static_assert(FFrameLatencyTracker::MaxFramesTracked >= FFrameSyncManager::MaxFrameLead + 1,
+              "FFrameLatencyTracker must track every frame that can be in flight");
+
 std::unique_ptr<FFrameSyncManager> FFrameSyncManager::Singleton;
 
 FFrameSyncManager::FFrameSyncManager()
     : GameFrameNumber(0)
     , RenderFrameNumber(0)
     , RHIFrameNumber(0)
+    , RHICompletedFrameNumber(0)
+    , FrameLead(MinFrameLead)
+    , bShutdown(false)
 {
 }
 
@@ -484,18 +735,34 @@ void FFrameSyncManager::Initialize()
 void FFrameSyncManager::Shutdown()
 {
     // Wake up any waiting threads
+    {
+        std::lock_guard<std::mutex> Lock(SyncMutex);
+        bShutdown = true;
+    }
     GameCanProceedCondition.notify_all();
     FLog::Log(ELogLevel::Info, "Frame sync manager shutdown");
 }
 
+void FFrameSyncManager::SetFrameLead(uint32 InFrameLead)
+{
+    uint32 NewFrameLead = std::min(std::max(InFrameLead, MinFrameLead), MaxFrameLead);
+    {
+        std::lock_guard<std::mutex> Lock(SyncMutex);
+        FrameLead = NewFrameLead;
+    }
+    // A larger lead may let a waiting game thread start right away
+    GameCanProceedCondition.notify_all();
+    FLog::Log(ELogLevel::Info, std::string("Frame lead set to ") + std::to_string(NewFrameLead));
+}
+
 void FFrameSyncManager::GameThread_BeginFrame()
 {
-    // Check if game is too far ahead of render
-    // If game frame > render frame + MaxFrameLead, wait
+    // Frames begun but not yet finished by the RHI thread must not exceed
+    // the frame lead before the game thread may start another one
     {
         std::unique_lock<std::mutex> Lock(SyncMutex);
         GameCanProceedCondition.wait(Lock, [this]() {
-            return GameFrameNumber.load() < RenderFrameNumber.load() + MaxFrameLead + 1;
+            return GameFrameNumber.load() - RHICompletedFrameNumber.load() <= FrameLead.load() || bShutdown;
         });
     }
     
@@ -516,9 +783,6 @@ void FFrameSyncManager::RenderThread_BeginFrame()
 
 void FFrameSyncManager::RenderThread_EndFrame()
 {
-    // Signal game thread that it can proceed
-    GameCanProceedCondition.notify_all();
-    
     // Signal RHI thread
     FRHIThread::Get().SignalFrameReady();
 }
@@ -530,7 +794,13 @@ void FFrameSyncManager::RHIThread_BeginFrame()
 
 void FFrameSyncManager::RHIThread_EndFrame()
 {
-    // RHI frame complete - nothing specific to do here
+    {
+        std::lock_guard<std::mutex> Lock(SyncMutex);
+        ++RHICompletedFrameNumber;
+    }
+    
+    // Signal game thread that it can proceed
+    GameCanProceedCondition.notify_all();
 }
 
 FFrameSyncManager& FFrameSyncManager::Get()
@@ -542,3 +812,75 @@ FFrameSyncManager& FFrameSyncManager::Get()
     }
     return *Singleton;
 }
+
+// ============================================================================
+// FRenderFence Implementation
+// ============================================================================
+
+FRenderFence::FRenderFence()
+    : bFenceSet(false)
+{
+}
+
+FRenderFence::~FRenderFence()
+{
+    // Ensure we wait for any pending fence before destruction
+    if (bFenceSet && Event && !Event->IsComplete())
+    {
+        Wait();
+    }
+}
+
+void FRenderFence::BeginFence(bool bSyncToRHIThread)
+{
+    Event = FTaskEvent::Create();
+    bFenceSet = true;
+    
+    if (!FRenderThread::Get().IsRunning())
+    {
+        Event->Signal();
+        return;
+    }
+    
+    // The thread may be stopping: a marker the closed queue rejects would never be
+    // signalled, so signal it here instead
+    FGraphEventRef FenceEvent = Event;
+    bool bQueued = ENQUEUE_RENDER_COMMAND(FenceCommand)[FenceEvent, bSyncToRHIThread]()
+    {
+        // Same for the RHI thread: signal here if it no longer accepts work
+        bool bQueuedOnRHI = bSyncToRHIThread && FRHIThread::Get().EnqueueWork([FenceEvent]()
+        {
+            FenceEvent->Signal();
+        });
+        if (!bQueuedOnRHI)
+        {
+            FenceEvent->Signal();
+        }
+    });
+    if (!bQueued)
+    {
+        Event->Signal();
+    }
+}
+
+void FRenderFence::Wait()
+{
+    if (bFenceSet && Event)
+    {
+        if (!Event->IsComplete())
+        {
+            FRenderThread::Get().SignalFrameReady();
+        }
+        Event->Wait();
+        bFenceSet = false;
+    }
+}
+
+bool FRenderFence::IsFenceComplete() const
+{
+    if (bFenceSet && Event)
+    {
+        return Event->IsComplete();
+    }
+    return true;  // No fence means complete
+}
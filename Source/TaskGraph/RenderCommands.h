@@ -7,24 +7,29 @@
 #include <memory>
 #include <atomic>
 #include <condition_variable>
+#include <new>
+#include <type_traits>
 
 /**
  * Render Command System
  * 
- * This system allows the game thread to enqueue rendering commands
+ * This system allows any thread to enqueue rendering commands
  * that will be executed on the render thread, similar to UE5's
  * ENQUEUE_RENDER_COMMAND macro and render command system.
  * 
  * Key concepts:
  * - FRenderCommandBase: Base class for render commands
- * - FRenderCommandQueue: Thread-safe queue for render commands
+ * - FRenderCommandQueue: Lock-free multi-producer/single-consumer queue
+ * - FRenderCommandChunk: Linear memory that lambda commands are constructed in
  * - ENQUEUE_RENDER_COMMAND: Macro for enqueuing lambda-based commands
+ * - FRenderFence: Marker the game thread can wait on until the render (or RHI) thread reaches it
  */
 
 // Forward declarations
 class FRenderer;
 class FRHI;
 class FRHICommandList;
+struct FRenderCommandChunk;
 
 /**
  * FRenderCommandBase - Base class for all render commands
@@ -40,6 +45,15 @@ public:
     
 protected:
     const char* Name = "Unknown";
+    
+private:
+    friend class FRenderCommandQueue;
+    
+    // Intrusive link for the MPSC queue (and the executed list afterwards)
+    std::atomic<FRenderCommandBase*> Next{ nullptr };
+    
+    // Chunk the command was constructed in, or nullptr if heap allocated
+    FRenderCommandChunk* Chunk = nullptr;
 };
 
 /**
@@ -49,8 +63,9 @@ template<typename LambdaType>
 class FLambdaRenderCommand : public FRenderCommandBase 
 {
 public:
-    FLambdaRenderCommand(const char* InName, LambdaType&& InLambda)
-        : Lambda(std::forward<LambdaType>(InLambda))
+    template<typename InLambdaType>
+    FLambdaRenderCommand(const char* InName, InLambdaType&& InLambda)
+        : Lambda(std::forward<InLambdaType>(InLambda))
     {
         Name = InName;
     }
@@ -65,11 +80,37 @@ private:
 };
 
 /**
- * FRenderCommandQueue - Thread-safe queue for render commands
+ * FRenderCommandChunk - block of linear memory for render commands
+ * 
+ * Each producer thread bump-allocates commands from its own chunk, so
+ * enqueueing never touches the heap or a lock. A chunk is recycled once its
+ * producer has moved on (retired it) and the render thread has destroyed
+ * every command in it. Retirement adds the number of allocated commands to
+ * Balance and the consumer subtracts destroyed ones in bulk, so whichever
+ * side brings Balance back to zero returns the chunk to the free list.
+ */
+struct FRenderCommandChunk
+{
+    static constexpr uint32 ChunkSize = 64 * 1024;
+    
+    // Producer-owned bump state
+    uint32 Offset = 0;
+    uint32 NumAllocated = 0;
+    
+    // Allocated (added at retirement) minus destroyed
+    std::atomic<int32> Balance{ 0 };
+    
+    alignas(16) uint8 Data[ChunkSize];
+};
+
+/**
+ * FRenderCommandQueue - Lock-free queue for render commands
  * 
- * The game thread enqueues commands, and the render thread dequeues
- * and executes them. This implements a producer-consumer pattern
- * similar to UE5's render command pipe.
+ * Any thread can enqueue; only the render thread dequeues and executes.
+ * Commands are linked into an intrusive Vyukov MPSC queue: enqueue is one
+ * atomic exchange, dequeue never blocks producers. Lambda commands are
+ * placement-constructed in per-thread FRenderCommandChunk memory and
+ * destroyed in bulk after a batch has executed.
  */
 class FRenderCommandQueue 
 {
@@ -77,16 +118,34 @@ public:
     FRenderCommandQueue();
     ~FRenderCommandQueue();
     
-    // Enqueue a command (called from game thread)
-    void EnqueueCommand(std::unique_ptr<FRenderCommandBase> Command);
+    // Enqueue a heap-allocated command (any thread)
+    // Returns false if the queue is shut down and the command was dropped
+    bool EnqueueCommand(std::unique_ptr<FRenderCommandBase> Command);
     
-    // Enqueue a lambda command (called from game thread)
+    // Enqueue a lambda command (any thread)
+    // Returns false if the queue is shut down and the command was dropped
     template<typename LambdaType>
-    void EnqueueLambda(const char* Name, LambdaType&& Lambda)
+    bool EnqueueLambda(const char* Name, LambdaType&& Lambda)
     {
-        auto Command = std::make_unique<FLambdaRenderCommand<LambdaType>>(
-            Name, std::forward<LambdaType>(Lambda));
-        EnqueueCommand(std::move(Command));
+        using CommandType = FLambdaRenderCommand<std::decay_t<LambdaType>>;
+        
+        // Registered before the check so SignalShutdown can wait for us to finish pushing
+        ActiveProducers.fetch_add(1);
+        if (bShutdown)
+        {
+            ActiveProducers.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+        
+        FRenderCommandChunk* Chunk = nullptr;
+        void* Memory = AllocateCommandMemory(sizeof(CommandType), alignof(CommandType), Chunk);
+        FRenderCommandBase* Command = Memory
+            ? new (Memory) CommandType(Name, std::forward<LambdaType>(Lambda))
+            : new CommandType(Name, std::forward<LambdaType>(Lambda));  // Too large for a chunk
+        Command->Chunk = Chunk;
+        Push(Command);
+        ActiveProducers.fetch_sub(1, std::memory_order_release);
+        return true;
     }
     
     // Process all pending commands (called from render thread)
@@ -101,23 +160,62 @@ public:
     // Returns false if shutdown was signaled
     bool WaitAndProcessCommand();
     
-    // Signal the queue to wake up for shutdown
+    // Signal the queue to wake up for shutdown (further enqueues are dropped). Returns once
+    // every enqueue that was accepted has been pushed, so a final ProcessCommands sees it
     void SignalShutdown();
     
+    // Accept commands again after SignalShutdown (render thread restart)
+    void ResetShutdown() { bShutdown = false; }
+    
     // Check if there are pending commands
     bool HasPendingCommands() const;
     
     // Get the number of pending commands
     uint32 GetPendingCommandCount() const;
     
+    // Number of command chunks ever allocated, across all queues (stays flat in steady state)
+    static uint32 GetNumAllocatedChunks();
+    
     // Get singleton instance
     static FRenderCommandQueue& Get();
     
 private:
-    std::queue<std::unique_ptr<FRenderCommandBase>> Commands;
-    mutable std::mutex QueueMutex;
-    std::condition_variable QueueCondition;
+    // Bump-allocate from the calling thread's chunk. Returns nullptr if the
+    // command does not fit in a chunk; OutChunk receives the owning chunk.
+    static void* AllocateCommandMemory(size_t Size, size_t Alignment, FRenderCommandChunk*& OutChunk);
+    
+    // Producer side: link a command at the head and wake the consumer if parked
+    void Push(FRenderCommandBase* Command);
+    
+    // Consumer side: unlink the oldest command, or nullptr if none is ready
+    FRenderCommandBase* Pop();
+    
+    // Run a command, logging (not propagating) exceptions
+    static void ExecuteCommand(FRenderCommandBase* Command);
+    
+    // Destroy a list of executed commands linked through Next, releasing chunks in runs
+    static void DestroyCommands(FRenderCommandBase* First);
+    
+    // Stub node that keeps the queue non-empty (never executed)
+    class FStubCommand : public FRenderCommandBase
+    {
+    public:
+        virtual void Execute() override {}
+    };
+    
+    // Producers exchange Head; the consumer owns Tail
+    alignas(64) std::atomic<FRenderCommandBase*> Head;
+    alignas(64) FRenderCommandBase* Tail;
+    FStubCommand Stub;
+    
+    std::atomic<uint32> PendingCount;
+    
+    // Parking for WaitAndProcessCommand; producers only lock when it is in use
+    std::mutex WaitMutex;
+    std::condition_variable WaitCondition;
+    std::atomic<bool> bConsumerWaiting;
     std::atomic<bool> bShutdown;
+    std::atomic<uint32> ActiveProducers;    // Enqueues between the shutdown check and their push
     
     static std::unique_ptr<FRenderCommandQueue> Singleton;
 };
@@ -182,8 +280,9 @@ private:
  * FRHIThread - The RHI thread that translates and executes RHI commands
  * 
  * In UE5, the RHI thread is responsible for translating platform-agnostic
- * RHI commands into actual GPU commands. This simplified version just
- * executes the RHI commands.
+ * RHI commands into actual GPU commands. Here it runs enqueued work items in
+ * order - in the pipelined frame loop, one item per frame that replays the
+ * render thread's recorded command stream and presents it.
  */
 class FRHIThread 
 {
@@ -203,13 +302,14 @@ public:
     // Set RHI
     void SetRHI(FRHI* InRHI) { RHI = InRHI; }
     
-    // Enqueue RHI work
-    void EnqueueWork(std::function<void()> Work);
+    // Enqueue RHI work (wakes the thread; items run in enqueue order)
+    // Returns false if the thread is stopped or stopping and the work was dropped
+    bool EnqueueWork(std::function<void()> Work);
     
-    // Signal frame ready for RHI processing
+    // Signal frame ready for RHI processing (EnqueueWork already wakes the thread)
     void SignalFrameReady();
     
-    // Wait for RHI frame complete
+    // Wait until every enqueued work item has run
     void WaitForFrameComplete();
     
     // Get singleton
@@ -229,12 +329,9 @@ private:
     std::mutex WorkMutex;
     std::condition_variable WorkCondition;
     
-    // Frame synchronization
-    std::mutex FrameMutex;
-    std::condition_variable FrameReadyCondition;
-    std::condition_variable FrameCompleteCondition;
-    std::atomic<bool> bFrameReady;
-    std::atomic<bool> bFrameComplete;
+    // Signalled (under WorkMutex) when the queue drains and no item is running
+    std::condition_variable WorkCompleteCondition;
+    bool bWorkInProgress;
     
     static std::unique_ptr<FRHIThread> Singleton;
 };
@@ -242,8 +339,15 @@ private:
 /**
  * Frame Synchronization Manager
  * 
- * Manages the synchronization between Game, Render, and RHI threads
- * following UE5's pattern where Game can lead Render by 1 frame.
+ * Manages the synchronization between Game, Render, and RHI threads.
+ * The frame lead is the number of frames the game thread may run ahead of
+ * the last frame the RHI thread finished submitting:
+ * - 1: game overlaps render or RHI, lowest latency (UE5's default)
+ * - 2: game, render and RHI can all be busy on three consecutive frames
+ * - 3: one extra frame of buffering to absorb stage hitches
+ * Higher leads trade input latency for throughput. Per-frame resources that
+ * live across stages (FRenderer's command recorders) are ring-buffered with
+ * MaxFrameLead + 1 slots.
  */
 class FFrameSyncManager 
 {
@@ -257,10 +361,10 @@ public:
     // Shutdown synchronization
     void Shutdown();
     
-    // Game thread: Start a new frame
+    // Game thread: Start a new frame (waits while FrameLead frames are still in flight)
     void GameThread_BeginFrame();
     
-    // Game thread: End frame (may wait if 1 frame ahead)
+    // Game thread: End frame
     void GameThread_EndFrame();
     
     // Render thread: Begin processing a frame
@@ -272,15 +376,25 @@ public:
     // RHI thread: Begin processing a frame
     void RHIThread_BeginFrame();
     
-    // RHI thread: End frame
+    // RHI thread: End frame (frees the game thread to start another frame)
     void RHIThread_EndFrame();
     
+    // Frame lead, clamped to [MinFrameLead, MaxFrameLead]; takes effect at the next GameThread_BeginFrame
+    void SetFrameLead(uint32 InFrameLead);
+    uint32 GetFrameLead() const { return FrameLead; }
+    
+    static constexpr uint32 MinFrameLead = 1;
+    static constexpr uint32 MaxFrameLead = 3;
+    
     // Get current game frame number
     uint64 GetGameFrameNumber() const { return GameFrameNumber; }
     
     // Get current render frame number
     uint64 GetRenderFrameNumber() const { return RenderFrameNumber; }
     
+    // Number of frames the RHI thread has finished
+    uint64 GetRHICompletedFrameNumber() const { return RHICompletedFrameNumber; }
+    
     // Get singleton
     static FFrameSyncManager& Get();
     
@@ -288,17 +402,50 @@ private:
     std::atomic<uint64> GameFrameNumber;
     std::atomic<uint64> RenderFrameNumber;
     std::atomic<uint64> RHIFrameNumber;
+    std::atomic<uint64> RHICompletedFrameNumber;
+    std::atomic<uint32> FrameLead;
+    std::atomic<bool> bShutdown;
     
-    // Fence for game-render synchronization
+    // Fence for game-RHI synchronization
     std::mutex SyncMutex;
     std::condition_variable GameCanProceedCondition;
     
-    // Maximum frame lead (game can be at most this many frames ahead of render)
-    static constexpr uint64 MaxFrameLead = 1;
-    
     static std::unique_ptr<FFrameSyncManager> Singleton;
 };
 
+/**
+ * FRenderFence - Fence for synchronizing between Game and Render threads
+ * Similar to UE5's FRenderCommandFence
+ * 
+ * BeginFence enqueues a marker render command; the render thread signals the
+ * fence when it executes the marker, i.e. once every command enqueued before
+ * it has run. With bSyncToRHIThread the render thread instead forwards the
+ * marker to the RHI thread, so the fence completes after all RHI work queued
+ * up to that point (recorded frames replayed and presented).
+ * 
+ * If the render (RHI) thread is not running, the marker completes at once.
+ */
+class FRenderFence 
+{
+public:
+    FRenderFence();
+    ~FRenderFence();
+    
+    // Begin the fence (called from game thread)
+    void BeginFence(bool bSyncToRHIThread = false);
+    
+    // Wait for the fence to complete (blocks game thread)
+    // Kicks the render thread so a marker enqueued mid-frame is not stuck behind the frame signal
+    void Wait();
+    
+    // Check if fence is complete without blocking
+    bool IsFenceComplete() const;
+    
+private:
+    FGraphEventRef Event;
+    std::atomic<bool> bFenceSet;
+};
+
 /**
  * Macro to enqueue a render command
  * 
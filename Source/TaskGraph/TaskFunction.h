@@ -0,0 +1,162 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * FTaskFunction - move-only void() callable with small-buffer optimization
+ *
+ * Replaces std::function for task bodies. Callables up to InlineSize bytes
+ * (typical lambdas capturing a few pointers) are stored inline, so creating a
+ * task does not touch the heap. Larger callables fall back to a heap allocation.
+ * Similar to UE5's TUniqueFunction with its inline allocator.
+ */
+class FTaskFunction
+{
+public:
+    static constexpr size_t InlineSize = 48;
+
+    FTaskFunction() : Ops(nullptr), HeapCallable(nullptr) {}
+
+    template<typename FunctorType,
+             typename = std::enable_if_t<!std::is_same<std::decay_t<FunctorType>, FTaskFunction>::value>>
+    FTaskFunction(FunctorType&& Functor)
+        : Ops(nullptr)
+        , HeapCallable(nullptr)
+    {
+        Set(std::forward<FunctorType>(Functor));
+    }
+
+    FTaskFunction(FTaskFunction&& Other) noexcept
+        : Ops(nullptr)
+        , HeapCallable(nullptr)
+    {
+        MoveFrom(Other);
+    }
+
+    FTaskFunction& operator=(FTaskFunction&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            Reset();
+            MoveFrom(Other);
+        }
+        return *this;
+    }
+
+    FTaskFunction(const FTaskFunction&) = delete;
+    FTaskFunction& operator=(const FTaskFunction&) = delete;
+
+    ~FTaskFunction()
+    {
+        Reset();
+    }
+
+    void operator()()
+    {
+        Ops->Invoke(GetCallable());
+    }
+
+    explicit operator bool() const { return Ops != nullptr; }
+
+    // True if the callable lives in the inline buffer (no heap allocation)
+    bool IsInline() const { return Ops != nullptr && HeapCallable == nullptr; }
+
+    // Destroy the stored callable (releases captures immediately)
+    void Reset()
+    {
+        if (Ops)
+        {
+            if (HeapCallable)
+            {
+                Ops->DeleteHeap(HeapCallable);
+                HeapCallable = nullptr;
+            }
+            else
+            {
+                Ops->Destroy(InlineStorage);
+            }
+            Ops = nullptr;
+        }
+    }
+
+private:
+    // Type-erased operations for the stored callable
+    struct FOps
+    {
+        void (*Invoke)(void* Callable);
+        void (*MoveConstruct)(void* Dest, void* Source);  // inline storage only
+        void (*Destroy)(void* Callable);                  // inline storage only
+        void (*DeleteHeap)(void* Callable);
+    };
+
+    template<typename FunctorType>
+    struct TOps
+    {
+        static void Invoke(void* Callable) { (*static_cast<FunctorType*>(Callable))(); }
+        static void MoveConstruct(void* Dest, void* Source) { new (Dest) FunctorType(std::move(*static_cast<FunctorType*>(Source))); }
+        static void Destroy(void* Callable) { static_cast<FunctorType*>(Callable)->~FunctorType(); }
+        static void DeleteHeap(void* Callable) { delete static_cast<FunctorType*>(Callable); }
+
+        static const FOps Table;
+    };
+
+    template<typename FunctorType>
+    void Set(FunctorType&& Functor)
+    {
+        using DecayedType = std::decay_t<FunctorType>;
+        constexpr bool bFitsInline = sizeof(DecayedType) <= InlineSize
+            && alignof(DecayedType) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<DecayedType>::value;
+
+        if constexpr (bFitsInline)
+        {
+            new (InlineStorage) DecayedType(std::forward<FunctorType>(Functor));
+        }
+        else
+        {
+            HeapCallable = new DecayedType(std::forward<FunctorType>(Functor));
+        }
+        Ops = &TOps<DecayedType>::Table;
+    }
+
+    void MoveFrom(FTaskFunction& Other)
+    {
+        if (!Other.Ops)
+        {
+            return;
+        }
+
+        Ops = Other.Ops;
+        if (Other.HeapCallable)
+        {
+            // Heap callables just transfer ownership
+            HeapCallable = Other.HeapCallable;
+            Other.HeapCallable = nullptr;
+        }
+        else
+        {
+            Ops->MoveConstruct(InlineStorage, Other.InlineStorage);
+            Ops->Destroy(Other.InlineStorage);
+        }
+        Other.Ops = nullptr;
+    }
+
+    void* GetCallable() { return HeapCallable ? HeapCallable : static_cast<void*>(InlineStorage); }
+
+    const FOps* Ops;
+    void* HeapCallable;
+    alignas(std::max_align_t) uint8 InlineStorage[InlineSize];
+};
+
+template<typename FunctorType>
+const FTaskFunction::FOps FTaskFunction::TOps<FunctorType>::Table =
+{
+    &FTaskFunction::TOps<FunctorType>::Invoke,
+    &FTaskFunction::TOps<FunctorType>::MoveConstruct,
+    &FTaskFunction::TOps<FunctorType>::Destroy,
+    &FTaskFunction::TOps<FunctorType>::DeleteHeap
+};
@@ -1,4 +1,25 @@
 #include "TaskGraph.h"
+#include "LockFreePool.h"
+
+/**
+ * FEventSubscriber - node in an event's subscriber list
+ * One per (task, prerequisite) pair; recycled once the event signals.
+ */
+struct FEventSubscriber
+{
+    FTask* Task = nullptr;
+    FTaskGraph* Graph = nullptr;
+    FEventSubscriber* Next = nullptr;
+};
+
+// Pools for recycled events, lambda tasks and subscriber nodes. Defined before
+// the FTaskGraph singleton so they outlive it during static destruction.
+static TLockFreePool<FTaskEvent> GTaskEventPool;
+static TLockFreePool<FLambdaTask> GLambdaTaskPool;
+static TLockFreePool<FEventSubscriber> GEventSubscriberPool;
+
+// Head value of a subscriber list that has been closed by Signal()
+static FEventSubscriber* const ClosedSubscriberList = reinterpret_cast<FEventSubscriber*>(uintptr_t(1));
 
 // ============================================================================
 // FTaskEvent Implementation
@@ -6,6 +27,9 @@
 
 FTaskEvent::FTaskEvent()
     : bComplete(false)
+    , Subscribers(nullptr)
+    , RefCount(0)
+    , bPooled(false)
 {
 }
 
@@ -13,6 +37,15 @@ FTaskEvent::~FTaskEvent()
 {
 }
 
+FGraphEventRef FTaskEvent::Create()
+{
+    FTaskEvent* Event = GTaskEventPool.Allocate();
+    Event->bPooled = true;
+    Event->bComplete = false;
+    Event->Subscribers.store(nullptr, std::memory_order_relaxed);
+    return FGraphEventRef(Event);
+}
+
 void FTaskEvent::Signal()
 {
     {
@@ -20,10 +53,59 @@ void FTaskEvent::Signal()
         bComplete = true;
     }
     Condition.notify_all();
+    
+    // Close the list so late subscribers see the event as complete, then
+    // dispatch everything that subscribed before
+    FEventSubscriber* Subscriber = Subscribers.exchange(ClosedSubscriberList, std::memory_order_acq_rel);
+    if (Subscriber == ClosedSubscriberList)
+    {
+        return;  // Already signalled
+    }
+    
+    while (Subscriber)
+    {
+        FEventSubscriber* Next = Subscriber->Next;
+        Subscriber->Graph->OnPrerequisiteComplete(Subscriber->Task, 1);
+        GEventSubscriberPool.Free(Subscriber);
+        Subscriber = Next;
+    }
+}
+
+bool FTaskEvent::AddSubscriber(FTask* Task, FTaskGraph* Graph)
+{
+    FEventSubscriber* Head = Subscribers.load(std::memory_order_acquire);
+    if (Head == ClosedSubscriberList)
+    {
+        return false;
+    }
+    
+    FEventSubscriber* Subscriber = GEventSubscriberPool.Allocate();
+    Subscriber->Task = Task;
+    Subscriber->Graph = Graph;
+    
+    // Push-only until Signal() takes the whole list, so a plain CAS has no ABA problem
+    do
+    {
+        if (Head == ClosedSubscriberList)
+        {
+            GEventSubscriberPool.Free(Subscriber);
+            return false;
+        }
+        Subscriber->Next = Head;
+    }
+    while (!Subscribers.compare_exchange_weak(Head, Subscriber, std::memory_order_release, std::memory_order_acquire));
+    
+    return true;
 }
 
 void FTaskEvent::Wait()
 {
+    // Fast path - no lock if the task already finished
+    if (bComplete.load())
+    {
+        return;
+    }
+    
     std::unique_lock<std::mutex> Lock(Mutex);
     Condition.wait(Lock, [this]() { return bComplete.load(); });
 }
@@ -33,12 +115,43 @@ bool FTaskEvent::IsComplete() const
     return bComplete.load();
 }
 
+void FTaskEvent::AddRef()
+{
+    RefCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FTaskEvent::Release()
+{
+    if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1 && bPooled)
+    {
+        // Last reference - nobody can observe the event any more, recycle it.
+        // Taking the lock orders us after a Signal() still inside notify.
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            bComplete = false;
+        }
+        GTaskEventPool.Free(this);
+    }
+}
+
+uint32 FTaskEvent::GetPoolCapacity()
+{
+    return GTaskEventPool.GetCapacity();
+}
+
 // ============================================================================
 // FTask Implementation
 // ============================================================================
 
 FTask::FTask()
-    : Event(std::make_unique<FTaskEvent>())
+    : Event(FTaskEvent::Create())
+    , NumPendingPrerequisites(0)
+{
+}
+
+FTask::FTask(FGraphEventRef InEvent)
+    : Event(std::move(InEvent))
+    , NumPendingPrerequisites(0)
 {
 }
 
@@ -50,8 +163,15 @@ FTask::~FTask()
 // FLambdaTask Implementation
 // ============================================================================
 
-FLambdaTask::FLambdaTask(std::function<void()> InLambda)
+FLambdaTask::FLambdaTask()
+    : FTask(FGraphEventRef())
+    , bPooled(false)
+{
+}
+
+FLambdaTask::FLambdaTask(FTaskFunction InLambda)
     : Lambda(std::move(InLambda))
+    , bPooled(false)
 {
 }
 
@@ -59,13 +179,53 @@ FLambdaTask::~FLambdaTask()
 {
 }
 
+FLambdaTask* FLambdaTask::Allocate(FTaskFunction&& InLambda)
+{
+    FLambdaTask* Task = GLambdaTaskPool.Allocate();
+    Task->Lambda = std::move(InLambda);
+    Task->Event = FTaskEvent::Create();
+    Task->bPooled = true;
+    return Task;
+}
+
+uint32 FLambdaTask::GetPoolCapacity()
+{
+    return GLambdaTaskPool.GetCapacity();
+}
+
 void FLambdaTask::Execute()
 {
     if (Lambda)
     {
-        Lambda();
+        try
+        {
+            Lambda();
+        }
+        catch (...)
+        {
+            // Still complete so waiters and the pool are not left hanging
+            Complete();
+            throw;
+        }
+    }
+    Complete();
+}
+
+void FLambdaTask::Complete()
+{
+    Lambda.Reset();
+    
+    // Take the event out first - once recycled this task may be reused immediately
+    FGraphEventRef CompletedEvent = std::move(Event);
+    if (bPooled)
+    {
+        GLambdaTaskPool.Free(this);
+    }
+    
+    if (CompletedEvent)
+    {
+        CompletedEvent->Signal();
     }
-    Event->Signal();
 }
 
 // ============================================================================
@@ -74,8 +234,15 @@ void FLambdaTask::Execute()
 
 std::unique_ptr<FTaskGraph> FTaskGraph::Singleton;
 
+// Worker identity of the calling thread (set once per worker thread)
+static thread_local const FTaskGraph* GCurrentWorkerGraph = nullptr;
+static thread_local int32 GCurrentWorkerIndex = -1;
+
 FTaskGraph::FTaskGraph(uint32 InNumWorkerThreads)
-    : bShutdown(false)
+    : IncomingCount(0)
+    , NumSleeping(0)
+    , WakeEpoch(0)
+    , bShutdown(false)
     , bInitialized(false)
     , NumThreads(InNumWorkerThreads)
 {
@@ -113,10 +280,21 @@ void FTaskGraph::Initialize()
     
     FLog::Log(ELogLevel::Info, std::string("TaskGraph initializing with ") + std::to_string(NumThreads) + " worker threads");
     
+    bShutdown = false;
+    
+    // Worker state must exist before any thread can try to steal from it
+    Workers.clear();
+    for (uint32 i = 0; i < NumThreads; ++i)
+    {
+        auto Worker = std::make_unique<FWorker>();
+        Worker->RandomState = 0x9E3779B9u * (i + 1);
+        Workers.push_back(std::move(Worker));
+    }
+    
     // Create worker threads
     for (uint32 i = 0; i < NumThreads; ++i)
     {
-        WorkerThreads.emplace_back(&FTaskGraph::WorkerThreadLoop, this);
+        WorkerThreads.emplace_back(&FTaskGraph::WorkerThreadLoop, this, i);
     }
     
     bInitialized = true;
@@ -132,11 +310,15 @@ void FTaskGraph::Shutdown()
     
     FLog::Log(ELogLevel::Info, "TaskGraph shutting down");
     
-    // Signal shutdown
-    bShutdown = true;
-    QueueCondition.notify_all();
+    // Signal shutdown and wake every parked worker
+    {
+        std::lock_guard<std::mutex> Lock(SleepMutex);
+        bShutdown = true;
+        WakeEpoch.fetch_add(1);
+    }
+    SleepCondition.notify_all();
     
-    // Wait for all worker threads to finish
+    // Wait for all worker threads to finish (they drain remaining work first)
     for (auto& Thread : WorkerThreads)
     {
         if (Thread.joinable())
@@ -145,56 +327,175 @@ void FTaskGraph::Shutdown()
         }
     }
     WorkerThreads.clear();
+    Workers.clear();
     
-    // Clean up remaining tasks
+    // Run anything pushed after the workers stopped looking, so no task or waiter is left behind
+    std::queue<FTask*> Leftovers;
     {
-        std::lock_guard<std::mutex> Lock(QueueMutex);
-        while (!TaskQueue.empty())
-        {
-            TaskQueue.pop();
-        }
+        std::lock_guard<std::mutex> Lock(IncomingMutex);
+        std::swap(Leftovers, IncomingQueue);
+        IncomingCount = 0;
     }
-    
-    // Clean up owned tasks
+    while (!Leftovers.empty())
     {
-        std::lock_guard<std::mutex> Lock(OwnedTasksMutex);
-        OwnedTasks.clear();
+        ExecuteTask(Leftovers.front());
+        Leftovers.pop();
     }
     
     bInitialized = false;
     FLog::Log(ELogLevel::Info, "TaskGraph shutdown complete");
 }
 
-FTaskEvent* FTaskGraph::CreateTask(std::function<void()> Lambda)
+FGraphEventRef FTaskGraph::CreateTask(FTaskFunction Lambda)
 {
-    auto Task = std::make_unique<FLambdaTask>(std::move(Lambda));
-    FTaskEvent* Event = Task->GetEvent();
-    FTask* TaskPtr = Task.get();  // Get pointer before moving
+    FLambdaTask* Task = FLambdaTask::Allocate(std::move(Lambda));
     
-    // Store the task for lifetime management
+    // Grab the completion event before queueing - the task recycles itself when done
+    FGraphEventRef Event = Task->GetEventRef();
+    DispatchTask(Task);
+    return Event;
+}
+
+FGraphEventRef FTaskGraph::CreateTask(FTaskFunction Lambda, const FGraphEventArray& Prerequisites)
+{
+    FLambdaTask* Task = FLambdaTask::Allocate(std::move(Lambda));
+    FGraphEventRef Event = Task->GetEventRef();
+    QueueTask(Task, Prerequisites);
+    return Event;
+}
+
+void FTaskGraph::QueueTask(FTask* Task, const FGraphEventArray& Prerequisites)
+{
+    if (!Task)
     {
-        std::lock_guard<std::mutex> Lock(OwnedTasksMutex);
-        OwnedTasks.push_back(std::move(Task));
+        return;
     }
     
-    // Queue the task (using the pointer we captured before moving)
-    QueueTask(TaskPtr);
+    // The extra count keeps the task from being dispatched by a prerequisite
+    // that signals while we are still subscribing to the others
+    int32 NumPrerequisites = static_cast<int32>(Prerequisites.size());
+    Task->NumPendingPrerequisites.store(NumPrerequisites + 1, std::memory_order_relaxed);
     
-    return Event;
+    int32 NumAlreadyComplete = 0;
+    for (const FGraphEventRef& Prerequisite : Prerequisites)
+    {
+        if (!Prerequisite || !Prerequisite->AddSubscriber(Task, this))
+        {
+            ++NumAlreadyComplete;
+        }
+    }
+    
+    OnPrerequisiteComplete(Task, NumAlreadyComplete + 1);
+}
+
+void FTaskGraph::OnPrerequisiteComplete(FTask* Task, int32 NumCompleted)
+{
+    // acq_rel: whoever dispatches sees the writes of every prerequisite task
+    if (Task->NumPendingPrerequisites.fetch_sub(NumCompleted, std::memory_order_acq_rel) == NumCompleted)
+    {
+        DispatchTask(Task);
+    }
+}
+
+void FTaskGraph::DispatchTask(FTask* Task)
+{
+    if (bShutdown || !bInitialized)
+    {
+        // No workers to run it - execute inline so waiters never hang
+        ExecuteTask(Task);
+        return;
+    }
+    
+    QueueTask(Task);
 }
 
 void FTaskGraph::QueueTask(FTask* Task)
 {
-    if (!Task || bShutdown)
+    if (!Task)
     {
         return;
     }
     
+    if (bShutdown)
+    {
+        // Workers are gone or draining - run it here so the task is released and its event signalled
+        ExecuteTask(Task);
+        return;
+    }
+    
+    int32 WorkerIndex = GetCurrentWorkerIndex();
+    if (WorkerIndex >= 0)
+    {
+        // Fast path: a worker spawning work keeps it local, other workers steal it if idle
+        Workers[WorkerIndex]->LocalQueue.Push(Task);
+    }
+    else
+    {
+        std::unique_lock<std::mutex> Lock(IncomingMutex);
+        if (bShutdown)
+        {
+            // Lost the race with Shutdown(), which may already have drained the queue
+            Lock.unlock();
+            ExecuteTask(Task);
+            return;
+        }
+        IncomingQueue.push(Task);
+        IncomingCount.fetch_add(1, std::memory_order_release);
+    }
+    
+    WakeWorker();
+}
+
+int32 FTaskGraph::GetCurrentWorkerIndex() const
+{
+    return GCurrentWorkerGraph == this ? GCurrentWorkerIndex : -1;
+}
+
+bool FTaskGraph::TryExecuteTask()
+{
+    if (!bInitialized)
+    {
+        return false;
+    }
+    
+    FTask* Task = nullptr;
+    int32 WorkerIndex = GetCurrentWorkerIndex();
+    if (WorkerIndex >= 0)
     {
-        std::lock_guard<std::mutex> Lock(QueueMutex);
-        TaskQueue.push(Task);
+        if (!FindWork(static_cast<uint32>(WorkerIndex), Task))
+        {
+            return false;
+        }
     }
-    QueueCondition.notify_one();
+    else if (!TryPopIncoming(Task))
+    {
+        // Non-workers have no deque of their own but may steal like any worker
+        static thread_local uint32 NextVictim = 0;
+        uint32 NumWorkers = static_cast<uint32>(Workers.size());
+        bool bStolen = false;
+        for (uint32 i = 0; i < NumWorkers && !bStolen; ++i)
+        {
+            bStolen = Workers[(NextVictim + i) % NumWorkers]->LocalQueue.Steal(Task);
+        }
+        ++NextVictim;
+        if (!bStolen)
+        {
+            return false;
+        }
+    }
+    
+    ExecuteTask(Task);
+    return true;
+}
+
+bool FTaskGraph::IsCallerQueueEmpty() const
+{
+    int32 WorkerIndex = GetCurrentWorkerIndex();
+    if (WorkerIndex >= 0)
+    {
+        return Workers[WorkerIndex]->LocalQueue.IsEmpty();
+    }
+    return IncomingCount.load(std::memory_order_relaxed) == 0;
 }
 
 FTaskGraph& FTaskGraph::Get()
@@ -207,90 +508,142 @@ FTaskGraph& FTaskGraph::Get()
     return *Singleton;
 }
 
-void FTaskGraph::WorkerThreadLoop()
+void FTaskGraph::WakeWorker()
 {
-    while (!bShutdown)
+    // Pairs with the NumSleeping increment in WorkerThreadLoop: either the worker
+    // sees the task we just queued, or we see it going to sleep and bump the epoch
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (NumSleeping.load(std::memory_order_relaxed) > 0)
     {
-        FTask* Task = nullptr;
-        
-        // Wait for a task
         {
-            std::unique_lock<std::mutex> Lock(QueueMutex);
-            QueueCondition.wait(Lock, [this]() {
-                return !TaskQueue.empty() || bShutdown;
-            });
-            
-            if (bShutdown && TaskQueue.empty())
-            {
-                break;
-            }
-            
-            if (!TaskQueue.empty())
-            {
-                Task = TaskQueue.front();
-                TaskQueue.pop();
-            }
-        }
-        
-        // Execute the task
-        if (Task)
-        {
-            try
-            {
-                Task->Execute();
-            }
-            catch (const std::exception& e)
-            {
-                FLog::Log(ELogLevel::Error, std::string("Task exception: ") + e.what());
-            }
-            catch (...)
-            {
-                FLog::Log(ELogLevel::Error, "Task exception: Unknown error");
-            }
+            std::lock_guard<std::mutex> Lock(SleepMutex);
+            WakeEpoch.fetch_add(1, std::memory_order_relaxed);
         }
+        SleepCondition.notify_one();
     }
 }
 
-// ============================================================================
-// FRenderFence Implementation
-// ============================================================================
-
-FRenderFence::FRenderFence()
-    : bFenceSet(false)
+bool FTaskGraph::TryPopIncoming(FTask*& OutTask)
 {
+    // Avoid touching the mutex when nothing has been queued from outside
+    if (IncomingCount.load(std::memory_order_acquire) == 0)
+    {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> Lock(IncomingMutex);
+    if (IncomingQueue.empty())
+    {
+        return false;
+    }
+    
+    OutTask = IncomingQueue.front();
+    IncomingQueue.pop();
+    IncomingCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
 }
 
-FRenderFence::~FRenderFence()
+bool FTaskGraph::TryStealWork(uint32 WorkerIndex, FTask*& OutTask)
 {
-    // Ensure we wait for any pending fence before destruction
-    if (bFenceSet && Event && !Event->IsComplete())
+    uint32 NumWorkers = static_cast<uint32>(Workers.size());
+    if (NumWorkers <= 1)
+    {
+        return false;
+    }
+    
+    // xorshift32 - cheap per-worker randomness for victim selection
+    uint32& State = Workers[WorkerIndex]->RandomState;
+    State ^= State << 13;
+    State ^= State >> 17;
+    State ^= State << 5;
+    
+    uint32 Start = State % NumWorkers;
+    for (uint32 i = 0; i < NumWorkers; ++i)
     {
-        Wait();
+        uint32 Victim = (Start + i) % NumWorkers;
+        if (Victim != WorkerIndex && Workers[Victim]->LocalQueue.Steal(OutTask))
+        {
+            return true;
+        }
     }
+    return false;
 }
 
-void FRenderFence::BeginFence()
+bool FTaskGraph::FindWork(uint32 WorkerIndex, FTask*& OutTask)
 {
-    Event = std::make_shared<FTaskEvent>();
-    bFenceSet = true;
+    return Workers[WorkerIndex]->LocalQueue.Pop(OutTask)
+        || TryPopIncoming(OutTask)
+        || TryStealWork(WorkerIndex, OutTask);
 }
 
-void FRenderFence::Wait()
+void FTaskGraph::ExecuteTask(FTask* Task)
 {
-    if (bFenceSet && Event)
+    try
     {
-        Event->Wait();
-        bFenceSet = false;
+        Task->Execute();
+    }
+    catch (const std::exception& e)
+    {
+        FLog::Log(ELogLevel::Error, std::string("Task exception: ") + e.what());
+    }
+    catch (...)
+    {
+        FLog::Log(ELogLevel::Error, "Task exception: Unknown error");
     }
 }
 
-bool FRenderFence::IsFenceComplete() const
+void FTaskGraph::WorkerThreadLoop(uint32 WorkerIndex)
 {
-    if (bFenceSet && Event)
+    GCurrentWorkerGraph = this;
+    GCurrentWorkerIndex = static_cast<int32>(WorkerIndex);
+    
+    while (true)
     {
-        return Event->IsComplete();
+        FTask* Task = nullptr;
+        
+        // Spin phase: keep looking for work for a short while before parking
+        for (uint32 Spin = 0; Spin < SpinIterations && !Task; ++Spin)
+        {
+            if (!FindWork(WorkerIndex, Task) && Spin > SpinIterations / 2)
+            {
+                std::this_thread::yield();
+            }
+        }
+        
+        if (Task)
+        {
+            ExecuteTask(Task);
+            continue;
+        }
+        
+        if (bShutdown)
+        {
+            break;
+        }
+        
+        // Park: announce we are going to sleep, then re-check for work so a
+        // concurrent QueueTask either sees us sleeping or we see its task
+        uint64 Epoch = WakeEpoch.load(std::memory_order_relaxed);
+        NumSleeping.fetch_add(1, std::memory_order_seq_cst);
+        
+        if (FindWork(WorkerIndex, Task))
+        {
+            NumSleeping.fetch_sub(1, std::memory_order_relaxed);
+            ExecuteTask(Task);
+            continue;
+        }
+        
+        {
+            std::unique_lock<std::mutex> Lock(SleepMutex);
+            SleepCondition.wait(Lock, [this, Epoch]() {
+                return WakeEpoch.load(std::memory_order_relaxed) != Epoch || bShutdown;
+            });
+        }
+        NumSleeping.fetch_sub(1, std::memory_order_relaxed);
     }
-    return true;  // No fence means complete
+    
+    GCurrentWorkerGraph = nullptr;
+    GCurrentWorkerIndex = -1;
 }
 
 // ============================================================================
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../Core/CoreTypes.h"
+#include "WorkStealingQueue.h"
+#include "TaskFunction.h"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -18,19 +20,42 @@
  * - FTaskEvent: Synchronization primitive for task completion
  * - FTaskGraph: Manages worker threads and task execution
  * 
+ * Scheduling: each worker owns a Chase-Lev deque. Tasks queued from a worker
+ * go to its own deque; tasks queued from other threads (game, render) go to a
+ * shared incoming queue. Idle workers pop local work first, then drain the
+ * incoming queue, then steal from a random victim. A worker that finds nothing
+ * spins briefly and then parks until new work is queued.
+ * 
+ * Task lifetime: lambda tasks and their events are pooled and recycled, so a
+ * long-running process does not grow memory with the number of tasks created.
+ * 
+ * Dependencies: a task can be given prerequisite events. It subscribes to each
+ * one and is queued by whichever prerequisite signals last, so a DAG of tasks
+ * runs without any thread blocking on FTaskEvent::Wait().
+ * 
  * Usage:
- *   FTaskEvent* Event = TaskGraph->CreateTask([]() { DoWork(); });
- *   Event->Wait();  // Block until task completes
+ *   FGraphEventRef Event = TaskGraph->CreateTask([]() { DoWork(); });
+ *   FGraphEventRef After = TaskGraph->CreateTask([]() { DoMoreWork(); }, { Event });
+ *   After->Wait();  // Block until both tasks complete
  */
 
 // Forward declarations
 class FTask;
 class FTaskEvent;
 class FTaskGraph;
+class FGraphEventRef;
+struct FEventSubscriber;
 
 /**
  * FTaskEvent - Synchronization primitive for task completion
- * Similar to UE5's FGraphEventRef but simplified
+ * 
+ * Events handed out by FTaskEvent::Create() are pooled and reference counted
+ * through FGraphEventRef; the last reference returns the event to the pool.
+ * Events constructed directly (stack/member) are not pooled and ignore the count.
+ * 
+ * Tasks waiting on the event as a prerequisite are kept in a lock-free
+ * subscriber list. Signal() closes the list and dispatches every subscriber
+ * whose last prerequisite this was.
  */
 class FTaskEvent 
 {
@@ -38,7 +63,10 @@ public:
     FTaskEvent();
     ~FTaskEvent();
     
-    // Signal that the task is complete
+    // Get a recycled event from the pool (unsignaled, owned by the returned ref)
+    static FGraphEventRef Create();
+    
+    // Signal that the task is complete and dispatch subscribed tasks
     void Signal();
     
     // Wait for the task to complete
@@ -47,12 +75,108 @@ public:
     // Check if the task is complete without blocking
     bool IsComplete() const;
     
+    // Reference counting (used by FGraphEventRef)
+    void AddRef();
+    void Release();
+    uint32 GetRefCount() const { return RefCount.load(std::memory_order_relaxed); }
+    
+    // Number of pooled events ever created (stays flat in steady state)
+    static uint32 GetPoolCapacity();
+    
 private:
+    friend class FTaskGraph;
+    
+    // Register Task to be dispatched on Graph when this event signals.
+    // Returns false if the event has already signalled (nothing is registered).
+    bool AddSubscriber(FTask* Task, FTaskGraph* Graph);
+    
     std::mutex Mutex;
     std::condition_variable Condition;
     std::atomic<bool> bComplete;
+    std::atomic<FEventSubscriber*> Subscribers;  // Closed sentinel once signalled
+    std::atomic<uint32> RefCount;
+    bool bPooled;
 };
 
+/**
+ * FGraphEventRef - Reference-counted handle to a FTaskEvent
+ * Similar to UE5's FGraphEventRef (TRefCountPtr<FGraphEvent>)
+ */
+class FGraphEventRef
+{
+public:
+    FGraphEventRef() : Event(nullptr) {}
+    
+    explicit FGraphEventRef(FTaskEvent* InEvent)
+        : Event(InEvent)
+    {
+        if (Event)
+        {
+            Event->AddRef();
+        }
+    }
+    
+    FGraphEventRef(const FGraphEventRef& Other)
+        : Event(Other.Event)
+    {
+        if (Event)
+        {
+            Event->AddRef();
+        }
+    }
+    
+    FGraphEventRef(FGraphEventRef&& Other) noexcept
+        : Event(Other.Event)
+    {
+        Other.Event = nullptr;
+    }
+    
+    FGraphEventRef& operator=(const FGraphEventRef& Other)
+    {
+        FGraphEventRef Copy(Other);
+        std::swap(Event, Copy.Event);
+        return *this;
+    }
+    
+    FGraphEventRef& operator=(FGraphEventRef&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            SafeRelease();
+            Event = Other.Event;
+            Other.Event = nullptr;
+        }
+        return *this;
+    }
+    
+    ~FGraphEventRef()
+    {
+        SafeRelease();
+    }
+    
+    // Drop this reference (returns the event to the pool if it was the last one)
+    void SafeRelease()
+    {
+        if (Event)
+        {
+            FTaskEvent* OldEvent = Event;
+            Event = nullptr;
+            OldEvent->Release();
+        }
+    }
+    
+    FTaskEvent* operator->() const { return Event; }
+    FTaskEvent* GetReference() const { return Event; }
+    bool IsValid() const { return Event != nullptr; }
+    explicit operator bool() const { return Event != nullptr; }
+    
+private:
+    FTaskEvent* Event;
+};
+
+// List of prerequisite events, similar to UE5's FGraphEventArray
+using FGraphEventArray = std::vector<FGraphEventRef>;
+
 /**
  * FTask - Base class for tasks that can be executed on worker threads
  * Similar to UE5's TGraphTask
@@ -60,38 +184,63 @@ private:
 class FTask 
 {
 public:
-    FTask();
+    FTask();  // Creates the completion event
     virtual ~FTask();
     
     // Execute the task
     virtual void Execute() = 0;
     
     // Get the event for this task
-    FTaskEvent* GetEvent() { return Event.get(); }
+    FTaskEvent* GetEvent() { return Event.GetReference(); }
+    const FGraphEventRef& GetEventRef() const { return Event; }
     
 protected:
-    std::unique_ptr<FTaskEvent> Event;
+    explicit FTask(FGraphEventRef InEvent);
+    
+    FGraphEventRef Event;
+    
+private:
+    friend class FTaskGraph;
+    friend class FTaskEvent;
+    
+    // Prerequisites not yet signalled, plus one held by QueueTask while subscribing
+    std::atomic<int32> NumPendingPrerequisites;
 };
 
 /**
  * FLambdaTask - Task that executes a lambda function
  * Convenience class for quick task creation
+ * 
+ * Tasks from Allocate() come from a lock-free pool and recycle themselves
+ * after Execute(); the lambda is stored in a small-buffer FTaskFunction so
+ * typical captures do not allocate.
  */
 class FLambdaTask : public FTask 
 {
 public:
-    explicit FLambdaTask(std::function<void()> InLambda);
+    FLambdaTask();  // Pool constructor - no lambda, no event
+    explicit FLambdaTask(FTaskFunction InLambda);
     virtual ~FLambdaTask() override;
     
     virtual void Execute() override;
     
+    // Get a pooled task with a fresh completion event
+    static FLambdaTask* Allocate(FTaskFunction&& InLambda);
+    
+    // Number of pooled tasks ever created (stays flat in steady state)
+    static uint32 GetPoolCapacity();
+    
 private:
-    std::function<void()> Lambda;
+    // Destroy the lambda, recycle the task (if pooled) and signal completion
+    void Complete();
+    
+    FTaskFunction Lambda;
+    bool bPooled;
 };
 
 /**
  * FTaskGraph - Manages worker threads and task execution
- * Simplified version of UE5's FTaskGraphImplementation
+ * Simplified version of UE5's FTaskGraphImplementation with work stealing
  */
 class FTaskGraph 
 {
@@ -107,32 +256,87 @@ public:
     
     // Create and queue a task from a lambda
     // Returns the event that can be used to wait for completion
-    FTaskEvent* CreateTask(std::function<void()> Lambda);
+    FGraphEventRef CreateTask(FTaskFunction Lambda);
+    
+    // Create a task that is queued once every prerequisite has signalled.
+    // Never blocks; null or already-complete prerequisites are skipped.
+    FGraphEventRef CreateTask(FTaskFunction Lambda, const FGraphEventArray& Prerequisites);
     
     // Queue an existing task for execution
     void QueueTask(FTask* Task);
     
+    // Queue an existing task once every prerequisite has signalled
+    void QueueTask(FTask* Task, const FGraphEventArray& Prerequisites);
+    
     // Get singleton instance
     static FTaskGraph& Get();
     
     // Check if initialized
     bool IsInitialized() const { return bInitialized; }
     
+    // Number of worker threads
+    uint32 GetNumWorkerThreads() const { return NumThreads; }
+    
+    // Index of the calling worker thread in this graph, or -1 if not a worker of this graph
+    int32 GetCurrentWorkerIndex() const;
+    
+    // Run one queued task on the calling thread, if any can be found.
+    // Lets a thread waiting on its own work (e.g. ParallelFor) help instead of idling.
+    bool TryExecuteTask();
+    
+    // True if the calling thread has no queued work of its own: its local deque
+    // for a worker, the shared incoming queue otherwise. Drives lazy splitting.
+    bool IsCallerQueueEmpty() const;
+    
 private:
-    void WorkerThreadLoop();
+    friend class FTaskEvent;
+    
+    // Called when one of Task's prerequisites completes; dispatches it after the last
+    void OnPrerequisiteComplete(FTask* Task, int32 NumCompleted);
+    
+    // Queue a ready task, or run it inline if there are no workers to run it
+    void DispatchTask(FTask* Task);
+    
+    // Per-worker scheduling state
+    struct FWorker
+    {
+        TWorkStealingQueue<FTask*> LocalQueue;
+        uint32 RandomState = 0;  // xorshift state for victim selection
+    };
+    
+    void WorkerThreadLoop(uint32 WorkerIndex);
+    
+    // Local pop, then incoming queue, then steal
+    bool FindWork(uint32 WorkerIndex, FTask*& OutTask);
+    bool TryStealWork(uint32 WorkerIndex, FTask*& OutTask);
+    bool TryPopIncoming(FTask*& OutTask);
+    
+    void ExecuteTask(FTask* Task);
+    
+    // Wake one parked worker if any are sleeping
+    void WakeWorker();
+    
+    // Number of empty FindWork rounds before a worker parks
+    static constexpr uint32 SpinIterations = 64;
     
     std::vector<std::thread> WorkerThreads;
-    std::queue<FTask*> TaskQueue;
-    std::mutex QueueMutex;
-    std::condition_variable QueueCondition;
+    std::vector<std::unique_ptr<FWorker>> Workers;
+    
+    // Tasks queued from non-worker threads (game, render, RHI)
+    std::queue<FTask*> IncomingQueue;
+    std::mutex IncomingMutex;
+    std::atomic<uint32> IncomingCount;
+    
+    // Parking for idle workers
+    std::mutex SleepMutex;
+    std::condition_variable SleepCondition;
+    std::atomic<uint32> NumSleeping;
+    std::atomic<uint64> WakeEpoch;
+    
     std::atomic<bool> bShutdown;
     std::atomic<bool> bInitialized;
     uint32 NumThreads;
     
-    // Owned tasks (for lifetime management)
-    std::vector<std::unique_ptr<FTask>> OwnedTasks;
-    std::mutex OwnedTasksMutex;
-    
     // Singleton
     static std::unique_ptr<FTaskGraph> Singleton;
 };
@@ -149,30 +353,6 @@ enum class ENamedThreads : uint8
     NumThreads
 };
 
-/**
- * FRenderFence - Fence for synchronizing between Game and Render threads
- * Similar to UE5's FRenderCommandFence
- */
-class FRenderFence 
-{
-public:
-    FRenderFence();
-    ~FRenderFence();
-    
-    // Begin the fence (called from game thread)
-    void BeginFence();
-    
-    // Wait for the fence to complete (blocks game thread)
-    void Wait();
-    
-    // Check if fence is complete without blocking
-    bool IsFenceComplete() const;
-    
-private:
-    std::shared_ptr<FTaskEvent> Event;
-    std::atomic<bool> bFenceSet;
-};
-
 /**
  * FThreadManager - Manages named threads
  * Simplified version of UE5's FTaskGraphInterface for named threads
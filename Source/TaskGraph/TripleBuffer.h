@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include <atomic>
+
+/**
+ * TTripleBuffer - single-producer / single-consumer handoff of the latest value
+ * Similar in spirit to UE5's TTripleBuffer
+ *
+ * Three buffers rotate between the roles write (producer-owned), middle
+ * (last published) and read (consumer-owned). Publish() swaps the write
+ * buffer with the middle one; Acquire() swaps the middle buffer with the read
+ * one if something new was published. Each flip is a single atomic exchange
+ * on the middle index, so neither side ever locks or waits on the other.
+ *
+ * The consumer always sees the most recent complete value; values published
+ * while the consumer was busy are overwritten, never merged. Buffers are
+ * reused, so the producer should overwrite the whole write buffer before
+ * publishing (containers keep their capacity, so steady state does not allocate).
+ */
+template<typename ValueType>
+class TTripleBuffer
+{
+public:
+    TTripleBuffer()
+        : WriteIndex(0)
+        , ReadIndex(1)
+        , MiddleIndex(2)
+    {
+    }
+
+    // Producer: the buffer to fill for the next Publish()
+    ValueType& GetWriteBuffer() { return Buffers[WriteIndex]; }
+
+    // Producer: make the write buffer the latest value and take back the old middle buffer
+    void Publish()
+    {
+        uint32 Previous = MiddleIndex.exchange(WriteIndex | FreshFlag, std::memory_order_acq_rel);
+        WriteIndex = Previous & IndexMask;
+    }
+
+    // Consumer: switch to the latest published value; false if nothing new since the last call
+    bool Acquire()
+    {
+        if ((MiddleIndex.load(std::memory_order_relaxed) & FreshFlag) == 0)
+        {
+            return false;
+        }
+        uint32 Previous = MiddleIndex.exchange(ReadIndex, std::memory_order_acq_rel);
+        ReadIndex = Previous & IndexMask;
+        return true;
+    }
+
+    // Consumer: the value returned by the last successful Acquire()
+    const ValueType& GetReadBuffer() const { return Buffers[ReadIndex]; }
+
+    // Either side: has a value been published that the consumer has not acquired yet
+    bool HasPendingValue() const { return (MiddleIndex.load(std::memory_order_relaxed) & FreshFlag) != 0; }
+
+private:
+    static constexpr uint32 IndexMask = 0x3;
+    static constexpr uint32 FreshFlag = 0x4;
+
+    ValueType Buffers[3];
+    uint32 WriteIndex;                  // Producer only
+    uint32 ReadIndex;                   // Consumer only
+    alignas(64) std::atomic<uint32> MiddleIndex;  // Index | FreshFlag
+};
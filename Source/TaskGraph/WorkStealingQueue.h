@@ -0,0 +1,160 @@
+#pragma once
+
+#include "../Core/CoreTypes.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * TWorkStealingQueue - Chase-Lev work-stealing deque
+ *
+ * One owner thread pushes and pops at the bottom (LIFO, cache friendly);
+ * any number of thief threads steal from the top (FIFO, oldest work first).
+ * Only Steal() and the last-element Pop() race, and they are resolved with a
+ * single CAS on Top, so the common owner path is lock free and contention free.
+ *
+ * Based on "Correct and Efficient Work-Stealing for Weak Memory Models"
+ * (Le, Pop, Cohen, Zappa Nardelli - PPoPP 2013).
+ *
+ * The ring buffer grows on demand. Retired buffers are kept alive until the
+ * queue is destroyed because a thief may still be reading from them.
+ *
+ * ItemType must be trivially copyable (typically a pointer).
+ */
+template<typename ItemType>
+class TWorkStealingQueue
+{
+public:
+    explicit TWorkStealingQueue(int64 InitialCapacity = 1024)
+        : Top(0)
+        , Bottom(0)
+    {
+        // Capacity must be a power of two for index masking
+        int64 capacity = 1;
+        while (capacity < InitialCapacity)
+        {
+            capacity <<= 1;
+        }
+        RetiredBuffers.push_back(std::make_unique<FRingBuffer>(capacity));
+        Buffer.store(RetiredBuffers.back().get(), std::memory_order_relaxed);
+    }
+
+    TWorkStealingQueue(const TWorkStealingQueue&) = delete;
+    TWorkStealingQueue& operator=(const TWorkStealingQueue&) = delete;
+
+    // Owner only: push an item at the bottom
+    void Push(ItemType Item)
+    {
+        int64 b = Bottom.load(std::memory_order_relaxed);
+        int64 t = Top.load(std::memory_order_acquire);
+        FRingBuffer* buffer = Buffer.load(std::memory_order_relaxed);
+
+        if (b - t > buffer->Capacity - 1)
+        {
+            buffer = Grow(buffer, b, t);
+        }
+
+        buffer->Put(b, Item);
+        std::atomic_thread_fence(std::memory_order_release);
+        Bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only: pop the most recently pushed item
+    bool Pop(ItemType& OutItem)
+    {
+        int64 b = Bottom.load(std::memory_order_relaxed) - 1;
+        FRingBuffer* buffer = Buffer.load(std::memory_order_relaxed);
+        Bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 t = Top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // Queue was empty
+            Bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        OutItem = buffer->Get(b);
+        if (t == b)
+        {
+            // Last element - race against thieves for it
+            bool bWon = Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            Bottom.store(b + 1, std::memory_order_relaxed);
+            return bWon;
+        }
+        return true;
+    }
+
+    // Any thread: steal the oldest item. Returns false if empty or the race was lost.
+    bool Steal(ItemType& OutItem)
+    {
+        int64 t = Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 b = Bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return false;
+        }
+
+        FRingBuffer* buffer = Buffer.load(std::memory_order_acquire);
+        ItemType item = buffer->Get(t);
+        if (!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        OutItem = item;
+        return true;
+    }
+
+    // Approximate - only exact when called by the owner with no concurrent thieves
+    bool IsEmpty() const
+    {
+        int64 b = Bottom.load(std::memory_order_relaxed);
+        int64 t = Top.load(std::memory_order_relaxed);
+        return b <= t;
+    }
+
+    int64 GetCapacity() const { return Buffer.load(std::memory_order_relaxed)->Capacity; }
+
+private:
+    struct FRingBuffer
+    {
+        explicit FRingBuffer(int64 InCapacity)
+            : Capacity(InCapacity)
+            , Mask(InCapacity - 1)
+            , Items(new std::atomic<ItemType>[static_cast<size_t>(InCapacity)])
+        {
+        }
+
+        ItemType Get(int64 Index) const { return Items[Index & Mask].load(std::memory_order_relaxed); }
+        void Put(int64 Index, ItemType Item) { Items[Index & Mask].store(Item, std::memory_order_relaxed); }
+
+        int64 Capacity;
+        int64 Mask;
+        std::unique_ptr<std::atomic<ItemType>[]> Items;
+    };
+
+    // Owner only: double the buffer and copy the live range [Top, Bottom)
+    FRingBuffer* Grow(FRingBuffer* OldBuffer, int64 b, int64 t)
+    {
+        RetiredBuffers.push_back(std::make_unique<FRingBuffer>(OldBuffer->Capacity * 2));
+        FRingBuffer* newBuffer = RetiredBuffers.back().get();
+        for (int64 i = t; i < b; ++i)
+        {
+            newBuffer->Put(i, OldBuffer->Get(i));
+        }
+        Buffer.store(newBuffer, std::memory_order_release);
+        return newBuffer;
+    }
+
+    // Top and Bottom live on separate cache lines - thieves hammer Top, the owner hammers Bottom
+    alignas(64) std::atomic<int64> Top;
+    alignas(64) std::atomic<int64> Bottom;
+    alignas(64) std::atomic<FRingBuffer*> Buffer;
+
+    // Every buffer ever allocated (owner only); the last one is the live buffer
+    std::vector<std::unique_ptr<FRingBuffer>> RetiredBuffers;
+};
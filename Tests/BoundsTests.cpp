@@ -0,0 +1,233 @@
+/**
+ * Unit tests for bounds and frustum culling
+ * Tests FBoxSphereBounds construction from vertex positions and transforms,
+ * the sphere test used for point light reach, FBox ray and distance tests, the planes FViewFrustum
+ * extracts from a camera view-projection, and the SIMD batch kernel against
+ * the scalar one on random SoA bounds
+ */
+
+#include <gtest/gtest.h>
+#include "Bounds.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Same camera setup as FCamera: left-handed, looking down +Z from the origin
+    FViewFrustum MakeCameraFrustum(float FarZ = 100.0f)
+    {
+        FMatrix4x4 View = FMatrix4x4::LookAtLH(FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 1.0f), FVector(0.0f, 1.0f, 0.0f));
+        FMatrix4x4 Projection = FMatrix4x4::PerspectiveFovLH(DirectX::XM_PIDIV2, 1.0f, 0.1f, FarZ);
+        return FViewFrustum::FromViewProjection(View * Projection);
+    }
+
+    FBoxSphereBounds MakeCube(const FVector& Center, float HalfSize)
+    {
+        return FBoxSphereBounds(Center, FVector(HalfSize, HalfSize, HalfSize), HalfSize * std::sqrt(3.0f));
+    }
+}
+
+TEST(BoundsTest, FromPoints_BoxAndSphereEncloseThePoints)
+{
+    // Positions first, as in every vertex format, with a stride larger than FVector
+    struct FTestVertex
+    {
+        FVector Position;
+        float Padding[2];
+    };
+    std::vector<FTestVertex> Vertices = {
+        { FVector(-1.0f, 0.0f, 2.0f), {} },
+        { FVector(3.0f, -2.0f, 2.0f), {} },
+        { FVector(1.0f, 2.0f, 4.0f), {} },
+    };
+
+    FBoxSphereBounds Bounds = FBoxSphereBounds::FromPoints(Vertices.data(), 3, sizeof(FTestVertex));
+
+    EXPECT_FLOAT_EQ(Bounds.Origin.X, 1.0f);
+    EXPECT_FLOAT_EQ(Bounds.Origin.Y, 0.0f);
+    EXPECT_FLOAT_EQ(Bounds.Origin.Z, 3.0f);
+    EXPECT_FLOAT_EQ(Bounds.BoxExtent.X, 2.0f);
+    EXPECT_FLOAT_EQ(Bounds.BoxExtent.Y, 2.0f);
+    EXPECT_FLOAT_EQ(Bounds.BoxExtent.Z, 1.0f);
+    EXPECT_FLOAT_EQ(Bounds.SphereRadius, 3.0f);      // (3, -2, 2), not the box corner
+}
+
+TEST(BoundsTest, FromPoints_NoPointsIsEmpty)
+{
+    FBoxSphereBounds Bounds = FBoxSphereBounds::FromPoints(nullptr, 0, sizeof(FVector));
+
+    EXPECT_FLOAT_EQ(Bounds.BoxExtent.X, 0.0f);
+    EXPECT_FLOAT_EQ(Bounds.SphereRadius, 0.0f);
+}
+
+TEST(BoundsTest, TransformBy_ScalesAndTranslates)
+{
+    FBoxSphereBounds Local(FVector(1.0f, 0.0f, 0.0f), FVector(1.0f, 2.0f, 3.0f), 4.0f);
+
+    FBoxSphereBounds World = Local.TransformBy(FMatrix4x4::Scaling(2.0f, 1.0f, 1.0f) * FMatrix4x4::Translation(10.0f, 0.0f, 5.0f));
+
+    EXPECT_FLOAT_EQ(World.Origin.X, 12.0f);
+    EXPECT_FLOAT_EQ(World.Origin.Y, 0.0f);
+    EXPECT_FLOAT_EQ(World.Origin.Z, 5.0f);
+    EXPECT_FLOAT_EQ(World.BoxExtent.X, 2.0f);
+    EXPECT_FLOAT_EQ(World.BoxExtent.Y, 2.0f);
+    EXPECT_FLOAT_EQ(World.BoxExtent.Z, 3.0f);
+    EXPECT_FLOAT_EQ(World.SphereRadius, 8.0f);     // Largest axis scale
+}
+
+TEST(BoundsTest, TransformBy_RotationGrowsTheBox)
+{
+    FBoxSphereBounds Local(FVector(0.0f, 0.0f, 0.0f), FVector(1.0f, 1.0f, 1.0f), std::sqrt(3.0f));
+
+    FBoxSphereBounds World = Local.TransformBy(FMatrix4x4::RotationY(DirectX::XM_PIDIV4));
+
+    // The rotated cube's corners reach sqrt(2) along X and Z; Y and the sphere are unchanged
+    EXPECT_NEAR(World.BoxExtent.X, std::sqrt(2.0f), 1e-5f);
+    EXPECT_NEAR(World.BoxExtent.Y, 1.0f, 1e-5f);
+    EXPECT_NEAR(World.BoxExtent.Z, std::sqrt(2.0f), 1e-5f);
+    EXPECT_NEAR(World.SphereRadius, std::sqrt(3.0f), 1e-5f);
+}
+
+TEST(BoundsTest, IntersectsSphere_NearestBoxPointDecides)
+{
+    FBoxSphereBounds Cube = MakeCube(FVector(0.0f, 0.0f, 0.0f), 1.0f);
+
+    EXPECT_TRUE(Cube.IntersectsSphere(FVector(2.5f, 0.0f, 0.0f), 2.0f));     // Face 1.5 away
+    EXPECT_FALSE(Cube.IntersectsSphere(FVector(3.5f, 0.0f, 0.0f), 2.0f));
+    EXPECT_TRUE(Cube.IntersectsSphere(FVector(0.0f, 0.0f, 0.0f), 0.1f));     // Inside the box
+
+    // Diagonal: within reach of the corner's bounding sphere, but not of the box
+    EXPECT_FALSE(Cube.IntersectsSphere(FVector(2.5f, 2.5f, 0.0f), 2.0f));
+    EXPECT_TRUE(Cube.IntersectsSphere(FVector(2.5f, 2.5f, 0.0f), 2.2f));
+}
+
+TEST(BoxTest, IntersectsRay_EntryDistanceAndParallelRays)
+{
+    FBox Box(FVector(1.0f, -1.0f, -1.0f), FVector(3.0f, 1.0f, 1.0f));
+    const float Inf = std::numeric_limits<float>::infinity();
+
+    // Along +X: enters at x = 1
+    float Distance = -1.0f;
+    EXPECT_TRUE(Box.IntersectsRay(FVector(0.0f, 0.0f, 0.0f), FVector(1.0f, Inf, Inf), 10.0f, Distance));
+    EXPECT_FLOAT_EQ(Distance, 1.0f);
+
+    // Too short, pointing away, and parallel beside the box
+    EXPECT_FALSE(Box.IntersectsRay(FVector(0.0f, 0.0f, 0.0f), FVector(1.0f, Inf, Inf), 0.5f, Distance));
+    EXPECT_FALSE(Box.IntersectsRay(FVector(0.0f, 0.0f, 0.0f), FVector(-1.0f, Inf, Inf), 10.0f, Distance));
+    EXPECT_FALSE(Box.IntersectsRay(FVector(0.0f, 2.0f, 0.0f), FVector(1.0f, Inf, Inf), 10.0f, Distance));
+
+    // Parallel along the box face, and starting inside
+    EXPECT_TRUE(Box.IntersectsRay(FVector(0.0f, 1.0f, 0.0f), FVector(1.0f, Inf, Inf), 10.0f, Distance));
+    EXPECT_TRUE(Box.IntersectsRay(FVector(2.0f, 0.0f, 0.0f), FVector(Inf, Inf, 1.0f), 10.0f, Distance));
+    EXPECT_FLOAT_EQ(Distance, 0.0f);
+}
+
+TEST(BoxTest, ContainsIntersectsAndDistance)
+{
+    FBox Box(FVector(0.0f, 0.0f, 0.0f), FVector(2.0f, 2.0f, 2.0f));
+
+    EXPECT_TRUE(Box.ExpandBy(0.5f).Contains(Box));
+    EXPECT_FALSE(Box.Contains(Box.ExpandBy(0.5f)));
+    EXPECT_TRUE(Box.Intersects(FBox(FVector(2.0f, 1.0f, 1.0f), FVector(3.0f, 3.0f, 3.0f))));     // Touching faces
+    EXPECT_FALSE(Box.Intersects(FBox(FVector(2.5f, 1.0f, 1.0f), FVector(3.0f, 3.0f, 3.0f))));
+    EXPECT_FLOAT_EQ(Box.GetSurfaceArea(), 24.0f);
+    EXPECT_FLOAT_EQ(Box.ComputeSquaredDistanceToPoint(FVector(1.0f, 1.0f, 1.0f)), 0.0f);
+    EXPECT_FLOAT_EQ(Box.ComputeSquaredDistanceToPoint(FVector(5.0f, 6.0f, 1.0f)), 9.0f + 16.0f);
+}
+
+TEST(FrustumTest, FromViewProjection_PlanesFaceInwards)
+{
+    FViewFrustum Frustum = MakeCameraFrustum();
+
+    // A point straight ahead is in front of every plane
+    FVector Ahead(0.0f, 0.0f, 10.0f);
+    for (const FPlane& Plane : Frustum.Planes)
+    {
+        EXPECT_GT(Plane.PlaneDot(Ahead), 0.0f);
+    }
+
+    // Normalized: distances to the near and far planes are in world units
+    EXPECT_NEAR(Frustum.Planes[FViewFrustum::Near].PlaneDot(Ahead), 9.9f, 1e-3f);
+    EXPECT_NEAR(Frustum.Planes[FViewFrustum::Far].PlaneDot(Ahead), 90.0f, 1e-2f);
+}
+
+TEST(FrustumTest, IntersectsBounds_InsideBehindAndBeside)
+{
+    FViewFrustum Frustum = MakeCameraFrustum();
+
+    EXPECT_TRUE(Frustum.IntersectsBounds(MakeCube(FVector(0.0f, 0.0f, 10.0f), 1.0f)));
+    EXPECT_FALSE(Frustum.IntersectsBounds(MakeCube(FVector(0.0f, 0.0f, -10.0f), 1.0f)));    // Behind the camera
+    EXPECT_FALSE(Frustum.IntersectsBounds(MakeCube(FVector(30.0f, 0.0f, 10.0f), 1.0f)));    // Right of the 90 degree view
+    EXPECT_FALSE(Frustum.IntersectsBounds(MakeCube(FVector(0.0f, 0.0f, 200.0f), 1.0f)));    // Past the far plane
+
+    // Straddling the right plane: partly visible counts as visible
+    EXPECT_TRUE(Frustum.IntersectsBounds(MakeCube(FVector(10.5f, 0.0f, 10.0f), 1.0f)));
+
+    EXPECT_TRUE(Frustum.IntersectsSphere(FVector(0.0f, 0.0f, -0.5f), 1.0f));
+    EXPECT_FALSE(Frustum.IntersectsSphere(FVector(0.0f, 0.0f, -5.0f), 1.0f));
+}
+
+TEST(FrustumTest, IntersectsBounds_TighterOfBoxAndSphereDecides)
+{
+    FViewFrustum Frustum = MakeCameraFrustum();
+
+    // A long thin box whose sphere reaches into view but whose box does not
+    FBoxSphereBounds Thin(FVector(0.0f, 0.0f, -3.0f), FVector(0.1f, 0.1f, 2.0f), 2.0f);
+    EXPECT_FALSE(Frustum.IntersectsBounds(Thin));
+
+    // A box corner that reaches into view while its inscribed sphere does not
+    FBoxSphereBounds Tight(FVector(0.0f, 0.0f, -1.0f), FVector(1.5f, 1.5f, 1.5f), 0.9f);
+    EXPECT_FALSE(Frustum.IntersectsBounds(Tight));
+}
+
+TEST(FrustumTest, CullBounds_MatchesScalarOnRandomBounds)
+{
+    FViewFrustum Frustum = MakeCameraFrustum();
+
+    // Not a multiple of four, so the last group is partly padding
+    const uint32 NumBounds = 1027;
+    FBoundsSoA Bounds;
+    Bounds.Reset(NumBounds);
+    std::mt19937 Random(7);
+    std::uniform_real_distribution<float> Position(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> Size(0.1f, 8.0f);
+    for (uint32 i = 0; i < NumBounds; ++i)
+    {
+        FVector Extent(Size(Random), Size(Random), Size(Random));
+        float Radius = std::sqrt(Extent.X * Extent.X + Extent.Y * Extent.Y + Extent.Z * Extent.Z);
+        Bounds.Set(i, FBoxSphereBounds(FVector(Position(Random), Position(Random), Position(Random)), Extent, Radius));
+    }
+
+    std::vector<uint8> Simd(NumBounds + FBoundsSoA::Alignment, 0xCD);
+    std::vector<uint8> Scalar(NumBounds, 0xCD);
+    uint32 NumSimd = Frustum.CullBounds(Bounds, Simd.data());
+    uint32 NumScalar = Frustum.CullBoundsScalar(Bounds, Scalar.data());
+
+    EXPECT_EQ(NumSimd, NumScalar);
+    EXPECT_GT(NumSimd, 0u);
+    EXPECT_LT(NumSimd, NumBounds);
+    for (uint32 i = 0; i < NumBounds; ++i)
+    {
+        ASSERT_EQ(Simd[i], Scalar[i]) << "Entry " << i;
+        ASSERT_EQ(Simd[i] != 0, Frustum.IntersectsBounds(Bounds.Get(i))) << "Entry " << i;
+    }
+
+    // Nothing is written past the last entry
+    EXPECT_EQ(Simd[NumBounds], 0xCD);
+}
+
+TEST(FrustumTest, CullBounds_UnboundedEntriesAlwaysVisible)
+{
+    FViewFrustum Frustum = MakeCameraFrustum();
+
+    FBoundsSoA Bounds;
+    Bounds.Reset(6);
+    Bounds.Set(1, MakeCube(FVector(0.0f, 0.0f, -10.0f), 1.0f));
+    Bounds.Set(4, MakeCube(FVector(0.0f, 0.0f, 10.0f), 1.0f));
+
+    std::vector<uint8> Visible(6);
+    EXPECT_EQ(Frustum.CullBounds(Bounds, Visible.data()), 5u);
+    EXPECT_EQ(Visible, std::vector<uint8>({ 1, 0, 1, 1, 1, 1 }));
+}
@@ -0,0 +1,284 @@
+/**
+ * Unit tests for the dynamic AABB tree
+ * Tests FDynamicBVH structure under random create / move / destroy
+ * sequences, box, sphere, frustum and ray queries against brute force over
+ * the same fat boxes, stable proxy ids across Compact(), and tree height
+ * under sorted insertion
+ */
+
+#include <gtest/gtest.h>
+#include "DynamicBVH.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    FBox MakeBox(const FVector& Center, float HalfSize)
+    {
+        return FBox(FVector(Center.X - HalfSize, Center.Y - HalfSize, Center.Z - HalfSize),
+                    FVector(Center.X + HalfSize, Center.Y + HalfSize, Center.Z + HalfSize));
+    }
+
+    FBox MakeRandomBox(std::mt19937& Random)
+    {
+        std::uniform_real_distribution<float> Position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> Size(0.25f, 2.0f);
+        return MakeBox(FVector(Position(Random), Position(Random), Position(Random)), Size(Random));
+    }
+
+    // Random tree of NumProxies live proxies, some destroyed and moved along the way
+    struct FRandomTree
+    {
+        FDynamicBVH Tree;
+        std::vector<uint32> LiveIds;
+
+        FRandomTree(uint32 NumProxies, uint32 Seed)
+        {
+            std::mt19937 Random(Seed);
+            for (uint32 i = 0; i < NumProxies + NumProxies / 4; ++i)
+            {
+                LiveIds.push_back(Tree.CreateProxy(MakeRandomBox(Random), nullptr));
+            }
+            for (uint32 i = 0; i < NumProxies / 4; ++i)
+            {
+                uint32 Slot = Random() % LiveIds.size();
+                Tree.DestroyProxy(LiveIds[Slot]);
+                LiveIds.erase(LiveIds.begin() + Slot);
+            }
+            for (uint32 Id : LiveIds)
+            {
+                Tree.MoveProxy(Id, MakeRandomBox(Random));
+            }
+        }
+    };
+
+    std::vector<uint32> Sorted(std::vector<uint32> Ids)
+    {
+        std::sort(Ids.begin(), Ids.end());
+        return Ids;
+    }
+}
+
+TEST(DynamicBVHTest, RandomUpdates_KeepTheTreeValid)
+{
+    FDynamicBVH Tree;
+    std::mt19937 Random(3);
+    std::vector<uint32> LiveIds;
+    for (uint32 Step = 0; Step < 4000; ++Step)
+    {
+        uint32 Action = Random() % 3;
+        if (Action == 0 || LiveIds.empty())
+        {
+            LiveIds.push_back(Tree.CreateProxy(MakeRandomBox(Random), nullptr));
+        }
+        else if (Action == 1)
+        {
+            uint32 Slot = Random() % LiveIds.size();
+            Tree.DestroyProxy(LiveIds[Slot]);
+            LiveIds.erase(LiveIds.begin() + Slot);
+        }
+        else
+        {
+            Tree.MoveProxy(LiveIds[Random() % LiveIds.size()], MakeRandomBox(Random));
+        }
+        ASSERT_TRUE(Tree.Validate()) << "Step " << Step;
+    }
+    EXPECT_EQ(Tree.GetNumProxies(), LiveIds.size());
+}
+
+TEST(DynamicBVHTest, MoveProxy_SmallMovesStayInTheFatBox)
+{
+    FDynamicBVH Tree(0.5f);
+    uint32 Id = Tree.CreateProxy(MakeBox(FVector(0.0f, 0.0f, 0.0f), 1.0f), nullptr);
+    Tree.CreateProxy(MakeBox(FVector(10.0f, 0.0f, 0.0f), 1.0f), nullptr);
+
+    EXPECT_FALSE(Tree.MoveProxy(Id, MakeBox(FVector(0.25f, 0.0f, 0.0f), 1.0f)));
+    EXPECT_FLOAT_EQ(Tree.GetFatBox(Id).Max.X, 1.5f);
+
+    EXPECT_TRUE(Tree.MoveProxy(Id, MakeBox(FVector(5.0f, 0.0f, 0.0f), 4.0f)));
+    EXPECT_FLOAT_EQ(Tree.GetFatBox(Id).Max.X, 9.5f);
+
+    // Shrinking far inside the fat box refits it too, so it does not stay loose forever
+    EXPECT_TRUE(Tree.MoveProxy(Id, MakeBox(FVector(5.0f, 0.0f, 0.0f), 1.0f)));
+    EXPECT_FLOAT_EQ(Tree.GetFatBox(Id).Max.X, 6.5f);
+    EXPECT_TRUE(Tree.Validate());
+}
+
+TEST(DynamicBVHTest, Queries_MatchBruteForce)
+{
+    FRandomTree Random(1000, 11);
+    const FDynamicBVH& Tree = Random.Tree;
+
+    FBox QueryBox(FVector(-20.0f, -10.0f, -30.0f), FVector(15.0f, 25.0f, 5.0f));
+    FVector SphereCenter(5.0f, -5.0f, 10.0f);
+    float SphereRadius = 18.0f;
+    FMatrix4x4 View = FMatrix4x4::LookAtLH(FVector(0.0f, 0.0f, -60.0f), FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 1.0f, 0.0f));
+    FMatrix4x4 Projection = FMatrix4x4::PerspectiveFovLH(DirectX::XM_PIDIV4, 1.0f, 0.1f, 80.0f);
+    FViewFrustum Frustum = FViewFrustum::FromViewProjection(View * Projection);
+
+    std::vector<uint32> ExpectedBox, ExpectedSphere, ExpectedFrustum;
+    for (uint32 Id : Random.LiveIds)
+    {
+        const FBox& Box = Tree.GetFatBox(Id);
+        if (Box.Intersects(QueryBox))
+        {
+            ExpectedBox.push_back(Id);
+        }
+        if (Box.ComputeSquaredDistanceToPoint(SphereCenter) <= SphereRadius * SphereRadius)
+        {
+            ExpectedSphere.push_back(Id);
+        }
+        FVector Center((Box.Min.X + Box.Max.X) * 0.5f, (Box.Min.Y + Box.Max.Y) * 0.5f, (Box.Min.Z + Box.Max.Z) * 0.5f);
+        FVector Extent(Box.Max.X - Center.X, Box.Max.Y - Center.Y, Box.Max.Z - Center.Z);
+        float Radius = std::sqrt(Extent.X * Extent.X + Extent.Y * Extent.Y + Extent.Z * Extent.Z);
+        if (Frustum.IntersectsBounds(FBoxSphereBounds(Center, Extent, Radius)))
+        {
+            ExpectedFrustum.push_back(Id);
+        }
+    }
+
+    std::vector<uint32> FoundBox, FoundSphere, FoundFrustum;
+    Tree.QueryBox(QueryBox, [&](uint32 Id) { FoundBox.push_back(Id); return true; });
+    Tree.QuerySphere(SphereCenter, SphereRadius, [&](uint32 Id) { FoundSphere.push_back(Id); return true; });
+    Tree.QueryFrustum(Frustum, [&](uint32 Id) { FoundFrustum.push_back(Id); return true; });
+
+    EXPECT_FALSE(ExpectedBox.empty());
+    EXPECT_FALSE(ExpectedSphere.empty());
+    EXPECT_FALSE(ExpectedFrustum.empty());
+    EXPECT_EQ(Sorted(FoundBox), Sorted(ExpectedBox));
+    EXPECT_EQ(Sorted(FoundSphere), Sorted(ExpectedSphere));
+    EXPECT_EQ(Sorted(FoundFrustum), Sorted(ExpectedFrustum));
+}
+
+TEST(DynamicBVHTest, Queries_VisitorFalseStops)
+{
+    FRandomTree Random(200, 5);
+    uint32 NumVisited = 0;
+    Random.Tree.QueryBox(FBox(FVector(-100.0f, -100.0f, -100.0f), FVector(100.0f, 100.0f, 100.0f)), [&](uint32)
+    {
+        return ++NumVisited < 3;
+    });
+    EXPECT_EQ(NumVisited, 3u);
+}
+
+TEST(DynamicBVHTest, RayCast_ClosestHitMatchesBruteForce)
+{
+    FRandomTree Random(1000, 17);
+    const FDynamicBVH& Tree = Random.Tree;
+
+    std::mt19937 Rays(23);
+    std::uniform_real_distribution<float> Unit(-1.0f, 1.0f);
+    for (uint32 RayIndex = 0; RayIndex < 64; ++RayIndex)
+    {
+        FVector Origin(Unit(Rays) * 60.0f, Unit(Rays) * 60.0f, Unit(Rays) * 60.0f);
+        FVector Direction(Unit(Rays), Unit(Rays), Unit(Rays));
+        if (RayIndex % 8 == 0)
+        {
+            Direction = FVector(0.0f, 0.0f, 1.0f);     // Axis-parallel
+        }
+        FVector InvDirection(1.0f / Direction.X, 1.0f / Direction.Y, 1.0f / Direction.Z);
+
+        float ExpectedDistance = 200.0f;
+        uint32 ExpectedId = FDynamicBVH::NullIndex;
+        for (uint32 Id : Random.LiveIds)
+        {
+            float Distance;
+            if (Tree.GetFatBox(Id).IntersectsRay(Origin, InvDirection, ExpectedDistance, Distance) && Distance < ExpectedDistance)
+            {
+                ExpectedDistance = Distance;
+                ExpectedId = Id;
+            }
+        }
+
+        float FoundDistance = 200.0f;
+        uint32 FoundId = FDynamicBVH::NullIndex;
+        Tree.RayCast(Origin, Direction, 200.0f, [&](uint32 Id, float MaxDistance)
+        {
+            float Distance;
+            if (Tree.GetFatBox(Id).IntersectsRay(Origin, InvDirection, MaxDistance, Distance) && Distance < FoundDistance)
+            {
+                FoundDistance = Distance;
+                FoundId = Id;
+                return Distance;
+            }
+            return MaxDistance;
+        });
+
+        ASSERT_EQ(FoundId, ExpectedId) << "Ray " << RayIndex;
+        if (FoundId != FDynamicBVH::NullIndex)
+        {
+            EXPECT_FLOAT_EQ(FoundDistance, ExpectedDistance);
+        }
+    }
+}
+
+TEST(DynamicBVHTest, Compact_KeepsProxyIdsAndResults)
+{
+    FRandomTree Random(500, 29);
+    FDynamicBVH& Tree = Random.Tree;
+    for (uint32 Id : Random.LiveIds)
+    {
+        Tree.MoveProxy(Id, Tree.GetFatBox(Id));
+    }
+
+    FBox QueryBox(FVector(-25.0f, -25.0f, -25.0f), FVector(25.0f, 25.0f, 25.0f));
+    std::vector<uint32> Before, After;
+    Tree.QueryBox(QueryBox, [&](uint32 Id) { Before.push_back(Id); return true; });
+    std::vector<FBox> FatBoxes;
+    for (uint32 Id : Random.LiveIds)
+    {
+        FatBoxes.push_back(Tree.GetFatBox(Id));
+    }
+
+    Tree.Compact();
+    ASSERT_TRUE(Tree.Validate());
+    Tree.QueryBox(QueryBox, [&](uint32 Id) { After.push_back(Id); return true; });
+
+    EXPECT_EQ(Sorted(After), Sorted(Before));
+    for (size_t i = 0; i < Random.LiveIds.size(); ++i)
+    {
+        EXPECT_FLOAT_EQ(Tree.GetFatBox(Random.LiveIds[i]).Min.X, FatBoxes[i].Min.X);
+    }
+
+    // Updates keep working on the compacted layout
+    uint32 NewId = Tree.CreateProxy(MakeBox(FVector(0.0f, 0.0f, 0.0f), 1.0f), nullptr);
+    Tree.DestroyProxy(Random.LiveIds[0]);
+    EXPECT_TRUE(Tree.Validate());
+    EXPECT_NE(NewId, Random.LiveIds[0]);
+}
+
+TEST(DynamicBVHTest, SortedInsertion_StaysBalanced)
+{
+    // A row of boxes inserted in order degenerates into a list without rotations
+    FDynamicBVH Tree;
+    const uint32 NumProxies = 4096;
+    for (uint32 i = 0; i < NumProxies; ++i)
+    {
+        Tree.CreateProxy(MakeBox(FVector(static_cast<float>(i) * 3.0f, 0.0f, 0.0f), 1.0f), nullptr);
+    }
+
+    EXPECT_TRUE(Tree.Validate());
+    EXPECT_EQ(Tree.GetNumNodes(), 2 * NumProxies - 1);
+    EXPECT_LE(Tree.GetHeight(), 2u * 12u);      // AVL bound is about 1.44 log2(n)
+    EXPECT_GT(Tree.GetAreaRatio(), 1.0f);
+}
+
+TEST(DynamicBVHTest, EmptyTree_QueriesFindNothing)
+{
+    FDynamicBVH Tree;
+    uint32 NumVisited = 0;
+    Tree.QueryBox(MakeBox(FVector(0.0f, 0.0f, 0.0f), 10.0f), [&](uint32) { ++NumVisited; return true; });
+    Tree.RayCast(FVector(0.0f, 0.0f, 0.0f), FVector(1.0f, 0.0f, 0.0f), 10.0f, [&](uint32, float) { ++NumVisited; return 0.0f; });
+    EXPECT_EQ(NumVisited, 0u);
+    EXPECT_EQ(Tree.GetHeight(), 0u);
+    EXPECT_TRUE(Tree.Validate());
+
+    // A lone proxy is the root; destroying it empties the tree again
+    uint32 Id = Tree.CreateProxy(MakeBox(FVector(0.0f, 0.0f, 0.0f), 1.0f), nullptr);
+    EXPECT_EQ(Tree.GetNumNodes(), 1u);
+    Tree.DestroyProxy(Id);
+    EXPECT_EQ(Tree.GetNumProxies(), 0u);
+    EXPECT_TRUE(Tree.Validate());
+}
@@ -0,0 +1,147 @@
+/**
+ * Unit tests for the per-frame linear allocator
+ * Tests FFrameAllocator alignment, block recycling across Reset, oversized
+ * allocations, concurrent allocation from several threads and the
+ * TFrameStlAllocator container adapters
+ */
+
+#include <gtest/gtest.h>
+#include "FrameAllocator.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+TEST(FrameAllocatorTest, AllocationsAreAlignedAndDistinct)
+{
+    FFrameAllocator Allocator;
+
+    uint8* First = static_cast<uint8*>(Allocator.Allocate(3, 1));
+    uint8* Aligned = static_cast<uint8*>(Allocator.Allocate(16, 64));
+    uint8* Second = static_cast<uint8*>(Allocator.Allocate(8, 8));
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(Aligned) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(Second) % 8, 0u);
+    EXPECT_GE(Aligned, First + 3);
+    EXPECT_GE(Second, Aligned + 16);
+
+    Allocator.Reset();
+    EXPECT_GE(Allocator.GetLastFrameBytes(), 27u);
+    EXPECT_EQ(Allocator.GetLastFrameBlocks(), 1u);
+}
+
+TEST(FrameAllocatorTest, Reset_RecyclesBlocks)
+{
+    FFrameAllocator Allocator;
+
+    auto RunFrame = [&Allocator]()
+    {
+        // Spans several blocks
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            memset(Allocator.Allocate(256), 0xAB, 256);
+        }
+        Allocator.Reset();
+    };
+
+    RunFrame();
+    uint32 WarmBlocks = Allocator.GetNumAllocatedBlocks();
+    EXPECT_GT(WarmBlocks, 1u);
+
+    for (uint32 Frame = 0; Frame < 100; ++Frame)
+    {
+        RunFrame();
+    }
+    EXPECT_EQ(Allocator.GetNumAllocatedBlocks(), WarmBlocks);
+    EXPECT_EQ(Allocator.GetLastFrameBlocks(), WarmBlocks);
+}
+
+TEST(FrameAllocatorTest, OversizedAllocation_GetsOwnBlock)
+{
+    FFrameAllocator Allocator;
+
+    uint8* Small = static_cast<uint8*>(Allocator.Allocate(16));
+    uint8* Large = static_cast<uint8*>(Allocator.Allocate(FFrameAllocator::BlockSize * 2));
+    memset(Large, 1, FFrameAllocator::BlockSize * 2);
+
+    // The thread keeps bumping through its regular block afterwards
+    uint8* Next = static_cast<uint8*>(Allocator.Allocate(16));
+    EXPECT_EQ(Next, Small + 16);
+
+    Allocator.Reset();
+    EXPECT_EQ(Allocator.GetLastFrameBlocks(), 2u);
+    EXPECT_EQ(Allocator.GetNumAllocatedBlocks(), 1u);
+}
+
+TEST(FrameAllocatorTest, ConcurrentThreads_DoNotOverlap)
+{
+    FFrameAllocator Allocator;
+    const uint32 NumThreads = 4;
+    const uint32 AllocationsPerThread = 5000;
+    std::atomic<uint32> NumCorrupted(0);
+
+    std::vector<std::thread> Threads;
+    for (uint32 Thread = 0; Thread < NumThreads; ++Thread)
+    {
+        Threads.emplace_back([&, Thread]()
+        {
+            std::vector<uint32*> Allocations;
+            for (uint32 i = 0; i < AllocationsPerThread; ++i)
+            {
+                uint32* Values = Allocator.AllocateArray<uint32>(8);
+                for (uint32 j = 0; j < 8; ++j)
+                {
+                    Values[j] = Thread;
+                }
+                Allocations.push_back(Values);
+            }
+
+            // Another thread writing into our memory would show up here
+            for (uint32* Values : Allocations)
+            {
+                for (uint32 j = 0; j < 8; ++j)
+                {
+                    if (Values[j] != Thread)
+                    {
+                        NumCorrupted.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& Thread : Threads)
+    {
+        Thread.join();
+    }
+
+    EXPECT_EQ(NumCorrupted.load(), 0u);
+    Allocator.Reset();
+    EXPECT_GE(Allocator.GetLastFrameBytes(), static_cast<size_t>(NumThreads) * AllocationsPerThread * 8 * sizeof(uint32));
+}
+
+TEST(FrameAllocatorTest, StlAdapters_UseFrameMemory)
+{
+    FFrameAllocator Allocator;
+
+    TFrameVector<int32> Values{ TFrameStlAllocator<int32>(Allocator) };
+    for (int32 i = 0; i < 1000; ++i)
+    {
+        Values.push_back(i);
+    }
+    EXPECT_EQ(Values[999], 999);
+
+    FFrameString Text{ TFrameStlAllocator<char>(Allocator) };
+    Text = "Shadow: Point Light ";
+    Text += "0 - a name longer than the small string buffer";
+    EXPECT_EQ(Text.substr(0, 6), "Shadow");
+
+    // Rebinding keeps the same allocator
+    TFrameStlAllocator<double> Rebound(Values.get_allocator());
+    EXPECT_EQ(Rebound.GetAllocator(), &Allocator);
+    EXPECT_TRUE(Rebound == Values.get_allocator());
+
+    Values = TFrameVector<int32>{ TFrameStlAllocator<int32>(Allocator) };
+    Text = FFrameString{ TFrameStlAllocator<char>(Allocator) };
+    Allocator.Reset();
+    EXPECT_GT(Allocator.GetLastFrameBytes(), 1000 * sizeof(int32));
+}
@@ -0,0 +1,162 @@
+/**
+ * Unit tests for the masked occlusion buffer
+ * Tests FMaskedOcclusionBuffer coverage merging of occluder triangles into
+ * whole-tile depths, box tests behind, in front of and beside occluders,
+ * near plane clipping, and rasterizing bins one at a time
+ */
+
+#include <gtest/gtest.h>
+#include "MaskedOcclusionBuffer.h"
+#include <cmath>
+
+namespace
+{
+    // Camera at the origin looking down +Z, with the buffer's aspect ratio
+    FMatrix4x4 MakeViewProjection(const FMaskedOcclusionBuffer& Buffer)
+    {
+        FMatrix4x4 View = FMatrix4x4::LookAtLH(FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 1.0f), FVector(0.0f, 1.0f, 0.0f));
+        float Aspect = static_cast<float>(Buffer.GetWidth()) / static_cast<float>(Buffer.GetHeight());
+        FMatrix4x4 Projection = FMatrix4x4::PerspectiveFovLH(DirectX::XM_PIDIV2, Aspect, 0.1f, 100.0f);
+        return View * Projection;
+    }
+
+    // A rectangle facing the camera at depth Z, as two triangles
+    FOccluderMesh MakeWall(float MinX, float MinY, float MaxX, float MaxY, float Z)
+    {
+        FOccluderMesh Mesh;
+        Mesh.Positions = { FVector(MinX, MinY, Z), FVector(MaxX, MinY, Z), FVector(MaxX, MaxY, Z), FVector(MinX, MaxY, Z) };
+        Mesh.Indices = { 0, 1, 2, 0, 2, 3 };
+        return Mesh;
+    }
+
+    FBox MakeCube(const FVector& Center, float HalfSize)
+    {
+        return FBox(FVector(Center.X - HalfSize, Center.Y - HalfSize, Center.Z - HalfSize),
+                    FVector(Center.X + HalfSize, Center.Y + HalfSize, Center.Z + HalfSize));
+    }
+}
+
+TEST(MaskedOcclusionTest, EmptyBuffer_EverythingVisible)
+{
+    FMaskedOcclusionBuffer Buffer;
+    FMatrix4x4 ViewProjection = MakeViewProjection(Buffer);
+    Buffer.RasterizeAll();
+
+    EXPECT_EQ(Buffer.GetWidth() % FMaskedOcclusionBuffer::TileWidth, 0u);
+    EXPECT_EQ(Buffer.GetHeight() % FMaskedOcclusionBuffer::TileHeight, 0u);
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 0.0f, 50.0f), 1.0f), ViewProjection));
+    EXPECT_FLOAT_EQ(Buffer.GetTileDepth(0, 0), 1.0f);
+}
+
+TEST(MaskedOcclusionTest, FullScreenWall_HidesWhatIsBehindIt)
+{
+    FMaskedOcclusionBuffer Buffer;
+    FMatrix4x4 ViewProjection = MakeViewProjection(Buffer);
+
+    // Two triangles: no tile on the diagonal is covered by one alone, the masks complete them
+    EXPECT_EQ(Buffer.AddOccluder(ViewProjection, MakeWall(-100.0f, -100.0f, 100.0f, 100.0f, 10.0f)), 2u);
+    Buffer.RasterizeAll();
+
+    for (uint32 TileY = 0; TileY < Buffer.GetNumTilesY(); ++TileY)
+    {
+        for (uint32 TileX = 0; TileX < Buffer.GetNumTilesX(); ++TileX)
+        {
+            ASSERT_LT(Buffer.GetTileDepth(TileX, TileY), 1.0f) << TileX << ", " << TileY;
+        }
+        EXPECT_LT(Buffer.GetRowDepth(TileY), 1.0f);
+    }
+
+    EXPECT_FALSE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 0.0f, 20.0f), 1.0f), ViewProjection));
+    EXPECT_FALSE(Buffer.IsBoxVisible(MakeCube(FVector(5.0f, -3.0f, 60.0f), 4.0f), ViewProjection));
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 0.0f, 5.0f), 1.0f), ViewProjection));
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 0.0f, 10.5f), 1.0f), ViewProjection));    // Pokes through
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 0.0f, 0.0f), 1.0f), ViewProjection));     // Around the camera
+}
+
+TEST(MaskedOcclusionTest, PartialWall_OnlyHidesWhatItCovers)
+{
+    FMaskedOcclusionBuffer Buffer;
+    FMatrix4x4 ViewProjection = MakeViewProjection(Buffer);
+
+    // Left half of the view
+    Buffer.AddOccluder(ViewProjection, MakeWall(-100.0f, -100.0f, 0.0f, 100.0f, 10.0f));
+    Buffer.RasterizeAll();
+
+    EXPECT_FALSE(Buffer.IsBoxVisible(MakeCube(FVector(-15.0f, 0.0f, 30.0f), 2.0f), ViewProjection));
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(15.0f, 0.0f, 30.0f), 2.0f), ViewProjection));
+
+    // Straddling the wall's edge is visible through the uncovered half
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 0.0f, 30.0f), 2.0f), ViewProjection));
+}
+
+TEST(MaskedOcclusionTest, SmallOccluder_LeavesPartlyCoveredTilesOpen)
+{
+    FMaskedOcclusionBuffer Buffer;
+    FMatrix4x4 ViewProjection = MakeViewProjection(Buffer);
+
+    // Narrower than a tile: no tile is wholly covered, so it hides nothing
+    Buffer.AddOccluder(ViewProjection, MakeWall(-0.05f, -0.05f, 0.05f, 0.05f, 10.0f));
+    Buffer.RasterizeAll();
+
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 0.0f, 50.0f), 0.1f), ViewProjection));
+}
+
+TEST(MaskedOcclusionTest, OccluderCrossingTheNearPlane_IsClipped)
+{
+    FMaskedOcclusionBuffer Buffer;
+    FMatrix4x4 ViewProjection = MakeViewProjection(Buffer);
+
+    // A floor under the camera reaching behind it
+    FOccluderMesh Floor;
+    Floor.Positions = { FVector(-100.0f, -1.0f, -50.0f), FVector(100.0f, -1.0f, -50.0f), FVector(100.0f, -1.0f, 90.0f),
+                        FVector(-100.0f, -1.0f, 90.0f) };
+    Floor.Indices = { 0, 2, 1, 0, 3, 2 };
+    EXPECT_GE(Buffer.AddOccluder(ViewProjection, Floor), 2u);
+    Buffer.RasterizeAll();
+
+    // Below the floor is hidden, above it is not
+    EXPECT_FALSE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, -5.0f, 20.0f), 1.0f), ViewProjection));
+    EXPECT_TRUE(Buffer.IsBoxVisible(MakeCube(FVector(0.0f, 2.0f, 20.0f), 1.0f), ViewProjection));
+
+    // Entirely behind the camera: nothing to bin
+    EXPECT_EQ(Buffer.AddOccluder(ViewProjection, MakeWall(-1.0f, -1.0f, 1.0f, 1.0f, -5.0f)), 0u);
+}
+
+TEST(MaskedOcclusionTest, BinsRasterizedSeparately_MatchRasterizeAll)
+{
+    FMaskedOcclusionBuffer Serial;
+    FMaskedOcclusionBuffer Binned;
+    FMatrix4x4 ViewProjection = MakeViewProjection(Serial);
+
+    // Overlapping walls at different depths and angles
+    FOccluderMesh Slanted;
+    Slanted.Positions = { FVector(-30.0f, -10.0f, 20.0f), FVector(10.0f, -10.0f, 40.0f), FVector(-5.0f, 15.0f, 25.0f) };
+    Slanted.Indices = { 0, 1, 2 };
+    for (FMaskedOcclusionBuffer* Buffer : { &Serial, &Binned })
+    {
+        Buffer->AddOccluder(ViewProjection, MakeWall(-12.0f, -4.0f, 3.0f, 6.0f, 15.0f));
+        Buffer->AddOccluder(ViewProjection, Slanted);
+    }
+    Serial.RasterizeAll();
+    for (uint32 Bin = Binned.GetNumBins(); Bin-- > 0;)
+    {
+        Binned.RasterizeBin(Bin);
+    }
+
+    uint32 NumCovered = 0;
+    for (uint32 TileY = 0; TileY < Serial.GetNumTilesY(); ++TileY)
+    {
+        for (uint32 TileX = 0; TileX < Serial.GetNumTilesX(); ++TileX)
+        {
+            ASSERT_EQ(Serial.GetTileDepth(TileX, TileY), Binned.GetTileDepth(TileX, TileY));
+            NumCovered += Serial.GetTileDepth(TileX, TileY) < 1.0f;
+        }
+    }
+    EXPECT_GT(NumCovered, 0u);
+
+    // Clear drops the triangles and the depth
+    Serial.Clear();
+    Serial.RasterizeAll();
+    EXPECT_EQ(Serial.GetNumBinnedTriangles(), 0u);
+    EXPECT_FLOAT_EQ(Serial.GetTileDepth(0, 0), 1.0f);
+}
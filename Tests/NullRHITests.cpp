@@ -0,0 +1,2260 @@
+/**
+ * Unit tests for the headless null RHI backend
+ * Tests FNullRHI resources, FRecordingCommandList recording, replay of
+ * FRHICommandRecorder streams, redundant state filtering, mesh draw command
+ * sorting, instanced draws, transient constant allocation, deferred
+ * resource release, geometry sub-allocation, the pipeline state cache, the
+ * shared mesh registry, the per-view uniform buffer, frustum, occlusion and shadow caster culling, the
+ * render scene's spatial index, scene render state snapshots, frame latency tracking and full headless FRenderer frames
+ */
+
+#include <gtest/gtest.h>
+#include "NullRHI.h"
+#include "RHICommandRecorder.h"
+#include "RHIStateCache.h"
+#include "Renderer.h"
+#include "PipelineStateCache.h"
+#include "GeometryBufferAllocator.h"
+#include "MeshRegistry.h"
+#include "MeshDrawCommand.h"
+#include "Scene.h"
+#include "ScenePrimitive.h"
+#include "GameGlobals.h"
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <thread>
+
+// Test class
+class NullRHITest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        RHI.reset(CreateNullRHI());
+        ASSERT_TRUE(RHI->Initialize(nullptr, 1280, 720));
+        CmdList = static_cast<FNullRHI*>(RHI.get())->GetRecordingCommandList();
+    }
+
+    void TearDown() override
+    {
+        RHI->Shutdown();
+    }
+
+    std::unique_ptr<FRHI> RHI;
+    FRecordingCommandList* CmdList = nullptr;
+};
+
+// ============================================
+// Resource Tests
+// ============================================
+
+TEST_F(NullRHITest, VertexBuffer_HoldsInitialData)
+{
+    float data[6] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+    std::unique_ptr<FRHIBuffer> buffer(RHI->CreateVertexBuffer(sizeof(data), data));
+
+    void* mapped = buffer->Map();
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(memcmp(mapped, data, sizeof(data)), 0);
+    buffer->Unmap();
+}
+
+TEST_F(NullRHITest, ConstantBuffer_AlignedTo256Bytes)
+{
+    std::unique_ptr<FRHIBuffer> buffer(RHI->CreateConstantBuffer(64));
+    EXPECT_EQ(static_cast<FNullBuffer*>(buffer.get())->GetSize(), 256u);
+}
+
+TEST_F(NullRHITest, DepthTexture_AllocatesAllSlices)
+{
+    std::unique_ptr<FRHITexture> texture(RHI->CreateDepthTexture(64, 32, ERTFormat::D16_UNORM, 6));
+
+    EXPECT_EQ(texture->GetWidth(), 64u);
+    EXPECT_EQ(texture->GetHeight(), 32u);
+    EXPECT_EQ(texture->GetArraySize(), 6u);
+    EXPECT_FALSE(texture->IsColorTexture());
+    EXPECT_EQ(static_cast<FNullTexture*>(texture.get())->GetSizeInBytes(), 64u * 32u * 6u * 2u);
+}
+
+TEST_F(NullRHITest, PipelineState_RemembersFlags)
+{
+    EPipelineFlags flags = EPipelineFlags::EnableDepth | EPipelineFlags::DepthOnly;
+    std::unique_ptr<FRHIPipelineState> pso(RHI->CreateGraphicsPipelineStateEx(flags));
+    EXPECT_EQ(static_cast<FNullPipelineState*>(pso.get())->GetFlags(), flags);
+}
+
+// ============================================
+// Recording Tests
+// ============================================
+
+TEST_F(NullRHITest, Recording_StreamDecodesInOrder)
+{
+    std::unique_ptr<FRHIPipelineState> pso(RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::EnableDepth));
+
+    CmdList->BeginFrame();
+    CmdList->SetPipelineState(pso.get());
+    CmdList->DrawIndexedPrimitive(36, 0, 0);
+    CmdList->EndFrame();
+
+    std::vector<ENullCommand> commands;
+    uint32 indexCount = 0;
+    CmdList->ForEachCommand([&](ENullCommand Command, const uint8* Payload, uint32 PayloadSize)
+    {
+        commands.push_back(Command);
+        if (Command == ENullCommand::DrawIndexedPrimitive)
+        {
+            ASSERT_EQ(PayloadSize, 3u * sizeof(uint32));
+            memcpy(&indexCount, Payload, sizeof(uint32));
+        }
+    });
+
+    ASSERT_EQ(commands.size(), 4u);
+    EXPECT_EQ(commands[0], ENullCommand::BeginFrame);
+    EXPECT_EQ(commands[1], ENullCommand::SetPipelineState);
+    EXPECT_EQ(commands[2], ENullCommand::DrawIndexedPrimitive);
+    EXPECT_EQ(commands[3], ENullCommand::EndFrame);
+    EXPECT_EQ(indexCount, 36u);
+}
+
+TEST_F(NullRHITest, Recording_BeginFrameClearsStream)
+{
+    CmdList->BeginFrame();
+    CmdList->DrawPrimitive(3, 0);
+    CmdList->EndFrame();
+    CmdList->BeginFrame();
+
+    EXPECT_EQ(CmdList->GetStats().CommandCount, 1u);
+    EXPECT_EQ(CmdList->GetStats().DrawCalls, 0u);
+}
+
+TEST_F(NullRHITest, Recording_TracksBoundState)
+{
+    std::unique_ptr<FRHIBuffer> vb(RHI->CreateVertexBuffer(64, nullptr));
+    std::unique_ptr<FRHIBuffer> cb(RHI->CreateConstantBuffer(64));
+    std::unique_ptr<FRHITexture> shadowMap(RHI->CreateDepthTexture(16, 16, ERTFormat::D32_FLOAT, 6));
+
+    CmdList->BeginFrame();
+    CmdList->SetVertexBuffer(vb.get(), 0, 24);
+    CmdList->SetConstantBuffer(cb.get(), 2);
+    CmdList->BeginShadowPass(shadowMap.get(), 3);
+
+    const FNullBoundState& state = CmdList->GetBoundState();
+    EXPECT_EQ(state.VertexBuffer, vb.get());
+    EXPECT_EQ(state.VertexStride, 24u);
+    EXPECT_EQ(state.ConstantBuffers[2], cb.get());
+    EXPECT_TRUE(state.bInShadowPass);
+    EXPECT_EQ(state.ShadowPassFace, 3u);
+
+    CmdList->EndShadowPass();
+    EXPECT_FALSE(CmdList->GetBoundState().bInShadowPass);
+    EXPECT_FLOAT_EQ(CmdList->GetBoundState().Viewport[2], 1280.0f);
+}
+
+TEST_F(NullRHITest, Recording_EventNamesAreStored)
+{
+    CmdList->BeginFrame();
+    CmdList->BeginEvent("ShadowDepths");
+    CmdList->EndEvent();
+
+    std::string name;
+    CmdList->ForEachCommand([&](ENullCommand Command, const uint8* Payload, uint32 /*PayloadSize*/)
+    {
+        if (Command == ENullCommand::BeginEvent)
+        {
+            uint16 length = 0;
+            memcpy(&length, Payload, sizeof(uint16));
+            name.assign(reinterpret_cast<const char*>(Payload + sizeof(uint16)), length);
+        }
+    });
+
+    EXPECT_EQ(name, "ShadowDepths");
+    EXPECT_EQ(CmdList->GetBoundState().EventDepth, 0u);
+}
+
+// ============================================
+// Command Recorder Tests
+// ============================================
+
+// Issue one of every kind of command with recognisable arguments
+static void RecordCommandSequence(FRHICommandList* Target, FRHIPipelineState* PSO, FRHIBuffer* VB, FRHIBuffer* IB,
+                                  FRHIBuffer* CB, FRHITexture* ShadowMap)
+{
+    float rootConstants[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+
+    Target->BeginFrame();
+    Target->BeginEvent("ShadowDepths");
+    Target->BeginShadowPass(ShadowMap, 2);
+    Target->SetViewport(0.0f, 0.0f, 512.0f, 512.0f);
+    Target->ClearDepthOnly(ShadowMap, 2);
+    Target->SetRootConstants(0, 4, rootConstants);
+    Target->EndShadowPass();
+    Target->EndEvent();
+    Target->ClearRenderTarget(FColor(0.2f, 0.3f, 0.4f, 1.0f));
+    Target->ClearDepthStencil();
+    Target->SetPipelineState(PSO);
+    Target->SetConstantBuffer(CB, 1);
+    Target->SetShadowMapTexture(ShadowMap);
+    Target->SetDiffuseTexture(nullptr);
+    Target->SetVertexBuffer(VB, 0, sizeof(FLitVertex));
+    Target->SetIndexBuffer(IB);
+    Target->SetPrimitiveTopology(false);
+    Target->DrawIndexedPrimitive(36, 6, 4);
+    Target->DrawIndexedLines(24, 0, 0);
+    Target->DrawPrimitive(3, 9);
+    Target->FlushCommandsFor2D();
+    Target->RHIDrawText("FPS: 60.0", FVector2D(10.0f, 20.0f), 14.0f, FColor(0.0f, 1.0f, 0.0f, 1.0f));
+    Target->DrawDebugTexture(ShadowMap, 1.0f, 2.0f, 128.0f, 128.0f);
+    Target->EndFrame();
+    Target->Present();
+}
+
+TEST_F(NullRHITest, Recorder_ReplayMatchesDirectRecording)
+{
+    std::unique_ptr<FRHIPipelineState> pso(RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::EnableDepth));
+    std::unique_ptr<FRHIBuffer> vb(RHI->CreateVertexBuffer(64, nullptr));
+    std::unique_ptr<FRHIBuffer> ib(RHI->CreateIndexBuffer(64, nullptr));
+    std::unique_ptr<FRHIBuffer> cb(RHI->CreateConstantBuffer(64));
+    std::unique_ptr<FRHITexture> shadowMap(RHI->CreateDepthTexture(16, 16, ERTFormat::D32_FLOAT, 6));
+
+    RecordCommandSequence(CmdList, pso.get(), vb.get(), ib.get(), cb.get(), shadowMap.get());
+    std::vector<uint8> directStream = CmdList->GetCommandStream();
+    uint32 directCount = CmdList->GetStats().CommandCount;
+
+    FRHICommandRecorder recorder;
+    RecordCommandSequence(&recorder, pso.get(), vb.get(), ib.get(), cb.get(), shadowMap.get());
+    EXPECT_EQ(recorder.GetNumCommands(), directCount);
+
+    recorder.Replay(CmdList);
+    EXPECT_EQ(CmdList->GetCommandStream(), directStream);
+    EXPECT_EQ(CmdList->GetPresentedFrameCount(), 2u);
+}
+
+TEST_F(NullRHITest, Recorder_UpdateBufferDeferredUntilReplay)
+{
+    std::unique_ptr<FRHIBuffer> cb(RHI->CreateConstantBuffer(64));
+    const FNullBuffer* nullBuffer = static_cast<FNullBuffer*>(cb.get());
+
+    FRHICommandRecorder recorder;
+    float first[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+    float second[4] = { 5.0f, 6.0f, 7.0f, 8.0f };
+    recorder.UpdateBuffer(cb.get(), first, sizeof(first));
+    recorder.DrawPrimitive(3, 0);
+    recorder.UpdateBuffer(cb.get(), second, sizeof(second));
+
+    // The caller's memory may change after recording; the stream holds a copy
+    second[0] = 0.0f;
+    EXPECT_EQ(nullBuffer->GetData()[0], 0u);
+
+    recorder.Replay(CmdList);
+    float result[4] = {};
+    memcpy(result, nullBuffer->GetData(), sizeof(result));
+    EXPECT_FLOAT_EQ(result[0], 5.0f);
+    EXPECT_FLOAT_EQ(result[3], 8.0f);
+    EXPECT_FALSE(nullBuffer->IsMapped());
+
+    // Reset keeps the allocation for the next frame
+    size_t capacity = recorder.GetStreamCapacity();
+    recorder.Reset();
+    EXPECT_EQ(recorder.GetNumCommands(), 0u);
+    EXPECT_EQ(recorder.GetStreamSize(), 0u);
+    EXPECT_EQ(recorder.GetStreamCapacity(), capacity);
+}
+
+// ============================================
+// State Cache Tests
+// ============================================
+
+TEST_F(NullRHITest, StateCache_DropsRepeatedBinds)
+{
+    FRHIPipelineState* pso = RHI->CreateGraphicsPipelineState(true);
+    FRHIBuffer* vertices = RHI->CreateVertexBuffer(1024, nullptr);
+    FRHIBuffer* indices = RHI->CreateIndexBuffer(256, nullptr);
+    FRHIBuffer* constants = RHI->CreateConstantBuffer(1024);
+    FRHITexture* shadowMap = RHI->CreateDepthTexture(64, 64, ERTFormat::D32_FLOAT);
+
+    FRHIStateCache cache(CmdList);
+    cache.BeginFrame();
+    for (uint32 draw = 0; draw < 4; ++draw)
+    {
+        cache.SetPipelineState(pso);
+        cache.SetVertexBuffer(vertices, 0, sizeof(FLitVertex));
+        cache.SetIndexBuffer(indices);
+        cache.SetConstantBuffer(constants, 0, 0);
+        cache.SetConstantBuffer(constants, 1, draw * 256);
+        cache.SetShadowMapTexture(shadowMap);
+        cache.DrawIndexedPrimitive(6, 0, 0);
+    }
+
+    // Only the per-draw constant slice changes after the first draw
+    const FNullCommandStats& stats = CmdList->GetStats();
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetPipelineState), 1u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetVertexBuffer), 1u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetIndexBuffer), 1u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetConstantBuffer), 5u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetShadowMapTexture), 1u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::DrawIndexedPrimitive), 4u);
+
+    // A stride change is a different binding
+    cache.SetVertexBuffer(vertices, 0, sizeof(FVertex));
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetVertexBuffer), 2u);
+
+    cache.Present();
+    const FRHIStateCacheStats& cacheStats = cache.GetLastFrameStats();
+    EXPECT_EQ(cacheStats.Issued.GetTotal(), 10u);
+    EXPECT_EQ(cacheStats.Filtered.PipelineStates, 3u);
+    EXPECT_EQ(cacheStats.Filtered.ConstantBuffers, 3u);
+    EXPECT_EQ(cacheStats.Filtered.GetTotal(), 15u);
+
+    delete shadowMap;
+    delete constants;
+    delete indices;
+    delete vertices;
+    delete pso;
+}
+
+TEST_F(NullRHITest, StateCache_ForgetsBindingsTheBackendDrops)
+{
+    FRHIPipelineState* lit = RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting);
+    FRHIPipelineState* textured = RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::EnableDepth | EPipelineFlags::EnableTextures);
+    FRHIBuffer* vertices = RHI->CreateVertexBuffer(1024, nullptr);
+    FRHIBuffer* constants = RHI->CreateConstantBuffer(256);
+    FRHITexture* shadowMap = RHI->CreateDepthTexture(64, 64, ERTFormat::D32_FLOAT);
+    uint8 texels[4 * 4 * 4] = {};
+    FRHITexture* diffuse = RHI->CreateTexture2D(4, 4, texels);
+
+    FRHIStateCache cache(CmdList);
+    cache.BeginFrame();
+    const FNullCommandStats& stats = CmdList->GetStats();
+
+    // A different PSO has its own root signature: root bindings are re-issued, buffers are not
+    cache.SetPipelineState(lit);
+    cache.SetVertexBuffer(vertices, 0, sizeof(FLitVertex));
+    cache.SetConstantBuffer(constants, 0, 0);
+    cache.SetPipelineState(textured);
+    cache.SetVertexBuffer(vertices, 0, sizeof(FLitVertex));
+    cache.SetConstantBuffer(constants, 0, 0);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetVertexBuffer), 1u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetConstantBuffer), 2u);
+
+    // Each texture sets its own descriptor heap, so alternating binds all go through
+    cache.SetShadowMapTexture(shadowMap);
+    cache.SetDiffuseTexture(diffuse);
+    cache.SetShadowMapTexture(shadowMap);
+    cache.SetDiffuseTexture(diffuse);
+    cache.SetDiffuseTexture(diffuse);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetShadowMapTexture), 2u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetDiffuseTexture), 2u);
+
+    // Flushing resets the backend command list and everything on it
+    cache.FlushCommandsFor2D();
+    cache.SetPipelineState(textured);
+    cache.SetVertexBuffer(vertices, 0, sizeof(FLitVertex));
+    cache.SetDiffuseTexture(diffuse);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetPipelineState), 3u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetVertexBuffer), 2u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetDiffuseTexture), 3u);
+
+    delete diffuse;
+    delete shadowMap;
+    delete constants;
+    delete vertices;
+    delete textured;
+    delete lit;
+}
+
+TEST_F(NullRHITest, StateCache_RendererFiltersSceneBinds)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);  // One draw per proxy
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FDirectionalLight* sun = new FDirectionalLight();
+    sun->SetDirection(FVector(0.5f, -0.8f, 0.3f));
+    scene.GetLightScene()->AddLight(sun);
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        scene.AddPrimitive(new FCubePrimitive());
+    }
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // The cubes share a PSO and their geometry pages, so each is bound once per pass
+    const FRHIStateCacheStats& stats = renderer.GetStateCacheStats();
+    const FNullCommandStats& cmdStats = CmdList->GetStats();
+    EXPECT_EQ(stats.Issued.PipelineStates, cmdStats.GetCount(ENullCommand::SetPipelineState));
+    EXPECT_EQ(stats.Issued.VertexBuffers, cmdStats.GetCount(ENullCommand::SetVertexBuffer));
+    EXPECT_GE(stats.Filtered.PipelineStates, 7u);
+    EXPECT_GE(stats.Filtered.VertexBuffers, 7u);
+    EXPECT_GE(stats.Filtered.IndexBuffers, 7u);
+    EXPECT_GT(stats.Filtered.GetTotal(), stats.Issued.PipelineStates + stats.Issued.VertexBuffers);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Mesh Draw Command Tests
+// ============================================
+
+TEST_F(NullRHITest, MeshDrawCommands_SortGroupsByStateInSubmissionOrder)
+{
+    FRHIPipelineState* lit = RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting);
+    FRHIPipelineState* unlit = RHI->CreateGraphicsPipelineState(true);
+    FRHIBuffer* vertexPages[2] = { RHI->CreateVertexBuffer(1024, nullptr), RHI->CreateVertexBuffer(1024, nullptr) };
+    FRHIBuffer* indices = RHI->CreateIndexBuffer(256, nullptr);
+
+    // Alternate pipeline states and vertex pages; FirstElement records the add order
+    FMeshDrawCommandList drawList;
+    drawList.Reset();
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        FMeshDrawCommand command;
+        command.PipelineState = (i % 2) ? unlit : lit;
+        command.VertexBuffer = vertexPages[(i / 2) % 2];
+        command.VertexStride = sizeof(FVertex);
+        command.IndexBuffer = indices;
+        command.NumElements = 6;
+        command.FirstElement = i;
+        drawList.AddCommand(command);
+    }
+    EXPECT_EQ(drawList.GetCommand(1).FirstElement, 1u);
+
+    // Pipeline state first, then vertex buffer; equal state keeps the order it was added in
+    drawList.Sort();
+    ASSERT_TRUE(drawList.IsSorted());
+    const uint32 expectedOrder[8] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(drawList.GetCommand(i).FirstElement, expectedOrder[i]);
+    }
+
+    // One PSO change and two vertex buffer changes per PSO through the state cache
+    FRHIStateCache cache(CmdList);
+    cache.BeginFrame();
+    drawList.Submit(&cache);
+    const FNullCommandStats& stats = CmdList->GetStats();
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetPipelineState), 2u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetVertexBuffer), 4u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::DrawIndexedPrimitive), 8u);
+
+    // Reset keeps nothing but storage
+    drawList.Reset();
+    EXPECT_EQ(drawList.Num(), 0u);
+    EXPECT_FALSE(drawList.IsSorted());
+
+    delete indices;
+    delete vertexPages[1];
+    delete vertexPages[0];
+    delete unlit;
+    delete lit;
+}
+
+TEST_F(NullRHITest, MeshDrawCommands_PassPipelineStateAndRootConstants)
+{
+    FRHIPipelineState* depthOnly = RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::EnableDepth | EPipelineFlags::DepthOnly);
+    FRHIPipelineState* texturedDepthOnly = RHI->CreateGraphicsPipelineStateEx(
+        EPipelineFlags::EnableDepth | EPipelineFlags::DepthOnly | EPipelineFlags::EnableTextures);
+    FRHIBuffer* vertices = RHI->CreateVertexBuffer(1024, nullptr);
+
+    FMatrix4x4 mvp = FMatrix4x4::Translation(1.0f, 2.0f, 3.0f);
+    FMeshDrawCommandList drawList;
+
+    FMeshDrawCommand own;
+    own.PipelineState = texturedDepthOnly;
+    own.VertexBuffer = vertices;
+    own.DrawType = EMeshDrawType::NonIndexed;
+    own.NumElements = 3;
+    own.SetRootConstants(&mvp.Matrix, 16);
+    drawList.AddCommand(own);
+
+    FMeshDrawCommand inherited = own;
+    inherited.PipelineState = nullptr;
+    drawList.AddCommand(inherited);
+
+    // Commands without a PSO sort first and draw with the pass's
+    drawList.Sort();
+    EXPECT_EQ(drawList.GetCommand(0).PipelineState, nullptr);
+    EXPECT_EQ(drawList.GetCommand(1).PipelineState, texturedDepthOnly);
+    EXPECT_EQ(drawList.GetCommand(0).NumRootConstants, 16u);
+    EXPECT_EQ(memcmp(drawList.GetCommand(0).RootConstants, &mvp.Matrix, sizeof(float) * 16), 0);
+
+    FMeshDrawContext context;
+    context.RHI = RHI.get();
+    context.PassPipelineState = depthOnly;
+    drawList.UpdateAndSubmit(EMeshPass::ShadowDepth, context, CmdList);
+    const FNullCommandStats& stats = CmdList->GetStats();
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetPipelineState), 2u);
+    EXPECT_EQ(CmdList->GetBoundState().PipelineState, texturedDepthOnly);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetRootConstants), 2u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::DrawPrimitive), 2u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetIndexBuffer), 0u);
+
+    delete vertices;
+    delete texturedDepthOnly;
+    delete depthOnly;
+}
+
+TEST_F(NullRHITest, MeshDrawCommands_SortingCutsSceneStateChanges)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);  // One draw per proxy
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FDirectionalLight* sun = new FDirectionalLight();
+    sun->SetDirection(FVector(0.5f, -0.8f, 0.3f));
+    scene.GetLightScene()->AddLight(sun);
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        scene.AddPrimitive(new FCubePrimitive());
+        scene.AddPrimitive(new FUnlitCubePrimitive());
+    }
+    renderer.UpdateFromScene(&scene);
+
+    // Lit and unlit proxies alternate in scene order
+    renderer.SetSortMeshDrawCommands(false);
+    renderer.RenderFrame();
+    const FNullCommandStats& cmdStats = CmdList->GetStats();
+    uint32 unsortedPSOChanges = cmdStats.GetCount(ENullCommand::SetPipelineState);
+    uint32 unsortedDraws = cmdStats.DrawCalls;
+
+    renderer.SetSortMeshDrawCommands(true);
+    renderer.RenderFrame();
+    uint32 sortedPSOChanges = cmdStats.GetCount(ENullCommand::SetPipelineState);
+    EXPECT_EQ(cmdStats.DrawCalls, unsortedDraws);
+    EXPECT_GE(unsortedPSOChanges, 16u);
+    EXPECT_LE(sortedPSOChanges, 3u);  // Shadow depth-only, lit, unlit
+    EXPECT_EQ(renderer.GetStateCacheStats().Issued.PipelineStates, sortedPSOChanges);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+TEST_F(NullRHITest, MeshDrawCommands_CachedUntilProxiesChange)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);  // One draw per proxy
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FDirectionalLight* sun = new FDirectionalLight();
+    sun->SetDirection(FVector(0.5f, -0.8f, 0.3f));
+    scene.GetLightScene()->AddLight(sun);
+    std::vector<FCubePrimitive*> cubes;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        cubes.push_back(new FCubePrimitive());
+        scene.AddPrimitive(cubes.back());
+    }
+    scene.AddPrimitive(new FUnlitCubePrimitive());
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    const FRenderScene* renderScene = renderer.GetRenderScene();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 1u);
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::BasePass), 5u);
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::ShadowDepth), 4u);  // Unlit casts nothing
+    uint32 drawCalls = CmdList->GetStats().DrawCalls;
+
+    // Moving primitives only patches per-frame data, which is still written every frame
+    for (uint32 frame = 0; frame < 3; ++frame)
+    {
+        cubes[0]->SetPosition(FVector(static_cast<float>(frame), 0.0f, 0.0f));
+        renderer.UpdateFromScene(&scene);
+        renderer.RenderFrame();
+        EXPECT_EQ(CmdList->GetStats().DrawCalls, drawCalls);
+    }
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 1u);
+    RHI->BeginTransientFrame();
+    EXPECT_GE(RHI->GetTransientConstantStats().LastFrameAllocations, 4u + 1u + 1u);
+
+    // A new primitive, a caster leaving the shadow pass and a hidden primitive each rebuild
+    scene.AddPrimitive(new FCubePrimitive());
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 2u);
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::BasePass), 6u);
+
+    cubes[1]->SetCastShadow(false);
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 3u);
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::ShadowDepth), 4u);
+
+    cubes[2]->SetVisible(false);
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 4u);
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::BasePass), 5u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Instanced Draw Tests
+// ============================================
+
+TEST_F(NullRHITest, InstancedDraw_InstanceStreamFilteredAndReplayed)
+{
+    std::unique_ptr<FRHIPipelineState> pso(RHI->CreateGraphicsPipelineStateEx(
+        EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting | EPipelineFlags::Instanced));
+    std::unique_ptr<FRHIBuffer> vertices(RHI->CreateVertexBuffer(1024, nullptr));
+    std::unique_ptr<FRHIBuffer> indices(RHI->CreateIndexBuffer(256, nullptr));
+    std::unique_ptr<FRHIBuffer> instances(RHI->CreateVertexBuffer(8 * sizeof(FMatrix4x4), nullptr));
+
+    FRHICommandRecorder recorder;
+    FRHIStateCache cache(&recorder);
+    cache.BeginFrame();
+    for (uint32 draw = 0; draw < 2; ++draw)
+    {
+        cache.SetPipelineState(pso.get());
+        cache.SetVertexBuffer(vertices.get(), 0, sizeof(FLitVertex));
+        cache.SetInstanceBuffer(instances.get(), 0, sizeof(FMatrix4x4));
+        cache.SetIndexBuffer(indices.get());
+        cache.DrawIndexedInstanced(36, 4, 0, 0);
+    }
+
+    // A different window into the same instance buffer is a new binding
+    cache.SetInstanceBuffer(instances.get(), 4 * sizeof(FMatrix4x4), sizeof(FMatrix4x4));
+    cache.DrawIndexedInstanced(36, 2, 0, 0);
+    cache.EndFrame();
+    EXPECT_EQ(cache.GetCurrentFrameStats().Issued.VertexBuffers, 3u);
+    EXPECT_EQ(cache.GetCurrentFrameStats().Filtered.VertexBuffers, 2u);
+
+    recorder.Replay(CmdList);
+    const FNullCommandStats& stats = CmdList->GetStats();
+    EXPECT_EQ(stats.GetCount(ENullCommand::SetInstanceBuffer), 2u);
+    EXPECT_EQ(stats.GetCount(ENullCommand::DrawIndexedInstanced), 3u);
+    EXPECT_EQ(stats.DrawCalls, 3u);
+    EXPECT_EQ(stats.InstancesDrawn, 10u);
+    EXPECT_EQ(stats.IndicesDrawn, 36u * 10u);
+
+    const FNullBoundState& bound = CmdList->GetBoundState();
+    EXPECT_EQ(bound.InstanceBuffer, instances.get());
+    EXPECT_EQ(bound.InstanceOffset, 4u * sizeof(FMatrix4x4));
+    EXPECT_EQ(bound.InstanceStride, static_cast<uint32>(sizeof(FMatrix4x4)));
+}
+
+TEST_F(NullRHITest, InstancedDraw_SceneBatchesIdenticalPrimitives)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetFrustumCulling(false);  // The row of cubes reaches out of view
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FDirectionalLight* sun = new FDirectionalLight();
+    sun->SetDirection(FVector(0.5f, -0.8f, 0.3f));
+    scene.GetLightScene()->AddLight(sun);
+    std::vector<FCubePrimitive*> cubes;
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        cubes.push_back(new FCubePrimitive());
+        cubes.back()->SetPosition(FVector(static_cast<float>(i) * 2.0f, 0.0f, 0.0f));
+        scene.AddPrimitive(cubes.back());
+    }
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        scene.AddPrimitive(new FUnlitCubePrimitive());
+    }
+    scene.AddPrimitive(new FSpherePrimitive());
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // Lit cubes and unlit cubes each become one instanced draw; the lone sphere draws on its own
+    const FRenderScene* renderScene = renderer.GetRenderScene();
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::BasePass), 3u);
+    EXPECT_EQ(renderScene->GetNumInstancedDraws(EMeshPass::BasePass), 2u);
+    EXPECT_EQ(renderScene->GetNumInstances(EMeshPass::BasePass), 12u);
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::ShadowDepth), 2u);
+    EXPECT_EQ(renderScene->GetNumInstancedDraws(EMeshPass::ShadowDepth), 1u);
+    EXPECT_EQ(renderScene->GetNumInstances(EMeshPass::ShadowDepth), 8u);
+
+    const FNullCommandStats& cmdStats = CmdList->GetStats();
+    EXPECT_EQ(cmdStats.GetCount(ENullCommand::DrawIndexedInstanced), 3u);
+    EXPECT_EQ(cmdStats.InstancesDrawn, 12u + 8u);
+    EXPECT_EQ(cmdStats.GetCount(ENullCommand::DrawIndexedPrimitive), 2u);
+
+    // Moving an instance only rewrites the instance data
+    cubes[3]->SetPosition(FVector(0.0f, 5.0f, 0.0f));
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 1u);
+    EXPECT_EQ(cmdStats.InstancesDrawn, 12u + 8u);
+
+    // A different material splits the cube off the base pass batch; depth-only shadows
+    // ignore materials, so it stays in the shadow batch
+    FMaterial material;
+    material.DiffuseColor = FColor(1.0f, 0.0f, 0.0f, 1.0f);
+    cubes[0]->SetMaterial(material);
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 2u);
+    EXPECT_EQ(renderScene->GetNumCachedMeshDrawCommands(EMeshPass::BasePass), 4u);
+    EXPECT_EQ(renderScene->GetNumInstances(EMeshPass::BasePass), 11u);
+    EXPECT_EQ(renderScene->GetNumInstances(EMeshPass::ShadowDepth), 8u);
+
+    // Turned off, every primitive draws on its own again
+    renderer.SetInstancedDraws(false);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumInstancedDraws(EMeshPass::BasePass), 0u);
+    EXPECT_EQ(cmdStats.GetCount(ENullCommand::DrawIndexedInstanced), 0u);
+    EXPECT_EQ(cmdStats.GetCount(ENullCommand::DrawIndexedPrimitive), 13u + 9u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Transient Constant Tests
+// ============================================
+
+TEST_F(NullRHITest, TransientConstants_AlignedSlicesOfMappedPages)
+{
+    RHI->BeginTransientFrame();
+    float mvp[16] = { 1.0f, 2.0f, 3.0f };
+    FRHITransientAllocation first = RHI->UploadTransientConstants(mvp, sizeof(mvp));
+    FRHITransientAllocation second = RHI->AllocateTransientConstants(384);
+    FRHITransientAllocation third = RHI->AllocateTransientConstants(80);
+
+    // Back to back in one page, each slice starting on a 256-byte boundary
+    const FNullBuffer* page = static_cast<FNullBuffer*>(first.Buffer);
+    ASSERT_NE(page, nullptr);
+    EXPECT_EQ(second.Buffer, first.Buffer);
+    EXPECT_EQ(third.Buffer, first.Buffer);
+    EXPECT_EQ(first.Offset, 0u);
+    EXPECT_EQ(second.Offset, 256u);
+    EXPECT_EQ(third.Offset, 768u);
+
+    // The page stays mapped and CPUAddress points into it
+    EXPECT_TRUE(page->IsMapped());
+    EXPECT_EQ(static_cast<const uint8*>(third.CPUAddress), page->GetData() + third.Offset);
+    float uploaded[3] = {};
+    memcpy(uploaded, page->GetData() + first.Offset, sizeof(uploaded));
+    EXPECT_FLOAT_EQ(uploaded[2], 3.0f);
+
+    // Larger than a page: gets a page of its own
+    FRHITransientAllocation large = RHI->AllocateTransientConstants(FTransientConstantRing::DefaultPageSize + 1);
+    EXPECT_NE(large.Buffer, first.Buffer);
+    EXPECT_EQ(large.Offset, 0u);
+    EXPECT_EQ(RHI->GetTransientConstantStats().NumPages, 2u);
+
+    RHI->BeginTransientFrame();
+    FRHITransientConstantStats stats = RHI->GetTransientConstantStats();
+    EXPECT_EQ(stats.LastFrameAllocations, 4u);
+    EXPECT_EQ(stats.LastFrameBytes, 1024u + FTransientConstantRing::DefaultPageSize + 256u);
+}
+
+TEST_F(NullRHITest, TransientConstants_OffsetRecordedAndReplayed)
+{
+    RHI->BeginTransientFrame();
+    RHI->AllocateTransientConstants(64);
+    FRHITransientAllocation constants = RHI->AllocateTransientConstants(64);
+    ASSERT_EQ(constants.Offset, 256u);
+
+    CmdList->BeginFrame();
+    CmdList->SetConstantBuffer(constants.Buffer, 1, constants.Offset);
+    std::vector<uint8> directStream = CmdList->GetCommandStream();
+    EXPECT_EQ(CmdList->GetBoundState().ConstantBuffers[1], constants.Buffer);
+    EXPECT_EQ(CmdList->GetBoundState().ConstantBufferOffsets[1], 256u);
+
+    FRHICommandRecorder recorder;
+    recorder.BeginFrame();
+    recorder.SetConstantBuffer(constants.Buffer, 1, constants.Offset);
+    recorder.Replay(CmdList);
+    EXPECT_EQ(CmdList->GetCommandStream(), directStream);
+    EXPECT_EQ(CmdList->GetBoundState().ConstantBufferOffsets[1], 256u);
+}
+
+TEST_F(NullRHITest, TransientConstants_SteadyStateReusesPages)
+{
+    // 1000 draws with 3 slices each spill over several pages per frame
+    auto RunFrame = [this]()
+    {
+        RHI->BeginTransientFrame();
+        CmdList->BeginFrame();
+        for (uint32 i = 0; i < 3000; ++i)
+        {
+            RHI->AllocateTransientConstants(sizeof(float) * 16);
+        }
+        CmdList->EndFrame();
+        CmdList->Present();
+    };
+
+    for (uint32 frame = 0; frame < 4; ++frame)
+    {
+        RunFrame();
+    }
+    uint32 warmPages = RHI->GetTransientConstantStats().NumPages;
+    EXPECT_GT(warmPages, 1u);
+
+    for (uint32 frame = 0; frame < 50; ++frame)
+    {
+        RunFrame();
+    }
+    RHI->BeginTransientFrame();
+    FRHITransientConstantStats stats = RHI->GetTransientConstantStats();
+    EXPECT_EQ(stats.NumPages, warmPages);
+    EXPECT_EQ(stats.LastFrameAllocations, 3000u);
+    EXPECT_EQ(stats.LastFrameBytes, 3000ull * 256);
+
+    // Every frame completed before the next began, so one segment was enough
+    EXPECT_EQ(stats.NumSegments, 1u);
+}
+
+TEST_F(NullRHITest, TransientConstants_SegmentPerFrameInFlight)
+{
+    // Three frames begun and none presented: each needs memory of its own
+    std::set<FRHIBuffer*> pages;
+    for (uint32 frame = 0; frame < 3; ++frame)
+    {
+        RHI->BeginTransientFrame();
+        pages.insert(RHI->AllocateTransientConstants(64).Buffer);
+    }
+    EXPECT_EQ(pages.size(), 3u);
+    EXPECT_EQ(RHI->GetTransientConstantStats().NumSegments, 3u);
+
+    // Once they complete, the oldest segment is rewound instead of adding one
+    for (uint32 frame = 0; frame < 3; ++frame)
+    {
+        CmdList->Present();
+    }
+    RHI->BeginTransientFrame();
+    FRHITransientAllocation reused = RHI->AllocateTransientConstants(64);
+    EXPECT_EQ(reused.Offset, 0u);
+    EXPECT_EQ(pages.count(reused.Buffer), 1u);
+
+    FRHITransientConstantStats stats = RHI->GetTransientConstantStats();
+    EXPECT_EQ(stats.NumSegments, 3u);
+    EXPECT_EQ(stats.NumPages, 3u);
+}
+
+TEST_F(NullRHITest, TransientConstants_SceneProxiesOwnNoConstantBuffers)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);  // One draw per proxy
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        scene.AddPrimitive(new FCubePrimitive());
+        scene.AddPrimitive(new FUnlitCubePrimitive());
+    }
+
+    // No per-proxy buffers at all: geometry lands in one vertex page per stride and one
+    // index page (PSOs are precached)
+    FNullRHI* nullRHI = static_cast<FNullRHI*>(RHI.get());
+    uint32 resourcesBefore = nullRHI->GetCreatedResourceCount();
+    renderer.UpdateFromScene(&scene);
+    EXPECT_EQ(nullRHI->GetCreatedResourceCount() - resourcesBefore, 3u);
+
+    // Every draw takes one per-draw slice, plus the view slice shared by the lit draws
+    renderer.RenderFrame();
+    renderer.RenderFrame();
+    FRHITransientConstantStats stats = RHI->GetTransientConstantStats();
+    EXPECT_GE(stats.LastFrameAllocations, 8u + 8u + 1u);
+    EXPECT_EQ(stats.LastFrameBytes % FTransientConstantRing::Alignment, 0u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Deferred Release Tests
+// ============================================
+
+TEST_F(NullRHITest, DeferredRelease_HeldUntilFramePresented)
+{
+    RHI->BeginTransientFrame();
+    bool bReleased = false;
+    RHI->DeferredRelease(RHI->CreateVertexBuffer(1024, nullptr), 1024);
+    RHI->DeferredRelease([&bReleased]() { bReleased = true; }, 256);
+
+    FRHIDeferredReleaseStats stats = RHI->GetDeferredReleaseStats();
+    EXPECT_EQ(stats.PendingObjects, 2u);
+    EXPECT_EQ(stats.PendingBytes, 1280u);
+
+    // The frame they were released in has not been presented yet
+    RHI->BeginTransientFrame();
+    EXPECT_FALSE(bReleased);
+    stats = RHI->GetDeferredReleaseStats();
+    EXPECT_EQ(stats.PendingObjects, 2u);
+    EXPECT_EQ(stats.FramesInFlight, 2u);
+
+    // Releases from the next frame wait for that frame
+    RHI->DeferredRelease(RHI->CreateConstantBuffer(256), 256);
+
+    CmdList->Present();
+    RHI->BeginTransientFrame();
+    EXPECT_TRUE(bReleased);
+    stats = RHI->GetDeferredReleaseStats();
+    EXPECT_EQ(stats.PendingObjects, 1u);
+    EXPECT_EQ(stats.PendingBytes, 256u);
+    EXPECT_EQ(stats.ReleasedObjects, 2u);
+    EXPECT_EQ(stats.ReleasedBytes, 1280u);
+
+    RHI->FlushDeferredReleases();
+    stats = RHI->GetDeferredReleaseStats();
+    EXPECT_EQ(stats.PendingObjects, 0u);
+    EXPECT_EQ(stats.PendingBytes, 0u);
+    EXPECT_EQ(stats.ReleasedObjects, 3u);
+}
+
+TEST_F(NullRHITest, DeferredRelease_GeometryRangeReusedAfterFrameCompletes)
+{
+    FGeometryBufferAllocator::Initialize(RHI.get());
+    RHI->BeginTransientFrame();
+
+    uint32 indices[3] = { 0, 1, 2 };
+    FGeometryAllocation* first = FGeometryBufferAllocator::AllocateIndices(RHI.get(), indices, 3);
+    FGeometryBufferAllocator::FreeGeometry(first);
+
+    // The range stays allocated while the frame may still draw from it
+    FGeometryAllocation* second = FGeometryBufferAllocator::AllocateIndices(RHI.get(), indices, 3);
+    EXPECT_EQ(second->First, 3u);
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, 2u);
+    EXPECT_EQ(RHI->GetDeferredReleaseStats().PendingBytes, sizeof(indices));
+
+    CmdList->Present();
+    RHI->BeginTransientFrame();
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, 1u);
+    FGeometryAllocation* third = FGeometryBufferAllocator::AllocateIndices(RHI.get(), indices, 3);
+    EXPECT_EQ(third->First, 0u);
+
+    FGeometryBufferAllocator::FreeGeometry(second);
+    FGeometryBufferAllocator::FreeGeometry(third);
+
+    // Shutdown lands the pending frees before destroying the pages
+    FGeometryBufferAllocator::Shutdown();
+    EXPECT_EQ(RHI->GetDeferredReleaseStats().PendingObjects, 0u);
+}
+
+TEST_F(NullRHITest, DeferredRelease_RemovedProxyResourcesOutliveTheFrame)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetPrecachePipelineStates(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FCubePrimitive* cube = new FCubePrimitive();
+    scene.AddPrimitive(cube);
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    uint32 liveRanges = FGeometryBufferAllocator::Get()->GetStats().NumAllocations;
+    scene.RemovePrimitive(cube);
+    delete cube;
+
+    // Run frames until the render scene lets go of the cube's proxy
+    for (uint32 frame = 0; frame < 4 && scene.GetNumRetiredProxies() > 0; ++frame)
+    {
+        renderer.RenderFrame();
+        renderer.UpdateFromScene(&scene);
+    }
+    ASSERT_EQ(scene.GetNumRetiredProxies(), 0u);
+
+    // The proxy is gone but the last frame that drew it may still be on the GPU: its vertex
+    // and index ranges wait, and so do its PSOs, which nothing else references (the lit
+    // PSO and the base and shadow pass instanced variants)
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, liveRanges);
+    FRHIDeferredReleaseStats stats = RHI->GetDeferredReleaseStats();
+    EXPECT_EQ(stats.PendingObjects, 5u);
+    EXPECT_GT(stats.PendingBytes, 0u);
+
+    // That frame was presented, so the next one returns the ranges
+    renderer.RenderFrame();
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, liveRanges - 2);
+    EXPECT_EQ(RHI->GetDeferredReleaseStats().PendingObjects, 0u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Geometry Buffer Tests
+// ============================================
+
+TEST_F(NullRHITest, GeometryBuffer_RangesShareOnePagePerStride)
+{
+    FGeometryBufferAllocator allocator(RHI.get(), 64 * 1024);
+
+    float first[6] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+    float second[3] = { 7.0f, 8.0f, 9.0f };
+    uint32 indices[3] = { 0, 1, 2 };
+    FGeometryAllocation* a = allocator.Allocate(EGeometryBufferType::Vertex, first, 2, 3 * sizeof(float));
+    FGeometryAllocation* b = allocator.Allocate(EGeometryBufferType::Vertex, second, 1, 3 * sizeof(float));
+    FGeometryAllocation* c = allocator.Allocate(EGeometryBufferType::Vertex, first, 1, 6 * sizeof(float));
+    FGeometryAllocation* ib = allocator.Allocate(EGeometryBufferType::Index, indices, 3, sizeof(uint32));
+
+    // Same stride shares a buffer, ranges counted in vertices
+    EXPECT_EQ(a->Buffer, b->Buffer);
+    EXPECT_EQ(a->First, 0u);
+    EXPECT_EQ(b->First, 2u);
+    EXPECT_NE(c->Buffer, a->Buffer);
+    EXPECT_NE(ib->Buffer, a->Buffer);
+    EXPECT_EQ(static_cast<FNullBuffer*>(ib->Buffer)->GetBufferType(), FNullBuffer::EBufferType::Index);
+
+    // Data lands at First * Stride in the shared buffer
+    const FNullBuffer* page = static_cast<FNullBuffer*>(b->Buffer);
+    float uploaded[3] = {};
+    memcpy(uploaded, page->GetData() + b->First * b->Stride, sizeof(uploaded));
+    EXPECT_FLOAT_EQ(uploaded[0], 7.0f);
+    EXPECT_FLOAT_EQ(uploaded[2], 9.0f);
+
+    FGeometryBufferStats stats = allocator.GetStats();
+    EXPECT_EQ(stats.NumPages, 3u);
+    EXPECT_EQ(stats.NumAllocations, 4u);
+    EXPECT_EQ(stats.UsedBytes, 3u * 12u + 24u + 12u);
+
+    // A freed range is reused
+    allocator.Free(b);
+    FGeometryAllocation* d = allocator.Allocate(EGeometryBufferType::Vertex, second, 1, 3 * sizeof(float));
+    EXPECT_EQ(d->Buffer, a->Buffer);
+    EXPECT_EQ(d->First, 2u);
+
+    allocator.Free(a);
+    allocator.Free(c);
+    allocator.Free(d);
+    allocator.Free(ib);
+    EXPECT_EQ(allocator.GetStats().NumAllocations, 0u);
+}
+
+TEST_F(NullRHITest, GeometryBuffer_OversizedMeshGetsPageReleasedOnFree)
+{
+    FGeometryBufferAllocator allocator(RHI.get(), 1024);
+
+    FGeometryAllocation* small = allocator.Allocate(EGeometryBufferType::Index, nullptr, 16, sizeof(uint32));
+    FGeometryAllocation* large = allocator.Allocate(EGeometryBufferType::Index, nullptr, 1000, sizeof(uint32));
+    EXPECT_NE(large->Buffer, small->Buffer);
+    EXPECT_EQ(large->First, 0u);
+    EXPECT_EQ(allocator.GetStats().NumPages, 2u);
+
+    allocator.Free(large);
+    EXPECT_EQ(allocator.GetStats().NumPages, 1u);
+    allocator.Free(small);
+
+    // Regular pages are kept for the next mesh
+    EXPECT_EQ(allocator.GetStats().NumPages, 1u);
+}
+
+TEST_F(NullRHITest, GeometryBuffer_DefragmentPacksPagesAndKeepsData)
+{
+    // 16 vertices of 4 bytes per page
+    FGeometryBufferAllocator allocator(RHI.get(), 64);
+
+    std::vector<FGeometryAllocation*> ranges;
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        uint32 values[4] = { i, i, i, i };
+        ranges.push_back(allocator.Allocate(EGeometryBufferType::Vertex, values, 4, sizeof(uint32)));
+    }
+    ASSERT_EQ(allocator.GetStats().NumPages, 4u);
+
+    // Keep every other range: each page is left half full with holes
+    for (uint32 i = 0; i < 16; i += 2)
+    {
+        allocator.Free(ranges[i]);
+        ranges[i] = nullptr;
+    }
+
+    FGeometryDefragmentStats defragStats = allocator.Defragment();
+    EXPECT_EQ(defragStats.ReleasedPages, 2u);
+    EXPECT_GT(defragStats.MovedAllocations, 0u);
+
+    FGeometryBufferStats stats = allocator.GetStats();
+    EXPECT_EQ(stats.NumPages, 2u);
+    EXPECT_EQ(stats.NumAllocations, 8u);
+    EXPECT_EQ(stats.UsedBytes, stats.ReservedBytes);
+
+    // Every surviving range still reads back its own data at its (possibly new) location
+    for (uint32 i = 1; i < 16; i += 2)
+    {
+        const FNullBuffer* page = static_cast<FNullBuffer*>(ranges[i]->Buffer);
+        uint32 values[4] = {};
+        memcpy(values, page->GetData() + ranges[i]->First * sizeof(uint32), sizeof(values));
+        EXPECT_EQ(values[0], i);
+        EXPECT_EQ(values[3], i);
+        allocator.Free(ranges[i]);
+    }
+}
+
+TEST_F(NullRHITest, GeometryBuffer_DedicatedBufferWithoutAllocator)
+{
+    ASSERT_EQ(FGeometryBufferAllocator::Get(), nullptr);
+
+    uint32 indices[6] = { 0, 1, 2, 2, 1, 3 };
+    FGeometryAllocation* allocation = FGeometryBufferAllocator::AllocateIndices(RHI.get(), indices, 6);
+    ASSERT_NE(allocation, nullptr);
+    EXPECT_TRUE(allocation->bDedicated);
+    EXPECT_EQ(allocation->First, 0u);
+    EXPECT_EQ(static_cast<FNullBuffer*>(allocation->Buffer)->GetSize(), sizeof(indices));
+    FGeometryBufferAllocator::FreeGeometry(allocation);
+}
+
+TEST_F(NullRHITest, GeometryBuffer_ProxiesDrawWithBaseVertexAndStartIndex)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetPrecachePipelineStates(false);
+    renderer.SetInstancedDraws(false);  // One draw per proxy
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    const FColor colors[3] = { FColor(1.0f, 0.0f, 0.0f), FColor(0.0f, 1.0f, 0.0f), FColor(0.0f, 0.0f, 1.0f) };
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        FUnlitCubePrimitive* cube = new FUnlitCubePrimitive();
+        cube->SetColor(colors[i]);
+        scene.AddPrimitive(cube);
+    }
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // The cubes (24 vertices, 36 indices each) differ in their baked vertex color, so each
+    // has its own mesh: one vertex and one index buffer, each cube drawing its own range
+    std::set<uint32> startIndices;
+    std::set<uint32> baseVertices;
+    CmdList->ForEachCommand([&](ENullCommand Command, const uint8* Payload, uint32 PayloadSize)
+    {
+        if (Command == ENullCommand::DrawIndexedPrimitive)
+        {
+            ASSERT_EQ(PayloadSize, 3u * sizeof(uint32));
+            uint32 values[3] = {};
+            memcpy(values, Payload, sizeof(values));
+            startIndices.insert(values[1]);
+            baseVertices.insert(values[2]);
+        }
+    });
+    EXPECT_EQ(startIndices, (std::set<uint32>{ 0u, 36u, 72u }));
+    EXPECT_EQ(baseVertices, (std::set<uint32>{ 0u, 24u, 48u }));
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumPages, 2u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    EXPECT_EQ(FGeometryBufferAllocator::Get(), nullptr);
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+TEST_F(NullRHITest, GeometryBuffer_DefragmentRebuildsCachedDraws)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetPrecachePipelineStates(false);
+    renderer.SetInstancedDraws(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    const FColor colors[3] = { FColor(1.0f, 0.0f, 0.0f), FColor(0.0f, 1.0f, 0.0f), FColor(0.0f, 0.0f, 1.0f) };
+    FUnlitCubePrimitive* cubes[3] = {};
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        cubes[i] = new FUnlitCubePrimitive();
+        cubes[i]->SetColor(colors[i]);
+        scene.AddPrimitive(cubes[i]);
+    }
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // Drop the first two meshes, leaving the last one behind a hole
+    scene.RemovePrimitive(cubes[0]);
+    scene.RemovePrimitive(cubes[1]);
+    delete cubes[0];
+    delete cubes[1];
+    for (uint32 frame = 0; frame < 3; ++frame)  // Until the retired proxies free their meshes
+    {
+        renderer.UpdateFromScene(&scene);
+        renderer.RenderFrame();
+    }
+    const FRenderScene* renderScene = renderer.GetRenderScene();
+    uint32 builds = renderScene->GetNumCachedDrawListBuilds();
+
+    // Defragment moves the survivor to the front of its pages; the cached draw must follow
+    FGeometryDefragmentStats defragStats = FGeometryBufferAllocator::Get()->Defragment();
+    ASSERT_GT(defragStats.MovedAllocations, 0u);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), builds + 1);
+
+    std::vector<uint32> draws;
+    CmdList->ForEachCommand([&](ENullCommand Command, const uint8* Payload, uint32 PayloadSize)
+    {
+        if (Command == ENullCommand::DrawIndexedPrimitive)
+        {
+            ASSERT_EQ(PayloadSize, 3u * sizeof(uint32));
+            uint32 values[3] = {};
+            memcpy(values, Payload, sizeof(values));
+            draws.push_back(values[1]);
+            draws.push_back(values[2]);
+        }
+    });
+    EXPECT_EQ(draws, (std::vector<uint32>{ 0u, 0u }));
+
+    // Nothing moved: the lists stay cached
+    FGeometryBufferAllocator::Get()->Defragment();
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), builds + 1);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Pipeline State Cache Tests
+// ============================================
+
+TEST_F(NullRHITest, PipelineStateCache_SharesOnePSOPerKey)
+{
+    FPipelineStateCache cache(RHI.get());
+    EPipelineFlags litFlags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
+
+    FRHIPipelineState* first = cache.Acquire(litFlags);
+    FRHIPipelineState* second = cache.Acquire(litFlags);
+    FRHIPipelineState* shadow = cache.Acquire(EPipelineFlags::DepthOnly);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, shadow);
+    EXPECT_EQ(static_cast<FNullPipelineState*>(first)->GetFlags(), litFlags);
+
+    FPipelineStateCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.Hits, 1u);
+    EXPECT_EQ(stats.Misses, 2u);
+    EXPECT_EQ(stats.LivePipelineStates, 2u);
+    EXPECT_EQ(stats.References, 3u);
+
+    // The PSO survives until its last reference is released
+    EXPECT_TRUE(cache.Release(first));
+    EXPECT_EQ(cache.GetNumLivePipelineStates(), 2u);
+    EXPECT_TRUE(cache.Release(second));
+    EXPECT_TRUE(cache.Release(shadow));
+    EXPECT_EQ(cache.GetNumLivePipelineStates(), 0u);
+    EXPECT_EQ(cache.GetStats().References, 0u);
+
+    // Acquiring again after the PSO was destroyed is a miss
+    FRHIPipelineState* recreated = cache.Acquire(litFlags);
+    EXPECT_EQ(cache.GetStats().Misses, 3u);
+    cache.Release(recreated);
+}
+
+TEST_F(NullRHITest, PipelineStateCache_KeyIncludesVertexLayout)
+{
+    EXPECT_EQ(GetVertexLayoutForFlags(EPipelineFlags::EnableDepth), EVertexLayout::Color);
+    EXPECT_EQ(GetVertexLayoutForFlags(EPipelineFlags::DepthOnly), EVertexLayout::Lit);
+    EXPECT_EQ(GetVertexLayoutForFlags(EPipelineFlags::EnableLighting | EPipelineFlags::EnableTextures),
+              EVertexLayout::Textured);
+
+    FPipelineStateKey key(EPipelineFlags::EnableDepth);
+    FPipelineStateKey otherLayout = key;
+    otherLayout.VertexLayout = EVertexLayout::Lit;
+    EXPECT_FALSE(key == otherLayout);
+
+    FPipelineStateCache cache(RHI.get());
+    FRHIPipelineState* color = cache.Acquire(key);
+    FRHIPipelineState* lit = cache.Acquire(otherLayout);
+    EXPECT_NE(color, lit);
+    EXPECT_EQ(cache.GetNumLivePipelineStates(), 2u);
+    cache.Release(color);
+    cache.Release(lit);
+}
+
+TEST_F(NullRHITest, PipelineStateCache_ReleaseIgnoresForeignPSO)
+{
+    FPipelineStateCache cache(RHI.get());
+    std::unique_ptr<FRHIPipelineState> foreign(RHI->CreateGraphicsPipelineStateEx(EPipelineFlags::EnableDepth));
+    EXPECT_FALSE(cache.Release(foreign.get()));
+    EXPECT_EQ(cache.GetNumLivePipelineStates(), 0u);
+}
+
+TEST_F(NullRHITest, PipelineStateCache_PrecacheBuildsEveryValidKey)
+{
+    std::vector<FPipelineStateKey> keys = FPipelineStateCache::GetAllPipelineStateKeys();
+    EXPECT_EQ(keys.size(), 30u);
+
+    bool bHasLayout[3] = { false, false, false };
+    for (const FPipelineStateKey& key : keys)
+    {
+        EXPECT_TRUE(IsValidPipelineFlags(key.Flags));
+        bHasLayout[static_cast<uint32>(key.VertexLayout)] = true;
+    }
+    EXPECT_TRUE(bHasLayout[0] && bHasLayout[1] && bHasLayout[2]);
+    EXPECT_FALSE(IsValidPipelineFlags(EPipelineFlags::DepthOnly | EPipelineFlags::EnableDepth));
+    EXPECT_FALSE(IsValidPipelineFlags(EPipelineFlags::EnableDepth | EPipelineFlags::EnableTextures));
+    EXPECT_TRUE(IsValidPipelineFlags(EPipelineFlags::DepthOnly | EPipelineFlags::Instanced));
+    EXPECT_FALSE(IsValidPipelineFlags(EPipelineFlags::Instanced));
+    EXPECT_FALSE(IsValidPipelineFlags(EPipelineFlags::EnableDepth | EPipelineFlags::EnableTextures | EPipelineFlags::Instanced));
+
+    FPipelineStateCache cache(RHI.get());
+    cache.Precache(keys);
+    cache.WaitForPrecache();
+    EXPECT_TRUE(cache.IsPrecacheComplete());
+    EXPECT_EQ(cache.GetNumLivePipelineStates(), 30u);
+
+    // Precached PSOs are hits and stay alive after their users release them
+    FRHIPipelineState* pso = cache.Acquire(EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting);
+    ASSERT_NE(pso, nullptr);
+    cache.Release(pso);
+    FPipelineStateCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.Misses, 0u);
+    EXPECT_EQ(stats.Hits, 1u);
+    EXPECT_EQ(stats.Precached, 30u);
+    EXPECT_EQ(stats.LivePipelineStates, 30u);
+}
+
+TEST_F(NullRHITest, PipelineStateCache_AcquireDuringPrecacheBuildsOnce)
+{
+    FNullRHI* nullRHI = static_cast<FNullRHI*>(RHI.get());
+    nullRHI->SetPipelineStateCreateDelayMs(30);
+
+    FPipelineStateCache cache(RHI.get());
+    EPipelineFlags litFlags = EPipelineFlags::EnableDepth | EPipelineFlags::EnableLighting;
+    uint32 createdBefore = nullRHI->GetCreatedResourceCount();
+    cache.Precache({ FPipelineStateKey(litFlags) });
+
+    // Both callers arrive while the PSO is queued or mid-build
+    FRHIPipelineState* results[2] = { nullptr, nullptr };
+    std::thread other([&]() { results[1] = cache.Acquire(litFlags); });
+    results[0] = cache.Acquire(litFlags);
+    other.join();
+    cache.WaitForPrecache();
+
+    ASSERT_NE(results[0], nullptr);
+    EXPECT_EQ(results[0], results[1]);
+    EXPECT_EQ(nullRHI->GetCreatedResourceCount() - createdBefore, 1u);
+    FPipelineStateCacheStats stats = cache.GetStats();
+    EXPECT_EQ(stats.Misses, 0u);
+    EXPECT_GE(stats.Waits, 1u);
+    EXPECT_EQ(stats.References, 3u);
+
+    cache.Release(results[0]);
+    cache.Release(results[1]);
+    nullRHI->SetPipelineStateCreateDelayMs(0);
+}
+
+TEST_F(NullRHITest, PipelineStateCache_SceneProxiesSharePSOs)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetPrecachePipelineStates(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    // The three shadow passes share one depth-only PSO
+    FPipelineStateCache* cache = FPipelineStateCache::Get();
+    ASSERT_NE(cache, nullptr);
+    EXPECT_EQ(cache->GetNumLivePipelineStates(), 1u);
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        scene.AddPrimitive(new FCubePrimitive());
+        scene.AddPrimitive(new FSpherePrimitive());
+    }
+    renderer.UpdateFromScene(&scene);
+
+    // 32 lit proxies, one lit PSO
+    EXPECT_EQ(cache->GetNumLivePipelineStates(), 2u);
+    EXPECT_EQ(cache->GetStats().Misses, 2u);
+
+    scene.Shutdown();
+    EXPECT_EQ(cache->GetNumLivePipelineStates(), 1u);
+
+    renderer.Shutdown();
+    EXPECT_EQ(FPipelineStateCache::Get(), nullptr);
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+TEST_F(NullRHITest, PipelineStateCache_RendererPrecachesOnInitialize)
+{
+    FRenderer renderer(RHI.get());
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    FPipelineStateCache* cache = FPipelineStateCache::Get();
+    ASSERT_NE(cache, nullptr);
+    cache->WaitForPrecache();
+    uint32 numKeys = static_cast<uint32>(FPipelineStateCache::GetAllPipelineStateKeys().size());
+    EXPECT_EQ(cache->GetNumLivePipelineStates(), numKeys);
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    scene.AddPrimitive(new FCubePrimitive());
+    scene.AddPrimitive(new FUnlitCubePrimitive());
+    renderer.UpdateFromScene(&scene);
+
+    // Every proxy found its PSO already built
+    EXPECT_EQ(cache->GetStats().Misses, 0u);
+    EXPECT_EQ(cache->GetNumLivePipelineStates(), numKeys);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Mesh Registry Tests
+// ============================================
+
+static void BuildTestTriangle(FMeshBuildData& OutMesh)
+{
+    std::vector<FVertex> vertices = {
+        { FVector(0.0f, 0.0f, 0.0f), FColor() },
+        { FVector(1.0f, 0.0f, 0.0f), FColor() },
+        { FVector(0.0f, 1.0f, 0.0f), FColor() },
+    };
+    OutMesh.SetVertices(vertices);
+    OutMesh.Indices = { 0, 1, 2 };
+}
+
+TEST_F(NullRHITest, MeshRegistry_EqualKeysShareOneMesh)
+{
+    FGeometryBufferAllocator::Initialize(RHI.get());
+    FMeshRegistry registry(RHI.get());
+
+    uint32 numBuilds = 0;
+    FMeshBuildFunction build = [&numBuilds](FMeshBuildData& OutMesh)
+    {
+        ++numBuilds;
+        BuildTestTriangle(OutMesh);
+    };
+
+    FSharedMesh* first = registry.Acquire(FMeshKey(EMeshGenerator::LitSphere, 24, 16), build);
+    FSharedMesh* second = registry.Acquire(FMeshKey(EMeshGenerator::LitSphere, 24, 16), build);
+    FSharedMesh* rings = registry.Acquire(FMeshKey(EMeshGenerator::LitSphere, 24, 8), build);
+    FSharedMesh* color = registry.Acquire(FMeshKey(EMeshGenerator::LitSphere, 24, 16, 1), build);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, rings);
+    EXPECT_NE(first, color);
+    EXPECT_NE(first->Hash, rings->Hash);
+    EXPECT_EQ(numBuilds, 3u);
+    EXPECT_EQ(first->GetNumVertices(), 3u);
+    EXPECT_EQ(first->GetNumIndices(), 3u);
+
+    FMeshRegistryStats stats = registry.GetStats();
+    EXPECT_EQ(stats.Hits, 1u);
+    EXPECT_EQ(stats.Misses, 3u);
+    EXPECT_EQ(stats.LiveMeshes, 3u);
+    EXPECT_EQ(stats.References, 4u);
+    EXPECT_EQ(stats.ReferencedBytes, stats.LiveBytes + first->GetSizeBytes());
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, 6u);
+
+    EXPECT_TRUE(registry.Release(first));
+    EXPECT_TRUE(registry.Release(rings));
+    EXPECT_TRUE(registry.Release(color));
+    EXPECT_EQ(registry.GetNumLiveMeshes(), 1u);
+    EXPECT_TRUE(registry.Release(second));
+    EXPECT_EQ(registry.GetNumLiveMeshes(), 0u);
+    EXPECT_EQ(registry.GetStats().LiveBytes, 0u);
+
+    FGeometryBufferAllocator::Shutdown();
+}
+
+TEST_F(NullRHITest, MeshRegistry_LastReleaseFreesGeometryAfterTheFrame)
+{
+    FGeometryBufferAllocator::Initialize(RHI.get());
+    FMeshRegistry registry(RHI.get());
+    RHI->BeginTransientFrame();
+
+    FMeshKey key(EMeshGenerator::Imported, 3, 3, 42);
+    FSharedMesh* first = registry.Acquire(key, BuildTestTriangle);
+    FSharedMesh* second = registry.Acquire(key, BuildTestTriangle);
+    registry.Release(first);
+    EXPECT_EQ(RHI->GetDeferredReleaseStats().PendingObjects, 0u);
+
+    // The last reference frees both ranges, once the frame that may draw them completes
+    registry.Release(second);
+    EXPECT_EQ(RHI->GetDeferredReleaseStats().PendingObjects, 2u);
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, 2u);
+    CmdList->Present();
+    RHI->BeginTransientFrame();
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, 0u);
+
+    // A build without geometry gives no mesh
+    EXPECT_EQ(registry.Acquire(FMeshKey(EMeshGenerator::None), nullptr), nullptr);
+    EXPECT_EQ(registry.GetNumLiveMeshes(), 0u);
+
+    FGeometryBufferAllocator::Shutdown();
+}
+
+TEST_F(NullRHITest, MeshRegistry_UnsharedWithoutRegistry)
+{
+    FGeometryBufferAllocator::Initialize(RHI.get());
+    ASSERT_EQ(FMeshRegistry::Get(), nullptr);
+
+    FMeshKey key(EMeshGenerator::LitCube);
+    FSharedMesh* first = FMeshRegistry::AcquireMesh(RHI.get(), key, BuildTestTriangle);
+    FSharedMesh* second = FMeshRegistry::AcquireMesh(RHI.get(), key, BuildTestTriangle);
+    ASSERT_NE(first, nullptr);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first->Hash, second->Hash);
+
+    // Meshes held when the registry goes away are freed by their last release
+    FMeshRegistry::Initialize(RHI.get());
+    FSharedMesh* shared = FMeshRegistry::AcquireMesh(RHI.get(), key, BuildTestTriangle);
+    FSharedMesh* sharedAgain = FMeshRegistry::AcquireMesh(RHI.get(), key, BuildTestTriangle);
+    EXPECT_EQ(shared, sharedAgain);
+    FMeshRegistry::Shutdown();
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, 6u);
+
+    FMeshRegistry::ReleaseMesh(first);
+    FMeshRegistry::ReleaseMesh(second);
+    FMeshRegistry::ReleaseMesh(shared);
+    FMeshRegistry::ReleaseMesh(sharedAgain);
+    FGeometryBufferAllocator::Shutdown();
+    EXPECT_EQ(RHI->GetDeferredReleaseStats().PendingObjects, 0u);
+}
+
+TEST_F(NullRHITest, MeshRegistry_ScenePrimitivesShareMeshes)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetPrecachePipelineStates(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    FMeshRegistry* registry = FMeshRegistry::Get();
+    ASSERT_NE(registry, nullptr);
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FCubePrimitive* cube = nullptr;
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        cube = new FCubePrimitive();
+        scene.AddPrimitive(cube);
+        scene.AddPrimitive(new FSpherePrimitive());
+        scene.AddPrimitive(new FSpherePrimitive(12, 8));
+    }
+    renderer.UpdateFromScene(&scene);
+
+    // 48 proxies, three meshes: the cube, and the sphere at two tessellations
+    FMeshRegistryStats stats = registry->GetStats();
+    EXPECT_EQ(stats.LiveMeshes, 3u);
+    EXPECT_EQ(stats.References, 48u);
+    EXPECT_EQ(stats.Misses, 3u);
+    EXPECT_EQ(stats.Hits, 45u);
+    EXPECT_EQ(FGeometryBufferAllocator::Get()->GetStats().NumAllocations, 6u);
+
+    // A recreated proxy finds its mesh while the old proxy still holds it
+    cube->SetColor(FColor(1.0f, 0.0f, 0.0f));
+    renderer.UpdateFromScene(&scene);
+    EXPECT_EQ(registry->GetStats().Misses, 3u);
+    EXPECT_EQ(registry->GetStats().Hits, 46u);
+
+    scene.Shutdown();
+    EXPECT_EQ(registry->GetNumLiveMeshes(), 0u);
+
+    renderer.Shutdown();
+    EXPECT_EQ(FMeshRegistry::Get(), nullptr);
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// View Uniform Tests
+// ============================================
+
+TEST_F(NullRHITest, ViewUniforms_SharedByEveryLitDraw)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);  // One draw per proxy
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FDirectionalLight* sun = new FDirectionalLight();
+    sun->SetDirection(FVector(0.3f, -1.0f, 0.2f));
+    scene.GetLightScene()->AddLight(sun);
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        FCubePrimitive* cube = new FCubePrimitive();
+        cube->SetPosition(FVector(static_cast<float>(i) * 1.5f - 5.0f, 0.0f, 0.0f));
+        scene.AddPrimitive(cube);
+    }
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    renderer.RenderFrame();
+
+    // Each lit draw binds its own primitive slice at b0 and the same view slice at b1
+    std::set<std::pair<uint32, uint32>> primitiveSlices;
+    std::set<std::pair<uint32, uint32>> viewSlices;
+    bool bInShadowPass = false;
+    uint32 baseDraws = 0;
+    CmdList->ForEachCommand([&](ENullCommand Command, const uint8* Payload, uint32 PayloadSize)
+    {
+        if (Command == ENullCommand::BeginShadowPass || Command == ENullCommand::EndShadowPass)
+        {
+            bInShadowPass = Command == ENullCommand::BeginShadowPass;
+        }
+        else if (Command == ENullCommand::DrawIndexedPrimitive && !bInShadowPass)
+        {
+            ++baseDraws;
+        }
+        else if (Command == ENullCommand::SetConstantBuffer && !bInShadowPass)
+        {
+            ASSERT_EQ(PayloadSize, 3u * sizeof(uint32));
+            uint32 values[3] = {};
+            memcpy(values, Payload, sizeof(values));
+            (values[1] == 0 ? primitiveSlices : viewSlices).insert({ values[0], values[2] });
+        }
+    });
+    EXPECT_EQ(baseDraws, 8u);
+    EXPECT_EQ(primitiveSlices.size(), 8u);
+    EXPECT_EQ(viewSlices.size(), 1u);
+
+    // One 256-byte slice per draw (the shadow pass takes its own) and two for the view
+    RHI->BeginTransientFrame();
+    FRHITransientConstantStats stats = RHI->GetTransientConstantStats();
+    EXPECT_LE(stats.LastFrameBytes, (8u + 2u) * 256u + 8u * 256u);
+
+    // The view's shadow matrix is the one the shadow depth pass rendered with
+    const FNullBoundState& bound = CmdList->GetBoundState();
+    ASSERT_NE(bound.ConstantBuffers[1], nullptr);
+    FViewUniformParameters view;
+    memcpy(&view, bound.ConstantBuffers[1]->GetData() + bound.ConstantBufferOffsets[1], sizeof(view));
+    FMatrix4x4 shadowMatrix;
+    ASSERT_TRUE(renderer.GetShadowSystem()->GetDirectionalShadowMatrix(shadowMatrix));
+    DirectX::XMFLOAT4X4 expected;
+    DirectX::XMFLOAT4X4 uploaded;
+    DirectX::XMStoreFloat4x4(&expected, DirectX::XMMatrixTranspose(shadowMatrix.Matrix));
+    DirectX::XMStoreFloat4x4(&uploaded, view.DirLightViewProj);
+    EXPECT_EQ(memcmp(&expected, &uploaded, sizeof(expected)), 0);
+    EXPECT_FLOAT_EQ(view.DirShadowInfo.x, 1.0f);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Frustum Culling Tests
+// ============================================
+
+TEST_F(NullRHITest, FrustumCulling_SkipsPrimitivesOutsideTheView)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    // Unlit cubes cast no shadows, so every draw is a base pass draw
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    std::vector<FUnlitCubePrimitive*> cubes;
+    for (uint32 i = 0; i < 5; ++i)
+    {
+        cubes.push_back(new FUnlitCubePrimitive());
+        cubes.back()->SetPosition(FVector(static_cast<float>(i % 3) - 1.0f, 0.0f, 0.0f));
+        scene.AddPrimitive(cubes.back());
+    }
+    cubes[3]->SetPosition(FVector(0.0f, 0.0f, -20.0f));     // Behind the camera
+    cubes[4]->SetPosition(FVector(200.0f, 0.0f, 0.0f));     // Far off to the side
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    const FRenderScene* renderScene = renderer.GetRenderScene();
+    const FSceneCullingStats& culling = renderScene->GetCullingStats();
+    EXPECT_EQ(culling.VisibleProxies, 3u);
+    EXPECT_EQ(culling.CulledProxies, 2u);
+    EXPECT_EQ(culling.VisibleTriangles, 3u * 12u);
+    EXPECT_EQ(culling.CulledTriangles, 2u * 12u);
+    EXPECT_EQ(CmdList->GetStats().GetCount(ENullCommand::DrawIndexedPrimitive), 3u);
+
+    // Moving into view only updates the bounds; the cached draw lists stay as they are
+    cubes[3]->SetPosition(FVector(0.0f, 0.0f, 2.0f));
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 1u);
+    EXPECT_EQ(culling.VisibleProxies, 4u);
+    EXPECT_EQ(CmdList->GetStats().GetCount(ENullCommand::DrawIndexedPrimitive), 4u);
+
+    // Turned off, everything draws
+    renderer.SetFrustumCulling(false);
+    renderer.RenderFrame();
+    EXPECT_EQ(culling.VisibleProxies, 5u);
+    EXPECT_EQ(culling.CulledProxies, 0u);
+    EXPECT_EQ(CmdList->GetStats().GetCount(ENullCommand::DrawIndexedPrimitive), 5u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+TEST_F(NullRHITest, FrustumCulling_InstancedDrawsOnlyVisibleInstances)
+{
+    FRenderer renderer(RHI.get());
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    std::vector<FUnlitCubePrimitive*> cubes;
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        cubes.push_back(new FUnlitCubePrimitive());
+        cubes.back()->SetPosition(FVector(static_cast<float>(i % 3) - 1.0f, 0.0f, i < 3 ? 0.0f : -20.0f));
+        scene.AddPrimitive(cubes.back());
+    }
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // One batch of six; the three behind the camera are left out of its instance data
+    const FRenderScene* renderScene = renderer.GetRenderScene();
+    const FNullCommandStats& cmdStats = CmdList->GetStats();
+    EXPECT_EQ(renderScene->GetNumInstances(EMeshPass::BasePass), 6u);
+    EXPECT_EQ(cmdStats.GetCount(ENullCommand::DrawIndexedInstanced), 1u);
+    EXPECT_EQ(cmdStats.InstancesDrawn, 3u);
+    EXPECT_EQ(renderScene->GetCullingStats().CulledProxies, 3u);
+
+    // With every instance culled the batch is not drawn at all
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        cubes[i]->SetPosition(FVector(0.0f, 0.0f, -20.0f));
+    }
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 1u);
+    EXPECT_EQ(cmdStats.GetCount(ENullCommand::DrawIndexedInstanced), 0u);
+    EXPECT_EQ(cmdStats.InstancesDrawn, 0u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Occlusion Culling Tests
+// ============================================
+
+TEST_F(NullRHITest, OcclusionCulling_OccluderHidesPrimitivesBehindIt)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    // Three cubes behind a wall filling the view, one between the wall and the camera
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        FUnlitCubePrimitive* cube = new FUnlitCubePrimitive();
+        cube->SetPosition(FVector(static_cast<float>(i) - 1.0f, 0.0f, 0.0f));
+        scene.AddPrimitive(cube);
+    }
+    FUnlitCubePrimitive* frontCube = new FUnlitCubePrimitive();
+    frontCube->SetPosition(FVector(0.0f, 0.0f, -4.0f));
+    frontCube->SetScale(FVector(0.5f, 0.5f, 0.5f));
+    scene.AddPrimitive(frontCube);
+    FUnlitCubePrimitive* wall = new FUnlitCubePrimitive();
+    wall->SetPosition(FVector(0.0f, 0.0f, -3.0f));
+    wall->SetScale(FVector(6.0f, 4.0f, 0.2f));
+    wall->SetOccluder(true);
+    scene.AddPrimitive(wall);
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // The occluder is rasterized from the registry's CPU copy of the cube
+    const FRenderScene* renderScene = renderer.GetRenderScene();
+    ASSERT_EQ(renderScene->GetProxies().size(), 5u);
+    ASSERT_NE(renderScene->GetProxies()[4]->GetOccluderMesh(), nullptr);
+    EXPECT_EQ(renderScene->GetProxies()[4]->GetOccluderMesh()->GetNumTriangles(), 12u);
+
+    const FOcclusionCullingStats& occlusion = renderScene->GetOcclusionCullingStats();
+    const FSceneCullingStats& culling = renderScene->GetCullingStats();
+    EXPECT_EQ(occlusion.NumOccluders, 1u);
+    EXPECT_GT(occlusion.OccluderTriangles, 0u);
+    EXPECT_EQ(occlusion.TestedProxies, 4u);
+    EXPECT_EQ(occlusion.OccludedProxies, 3u);
+    EXPECT_EQ(occlusion.OccludedTriangles, 3u * 12u);
+    EXPECT_FLOAT_EQ(occlusion.GetOccludedPercent(), 75.0f);
+    EXPECT_EQ(culling.VisibleProxies, 2u);
+    EXPECT_EQ(culling.CulledProxies, 3u);
+    EXPECT_EQ(CmdList->GetStats().GetCount(ENullCommand::DrawIndexedPrimitive), 2u);
+
+    // No longer an occluder: the draw lists are rebuilt and everything draws
+    wall->SetOccluder(false);
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(renderScene->GetNumCachedDrawListBuilds(), 2u);
+    EXPECT_EQ(occlusion.NumOccluders, 0u);
+    EXPECT_EQ(culling.VisibleProxies, 5u);
+    EXPECT_EQ(CmdList->GetStats().GetCount(ENullCommand::DrawIndexedPrimitive), 5u);
+
+    // An occluder again, with occlusion culling turned off
+    wall->SetOccluder(true);
+    renderer.SetOcclusionCulling(false);
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(occlusion.OccludedProxies, 0u);
+    EXPECT_EQ(CmdList->GetStats().GetCount(ENullCommand::DrawIndexedPrimitive), 5u);
+
+    // Without frustum culling the occluders still hide what is behind them
+    renderer.SetOcclusionCulling(true);
+    renderer.SetFrustumCulling(false);
+    renderer.RenderFrame();
+    EXPECT_EQ(occlusion.OccludedProxies, 3u);
+    EXPECT_EQ(culling.VisibleProxies, 2u);
+    EXPECT_EQ(CmdList->GetStats().GetCount(ENullCommand::DrawIndexedPrimitive), 2u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Shadow Caster Culling Tests
+// ============================================
+
+TEST_F(NullRHITest, ShadowCulling_PointLightFacesDrawOnlyCastersTheyReach)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetInstancedDraws(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FPointLight* point = new FPointLight();
+    point->SetPosition(FVector(0.0f, 0.0f, 0.0f));
+    point->SetRadius(10.0f);
+    scene.GetLightScene()->AddLight(point);
+
+    FCubePrimitive* inPlusX = new FCubePrimitive();
+    inPlusX->SetPosition(FVector(5.0f, 0.0f, 0.0f));
+    FCubePrimitive* outOfRange = new FCubePrimitive();
+    outOfRange->SetPosition(FVector(30.0f, 0.0f, 0.0f));
+    FCubePrimitive* pastRadius = new FCubePrimitive();      // Inside the +X and +Y face frustums, outside the radius
+    pastRadius->SetPosition(FVector(8.0f, 8.0f, 0.0f));
+    scene.AddPrimitive(inPlusX);
+    scene.AddPrimitive(outOfRange);
+    scene.AddPrimitive(pastRadius);
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // Six faces of three casters: only the +X face draws, and only the near cube
+    const FShadowCullingStats& shadowStats = renderer.GetRenderScene()->GetShadowCullingStats();
+    EXPECT_EQ(shadowStats.NumViews, 6u);
+    EXPECT_EQ(shadowStats.DrawnCasters, 1u);
+    EXPECT_EQ(shadowStats.CulledCasters, 3u * 6u - 1u);
+    EXPECT_EQ(renderer.GetShadowSystem()->GetShadowDrawCallCount(), 1u);
+
+    // Moving a caster updates its bounds for the next frame's shadow views
+    outOfRange->SetPosition(FVector(0.0f, 0.0f, -5.0f));
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+    EXPECT_EQ(shadowStats.DrawnCasters, 2u);
+    EXPECT_EQ(renderer.GetShadowSystem()->GetShadowDrawCallCount(), 2u);
+    EXPECT_EQ(renderer.GetRenderScene()->GetNumCachedDrawListBuilds(), 1u);
+
+    // Turned off, every caster is drawn into every face
+    renderer.SetShadowCulling(false);
+    renderer.RenderFrame();
+    EXPECT_EQ(shadowStats.NumViews, 0u);
+    EXPECT_EQ(renderer.GetShadowSystem()->GetShadowDrawCallCount(), 3u * 6u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+TEST_F(NullRHITest, ShadowCulling_InstancedCastersDrawPerView)
+{
+    FRenderer renderer(RHI.get());
+    renderer.SetFrustumCulling(false);
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+    FPipelineStateCache::Get()->WaitForPrecache();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FPointLight* point = new FPointLight();
+    point->SetPosition(FVector(0.0f, 0.0f, 0.0f));
+    point->SetRadius(10.0f);
+    scene.GetLightScene()->AddLight(point);
+
+    const FVector positions[3] = { FVector(5.0f, 0.0f, 0.0f), FVector(5.0f, 1.0f, 0.0f), FVector(-5.0f, 0.0f, 0.0f) };
+    for (const FVector& position : positions)
+    {
+        FCubePrimitive* cube = new FCubePrimitive();
+        cube->SetPosition(position);
+        scene.AddPrimitive(cube);
+    }
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    // One instanced shadow command: the +X face draws two instances, the -X face one,
+    // and the other faces skip it
+    const FRenderScene* renderScene = renderer.GetRenderScene();
+    ASSERT_EQ(renderScene->GetNumInstancedDraws(EMeshPass::ShadowDepth), 1u);
+    EXPECT_EQ(renderScene->GetShadowCullingStats().DrawnCasters, 3u);
+    EXPECT_EQ(renderer.GetShadowSystem()->GetShadowDrawCallCount(), 2u);
+
+    // Base pass: one draw of all three
+    const FNullCommandStats& cmdStats = CmdList->GetStats();
+    EXPECT_EQ(cmdStats.GetCount(ENullCommand::DrawIndexedInstanced), 1u + 2u);
+    EXPECT_EQ(cmdStats.InstancesDrawn, 3u + 3u);
+
+    // The renderer's draw call count is submitted draws, not visible proxies
+    EXPECT_EQ(renderer.GetDrawCallCount(), 1u + 2u);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+// ============================================
+// Spatial Index Tests
+// ============================================
+
+TEST_F(NullRHITest, SpatialIndex_QueriesFollowMovesAndRemovals)
+{
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FRenderScene renderScene;
+
+    FCubePrimitive* nearCube = new FCubePrimitive();
+    nearCube->SetPosition(FVector(2.0f, 0.0f, 0.0f));
+    FCubePrimitive* farCube = new FCubePrimitive();
+    farCube->SetPosition(FVector(50.0f, 0.0f, 0.0f));
+    scene.AddPrimitive(nearCube);
+    scene.AddPrimitive(farCube);
+    scene.UpdateRenderScene(&renderScene);
+    renderScene.ApplySnapshot();
+    renderScene.ReleaseSnapshot(renderScene.GetAppliedSnapshotSequence());
+    ASSERT_EQ(renderScene.GetProxies().size(), 2u);
+    FSceneProxy* nearProxy = renderScene.GetProxies()[0];
+    FSceneProxy* farProxy = renderScene.GetProxies()[1];
+
+    std::vector<FSceneProxy*> found;
+    renderScene.QueryProxies(FVector(0.0f, 0.0f, 0.0f), 5.0f, found);
+    EXPECT_EQ(found, std::vector<FSceneProxy*>({ nearProxy }));
+    EXPECT_EQ(renderScene.GetSpatialIndex().GetNumProxies(), 2u);
+
+    // Moves reach the tree without rebuilding the cached lists
+    farCube->SetPosition(FVector(0.0f, 0.0f, -3.0f));
+    scene.UpdateRenderScene(&renderScene);
+    renderScene.ApplySnapshot();
+    renderScene.ReleaseSnapshot(renderScene.GetAppliedSnapshotSequence());
+    found.clear();
+    renderScene.QueryProxies(FVector(0.0f, 0.0f, 0.0f), 5.0f, found);
+    EXPECT_EQ(found.size(), 2u);
+    EXPECT_EQ(renderScene.GetNumCachedDrawListBuilds(), 1u);
+
+    // Removed proxies leave the tree
+    scene.RemovePrimitive(nearCube);
+    delete nearCube;
+    scene.UpdateRenderScene(&renderScene);
+    renderScene.ApplySnapshot();
+    renderScene.ReleaseSnapshot(renderScene.GetAppliedSnapshotSequence());
+    found.clear();
+    renderScene.QueryProxies(FVector(0.0f, 0.0f, 0.0f), 5.0f, found);
+    EXPECT_EQ(found, std::vector<FSceneProxy*>({ farProxy }));
+    EXPECT_EQ(renderScene.GetSpatialIndex().GetNumProxies(), 1u);
+    EXPECT_TRUE(renderScene.GetSpatialIndex().Validate());
+
+    scene.Shutdown();
+    g_LightScene = nullptr;
+}
+
+TEST_F(NullRHITest, SpatialIndex_RayCastPicksTheNearestProxy)
+{
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FRenderScene renderScene;
+
+    // Three cubes along +Z and one beside the ray
+    const float depths[3] = { 30.0f, 10.0f, 20.0f };
+    for (float depth : depths)
+    {
+        FCubePrimitive* cube = new FCubePrimitive();
+        cube->SetPosition(FVector(0.0f, 0.0f, depth));
+        scene.AddPrimitive(cube);
+    }
+    FCubePrimitive* beside = new FCubePrimitive();
+    beside->SetPosition(FVector(10.0f, 0.0f, 5.0f));
+    scene.AddPrimitive(beside);
+    scene.UpdateRenderScene(&renderScene);
+    renderScene.ApplySnapshot();
+    ASSERT_EQ(renderScene.GetProxies().size(), 4u);
+
+    float distance = 0.0f;
+    FSceneProxy* hit = renderScene.RayCastProxies(FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 1.0f), 100.0f, &distance);
+    EXPECT_EQ(hit, renderScene.GetProxies()[1]);
+    const FBoxSphereBounds& bounds = renderScene.GetProxies()[1]->GetBounds();
+    EXPECT_NEAR(distance, bounds.Origin.Z - bounds.BoxExtent.Z, 1e-4f);
+
+    // Too short to reach, and pointing away
+    EXPECT_EQ(renderScene.RayCastProxies(FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 1.0f), 5.0f), nullptr);
+    EXPECT_EQ(renderScene.RayCastProxies(FVector(0.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, -1.0f), 100.0f), nullptr);
+
+    scene.Shutdown();
+    g_LightScene = nullptr;
+}
+
+// ============================================
+// Scene Snapshot Tests
+// ============================================
+
+TEST_F(NullRHITest, SceneSnapshot_AppliedOnlyByRenderScene)
+{
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FRenderScene renderScene;
+
+    FCubePrimitive* cube = new FCubePrimitive();
+    FSpherePrimitive* sphere = new FSpherePrimitive();
+    scene.AddPrimitive(cube);
+    scene.AddPrimitive(sphere);
+
+    // Publishing does not touch the render scene until it applies the snapshot
+    scene.UpdateRenderScene(&renderScene);
+    EXPECT_TRUE(renderScene.GetProxies().empty());
+    renderScene.ApplySnapshot();
+    ASSERT_EQ(renderScene.GetProxies().size(), 2u);
+    EXPECT_EQ(renderScene.GetAppliedSnapshotSequence(), 1u);
+
+    // Visibility and material changes reuse the existing proxies
+    FSceneProxy* cubeProxy = renderScene.GetProxies()[0];
+    uint32 cubeVersion = cubeProxy->GetRenderStateVersion();
+    sphere->SetVisible(false);
+    cube->SetMaterial(FMaterial());
+    scene.UpdateRenderScene(&renderScene);
+    EXPECT_EQ(renderScene.GetProxies().size(), 2u);
+    renderScene.ApplySnapshot();
+    ASSERT_EQ(renderScene.GetProxies().size(), 1u);
+    EXPECT_EQ(renderScene.GetProxies()[0], cubeProxy);
+    EXPECT_NE(cubeProxy->GetRenderStateVersion(), cubeVersion);
+    EXPECT_EQ(scene.GetNumRetiredProxies(), 0u);
+
+    // Nothing new published: applying again keeps the current state
+    renderScene.ApplySnapshot();
+    EXPECT_EQ(renderScene.GetAppliedSnapshotSequence(), 2u);
+
+    scene.Shutdown();
+    g_LightScene = nullptr;
+}
+
+TEST_F(NullRHITest, SceneSnapshot_RemovedProxyDeletedAfterRelease)
+{
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+    FRenderScene renderScene;
+
+    FCubePrimitive* cube = new FCubePrimitive();
+    scene.AddPrimitive(cube);
+    scene.AddPrimitive(new FSpherePrimitive());
+    scene.UpdateRenderScene(&renderScene);
+    renderScene.ApplySnapshot();
+    renderScene.ReleaseSnapshot(renderScene.GetAppliedSnapshotSequence());
+
+    scene.RemovePrimitive(cube);
+    delete cube;
+    EXPECT_EQ(scene.GetNumRetiredProxies(), 1u);
+
+    // Snapshot 2 no longer contains the cube, but the render thread has not released it
+    scene.UpdateRenderScene(&renderScene);
+    scene.UpdateRenderScene(&renderScene);
+    EXPECT_EQ(scene.GetNumRetiredProxies(), 1u);
+
+    renderScene.ApplySnapshot();
+    EXPECT_EQ(renderScene.GetProxies().size(), 1u);
+    renderScene.ReleaseSnapshot(renderScene.GetAppliedSnapshotSequence());
+    scene.UpdateRenderScene(&renderScene);
+    EXPECT_EQ(scene.GetNumRetiredProxies(), 0u);
+
+    scene.Shutdown();
+    g_LightScene = nullptr;
+}
+
+// ============================================
+// Frame Latency Tests
+// ============================================
+
+TEST(FrameLatencyTrackerTest, PresentClosesFrameAndPublishesPercentiles)
+{
+    FFrameLatencyTracker tracker;
+    EXPECT_EQ(tracker.GetLastPresentedFrameId(), 0u);
+
+    uint64 first = tracker.BeginFrame();
+    uint64 second = tracker.BeginFrame();
+    EXPECT_EQ(first, 1u);
+    EXPECT_EQ(second, 2u);
+
+    // Stages of different frames interleave as they would in the pipeline
+    tracker.MarkStage(first, EFrameStage::RenderBegin);
+    tracker.MarkStage(first, EFrameStage::RHISubmit);
+    tracker.MarkStage(second, EFrameStage::RenderBegin);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    tracker.MarkStage(first, EFrameStage::Present);
+    EXPECT_EQ(tracker.GetLastPresentedFrameId(), first);
+    EXPECT_GE(tracker.GetLastLatencyMs(), 5.0f);
+    EXPECT_EQ(tracker.GetP50LatencyMs(), tracker.GetLastLatencyMs());
+
+    tracker.MarkStage(second, EFrameStage::RHISubmit);
+    tracker.MarkStage(second, EFrameStage::Present);
+    EXPECT_EQ(tracker.GetLastPresentedFrameId(), second);
+    EXPECT_LE(tracker.GetP50LatencyMs(), tracker.GetP99LatencyMs());
+    EXPECT_LE(tracker.GetP99LatencyMs(), tracker.GetMaxLatencyMs());
+
+    // Untracked frames are ignored
+    tracker.MarkStage(0, EFrameStage::Present);
+    EXPECT_EQ(tracker.GetLastPresentedFrameId(), second);
+}
+
+TEST(FrameLatencyTrackerTest, OverwrittenFrameIsIgnored)
+{
+    FFrameLatencyTracker tracker;
+    uint64 stale = tracker.BeginFrame();
+    for (uint32 i = 0; i < FFrameLatencyTracker::MaxFramesTracked; ++i)
+    {
+        tracker.BeginFrame();
+    }
+
+    tracker.MarkStage(stale, EFrameStage::Present);
+    EXPECT_EQ(tracker.GetLastPresentedFrameId(), 0u);
+}
+
+// ============================================
+// Headless Renderer Tests
+// ============================================
+
+TEST_F(NullRHITest, Renderer_RendersSceneHeadless)
+{
+    FRenderer renderer(RHI.get());
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+
+    FDirectionalLight* sun = new FDirectionalLight();
+    sun->SetDirection(FVector(0.5f, -0.8f, 0.3f));
+    scene.GetLightScene()->AddLight(sun);
+
+    FPointLight* point = new FPointLight();
+    point->SetPosition(FVector(0.0f, 2.0f, 0.0f));
+    point->SetRadius(8.0f);
+    scene.GetLightScene()->AddLight(point);
+
+    scene.AddPrimitive(new FCubePrimitive());
+    scene.AddPrimitive(new FSpherePrimitive());
+
+    renderer.UpdateFromScene(&scene);
+    renderer.RenderFrame();
+
+    const FNullCommandStats& stats = CmdList->GetStats();
+    EXPECT_EQ(CmdList->GetPresentedFrameCount(), 1u);
+    EXPECT_GT(stats.GetCount(ENullCommand::BeginShadowPass), 0u);
+    EXPECT_GE(stats.GetCount(ENullCommand::DrawIndexedPrimitive), 2u);
+    EXPECT_EQ(CmdList->GetBoundState().EventDepth, 0u);
+    EXPECT_FALSE(CmdList->GetBoundState().bInShadowPass);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
+
+TEST_F(NullRHITest, Renderer_RecordedFrameMatchesImmediateFrame)
+{
+    FRenderer renderer(RHI.get());
+    renderer.Initialize();
+    g_Camera = renderer.GetCamera();
+
+    FScene scene(RHI.get());
+    g_LightScene = scene.GetLightScene();
+
+    FDirectionalLight* sun = new FDirectionalLight();
+    sun->SetDirection(FVector(0.5f, -0.8f, 0.3f));
+    scene.GetLightScene()->AddLight(sun);
+
+    scene.AddPrimitive(new FCubePrimitive());
+    scene.AddPrimitive(new FSpherePrimitive());
+    renderer.UpdateFromScene(&scene);
+
+    renderer.RenderFrame();
+    FNullCommandStats immediateStats = CmdList->GetStats();
+
+    // Pipelined path: record on the "render thread", replay on the "RHI thread"
+    FRHICommandRecorder* recorder = renderer.RecordFrame();
+    EXPECT_EQ(CmdList->GetPresentedFrameCount(), 1u);
+    renderer.ExecuteRecordedFrame(recorder);
+
+    const FNullCommandStats& recordedStats = CmdList->GetStats();
+    EXPECT_EQ(CmdList->GetPresentedFrameCount(), 2u);
+    for (uint32 i = 0; i < static_cast<uint32>(ENullCommand::Count); ++i)
+    {
+        EXPECT_EQ(recordedStats.CommandCounts[i], immediateStats.CommandCounts[i])
+            << GetNullCommandName(static_cast<ENullCommand>(i));
+    }
+
+    // Consecutive frames use different ring slots; the frame ID follows the recorder
+    uint64 frameId = renderer.GetStats().GetLatencyTracker().BeginFrame();
+    FRHICommandRecorder* nextRecorder = renderer.RecordFrame(frameId);
+    EXPECT_NE(nextRecorder, recorder);
+    EXPECT_NE(renderer.GetStats().GetLatencyTracker().GetLastPresentedFrameId(), frameId);
+    renderer.ExecuteRecordedFrame(nextRecorder);
+    EXPECT_EQ(renderer.GetStats().GetLatencyTracker().GetLastPresentedFrameId(), frameId);
+
+    scene.Shutdown();
+    renderer.Shutdown();
+    g_LightScene = nullptr;
+    g_Camera = nullptr;
+}
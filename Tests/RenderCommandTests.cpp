@@ -0,0 +1,421 @@
+/**
+ * Unit tests for the render command queue
+ * Tests FRenderCommandQueue ordering, multi-producer enqueue, consumer
+ * wake-up and recycling of chunked command memory, the frame lead
+ * enforced by FFrameSyncManager and FRenderFence markers on the render and
+ * RHI threads, including fences begun while the render thread stops
+ */
+
+#include <gtest/gtest.h>
+#include "RenderCommands.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(RenderCommandQueueTest, ExecutesInEnqueueOrder)
+{
+    FRenderCommandQueue Queue;
+    std::vector<int32> Order;
+
+    for (int32 i = 0; i < 1000; ++i)
+    {
+        Queue.EnqueueLambda("Append", [&Order, i]() { Order.push_back(i); });
+    }
+    EXPECT_EQ(Queue.GetPendingCommandCount(), 1000u);
+
+    EXPECT_EQ(Queue.ProcessCommands(), 1000u);
+    EXPECT_FALSE(Queue.HasPendingCommands());
+    ASSERT_EQ(Order.size(), 1000u);
+    for (int32 i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(Order[i], i);
+    }
+}
+
+TEST(RenderCommandQueueTest, CapturesDestroyedAfterExecution)
+{
+    FRenderCommandQueue Queue;
+    std::shared_ptr<int32> Resource = std::make_shared<int32>(42);
+
+    int32 Seen = 0;
+    Queue.EnqueueLambda("Read", [Resource, &Seen]() { Seen = *Resource; });
+    EXPECT_EQ(Resource.use_count(), 2);
+
+    Queue.ProcessCommands();
+    EXPECT_EQ(Seen, 42);
+    EXPECT_EQ(Resource.use_count(), 1);
+}
+
+TEST(RenderCommandQueueTest, DestructorDestroysUnexecutedCommands)
+{
+    std::shared_ptr<int32> Resource = std::make_shared<int32>(0);
+    {
+        FRenderCommandQueue Queue;
+        Queue.EnqueueLambda("Never", [Resource]() {});
+        EXPECT_EQ(Resource.use_count(), 2);
+    }
+    EXPECT_EQ(Resource.use_count(), 1);
+}
+
+TEST(RenderCommandQueueTest, OversizedCommand_FallsBackToHeap)
+{
+    FRenderCommandQueue Queue;
+    std::array<uint8, FRenderCommandChunk::ChunkSize> Payload;
+    Payload.fill(7);
+
+    uint32 Sum = 0;
+    Queue.EnqueueLambda("Big", [Payload, &Sum]() { Sum = Payload[0] + Payload[Payload.size() - 1]; });
+    EXPECT_EQ(Queue.ProcessCommands(), 1u);
+    EXPECT_EQ(Sum, 14u);
+}
+
+TEST(RenderCommandQueueTest, HeapCommand_StillSupported)
+{
+    class FFlagCommand : public FRenderCommandBase
+    {
+    public:
+        explicit FFlagCommand(bool* InFlag) : Flag(InFlag) {}
+        virtual void Execute() override { *Flag = true; }
+
+    private:
+        bool* Flag;
+    };
+
+    FRenderCommandQueue Queue;
+    bool bExecuted = false;
+    Queue.EnqueueCommand(std::make_unique<FFlagCommand>(&bExecuted));
+    EXPECT_TRUE(Queue.ProcessOneCommand());
+    EXPECT_TRUE(bExecuted);
+    EXPECT_FALSE(Queue.ProcessOneCommand());
+}
+
+TEST(RenderCommandQueueTest, MultipleProducers_EveryCommandOnceInProducerOrder)
+{
+    FRenderCommandQueue Queue;
+    const uint32 NumProducers = 4;
+    const uint32 CommandsPerProducer = 20000;
+
+    // Written only by the consumer thread
+    std::vector<uint32> NextExpected(NumProducers, 0);
+    std::atomic<uint32> NumOutOfOrder(0);
+
+    std::thread Consumer([&]()
+    {
+        uint32 Executed = 0;
+        while (Executed < NumProducers * CommandsPerProducer)
+        {
+            uint32 Processed = Queue.ProcessCommands();
+            Executed += Processed;
+            if (Processed == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> Producers;
+    for (uint32 Producer = 0; Producer < NumProducers; ++Producer)
+    {
+        Producers.emplace_back([&, Producer]()
+        {
+            for (uint32 i = 0; i < CommandsPerProducer; ++i)
+            {
+                Queue.EnqueueLambda("Check", [&, Producer, i]()
+                {
+                    if (NextExpected[Producer] != i)
+                    {
+                        NumOutOfOrder.fetch_add(1);
+                    }
+                    NextExpected[Producer] = i + 1;
+                });
+            }
+        });
+    }
+    for (std::thread& Producer : Producers)
+    {
+        Producer.join();
+    }
+    Consumer.join();
+
+    EXPECT_EQ(NumOutOfOrder.load(), 0u);
+    for (uint32 Producer = 0; Producer < NumProducers; ++Producer)
+    {
+        EXPECT_EQ(NextExpected[Producer], CommandsPerProducer);
+    }
+    EXPECT_FALSE(Queue.HasPendingCommands());
+}
+
+TEST(RenderCommandQueueTest, WaitAndProcess_WakesOnEnqueueAndShutdown)
+{
+    FRenderCommandQueue Queue;
+    std::atomic<uint32> Executed(0);
+    std::atomic<bool> bConsumerExited(false);
+
+    std::thread Consumer([&]()
+    {
+        while (Queue.WaitAndProcessCommand())
+        {
+        }
+        bConsumerExited = true;
+    });
+
+    // Let the consumer park before each enqueue
+    for (uint32 i = 0; i < 5; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        Queue.EnqueueLambda("Count", [&Executed]() { Executed.fetch_add(1); });
+    }
+
+    auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (Executed.load() < 5 && std::chrono::steady_clock::now() < Deadline)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(Executed.load(), 5u);
+
+    Queue.SignalShutdown();
+    Consumer.join();
+    EXPECT_TRUE(bConsumerExited.load());
+}
+
+TEST(RenderCommandQueueTest, Shutdown_RejectsEnqueues)
+{
+    FRenderCommandQueue Queue;
+    EXPECT_TRUE(Queue.EnqueueLambda("Accepted", []() {}));
+
+    Queue.SignalShutdown();
+    bool bRan = false;
+    EXPECT_FALSE(Queue.EnqueueLambda("Rejected", [&bRan]() { bRan = true; }));
+    EXPECT_FALSE(Queue.EnqueueCommand(std::make_unique<FLambdaRenderCommand<std::function<void()>>>("Rejected", []() {})));
+
+    // The command accepted before shutdown still runs
+    EXPECT_EQ(Queue.ProcessCommands(), 1u);
+    EXPECT_FALSE(bRan);
+}
+
+TEST(RenderCommandQueueTest, SteadyState_ChunksAreRecycled)
+{
+    FRenderCommandQueue Queue;
+    const uint32 CommandsPerFrame = 20000;
+    uint64 Sum = 0;
+
+    auto RunFrame = [&]()
+    {
+        for (uint32 i = 0; i < CommandsPerFrame; ++i)
+        {
+            Queue.EnqueueLambda("Add", [&Sum, i]() { Sum += i; });
+        }
+        Queue.ProcessCommands();
+    };
+
+    // Warm up so the pool holds a frame's worth of chunks
+    RunFrame();
+    RunFrame();
+    uint32 WarmChunks = FRenderCommandQueue::GetNumAllocatedChunks();
+
+    for (uint32 Frame = 0; Frame < 200; ++Frame)
+    {
+        RunFrame();
+    }
+
+    EXPECT_EQ(FRenderCommandQueue::GetNumAllocatedChunks(), WarmChunks);
+    EXPECT_EQ(Sum, 202ull * (static_cast<uint64>(CommandsPerFrame) * (CommandsPerFrame - 1) / 2));
+}
+
+TEST(FrameSyncManagerTest, SetFrameLead_ClampsToSupportedRange)
+{
+    FFrameSyncManager Sync;
+    EXPECT_EQ(Sync.GetFrameLead(), FFrameSyncManager::MinFrameLead);
+
+    Sync.SetFrameLead(0);
+    EXPECT_EQ(Sync.GetFrameLead(), 1u);
+    Sync.SetFrameLead(2);
+    EXPECT_EQ(Sync.GetFrameLead(), 2u);
+    Sync.SetFrameLead(9);
+    EXPECT_EQ(Sync.GetFrameLead(), FFrameSyncManager::MaxFrameLead);
+}
+
+TEST(FrameSyncManagerTest, GameThreadBlocksBeyondFrameLead)
+{
+    FFrameSyncManager Sync;
+    Sync.SetFrameLead(2);
+
+    // Nothing completed on the RHI thread yet: frames 1..3 may start
+    for (uint32 Frame = 0; Frame < 3; ++Frame)
+    {
+        Sync.GameThread_BeginFrame();
+    }
+    EXPECT_EQ(Sync.GetGameFrameNumber(), 3u);
+
+    std::atomic<bool> bStarted(false);
+    std::thread Game([&]()
+    {
+        Sync.GameThread_BeginFrame();
+        bStarted = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(bStarted.load());
+
+    // Finishing the oldest frame on the RHI thread releases the game thread
+    Sync.RHIThread_BeginFrame();
+    Sync.RHIThread_EndFrame();
+    Game.join();
+    EXPECT_TRUE(bStarted.load());
+    EXPECT_EQ(Sync.GetGameFrameNumber(), 4u);
+    EXPECT_EQ(Sync.GetRHICompletedFrameNumber(), 1u);
+}
+
+TEST(FrameSyncManagerTest, RaisingFrameLead_WakesWaitingGameThread)
+{
+    FFrameSyncManager Sync;
+    Sync.GameThread_BeginFrame();
+    Sync.GameThread_BeginFrame();
+
+    std::atomic<bool> bStarted(false);
+    std::thread Game([&]()
+    {
+        Sync.GameThread_BeginFrame();
+        bStarted = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(bStarted.load());
+
+    Sync.SetFrameLead(2);
+    Game.join();
+    EXPECT_TRUE(bStarted.load());
+}
+
+TEST(RenderFenceTest, NoRenderThread_CompletesImmediately)
+{
+    ASSERT_FALSE(FRenderThread::Get().IsRunning());
+
+    FRenderFence Fence;
+    EXPECT_TRUE(Fence.IsFenceComplete());
+    Fence.BeginFence();
+    EXPECT_TRUE(Fence.IsFenceComplete());
+    Fence.Wait();
+}
+
+TEST(RenderFenceTest, RenderThread_SignalsAfterEarlierCommands)
+{
+    FRenderThread::Get().Start();
+
+    std::atomic<bool> bCommandRan(false);
+    ENQUEUE_RENDER_COMMAND(SlowCommand)[&bCommandRan]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        bCommandRan = true;
+    });
+
+    FRenderFence Fence;
+    Fence.BeginFence();
+    EXPECT_FALSE(Fence.IsFenceComplete());
+
+    // No frame is signalled: Wait must kick the render thread itself
+    Fence.Wait();
+    EXPECT_TRUE(bCommandRan.load());
+    EXPECT_TRUE(Fence.IsFenceComplete());
+
+    FRenderThread::Get().Stop();
+}
+
+TEST(RenderFenceTest, SyncToRHIThread_SignalsAfterQueuedRHIWork)
+{
+    FRenderThread::Get().Start();
+    FRHIThread::Get().Start();
+
+    std::atomic<bool> bRHIWorkRan(false);
+    ENQUEUE_RENDER_COMMAND(EnqueueRHIWork)[&bRHIWorkRan]()
+    {
+        FRHIThread::Get().EnqueueWork([&bRHIWorkRan]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            bRHIWorkRan = true;
+        });
+    });
+
+    // A render-thread fence only waits for the render command itself
+    FRenderFence RenderFence;
+    FRenderFence RHIFence;
+    RenderFence.BeginFence();
+    RHIFence.BeginFence(true);
+
+    RHIFence.Wait();
+    EXPECT_TRUE(bRHIWorkRan.load());
+    EXPECT_TRUE(RenderFence.IsFenceComplete());
+
+    FRenderThread::Get().Stop();
+    FRHIThread::Get().Stop();
+}
+
+TEST(RenderFenceTest, BegunWhileStopping_IsAlwaysSignalled)
+{
+    for (uint32 Round = 0; Round < 20; ++Round)
+    {
+        FRenderThread::Get().Start();
+
+        // Fences race the stop: each is either run by the final drain or rejected and
+        // signalled by BeginFence, never left pending
+        std::atomic<bool> bStopped(false);
+        std::atomic<uint32> Completed(0);
+        std::thread Producer([&]()
+        {
+            while (!bStopped.load())
+            {
+                FRenderFence Fence;
+                Fence.BeginFence();
+                Fence.Wait();
+                Completed.fetch_add(1);
+            }
+        });
+
+        // Stop only once a fence has completed, so the count below is not a scheduling race
+        while (Completed.load() == 0)
+        {
+            std::this_thread::yield();
+        }
+        FRenderThread::Get().Stop();
+        bStopped = true;
+        Producer.join();
+        EXPECT_GT(Completed.load(), 0u);
+    }
+}
+
+TEST(RenderFenceTest, SyncToRHIThread_BegunWhileRHIStopping_IsAlwaysSignalled)
+{
+    FRenderThread::Get().Start();
+    for (uint32 Round = 0; Round < 20; ++Round)
+    {
+        FRHIThread::Get().Start();
+
+        // The RHI thread stops under the fences: each marker is either run by its final
+        // drain or rejected by EnqueueWork and signalled on the render thread
+        std::atomic<bool> bStopped(false);
+        std::atomic<uint32> Completed(0);
+        std::thread Producer([&]()
+        {
+            while (!bStopped.load())
+            {
+                FRenderFence Fence;
+                Fence.BeginFence(true);
+                Fence.Wait();
+                Completed.fetch_add(1);
+            }
+        });
+
+        while (Completed.load() == 0)
+        {
+            std::this_thread::yield();
+        }
+        FRHIThread::Get().Stop();
+        bStopped = true;
+        Producer.join();
+    }
+    FRenderThread::Get().Stop();
+
+    EXPECT_FALSE(FRHIThread::Get().EnqueueWork([]() {}));
+}
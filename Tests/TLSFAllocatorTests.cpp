@@ -0,0 +1,217 @@
+/**
+ * Unit tests for the TLSF range allocator
+ * Tests FTLSFAllocator placement, splitting and coalescing on Free, exact-fit
+ * requests that only the request's own size class can satisfy, Reset, and a
+ * randomized alloc/free run checked against a reference model of the range
+ */
+
+#include <gtest/gtest.h>
+#include "TLSFAllocator.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(TLSFAllocatorTest, Allocate_PacksFromOffsetZero)
+{
+    FTLSFAllocator Allocator(1000);
+
+    FTLSFAllocator::FAllocation A = Allocator.Allocate(100);
+    FTLSFAllocator::FAllocation B = Allocator.Allocate(200);
+    FTLSFAllocator::FAllocation C = Allocator.Allocate(300);
+
+    ASSERT_TRUE(A.IsValid() && B.IsValid() && C.IsValid());
+    EXPECT_EQ(A.Offset, 0u);
+    EXPECT_EQ(B.Offset, 100u);
+    EXPECT_EQ(C.Offset, 300u);
+    EXPECT_EQ(Allocator.GetAllocationSize(B), 200u);
+    EXPECT_EQ(Allocator.GetUsedSize(), 600u);
+    EXPECT_EQ(Allocator.GetNumAllocations(), 3u);
+    EXPECT_EQ(Allocator.GetNumFreeBlocks(), 1u);
+    EXPECT_EQ(Allocator.GetLargestFreeBlock(), 400u);
+}
+
+TEST(TLSFAllocatorTest, Allocate_FailsWhenNothingFits)
+{
+    FTLSFAllocator Allocator(64);
+
+    EXPECT_FALSE(Allocator.Allocate(0).IsValid());
+    EXPECT_FALSE(Allocator.Allocate(65).IsValid());
+
+    FTLSFAllocator::FAllocation All = Allocator.Allocate(64);
+    ASSERT_TRUE(All.IsValid());
+    EXPECT_FALSE(Allocator.Allocate(1).IsValid());
+    EXPECT_EQ(Allocator.GetFreeSize(), 0u);
+    EXPECT_EQ(Allocator.GetLargestFreeBlock(), 0u);
+}
+
+TEST(TLSFAllocatorTest, Free_CoalescesNeighbours)
+{
+    FTLSFAllocator Allocator(1000);
+
+    FTLSFAllocator::FAllocation A = Allocator.Allocate(100);
+    FTLSFAllocator::FAllocation B = Allocator.Allocate(100);
+    FTLSFAllocator::FAllocation C = Allocator.Allocate(100);
+    FTLSFAllocator::FAllocation D = Allocator.Allocate(100);
+
+    // Two separate holes
+    Allocator.Free(A);
+    Allocator.Free(C);
+    EXPECT_EQ(Allocator.GetNumFreeBlocks(), 3u);
+    EXPECT_EQ(Allocator.GetLargestFreeBlock(), 600u);
+
+    // Freeing B joins A, B and C into one block
+    Allocator.Free(B);
+    EXPECT_EQ(Allocator.GetNumFreeBlocks(), 2u);
+    FTLSFAllocator::FAllocation Tail = Allocator.Allocate(600);
+    FTLSFAllocator::FAllocation Joined = Allocator.Allocate(300);
+    ASSERT_TRUE(Tail.IsValid() && Joined.IsValid());
+    EXPECT_EQ(Tail.Offset, 400u);
+    EXPECT_EQ(Joined.Offset, 0u);
+
+    // Everything free again is a single block
+    Allocator.Free(Joined);
+    Allocator.Free(Tail);
+    Allocator.Free(D);
+    EXPECT_EQ(Allocator.GetNumFreeBlocks(), 1u);
+    EXPECT_EQ(Allocator.GetLargestFreeBlock(), 1000u);
+    EXPECT_EQ(Allocator.GetUsedSize(), 0u);
+}
+
+TEST(TLSFAllocatorTest, Free_IgnoresStaleHandles)
+{
+    FTLSFAllocator Allocator(256);
+
+    FTLSFAllocator::FAllocation A = Allocator.Allocate(16);
+    Allocator.Free(A);
+    Allocator.Free(A);
+    Allocator.Free(FTLSFAllocator::FAllocation());
+
+    EXPECT_EQ(Allocator.GetNumAllocations(), 0u);
+    EXPECT_EQ(Allocator.GetUsedSize(), 0u);
+    EXPECT_EQ(Allocator.GetNumFreeBlocks(), 1u);
+}
+
+TEST(TLSFAllocatorTest, Allocate_ExactFitInOwnSizeClass)
+{
+    // 17 shares a size class with 16..17; rounding the request up skips that class,
+    // so only the fallback finds the one block that fits exactly
+    FTLSFAllocator Allocator(17);
+    FTLSFAllocator::FAllocation A = Allocator.Allocate(17);
+    ASSERT_TRUE(A.IsValid());
+    EXPECT_EQ(A.Offset, 0u);
+
+    // Same when the fitting block is one of several in the class
+    FTLSFAllocator Holes(1000);
+    std::vector<FTLSFAllocator::FAllocation> Blocks;
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        Blocks.push_back(Holes.Allocate(i % 2 == 0 ? 17u : 1u));
+    }
+    FTLSFAllocator::FAllocation Rest = Holes.Allocate(Holes.GetFreeSize());
+    ASSERT_TRUE(Rest.IsValid());
+    for (uint32 i = 0; i < 10; i += 2)
+    {
+        Holes.Free(Blocks[i]);
+    }
+    FTLSFAllocator::FAllocation Fit = Holes.Allocate(17);
+    ASSERT_TRUE(Fit.IsValid());
+    EXPECT_EQ(Holes.GetAllocationSize(Fit), 17u);
+}
+
+TEST(TLSFAllocatorTest, Reset_ReleasesEverything)
+{
+    FTLSFAllocator Allocator(4096);
+    for (uint32 i = 0; i < 50; ++i)
+    {
+        Allocator.Allocate(37);
+    }
+    Allocator.Reset();
+
+    EXPECT_EQ(Allocator.GetNumAllocations(), 0u);
+    EXPECT_EQ(Allocator.GetUsedSize(), 0u);
+    EXPECT_EQ(Allocator.GetLargestFreeBlock(), 4096u);
+    EXPECT_EQ(Allocator.Allocate(4096).Offset, 0u);
+}
+
+TEST(TLSFAllocatorTest, RandomChurn_MatchesReferenceModel)
+{
+    const uint32 Capacity = 1u << 16;
+    FTLSFAllocator Allocator(Capacity);
+
+    struct FLive
+    {
+        FTLSFAllocator::FAllocation Allocation;
+        uint32 Size;
+    };
+    std::vector<FLive> Live;
+    std::vector<uint8> Owner(Capacity, 0);
+    std::mt19937 Random(1234);
+
+    for (uint32 Step = 0; Step < 20000; ++Step)
+    {
+        bool bAllocate = Live.empty() || Random() % 100 < 55;
+        if (bAllocate)
+        {
+            uint32 Size = 1 + Random() % 700;
+            FTLSFAllocator::FAllocation Allocation = Allocator.Allocate(Size);
+            if (!Allocation.IsValid())
+            {
+                // A failure is only allowed when no free block could hold Size
+                EXPECT_LT(Allocator.GetLargestFreeBlock(), Size);
+                continue;
+            }
+            ASSERT_LE(Allocation.Offset + Size, Capacity);
+            for (uint32 i = Allocation.Offset; i < Allocation.Offset + Size; ++i)
+            {
+                ASSERT_EQ(Owner[i], 0) << "Overlapping allocation at " << i;
+                Owner[i] = 1;
+            }
+            Live.push_back({ Allocation, Size });
+        }
+        else
+        {
+            uint32 Index = Random() % Live.size();
+            FLive Victim = Live[Index];
+            Live[Index] = Live.back();
+            Live.pop_back();
+            std::fill(Owner.begin() + Victim.Allocation.Offset, Owner.begin() + Victim.Allocation.Offset + Victim.Size, 0);
+            Allocator.Free(Victim.Allocation);
+        }
+
+        uint32 UsedSize = 0;
+        for (const FLive& Entry : Live)
+        {
+            UsedSize += Entry.Size;
+        }
+        ASSERT_EQ(Allocator.GetUsedSize(), UsedSize);
+        ASSERT_EQ(Allocator.GetNumAllocations(), static_cast<uint32>(Live.size()));
+    }
+
+    // Free blocks in the reference are maximal runs, exactly what coalescing should leave
+    uint32 ReferenceBlocks = 0;
+    uint32 ReferenceLargest = 0;
+    for (uint32 i = 0; i < Capacity;)
+    {
+        if (Owner[i] != 0)
+        {
+            ++i;
+            continue;
+        }
+        uint32 Start = i;
+        while (i < Capacity && Owner[i] == 0)
+        {
+            ++i;
+        }
+        ++ReferenceBlocks;
+        ReferenceLargest = std::max(ReferenceLargest, i - Start);
+    }
+    EXPECT_EQ(Allocator.GetNumFreeBlocks(), ReferenceBlocks);
+    EXPECT_EQ(Allocator.GetLargestFreeBlock(), ReferenceLargest);
+
+    for (const FLive& Entry : Live)
+    {
+        Allocator.Free(Entry.Allocation);
+    }
+    EXPECT_EQ(Allocator.GetNumFreeBlocks(), 1u);
+    EXPECT_EQ(Allocator.GetLargestFreeBlock(), Capacity);
+}
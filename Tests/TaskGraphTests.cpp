@@ -0,0 +1,761 @@
+/**
+ * Unit tests for the task graph
+ * Tests TWorkStealingQueue, the work-stealing FTaskGraph scheduler,
+ * pooled task/event recycling, task prerequisites, ParallelFor and the
+ * TTripleBuffer game -> render handoff
+ */
+
+#include <gtest/gtest.h>
+#include "TaskGraph.h"
+#include "WorkStealingQueue.h"
+#include "LockFreePool.h"
+#include "ParallelFor.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Task that bumps a shared counter
+class FCounterTask : public FTask
+{
+public:
+    explicit FCounterTask(std::atomic<uint32>* InCounter) : Counter(InCounter) {}
+
+    virtual void Execute() override
+    {
+        Counter->fetch_add(1);
+        Event->Signal();
+    }
+
+private:
+    std::atomic<uint32>* Counter;
+};
+
+// Spin until Counter reaches Expected or the timeout expires
+static bool WaitForCount(const std::atomic<uint32>& Counter, uint32 Expected, int TimeoutMs = 10000)
+{
+    auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TimeoutMs);
+    while (Counter.load() < Expected)
+    {
+        if (std::chrono::steady_clock::now() > Deadline)
+        {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// ============================================
+// Work-Stealing Queue Tests
+// ============================================
+
+TEST(WorkStealingQueueTest, PopIsLifo)
+{
+    TWorkStealingQueue<int*> Queue;
+    int Values[3] = { 0, 1, 2 };
+    for (int& Value : Values)
+    {
+        Queue.Push(&Value);
+    }
+
+    int* Item = nullptr;
+    ASSERT_TRUE(Queue.Pop(Item));
+    EXPECT_EQ(Item, &Values[2]);
+    ASSERT_TRUE(Queue.Pop(Item));
+    EXPECT_EQ(Item, &Values[1]);
+}
+
+TEST(WorkStealingQueueTest, StealIsFifo)
+{
+    TWorkStealingQueue<int*> Queue;
+    int Values[3] = { 0, 1, 2 };
+    for (int& Value : Values)
+    {
+        Queue.Push(&Value);
+    }
+
+    int* Item = nullptr;
+    ASSERT_TRUE(Queue.Steal(Item));
+    EXPECT_EQ(Item, &Values[0]);
+}
+
+TEST(WorkStealingQueueTest, EmptyQueue_PopAndStealFail)
+{
+    TWorkStealingQueue<int*> Queue;
+    int* Item = nullptr;
+    EXPECT_FALSE(Queue.Pop(Item));
+    EXPECT_FALSE(Queue.Steal(Item));
+    EXPECT_TRUE(Queue.IsEmpty());
+}
+
+TEST(WorkStealingQueueTest, GrowsPastInitialCapacity)
+{
+    TWorkStealingQueue<uintptr_t> Queue(4);
+    for (uintptr_t i = 1; i <= 100; ++i)
+    {
+        Queue.Push(i);
+    }
+    EXPECT_GE(Queue.GetCapacity(), 100);
+
+    uintptr_t Item = 0;
+    for (uintptr_t i = 100; i >= 1; --i)
+    {
+        ASSERT_TRUE(Queue.Pop(Item));
+        EXPECT_EQ(Item, i);
+    }
+}
+
+TEST(WorkStealingQueueTest, ConcurrentSteal_EveryItemTakenExactlyOnce)
+{
+    const uintptr_t NumItems = 100000;
+    const int NumThieves = 4;
+    TWorkStealingQueue<uintptr_t> Queue(64);
+    std::vector<std::atomic<uint8>> Taken(NumItems);
+    std::atomic<bool> bDone(false);
+
+    auto Take = [&](uintptr_t Item) { Taken[Item - 1].fetch_add(1); };
+
+    std::vector<std::thread> Thieves;
+    for (int i = 0; i < NumThieves; ++i)
+    {
+        Thieves.emplace_back([&]()
+        {
+            uintptr_t Item = 0;
+            while (!bDone.load() || !Queue.IsEmpty())
+            {
+                if (Queue.Steal(Item))
+                {
+                    Take(Item);
+                }
+            }
+        });
+    }
+
+    // Owner interleaves pushes and pops while thieves steal
+    uintptr_t Item = 0;
+    for (uintptr_t i = 1; i <= NumItems; ++i)
+    {
+        Queue.Push(i);
+        if ((i % 3) == 0 && Queue.Pop(Item))
+        {
+            Take(Item);
+        }
+    }
+    while (Queue.Pop(Item))
+    {
+        Take(Item);
+    }
+    bDone = true;
+
+    for (auto& Thief : Thieves)
+    {
+        Thief.join();
+    }
+
+    for (uintptr_t i = 0; i < NumItems; ++i)
+    {
+        ASSERT_EQ(Taken[i].load(), 1) << "Item " << (i + 1);
+    }
+}
+
+// ============================================
+// Task Graph Scheduler Tests
+// ============================================
+
+TEST(TaskGraphTest, CreateTask_RunsAndSignals)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    std::atomic<uint32> Counter(0);
+    FGraphEventRef Event = Graph.CreateTask([&Counter]() { Counter.fetch_add(1); });
+    Event->Wait();
+
+    EXPECT_TRUE(Event->IsComplete());
+    EXPECT_EQ(Counter.load(), 1u);
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, ManyExternalTasks_AllExecute)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    const uint32 NumTasks = 10000;
+    std::atomic<uint32> Counter(0);
+    std::vector<std::unique_ptr<FCounterTask>> Tasks;
+    for (uint32 i = 0; i < NumTasks; ++i)
+    {
+        Tasks.push_back(std::make_unique<FCounterTask>(&Counter));
+        Graph.QueueTask(Tasks.back().get());
+    }
+
+    EXPECT_TRUE(WaitForCount(Counter, NumTasks));
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, WorkerSpawnedTasks_AreStolenByOtherWorkers)
+{
+    const uint32 NumWorkers = 4;
+    FTaskGraph Graph(NumWorkers);
+    Graph.Initialize();
+
+    const uint32 NumChildren = 2000;
+    std::atomic<uint32> Counter(0);
+    std::vector<std::atomic<uint32>> PerWorker(NumWorkers);
+    std::vector<std::unique_ptr<FLambdaTask>> Children;
+    for (uint32 i = 0; i < NumChildren; ++i)
+    {
+        Children.push_back(std::make_unique<FLambdaTask>([&]()
+        {
+            int32 Index = Graph.GetCurrentWorkerIndex();
+            if (Index >= 0)
+            {
+                PerWorker[Index].fetch_add(1);
+            }
+            // Enough work per task for idle workers to find the deque non-empty
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            Counter.fetch_add(1);
+        }));
+    }
+
+    // A single root task pushes every child into its own local deque
+    Graph.CreateTask([&]()
+    {
+        EXPECT_GE(Graph.GetCurrentWorkerIndex(), 0);
+        for (auto& Child : Children)
+        {
+            Graph.QueueTask(Child.get());
+        }
+    });
+
+    ASSERT_TRUE(WaitForCount(Counter, NumChildren));
+
+    uint32 WorkersThatRanChildren = 0;
+    for (auto& Count : PerWorker)
+    {
+        WorkersThatRanChildren += Count.load() > 0 ? 1 : 0;
+    }
+    EXPECT_GT(WorkersThatRanChildren, 1u);
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, NonWorkerThread_HasNoWorkerIndex)
+{
+    FTaskGraph Graph(2);
+    Graph.Initialize();
+    EXPECT_EQ(Graph.GetCurrentWorkerIndex(), -1);
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, ParkedWorkers_WakeForNewWork)
+{
+    FTaskGraph Graph(2);
+    Graph.Initialize();
+
+    // Give workers time to run out of spins and park
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::atomic<uint32> Counter(0);
+    FGraphEventRef Event = Graph.CreateTask([&Counter]() { Counter.fetch_add(1); });
+    Event->Wait();
+    EXPECT_EQ(Counter.load(), 1u);
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, QueueTaskAfterShutdown_RunsInlineAndSignals)
+{
+    FTaskGraph Graph(2);
+    Graph.Initialize();
+    Graph.Shutdown();
+
+    bool bRan = false;
+    FLambdaTask* Task = FLambdaTask::Allocate([&bRan]() { bRan = true; });
+    FGraphEventRef Event = Task->GetEventRef();
+    Graph.QueueTask(Task);
+
+    EXPECT_TRUE(bRan);
+    EXPECT_TRUE(Event->IsComplete());
+}
+
+// ============================================
+// Task Pooling Tests
+// ============================================
+
+TEST(TaskFunctionTest, SmallLambda_StoredInline)
+{
+    int Value = 0;
+    int* Pointer = &Value;
+    FTaskFunction Function([Pointer]() { *Pointer = 42; });
+
+    EXPECT_TRUE(Function.IsInline());
+    Function();
+    EXPECT_EQ(Value, 42);
+}
+
+TEST(TaskFunctionTest, LargeLambda_FallsBackToHeap)
+{
+    uint8 Payload[FTaskFunction::InlineSize + 16] = {};
+    Payload[0] = 7;
+    int Result = 0;
+    int* ResultPtr = &Result;
+    FTaskFunction Function([Payload, ResultPtr]() { *ResultPtr = Payload[0]; });
+
+    EXPECT_FALSE(Function.IsInline());
+    Function();
+    EXPECT_EQ(Result, 7);
+}
+
+TEST(TaskFunctionTest, Move_TransfersCallableAndDestroysCaptures)
+{
+    std::shared_ptr<int> Shared = std::make_shared<int>(1);
+    FTaskFunction Source([Shared]() {});
+    EXPECT_EQ(Shared.use_count(), 2);
+
+    FTaskFunction Dest(std::move(Source));
+    EXPECT_FALSE(static_cast<bool>(Source));
+    EXPECT_TRUE(static_cast<bool>(Dest));
+    EXPECT_EQ(Shared.use_count(), 2);
+
+    Dest.Reset();
+    EXPECT_EQ(Shared.use_count(), 1);
+}
+
+TEST(LockFreePoolTest, FreedItemsAreReused)
+{
+    TLockFreePool<uint64, 8> Pool;
+    uint64* First = Pool.Allocate();
+    EXPECT_EQ(Pool.GetCapacity(), 8u);
+
+    Pool.Free(First);
+    uint64* Second = Pool.Allocate();
+    EXPECT_EQ(First, Second);
+    EXPECT_EQ(Pool.GetCapacity(), 8u);
+}
+
+TEST(LockFreePoolTest, Exhausted_FallsBackToHeap)
+{
+    // One item per block, so the block table fills after 16384 items
+    auto Pool = std::make_unique<TLockFreePool<uint64, 1>>();
+    std::vector<uint64*> Items;
+    for (uint32 i = 0; i < 16384 + 16; ++i)
+    {
+        uint64* Item = Pool->Allocate();
+        ASSERT_NE(Item, nullptr);
+        *Item = i;
+        Items.push_back(Item);
+    }
+    EXPECT_EQ(Pool->GetCapacity(), 16384u);
+    EXPECT_EQ(*Items.back(), 16384u + 15u);
+
+    // Heap items are deleted, pooled ones recycled
+    for (uint64* Item : Items)
+    {
+        Pool->Free(Item);
+    }
+    EXPECT_EQ(Pool->GetNumFree(), Pool->GetCapacity());
+    EXPECT_NE(Pool->Allocate(), nullptr);
+}
+
+TEST(LockFreePoolTest, ConcurrentAllocateFree_NoDuplicates)
+{
+    TLockFreePool<uint64, 64> Pool;
+    const int NumThreads = 4;
+    const int Iterations = 20000;
+    std::atomic<bool> bFailed(false);
+
+    std::vector<std::thread> Threads;
+    for (int t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&, t]()
+        {
+            for (int i = 0; i < Iterations; ++i)
+            {
+                uint64* Item = Pool.Allocate();
+                // Stamp the item; another owner would overwrite it
+                uint64 Stamp = (static_cast<uint64>(t) << 32) | static_cast<uint32>(i);
+                *Item = Stamp;
+                std::this_thread::yield();
+                if (*Item != Stamp)
+                {
+                    bFailed = true;
+                }
+                Pool.Free(Item);
+            }
+        });
+    }
+    for (auto& Thread : Threads)
+    {
+        Thread.join();
+    }
+
+    EXPECT_FALSE(bFailed.load());
+    EXPECT_EQ(Pool.GetNumFree(), Pool.GetCapacity());
+}
+
+TEST(TaskGraphTest, GraphEventRef_OutlivesRecycledTask)
+{
+    FTaskGraph Graph(2);
+    Graph.Initialize();
+
+    FGraphEventRef Event = Graph.CreateTask([]() {});
+    Event->Wait();
+
+    // Joining the workers guarantees the task has dropped its reference and recycled itself
+    Graph.Shutdown();
+
+    // Our reference keeps the event valid
+    EXPECT_TRUE(Event->IsComplete());
+    EXPECT_EQ(Event->GetRefCount(), 1u);
+
+    FGraphEventRef Copy = Event;
+    EXPECT_EQ(Event->GetRefCount(), 2u);
+}
+
+TEST(TaskGraphTest, Soak_MillionTasks_PoolStaysFlat)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    const uint32 BatchSize = 1000;
+    const uint32 NumBatches = 1000;
+    std::atomic<uint32> Counter(0);
+    std::vector<FGraphEventRef> Events;
+    Events.reserve(BatchSize);
+
+    auto RunBatch = [&]()
+    {
+        for (uint32 i = 0; i < BatchSize; ++i)
+        {
+            Events.push_back(Graph.CreateTask([&Counter]() { Counter.fetch_add(1, std::memory_order_relaxed); }));
+        }
+        for (FGraphEventRef& Event : Events)
+        {
+            Event->Wait();
+        }
+        Events.clear();
+    };
+
+    // Warm up so the pools reach their working-set size
+    RunBatch();
+    uint32 TaskCapacity = FLambdaTask::GetPoolCapacity();
+    uint32 EventCapacity = FTaskEvent::GetPoolCapacity();
+
+    for (uint32 Batch = 1; Batch < NumBatches; ++Batch)
+    {
+        RunBatch();
+    }
+
+    EXPECT_EQ(Counter.load(), BatchSize * NumBatches);
+    // At most BatchSize tasks are ever alive at once; allow one extra batch of slack
+    // for tasks still being recycled when the next batch starts
+    EXPECT_LE(FLambdaTask::GetPoolCapacity(), TaskCapacity + BatchSize);
+    EXPECT_LE(FTaskEvent::GetPoolCapacity(), EventCapacity + BatchSize);
+    Graph.Shutdown();
+}
+
+// ============================================
+// Task Prerequisite Tests
+// ============================================
+
+TEST(TaskGraphTest, Prerequisites_ChainRunsInOrder)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    const uint32 ChainLength = 200;
+    std::vector<uint32> Order;
+    Order.reserve(ChainLength);
+
+    FGraphEventRef Previous;
+    for (uint32 i = 0; i < ChainLength; ++i)
+    {
+        // Each link only runs after the previous one, so the vector needs no lock
+        Previous = Graph.CreateTask([&Order, i]() { Order.push_back(i); }, { Previous });
+    }
+    Previous->Wait();
+
+    ASSERT_EQ(Order.size(), ChainLength);
+    for (uint32 i = 0; i < ChainLength; ++i)
+    {
+        EXPECT_EQ(Order[i], i);
+    }
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, Prerequisites_DiamondWaitsForAllParents)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    std::atomic<uint32> ParentsDone(0);
+    uint32 ParentsSeenByJoin = 0;
+
+    FGraphEventRef Root = Graph.CreateTask([]() {});
+    FGraphEventRef Left = Graph.CreateTask([&ParentsDone]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ParentsDone.fetch_add(1);
+    }, { Root });
+    FGraphEventRef Right = Graph.CreateTask([&ParentsDone]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ParentsDone.fetch_add(1);
+    }, { Root });
+    FGraphEventRef Join = Graph.CreateTask([&]() { ParentsSeenByJoin = ParentsDone.load(); }, { Left, Right });
+
+    Join->Wait();
+    EXPECT_EQ(ParentsSeenByJoin, 2u);
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, Prerequisites_PendingTaskDoesNotOccupyWorker)
+{
+    // One worker: if the dependent task blocked a thread, the independent one could never run
+    FTaskGraph Graph(1);
+    Graph.Initialize();
+
+    FGraphEventRef Gate = FTaskEvent::Create();
+    std::atomic<uint32> DependentRuns(0);
+    FGraphEventRef Dependent = Graph.CreateTask([&DependentRuns]() { DependentRuns.fetch_add(1); }, { Gate });
+
+    FGraphEventRef Independent = Graph.CreateTask([]() {});
+    Independent->Wait();
+    EXPECT_FALSE(Dependent->IsComplete());
+    EXPECT_EQ(DependentRuns.load(), 0u);
+
+    Gate->Signal();
+    Dependent->Wait();
+    EXPECT_EQ(DependentRuns.load(), 1u);
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, Prerequisites_CompleteOrNull_RunsImmediately)
+{
+    FTaskGraph Graph(2);
+    Graph.Initialize();
+
+    FGraphEventRef Done = Graph.CreateTask([]() {});
+    Done->Wait();
+
+    std::atomic<uint32> Counter(0);
+    FGraphEventRef Event = Graph.CreateTask([&Counter]() { Counter.fetch_add(1); }, { Done, FGraphEventRef() });
+    Event->Wait();
+    EXPECT_EQ(Counter.load(), 1u);
+    Graph.Shutdown();
+}
+
+TEST(TaskGraphTest, Prerequisites_WideFanIn_RacesWithSubscription)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    const uint32 NumParents = 500;
+    const uint32 NumRounds = 50;
+    for (uint32 Round = 0; Round < NumRounds; ++Round)
+    {
+        std::atomic<uint32> ParentsDone(0);
+        uint32 ParentsSeenByJoin = 0;
+
+        // Parents start running while the join is still subscribing to them
+        FGraphEventArray Parents;
+        Parents.reserve(NumParents);
+        for (uint32 i = 0; i < NumParents; ++i)
+        {
+            Parents.push_back(Graph.CreateTask([&ParentsDone]() { ParentsDone.fetch_add(1); }));
+        }
+        FGraphEventRef Join = Graph.CreateTask([&]() { ParentsSeenByJoin = ParentsDone.load(); }, Parents);
+
+        Join->Wait();
+        ASSERT_EQ(ParentsSeenByJoin, NumParents) << "Round " << Round;
+    }
+    Graph.Shutdown();
+}
+
+// ============================================
+// ParallelFor Tests
+// ============================================
+
+TEST(ParallelForTest, EveryIndexVisitedExactlyOnce)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    const int32 Sizes[] = { 1, 7, 64, 1000, 100003 };
+    const int32 BatchSizes[] = { 1, 16, 1024 };
+    for (int32 Num : Sizes)
+    {
+        for (int32 MinBatchSize : BatchSizes)
+        {
+            std::vector<std::atomic<uint32>> Visits(Num);
+            ParallelFor(Graph, Num, [&Visits](int32 Index) { Visits[Index].fetch_add(1); }, MinBatchSize);
+
+            for (int32 i = 0; i < Num; ++i)
+            {
+                ASSERT_EQ(Visits[i].load(), 1u) << "Num " << Num << " batch " << MinBatchSize << " index " << i;
+            }
+        }
+    }
+    Graph.Shutdown();
+}
+
+TEST(ParallelForTest, SmallLoop_RunsInlineOnCaller)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    std::thread::id Caller = std::this_thread::get_id();
+    std::atomic<uint32> OffThread(0);
+    ParallelFor(Graph, 32, [&](int32) {
+        if (std::this_thread::get_id() != Caller)
+        {
+            OffThread.fetch_add(1);
+        }
+    }, 64);
+
+    EXPECT_EQ(OffThread.load(), 0u);
+    Graph.Shutdown();
+}
+
+TEST(ParallelForTest, LargeLoop_SpreadsAcrossWorkersAndCaller)
+{
+    FTaskGraph Graph(3);
+    Graph.Initialize();
+
+    std::thread::id Caller = std::this_thread::get_id();
+    std::atomic<uint32> OnCaller(0);
+    std::atomic<uint32> OnWorkers(0);
+    ParallelFor(Graph, 2000, [&](int32) {
+        // Enough work per element for workers to wake up and steal
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        if (std::this_thread::get_id() == Caller)
+        {
+            OnCaller.fetch_add(1);
+        }
+        else
+        {
+            OnWorkers.fetch_add(1);
+        }
+    }, 8);
+
+    EXPECT_EQ(OnCaller.load() + OnWorkers.load(), 2000u);
+    EXPECT_GT(OnCaller.load(), 0u);
+    EXPECT_GT(OnWorkers.load(), 0u);
+    Graph.Shutdown();
+}
+
+TEST(ParallelForTest, NestedParallelFor_FromWorkerCompletes)
+{
+    FTaskGraph Graph(4);
+    Graph.Initialize();
+
+    const int32 Outer = 16;
+    const int32 Inner = 1000;
+    std::atomic<uint32> Counter(0);
+    ParallelFor(Graph, Outer, [&](int32) {
+        ParallelFor(Graph, Inner, [&Counter](int32) { Counter.fetch_add(1, std::memory_order_relaxed); }, 32);
+    });
+
+    EXPECT_EQ(Counter.load(), static_cast<uint32>(Outer * Inner));
+    Graph.Shutdown();
+}
+
+TEST(ParallelForTest, UninitializedGraph_RunsSerially)
+{
+    FTaskGraph Graph(2);
+
+    int32 Sum = 0;
+    ParallelFor(Graph, 1000, [&Sum](int32 Index) { Sum += Index; }, 1);
+    EXPECT_EQ(Sum, 999 * 1000 / 2);
+}
+
+TEST(TripleBufferTest, Acquire_ReturnsLatestPublishedValue)
+{
+    TTripleBuffer<int32> Buffer;
+    EXPECT_FALSE(Buffer.Acquire());
+
+    Buffer.GetWriteBuffer() = 1;
+    Buffer.Publish();
+    Buffer.GetWriteBuffer() = 2;
+    Buffer.Publish();
+    EXPECT_TRUE(Buffer.HasPendingValue());
+
+    // Older values are overwritten, not queued
+    EXPECT_TRUE(Buffer.Acquire());
+    EXPECT_EQ(Buffer.GetReadBuffer(), 2);
+    EXPECT_FALSE(Buffer.HasPendingValue());
+
+    // Nothing new: keep the current read buffer
+    EXPECT_FALSE(Buffer.Acquire());
+    EXPECT_EQ(Buffer.GetReadBuffer(), 2);
+
+    Buffer.GetWriteBuffer() = 3;
+    Buffer.Publish();
+    EXPECT_TRUE(Buffer.Acquire());
+    EXPECT_EQ(Buffer.GetReadBuffer(), 3);
+}
+
+TEST(TripleBufferTest, ConcurrentProducerConsumer_NeverSeesTornOrOlderValue)
+{
+    // Every element of a published value carries the same sequence number
+    struct FValue
+    {
+        uint64 Elements[16];
+    };
+
+    TTripleBuffer<FValue> Buffer;
+    const uint64 NumValues = 200000;
+    std::atomic<bool> bDone(false);
+
+    std::thread Producer([&]()
+    {
+        for (uint64 Sequence = 1; Sequence <= NumValues; ++Sequence)
+        {
+            FValue& Value = Buffer.GetWriteBuffer();
+            for (uint64& Element : Value.Elements)
+            {
+                Element = Sequence;
+            }
+            Buffer.Publish();
+        }
+        bDone = true;
+    });
+
+    uint64 LastSeen = 0;
+    uint32 NumTorn = 0;
+    uint32 NumOutOfOrder = 0;
+    while (LastSeen < NumValues)
+    {
+        if (!Buffer.Acquire())
+        {
+            if (bDone.load() && !Buffer.HasPendingValue())
+            {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        const FValue& Value = Buffer.GetReadBuffer();
+        for (uint64 Element : Value.Elements)
+        {
+            if (Element != Value.Elements[0])
+            {
+                ++NumTorn;
+                break;
+            }
+        }
+        if (Value.Elements[0] <= LastSeen)
+        {
+            ++NumOutOfOrder;
+        }
+        LastSeen = Value.Elements[0];
+    }
+    Producer.join();
+
+    EXPECT_EQ(NumTorn, 0u);
+    EXPECT_EQ(NumOutOfOrder, 0u);
+    EXPECT_EQ(LastSeen, NumValues);
+}